@@ -0,0 +1,227 @@
+/**
+ * @file analyzer_main.cpp
+ * @brief WaveformAnalyzer executable
+ *
+ * Recomputes energy, energyShort (PSD) and CFD timestamps of full events
+ * from their waveforms.
+ *
+ * Usage:
+ *   delila_analyzer [options]
+ *
+ * Options:
+ *   -i, --input <address>    ZMQ input address (required)
+ *   -o, --output <address>   ZMQ output address (default: tcp://*:5567)
+ *   -w, --workers <number>   Analyzing threads (default: 2)
+ *   --positive               Positive pulses (default: negative)
+ *   --trigger <sample>       Sample the timestamp refers to (default: 64)
+ *   --baseline <samples>     Baseline samples (default: 16)
+ *   --pre-gate <samples>     Gates open this many samples before the trigger (default: 8)
+ *   --short-gate <samples>   Short gate length (default: 24)
+ *   --long-gate <samples>    Long gate length (default: 120)
+ *   --cfd-fraction <value>   CFD fraction (default: 0.25)
+ *   --cfd-delay <samples>    CFD delay (default: 4)
+ *   --sample-ns <value>      Sampling period in ns (default: 2)
+ *   --scale <value>          Integral to energy channel factor (default: 1)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   delila_analyzer -i tcp://localhost:5555 -w 4 --short-gate 20 --scale 0.05
+ */
+
+#include <WaveformAnalyzer.hpp>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "metrics_endpoint.hpp"
+
+using namespace DELILA;
+
+// Global pointer for signal handler
+static WaveformAnalyzer* g_analyzer = nullptr;
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+  if (g_analyzer) {
+    g_analyzer->Stop(true);
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 WaveformAnalyzer - Software PSD and CFD Timing\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -i, --input <address>    ZMQ input address (required)\n";
+  std::cout << "  -o, --output <address>   ZMQ output address (default: tcp://*:5567)\n";
+  std::cout << "  -w, --workers <number>   Analyzing threads (default: 2)\n";
+  std::cout << "  --positive               Positive pulses (default: negative)\n";
+  std::cout << "  --trigger <sample>       Sample the timestamp refers to (default: 64)\n";
+  std::cout << "  --baseline <samples>     Baseline samples (default: 16)\n";
+  std::cout << "  --pre-gate <samples>     Gates open this many samples before the trigger (default: 8)\n";
+  std::cout << "  --short-gate <samples>   Short gate length (default: 24)\n";
+  std::cout << "  --long-gate <samples>    Long gate length (default: 120)\n";
+  std::cout << "  --cfd-fraction <value>   CFD fraction (default: 0.25)\n";
+  std::cout << "  --cfd-delay <samples>    CFD delay (default: 4)\n";
+  std::cout << "  --sample-ns <value>      Sampling period in ns (default: 2)\n";
+  std::cout << "  --scale <value>          Integral to energy channel factor (default: 1)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -i tcp://localhost:5555 -w 4 --short-gate 20 --scale 0.05\n";
+}
+
+int main(int argc, char* argv[]) {
+  // Default configuration
+  std::string input_address;
+  std::string output_address = "tcp://*:5567";
+  std::string metrics_address;  // Empty: no metrics endpoint
+  uint32_t workers = 2;
+  PulseAnalyzer::Settings settings;
+
+  // Parse command line arguments
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool hasValue = i + 1 < argc;
+
+      if (arg == "-h" || arg == "--help") {
+        printUsage(argv[0]);
+        return 0;
+      } else if (arg == "--positive") {
+        settings.polarity = 1;
+      } else if (!hasValue) {
+        continue;
+      } else if (arg == "--metrics") {
+        metrics_address = argv[++i];
+      } else if (arg == "-i" || arg == "--input") {
+        input_address = argv[++i];
+      } else if (arg == "-o" || arg == "--output") {
+        output_address = argv[++i];
+      } else if (arg == "-w" || arg == "--workers") {
+        workers = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--trigger") {
+        settings.triggerSample = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--baseline") {
+        settings.baselineSamples = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--pre-gate") {
+        settings.preGate = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--short-gate") {
+        settings.shortGate = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--long-gate") {
+        settings.longGate = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--cfd-fraction") {
+        settings.cfdFraction = std::stof(argv[++i]);
+      } else if (arg == "--cfd-delay") {
+        settings.cfdDelay = static_cast<uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--sample-ns") {
+        settings.sampleNs = std::stod(argv[++i]);
+      } else if (arg == "--scale") {
+        settings.energyScale = std::stod(argv[++i]);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid argument value: " << e.what() << std::endl;
+    return 1;
+  }
+
+  // Validate inputs
+  if (input_address.empty()) {
+    std::cerr << "ERROR: An input address is required (-i option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Create and configure analyzer
+  WaveformAnalyzer analyzer;
+  g_analyzer = &analyzer;
+
+  analyzer.SetComponentId("analyzer");
+  analyzer.SetInputAddresses({input_address});
+  analyzer.SetOutputAddresses({output_address});
+  analyzer.SetWorkerThreads(workers);
+  std::string error;
+  if (!analyzer.SetSettings(settings, &error)) {
+    std::cerr << "ERROR: Invalid analysis settings: " << error << std::endl;
+    return 1;
+  }
+
+  // Print configuration
+  std::cout << "=== DELILA2 WaveformAnalyzer ===" << std::endl;
+  std::cout << "Input address:  " << input_address << std::endl;
+  std::cout << "Output address: " << output_address << std::endl;
+  std::cout << "Workers:        " << analyzer.GetWorkerThreads() << std::endl;
+  std::cout << "Polarity:       "
+            << (settings.polarity > 0 ? "positive" : "negative") << std::endl;
+  std::cout << "Gates:          baseline " << settings.baselineSamples
+            << ", trigger " << settings.triggerSample << ", pre "
+            << settings.preGate << ", short " << settings.shortGate
+            << ", long " << settings.longGate << std::endl;
+  std::cout << "CFD:            fraction " << settings.cfdFraction
+            << ", delay " << settings.cfdDelay << ", "
+            << settings.sampleNs << " ns/sample" << std::endl;
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(analyzer, metrics_address)) {
+    return 1;
+  }
+
+  // Initialize
+  std::cout << "Initializing analyzer..." << std::endl;
+  if (!analyzer.Initialize("")) {
+    std::cerr << "ERROR: Failed to initialize analyzer" << std::endl;
+    return 1;
+  }
+
+  // Arm
+  std::cout << "Arming analyzer..." << std::endl;
+  if (!analyzer.Arm()) {
+    std::cerr << "ERROR: Failed to arm analyzer" << std::endl;
+    return 1;
+  }
+
+  // Start with run number 1
+  std::cout << "Starting analyzer (Run 1)..." << std::endl;
+  if (!analyzer.Start(1)) {
+    std::cerr << "ERROR: Failed to start analyzer" << std::endl;
+    return 1;
+  }
+
+  std::cout << "WaveformAnalyzer running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      auto status = analyzer.GetStatus();
+      std::cout << "[Status] Events: " << status.metrics.events_processed
+                << ", Analyzed: " << analyzer.GetEventsAnalyzed()
+                << ", No CFD: " << analyzer.GetCfdFailures()
+                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+    }
+  }
+
+  // Cleanup
+  std::cout << "Stopping analyzer..." << std::endl;
+  analyzer.Stop(true);
+  analyzer.Shutdown();
+
+  auto status = analyzer.GetStatus();
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  std::cout << "Events:           " << status.metrics.events_processed << std::endl;
+  std::cout << "Analyzed:         " << analyzer.GetEventsAnalyzed() << std::endl;
+  std::cout << "No CFD crossing:  " << analyzer.GetCfdFailures() << std::endl;
+  std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+
+  g_analyzer = nullptr;
+  return 0;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file calibration_main.cpp
+ * @brief CalibrationStage executable
+ *
+ * Applies per-channel energy calibration and time offsets to the hits of
+ * one upstream stage and sends calibrated events.
+ *
+ * Usage:
+ *   delila_calibration [options]
+ *
+ * Options:
+ *   -i, --input <address>    ZMQ input address (required)
+ *   -o, --output <address>   ZMQ output address (default: tcp://*:5566)
+ *   -t, --table <file>       Calibration table (JSON, see CalibrationTable)
+ *   --command <address>      Command endpoint, e.g. tcp://*:5600 (default: off)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   delila_calibration -i tcp://localhost:5555 -t calibration.json
+ */
+
+#include <CalibrationStage.hpp>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "metrics_endpoint.hpp"
+
+using namespace DELILA;
+
+// Global pointer for signal handler
+static CalibrationStage* g_stage = nullptr;
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+  if (g_stage) {
+    g_stage->Stop(true);
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 CalibrationStage - Online Energy Calibration\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -i, --input <address>    ZMQ input address (required)\n";
+  std::cout << "  -o, --output <address>   ZMQ output address (default: tcp://*:5566)\n";
+  std::cout << "  -t, --table <file>       Calibration table (JSON)\n";
+  std::cout << "  --command <address>      Command endpoint, e.g. tcp://*:5600 (default: off)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Channels without a table entry are passed through uncalibrated.\n";
+  std::cout << "A Configure command with a JSON table in its payload replaces\n";
+  std::cout << "the table between runs.\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -i tcp://localhost:5555 -t calibration.json\n";
+}
+
+int main(int argc, char* argv[]) {
+  // Default configuration
+  std::string input_address;
+  std::string output_address = "tcp://*:5566";
+  std::string table_path;
+  std::string command_address;  // Empty: no command endpoint
+  std::string metrics_address;  // Empty: no metrics endpoint
+
+  // Parse command line arguments
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "--metrics") {
+      if (i + 1 < argc) {
+        metrics_address = argv[++i];
+      }
+    } else if (arg == "--command") {
+      if (i + 1 < argc) {
+        command_address = argv[++i];
+      }
+    } else if (arg == "-i" || arg == "--input") {
+      if (i + 1 < argc) {
+        input_address = argv[++i];
+      }
+    } else if (arg == "-o" || arg == "--output") {
+      if (i + 1 < argc) {
+        output_address = argv[++i];
+      }
+    } else if (arg == "-t" || arg == "--table") {
+      if (i + 1 < argc) {
+        table_path = argv[++i];
+      }
+    }
+  }
+
+  // Validate inputs
+  if (input_address.empty()) {
+    std::cerr << "ERROR: An input address is required (-i option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Create and configure the stage
+  CalibrationStage stage;
+  g_stage = &stage;
+
+  stage.SetComponentId("calibration");
+  stage.SetInputAddresses({input_address});
+  stage.SetOutputAddresses({output_address});
+
+  // Print configuration
+  std::cout << "=== DELILA2 CalibrationStage ===" << std::endl;
+  std::cout << "Input address:  " << input_address << std::endl;
+  std::cout << "Output address: " << output_address << std::endl;
+  std::cout << "Table:          "
+            << (table_path.empty() ? "(none, pass-through)" : table_path)
+            << std::endl;
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(stage, metrics_address)) {
+    return 1;
+  }
+
+  // Command endpoint (optional, used to swap tables between runs)
+  if (!command_address.empty()) {
+    stage.SetCommandAddress(command_address);
+    stage.StartCommandListener();
+    std::cout << "Command endpoint: " << command_address << std::endl;
+  }
+
+  // Initialize (loads the table)
+  std::cout << "Initializing calibration stage..." << std::endl;
+  if (!stage.Initialize(table_path)) {
+    std::cerr << "ERROR: Failed to initialize calibration stage: "
+              << stage.GetStatus().error_message << std::endl;
+    return 1;
+  }
+  std::cout << "Calibrated channels: " << stage.GetCalibratedChannelCount()
+            << std::endl;
+
+  // Arm
+  std::cout << "Arming calibration stage..." << std::endl;
+  if (!stage.Arm()) {
+    std::cerr << "ERROR: Failed to arm calibration stage" << std::endl;
+    return 1;
+  }
+
+  // Start with run number 1
+  std::cout << "Starting calibration stage (Run 1)..." << std::endl;
+  if (!stage.Start(1)) {
+    std::cerr << "ERROR: Failed to start calibration stage" << std::endl;
+    return 1;
+  }
+
+  std::cout << "CalibrationStage running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      auto status = stage.GetStatus();
+      std::cout << "[Status] Events: " << status.metrics.events_processed
+                << ", Uncalibrated: " << stage.GetUncalibratedEvents()
+                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+    }
+  }
+
+  // Cleanup
+  std::cout << "Stopping calibration stage..." << std::endl;
+  stage.Stop(true);
+  stage.Shutdown();
+
+  auto status = stage.GetStatus();
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  std::cout << "Events:           " << status.metrics.events_processed << std::endl;
+  std::cout << "Uncalibrated:     " << stage.GetUncalibratedEvents() << std::endl;
+  std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+
+  g_stage = nullptr;
+  return 0;
+}
@@ -13,10 +13,19 @@
  *   -m, --module <number>    Module number 0-255 (default: 0)
  *   -c, --channels <number>  Number of channels 1-64 (default: 16)
  *   -r, --rate <events/sec>  Event generation rate (default: 1000)
+ *   -b, --batch <events>     Events per data frame (default: 1)
  *   -e, --energy <min,max>   Energy range (default: 0,16383)
  *   --full                   Use full EventData mode (default: Minimal)
  *   --waveform <size>        Waveform samples (Full mode only, default: 0)
+ *   --compact                Compact waveform encoding (Full mode, format 5)
  *   --seed <value>           Random seed for reproducibility
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   --retransmit <address>   Reliable delivery: bind the retransmit side
+ *                            channel, e.g. tcp://*:5565 (default: off)
+ *   --replay <frames>        Frames kept for retransmission (default: 4096)
+ *   --spill <directory>      Spill mode: hold frames downstream cannot take,
+ *                            overflowing to a file there (default: off)
+ *   --spill-size <MB>        Spill file size (default: 1024)
  *   -h, --help               Show this help message
  *
  * Example:
@@ -25,6 +34,9 @@
  *
  *   # Start emulator with full waveform data
  *   delila_emulator -o tcp://*:5556 -m 1 --full --waveform 1024
+ *
+ *   # Lost frames are sent again on request of "delila_writer -R"
+ *   delila_emulator -o tcp://*:5555 --retransmit tcp://*:5565
  */
 
 #include <Emulator.hpp>
@@ -34,6 +46,8 @@
 #include <string>
 #include <thread>
 
+#include "metrics_endpoint.hpp"
+
 using namespace DELILA;
 
 // Global pointer for signal handler
@@ -57,10 +71,19 @@ void printUsage(const char* program) {
   std::cout << "  -m, --module <number>    Module number 0-255 (default: 0)\n";
   std::cout << "  -c, --channels <number>  Number of channels 1-64 (default: 16)\n";
   std::cout << "  -r, --rate <events/sec>  Event generation rate (default: 1000)\n";
+  std::cout << "  -b, --batch <events>     Events per data frame (default: 1)\n";
   std::cout << "  -e, --energy <min,max>   Energy range (default: 0,16383)\n";
   std::cout << "  --full                   Use full EventData mode (default: Minimal)\n";
   std::cout << "  --waveform <size>        Waveform samples (Full mode, default: 0)\n";
+  std::cout << "  --compact                Compact waveform encoding (Full mode, format 5)\n";
   std::cout << "  --seed <value>           Random seed for reproducibility\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  --retransmit <address>   Reliable delivery: bind the retransmit side\n";
+  std::cout << "                           channel, e.g. tcp://*:5565 (default: off)\n";
+  std::cout << "  --replay <frames>        Frames kept for retransmission (default: 4096)\n";
+  std::cout << "  --spill <directory>      Spill mode: hold frames downstream cannot take,\n";
+  std::cout << "                           overflowing to a file there (default: off)\n";
+  std::cout << "  --spill-size <MB>        Spill file size (default: 1024)\n";
   std::cout << "  -h, --help               Show this help message\n\n";
   std::cout << "Example:\n";
   std::cout << "  " << program << " -o tcp://*:5555 -m 0 -r 10000\n";
@@ -76,8 +99,15 @@ int main(int argc, char* argv[]) {
   uint16_t energy_max = 16383;
   EmulatorDataMode data_mode = EmulatorDataMode::Minimal;
   size_t waveform_size = 0;
+  bool compact_waveforms = false;
+  size_t batch_size = 1;
   bool seed_set = false;
   uint64_t seed = 0;
+  std::string metrics_address;  // Empty: no metrics endpoint
+  std::string retransmit_address;  // Empty: no reliable delivery
+  size_t replay_frames = 4096;
+  std::string spill_directory;  // Empty: no spill mode
+  uint64_t spill_mb = 1024;
 
   // Parse command line arguments
   for (int i = 1; i < argc; ++i) {
@@ -86,6 +116,26 @@ int main(int argc, char* argv[]) {
     if (arg == "-h" || arg == "--help") {
       printUsage(argv[0]);
       return 0;
+    } else if (arg == "--metrics") {
+      if (i + 1 < argc) {
+        metrics_address = argv[++i];
+      }
+    } else if (arg == "--retransmit") {
+      if (i + 1 < argc) {
+        retransmit_address = argv[++i];
+      }
+    } else if (arg == "--spill") {
+      if (i + 1 < argc) {
+        spill_directory = argv[++i];
+      }
+    } else if (arg == "--spill-size") {
+      if (i + 1 < argc) {
+        spill_mb = std::stoull(argv[++i]);
+      }
+    } else if (arg == "--replay") {
+      if (i + 1 < argc) {
+        replay_frames = static_cast<size_t>(std::stoul(argv[++i]));
+      }
     } else if (arg == "-o" || arg == "--output") {
       if (i + 1 < argc) {
         output_address = argv[++i];
@@ -102,6 +152,10 @@ int main(int argc, char* argv[]) {
       if (i + 1 < argc) {
         event_rate = static_cast<uint32_t>(std::stoi(argv[++i]));
       }
+    } else if (arg == "-b" || arg == "--batch") {
+      if (i + 1 < argc) {
+        batch_size = static_cast<size_t>(std::stoi(argv[++i]));
+      }
     } else if (arg == "-e" || arg == "--energy") {
       if (i + 1 < argc) {
         std::string range = argv[++i];
@@ -113,6 +167,8 @@ int main(int argc, char* argv[]) {
       }
     } else if (arg == "--full") {
       data_mode = EmulatorDataMode::Full;
+    } else if (arg == "--compact") {
+      compact_waveforms = true;
     } else if (arg == "--waveform") {
       if (i + 1 < argc) {
         waveform_size = static_cast<size_t>(std::stoi(argv[++i]));
@@ -131,10 +187,20 @@ int main(int argc, char* argv[]) {
   std::cout << "Module number:  " << static_cast<int>(module_number) << std::endl;
   std::cout << "Channels:       " << static_cast<int>(num_channels) << std::endl;
   std::cout << "Event rate:     " << event_rate << " events/sec" << std::endl;
+  std::cout << "Batch size:     " << batch_size << " events/frame" << std::endl;
   std::cout << "Energy range:   " << energy_min << " - " << energy_max << std::endl;
   std::cout << "Data mode:      " << (data_mode == EmulatorDataMode::Minimal ? "Minimal" : "Full") << std::endl;
   if (data_mode == EmulatorDataMode::Full) {
-    std::cout << "Waveform size:  " << waveform_size << " samples" << std::endl;
+    std::cout << "Waveform size:  " << waveform_size << " samples"
+              << (compact_waveforms ? " (compact)" : "") << std::endl;
+  }
+  if (!retransmit_address.empty()) {
+    std::cout << "Retransmit:     " << retransmit_address << " ("
+              << replay_frames << " frames kept)" << std::endl;
+  }
+  if (!spill_directory.empty()) {
+    std::cout << "Spill:          " << spill_directory << " (" << spill_mb
+              << " MB)" << std::endl;
   }
   std::cout << std::endl;
 
@@ -153,12 +219,23 @@ int main(int argc, char* argv[]) {
   emulator.SetEnergyRange(energy_min, energy_max);
   emulator.SetDataMode(data_mode);
   emulator.SetWaveformSize(waveform_size);
+  emulator.SetCompactWaveforms(compact_waveforms);
+  emulator.SetBatchSize(batch_size);
   emulator.SetOutputAddresses({output_address});
+  emulator.SetRetransmitAddress(retransmit_address);
+  emulator.SetReplayBufferSize(replay_frames);
+  emulator.SetSpillDirectory(spill_directory);
+  emulator.SetSpillCapacity(spill_mb << 20);
 
   if (seed_set) {
     emulator.SetSeed(seed);
   }
 
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(emulator, metrics_address)) {
+    return 1;
+  }
+
   // Initialize
   std::cout << "Initializing emulator..." << std::endl;
   if (!emulator.Initialize("")) {
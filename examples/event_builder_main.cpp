@@ -0,0 +1,244 @@
+/**
+ * @file event_builder_main.cpp
+ * @brief EventBuilder executable
+ *
+ * Receives hits from multiple upstream sources, time-orders them and sends
+ * coincidence events (built event frames) downstream.
+ *
+ * Usage:
+ *   delila_event_builder [options]
+ *
+ * Options:
+ *   -i, --input <address>    ZMQ input address (can be specified multiple times)
+ *   -o, --output <address>   ZMQ output address (default: tcp://*:5560)
+ *   -w, --window <pre,post>  Coincidence window in ns (default: 500,500)
+ *   -t, --trigger <mod:ch>   Trigger channel (multiple allowed, default: all)
+ *   -n, --min-hits <number>  Minimum hits per event (default: 1)
+ *   -j, --workers <number>   Build worker threads (default: 1)
+ *   --reorder <ns>           Out-of-order tolerance per module (default: 0)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   # Build events triggered by module 0 channel 0 from two emulators
+ *   delila_event_builder -i tcp://localhost:5555 -i tcp://localhost:5556 -t 0:0 -w 200,800
+ */
+
+#include <EventBuilder.hpp>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "metrics_endpoint.hpp"
+
+using namespace DELILA;
+
+// Global pointer for signal handler
+static EventBuilder* g_builder = nullptr;
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+  if (g_builder) {
+    g_builder->Stop(true);
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 EventBuilder - Online Coincidence Event Builder\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -i, --input <address>    ZMQ input address (multiple allowed)\n";
+  std::cout << "  -o, --output <address>   ZMQ output address (default: tcp://*:5560)\n";
+  std::cout << "  -w, --window <pre,post>  Coincidence window in ns (default: 500,500)\n";
+  std::cout << "  -t, --trigger <mod:ch>   Trigger channel (multiple allowed, default: all)\n";
+  std::cout << "  -n, --min-hits <number>  Minimum hits per event (default: 1)\n";
+  std::cout << "  -j, --workers <number>   Build worker threads (default: 1)\n";
+  std::cout << "  --reorder <ns>           Out-of-order tolerance per module (default: 0)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -i tcp://localhost:5555 -i tcp://localhost:5556 -t 0:0 -w 200,800\n";
+}
+
+int main(int argc, char* argv[]) {
+  // Default configuration
+  std::vector<std::string> input_addresses;
+  std::string output_address = "tcp://*:5560";
+  std::string metrics_address;  // Empty: no metrics endpoint
+  double pre_ns = 500.0;
+  double post_ns = 500.0;
+  std::vector<std::pair<uint8_t, uint8_t>> triggers;
+  uint32_t min_hits = 1;
+  uint32_t workers = 1;
+  double reorder_ns = 0.0;
+
+  // Parse command line arguments
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+
+      if (arg == "-h" || arg == "--help") {
+        printUsage(argv[0]);
+        return 0;
+      } else if (arg == "--metrics") {
+        if (i + 1 < argc) {
+          metrics_address = argv[++i];
+        }
+      } else if (arg == "-i" || arg == "--input") {
+        if (i + 1 < argc) {
+          input_addresses.push_back(argv[++i]);
+        }
+      } else if (arg == "-o" || arg == "--output") {
+        if (i + 1 < argc) {
+          output_address = argv[++i];
+        }
+      } else if (arg == "-w" || arg == "--window") {
+        if (i + 1 < argc) {
+          std::string window = argv[++i];
+          size_t comma = window.find(',');
+          if (comma == std::string::npos) {
+            std::cerr << "ERROR: Window must be <pre,post>" << std::endl;
+            return 1;
+          }
+          pre_ns = std::stod(window.substr(0, comma));
+          post_ns = std::stod(window.substr(comma + 1));
+        }
+      } else if (arg == "-t" || arg == "--trigger") {
+        if (i + 1 < argc) {
+          std::string trigger = argv[++i];
+          size_t colon = trigger.find(':');
+          if (colon == std::string::npos) {
+            std::cerr << "ERROR: Trigger must be <module:channel>" << std::endl;
+            return 1;
+          }
+          int module = std::stoi(trigger.substr(0, colon));
+          int channel = std::stoi(trigger.substr(colon + 1));
+          if (module < 0 || module > 255 || channel < 0 || channel > 255) {
+            std::cerr << "ERROR: Trigger module/channel must be 0-255"
+                      << std::endl;
+            return 1;
+          }
+          triggers.emplace_back(static_cast<uint8_t>(module),
+                                static_cast<uint8_t>(channel));
+        }
+      } else if (arg == "-n" || arg == "--min-hits") {
+        if (i + 1 < argc) {
+          min_hits = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+      } else if (arg == "-j" || arg == "--workers") {
+        if (i + 1 < argc) {
+          workers = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+      } else if (arg == "--reorder") {
+        if (i + 1 < argc) {
+          reorder_ns = std::stod(argv[++i]);
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid argument value: " << e.what() << std::endl;
+    return 1;
+  }
+
+  // Validate inputs
+  if (input_addresses.empty()) {
+    std::cerr << "ERROR: At least one input address is required (-i option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Print configuration
+  std::cout << "=== DELILA2 EventBuilder ===" << std::endl;
+  std::cout << "Input addresses:" << std::endl;
+  for (const auto& addr : input_addresses) {
+    std::cout << "  - " << addr << std::endl;
+  }
+  std::cout << "Output address: " << output_address << std::endl;
+  std::cout << "Window:         -" << pre_ns << " / +" << post_ns << " ns"
+            << std::endl;
+  std::cout << "Triggers:       ";
+  if (triggers.empty()) {
+    std::cout << "all channels";
+  }
+  for (const auto& [module, channel] : triggers) {
+    std::cout << static_cast<int>(module) << ":" << static_cast<int>(channel)
+              << " ";
+  }
+  std::cout << std::endl;
+  std::cout << "Workers:        " << workers << std::endl;
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Create and configure event builder
+  EventBuilder builder;
+  g_builder = &builder;
+
+  builder.SetComponentId("event_builder");
+  builder.SetInputAddresses(input_addresses);
+  builder.SetOutputAddresses({output_address});
+  builder.SetCoincidenceWindow(pre_ns, post_ns);
+  builder.SetTriggerChannels(triggers);
+  builder.SetMinHits(min_hits);
+  builder.SetWorkerThreads(workers);
+  builder.SetReorderWindowNs(reorder_ns);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(builder, metrics_address)) {
+    return 1;
+  }
+
+  // Initialize
+  std::cout << "Initializing event builder..." << std::endl;
+  if (!builder.Initialize("")) {
+    std::cerr << "ERROR: Failed to initialize event builder" << std::endl;
+    return 1;
+  }
+
+  // Arm
+  std::cout << "Arming event builder..." << std::endl;
+  if (!builder.Arm()) {
+    std::cerr << "ERROR: Failed to arm event builder" << std::endl;
+    return 1;
+  }
+
+  // Start with run number 1
+  std::cout << "Starting event builder (Run 1)..." << std::endl;
+  if (!builder.Start(1)) {
+    std::cerr << "ERROR: Failed to start event builder" << std::endl;
+    return 1;
+  }
+
+  std::cout << "EventBuilder running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      auto status = builder.GetStatus();
+      std::cout << "[Status] Events: " << status.metrics.events_processed
+                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+    }
+  }
+
+  // Cleanup
+  std::cout << "Stopping event builder..." << std::endl;
+  builder.Stop(true);
+  builder.Shutdown();
+
+  auto status = builder.GetStatus();
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  std::cout << "Built events:     " << status.metrics.events_processed << std::endl;
+  std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+
+  g_builder = nullptr;
+  return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file filter_main.cpp
+ * @brief FilterStage executable
+ *
+ * Receives events from one upstream stage and forwards only the events
+ * that pass every rule (software trigger).
+ *
+ * Usage:
+ *   delila_filter [options]
+ *
+ * Options:
+ *   -i, --input <address>    ZMQ input address (required)
+ *   -o, --output <address>   ZMQ output address (default: tcp://*:5570)
+ *   -r, --rule <expression>  Filter rule (multiple allowed, all must pass)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   # Keep clean hits above 100 channels from the merger
+ *   delila_filter -i tcp://localhost:5560 -r "energy >= 100" -r "flags none pileup"
+ */
+
+#include <FilterStage.hpp>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics_endpoint.hpp"
+
+using namespace DELILA;
+
+// Global pointer for signal handler
+static FilterStage* g_filter = nullptr;
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+  if (g_filter) {
+    g_filter->Stop(true);
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 FilterStage - Software Trigger / Event Filter\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -i, --input <address>    ZMQ input address (required)\n";
+  std::cout << "  -o, --output <address>   ZMQ output address (default: tcp://*:5570)\n";
+  std::cout << "  -r, --rule <expression>  Filter rule (multiple allowed, all must pass)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Rules:\n";
+  std::cout << "  <field> <op> <number>    field: module, channel, energy, energy_short,\n";
+  std::cout << "                           psd, multiplicity; op: < <= > >= == !=\n";
+  std::cout << "  flags none|any <mask>    mask: number or pileup|trigger_lost|over_range\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -i tcp://localhost:5560 -r \"energy >= 100\" -r \"flags none pileup\"\n";
+}
+
+void printRuleCounts(const FilterStage& filter) {
+  auto rules = filter.GetRules();
+  auto counts = filter.GetRuleCounts();
+  for (size_t r = 0; r < rules.size() && r < counts.size(); ++r) {
+    std::cout << "  [" << rules[r] << "] " << counts[r] << std::endl;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  // Default configuration
+  std::string input_address;
+  std::string output_address = "tcp://*:5570";
+  std::string metrics_address;  // Empty: no metrics endpoint
+  std::vector<std::string> rules;
+
+  // Parse command line arguments
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "--metrics") {
+      if (i + 1 < argc) {
+        metrics_address = argv[++i];
+      }
+    } else if (arg == "-i" || arg == "--input") {
+      if (i + 1 < argc) {
+        input_address = argv[++i];
+      }
+    } else if (arg == "-o" || arg == "--output") {
+      if (i + 1 < argc) {
+        output_address = argv[++i];
+      }
+    } else if (arg == "-r" || arg == "--rule") {
+      if (i + 1 < argc) {
+        rules.push_back(argv[++i]);
+      }
+    }
+  }
+
+  // Validate inputs
+  if (input_address.empty()) {
+    std::cerr << "ERROR: An input address is required (-i option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Create and configure filter
+  FilterStage filter;
+  g_filter = &filter;
+
+  filter.SetComponentId("filter");
+  filter.SetInputAddresses({input_address});
+  filter.SetOutputAddresses({output_address});
+  for (const auto& rule : rules) {
+    std::string error;
+    if (!filter.AddRule(rule, &error)) {
+      std::cerr << "ERROR: Invalid rule '" << rule << "': " << error
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // Print configuration
+  std::cout << "=== DELILA2 FilterStage ===" << std::endl;
+  std::cout << "Input address:  " << input_address << std::endl;
+  std::cout << "Output address: " << output_address << std::endl;
+  std::cout << "Rules:" << std::endl;
+  if (rules.empty()) {
+    std::cout << "  (none, all events pass)" << std::endl;
+  }
+  for (const auto& rule : rules) {
+    std::cout << "  - " << rule << std::endl;
+  }
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(filter, metrics_address)) {
+    return 1;
+  }
+
+  // Initialize
+  std::cout << "Initializing filter..." << std::endl;
+  if (!filter.Initialize("")) {
+    std::cerr << "ERROR: Failed to initialize filter" << std::endl;
+    return 1;
+  }
+
+  // Arm
+  std::cout << "Arming filter..." << std::endl;
+  if (!filter.Arm()) {
+    std::cerr << "ERROR: Failed to arm filter" << std::endl;
+    return 1;
+  }
+
+  // Start with run number 1
+  std::cout << "Starting filter (Run 1)..." << std::endl;
+  if (!filter.Start(1)) {
+    std::cerr << "ERROR: Failed to start filter" << std::endl;
+    return 1;
+  }
+
+  std::cout << "FilterStage running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      auto status = filter.GetStatus();
+      std::cout << "[Status] Received: " << filter.GetEventsReceived()
+                << ", Passed: " << status.metrics.events_processed
+                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+      printRuleCounts(filter);
+    }
+  }
+
+  // Cleanup
+  std::cout << "Stopping filter..." << std::endl;
+  filter.Stop(true);
+  filter.Shutdown();
+
+  auto status = filter.GetStatus();
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  std::cout << "Events received:  " << filter.GetEventsReceived() << std::endl;
+  std::cout << "Events passed:    " << status.metrics.events_processed << std::endl;
+  std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+  std::cout << "Per-rule passes:" << std::endl;
+  printRuleCounts(filter);
+
+  g_filter = nullptr;
+  return 0;
+}
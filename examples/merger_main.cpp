@@ -11,11 +11,20 @@
  * Options:
  *   -i, --input <address>    ZMQ input address (can be specified multiple times)
  *   -o, --output <address>   ZMQ output address (default: tcp://*:5560)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   --spill <directory>      Spill mode: hold frames downstream cannot take,
+ *                            overflowing to a file there (default: off)
+ *   --spill-size <MB>        Spill file size (default: 1024)
+ *   --reorder <frames>       Restore each input's frame order, holding up
+ *                            to this many frames (default: 0, off)
  *   -h, --help               Show this help message
  *
  * Example:
  *   # Merge from two emulators and output on port 5560
  *   delila_merger -i tcp://localhost:5555 -i tcp://localhost:5556 -o tcp://*:5560
+ *
+ *   # Absorb stalls of the writer in up to 4 GB of local disk
+ *   delila_merger -i tcp://localhost:5555 --spill /data/spill --spill-size 4096
  */
 
 #include <SimpleMerger.hpp>
@@ -25,6 +34,8 @@
 #include <thread>
 #include <vector>
 
+#include "metrics_endpoint.hpp"
+
 using namespace DELILA;
 
 // Global pointer for signal handler
@@ -46,6 +57,12 @@ void printUsage(const char* program) {
   std::cout << "Options:\n";
   std::cout << "  -i, --input <address>    ZMQ input address (multiple allowed)\n";
   std::cout << "  -o, --output <address>   ZMQ output address (default: tcp://*:5560)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  --spill <directory>      Spill mode: hold frames downstream cannot take,\n";
+  std::cout << "                           overflowing to a file there (default: off)\n";
+  std::cout << "  --spill-size <MB>        Spill file size (default: 1024)\n";
+  std::cout << "  --reorder <frames>       Restore each input's frame order, holding up\n";
+  std::cout << "                           to this many frames (default: 0, off)\n";
   std::cout << "  -h, --help               Show this help message\n\n";
   std::cout << "Example:\n";
   std::cout << "  " << program << " -i tcp://localhost:5555 -i tcp://localhost:5556 -o tcp://*:5560\n";
@@ -55,6 +72,10 @@ int main(int argc, char* argv[]) {
   // Default configuration
   std::vector<std::string> input_addresses;
   std::string output_address = "tcp://*:5560";
+  std::string metrics_address;  // Empty: no metrics endpoint
+  std::string spill_directory;  // Empty: no spill mode
+  uint64_t spill_mb = 1024;
+  size_t reorder_window = 0;
 
   // Parse command line arguments
   for (int i = 1; i < argc; ++i) {
@@ -63,6 +84,22 @@ int main(int argc, char* argv[]) {
     if (arg == "-h" || arg == "--help") {
       printUsage(argv[0]);
       return 0;
+    } else if (arg == "--metrics") {
+      if (i + 1 < argc) {
+        metrics_address = argv[++i];
+      }
+    } else if (arg == "--spill") {
+      if (i + 1 < argc) {
+        spill_directory = argv[++i];
+      }
+    } else if (arg == "--spill-size") {
+      if (i + 1 < argc) {
+        spill_mb = std::stoull(argv[++i]);
+      }
+    } else if (arg == "--reorder") {
+      if (i + 1 < argc) {
+        reorder_window = static_cast<size_t>(std::stoul(argv[++i]));
+      }
     } else if (arg == "-i" || arg == "--input") {
       if (i + 1 < argc) {
         input_addresses.push_back(argv[++i]);
@@ -88,6 +125,13 @@ int main(int argc, char* argv[]) {
     std::cout << "  - " << addr << std::endl;
   }
   std::cout << "Output address: " << output_address << std::endl;
+  if (!spill_directory.empty()) {
+    std::cout << "Spill:          " << spill_directory << " (" << spill_mb
+              << " MB)" << std::endl;
+  }
+  if (reorder_window > 0) {
+    std::cout << "Reorder window: " << reorder_window << " frames" << std::endl;
+  }
   std::cout << std::endl;
 
   // Setup signal handlers
@@ -101,6 +145,14 @@ int main(int argc, char* argv[]) {
   merger.SetComponentId("merger");
   merger.SetInputAddresses(input_addresses);
   merger.SetOutputAddresses({output_address});
+  merger.SetSpillDirectory(spill_directory);
+  merger.SetSpillCapacity(spill_mb << 20);
+  merger.SetReorderWindow(reorder_window);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(merger, metrics_address)) {
+    return 1;
+  }
 
   // Initialize
   std::cout << "Initializing merger..." << std::endl;
@@ -138,12 +190,21 @@ int main(int argc, char* argv[]) {
   // Cleanup
   std::cout << "Stopping merger..." << std::endl;
   merger.Stop(true);
+  const uint64_t dropped = merger.GetDroppedFrames();  // Cleared by Shutdown
   merger.Shutdown();
 
   auto status = merger.GetStatus();
   std::cout << "\n=== Final Statistics ===" << std::endl;
   std::cout << "Total events:     " << status.metrics.events_processed << std::endl;
   std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+  std::cout << "Frames dropped:   " << dropped << std::endl;
+  for (size_t i = 0; i < input_addresses.size(); ++i) {
+    auto stats = merger.GetInputSequenceStats(i);
+    std::cout << "Input " << i << ":          " << stats.received
+              << " frames, " << stats.lost << " lost, " << stats.reordered
+              << " reordered (" << stats.late << " late), "
+              << stats.duplicates << " duplicate" << std::endl;
+  }
 
   g_merger = nullptr;
   return 0;
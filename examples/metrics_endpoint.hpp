@@ -0,0 +1,29 @@
+/**
+ * @file metrics_endpoint.hpp
+ * @brief --metrics handling shared by the example executables
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Start @p component's OpenMetrics endpoint (serves GET /metrics)
+ * @param address Value of --metrics; empty leaves the endpoint off
+ * @return false (after printing an error) if the endpoint cannot be bound
+ */
+template <typename Component>
+bool StartMetricsEndpoint(Component &component, const std::string &address) {
+  if (address.empty()) {
+    return true;
+  }
+  component.SetMetricsAddress(address);
+  if (!component.StartMetricsExporter()) {
+    std::cerr << "ERROR: Failed to start metrics endpoint on " << address
+              << std::endl;
+    return false;
+  }
+  std::cout << "Metrics endpoint: " << address << "/metrics" << std::endl;
+  return true;
+}
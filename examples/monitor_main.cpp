@@ -16,6 +16,9 @@
  *   --timing                 Enable timing histogram
  *   --2d                     Enable 2D histograms (Energy vs Channel/Module)
  *   --waveform <mod,ch>      Enable waveform display for specified module,channel
+ *   --no-prescale            Fill every event even when falling behind
+ *   --workers <n>            Decode/fill worker threads (default: 2)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
  *   -h, --help               Show this help message
  *
  * Example:
@@ -38,6 +41,8 @@
 #include <string>
 #include <thread>
 
+#include "metrics_endpoint.hpp"
+
 using namespace DELILA;
 
 // Global pointer for signal handler
@@ -64,6 +69,9 @@ void printUsage(const char* program) {
   std::cout << "  --timing                 Enable timing histogram\n";
   std::cout << "  --2d                     Enable 2D histograms\n";
   std::cout << "  --waveform <mod,ch>      Enable waveform display\n";
+  std::cout << "  --no-prescale            Fill every event even when falling behind\n";
+  std::cout << "  --workers <n>            Decode/fill worker threads (default: 2)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
   std::cout << "  -h, --help               Show this help message\n\n";
   std::cout << "Example:\n";
   std::cout << "  " << program << " -i tcp://localhost:5560 -p 8080 --2d\n\n";
@@ -82,6 +90,9 @@ int main(int argc, char* argv[]) {
   bool enable_waveform = false;
   uint8_t waveform_module = 0;
   uint8_t waveform_channel = 0;
+  bool enable_prescale = true;
+  uint32_t worker_threads = 2;
+  std::string metrics_address;  // Empty: no metrics endpoint
 
   // Parse command line arguments
   for (int i = 1; i < argc; ++i) {
@@ -90,6 +101,10 @@ int main(int argc, char* argv[]) {
     if (arg == "-h" || arg == "--help") {
       printUsage(argv[0]);
       return 0;
+    } else if (arg == "--metrics") {
+      if (i + 1 < argc) {
+        metrics_address = argv[++i];
+      }
     } else if (arg == "-i" || arg == "--input") {
       if (i + 1 < argc) {
         input_address = argv[++i];
@@ -106,6 +121,12 @@ int main(int argc, char* argv[]) {
       enable_timing = true;
     } else if (arg == "--2d") {
       enable_2d = true;
+    } else if (arg == "--no-prescale") {
+      enable_prescale = false;
+    } else if (arg == "--workers") {
+      if (i + 1 < argc) {
+        worker_threads = static_cast<uint32_t>(std::stoi(argv[++i]));
+      }
     } else if (arg == "--waveform") {
       if (i + 1 < argc) {
         enable_waveform = true;
@@ -132,6 +153,8 @@ int main(int argc, char* argv[]) {
     std::cout << "  Waveform:      module " << static_cast<int>(waveform_module)
               << ", channel " << static_cast<int>(waveform_channel) << std::endl;
   }
+  std::cout << "Prescaling:      " << (enable_prescale ? "adaptive" : "off") << std::endl;
+  std::cout << "Workers:         " << worker_threads << std::endl;
   std::cout << std::endl;
 
   // Setup signal handlers
@@ -150,10 +173,17 @@ int main(int argc, char* argv[]) {
   monitor.EnableTimingHistogram(enable_timing);
   monitor.Enable2DHistogram(enable_2d);
   monitor.EnableWaveformDisplay(enable_waveform);
+  monitor.EnablePrescaling(enable_prescale);
+  monitor.SetWorkerThreads(worker_threads);
   if (enable_waveform) {
     monitor.SetWaveformChannel(waveform_module, waveform_channel);
   }
 
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(monitor, metrics_address)) {
+    return 1;
+  }
+
   // Initialize
   std::cout << "Initializing monitor..." << std::endl;
   if (!monitor.Initialize("")) {
@@ -185,7 +215,12 @@ int main(int argc, char* argv[]) {
     if (g_running) {
       auto status = monitor.GetStatus();
       std::cout << "[Status] Events: " << status.metrics.events_processed
-                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+                << ", Bytes: " << status.metrics.bytes_transferred;
+      if (status.metrics.sampling_fraction < 1.0) {
+        std::cout << ", Sampled: " << status.metrics.sampling_fraction * 100.0
+                  << "%";
+      }
+      std::cout << std::endl;
     }
   }
 
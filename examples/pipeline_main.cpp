@@ -0,0 +1,608 @@
+/**
+ * @file pipeline_main.cpp
+ * @brief Single-process pipeline runner
+ *
+ * Builds sources -> SimpleMerger -> [WaveformAnalyzer] -> [WaveformReducer]
+ * -> [FilterStage] -> [CalibrationStage] -> [Router] -> sink(s) from one
+ * JSON topology and runs all components in this process. With the default "inproc" transport the
+ * components share one ZeroMQ context and frames are handed from stage to
+ * stage in memory instead of over loopback TCP.
+ *
+ * Usage:
+ *   delila_pipeline [options] <topology.json>
+ *
+ * Options:
+ *   -r, --run <number>       Run number (default: topology "run_number" or 1)
+ *   -h, --help               Show this help message
+ *
+ * Topology:
+ *   {
+ *     "transport": "inproc",          // inproc | ipc | shm | tcp
+ *     "base_port": 5555,              // tcp only, one port per link
+ *     "run_number": 1,
+ *     "sources": [
+ *       { "type": "emulator", "module": 0, "rate": 10000, "batch": 100,
+ *         "full": true, "waveform": 512, "seed": 1 },
+ *       { "type": "digitizer", "config": "dig1.conf" }
+ *     ],
+ *     "merger": { "id": "merger" },   // optional with a single source
+ *     "analyzer": { "workers": 4, "short_gate": 20, "scale": 0.05 },
+ *     "reducer": { "prescale": 100, "channels": [[0, 3]] },
+ *     "filter": { "rules": ["energy >= 100", "flags none pileup"] },
+ *     "calibration": { "table": "calibration.json" },
+ *     "router": { "outputs": 2, "key": "module", "ranges": ["0-3=0"] },
+ *     "sink": { "type": "writer", "directory": "./data", "prefix": "run_",
+ *               "manifest": true }
+ *   }
+ *
+ * Every component also accepts "id" and "metrics" (OpenMetrics endpoint,
+ * e.g. "*:9100"). Emulator keys: module, channels, rate, batch, energy
+ * [min, max], full, waveform, seed. Digitizer keys: config, mock_rate,
+ * batch. Analyzer keys: workers, polarity (+1/-1), trigger, baseline,
+ * pre_gate, short_gate, long_gate, cfd_fraction, cfd_delay, sample_ns,
+ * scale (see PulseAnalyzer). Reducer keys: prescale, channels [[module, channel], ...], rules.
+ * Filter keys: rules (see FilterStage). Calibration keys: table (see
+ * CalibrationTable). Router keys: outputs, key (module, channel, time,
+ * frame), slice_ns, block, ranges (see RouteTable); with a router the sink
+ * is created once per output n, with "_<n>" appended to its id, "<n>_" to
+ * the writer prefix and n added to the monitor and metrics ports. Writer
+ * keys: directory, directories (one per router output, e.g. one per disk),
+ * prefix, manifest. With the frame key and "manifest", the writers' manifests
+ * are merged into <directory>/<prefix><run>.manifest.json after the run
+ * (see RunReader).
+ * Monitor keys (ROOT builds only): port, workers.
+ *
+ * Example:
+ *   delila_pipeline pipeline.json
+ */
+
+#include <DigitizerSource.hpp>
+#include <Emulator.hpp>
+#include <CalibrationStage.hpp>
+#include <FileWriter.hpp>
+#include <FilterStage.hpp>
+#include <Router.hpp>
+#include <RunManifest.hpp>
+#include <SimpleMerger.hpp>
+#include <WaveformAnalyzer.hpp>
+#include <WaveformReducer.hpp>
+#ifdef HAS_ROOT
+#include <MonitorROOT.hpp>
+#endif
+
+#include <unistd.h>
+
+#include <csignal>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace DELILA;
+
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 Pipeline - Single-Process Pipeline Runner\n\n";
+  std::cout << "Usage: " << program << " [options] <topology.json>\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -r, --run <number>       Run number (default: from topology, or 1)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Topology keys:\n";
+  std::cout << "  transport                inproc (default), ipc, shm or tcp\n";
+  std::cout << "  sources                  emulator / digitizer components\n";
+  std::cout << "  merger                   optional with a single source\n";
+  std::cout << "  analyzer                 optional WaveformAnalyzer\n";
+  std::cout << "  reducer                  optional WaveformReducer\n";
+  std::cout << "  filter                   optional FilterStage with \"rules\"\n";
+  std::cout << "  calibration              optional CalibrationStage with \"table\"\n";
+  std::cout << "  router                   optional Router, one sink per output\n";
+  std::cout << "  sink                     writer or monitor\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " pipeline.json\n";
+}
+
+// One connection between two stages: the upstream side binds, the
+// downstream side connects (the addresses only differ for tcp)
+struct Link {
+  std::string bind;
+  std::string connect;
+};
+
+// The calls the runner needs, for any component type
+struct Stage {
+  std::string id;
+  std::string config_path;
+  std::unique_ptr<IComponent> component;
+  std::function<bool()> arm;
+  std::function<bool(uint32_t)> start;
+  std::function<bool(bool)> stop;
+  std::function<bool()> start_metrics;
+};
+
+template <typename T>
+Stage makeStage(std::unique_ptr<T> component, const nlohmann::json& spec) {
+  Stage stage;
+  T* raw = component.get();
+  stage.id = raw->GetComponentId();
+  stage.arm = [raw] { return raw->Arm(); };
+  stage.start = [raw](uint32_t run) { return raw->Start(run); };
+  stage.stop = [raw](bool graceful) { return raw->Stop(graceful); };
+  if (spec.contains("metrics")) {
+    raw->SetMetricsAddress(spec["metrics"].get<std::string>());
+    stage.start_metrics = [raw] { return raw->StartMetricsExporter(); };
+  }
+  stage.component = std::move(component);
+  return stage;
+}
+
+Link makeLink(const std::string& transport, int base_port, int index) {
+  std::string tag = std::to_string(getpid()) + "_" + std::to_string(index);
+  if (transport == "ipc") {
+    std::string address = "ipc:///tmp/delila_pipeline_" + tag;
+    return {address, address};
+  }
+  if (transport == "shm") {
+    std::string address = "shm://delila_pipeline_" + tag;
+    return {address, address};
+  }
+  if (transport == "tcp") {
+    std::string port = std::to_string(base_port + index);
+    return {"tcp://*:" + port, "tcp://127.0.0.1:" + port};
+  }
+  std::string address = "inproc://delila_pipeline_" + std::to_string(index);
+  return {address, address};
+}
+
+Stage makeSource(const nlohmann::json& spec, const Link& output, size_t index) {
+  std::string type = spec.value("type", "emulator");
+
+  if (type == "digitizer") {
+    auto source = std::make_unique<DigitizerSource>();
+    source->SetComponentId(
+        spec.value("id", "digitizer" + std::to_string(index)));
+    if (spec.contains("mock_rate")) {
+      source->SetMockMode(true);
+      source->SetMockEventRate(spec["mock_rate"].get<uint32_t>());
+    }
+    if (spec.contains("batch")) {
+      source->SetBatchSize(spec["batch"].get<size_t>());
+    }
+    source->SetOutputAddresses({output.bind});
+    Stage stage = makeStage(std::move(source), spec);
+    stage.config_path = spec.value("config", "");
+    return stage;
+  }
+
+  if (type != "emulator") {
+    throw std::runtime_error("unknown source type '" + type + "'");
+  }
+
+  auto module = spec.value("module", static_cast<int>(index));
+  auto emulator = std::make_unique<Emulator>();
+  emulator->SetComponentId(
+      spec.value("id", "emulator_mod" + std::to_string(module)));
+  emulator->SetModuleNumber(static_cast<uint8_t>(module));
+  emulator->SetNumChannels(static_cast<uint8_t>(spec.value("channels", 16)));
+  emulator->SetEventRate(spec.value("rate", 1000u));
+  emulator->SetBatchSize(spec.value("batch", size_t{1}));
+  if (spec.contains("energy")) {
+    emulator->SetEnergyRange(spec["energy"].at(0).get<uint16_t>(),
+                             spec["energy"].at(1).get<uint16_t>());
+  }
+  emulator->SetDataMode(spec.value("full", false) ? EmulatorDataMode::Full
+                                                  : EmulatorDataMode::Minimal);
+  emulator->SetWaveformSize(spec.value("waveform", size_t{0}));
+  if (spec.contains("seed")) {
+    emulator->SetSeed(spec["seed"].get<uint64_t>());
+  }
+  emulator->SetOutputAddresses({output.bind});
+  return makeStage(std::move(emulator), spec);
+}
+
+Stage makeSink(const nlohmann::json& spec, const Link& input) {
+  std::string type = spec.value("type", "writer");
+
+  if (type == "monitor") {
+#ifdef HAS_ROOT
+    auto monitor = std::make_unique<MonitorROOT>();
+    monitor->SetComponentId(spec.value("id", "monitor"));
+    monitor->SetInputAddresses({input.connect});
+    monitor->SetHttpPort(spec.value("port", 8080));
+    monitor->SetWorkerThreads(spec.value("workers", 2u));
+    return makeStage(std::move(monitor), spec);
+#else
+    throw std::runtime_error("monitor sink requires ROOT");
+#endif
+  }
+
+  if (type != "writer") {
+    throw std::runtime_error("unknown sink type '" + type + "'");
+  }
+
+  auto writer = std::make_unique<FileWriter>();
+  writer->SetComponentId(spec.value("id", "writer"));
+  writer->SetInputAddresses({input.connect});
+  writer->SetOutputPath(spec.value("directory", "."));
+  writer->SetFilePrefix(spec.value("prefix", "run_"));
+  writer->SetWriteManifest(spec.value("manifest", false));
+  return makeStage(std::move(writer), spec);
+}
+
+// The sink behind router output n: distinct id, files and ports
+nlohmann::json sinkForOutput(const nlohmann::json& spec, size_t n) {
+  nlohmann::json part = spec;
+  std::string suffix = "_" + std::to_string(n);
+  part["id"] = spec.value("id", spec.value("type", "writer")) + suffix;
+  part["prefix"] = spec.value("prefix", "run_") + std::to_string(n) + "_";
+  if (spec.contains("directories") && !spec["directories"].empty()) {
+    const auto& directories = spec["directories"];
+    part["directory"] = directories.at(n % directories.size());
+  }
+  part["port"] = spec.value("port", 8080) + static_cast<int>(n);
+  if (spec.contains("metrics")) {
+    std::string address = spec["metrics"].get<std::string>();
+    size_t colon = address.rfind(':');
+    int port = std::stoi(address.substr(colon + 1));
+    part["metrics"] =
+        address.substr(0, colon + 1) + std::to_string(port + static_cast<int>(n));
+  }
+  return part;
+}
+
+// Merge the manifests of a writer farm into the run manifest
+void saveRunManifest(const std::vector<FileWriter*>& writers,
+                     const nlohmann::json& sink_spec, uint32_t run_number) {
+  RunManifest manifest;
+  for (auto* writer : writers) {
+    RunManifest part;
+    std::string error;
+    if (!part.Load(writer->GetManifestPath(), &error) ||
+        !manifest.Merge(part, &error)) {
+      std::cerr << "WARNING: " << error << std::endl;
+    }
+  }
+  manifest.Sort();
+
+  std::ostringstream path;
+  path << sink_spec.value("directory", ".") << '/'
+       << sink_spec.value("prefix", "run_") << std::setfill('0')
+       << std::setw(6) << run_number << ".manifest.json";
+  std::string error;
+  if (!manifest.Save(path.str(), &error)) {
+    std::cerr << "ERROR: Failed to save run manifest: " << error << std::endl;
+    return;
+  }
+  std::cout << "Run manifest: " << path.str() << " ("
+            << manifest.GetFrames() << " frames in "
+            << manifest.GetFiles().size() << " files";
+  auto gaps = manifest.FindGaps();
+  if (!gaps.empty()) {
+    std::cout << ", " << gaps.size() << " gap(s)";
+  }
+  std::cout << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  std::string topology_path;
+  bool run_set = false;
+  uint32_t run_number = 1;
+
+  // Parse command line arguments
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "-r" || arg == "--run") {
+      if (i + 1 < argc) {
+        run_number = static_cast<uint32_t>(std::stoul(argv[++i]));
+        run_set = true;
+      }
+    } else {
+      topology_path = arg;
+    }
+  }
+
+  if (topology_path.empty()) {
+    std::cerr << "ERROR: A topology file is required\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Build the stages, ordered upstream to downstream
+  std::vector<Stage> stages;
+  std::vector<FileWriter*> farm_writers;  // Writers behind a frame-key router
+  nlohmann::json sink_spec;
+  size_t num_sources = 0;
+  std::string transport;
+  try {
+    std::ifstream file(topology_path);
+    if (!file.is_open()) {
+      std::cerr << "ERROR: Cannot open " << topology_path << std::endl;
+      return 1;
+    }
+    nlohmann::json topology = nlohmann::json::parse(file);
+
+    transport = topology.value("transport", "inproc");
+    if (transport != "inproc" && transport != "ipc" && transport != "shm" &&
+        transport != "tcp") {
+      throw std::runtime_error("unknown transport '" + transport + "'");
+    }
+    int base_port = topology.value("base_port", 5555);
+    if (!run_set) {
+      run_number = topology.value("run_number", 1u);
+    }
+
+    const auto& sources = topology.at("sources");
+    num_sources = sources.size();
+    if (num_sources == 0) {
+      throw std::runtime_error("at least one source is required");
+    }
+    bool use_merger = topology.contains("merger") || num_sources > 1;
+
+    // Links 0..N-1 leave the sources, the following ones the merger,
+    // analyzer, reducer, filter, calibration and router in that order
+    std::vector<Link> source_links;
+    for (size_t i = 0; i < num_sources; ++i) {
+      source_links.push_back(makeLink(transport, base_port, static_cast<int>(i)));
+      stages.push_back(makeSource(sources[i], source_links.back(), i));
+    }
+
+    Link sink_link = source_links[0];
+    int next_link = static_cast<int>(num_sources);
+    if (use_merger) {
+      nlohmann::json spec = topology.value("merger", nlohmann::json::object());
+      sink_link = makeLink(transport, base_port, next_link++);
+
+      std::vector<std::string> inputs;
+      for (const auto& link : source_links) {
+        inputs.push_back(link.connect);
+      }
+      auto merger = std::make_unique<SimpleMerger>();
+      merger->SetComponentId(spec.value("id", "merger"));
+      merger->SetInputAddresses(inputs);
+      merger->SetOutputAddresses({sink_link.bind});
+      stages.push_back(makeStage(std::move(merger), spec));
+    }
+
+    if (topology.contains("analyzer")) {
+      const auto& spec = topology["analyzer"];
+      Link analyzer_link = makeLink(transport, base_port, next_link++);
+
+      auto analyzer = std::make_unique<WaveformAnalyzer>();
+      analyzer->SetComponentId(spec.value("id", "analyzer"));
+      analyzer->SetInputAddresses({sink_link.connect});
+      analyzer->SetOutputAddresses({analyzer_link.bind});
+      analyzer->SetWorkerThreads(spec.value("workers", 2u));
+      PulseAnalyzer::Settings settings;
+      settings.polarity = spec.value("polarity", settings.polarity);
+      settings.triggerSample = spec.value("trigger", settings.triggerSample);
+      settings.baselineSamples = spec.value("baseline", settings.baselineSamples);
+      settings.preGate = spec.value("pre_gate", settings.preGate);
+      settings.shortGate = spec.value("short_gate", settings.shortGate);
+      settings.longGate = spec.value("long_gate", settings.longGate);
+      settings.cfdFraction = spec.value("cfd_fraction", settings.cfdFraction);
+      settings.cfdDelay = spec.value("cfd_delay", settings.cfdDelay);
+      settings.sampleNs = spec.value("sample_ns", settings.sampleNs);
+      settings.energyScale = spec.value("scale", settings.energyScale);
+      std::string error;
+      if (!analyzer->SetSettings(settings, &error)) {
+        throw std::runtime_error("analyzer: " + error);
+      }
+      stages.push_back(makeStage(std::move(analyzer), spec));
+      sink_link = analyzer_link;
+    }
+
+    if (topology.contains("reducer")) {
+      const auto& spec = topology["reducer"];
+      Link reducer_link = makeLink(transport, base_port, next_link++);
+
+      auto reducer = std::make_unique<WaveformReducer>();
+      reducer->SetComponentId(spec.value("id", "reducer"));
+      reducer->SetInputAddresses({sink_link.connect});
+      reducer->SetOutputAddresses({reducer_link.bind});
+      reducer->SetPrescale(spec.value("prescale", 0u));
+      std::vector<std::pair<uint8_t, uint8_t>> channels;
+      for (const auto& channel :
+           spec.value("channels", nlohmann::json::array())) {
+        channels.emplace_back(channel.at(0).get<uint8_t>(),
+                              channel.at(1).get<uint8_t>());
+      }
+      reducer->SetWaveformChannels(channels);
+      for (const auto& rule : spec.value("rules", nlohmann::json::array())) {
+        std::string error;
+        if (!reducer->AddRule(rule.get<std::string>(), &error)) {
+          throw std::runtime_error("reducer rule '" +
+                                   rule.get<std::string>() + "': " + error);
+        }
+      }
+      stages.push_back(makeStage(std::move(reducer), spec));
+      sink_link = reducer_link;
+    }
+
+    if (topology.contains("filter")) {
+      const auto& spec = topology["filter"];
+      Link filter_link = makeLink(transport, base_port, next_link++);
+
+      auto filter = std::make_unique<FilterStage>();
+      filter->SetComponentId(spec.value("id", "filter"));
+      filter->SetInputAddresses({sink_link.connect});
+      filter->SetOutputAddresses({filter_link.bind});
+      for (const auto& rule : spec.value("rules", nlohmann::json::array())) {
+        std::string error;
+        if (!filter->AddRule(rule.get<std::string>(), &error)) {
+          throw std::runtime_error("filter rule '" + rule.get<std::string>() +
+                                   "': " + error);
+        }
+      }
+      stages.push_back(makeStage(std::move(filter), spec));
+      sink_link = filter_link;
+    }
+
+    if (topology.contains("calibration")) {
+      const auto& spec = topology["calibration"];
+      Link calibration_link = makeLink(transport, base_port, next_link++);
+
+      auto calibration = std::make_unique<CalibrationStage>();
+      calibration->SetComponentId(spec.value("id", "calibration"));
+      calibration->SetInputAddresses({sink_link.connect});
+      calibration->SetOutputAddresses({calibration_link.bind});
+      Stage stage = makeStage(std::move(calibration), spec);
+      stage.config_path = spec.value("table", "");
+      stages.push_back(std::move(stage));
+      sink_link = calibration_link;
+    }
+
+    sink_spec = topology.value("sink", nlohmann::json::object());
+    if (topology.contains("router")) {
+      const auto& spec = topology["router"];
+      size_t outputs = spec.value("outputs", size_t{2});
+      std::vector<Link> router_links;
+      std::vector<std::string> router_addresses;
+      for (size_t o = 0; o < outputs; ++o) {
+        router_links.push_back(makeLink(transport, base_port, next_link++));
+        router_addresses.push_back(router_links.back().bind);
+      }
+
+      auto router = std::make_unique<Router>();
+      router->SetComponentId(spec.value("id", "router"));
+      router->SetInputAddresses({sink_link.connect});
+      router->SetOutputAddresses(router_addresses);
+      RouteTable::Key key;
+      std::string key_name = spec.value("key", "module");
+      if (!RouteTable::ParseKey(key_name, key)) {
+        throw std::runtime_error("unknown router key '" + key_name + "'");
+      }
+      router->SetRouteKey(key);
+      if (spec.contains("slice_ns") &&
+          !router->SetTimeSlice(spec["slice_ns"].get<double>())) {
+        throw std::runtime_error("router slice_ns must be positive");
+      }
+      if (spec.contains("block") &&
+          !router->SetFrameBlock(spec["block"].get<uint32_t>())) {
+        throw std::runtime_error("router block must be positive");
+      }
+      for (const auto& range : spec.value("ranges", nlohmann::json::array())) {
+        std::string error;
+        if (!router->AddRange(range.get<std::string>(), &error)) {
+          throw std::runtime_error("router range '" +
+                                   range.get<std::string>() + "': " + error);
+        }
+      }
+      stages.push_back(makeStage(std::move(router), spec));
+
+      for (size_t o = 0; o < outputs; ++o) {
+        stages.push_back(
+            makeSink(sinkForOutput(sink_spec, o), router_links[o]));
+        auto* writer =
+            dynamic_cast<FileWriter*>(stages.back().component.get());
+        if (key == RouteTable::Key::Frame && writer &&
+            writer->GetWriteManifest()) {
+          farm_writers.push_back(writer);
+        }
+      }
+    } else {
+      stages.push_back(makeSink(sink_spec, sink_link));
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid topology " << topology_path << ": "
+              << e.what() << std::endl;
+    return 1;
+  }
+
+  // Print configuration
+  std::cout << "=== DELILA2 Pipeline ===" << std::endl;
+  std::cout << "Topology:   " << topology_path << std::endl;
+  std::cout << "Transport:  " << transport << std::endl;
+  std::cout << "Run number: " << run_number << std::endl;
+  std::cout << "Stages:" << std::endl;
+  for (const auto& stage : stages) {
+    std::cout << "  - " << stage.id << std::endl;
+  }
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Initialize and arm upstream first, so binding sides exist before
+  // their peers connect
+  for (auto& stage : stages) {
+    if (stage.start_metrics && !stage.start_metrics()) {
+      std::cerr << "ERROR: Failed to start metrics endpoint for " << stage.id
+                << std::endl;
+      return 1;
+    }
+    if (!stage.component->Initialize(stage.config_path)) {
+      std::cerr << "ERROR: Failed to initialize " << stage.id << std::endl;
+      return 1;
+    }
+    if (!stage.arm()) {
+      std::cerr << "ERROR: Failed to arm " << stage.id << std::endl;
+      return 1;
+    }
+  }
+
+  // Start downstream first, so no stage sends before its consumer runs
+  std::cout << "Starting pipeline (Run " << run_number << ")..." << std::endl;
+  for (auto it = stages.rbegin(); it != stages.rend(); ++it) {
+    if (!it->start(run_number)) {
+      std::cerr << "ERROR: Failed to start " << it->id << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Pipeline running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      for (const auto& stage : stages) {
+        auto status = stage.component->GetStatus();
+        std::cout << "[Status] " << stage.id
+                  << " Events: " << status.metrics.events_processed
+                  << ", Bytes: " << status.metrics.bytes_transferred
+                  << std::endl;
+      }
+    }
+  }
+
+  // Stop upstream first so downstream stages can drain
+  std::cout << "Stopping pipeline..." << std::endl;
+  for (auto& stage : stages) {
+    stage.stop(true);
+  }
+  for (auto& stage : stages) {
+    stage.component->Shutdown();
+  }
+  if (!farm_writers.empty()) {
+    saveRunManifest(farm_writers, sink_spec, run_number);
+  }
+
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  for (const auto& stage : stages) {
+    auto status = stage.component->GetStatus();
+    std::cout << stage.id << ": " << status.metrics.events_processed
+              << " events, " << status.metrics.bytes_transferred << " bytes"
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file reducer_main.cpp
+ * @brief WaveformReducer executable
+ *
+ * Converts full (waveform) events from one upstream stage to minimal
+ * events and keeps waveforms only for sampled or selected events.
+ *
+ * Usage:
+ *   delila_reducer [options]
+ *
+ * Options:
+ *   -i, --input <address>    ZMQ input address (required)
+ *   -o, --output <address>   ZMQ output address (default: tcp://*:5565)
+ *   -p, --prescale <number>  Keep every N-th waveform (default: 0 = off)
+ *   -c, --channel <mod:ch>   Keep all waveforms of a channel (multiple allowed)
+ *   -r, --rule <expression>  Keep waveforms of events passing all rules
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   # One waveform in 100, plus all with a high PSD ratio
+ *   delila_reducer -i tcp://localhost:5555 -p 100 -r "psd > 0.3"
+ */
+
+#include <WaveformReducer.hpp>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "metrics_endpoint.hpp"
+
+using namespace DELILA;
+
+// Global pointer for signal handler
+static WaveformReducer* g_reducer = nullptr;
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+  if (g_reducer) {
+    g_reducer->Stop(true);
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 WaveformReducer - Waveform Reduction\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -i, --input <address>    ZMQ input address (required)\n";
+  std::cout << "  -o, --output <address>   ZMQ output address (default: tcp://*:5565)\n";
+  std::cout << "  -p, --prescale <number>  Keep every N-th waveform (default: 0 = off)\n";
+  std::cout << "  -c, --channel <mod:ch>   Keep all waveforms of a channel (multiple allowed)\n";
+  std::cout << "  -r, --rule <expression>  Keep waveforms of events passing all rules\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Rules use the FilterStage syntax, e.g. \"psd > 0.3\" or \"energy >= 1000\".\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -i tcp://localhost:5555 -p 100 -r \"psd > 0.3\"\n";
+}
+
+int main(int argc, char* argv[]) {
+  // Default configuration
+  std::string input_address;
+  std::string output_address = "tcp://*:5565";
+  std::string metrics_address;  // Empty: no metrics endpoint
+  uint32_t prescale = 0;
+  std::vector<std::pair<uint8_t, uint8_t>> channels;
+  std::vector<std::string> rules;
+
+  // Parse command line arguments
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+
+      if (arg == "-h" || arg == "--help") {
+        printUsage(argv[0]);
+        return 0;
+      } else if (arg == "--metrics") {
+        if (i + 1 < argc) {
+          metrics_address = argv[++i];
+        }
+      } else if (arg == "-i" || arg == "--input") {
+        if (i + 1 < argc) {
+          input_address = argv[++i];
+        }
+      } else if (arg == "-o" || arg == "--output") {
+        if (i + 1 < argc) {
+          output_address = argv[++i];
+        }
+      } else if (arg == "-p" || arg == "--prescale") {
+        if (i + 1 < argc) {
+          prescale = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+      } else if (arg == "-c" || arg == "--channel") {
+        if (i + 1 < argc) {
+          std::string channel = argv[++i];
+          size_t colon = channel.find(':');
+          if (colon == std::string::npos) {
+            std::cerr << "ERROR: Channel must be <module:channel>" << std::endl;
+            return 1;
+          }
+          int module = std::stoi(channel.substr(0, colon));
+          int ch = std::stoi(channel.substr(colon + 1));
+          if (module < 0 || module > 255 || ch < 0 || ch > 255) {
+            std::cerr << "ERROR: Module/channel must be 0-255" << std::endl;
+            return 1;
+          }
+          channels.emplace_back(static_cast<uint8_t>(module),
+                                static_cast<uint8_t>(ch));
+        }
+      } else if (arg == "-r" || arg == "--rule") {
+        if (i + 1 < argc) {
+          rules.push_back(argv[++i]);
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid argument value: " << e.what() << std::endl;
+    return 1;
+  }
+
+  // Validate inputs
+  if (input_address.empty()) {
+    std::cerr << "ERROR: An input address is required (-i option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Create and configure reducer
+  WaveformReducer reducer;
+  g_reducer = &reducer;
+
+  reducer.SetComponentId("reducer");
+  reducer.SetInputAddresses({input_address});
+  reducer.SetOutputAddresses({output_address});
+  reducer.SetPrescale(prescale);
+  reducer.SetWaveformChannels(channels);
+  for (const auto& rule : rules) {
+    std::string error;
+    if (!reducer.AddRule(rule, &error)) {
+      std::cerr << "ERROR: Invalid rule '" << rule << "': " << error
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // Print configuration
+  std::cout << "=== DELILA2 WaveformReducer ===" << std::endl;
+  std::cout << "Input address:  " << input_address << std::endl;
+  std::cout << "Output address: " << output_address << std::endl;
+  std::cout << "Prescale:       "
+            << (prescale > 0 ? std::to_string(prescale) : "off") << std::endl;
+  std::cout << "Channels:       ";
+  if (channels.empty()) {
+    std::cout << "none";
+  }
+  for (const auto& [module, ch] : channels) {
+    std::cout << static_cast<int>(module) << ":" << static_cast<int>(ch)
+              << " ";
+  }
+  std::cout << std::endl;
+  std::cout << "Rules:" << std::endl;
+  if (rules.empty()) {
+    std::cout << "  (none)" << std::endl;
+  }
+  for (const auto& rule : rules) {
+    std::cout << "  - " << rule << std::endl;
+  }
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(reducer, metrics_address)) {
+    return 1;
+  }
+
+  // Initialize
+  std::cout << "Initializing reducer..." << std::endl;
+  if (!reducer.Initialize("")) {
+    std::cerr << "ERROR: Failed to initialize reducer" << std::endl;
+    return 1;
+  }
+
+  // Arm
+  std::cout << "Arming reducer..." << std::endl;
+  if (!reducer.Arm()) {
+    std::cerr << "ERROR: Failed to arm reducer" << std::endl;
+    return 1;
+  }
+
+  // Start with run number 1
+  std::cout << "Starting reducer (Run 1)..." << std::endl;
+  if (!reducer.Start(1)) {
+    std::cerr << "ERROR: Failed to start reducer" << std::endl;
+    return 1;
+  }
+
+  std::cout << "WaveformReducer running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      auto status = reducer.GetStatus();
+      std::cout << "[Status] Events: " << status.metrics.events_processed
+                << ", Waveforms: " << reducer.GetWaveformsKept()
+                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+    }
+  }
+
+  // Cleanup
+  std::cout << "Stopping reducer..." << std::endl;
+  reducer.Stop(true);
+  reducer.Shutdown();
+
+  auto status = reducer.GetStatus();
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  std::cout << "Events:           " << status.metrics.events_processed << std::endl;
+  std::cout << "Waveforms kept:   " << reducer.GetWaveformsKept() << std::endl;
+  std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+
+  g_reducer = nullptr;
+  return 0;
+}
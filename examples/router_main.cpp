@@ -0,0 +1,256 @@
+/**
+ * @file router_main.cpp
+ * @brief Router executable
+ *
+ * Receives events from one upstream stage and splits them across several
+ * outputs by module, channel or time slice, e.g. to spread one stream over
+ * several FileWriters or analyzers. With the frame key, whole frames are
+ * sent in blocks and numbered across all outputs, for a FileWriter farm
+ * (writers with -m; see delila_run_reader).
+ *
+ * Usage:
+ *   delila_router [options]
+ *
+ * Options:
+ *   -i, --input <address>    ZMQ input address (required)
+ *   -o, --output <address>   ZMQ output address (one per output, at least one)
+ *   -k, --key <key>          module, channel, time or frame (default: module)
+ *   -s, --slice <ns>         Time slice width for the time key (default: 1e6)
+ *   -b, --block <frames>     Frames per block for the frame key (default: 64)
+ *   -r, --range <spec>       Route a module/channel range, e.g. "0-3=1"
+ *                            (can specify multiple)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   # Two writers, modules 0-3 on the first and the rest spread over both
+ *   delila_router -i tcp://localhost:5560 -o tcp://*:5580 -o tcp://*:5581 -r "0-3=0"
+ *
+ *   # Writer farm: blocks of 64 frames alternate between two writers
+ *   delila_router -i tcp://localhost:5560 -o tcp://*:5580 -o tcp://*:5581 -k frame
+ */
+
+#include <Router.hpp>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics_endpoint.hpp"
+
+using namespace DELILA;
+
+// Global pointer for signal handler
+static Router* g_router = nullptr;
+static volatile bool g_running = true;
+
+void signalHandler(int signum) {
+  std::cout << "\nReceived signal " << signum << ", shutting down..."
+            << std::endl;
+  g_running = false;
+  if (g_router) {
+    g_router->Stop(true);
+  }
+}
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 Router - Stream Router / Splitter\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -i, --input <address>    ZMQ input address (required)\n";
+  std::cout << "  -o, --output <address>   ZMQ output address (one per output, at least one)\n";
+  std::cout << "  -k, --key <key>          module, channel, time or frame (default: module)\n";
+  std::cout << "  -s, --slice <ns>         Time slice width for the time key (default: 1e6)\n";
+  std::cout << "  -b, --block <frames>     Frames per block for the frame key (default: 64)\n";
+  std::cout << "  -r, --range <spec>       Route a module/channel range, e.g. \"0-3=1\"\n";
+  std::cout << "                           (can specify multiple)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Ranges:\n";
+  std::cout << "  <first>[-<last>]=<output>  first/last: module or module:channel\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -i tcp://localhost:5560 -o tcp://*:5580 -o tcp://*:5581 -r \"0-3=0\"\n";
+  std::cout << "  " << program << " -i tcp://localhost:5560 -o tcp://*:5580 -o tcp://*:5581 -k frame\n";
+}
+
+void printOutputCounts(const Router& router) {
+  auto outputs = router.GetOutputAddresses();
+  auto counts = router.GetOutputCounts();
+  for (size_t o = 0; o < outputs.size() && o < counts.size(); ++o) {
+    std::cout << "  [" << o << " " << outputs[o] << "] " << counts[o]
+              << std::endl;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  // Default configuration
+  std::string input_address;
+  std::vector<std::string> output_addresses;
+  std::string metrics_address;  // Empty: no metrics endpoint
+  std::string key_name = "module";
+  double slice_ns = 1e6;
+  unsigned long block_frames = 64;
+  std::vector<std::string> ranges;
+
+  // Parse command line arguments
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool hasValue = i + 1 < argc;
+
+      if (arg == "-h" || arg == "--help") {
+        printUsage(argv[0]);
+        return 0;
+      } else if (!hasValue) {
+        continue;
+      } else if (arg == "--metrics") {
+        metrics_address = argv[++i];
+      } else if (arg == "-i" || arg == "--input") {
+        input_address = argv[++i];
+      } else if (arg == "-o" || arg == "--output") {
+        output_addresses.push_back(argv[++i]);
+      } else if (arg == "-k" || arg == "--key") {
+        key_name = argv[++i];
+      } else if (arg == "-s" || arg == "--slice") {
+        slice_ns = std::stod(argv[++i]);
+      } else if (arg == "-b" || arg == "--block") {
+        block_frames = std::stoul(argv[++i]);
+      } else if (arg == "-r" || arg == "--range") {
+        ranges.push_back(argv[++i]);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid argument value: " << e.what() << std::endl;
+    return 1;
+  }
+
+  // Validate inputs
+  if (input_address.empty()) {
+    std::cerr << "ERROR: An input address is required (-i option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (output_addresses.empty()) {
+    std::cerr << "ERROR: At least one output address is required (-o option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  RouteTable::Key key;
+  if (!RouteTable::ParseKey(key_name, key)) {
+    std::cerr << "ERROR: Unknown key '" << key_name
+              << "' (module, channel, time or frame)" << std::endl;
+    return 1;
+  }
+
+  // Create and configure router
+  Router router;
+  g_router = &router;
+
+  router.SetComponentId("router");
+  router.SetInputAddresses({input_address});
+  router.SetOutputAddresses(output_addresses);
+  router.SetRouteKey(key);
+  if (!router.SetTimeSlice(slice_ns)) {
+    std::cerr << "ERROR: The time slice must be positive" << std::endl;
+    return 1;
+  }
+  if (block_frames > UINT32_MAX ||
+      !router.SetFrameBlock(static_cast<uint32_t>(block_frames))) {
+    std::cerr << "ERROR: The frame block must be 1 to " << UINT32_MAX
+              << std::endl;
+    return 1;
+  }
+  for (const auto& range : ranges) {
+    std::string error;
+    if (!router.AddRange(range, &error)) {
+      std::cerr << "ERROR: Invalid range '" << range << "': " << error
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // Print configuration
+  std::cout << "=== DELILA2 Router ===" << std::endl;
+  std::cout << "Input address:  " << input_address << std::endl;
+  std::cout << "Outputs:" << std::endl;
+  for (size_t o = 0; o < output_addresses.size(); ++o) {
+    std::cout << "  " << o << ": " << output_addresses[o] << std::endl;
+  }
+  std::cout << "Key:            " << RouteTable::KeyName(key);
+  if (key == RouteTable::Key::Time) {
+    std::cout << " (" << slice_ns << " ns slices)";
+  } else if (key == RouteTable::Key::Frame) {
+    std::cout << " (" << block_frames << " frames per block)";
+  }
+  std::cout << std::endl;
+  for (const auto& range : ranges) {
+    std::cout << "Range:          " << range << std::endl;
+  }
+  std::cout << std::endl;
+
+  // Setup signal handlers
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(router, metrics_address)) {
+    return 1;
+  }
+
+  // Initialize
+  std::cout << "Initializing router..." << std::endl;
+  if (!router.Initialize("")) {
+    std::cerr << "ERROR: Failed to initialize router: "
+              << router.GetStatus().error_message << std::endl;
+    return 1;
+  }
+
+  // Arm
+  std::cout << "Arming router..." << std::endl;
+  if (!router.Arm()) {
+    std::cerr << "ERROR: Failed to arm router" << std::endl;
+    return 1;
+  }
+
+  // Start with run number 1
+  std::cout << "Starting router (Run 1)..." << std::endl;
+  if (!router.Start(1)) {
+    std::cerr << "ERROR: Failed to start router" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Router running. Press Ctrl+C to stop." << std::endl;
+
+  // Main loop - print status periodically
+  while (g_running) {
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    if (g_running) {
+      auto status = router.GetStatus();
+      std::cout << "[Status] Events: " << status.metrics.events_processed
+                << ", Forwarded frames: " << router.GetFramesForwarded()
+                << ", Split frames: " << router.GetFramesSplit()
+                << ", Bytes: " << status.metrics.bytes_transferred << std::endl;
+      printOutputCounts(router);
+    }
+  }
+
+  // Cleanup
+  std::cout << "Stopping router..." << std::endl;
+  router.Stop(true);
+  router.Shutdown();
+
+  auto status = router.GetStatus();
+  std::cout << "\n=== Final Statistics ===" << std::endl;
+  std::cout << "Events routed:    " << status.metrics.events_processed << std::endl;
+  std::cout << "Frames forwarded: " << router.GetFramesForwarded() << std::endl;
+  std::cout << "Frames split:     " << router.GetFramesSplit() << std::endl;
+  std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+  std::cout << "Per-output events:" << std::endl;
+  printOutputCounts(router);
+
+  g_router = nullptr;
+  return 0;
+}
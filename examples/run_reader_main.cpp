@@ -0,0 +1,204 @@
+/**
+ * @file run_reader_main.cpp
+ * @brief Run manifest merger / ordered run reader
+ *
+ * Merges the manifests written by a FileWriter farm (writers with -m behind
+ * "delila_router -k frame") into one run manifest, checks that the run is
+ * complete, and reads every frame back in sequence order, optionally into
+ * a single file identical to what one writer would have written.
+ *
+ * Usage:
+ *   delila_run_reader [options]
+ *
+ * Options:
+ *   -m, --manifest <path>    Writer or run manifest (can specify multiple,
+ *                            at least one)
+ *   -s, --save <path>        Save the merged run manifest
+ *   -o, --output <path>      Write the frames, in order, to one file
+ *   --from <ns>              Only blocks with events at or after this time
+ *   --to <ns>                Only blocks with events at or before this time
+ *   -h, --help               Show this help message
+ *
+ * Example:
+ *   # Two writers on two disks: one run manifest, then one ordered file
+ *   delila_run_reader -m /disk0/run_000001.manifest.json \
+ *                     -m /disk1/run_000001.manifest.json \
+ *                     -s run_000001.manifest.json -o run_000001.dat
+ */
+
+#include <RunManifest.hpp>
+#include <RunReader.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace DELILA;
+
+void printUsage(const char* program) {
+  std::cout << "DELILA2 Run Reader - Run Manifest Merger / Ordered Reader\n\n";
+  std::cout << "Usage: " << program << " [options]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  -m, --manifest <path>    Writer or run manifest (can specify multiple,\n";
+  std::cout << "                           at least one)\n";
+  std::cout << "  -s, --save <path>        Save the merged run manifest\n";
+  std::cout << "  -o, --output <path>      Write the frames, in order, to one file\n";
+  std::cout << "  --from <ns>              Only blocks with events at or after this time\n";
+  std::cout << "  --to <ns>                Only blocks with events at or before this time\n";
+  std::cout << "  -h, --help               Show this help message\n\n";
+  std::cout << "Example:\n";
+  std::cout << "  " << program << " -m /disk0/run_000001.manifest.json -m /disk1/run_000001.manifest.json \\\n";
+  std::cout << "      -s run_000001.manifest.json -o run_000001.dat\n";
+}
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> manifest_paths;
+  std::string save_path;
+  std::string output_path;
+  bool time_range = false;
+  double from_ns = std::numeric_limits<double>::lowest();
+  double to_ns = std::numeric_limits<double>::max();
+
+  // Parse command line arguments
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool hasValue = i + 1 < argc;
+
+      if (arg == "-h" || arg == "--help") {
+        printUsage(argv[0]);
+        return 0;
+      } else if (!hasValue) {
+        continue;
+      } else if (arg == "-m" || arg == "--manifest") {
+        manifest_paths.push_back(argv[++i]);
+      } else if (arg == "-s" || arg == "--save") {
+        save_path = argv[++i];
+      } else if (arg == "-o" || arg == "--output") {
+        output_path = argv[++i];
+      } else if (arg == "--from") {
+        from_ns = std::stod(argv[++i]);
+        time_range = true;
+      } else if (arg == "--to") {
+        to_ns = std::stod(argv[++i]);
+        time_range = true;
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "ERROR: Invalid argument value: " << e.what() << std::endl;
+    return 1;
+  }
+
+  if (manifest_paths.empty()) {
+    std::cerr << "ERROR: At least one manifest is required (-m option)\n";
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Merge the writers' manifests into the run manifest
+  RunManifest manifest;
+  for (const auto& path : manifest_paths) {
+    RunManifest part;
+    std::string error;
+    if (!part.Load(path, &error) || !manifest.Merge(part, &error)) {
+      std::cerr << "ERROR: " << error << std::endl;
+      return 1;
+    }
+  }
+  manifest.Sort();
+
+  const auto& blocks = manifest.GetBlocks();
+  std::cout << "=== DELILA2 Run Reader ===" << std::endl;
+  std::cout << "Run number: " << manifest.GetRunNumber() << std::endl;
+  std::cout << "Files:      " << manifest.GetFiles().size() << std::endl;
+  for (const auto& file : manifest.GetFiles()) {
+    std::cout << "  " << file << std::endl;
+  }
+  std::cout << "Blocks:     " << blocks.size() << std::endl;
+  std::cout << "Frames:     " << manifest.GetFrames() << std::endl;
+  std::cout << "Events:     " << manifest.GetEvents() << std::endl;
+  if (!blocks.empty()) {
+    std::cout << "Sequences:  " << blocks.front().firstSequence << " - "
+              << blocks.back().lastSequence << std::endl;
+  }
+
+  auto overlaps = manifest.FindOverlaps();
+  if (!overlaps.empty()) {
+    std::cerr << "ERROR: " << overlaps.size()
+              << " sequence range(s) held more than once, first "
+              << overlaps.front().firstSequence << " - "
+              << overlaps.front().lastSequence << std::endl;
+    return 1;
+  }
+  auto gaps = manifest.FindGaps();
+  for (const auto& gap : gaps) {
+    std::cout << "WARNING: Frames " << gap.firstSequence << " - "
+              << gap.lastSequence << " are missing" << std::endl;
+  }
+  std::cout << std::endl;
+
+  if (!save_path.empty()) {
+    std::string error;
+    if (!manifest.Save(save_path, &error)) {
+      std::cerr << "ERROR: " << error << std::endl;
+      return 1;
+    }
+    std::cout << "Run manifest saved to " << save_path << std::endl;
+  }
+
+  std::ofstream output;
+  if (!output_path.empty()) {
+    output.open(output_path, std::ios::binary);
+    if (!output.is_open()) {
+      std::cerr << "ERROR: Cannot open " << output_path << std::endl;
+      return 1;
+    }
+  }
+
+  // Read every frame in order; the reader checks them against the manifest
+  RunReader reader;
+  std::string error;
+  if (!reader.Open(manifest, &error)) {
+    std::cerr << "ERROR: " << error << std::endl;
+    return 1;
+  }
+  if (time_range) {
+    reader.SetTimeRange(from_ns, to_ns);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  while (auto frame = reader.Next()) {
+    if (output.is_open()) {
+      output.write(reinterpret_cast<const char*>(frame->data()),
+                   static_cast<std::streamsize>(frame->size()));
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  if (reader.HasError()) {
+    std::cerr << "ERROR: " << reader.GetError() << std::endl;
+    return 1;
+  }
+  if (output.is_open() && !output.good()) {
+    std::cerr << "ERROR: Failed to write " << output_path << std::endl;
+    return 1;
+  }
+
+  std::cout << "=== Read Statistics ===" << std::endl;
+  std::cout << "Frames read:  " << reader.GetFramesRead() << std::endl;
+  std::cout << "Bytes read:   " << reader.GetBytesRead() << std::endl;
+  if (seconds > 0.0) {
+    std::cout << "Throughput:   "
+              << reader.GetBytesRead() / seconds / 1e6 << " MB/s"
+              << std::endl;
+  }
+  if (!output_path.empty()) {
+    std::cout << "Written to:   " << output_path << std::endl;
+  }
+
+  return gaps.empty() ? 0 : 2;
+}
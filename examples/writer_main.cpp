@@ -11,15 +11,26 @@
  *   -i, --input <address>    ZMQ input address (default: tcp://localhost:5560)
  *   -d, --dir <path>         Output directory (default: current directory)
  *   -p, --prefix <string>    File prefix (default: run_)
+ *   -m, --manifest           Write a run manifest next to the data file
+ *   -R, --retransmit <addr>  Reliable delivery: request lost frames from the
+ *                            source's retransmit address (default: off)
+ *   --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)
  *   -h, --help               Show this help message
  *
  * Output files:
  *   Files are named: <prefix><run_number>.dat
  *   Example: run_00001.dat
+ *   With -m also <prefix><run_number>.manifest.json, which records the
+ *   sequence and time range of every block of frames in the file. Writers
+ *   behind "delila_router -k frame" form a writer farm; delila_run_reader
+ *   merges their manifests and reads the run back in order.
  *
  * Example:
  *   # Write data from merger to files in ./data directory
  *   delila_writer -i tcp://localhost:5560 -d ./data -p experiment_
+ *
+ *   # Directly behind "delila_emulator --retransmit tcp://*:5565"
+ *   delila_writer -i tcp://daq1:5555 -R tcp://daq1:5565 -m
  */
 
 #include <FileWriter.hpp>
@@ -29,6 +40,8 @@
 #include <string>
 #include <thread>
 
+#include "metrics_endpoint.hpp"
+
 using namespace DELILA;
 
 // Global pointer for signal handler
@@ -51,10 +64,15 @@ void printUsage(const char* program) {
   std::cout << "  -i, --input <address>    ZMQ input address (default: tcp://localhost:5560)\n";
   std::cout << "  -d, --dir <path>         Output directory (default: current directory)\n";
   std::cout << "  -p, --prefix <string>    File prefix (default: run_)\n";
+  std::cout << "  -m, --manifest           Write a run manifest next to the data file\n";
+  std::cout << "  -R, --retransmit <addr>  Reliable delivery: request lost frames from the\n";
+  std::cout << "                           source's retransmit address (default: off)\n";
+  std::cout << "  --metrics <host:port>    OpenMetrics endpoint, e.g. *:9100 (default: off)\n";
   std::cout << "  -h, --help               Show this help message\n\n";
   std::cout << "Output files:\n";
   std::cout << "  Files are named: <prefix><run_number>.dat\n";
-  std::cout << "  Example: run_00001.dat\n\n";
+  std::cout << "  Example: run_00001.dat\n";
+  std::cout << "  With -m also <prefix><run_number>.manifest.json (see delila_run_reader)\n\n";
   std::cout << "Example:\n";
   std::cout << "  " << program << " -i tcp://localhost:5560 -d ./data -p experiment_\n";
 }
@@ -64,6 +82,9 @@ int main(int argc, char* argv[]) {
   std::string input_address = "tcp://localhost:5560";
   std::string output_dir = ".";
   std::string file_prefix = "run_";
+  std::string metrics_address;  // Empty: no metrics endpoint
+  bool write_manifest = false;
+  std::string retransmit_address;  // Empty: no reliable delivery
 
   // Parse command line arguments
   for (int i = 1; i < argc; ++i) {
@@ -72,6 +93,16 @@ int main(int argc, char* argv[]) {
     if (arg == "-h" || arg == "--help") {
       printUsage(argv[0]);
       return 0;
+    } else if (arg == "--metrics") {
+      if (i + 1 < argc) {
+        metrics_address = argv[++i];
+      }
+    } else if (arg == "-m" || arg == "--manifest") {
+      write_manifest = true;
+    } else if (arg == "-R" || arg == "--retransmit") {
+      if (i + 1 < argc) {
+        retransmit_address = argv[++i];
+      }
     } else if (arg == "-i" || arg == "--input") {
       if (i + 1 < argc) {
         input_address = argv[++i];
@@ -95,6 +126,11 @@ int main(int argc, char* argv[]) {
   std::cout << "Input address:   " << input_address << std::endl;
   std::cout << "Output directory:" << output_dir << std::endl;
   std::cout << "File prefix:     " << file_prefix << std::endl;
+  std::cout << "Run manifest:    " << (write_manifest ? "yes" : "no")
+            << std::endl;
+  if (!retransmit_address.empty()) {
+    std::cout << "Retransmit from: " << retransmit_address << std::endl;
+  }
   std::cout << std::endl;
 
   // Setup signal handlers
@@ -109,6 +145,13 @@ int main(int argc, char* argv[]) {
   writer.SetInputAddresses({input_address});
   writer.SetOutputPath(output_dir);
   writer.SetFilePrefix(file_prefix);
+  writer.SetWriteManifest(write_manifest);
+  writer.SetRetransmitAddress(retransmit_address);
+
+  // Metrics endpoint (optional, serves GET /metrics)
+  if (!StartMetricsEndpoint(writer, metrics_address)) {
+    return 1;
+  }
 
   // Initialize
   std::cout << "Initializing writer..." << std::endl;
@@ -152,6 +195,17 @@ int main(int argc, char* argv[]) {
   std::cout << "\n=== Final Statistics ===" << std::endl;
   std::cout << "Total events:     " << status.metrics.events_processed << std::endl;
   std::cout << "Total bytes:      " << status.metrics.bytes_transferred << std::endl;
+  if (write_manifest) {
+    std::cout << "Run manifest:     " << writer.GetManifestPath() << std::endl;
+  }
+  if (!retransmit_address.empty()) {
+    const auto& latency = writer.GetRecoveryLatency();
+    std::cout << "Frames recovered: " << writer.GetFramesRecovered()
+              << " (" << writer.GetRetransmitRequests() << " requests, p99 "
+              << latency.GetValueAtPercentile(99.0) / 1000 << " us)"
+              << std::endl;
+    std::cout << "Frames lost:      " << writer.GetFramesLost() << std::endl;
+  }
 
   g_writer = nullptr;
   return 0;
@@ -0,0 +1,39 @@
+#ifndef DELILA_CORE_BUILTEVENTDATA_HPP
+#define DELILA_CORE_BUILTEVENTDATA_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "MinimalEventData.hpp"
+
+namespace DELILA {
+namespace Digitizer {
+
+// Hits from any module/channel grouped into one coincidence event by the
+// EventBuilder. Waveforms are not carried; each hit is a MinimalEventData.
+class BuiltEventData {
+public:
+    BuiltEventData() = default;
+
+    // The hit that opened the event's coincidence window
+    const MinimalEventData& GetTrigger() const { return hits[triggerIndex]; }
+    double GetTriggerTimeNs() const { return hits[triggerIndex].timeStampNs; }
+    size_t GetMultiplicity() const { return hits.size(); }
+
+    uint32_t triggerIndex = 0;           // Index of the trigger hit in hits
+    std::vector<MinimalEventData> hits;  // Time-ordered
+};
+
+// Wire layout of one built event (format version 3): this record header,
+// then hitCount packed 22-byte MinimalEventData records
+struct BuiltEventRecordHeader {
+    uint32_t hitCount;
+    uint32_t triggerIndex;
+} __attribute__((packed));
+
+static_assert(sizeof(BuiltEventRecordHeader) == 8, "BuiltEventRecordHeader size is 8 bytes");
+
+} // namespace Digitizer
+} // namespace DELILA
+
+#endif // DELILA_CORE_BUILTEVENTDATA_HPP
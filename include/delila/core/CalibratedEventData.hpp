@@ -0,0 +1,53 @@
+#ifndef DELILA_CORE_CALIBRATEDEVENTDATA_HPP
+#define DELILA_CORE_CALIBRATEDEVENTDATA_HPP
+
+#include <cstdint>
+
+namespace DELILA {
+namespace Digitizer {
+
+// Hit after online calibration (CalibrationStage): energies in calibrated
+// units, timestamp corrected by the channel's time offset. The raw ADC
+// energy is kept so the data can be recalibrated offline.
+class CalibratedEventData {
+public:
+    // Default constructor - zero-initialize all fields
+    CalibratedEventData()
+        : module(0)
+        , channel(0)
+        , rawEnergy(0)
+        , energy(0.0f)
+        , energyShort(0.0f)
+        , timeStampNs(0.0)
+        , flags(0)
+    {
+    }
+
+    // Parameterized constructor
+    CalibratedEventData(uint8_t mod, uint8_t ch, uint16_t raw, float en, float enShort, double timestamp, uint64_t fl)
+        : module(mod)
+        , channel(ch)
+        , rawEnergy(raw)
+        , energy(en)
+        , energyShort(enShort)
+        , timeStampNs(timestamp)
+        , flags(fl)
+    {
+    }
+
+    // Public data members - module and channel first, as in MinimalEventData
+    uint8_t module;          // 1 byte - Hardware module ID
+    uint8_t channel;         // 1 byte - Channel within module
+    uint16_t rawEnergy;      // 2 bytes - Uncalibrated energy (ADC channels)
+    float energy;            // 4 bytes - Calibrated energy
+    float energyShort;       // 4 bytes - Calibrated short gate energy
+    double timeStampNs;      // 8 bytes - Corrected timestamp in nanoseconds
+    uint64_t flags;          // 8 bytes - Status/error flags (as received)
+} __attribute__((packed));
+
+static_assert(sizeof(CalibratedEventData) == 28, "CalibratedEventData packed size is 28 bytes");
+
+} // namespace Digitizer
+} // namespace DELILA
+
+#endif // DELILA_CORE_CALIBRATEDEVENTDATA_HPP
@@ -12,6 +12,8 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -40,6 +42,12 @@ class ZMQTransport;
  * - Provides async job execution with status tracking
  * - Monitors component health via heartbeats
  *
+ * Commands are fanned out concurrently over one persistent REQ connection
+ * per component. Start is issued tier by tier - sinks, then mergers, then
+ * sources - so every consumer is running before its producers; Stop uses
+ * the reverse order so producers flush into consumers that are still up.
+ * Configure, Arm and Reset go to all components at once.
+ *
  * State transitions follow IComponent standard:
  *   Idle -> Configured (after Initialize)
  */
@@ -83,6 +91,36 @@ public:
   void RegisterComponent(const ComponentAddress &address);
   void UnregisterComponent(const std::string &component_id);
 
+  /// Reply timeout for each component command (default 5 s)
+  void SetCommandTimeout(std::chrono::milliseconds timeout);
+  std::chrono::milliseconds GetCommandTimeout() const;
+
+  // === Command ordering ===
+
+  /// Position of a component in the data pipeline
+  enum class ComponentTier { Sink = 0, Merger = 1, Source = 2 };
+
+  /**
+   * @brief Classify a component by its component_type
+   *
+   * Sources (DigitizerSource, Emulator, *Source), mergers (*Merger,
+   * *Builder) and sinks (*Writer, *Monitor*, *Sink). Unknown types are
+   * treated as intermediate stages (Merger tier).
+   */
+  static ComponentTier GetComponentTier(const ComponentAddress &address);
+
+  /**
+   * @brief Group components into the batches a command is sent in
+   *
+   * Batches run one after another; components within a batch are
+   * commanded concurrently. Start orders by (tier, start_order) from sinks
+   * to sources, Stop is the exact reverse, every other command is a single
+   * batch.
+   */
+  static std::vector<std::vector<ComponentAddress>>
+  PlanCommandBatches(const std::vector<ComponentAddress> &components,
+                     CommandType type);
+
   // === Testing utilities ===
   void ForceError(const std::string &message);
   void Reset();
@@ -103,6 +141,16 @@ private:
   // === Command sending ===
   CommandResponse SendCommandToComponent(const ComponentAddress &component,
                                           const Command &cmd);
+  void FanOutCommand(const std::string &job_id, const Command &cmd,
+                     const std::string &verb);
+
+  // Persistent REQ connection to one component. A REQ socket allows a
+  // single outstanding request, hence the per-channel mutex.
+  struct CommandChannel {
+    std::mutex mutex;
+    std::unique_ptr<Net::ZMQTransport> transport;
+  };
+  std::shared_ptr<CommandChannel> GetCommandChannel(const std::string &component_id);
 
   // === State ===
   std::atomic<ComponentState> fState{ComponentState::Idle};
@@ -114,6 +162,8 @@ private:
   std::vector<ComponentAddress> fComponents;
   mutable std::mutex fComponentsMutex;
   std::map<std::string, ComponentState> fComponentStates;
+  std::map<std::string, std::shared_ptr<CommandChannel>> fCommandChannels;
+  std::atomic<int64_t> fCommandTimeoutMs{5000};
 
   // === Job tracking ===
   std::map<std::string, JobStatus> fJobs;
@@ -0,0 +1,89 @@
+/**
+ * @file CalibrationStage.hpp
+ * @brief Online energy calibration / gain matching component
+ *
+ * CalibrationStage applies a per-channel CalibrationTable to every hit and
+ * sends calibrated events (float energies, corrected timestamps).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CalibrationTable.hpp"
+#include "SingleInputStage.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class DataProcessor;
+}  // namespace Net
+
+/**
+ * @brief Calibrates the hits of one stream
+ *
+ * Architecture:
+ *   ReceivingThread -> Queue -> ProcessingThread (calibrate, encode, send)
+ *
+ * Minimal and full event frames become calibrated frames
+ * (FORMAT_VERSION_CALIBRATED_EVENTDATA) with the same sequence number and
+ * event order; waveforms are dropped. Other frames are forwarded unchanged,
+ * EOS in order.
+ *
+ * The calibration table can be replaced whenever the stage is not
+ * running: LoadCalibration(), or a Configure command carrying a JSON table
+ * in its payload or a file in its config_path.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class CalibrationStage : public SingleInputStage {
+public:
+  CalibrationStage();
+  ~CalibrationStage() override;
+
+  // === Configuration ===
+
+  /**
+   * @brief Replace the calibration table (only while not running)
+   * @param path JSON file (see CalibrationTable)
+   * @param error Receives the reason if the table is rejected (may be null)
+   * @return false if the table is invalid or the stage is running; the
+   *         current table is then kept
+   */
+  bool LoadCalibration(const std::string &path, std::string *error = nullptr);
+  bool LoadCalibrationJson(const std::string &text,
+                           std::string *error = nullptr);
+  bool SetCalibration(const CalibrationTable &table);
+
+  /// Channels with a calibration entry
+  size_t GetCalibratedChannelCount() const;
+
+  /// Hits this run from channels without a calibration entry
+  uint64_t GetUncalibratedEvents() const;
+
+protected:
+  // === SingleInputStage hooks ===
+  bool OnInitialize(const std::string &config_path) override;
+  void ResetCounters() override;
+  void AddMetrics(MetricsExporter &exporter) override;
+  bool HandleConfigure(const Command &cmd, std::string &message) override;
+  void ProcessFrame(std::unique_ptr<std::vector<uint8_t>> &data) override;
+
+private:
+  std::unique_ptr<std::vector<uint8_t>> CalibrateFrame(
+      std::unique_ptr<std::vector<uint8_t>> &data, uint32_t format);
+
+  // === Calibration (fixed while running) ===
+  CalibrationTable fTable;
+  std::vector<MinimalEventData> fHits;  // Processing thread only
+
+  std::atomic<uint64_t> fUncalibratedEvents{0};
+  std::unique_ptr<Net::DataProcessor> fDataProcessor;
+};
+
+}  // namespace DELILA
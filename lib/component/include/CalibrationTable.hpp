@@ -0,0 +1,110 @@
+/**
+ * @file CalibrationTable.hpp
+ * @brief Per-channel energy calibration and time offsets
+ *
+ * Coefficients are stored per slot in column arrays and looked up through
+ * a (module, channel) -> slot index, so applying the table to a batch is a
+ * few flat loops the compiler can vectorize. Not thread-safe: Apply() uses
+ * scratch columns held by the table, so each thread needs its own copy.
+ */
+
+#ifndef DELILA_COMPONENT_CALIBRATION_TABLE_HPP
+#define DELILA_COMPONENT_CALIBRATION_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "delila/core/CalibratedEventData.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+namespace DELILA {
+
+using Digitizer::CalibratedEventData;
+using Digitizer::MinimalEventData;
+
+/**
+ * @brief Energy calibration (polynomial or lookup table) and time offset
+ *        for each module/channel
+ *
+ * Channels without an entry are passed through: energy unchanged, no time
+ * offset. The same calibration applies to energy and energyShort.
+ *
+ * JSON form (LoadJson / LoadFile):
+ *   { "channels": [
+ *       { "module": 0, "channel": 0, "poly": [0.5, 0.25], "time_offset": 12.5 },
+ *       { "module": 0, "channel": 1, "lut": [0.0, 0.3, 0.7, ...] } ] }
+ * "poly" lists c0, c1, ... (energy = c0 + c1 x + c2 x^2 + c3 x^3); "lut"
+ * gives the energy for each raw value, the last entry applying above it.
+ * time_offset (ns) is added to the timestamp.
+ */
+class CalibrationTable {
+public:
+  static constexpr size_t kMaxTerms = 4;  ///< Up to cubic
+
+  CalibrationTable();
+
+  /// @return false if coefficients is empty or longer than kMaxTerms
+  bool SetPolynomial(uint8_t module, uint8_t channel,
+                     const std::vector<double> &coefficients);
+  /// @return false if table is empty or longer than 65536 entries
+  bool SetLookupTable(uint8_t module, uint8_t channel,
+                      const std::vector<float> &table);
+  void SetTimeOffset(uint8_t module, uint8_t channel, double offsetNs);
+  void Clear();
+
+  /// Channels with an entry
+  size_t GetChannelCount() const { return fC0.size() - 1; }
+  bool HasChannel(uint8_t module, uint8_t channel) const {
+    return fSlot[Key(module, channel)] != 0;
+  }
+
+  /**
+   * @brief Replace the table with the contents of a JSON document
+   * @param error Receives the reason on failure (may be null)
+   * @return false on a parse or validation error (table unchanged)
+   */
+  bool LoadJson(const std::string &text, std::string *error = nullptr);
+  bool LoadFile(const std::string &path, std::string *error = nullptr);
+
+  /// Calibrated energy of one raw value
+  float CalibrateEnergy(uint8_t module, uint8_t channel, uint16_t raw) const;
+  double GetTimeOffset(uint8_t module, uint8_t channel) const {
+    return fOffset[fSlot[Key(module, channel)]];
+  }
+
+  /**
+   * @brief Calibrate a batch of hits
+   * @param hits Input hits
+   * @param count Number of hits
+   * @param out Receives count records (may point into a frame buffer)
+   * @return number of hits from channels without an entry
+   */
+  size_t Apply(const MinimalEventData *hits, size_t count,
+               CalibratedEventData *out) const;
+
+private:
+  static size_t Key(uint8_t module, uint8_t channel) {
+    return (static_cast<size_t>(module) << 8) | channel;
+  }
+  uint16_t SlotFor(uint8_t module, uint8_t channel);
+
+  // Slot 0 is the pass-through entry
+  std::vector<uint16_t> fSlot;  // Key -> slot
+  std::vector<float> fC0, fC1, fC2, fC3;
+  std::vector<double> fOffset;
+  std::vector<uint32_t> fLutStart;  // Into fLut
+  std::vector<uint32_t> fLutSize;   // 0: polynomial
+  std::vector<float> fLut;
+  bool fAnyLut = false;
+
+  // Scratch columns for Apply()
+  mutable std::vector<uint16_t> fBatchSlot;
+  mutable std::vector<float> fBatchEnergy;
+  mutable std::vector<float> fBatchShort;
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_CALIBRATION_TABLE_HPP
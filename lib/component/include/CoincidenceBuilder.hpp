@@ -0,0 +1,189 @@
+/**
+ * @file CoincidenceBuilder.hpp
+ * @brief Time ordering and coincidence grouping for the EventBuilder
+ *
+ * HitTimeBuckets merges hits from many time-ordered streams into one
+ * time-ordered stream; CoincidenceBuilder groups that stream into built
+ * events and finds the points where it can be cut into independent time
+ * slices for parallel building. Neither class locks: each is owned by one
+ * thread of the EventBuilder.
+ */
+
+#ifndef DELILA_COMPONENT_COINCIDENCE_BUILDER_HPP
+#define DELILA_COMPONENT_COINCIDENCE_BUILDER_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "delila/core/MinimalEventData.hpp"
+
+namespace DELILA {
+
+using Digitizer::MinimalEventData;
+
+/**
+ * @brief Sliding time buckets that release hits in time order
+ *
+ * Hits are appended to the bucket covering their timestamp, in whatever
+ * order the inputs deliver them. Release() takes every bucket that ends at
+ * or before the watermark (the time up to which all inputs are known to be
+ * complete), sorts it and appends it to the output, so the cost per hit is
+ * one append plus a sort of a bucket-sized run. Hits that arrive for a
+ * bucket already released are dropped and counted in GetLateCount().
+ */
+class HitTimeBuckets {
+public:
+  explicit HitTimeBuckets(double bucketNs = 16000.0);
+
+  void Reset();
+
+  void Add(const MinimalEventData &hit);
+  void Add(const std::vector<MinimalEventData> &hits) {
+    for (const auto &hit : hits) {
+      Add(hit);
+    }
+  }
+
+  /// Append, in time order, every buffered hit earlier than @p watermarkNs
+  /// (whole buckets only). @return number of hits appended
+  size_t Release(double watermarkNs, std::vector<MinimalEventData> &out);
+
+  /// Append everything still buffered (end of run)
+  size_t ReleaseAll(std::vector<MinimalEventData> &out);
+
+  size_t GetBufferedCount() const { return fBuffered; }
+  uint64_t GetLateCount() const { return fLate; }
+
+private:
+  using Bucket = std::vector<MinimalEventData>;
+
+  int64_t BucketIndex(double timeNs) const;
+  void AppendSorted(Bucket &bucket, std::vector<MinimalEventData> &out);
+
+  const double fBucketNs;
+  std::map<int64_t, Bucket> fBuckets;  ///< Sparse: only buckets with hits
+  std::map<int64_t, Bucket>::iterator fLastBucket;  ///< Hits come in runs
+  bool fHaveLastBucket = false;
+  bool fReleased = false;
+  int64_t fHorizon = 0;  ///< First bucket index not yet released
+  std::vector<Bucket> fSpare;  ///< Released buckets, capacity kept
+  size_t fBuffered = 0;
+  uint64_t fLate = 0;
+};
+
+/**
+ * @brief Groups a time-ordered hit stream into coincidence events
+ *
+ * A trigger hit (any hit of a trigger channel, or every hit when no
+ * trigger channels are set) opens an event covering
+ * [t - pre, t + post] around its timestamp. Triggers are taken in time
+ * order and each hit joins at most one event: a trigger already inside
+ * an earlier event's window does not open another, and hits claimed by
+ * an earlier event are not reused. Events with fewer than the minimum
+ * number of hits are discarded (their hits stay claimed).
+ *
+ * Building is one forward sweep over the sorted hits, with the window
+ * edges found by moving two indices - no pairwise comparison of hits.
+ */
+class CoincidenceBuilder {
+public:
+  CoincidenceBuilder() = default;
+
+  // === Configuration ===
+
+  void SetWindow(double preNs, double postNs);
+  double GetPreWindowNs() const { return fPreNs; }
+  double GetPostWindowNs() const { return fPostNs; }
+
+  /// Channels whose hits open events; empty = every hit is a trigger
+  void SetTriggerChannels(
+      const std::vector<std::pair<uint8_t, uint8_t>> &channels);
+  bool IsTrigger(const MinimalEventData &hit) const {
+    return fAllTrigger || fTriggers.test(Key(hit.module, hit.channel));
+  }
+
+  void SetMinHits(uint32_t hits) { fMinHits = hits; }
+  uint32_t GetMinHits() const { return fMinHits; }
+
+  // === Building ===
+
+  /**
+   * @brief Visit every event of an independent slice of time-ordered hits
+   * @param sink Called as sink(const MinimalEventData *first,
+   *             uint32_t hitCount, uint32_t triggerIndex)
+   */
+  template <typename Sink>
+  void ForEachEvent(const std::vector<MinimalEventData> &hits,
+                    Sink &&sink) const {
+    const size_t n = hits.size();
+    size_t claimed = 0;  // Hits before this index belong to earlier events
+    size_t i = 0;
+    while (i < n) {
+      if (!IsTrigger(hits[i])) {
+        ++i;
+        continue;
+      }
+      const double t = hits[i].timeStampNs;
+      size_t lo = i;
+      while (lo > claimed && hits[lo - 1].timeStampNs >= t - fPreNs) {
+        --lo;
+      }
+      size_t hi = i + 1;
+      while (hi < n && hits[hi].timeStampNs <= t + fPostNs) {
+        ++hi;
+      }
+      if (hi - lo >= fMinHits) {
+        sink(&hits[lo], static_cast<uint32_t>(hi - lo),
+             static_cast<uint32_t>(i - lo));
+      }
+      claimed = hi;
+      i = hi;
+    }
+  }
+
+  /// Serialize every event of the slice into @p payload (format version 3
+  /// records). @return number of events appended
+  uint32_t Build(const std::vector<MinimalEventData> &hits,
+                 std::vector<uint8_t> &payload) const;
+
+  // === Time slicing ===
+
+  /// Resumable state of FindCut() over a growing slice
+  struct CutScan {
+    size_t position = 0;
+    bool haveTrigger = false;
+    double lastTrigger = 0.0;
+  };
+
+  /**
+   * @brief Find where a time-ordered slice can be split
+   *
+   * A cut is placed before the window of a trigger that starts after the
+   * window of the previous trigger has closed, so no event can span it
+   * and both parts build exactly as the whole would. Only cuts at or
+   * after @p notBeforeNs are taken. Scanning resumes from @p scan; when a
+   * cut is returned, @p scan is updated to describe the part after it.
+   * @return index of the first hit after the cut, or 0 if none yet
+   */
+  size_t FindCut(const std::vector<MinimalEventData> &hits, double notBeforeNs,
+                 CutScan &scan) const;
+
+private:
+  static size_t Key(uint8_t module, uint8_t channel) {
+    return (static_cast<size_t>(module) << 8) | channel;
+  }
+
+  double fPreNs = 500.0;
+  double fPostNs = 500.0;
+  uint32_t fMinHits = 1;
+  bool fAllTrigger = true;
+  std::bitset<256 * 256> fTriggers;
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_COINCIDENCE_BUILDER_HPP
@@ -5,15 +5,26 @@
 #include <delila/core/ComponentConfig.hpp>
 #include <delila/core/ComponentState.hpp>
 #include <delila/core/ComponentStatus.hpp>
+#include <delila/core/EventData.hpp>
 #include <delila/core/IDataComponent.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "LatencyHistogram.hpp"
+#include "MetricsExporter.hpp"
+#include "RateEstimator.hpp"
+#include "RetransmitServer.hpp"
+#include "SpillBuffer.hpp"
+
 namespace DELILA {
 
 // Forward declarations
@@ -22,6 +33,18 @@ class ZMQTransport;
 class DataProcessor;
 } // namespace Net
 
+namespace Digitizer {
+class IDigitizer;
+} // namespace Digitizer
+
+/**
+ * @brief Serialization format used on the output socket
+ */
+enum class DigitizerSourceDataMode {
+  Full,   ///< EventData (format_version 1) - keeps waveforms
+  Minimal ///< MinimalEventData (format_version 2) - 22 bytes per event
+};
+
 /**
  * @brief Data source component that acquires data from digitizer hardware
  *
@@ -29,12 +52,19 @@ class DataProcessor;
  * - 0 input addresses (data comes from hardware)
  * - 1 output address (sends data downstream)
  *
- * In mock mode, generates synthetic event data for testing.
+ * In mock mode, generates synthetic event data for testing. Otherwise
+ * events are read from an IDigitizer, either injected with SetDigitizer()
+ * or created from the configuration file passed to Initialize().
  *
  * Thread model:
  * - Main thread: State management
- * - Data acquisition thread: Reads from digitizer/mock
- * - Data sending thread: Serializes and sends via ZMQ
+ * - Data acquisition thread: Reads from digitizer/mock into a bounded queue
+ * - Data sending thread: Batches events from the queue, serializes and
+ *   sends via ZMQ
+ *
+ * A batch is sent when it reaches the batch size or when the batch timeout
+ * expires, whichever comes first. When the queue is full the acquisition
+ * thread blocks, leaving the events in the digitizer buffer.
  */
 class DigitizerSource : public IDataComponent {
 public:
@@ -62,6 +92,12 @@ public:
   void StartCommandListener() override;
   void StopCommandListener() override;
 
+  // === Metrics endpoint (OpenMetrics over HTTP, see MetricsExporter) ===
+  void SetMetricsAddress(const std::string &address);  ///< e.g. "*:9100"
+  std::string GetMetricsAddress() const;
+  bool StartMetricsExporter();
+  void StopMetricsExporter();
+
   // === Public control methods (for direct testing without command channel) ===
   bool Arm();
   bool Start(uint32_t run_number);
@@ -73,6 +109,91 @@ public:
   void SetMockMode(bool enable);
   void SetMockEventRate(uint32_t events_per_second);
 
+  /**
+   * @brief Use an externally created digitizer for the hardware path
+   *
+   * The digitizer must already be initialized; Initialize() configures it.
+   * Must be called while Idle.
+   */
+  void SetDigitizer(std::unique_ptr<Digitizer::IDigitizer> digitizer);
+
+  /**
+   * @brief Set the output serialization format
+   * @param mode Full or Minimal (default: Full)
+   */
+  void SetDataMode(DigitizerSourceDataMode mode);
+  DigitizerSourceDataMode GetDataMode() const;
+
+  /**
+   * @brief Send Full mode waveforms compactly (format_version 5)
+   * @param enable int16_t analog samples and bit-packed digital probes
+   *               (default: false = format_version 1)
+   */
+  void SetCompactWaveforms(bool enable);
+  bool GetCompactWaveforms() const;
+
+  /**
+   * @brief Set the maximum number of events per message
+   * @param events Events per batch (default: 1024)
+   */
+  void SetBatchSize(size_t events);
+  size_t GetBatchSize() const;
+
+  /**
+   * @brief Set the maximum time a partial batch is held before sending
+   * @param ms Timeout in milliseconds (default: 10); 0 is raised to 1 so
+   *           the sending thread still sleeps between empty polls
+   */
+  void SetBatchTimeoutMs(uint32_t ms);
+  uint32_t GetBatchTimeoutMs() const;
+
+  /**
+   * @brief Set the queue capacity between acquisition and sending threads
+   * @param events Maximum number of queued events (default: 100000)
+   */
+  void SetMaxQueueEvents(size_t events);
+  size_t GetMaxQueueEvents() const;
+
+  /**
+   * @brief Enable reliable delivery (see RetransmitServer)
+   * @param address Retransmit side channel to bind when armed, e.g.
+   *                "tcp://0.0.0.0:5565"; empty disables it (default)
+   */
+  void SetRetransmitAddress(const std::string &address);
+  std::string GetRetransmitAddress() const;
+
+  /**
+   * @brief Set the number of sent frames kept for retransmission
+   * @param frames Replay buffer size (default: 4096)
+   */
+  void SetReplayBufferSize(size_t frames);
+  size_t GetReplayBufferSize() const;
+
+  /**
+   * @brief Enable spill mode (see SpillBuffer)
+   * @param directory Existing local directory for the spill file, which
+   *                  is created when armed; empty disables spill mode
+   *                  (default)
+   *
+   * Frames the output is not ready for are held back instead of dropped,
+   * so the sending thread keeps draining the event queue (and the
+   * digitizer) while downstream stalls.
+   */
+  void SetSpillDirectory(const std::string &directory);
+  std::string GetSpillDirectory() const;
+
+  /**
+   * @brief Set the size of the spill file
+   * @param bytes Spill ring capacity (default: 1 GiB)
+   */
+  void SetSpillCapacity(uint64_t bytes);
+  uint64_t GetSpillCapacity() const;
+
+  /**
+   * @brief Get the number of events waiting to be sent
+   */
+  size_t GetQueueSize() const;
+
   // === Testing utilities ===
   void ForceError(const std::string &message);
 
@@ -97,6 +218,25 @@ private:
   // Mock mode settings
   bool fMockMode = false;
   uint32_t fMockEventRate = 1000; // events per second
+  std::mt19937 fMockRng{std::random_device{}()};
+  double fMockTimestampNs = 0.0;
+
+  // Hardware
+  std::unique_ptr<Digitizer::IDigitizer> fDigitizer;
+
+  // Output format and batching
+  DigitizerSourceDataMode fDataMode{DigitizerSourceDataMode::Full};
+  bool fCompactWaveforms = false;
+  size_t fBatchSize = 1024;
+  uint32_t fBatchTimeoutMs = 10;
+
+  // Reliable delivery
+  std::string fRetransmitAddress;
+  size_t fReplayBufferSize = Net::ReplayBuffer::kDefaultMaxFrames;
+
+  // Spill mode
+  std::string fSpillDirectory;
+  uint64_t fSpillCapacity = SpillBuffer::kDefaultCapacityBytes;
 
   // Run information
   std::atomic<uint32_t> fRunNumber{0};
@@ -106,16 +246,40 @@ private:
   std::atomic<uint64_t> fEventsProcessed{0};
   std::atomic<uint64_t> fBytesTransferred{0};
   std::atomic<uint64_t> fHeartbeatCounter{0};
+  std::atomic<uint64_t> fDrainLatencyTotalUs{0};
+  std::atomic<uint64_t> fDrainLatencySamples{0};
+  LatencyRecorder fLatency;  // Residency/processing recorded by the sender
+  mutable RateEstimator fRates;  // Per-channel counts from the sender
+
+  // === Bounded queue between acquisition and sending threads ===
+  using Clock = std::chrono::steady_clock;
+  using EventList = std::vector<std::unique_ptr<Digitizer::EventData>>;
+  struct QueuedBlock {
+    std::unique_ptr<EventList> events;
+    size_t offset = 0; ///< Events before this index were already taken
+    Clock::time_point enqueued;
+  };
+  std::deque<QueuedBlock> fEventQueue;
+  Clock::time_point fBatchEnqueued; ///< Oldest block of the current batch
+  size_t fQueuedEvents = 0;
+  size_t fMaxQueueEvents = 100000;
+  mutable std::mutex fQueueMutex;
+  std::condition_variable fQueueNotEmpty;
+  std::condition_variable fQueueNotFull;
 
   // Worker threads
   std::unique_ptr<std::thread> fAcquisitionThread;
   std::unique_ptr<std::thread> fSendingThread;
   std::atomic<bool> fRunning{false};
+  std::atomic<bool> fAcquisitionDone{true};
+  std::atomic<bool> fAbort{false};
   std::atomic<bool> fShutdownRequested{false};
 
   // Network transport
   std::unique_ptr<Net::ZMQTransport> fTransport;
   std::unique_ptr<Net::DataProcessor> fDataProcessor;
+  RetransmitServer fRetransmit; // Serves requests while armed
+  SpillBuffer fSpill;           // Open from arm to reset in spill mode
 
   // Command channel
   std::string fCommandAddress;
@@ -123,11 +287,23 @@ private:
   std::unique_ptr<std::thread> fCommandListenerThread;
   std::atomic<bool> fCommandListenerRunning{false};
 
+  // Metrics endpoint
+  MetricsEndpoint fMetrics;
+
   // Helper methods
   bool TransitionTo(ComponentState newState);
   void AcquisitionLoop();
   void SendingLoop();
-  void GenerateMockEvents();
+  std::unique_ptr<EventList> GenerateMockEvents();
+  void DrainDigitizer();
+  bool EnqueueEvents(std::unique_ptr<EventList> events);
+  size_t DequeueBatch(EventList &batch);
+  void SendBatch(EventList &batch);
+  bool SendFrame(std::unique_ptr<std::vector<uint8_t>> &data);
+  bool TransmitFrame(std::unique_ptr<std::vector<uint8_t>> &data);
+  bool WaitForSendReady(std::chrono::milliseconds timeout);
+  void JoinWorkers();
+  void ClearQueue();
   void CommandListenerLoop();
   void HandleCommand(const Command &cmd);
 };
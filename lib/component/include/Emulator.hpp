@@ -15,6 +15,7 @@
 #include <delila/core/IDataComponent.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -23,6 +24,11 @@
 #include <utility>
 #include <vector>
 
+#include "MetricsExporter.hpp"
+#include "RateEstimator.hpp"
+#include "RetransmitServer.hpp"
+#include "SpillBuffer.hpp"
+
 namespace DELILA {
 
 // Forward declarations
@@ -85,6 +91,12 @@ class Emulator : public IDataComponent {
   void StartCommandListener() override;
   void StopCommandListener() override;
 
+  // === Metrics endpoint (OpenMetrics over HTTP, see MetricsExporter) ===
+  void SetMetricsAddress(const std::string& address);  ///< e.g. "*:9100"
+  std::string GetMetricsAddress() const;
+  bool StartMetricsExporter();
+  void StopMetricsExporter();
+
   // === Public control methods ===
   bool Arm();
   bool Start(uint32_t run_number);
@@ -139,6 +151,57 @@ class Emulator : public IDataComponent {
   void SetWaveformSize(size_t size);
   size_t GetWaveformSize() const;
 
+  /**
+   * @brief Send Full mode waveforms compactly (format version 5)
+   * @param enable int16_t analog samples and bit-packed digital probes
+   *               (default: false = format version 1)
+   */
+  void SetCompactWaveforms(bool enable);
+  bool GetCompactWaveforms() const;
+
+  /**
+   * @brief Set the number of events sent per data frame
+   * @param size Events per frame (default: 1)
+   *
+   * The event rate is kept: frames are sent at rate / size per second.
+   */
+  void SetBatchSize(size_t size);
+  size_t GetBatchSize() const;
+
+  /**
+   * @brief Enable reliable delivery (see RetransmitServer)
+   * @param address Retransmit side channel to bind when armed, e.g.
+   *                "tcp://0.0.0.0:5565"; empty disables it (default)
+   */
+  void SetRetransmitAddress(const std::string& address);
+  std::string GetRetransmitAddress() const;
+
+  /**
+   * @brief Set the number of sent frames kept for retransmission
+   * @param frames Replay buffer size (default: 4096)
+   */
+  void SetReplayBufferSize(size_t frames);
+  size_t GetReplayBufferSize() const;
+
+  /**
+   * @brief Enable spill mode (see SpillBuffer)
+   * @param directory Existing local directory for the spill file, which
+   *                  is created when armed; empty disables spill mode
+   *                  (default)
+   *
+   * Frames the output is not ready for are held back, on disk once more
+   * than a few are waiting, and sent in order when downstream catches up.
+   */
+  void SetSpillDirectory(const std::string& directory);
+  std::string GetSpillDirectory() const;
+
+  /**
+   * @brief Set the size of the spill file
+   * @param bytes Spill ring capacity (default: 1 GiB)
+   */
+  void SetSpillCapacity(uint64_t bytes);
+  uint64_t GetSpillCapacity() const;
+
   /**
    * @brief Set random seed for reproducible tests
    * @param seed Random seed value
@@ -160,6 +223,9 @@ class Emulator : public IDataComponent {
   // === Helper methods ===
   bool TransitionTo(ComponentState newState);
   void GenerationLoop();
+  bool SendFrame(std::unique_ptr<std::vector<uint8_t>>& data);
+  bool TransmitFrame(std::unique_ptr<std::vector<uint8_t>>& data);
+  bool WaitForSendReady(std::chrono::milliseconds timeout);
   void CommandListenerLoop();
   void HandleCommand(const Command& cmd);
 
@@ -179,6 +245,12 @@ class Emulator : public IDataComponent {
   uint16_t fEnergyMin{0};
   uint16_t fEnergyMax{16383};
   size_t fWaveformSize{0};
+  bool fCompactWaveforms{false};
+  size_t fBatchSize{1};
+  std::string fRetransmitAddress;
+  size_t fReplayBufferSize{Net::ReplayBuffer::kDefaultMaxFrames};
+  std::string fSpillDirectory;
+  uint64_t fSpillCapacity{SpillBuffer::kDefaultCapacityBytes};
 
   // === Run state ===
   std::atomic<uint32_t> fRunNumber{0};
@@ -186,6 +258,7 @@ class Emulator : public IDataComponent {
   std::atomic<uint64_t> fEventsProcessed{0};
   std::atomic<uint64_t> fBytesTransferred{0};
   std::atomic<uint64_t> fHeartbeatCounter{0};
+  mutable RateEstimator fRates;
 
   // === Threads ===
   std::unique_ptr<std::thread> fGenerationThread;
@@ -195,6 +268,8 @@ class Emulator : public IDataComponent {
   // === Network components ===
   std::unique_ptr<Net::ZMQTransport> fTransport;
   std::unique_ptr<Net::DataProcessor> fDataProcessor;
+  RetransmitServer fRetransmit;  // Serves requests while armed
+  SpillBuffer fSpill;            // Open from arm to reset in spill mode
 
   // === Random number generation ===
   std::mt19937_64 fRng;
@@ -209,6 +284,9 @@ class Emulator : public IDataComponent {
   std::unique_ptr<Net::ZMQTransport> fCommandTransport;
   std::unique_ptr<std::thread> fCommandListenerThread;
   std::atomic<bool> fCommandListenerRunning{false};
+
+  // === Metrics endpoint ===
+  MetricsEndpoint fMetrics;
 };
 
 }  // namespace DELILA
@@ -0,0 +1,213 @@
+/**
+ * @file EventBuilder.hpp
+ * @brief Online coincidence event builder component
+ *
+ * EventBuilder receives hits from N upstream sources, puts them in time
+ * order and groups them into coincidence events around trigger channels.
+ * Built events are sent downstream as FORMAT_VERSION_BUILT_EVENTDATA
+ * frames.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CoincidenceBuilder.hpp"
+#include "StageComponent.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class DataProcessor;
+class EOSTracker;
+}  // namespace Net
+
+/**
+ * @brief Groups hits from several modules into coincidence events
+ *
+ * Inputs are expected to be time-ordered per module (as digitizers and
+ * the Emulator send them); Minimal and full EventData frames are both
+ * accepted, waveforms are dropped.
+ *
+ * Architecture:
+ *   N ReceivingThreads -> SortingThread -> W BuildWorkers -> SendingThread
+ *
+ * - ReceivingThreads decode frames into hits.
+ * - SortingThread merges the hits in HitTimeBuckets. A module's stream is
+ *   complete up to its newest hit (less the reorder window); buckets that
+ *   end before the oldest such time over active modules are released in
+ *   time order. The ordered stream is cut into slices of about slice_ns at
+ *   points no coincidence window spans (CoincidenceBuilder::FindCut).
+ * - BuildWorkers build whole slices in parallel; since no event crosses a
+ *   cut, the result does not depend on the number of workers.
+ * - SendingThread sends the slices' frames in time order.
+ *
+ * Nothing is released until every input has delivered data (or a second
+ * has passed). A module that has sent nothing for a second stops holding
+ * back the other modules; hits it sends later for already released time
+ * are dropped and counted as late.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class EventBuilder : public StageComponent {
+public:
+  EventBuilder();
+  ~EventBuilder() override;
+
+  // === Configuration ===
+
+  /**
+   * @brief Set the coincidence window around each trigger hit
+   * @param preNs  Window start before the trigger (default: 500)
+   * @param postNs Window end after the trigger (default: 500)
+   */
+  void SetCoincidenceWindow(double preNs, double postNs);
+  double GetPreWindowNs() const;
+  double GetPostWindowNs() const;
+
+  /**
+   * @brief Set the channels whose hits open events
+   * @param channels (module, channel) pairs; empty = every hit (default)
+   */
+  void SetTriggerChannels(
+      const std::vector<std::pair<uint8_t, uint8_t>> &channels);
+  std::vector<std::pair<uint8_t, uint8_t>> GetTriggerChannels() const;
+
+  /**
+   * @brief Set the minimum number of hits for an event to be sent
+   * @param hits Minimum multiplicity, at least 1 (default: 1)
+   */
+  void SetMinHits(uint32_t hits);
+  uint32_t GetMinHits() const;
+
+  /**
+   * @brief Set the number of build worker threads
+   * @param count Worker threads, at least 1 (default: 1)
+   */
+  void SetWorkerThreads(uint32_t count);
+  uint32_t GetWorkerThreads() const;
+
+  /**
+   * @brief Set the target time span of the slices handed to workers
+   *
+   * Also bounds the latency added by building; slices end at the first
+   * safe cut after this span.
+   * @param ns Slice length in nanoseconds (default: 1 ms)
+   */
+  void SetSliceNs(double ns);
+  double GetSliceNs() const;
+
+  /**
+   * @brief Allow hits of one module to arrive out of time order
+   * @param ns How far behind the module's newest hit a hit may still
+   *           arrive (default: 0, streams strictly time-ordered)
+   */
+  void SetReorderWindowNs(double ns);
+  double GetReorderWindowNs() const;
+
+  /**
+   * @brief Get the number of hit batches waiting to be sorted
+   */
+  size_t GetQueueSize() const override;
+
+protected:
+  // === StageComponent hooks ===
+  void ResetCounters() override;
+  void StartThreads() override;
+  void StopThreads(bool graceful) override;
+  void AddMetrics(MetricsExporter &exporter) override;
+
+private:
+  // One built slice, ready to be framed and sent
+  struct BuiltSlice {
+    std::unique_ptr<std::vector<uint8_t>> frame;  ///< Header space + payload
+    uint32_t events = 0;
+    uint64_t oldest_ns = 0;  ///< Receive time of its oldest frame, 0 if untimed
+    bool eos = false;        ///< End-of-stream marker, no payload
+  };
+
+  struct BuildJob {
+    std::vector<MinimalEventData> hits;
+    uint64_t oldest_ns = 0;
+    std::promise<BuiltSlice> result;
+  };
+
+  struct HitBatch {
+    std::vector<MinimalEventData> hits;
+    uint64_t received_ns = 0;  ///< Receive time if timed, else 0
+    size_t input = 0;
+  };
+
+  // === Helper methods ===
+  void ReceivingLoop(size_t input_index);
+  void SortingLoop();
+  void BuildWorker();
+  void SendingLoop();
+  bool DecodeHits(std::unique_ptr<std::vector<uint8_t>> &data,
+                  Net::DataProcessor &processor,
+                  std::vector<MinimalEventData> &hits);
+  void DispatchSlice(std::vector<MinimalEventData> &&hits, uint64_t oldest_ns);
+  void DispatchEOS();
+
+  // === Building configuration ===
+  double fPreWindowNs = 500.0;
+  double fPostWindowNs = 500.0;
+  std::vector<std::pair<uint8_t, uint8_t>> fTriggerChannels;
+  uint32_t fMinHits = 1;
+  uint32_t fWorkerThreads = 1;
+  double fSliceNs = 1e6;
+  double fReorderWindowNs = 0.0;
+  CoincidenceBuilder fBuilder;  // Copy of the settings for the current run
+
+  static constexpr double kBucketNs = 16000.0;
+  static constexpr uint64_t kModuleIdleNs = 1000000000;  // 1 s
+  static constexpr size_t kMaxSliceHits = 1 << 20;  // Forced cut beyond this
+
+  // === Run state ===
+  std::atomic<uint64_t> fHitsReceived{0};
+  std::atomic<uint64_t> fLateHits{0};
+  std::atomic<uint64_t> fForcedCuts{0};
+
+  // === Receive -> sort queue ===
+  std::deque<HitBatch> fHitQueue;
+  mutable std::mutex fHitQueueMutex;
+  std::condition_variable fHitQueueNotEmpty;
+  std::condition_variable fHitQueueNotFull;
+
+  // === Sort -> build -> send queues ===
+  std::deque<BuildJob> fJobQueue;
+  std::deque<std::future<BuiltSlice>> fSliceQueue;  // In time order
+  std::mutex fSliceMutex;
+  std::condition_variable fJobAvailable;
+  std::condition_variable fSliceAvailable;
+  std::condition_variable fSliceSpace;
+  bool fSortDone = false;  // Guarded by fSliceMutex
+
+  // === Threads ===
+  std::vector<std::unique_ptr<std::thread>> fReceivingThreads;
+  std::unique_ptr<std::thread> fSortingThread;
+  std::vector<std::unique_ptr<std::thread>> fBuildThreads;
+  std::unique_ptr<std::thread> fSendingThread;
+  std::atomic<bool> fReceiveDone{false};
+  std::atomic<bool> fAbort{false};
+
+  std::unique_ptr<Net::DataProcessor> fDataProcessor;  // Sending thread
+
+  // === EOS tracking ===
+  std::unique_ptr<Net::EOSTracker> fEOSTracker;
+  std::atomic<size_t> fEOSReceivedCount{0};
+  std::atomic<bool> fAllEOS{false};
+};
+
+}  // namespace DELILA
@@ -0,0 +1,110 @@
+/**
+ * @file EventFilter.hpp
+ * @brief Compiled event selection rules for the FilterStage
+ *
+ * Rules are parsed once into field/range tests and evaluated column by
+ * column over a whole batch, so each rule is a branch-free loop the
+ * compiler can vectorize. Not thread-safe: owned by one thread.
+ */
+
+#ifndef DELILA_COMPONENT_EVENT_FILTER_HPP
+#define DELILA_COMPONENT_EVENT_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "delila/core/MinimalEventData.hpp"
+
+namespace DELILA {
+
+using Digitizer::MinimalEventData;
+
+/**
+ * @brief Conjunction of per-event rules, evaluated over batches
+ *
+ * Rule syntax (one rule per expression, all rules must pass):
+ *   <field> <op> <number>   field: module, channel, energy, energy_short,
+ *                           psd, multiplicity; op: < <= > >= == !=
+ *   flags none <mask>       pass if none of the bits are set
+ *   flags any <mask>        pass if at least one bit is set
+ * A mask is a number (e.g. 0x5) or flag names joined by '|': pileup,
+ * trigger_lost, over_range. psd is (energy - energy_short) / energy, 0 for
+ * zero energy. multiplicity is the hit count of a built event, 1 for hits.
+ *
+ * Examples: "energy >= 100", "flags none pileup|over_range", "psd > 0.2"
+ */
+class EventFilter {
+public:
+  enum class Field : uint8_t {
+    Module,
+    Channel,
+    Energy,
+    EnergyShort,
+    PsdRatio,
+    Multiplicity,
+    Flags
+  };
+
+  /// One compiled rule
+  struct Rule {
+    std::string expression;  ///< As given to AddRule()
+    Field field = Field::Energy;
+    float lo = 0.0f;         ///< Numeric fields: value in [lo, hi] ...
+    float hi = 0.0f;
+    bool negate = false;     ///< ... or outside it (!=)
+    uint64_t mask = 0;       ///< Flags: bits tested
+    bool anySet = false;     ///< Flags: pass if any bit set, else if none
+  };
+
+  /// A batch of events split into columns
+  struct Batch {
+    std::vector<float> module;
+    std::vector<float> channel;
+    std::vector<float> energy;
+    std::vector<float> energyShort;
+    std::vector<float> psd;
+    std::vector<float> multiplicity;
+    std::vector<uint64_t> flags;
+
+    size_t Size() const { return energy.size(); }
+    void Clear();
+    void Add(uint8_t module, uint8_t channel, uint16_t energy,
+             uint16_t energyShort, uint64_t flags, uint32_t multiplicity = 1);
+    void Add(const MinimalEventData &hit, uint32_t multiplicity = 1) {
+      Add(hit.module, hit.channel, hit.energy, hit.energyShort, hit.flags,
+          multiplicity);
+    }
+  };
+
+  /**
+   * @brief Parse and add a rule
+   * @param error Receives the reason if parsing fails (may be null)
+   * @return false if the expression is not valid (no rule added)
+   */
+  bool AddRule(const std::string &expression, std::string *error = nullptr);
+  void Clear() { fRules.clear(); }
+
+  const std::vector<Rule> &GetRules() const { return fRules; }
+  size_t GetRuleCount() const { return fRules.size(); }
+
+  /**
+   * @brief Evaluate every rule over a batch
+   * @param pass       Resized to the batch; 1 where all rules pass
+   * @param ruleCounts Per rule, incremented by the events that pass it
+   *                   (each rule counted on the whole batch); resized to
+   *                   the rule count if smaller
+   * @return number of events passing all rules
+   */
+  size_t Evaluate(const Batch &batch, std::vector<uint8_t> &pass,
+                  std::vector<uint64_t> &ruleCounts) const;
+
+private:
+  std::vector<Rule> fRules;
+  mutable std::vector<uint8_t> fRuleResult;  // Scratch for Evaluate()
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_EVENT_FILTER_HPP
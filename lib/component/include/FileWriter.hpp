@@ -7,7 +7,10 @@
 #include <delila/core/ComponentStatus.hpp>
 #include <delila/core/IDataComponent.hpp>
 
+#include <GapRecovery.hpp>
+
 #include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <mutex>
@@ -15,12 +18,19 @@
 #include <thread>
 #include <vector>
 
+#include "LatencyHistogram.hpp"
+#include "MetricsExporter.hpp"
+#include "RateEstimator.hpp"
+#include "RunManifest.hpp"
+
 namespace DELILA {
 
 // Forward declarations
 namespace Net {
 class ZMQTransport;
 class DataProcessor;
+struct BinaryDataHeader;
+struct EventRecordRef;
 } // namespace Net
 
 /**
@@ -33,6 +43,23 @@ class DataProcessor;
  * Files are written in binary format with run number in filename.
  * Example: run_000042.dat
  *
+ * With SetWriteManifest(true), every frame written is also indexed (see
+ * RunManifest) and the index is saved next to the data file when the run
+ * stops, e.g. run_000042.manifest.json. Several writers behind a Router
+ * with the frame key form a writer farm; merging their manifests gives the
+ * run manifest that RunReader reads the whole run back with, in order.
+ *
+ * With a retransmit address (reliable delivery), sequence gaps in the
+ * input are not just lost: the missing frames are requested from the
+ * source's RetransmitServer and written when they arrive, after the
+ * frames that overtook them. EOS is held back until every missing frame
+ * has been recovered or given up on (SetRetransmitTimeoutMs).
+ * Reliable delivery needs a direct link to one source: behind a merger
+ * the sources' sequence numbers overlap and no single RetransmitServer
+ * holds their frames, so the first merged frame (source_id != 0) turns
+ * it off for the run. Every frame is still written, and the status
+ * reports the error.
+ *
  * Thread model:
  * - Main thread: State management
  * - Data receiving thread: Receives and deserializes from ZMQ
@@ -64,6 +91,12 @@ public:
   void StartCommandListener() override;
   void StopCommandListener() override;
 
+  // === Metrics endpoint (OpenMetrics over HTTP, see MetricsExporter) ===
+  void SetMetricsAddress(const std::string &address);  ///< e.g. "*:9100"
+  std::string GetMetricsAddress() const;
+  bool StartMetricsExporter();
+  void StopMetricsExporter();
+
   // === Public control methods (for direct testing without command channel) ===
   bool Arm();
   bool Start(uint32_t run_number);
@@ -77,6 +110,31 @@ public:
   void SetFilePrefix(const std::string &prefix);
   std::string GetFilePrefix() const;
 
+  /// Index written frames and save the manifest when the run stops
+  void SetWriteManifest(bool enable);
+  bool GetWriteManifest() const;
+  /// Manifest of the current or last run ("" unless enabled)
+  std::string GetManifestPath() const;
+
+  /**
+   * @brief Request lost frames from the source (reliable delivery)
+   * @param address The source's retransmit address, e.g.
+   *                "tcp://daq1:5565"; empty disables it (default)
+   */
+  void SetRetransmitAddress(const std::string &address);
+  std::string GetRetransmitAddress() const;
+
+  /// Time after which a missing frame counts as lost (default: 5000)
+  void SetRetransmitTimeoutMs(uint32_t ms);
+  uint32_t GetRetransmitTimeoutMs() const;
+
+  // === Reliable delivery statistics (current or last run) ===
+  uint64_t GetFramesRecovered() const;
+  uint64_t GetFramesLost() const;
+  uint64_t GetRetransmitRequests() const;
+  /// Time from detecting a gap to receiving the missing frame
+  const LatencyHistogram &GetRecoveryLatency() const;
+
   // === Testing utilities ===
   void ForceError(const std::string &message);
 
@@ -105,6 +163,11 @@ private:
   // File settings
   std::string fOutputPath;
   std::string fFilePrefix = "run_";
+  bool fWriteManifest = false;
+
+  // Reliable delivery
+  std::string fRetransmitAddress;
+  uint32_t fRetransmitTimeoutMs = 5000;
 
   // Run information
   std::atomic<uint32_t> fRunNumber{0};
@@ -114,6 +177,8 @@ private:
   std::atomic<uint64_t> fEventsProcessed{0};
   std::atomic<uint64_t> fBytesTransferred{0};
   std::atomic<uint64_t> fHeartbeatCounter{0};
+  LatencyRecorder fLatency;  // Recorded by the receiving thread
+  mutable RateEstimator fRates;  // Counted by the receiving thread
 
   // Worker threads
   std::unique_ptr<std::thread> fReceivingThread;
@@ -125,8 +190,24 @@ private:
   std::unique_ptr<Net::ZMQTransport> fTransport;
   std::unique_ptr<Net::DataProcessor> fDataProcessor;
 
+  // Retransmit side channel and gap tracking (receiving thread)
+  std::unique_ptr<Net::ZMQTransport> fRetransmitTransport;
+  Net::GapRecovery fRecovery;
+  LatencyHistogram fRecoveryLatency;
+  bool fReliable = false;    // Gap tracking on for this run
+  bool fEOSPending = false;  // EOS received while frames are missing
+  std::atomic<bool> fMergedInput{false};  // Reliable delivery turned off
+  static constexpr const char *kMergedInputError =
+      "Reliable delivery disabled: merged input cannot be retransmitted";
+
   // File output
   std::unique_ptr<std::ofstream> fOutputFile;
+  std::string fOutputFilePath;
+  uint64_t fFileOffset = 0;  // Bytes written to the current file
+
+  // Manifest of the current file (receiving thread while running)
+  RunManifest fManifest;
+  std::vector<Net::EventRecordRef> fRecords;
 
   // Command channel
   std::string fCommandAddress;
@@ -134,6 +215,9 @@ private:
   std::unique_ptr<std::thread> fCommandListenerThread;
   std::atomic<bool> fCommandListenerRunning{false};
 
+  // Metrics endpoint
+  MetricsEndpoint fMetrics;
+
   // EOS tracking
   std::atomic<bool> fReceivedEOS{false};
 
@@ -142,8 +226,14 @@ private:
   void ReceivingLoop();
   void WritingLoop();
   std::string GenerateFilename(uint32_t run_number) const;
+  std::string GenerateFilePath(uint32_t run_number) const;
   bool OpenOutputFile(uint32_t run_number);
+  void WriteFrame(const std::vector<uint8_t> &data,
+                  const Net::BinaryDataHeader &header);
   void CloseOutputFile();
+  bool AcceptSequence(const std::vector<uint8_t> &data);
+  void RequestMissing();
+  void DisableReliableDelivery();
   void CommandListenerLoop();
   void HandleCommand(const Command &cmd);
 };
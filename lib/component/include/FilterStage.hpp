@@ -0,0 +1,97 @@
+/**
+ * @file FilterStage.hpp
+ * @brief Software trigger / event filter component
+ *
+ * FilterStage sits between an upstream stage (e.g. SimpleMerger) and a
+ * sink (e.g. FileWriter) and forwards only the events that pass its
+ * rules (see EventFilter).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "EventFilter.hpp"
+#include "SingleInputStage.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class DataProcessor;
+}  // namespace Net
+
+/**
+ * @brief Forwards the events of one stream that pass all filter rules
+ *
+ * Architecture:
+ *   ReceivingThread -> Queue -> ProcessingThread (filter, re-encode, send)
+ *
+ * Minimal, full (waveform) and built event frames are accepted; each is
+ * forwarded in its own format with only the passing events, and frames
+ * left empty are not sent. For built events the hit rules apply to the
+ * trigger hit and multiplicity to the event. Frames of other formats
+ * (e.g. calibrated events) are forwarded unchanged. EOS is forwarded in
+ * order.
+ *
+ * Per-rule pass counts (each rule counted on every event) are available
+ * from GetRuleCounts() and the metrics endpoint.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class FilterStage : public SingleInputStage {
+public:
+  FilterStage();
+  ~FilterStage() override;
+
+  // === Configuration ===
+
+  /**
+   * @brief Add a filter rule (only while not running)
+   * @param expression Rule text, e.g. "energy >= 100" (see EventFilter)
+   * @param error Receives the reason if the rule is rejected (may be null)
+   * @return false if the rule is invalid or the stage is running
+   */
+  bool AddRule(const std::string &expression, std::string *error = nullptr);
+  void ClearRules();
+  std::vector<std::string> GetRules() const;
+
+  /**
+   * @brief Events passing each rule this run, in rule order
+   */
+  std::vector<uint64_t> GetRuleCounts() const;
+
+  /// Events received this run (events_processed counts events forwarded)
+  uint64_t GetEventsReceived() const;
+
+protected:
+  // === SingleInputStage hooks ===
+  void ResetCounters() override;
+  void AddMetrics(MetricsExporter &exporter) override;
+  void ProcessFrame(std::unique_ptr<std::vector<uint8_t>> &data) override;
+
+private:
+  std::unique_ptr<std::vector<uint8_t>> FilterFrame(
+      std::unique_ptr<std::vector<uint8_t>> &data, uint32_t &passed);
+
+  // === Filtering (filtering thread only while running) ===
+  EventFilter fFilter;
+  EventFilter::Batch fBatch;
+  std::vector<uint8_t> fPass;
+  std::vector<uint64_t> fFrameRuleCounts;
+  uint64_t fSequence = 0;
+
+  // Published per-rule counts
+  mutable std::mutex fRuleCountsMutex;
+  std::vector<uint64_t> fRuleCounts;
+
+  std::atomic<uint64_t> fEventsReceived{0};
+  std::unique_ptr<Net::DataProcessor> fDataProcessor;
+};
+
+}  // namespace DELILA
@@ -0,0 +1,166 @@
+/**
+ * @file HistogramShard.hpp
+ * @brief Per-worker integer histogram accumulator for MonitorROOT
+ *
+ * A HistogramShard holds plain integer bin arrays with the same binning as
+ * the ROOT histograms MonitorROOT publishes. Each fill thread owns one shard
+ * behind a per-shard mutex that only the periodic fold competes for, so it
+ * is rarely contended and the ROOT histograms stay out of the per-event
+ * path. The class itself is not thread-safe; it has no ROOT dependency so
+ * it can be tested and benchmarked on its own.
+ */
+
+#ifndef DELILA_COMPONENT_HISTOGRAM_SHARD_HPP
+#define DELILA_COMPONENT_HISTOGRAM_SHARD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DELILA {
+
+namespace Digitizer {
+class EventData;
+class MinimalEventData;
+}  // namespace Digitizer
+
+/**
+ * @brief Per-thread accumulator for the MonitorROOT histograms
+ *
+ * Bin arrays use ROOT's global bin numbering, so a fold is a plain
+ * AddBinContent(bin, count) per non-empty bin:
+ *  - 1D: 0 = underflow, 1..N = bins, N+1 = overflow
+ *  - 2D: binx + (NX + 2) * biny
+ *
+ * The energy, channel and module axes are integer-valued with power-of-two
+ * bin widths starting at zero, so a bin index is a shift and a clamp. Fill()
+ * gathers a block of events into small column arrays and bins each column
+ * in a branch-free loop the compiler can vectorize before the (scalar)
+ * increments.
+ *
+ * Counts are 32-bit; NeedsFold() turns true well before any bin can wrap.
+ */
+class HistogramShard {
+ public:
+  /// Histograms mirrored by the shard (same set as MonitorROOT)
+  enum class Histogram {
+    Energy = 0,
+    Channel,
+    Module,
+    TimeDiff,
+    EnergyVsChannel,
+    EnergyVsModule,
+  };
+  static constexpr size_t kHistogramCount = 6;
+
+  // === Binning (must match MonitorROOT::CreateHistograms) ===
+  static constexpr uint32_t kEnergyBins = 16384;      ///< 0..16384, width 1
+  static constexpr uint32_t kChannelBins = 64;        ///< 0..64, width 1
+  static constexpr uint32_t kModuleBins = 16;         ///< 0..16, width 1
+  static constexpr uint32_t kTimeDiffBins = 1000;     ///< 0..1000 us
+  static constexpr double kTimeDiffMaxUs = 1000.0;
+  static constexpr uint32_t k2DEnergyBins = 1024;     ///< 0..16384, width 16
+  static constexpr uint32_t k2DEnergyShift = 4;
+
+  /// Which histograms are filled; disabled ones allocate no bins
+  struct Layout {
+    bool energy = true;
+    bool channel = true;
+    bool module = true;
+    bool timing = false;
+    bool two_d = false;
+    bool waveform = false;
+    uint8_t waveform_module = 0;
+    uint8_t waveform_channel = 0;
+  };
+
+  HistogramShard();
+  explicit HistogramShard(const Layout& layout);
+
+  // === Filling ===
+
+  void Fill(const std::vector<std::unique_ptr<Digitizer::MinimalEventData>>& events);
+  void Fill(const std::vector<std::unique_ptr<Digitizer::EventData>>& events);
+
+  /// Add another shard's counts (same layout) to this one
+  void Merge(const HistogramShard& other);
+
+  /// Zero all counts after a fold; keeps the time-difference reference
+  void ClearCounts();
+
+  /// Zero counts and forget the previous timestamp (new run)
+  void Reset();
+
+  /// Do not take a time difference across the next Fill() boundary
+  void BreakTimeSequence() { fPreviousTimestamp = 0.0; }
+
+  /// Fill one time difference taken outside Fill(), e.g. between the last
+  /// event of one frame and the first of the next (no-op if disabled)
+  void FillTimeDifference(double previous, double current);
+
+  // === Access ===
+
+  const Layout& GetLayout() const { return fLayout; }
+
+  bool IsEnabled(Histogram h) const { return !Bins(h).empty(); }
+
+  /// Bin contents in ROOT global bin numbering (empty if disabled)
+  const std::vector<uint32_t>& Bins(Histogram h) const {
+    return fBins[static_cast<size_t>(h)];
+  }
+
+  /// Fills recorded for @p h since the last clear (including under/overflow)
+  uint64_t Entries(Histogram h) const {
+    return fEntries[static_cast<size_t>(h)];
+  }
+
+  /// Events passed to Fill() since the last clear
+  uint64_t GetEventCount() const { return fEventCount; }
+
+  /// True when the shard must be folded before 32-bit bins could overflow
+  bool NeedsFold() const { return fEventCount >= kFoldThreshold; }
+
+  /// Latest waveform of the selected channel since the last clear
+  bool HasWaveform() const { return fHasWaveform; }
+  const std::vector<int32_t>& GetWaveform() const { return fWaveform; }
+
+ private:
+  static constexpr uint64_t kFoldThreshold = 1ULL << 31;
+  static constexpr size_t kBlockSize = 256;
+
+  /// Column arrays for one block of events
+  struct Block {
+    size_t size = 0;
+    std::array<uint32_t, kBlockSize> energy;
+    std::array<uint32_t, kBlockSize> channel;
+    std::array<uint32_t, kBlockSize> module;
+    std::array<double, kBlockSize> timestamp;
+  };
+
+  void FillBlock();
+  static size_t TimeDiffBin(double diffNs);
+  std::vector<uint32_t>& MutableBins(Histogram h) {
+    return fBins[static_cast<size_t>(h)];
+  }
+
+  Layout fLayout;
+  std::array<std::vector<uint32_t>, kHistogramCount> fBins;
+  std::array<uint64_t, kHistogramCount> fEntries{};
+  uint64_t fEventCount{0};
+
+  // Time difference reference carried across blocks and folds
+  double fPreviousTimestamp{0.0};
+
+  bool fHasWaveform{false};
+  std::vector<int32_t> fWaveform;
+
+  // Scratch space reused across Fill() calls
+  Block fBlock;
+  std::array<uint32_t, kBlockSize> fBinScratch;
+};
+
+}  // namespace DELILA
+
+#endif  // DELILA_COMPONENT_HISTOGRAM_SHARD_HPP
@@ -0,0 +1,171 @@
+/**
+ * @file LatencyHistogram.hpp
+ * @brief Always-on per-frame latency instrumentation for data components
+ *
+ * Answers "where does a frame spend its time" along
+ * DigitizerSource -> SimpleMerger -> FileWriter. Each component records,
+ * per frame, how long it waited in the component's queue (residency), how
+ * long the component took to handle it (processing), and its end-to-end
+ * age: time since DataProcessor stamped BinaryDataHeader::timestamp.
+ * Comparing frame_age across components shows where latency accumulates.
+ */
+
+#ifndef DELILA_COMPONENT_LATENCY_HISTOGRAM_HPP
+#define DELILA_COMPONENT_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+
+/**
+ * @brief Log-linear (HDR-style) histogram of nanosecond values
+ *
+ * Values below 128 ns get their own bucket; above that every power of two
+ * is split into 64 buckets, so a bucket is at most 1/64 of its value wide
+ * and reported percentiles are within ~1%. Values above ~36 minutes land
+ * in the last bucket.
+ *
+ * Record() takes no lock and issues no atomic read-modify-write: each
+ * histogram has a single writer thread, and readers on other threads
+ * (GetStatus) see relaxed counts that may lag by a few samples. Reset()
+ * must not race with Record().
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 6;
+  static constexpr int kMaxExponent = 40;
+  static constexpr size_t kBucketCount =
+      (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+  LatencyHistogram();
+
+  void Record(uint64_t valueNs) {
+    auto& bucket = fCounts[BucketIndex(valueNs)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    if (valueNs > fMax.load(std::memory_order_relaxed)) {
+      fMax.store(valueNs, std::memory_order_relaxed);
+    }
+  }
+
+  /// Samples recorded since Reset()
+  uint64_t GetCount() const;
+
+  /// Largest value recorded (exact)
+  uint64_t GetMax() const { return fMax.load(std::memory_order_relaxed); }
+
+  /// Value at @p percentile (0-100), as the midpoint of its bucket; 0 if empty
+  uint64_t GetValueAtPercentile(double percentile) const;
+
+  /// Count and p50/p99/p99.9/max in microseconds
+  LatencySummary GetSummary() const;
+
+  void Reset();
+
+  static size_t BucketIndex(uint64_t valueNs);
+  static uint64_t BucketMidpoint(size_t index);
+
+ private:
+  using Counts = std::array<uint64_t, kBucketCount>;
+  uint64_t Snapshot(Counts& counts) const;
+  uint64_t ValueAtPercentile(const Counts& counts, uint64_t total,
+                             double percentile) const;
+
+  std::array<std::atomic<uint64_t>, kBucketCount> fCounts;
+  std::atomic<uint64_t> fMax{0};
+};
+
+/**
+ * @brief The three per-frame latency histograms of one component
+ *
+ * Timestamps passed in are Now() values (steady clock, ns). Frame age needs
+ * Unix time to compare with the header timestamp; it is derived from the
+ * steady clock with an offset taken at Reset(), so recording a frame costs
+ * two clock reads at most. Ages between hosts include their clock offset.
+ *
+ * Clock reads, not histogram updates, dominate the cost (~30 ns each), so
+ * only every Nth frame is timed. Sample() makes that decision with a counter
+ * and a mask; the stride N (a power of two) adapts so that between ~12k and
+ * ~50k frames per second are timed. Low-rate streams are timed frame by
+ * frame, and at 1 M frames/s the average cost stays at a few ns per frame.
+ */
+class LatencyRecorder {
+ public:
+  LatencyRecorder();
+
+  /// Monotonic time in nanoseconds
+  static uint64_t Now();
+
+  /// Now()-compatible value of a steady_clock time point
+  static uint64_t ToNs(std::chrono::steady_clock::time_point t);
+
+  /// Clear all histograms and re-read the Unix clock offset (run start)
+  void Reset();
+
+  /// Whether to time the next frame (recording thread only)
+  bool Sample() { return (fFrameCounter++ & GetSampleMask()) == 0; }
+
+  /// Stride - 1; threads sampling with their own counter may read this
+  uint32_t GetSampleMask() const {
+    return fSampleMask.load(std::memory_order_relaxed);
+  }
+
+  void RecordResidency(uint64_t enqueuedNs, uint64_t dequeuedNs) {
+    fResidency.Record(Elapsed(enqueuedNs, dequeuedNs));
+  }
+
+  /// Also adapts the sampling stride; call once per sampled frame
+  void RecordProcessing(uint64_t startNs, uint64_t endNs) {
+    fProcessing.Record(Elapsed(startNs, endNs));
+    AdaptStride(startNs);
+  }
+
+  /// @param headerTimestampNs BinaryDataHeader::timestamp (0 = not stamped)
+  void RecordAge(uint64_t headerTimestampNs, uint64_t nowNs) {
+    if (headerTimestampNs != 0) {
+      fAge.Record(Elapsed(headerTimestampNs, nowNs + fUnixOffsetNs));
+    }
+  }
+
+  /// Age from a Now()-compatible origin; sources, whose frames are only
+  /// stamped when sent, measure from when the data was read out
+  void RecordAgeSince(uint64_t originNs, uint64_t nowNs) {
+    fAge.Record(Elapsed(originNs, nowNs));
+  }
+
+  /// Fill residency/processing/frame_age of @p metrics
+  void Fill(ComponentMetrics& metrics) const;
+
+  const LatencyHistogram& Residency() const { return fResidency; }
+  const LatencyHistogram& Processing() const { return fProcessing; }
+  const LatencyHistogram& Age() const { return fAge; }
+
+  static constexpr uint64_t kMinSampleIntervalNs = 20000;  // <= 50k/s
+  static constexpr uint32_t kMaxSampleMask = 1023;
+
+ private:
+  static uint64_t Elapsed(uint64_t from, uint64_t to) {
+    return to > from ? to - from : 0;
+  }
+
+  void AdaptStride(uint64_t sampleNs);
+
+  LatencyHistogram fResidency;
+  LatencyHistogram fProcessing;
+  LatencyHistogram fAge;
+  uint64_t fUnixOffsetNs = 0;
+
+  uint64_t fFrameCounter = 0;
+  uint64_t fLastSampleNs = 0;
+  std::atomic<uint32_t> fSampleMask{0};
+};
+
+}  // namespace DELILA
+
+#endif  // DELILA_COMPONENT_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,148 @@
+/**
+ * @file MetricsExporter.hpp
+ * @brief Embedded OpenMetrics (Prometheus) HTTP endpoint for a component
+ *
+ * Serves GET /metrics on a dedicated thread. Each scrape calls the
+ * component's GetStatus() and renders ComponentMetrics, the component state
+ * and the per-stage latency summaries, plus any extra counters or gauges
+ * the component registered, in OpenMetrics text format. The data path is
+ * never touched: everything is read from the atomics GetStatus() already
+ * uses, and the response is rendered into a buffer reused across scrapes.
+ */
+
+#ifndef DELILA_COMPONENT_METRICS_EXPORTER_HPP
+#define DELILA_COMPONENT_METRICS_EXPORTER_HPP
+
+#include <delila/core/IComponent.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DELILA {
+
+/**
+ * @brief Minimal HTTP server exposing one component's metrics
+ *
+ * Usage:
+ * @code{.cpp}
+ * MetricsExporter exporter(merger);
+ * exporter.AddCounter("eos_received", "End-of-stream markers received",
+ *                     [&] { return eosCount.load(); });
+ * exporter.Start("*:9100");   // curl http://host:9100/metrics
+ * @endcode
+ *
+ * Requests are handled one at a time with "Connection: close"; it is meant
+ * for a Prometheus scraper and the occasional curl, not for heavy traffic.
+ * Metric names get a "delila_" prefix and a component="<id>" label.
+ */
+class MetricsExporter {
+public:
+  static constexpr const char *kContentType =
+      "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+  explicit MetricsExporter(const IComponent &component);
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+  // === Extra metrics (register before Start) ===
+
+  /// Monotonic counter; exposed as delila_<name>_total
+  void AddCounter(const std::string &name, const std::string &help,
+                  std::function<uint64_t()> read);
+
+  /// Instantaneous value; exposed as delila_<name>
+  void AddGauge(const std::string &name, const std::string &help,
+                std::function<double()> read);
+
+  // === Server ===
+
+  /**
+   * @brief Bind and start the server thread
+   * @param address "host:port", "*:port" (all interfaces) or "port";
+   *                port 0 picks a free port (see GetPort())
+   * @return false if the address is invalid or cannot be bound
+   */
+  bool Start(const std::string &address);
+  void Stop();
+  bool IsRunning() const { return fRunning.load(); }
+
+  /// Port actually bound (0 if not running)
+  uint16_t GetPort() const { return fPort; }
+
+  /// Render the current metrics into @p out (replaces its contents)
+  void Render(std::string &out) const;
+
+private:
+  struct ExtraMetric {
+    std::string name;
+    std::string help;
+    std::function<uint64_t()> counter;
+    std::function<double()> gauge;
+  };
+
+  void ServeLoop();
+  void HandleConnection(int fd);
+
+  const IComponent &fComponent;
+  std::vector<ExtraMetric> fExtras;
+
+  int fListenFd = -1;
+  uint16_t fPort = 0;
+  std::atomic<bool> fRunning{false};
+  std::unique_ptr<std::thread> fThread;
+
+  // Server thread only
+  std::string fBody;
+  std::string fResponse;
+};
+
+/**
+ * @brief A component's metrics endpoint: its address and running exporter
+ *
+ * Holds what every component's Set/Get/Start/StopMetricsExporter() share,
+ * so a component only registers its own extra metrics:
+ * @code{.cpp}
+ * MetricsExporter *exporter = fMetrics.Prepare(*this);
+ * if (!exporter) return false;
+ * exporter->AddCounter(...);
+ * return fMetrics.Start();
+ * @endcode
+ */
+class MetricsEndpoint {
+public:
+  MetricsEndpoint() = default;
+  ~MetricsEndpoint() { Stop(); }
+
+  MetricsEndpoint(const MetricsEndpoint &) = delete;
+  MetricsEndpoint &operator=(const MetricsEndpoint &) = delete;
+
+  /// "host:port", "*:port" or "port"; empty disables the endpoint
+  void SetAddress(const std::string &address) { fAddress = address; }
+  const std::string &GetAddress() const { return fAddress; }
+
+  /**
+   * @brief Create the exporter for @p component, not yet started
+   * @return nullptr if no address is set or the endpoint is already running
+   */
+  MetricsExporter *Prepare(const IComponent &component);
+
+  /// Start the prepared exporter; it is discarded if the bind fails
+  bool Start();
+  void Stop();
+  bool IsRunning() const { return fExporter && fExporter->IsRunning(); }
+
+private:
+  std::string fAddress;
+  std::unique_ptr<MetricsExporter> fExporter;
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_METRICS_EXPORTER_HPP
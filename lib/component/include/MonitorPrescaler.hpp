@@ -0,0 +1,113 @@
+/**
+ * @file MonitorPrescaler.hpp
+ * @brief Adaptive frame sampling for the online monitor under overload
+ *
+ * An online monitor must never slow acquisition. When MonitorROOT cannot
+ * decode and fill every frame, the prescaler picks a representative fraction
+ * of frames to analyse; the rest are counted from their header only. The
+ * effective sampling fraction is exposed so histograms can be rescaled.
+ */
+
+#ifndef DELILA_COMPONENT_MONITOR_PRESCALER_HPP
+#define DELILA_COMPONENT_MONITOR_PRESCALER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace DELILA {
+
+/**
+ * @brief Lag-driven adaptive prescaler for data frames
+ *
+ * Overload is detected from two signals:
+ *  - Lag: receive time minus the frame's BinaryDataHeader timestamp. The
+ *    smallest lag seen since Reset() is taken as the baseline, so a
+ *    constant clock offset between hosts cancels out; what remains is how
+ *    far behind the stream the monitor is.
+ *  - Queue depth: bytes waiting on the data channel, where the transport
+ *    can report it (shm:// rings).
+ *
+ * Once per control interval the target fraction is halved while either
+ * signal is above its high mark and raised by a quarter once both are below
+ * their low marks (multiplicative decrease, gentle increase), bounded by
+ * [min_fraction, 1]. Frames are admitted at random with that probability,
+ * so every source of a round-robin merged stream stays represented.
+ *
+ * Not thread-safe; use from the receive thread only.
+ */
+class MonitorPrescaler {
+ public:
+  struct Config {
+    bool enabled = true;
+    double lag_high_ms = 500.0;  ///< Shed load above this lag
+    double lag_low_ms = 100.0;   ///< Recover below this lag
+    size_t queue_high_bytes = 64 * 1024 * 1024;
+    double min_fraction = 1.0 / 1024;
+    std::chrono::milliseconds control_interval{100};
+  };
+
+  /// What the prescaler needs to know about one data frame
+  struct Frame {
+    uint64_t header_timestamp_ns = 0;  ///< BinaryDataHeader::timestamp
+    uint32_t event_count = 0;          ///< BinaryDataHeader::event_count
+    size_t pending_bytes = 0;          ///< Transport backlog (0 if unknown)
+    uint64_t receive_time_ns = 0;      ///< Unix time the frame was received
+  };
+
+  MonitorPrescaler();
+  explicit MonitorPrescaler(const Config& config);
+
+  void SetConfig(const Config& config);
+  const Config& GetConfig() const { return fConfig; }
+
+  /// Forget lag baseline, counters and target fraction (new run)
+  void Reset();
+
+  /**
+   * @brief Decide whether a frame is decoded and filled
+   * @return true to analyse the frame, false to count it and move on
+   */
+  bool Admit(const Frame& frame);
+
+  /// Current target probability of admitting a frame
+  double GetTargetFraction() const { return fTargetFraction; }
+
+  /**
+   * @brief Analysed events / received events since Reset()
+   *
+   * Histograms filled from admitted frames estimate the full spectrum when
+   * divided by this value. 1.0 while nothing has been skipped.
+   */
+  double GetSamplingFraction() const;
+
+  /// True once any frame has been skipped since Reset()
+  bool IsSampling() const { return fEventsAdmitted < fEventsSeen; }
+
+  /// Lag of the latest frame above the baseline (ms)
+  double GetLagMs() const { return fLagMs; }
+
+  uint64_t GetEventsSeen() const { return fEventsSeen; }
+  uint64_t GetEventsAdmitted() const { return fEventsAdmitted; }
+
+  /// Unix time now in nanoseconds (same clock as the header timestamps)
+  static uint64_t NowNs();
+
+ private:
+  void UpdateTarget(const Frame& frame);
+  bool Draw();
+
+  Config fConfig;
+  double fTargetFraction{1.0};
+  double fLagMs{0.0};
+  int64_t fBaselineNs{0};
+  bool fHasBaseline{false};
+  uint64_t fNextControlNs{0};
+  uint64_t fEventsSeen{0};
+  uint64_t fEventsAdmitted{0};
+  uint64_t fRandomState{0x9E3779B97F4A7C15ULL};
+};
+
+}  // namespace DELILA
+
+#endif  // DELILA_COMPONENT_MONITOR_PRESCALER_HPP
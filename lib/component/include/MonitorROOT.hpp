@@ -14,7 +14,15 @@
 #include <delila/core/ComponentStatus.hpp>
 #include <delila/core/IDataComponent.hpp>
 
+#include "HistogramShard.hpp"
+#include "MetricsExporter.hpp"
+#include "MonitorPrescaler.hpp"
+#include "RateEstimator.hpp"
+
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -52,9 +60,29 @@ class DataProcessor;
  *
  * Thread model:
  * - Main thread: State management
- * - Receive thread: ZMQ data reception
- * - Process thread: Histogram filling
+ * - Receive thread: ZMQ data reception, prescaling, periodic histogram update
+ * - Decode workers (SetWorkerThreads): decode frames and fill histograms
  * - THttpServer runs in its own internal thread
+ *
+ * The receive thread reads only the BinaryDataHeader of each frame and
+ * hands admitted frames to the workers through a bounded queue. A worker
+ * decodes a frame once, with the decoder selected by format_version.
+ *
+ * Filling never touches the ROOT histograms directly. Each worker owns
+ * a HistogramShard (plain integer bins) guarded by its own, normally
+ * uncontended mutex. Once per update interval the shards are folded into
+ * the ROOT histograms under fHistMutex, so the HTTP server only competes
+ * with the fold, not with every event.
+ *
+ * Workers finish frames out of order, so they only take time differences
+ * within a frame. The difference across each frame boundary is joined in
+ * receive order (FillFrameBoundaries), against the last event of the
+ * previous frame filled, as if a single thread had filled every event.
+ *
+ * Under overload a MonitorPrescaler skips frames after reading only their
+ * header. Histogram titles then carry a "[sampled N%]" label and
+ * GetSamplingFraction() / ComponentMetrics::sampling_fraction give the
+ * fraction of events that were filled, for rescaling.
  */
 class MonitorROOT : public IDataComponent {
  public:
@@ -85,6 +113,12 @@ class MonitorROOT : public IDataComponent {
   void StartCommandListener() override;
   void StopCommandListener() override;
 
+  // === Metrics endpoint (OpenMetrics over HTTP, see MetricsExporter) ===
+  void SetMetricsAddress(const std::string& address);  ///< e.g. "*:9100"
+  std::string GetMetricsAddress() const;
+  bool StartMetricsExporter();
+  void StopMetricsExporter();
+
   // === Public control methods ===
   bool Arm();
   bool Start(uint32_t run_number);
@@ -103,11 +137,27 @@ class MonitorROOT : public IDataComponent {
 
   /**
    * @brief Set histogram update interval
+   *
+   * Filled counts become visible in the ROOT histograms once per interval
+   * and when the run stops.
+   *
    * @param ms Milliseconds between updates (default: 1000)
    */
   void SetUpdateInterval(uint32_t ms);
   uint32_t GetUpdateInterval() const;
 
+  /**
+   * @brief Set the number of decode/fill worker threads
+   *
+   * Takes effect at the next Start. Waveform streams are decode-bound, so
+   * more workers help there; MinimalEventData streams rarely need more
+   * than one or two.
+   *
+   * @param count Worker threads, at least 1 (default: 2)
+   */
+  void SetWorkerThreads(uint32_t count);
+  uint32_t GetWorkerThreads() const;
+
   // === Histogram configuration ===
 
   /**
@@ -155,6 +205,27 @@ class MonitorROOT : public IDataComponent {
   void SetWaveformChannel(uint8_t module, uint8_t channel);
   std::pair<uint8_t, uint8_t> GetWaveformChannel() const;
 
+  // === Overload handling ===
+
+  /**
+   * @brief Enable/disable adaptive prescaling under overload
+   * @param enable True to enable (default: true)
+   */
+  void EnablePrescaling(bool enable);
+  bool IsPrescalingEnabled() const;
+
+  /**
+   * @brief Set prescaler thresholds (applied at the next Start)
+   */
+  void SetPrescalerConfig(const MonitorPrescaler::Config& config);
+  MonitorPrescaler::Config GetPrescalerConfig() const;
+
+  /**
+   * @brief Filled events / received events in the current run
+   * @return 1.0 when every event was filled
+   */
+  double GetSamplingFraction() const;
+
   // === Testing utilities ===
   void ForceError(const std::string& message);
 
@@ -170,6 +241,10 @@ class MonitorROOT : public IDataComponent {
   // === Helper methods ===
   bool TransitionTo(ComponentState newState);
   void ReceiveLoop();
+  void DecodeWorker(size_t index);
+  bool AdmitFrame(const std::vector<uint8_t>& data);
+  void EnqueueFrame(std::unique_ptr<std::vector<uint8_t>> data);
+  std::unique_ptr<std::vector<uint8_t>> DequeueFrame(uint64_t& ordinal);
   void CommandListenerLoop();
   void HandleCommand(const Command& cmd);
 
@@ -177,6 +252,14 @@ class MonitorROOT : public IDataComponent {
   void CreateHistograms();
   void ResetHistograms();
   void DeleteHistograms();
+  void CreateShards();
+  HistogramShard::Layout MakeShardLayout() const;
+  void FoldShards();
+  struct FrameSpan;
+  struct FillShard;
+  void FillFrameBoundaries(uint64_t ordinal, const FrameSpan& span,
+                           FillShard& shard);
+  void LabelHistograms(double samplingFraction);
 
   // === State ===
   std::atomic<ComponentState> fState{ComponentState::Idle};
@@ -189,6 +272,7 @@ class MonitorROOT : public IDataComponent {
   // === Configuration ===
   int fHttpPort{8080};
   uint32_t fUpdateInterval{1000};
+  uint32_t fWorkerThreads{2};
 
   // === Histogram enables ===
   bool fEnableEnergyHist{true};
@@ -205,6 +289,7 @@ class MonitorROOT : public IDataComponent {
   std::atomic<uint64_t> fEventsProcessed{0};
   std::atomic<uint64_t> fBytesTransferred{0};
   std::atomic<uint64_t> fHeartbeatCounter{0};
+  mutable RateEstimator fRates;  // Counted by the receive thread
 
   // === Threads ===
   std::unique_ptr<std::thread> fReceiveThread;
@@ -230,14 +315,51 @@ class MonitorROOT : public IDataComponent {
   // Mutex for histogram access
   mutable std::mutex fHistMutex;
 
-  // Previous timestamp for time difference calculation
-  double fPreviousTimestamp{0.0};
+  // === Receive -> decode worker queue ===
+  static constexpr size_t kMaxQueuedFrames = 256;
+  std::deque<std::unique_ptr<std::vector<uint8_t>>> fFrameQueue;
+  std::atomic<size_t> fQueuedBytes{0};
+  bool fReceiveDone{false};  // Guarded by fFrameQueueMutex
+  uint64_t fNextOrdinal{0};  // Receive order of dequeued frames, ditto
+  std::mutex fFrameQueueMutex;
+  std::condition_variable fFrameQueueNotEmpty;
+  std::condition_variable fFrameQueueNotFull;
+  std::atomic<bool> fFoldRequested{false};
+
+  // Per-worker fill accumulators, folded into the histograms above
+  struct FillShard {
+    explicit FillShard(const HistogramShard::Layout& layout) : hist(layout) {}
+    std::mutex mutex;
+    HistogramShard hist;
+  };
+  std::vector<std::unique_ptr<FillShard>> fShards;
+
+  // First/last event timestamps of a decoded frame (filled = had events)
+  struct FrameSpan {
+    bool filled{false};
+    double first{0.0};
+    double last{0.0};
+  };
+  // Spans of frames decoded ahead of an earlier one, by receive ordinal
+  std::map<uint64_t, FrameSpan> fPendingSpans;  // Guarded by fSpanMutex
+  uint64_t fNextSpan{0};                        // Ditto
+  double fLastTimestamp{0.0};                   // Ditto
+  std::mutex fSpanMutex;
+
+  // === Overload handling ===
+  MonitorPrescaler::Config fPrescalerConfig;
+  MonitorPrescaler fPrescaler;  // Receive thread only
+  std::atomic<double> fSamplingFraction{1.0};
+  double fLabeledFraction{1.0};  // Guarded by fHistMutex
 
   // === Command channel ===
   std::string fCommandAddress;
   std::unique_ptr<Net::ZMQTransport> fCommandTransport;
   std::unique_ptr<std::thread> fCommandListenerThread;
   std::atomic<bool> fCommandListenerRunning{false};
+
+  // === Metrics endpoint ===
+  MetricsEndpoint fMetrics;
 };
 
 }  // namespace DELILA
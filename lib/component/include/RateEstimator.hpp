@@ -0,0 +1,165 @@
+/**
+ * @file RateEstimator.hpp
+ * @brief Event/data rate estimation shared by all data components
+ *
+ * Components count events and bytes with relaxed atomics on the data path;
+ * RateEstimator turns those totals into rates when GetStatus() is called, so
+ * every component reports event_rate/data_rate the same way. It also keeps
+ * per-module/per-channel event counts, taken from the events themselves or
+ * from serialized data frames, so channel-level rates are visible without
+ * running MonitorROOT.
+ */
+
+#ifndef DELILA_COMPONENT_RATE_ESTIMATOR_HPP
+#define DELILA_COMPONENT_RATE_ESTIMATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+
+/**
+ * @brief EWMA and sliding-window rates from monotonically growing totals
+ *
+ * Data path (one writer thread per estimator): CountEvent()/CountEvents()/
+ * CountFrame() update a fixed per-channel table with relaxed loads and
+ * stores; no lock, no read-modify-write, no allocation. Up to kMaxModules
+ * distinct module numbers (any value 0-255) are tracked, each with
+ * kMaxChannels channels; events outside that land in GetUnmappedCount().
+ *
+ * Reader side: Fill() samples the component's event/byte totals and the
+ * channel table, at most once per kMinSampleIntervalNs, and derives
+ *  - event_rate/data_rate: EWMA with time constant tau, weighted by the
+ *    actual interval (alpha = 1 - exp(-dt / tau)) so irregular polling
+ *    gives the same result as a fixed tick;
+ *  - event_rate_avg/data_rate_avg: mean over the last window_s seconds;
+ *  - channel_rates: per-channel EWMA, for every channel seen this run.
+ * Fill() may be called from several threads; they serialize on a mutex the
+ * data path never touches.
+ */
+class RateEstimator {
+public:
+  static constexpr size_t kMaxModules = 16;
+  static constexpr size_t kMaxChannels = 64;
+  static constexpr uint64_t kMinSampleIntervalNs = 100000000; // 100 ms
+  static constexpr size_t kWindowSlots = 32;
+
+  /**
+   * @param timeConstantS EWMA time constant in seconds
+   * @param windowS       Sliding-window length in seconds
+   */
+  explicit RateEstimator(double timeConstantS = 2.0, double windowS = 10.0);
+
+  /// Monotonic time in nanoseconds (steady clock)
+  static uint64_t Now();
+
+  /// New run: zero channel counts and rates (must not race the data path)
+  void Reset();
+  void Reset(uint64_t nowNs);
+
+  // === Data path ===
+
+  void CountEvent(uint8_t module, uint8_t channel) {
+    size_t slot = ModuleSlot(module);
+    if (slot >= kMaxModules || channel >= kMaxChannels) {
+      Increment(fUnmapped);
+      return;
+    }
+    Increment(fChannelCounts[slot * kMaxChannels + channel]);
+  }
+
+  /// Count a batch of EventData or MinimalEventData
+  template <typename Event>
+  void CountEvents(const std::vector<std::unique_ptr<Event>> &events) {
+    for (const auto &event : events) {
+      if (event) {
+        CountEvent(event->module, event->channel);
+      }
+    }
+  }
+
+  /**
+   * @brief Count the events of a serialized data frame
+   *
+   * Reads only module/channel of each event (all format versions; built
+   * events count each of their hits); EOS and unknown formats are ignored.
+   * @return true if the frame was a data frame that could be walked
+   */
+  bool CountFrame(const uint8_t *data, size_t size);
+  bool CountFrame(const std::vector<uint8_t> &frame) {
+    return CountFrame(frame.data(), frame.size());
+  }
+
+  /// Events whose module/channel did not fit the table
+  uint64_t GetUnmappedCount() const {
+    return fUnmapped.load(std::memory_order_relaxed);
+  }
+
+  // === Reader side ===
+
+  /**
+   * @brief Update estimates from the component totals and fill @p metrics
+   * @param totalEvents Events processed since the run started
+   * @param totalBytes  Bytes transferred since the run started
+   */
+  void Fill(uint64_t totalEvents, uint64_t totalBytes,
+            ComponentMetrics &metrics);
+  void Fill(uint64_t totalEvents, uint64_t totalBytes, uint64_t nowNs,
+            ComponentMetrics &metrics);
+
+private:
+  struct Sample {
+    uint64_t time_ns = 0;
+    uint64_t events = 0;
+    uint64_t bytes = 0;
+  };
+
+  static void Increment(std::atomic<uint64_t> &counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  size_t ModuleSlot(uint8_t module) {
+    uint8_t slot = fModuleSlot[module].load(std::memory_order_relaxed);
+    return slot != 0 ? slot - 1 : AssignSlot(module);
+  }
+
+  size_t AssignSlot(uint8_t module);
+  void UpdateLocked(const Sample &now);
+  void Rebase(const Sample &now);
+
+  const double fTimeConstantNs;
+  const uint64_t fWindowNs;
+
+  // Data path (single writer)
+  std::array<std::atomic<uint64_t>, kMaxModules * kMaxChannels> fChannelCounts;
+  std::array<std::atomic<uint8_t>, 256> fModuleSlot;  ///< slot + 1, 0 = none
+  std::array<std::atomic<uint8_t>, kMaxModules> fSlotModule;
+  std::atomic<uint32_t> fSlotsUsed{0};
+  std::atomic<uint64_t> fUnmapped{0};
+
+  // Reader side, guarded by fMutex
+  std::mutex fMutex;
+  Sample fLast;
+  bool fHaveRate = false;
+  std::array<Sample, kWindowSlots> fWindow;
+  size_t fWindowHead = 0;
+  size_t fWindowSize = 0;
+  double fEventRate = 0.0;
+  double fByteRate = 0.0;
+  double fEventRateAvg = 0.0;
+  double fByteRateAvg = 0.0;
+  std::array<uint64_t, kMaxModules * kMaxChannels> fChannelLast{};
+  std::array<double, kMaxModules * kMaxChannels> fChannelRate{};
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_RATE_ESTIMATOR_HPP
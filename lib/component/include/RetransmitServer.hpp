@@ -0,0 +1,120 @@
+/**
+ * @file RetransmitServer.hpp
+ * @brief Sender side of reliable delivery mode
+ *
+ * ZMQTransport::SendBytes() does not wait: a frame that finds the socket's
+ * queue full is dropped, and so is anything lost on the way. For runs
+ * where loss is unacceptable, a source can send through a RetransmitServer
+ * instead. It keeps the last frames sent in a Net::ReplayBuffer and binds
+ * a side channel on which the receiver (FileWriter with a retransmit
+ * address) asks for the sequence numbers its Net::GapRecovery found
+ * missing; those frames are sent again on the data channel.
+ */
+
+#ifndef DELILA_COMPONENT_RETRANSMIT_SERVER_HPP
+#define DELILA_COMPONENT_RETRANSMIT_SERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ReplayBuffer.hpp>
+
+namespace DELILA {
+
+namespace Net {
+class ZMQTransport;
+} // namespace Net
+
+/**
+ * @brief Replay buffer plus the retransmit request listener of a source
+ *
+ * Send() replaces ZMQTransport::SendBytes() on the data path: it copies
+ * the frame into the replay buffer, then sends it. Requests are served on
+ * a thread of their own; the two share the data socket under a mutex, so
+ * every frame sent on the output must go through Send() while the server
+ * runs (EOS included).
+ *
+ * The side channel is a PULL socket bound at the retransmit address; the
+ * receiver connects a PUSH socket to it. Retransmission is point to point:
+ * the receiver must get the source's frames with their original sequence
+ * numbers, i.e. directly or through components that forward frames
+ * unchanged.
+ *
+ * Usage:
+ * @code{.cpp}
+ * RetransmitServer retransmit;
+ * retransmit.Start("tcp://0.0.0.0:5565", *transport);  // when armed
+ * retransmit.Clear();                             // when a run starts
+ * retransmit.Send(frame);                         // for every frame
+ * retransmit.Stop();                              // on reset
+ * @endcode
+ */
+class RetransmitServer {
+public:
+  RetransmitServer();
+  ~RetransmitServer();
+
+  RetransmitServer(const RetransmitServer &) = delete;
+  RetransmitServer &operator=(const RetransmitServer &) = delete;
+
+  /// Replay buffer bounds (see Net::ReplayBuffer)
+  void SetCapacity(size_t maxFrames, size_t maxBytes);
+
+  /**
+   * @brief Bind the side channel and start serving requests
+   * @param address Retransmit address to bind, e.g. "tcp://0.0.0.0:5565"
+   * @param output Data transport frames are (re)sent on; must outlive the
+   *               server or Stop()
+   */
+  bool Start(const std::string &address, Net::ZMQTransport &output);
+  void Stop();
+  bool IsRunning() const { return fRunning.load(); }
+
+  /// New run: forget the frames of the last one (sequence numbers restart)
+  void Clear();
+
+  /// Keep a copy of the frame, then send it on the output
+  bool Send(std::unique_ptr<std::vector<uint8_t>> &frame);
+
+  /// ZMQTransport::WaitForSendReady() on the output, under the send mutex
+  bool WaitForSendReady(std::chrono::milliseconds timeout);
+
+  // === Counters (since the last Clear()) ===
+  uint64_t GetRequestsReceived() const { return fRequests.load(); }
+  uint64_t GetFramesRetransmitted() const { return fRetransmitted.load(); }
+  /// Requested frames no longer in the replay buffer
+  uint64_t GetFramesUnavailable() const { return fUnavailable.load(); }
+  size_t GetBufferedFrames() const { return fBufferedFrames.load(); }
+  size_t GetBufferedBytes() const { return fBufferedBytes.load(); }
+
+private:
+  void ServeLoop();
+  void Serve(const std::vector<uint8_t> &request);
+  void UpdateBuffered();
+
+  std::unique_ptr<Net::ZMQTransport> fRequestTransport;
+  Net::ZMQTransport *fOutput = nullptr;
+
+  std::mutex fSendMutex; // Guards fReplay and sends on fOutput
+  Net::ReplayBuffer fReplay;
+
+  std::unique_ptr<std::thread> fThread;
+  std::atomic<bool> fRunning{false};
+
+  std::atomic<uint64_t> fRequests{0};
+  std::atomic<uint64_t> fRetransmitted{0};
+  std::atomic<uint64_t> fUnavailable{0};
+  std::atomic<size_t> fBufferedFrames{0};
+  std::atomic<size_t> fBufferedBytes{0};
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_RETRANSMIT_SERVER_HPP
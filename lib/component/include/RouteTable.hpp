@@ -0,0 +1,115 @@
+/**
+ * @file RouteTable.hpp
+ * @brief Event -> output assignment for the Router
+ *
+ * Module and channel keys are resolved through one (module, channel) ->
+ * output array built when the table changes, so routing an event is a
+ * single lookup; time slices and frame blocks are a division.
+ */
+
+#ifndef DELILA_COMPONENT_ROUTE_TABLE_HPP
+#define DELILA_COMPONENT_ROUTE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DELILA {
+
+/**
+ * @brief Assigns each event to one of N outputs by module, channel or
+ *        time slice, or each whole frame by its block of frame numbers
+ *
+ * Keys:
+ *   module   output = module % N
+ *   channel  output = (module * 256 + channel) % N
+ *   time     output = floor(timeStampNs / slice) % N
+ *   frame    output = floor(frame number / block) % N   (RouteBlock)
+ *
+ * For the module and channel keys, ranges override the modulo rule:
+ *   "0-3=1"          modules 0 to 3 -> output 1
+ *   "2:0-2:7=0"      module 2, channels 0 to 7 -> output 0
+ *   "5=2"            module 5 -> output 2
+ * A bare module number stands for all of its channels. Later ranges win
+ * where they overlap. Ranges are not used with the time and frame keys.
+ *
+ * The same key always maps to the same output, so a single routing thread
+ * keeps the order of each module, channel or slice.
+ */
+class RouteTable {
+public:
+  enum class Key { Module, Channel, Time, Frame };
+
+  static constexpr size_t kMaxOutputs = 256;
+
+  RouteTable();
+
+  /// @return false if count is 0 or above kMaxOutputs, or a range targets
+  ///         an output >= count (table unchanged)
+  bool SetOutputs(size_t count, std::string *error = nullptr);
+  size_t GetOutputs() const { return fOutputs; }
+
+  void SetKey(Key key);
+  Key GetKey() const { return fKey; }
+
+  /// Time slice width in ns (time key); @return false unless positive
+  bool SetTimeSlice(double sliceNs);
+  double GetTimeSlice() const { return fSliceNs; }
+
+  /// Consecutive frames per block (frame key); @return false if 0
+  bool SetFrameBlock(uint32_t frames);
+  uint32_t GetFrameBlock() const { return fFrameBlock; }
+
+  /**
+   * @brief Add a range, e.g. "0-3=1" or "2:0-2:7=0"
+   * @param error Receives the reason if the range is rejected (may be null)
+   * @return false on a syntax error or an output >= GetOutputs()
+   */
+  bool AddRange(const std::string &spec, std::string *error = nullptr);
+  void ClearRanges();
+  std::vector<std::string> GetRanges() const;
+
+  /// "module", "channel", "time" or "frame"; @return false for any other
+  /// name
+  static bool ParseKey(const std::string &name, Key &key);
+  static const char *KeyName(Key key);
+
+  /// Output of one event
+  size_t Route(uint8_t module, uint8_t channel, double timeStampNs) const {
+    if (fKey == Key::Time) {
+      if (!(timeStampNs > 0.0)) {
+        return 0;
+      }
+      return static_cast<size_t>(
+          static_cast<uint64_t>(timeStampNs / fSliceNs) % fOutputs);
+    }
+    return fTable[(static_cast<size_t>(module) << 8) | channel];
+  }
+
+  /// Output of a whole frame (frame key), by its number in the stream
+  size_t RouteBlock(uint64_t frameNumber) const {
+    return static_cast<size_t>((frameNumber / fFrameBlock) % fOutputs);
+  }
+
+private:
+  struct Range {
+    std::string spec;
+    uint16_t first;  // module << 8 | channel
+    uint16_t last;
+    uint8_t output;
+  };
+
+  void Rebuild();
+
+  size_t fOutputs = 1;
+  Key fKey = Key::Module;
+  double fSliceNs = 1e6;
+  uint32_t fFrameBlock = 64;
+  std::vector<Range> fRanges;
+  std::vector<uint8_t> fTable;  // module << 8 | channel -> output
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_ROUTE_TABLE_HPP
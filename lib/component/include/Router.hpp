@@ -0,0 +1,124 @@
+/**
+ * @file Router.hpp
+ * @brief Stream router / splitter component
+ *
+ * Router is the counterpart of SimpleMerger: it partitions one stream
+ * across several downstream workers (writers, analyzers) by module,
+ * channel or time slice, or by blocks of whole frames (see RouteTable).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "RouteTable.hpp"
+#include "SingleInputStage.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class DataProcessor;
+struct EventRecordRef;
+}  // namespace Net
+
+/**
+ * @brief Splits one stream into per-output streams by a routing key
+ *
+ * Architecture:
+ *   ReceivingThread -> Queue -> ProcessingThread (route, regroup, send)
+ *                                 -> Output 0..N-1
+ *
+ * Each output address gets its own PUSH socket. The records of a frame
+ * are located without decoding (DataProcessor::ScanRecords) and routed one
+ * by one; a frame whose events all go to one output is forwarded as is
+ * (only its sequence number is rewritten), otherwise the records are
+ * copied into one frame per output, in the input's format. Every output
+ * numbers its frames 0, 1, 2, ... so downstream gap detection works, and
+ * because one thread routes in receive order, each key keeps its order.
+ * EOS is sent to every output.
+ *
+ * With the frame key, whole frames are forwarded in blocks of consecutive
+ * frames and numbered in receive order across all outputs instead: output
+ * o sees the run-wide sequence numbers of its blocks only. This is the
+ * FileWriter farm mode; each writer's RunManifest records the numbers it
+ * holds and RunReader restores the order of the whole run.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class Router : public SingleInputStage {
+public:
+  Router();
+  ~Router() override;
+
+  // === IDataComponent interface ===
+  void SetOutputAddresses(const std::vector<std::string> &addresses) override;
+
+  // === Configuration ===
+
+  bool SetRouteKey(RouteTable::Key key);
+  RouteTable::Key GetRouteKey() const;
+
+  /// Slice width for the time key; @return false unless positive
+  bool SetTimeSlice(double sliceNs);
+  double GetTimeSlice() const;
+
+  /// Consecutive frames per block for the frame key; @return false if 0
+  bool SetFrameBlock(uint32_t frames);
+  uint32_t GetFrameBlock() const;
+
+  /**
+   * @brief Add a module/channel range (set the output addresses first)
+   * @param spec e.g. "0-3=1" (see RouteTable)
+   * @param error Receives the reason if the range is rejected (may be null)
+   * @return false if the range is invalid or the router is running
+   */
+  bool AddRange(const std::string &spec, std::string *error = nullptr);
+  void ClearRanges();
+  std::vector<std::string> GetRanges() const;
+
+  /// Events sent to each output this run, in output order
+  std::vector<uint64_t> GetOutputCounts() const;
+
+  /// Frames forwarded unchanged, and frames split across outputs
+  uint64_t GetFramesForwarded() const;
+  uint64_t GetFramesSplit() const;
+
+protected:
+  // === SingleInputStage hooks ===
+  bool OnInitialize(const std::string &config_path) override;
+  void ResetCounters() override;
+  void AddMetrics(MetricsExporter &exporter) override;
+  void ProcessFrame(std::unique_ptr<std::vector<uint8_t>> &data) override;
+
+private:
+  void RouteFrame(std::unique_ptr<std::vector<uint8_t>> &data);
+  void SendToOutput(size_t output, std::unique_ptr<std::vector<uint8_t>> &frame,
+                    uint32_t events);
+
+  // === Routing (processing thread only while running) ===
+  RouteTable fRoutes;
+  std::vector<Net::EventRecordRef> fRecords;
+  std::vector<uint8_t> fRecordOutput;
+  std::vector<uint32_t> fFrameEvents;  // Events per output, this frame
+  std::vector<size_t> fFrameBytes;     // Record bytes per output, this frame
+  std::vector<uint64_t> fFrameCounts;  // Events sent per output, unpublished
+  std::vector<uint64_t> fSequences;    // Next sequence number per output
+  uint64_t fFrameNumber = 0;           // Run-wide frame number (frame key)
+
+  // Published per-output counts
+  mutable std::mutex fOutputCountsMutex;
+  std::vector<uint64_t> fOutputCounts;
+
+  std::atomic<uint64_t> fFramesForwarded{0};
+  std::atomic<uint64_t> fFramesSplit{0};
+  std::atomic<uint64_t> fFramesRejected{0};
+  std::unique_ptr<Net::DataProcessor> fDataProcessor;
+};
+
+}  // namespace DELILA
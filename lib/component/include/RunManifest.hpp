@@ -0,0 +1,110 @@
+/**
+ * @file RunManifest.hpp
+ * @brief Index of which file holds which frames of a run
+ *
+ * FileWriter records one manifest next to its data file. For a writer farm
+ * (Router frame key, one FileWriter per output) the manifests of all
+ * writers are merged into the run manifest, which RunReader uses to read
+ * the run back in sequence order.
+ */
+
+#ifndef DELILA_COMPONENT_RUN_MANIFEST_HPP
+#define DELILA_COMPONENT_RUN_MANIFEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DELILA {
+
+/**
+ * @brief Frames of a run as blocks of consecutive sequence numbers
+ *
+ * A block is a run of frames stored back to back in one file whose
+ * sequence numbers follow each other, with its byte range, event count and
+ * event time range. Frames are added in file order; a frame continuing the
+ * last block extends it, so a writer that receives blocks of 64 frames
+ * stores one entry per 64 frames, and a single writer one per run.
+ *
+ * Saved as JSON:
+ *   {
+ *     "run_number": 42,
+ *     "files": ["run_000042.dat"],
+ *     "blocks": [{"file": 0, "first_sequence": 0, "last_sequence": 63,
+ *                 "offset": 0, "bytes": 90112, "events": 6400,
+ *                 "first_ns": 1000.0, "last_ns": 640000.0}]
+ *   }
+ * File names are stored relative to the manifest's directory when they are
+ * below it, and resolved against it on loading.
+ */
+class RunManifest {
+public:
+  struct Block {
+    size_t file = 0;  // Index into GetFiles()
+    uint64_t firstSequence = 0;
+    uint64_t lastSequence = 0;
+    uint64_t offset = 0;  // Byte range in the file
+    uint64_t bytes = 0;
+    uint64_t events = 0;
+    double firstNs = 0.0;  // Earliest and latest event time (0 if none)
+    double lastNs = 0.0;
+
+    uint64_t Frames() const { return lastSequence - firstSequence + 1; }
+  };
+
+  /// Sequence numbers firstSequence to lastSequence, inclusive
+  struct SequenceRange {
+    uint64_t firstSequence;
+    uint64_t lastSequence;
+  };
+
+  void SetRunNumber(uint32_t run) { fRunNumber = run; }
+  uint32_t GetRunNumber() const { return fRunNumber; }
+
+  /// @return Index of the file, added if not yet listed
+  size_t AddFile(const std::string &path);
+
+  /// Record one frame written at offset of file (after the file's last one)
+  void AddFrame(size_t file, uint64_t sequence, uint64_t offset,
+                uint64_t bytes, uint32_t events, double firstNs,
+                double lastNs);
+
+  /**
+   * @brief Add the blocks of another manifest of the same run
+   * @param error Receives the reason on failure (may be null)
+   * @return false if the run numbers differ (manifest unchanged)
+   */
+  bool Merge(const RunManifest &other, std::string *error = nullptr);
+
+  /// Order blocks by first sequence number
+  void Sort();
+
+  void Clear();
+
+  const std::vector<std::string> &GetFiles() const { return fFiles; }
+  const std::vector<Block> &GetBlocks() const { return fBlocks; }
+  uint64_t GetFrames() const;
+  uint64_t GetEvents() const;
+
+  /// Sequence numbers missing between the first and last frame (sorted)
+  std::vector<SequenceRange> FindGaps() const;
+
+  /// Sequence numbers held by more than one block (sorted)
+  std::vector<SequenceRange> FindOverlaps() const;
+
+  bool Save(const std::string &path, std::string *error = nullptr) const;
+  bool Load(const std::string &path, std::string *error = nullptr);
+
+  /// "<data file without .dat>.manifest.json"
+  static std::string ManifestPathFor(const std::string &dataPath);
+
+private:
+  uint32_t fRunNumber = 0;
+  std::vector<std::string> fFiles;
+  std::vector<Block> fBlocks;
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_RUN_MANIFEST_HPP
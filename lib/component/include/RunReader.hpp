@@ -0,0 +1,106 @@
+/**
+ * @file RunReader.hpp
+ * @brief Reads the frames of a run back in sequence order
+ *
+ * Counterpart of the FileWriter farm: given the run manifest merged from
+ * all writers (see RunManifest), frames are read block by block from
+ * whichever file holds them, so the result is the stream as the Router
+ * received it, independent of how many writers shared the run.
+ */
+
+#ifndef DELILA_COMPONENT_RUN_READER_HPP
+#define DELILA_COMPONENT_RUN_READER_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RunManifest.hpp"
+
+namespace DELILA {
+
+/**
+ * @brief Sequential, sequence-ordered frame reader over a run manifest
+ *
+ * Each block is one seek followed by sequential reads of its frames, whose
+ * headers are checked against the manifest (sequence number, sizes). The
+ * frames are returned as written, ready for DataProcessor to decode.
+ *
+ * Usage:
+ * @code
+ *   RunManifest manifest;
+ *   manifest.Load("w0/run_000042.manifest.json");
+ *   RunManifest other;
+ *   other.Load("w1/run_000042.manifest.json");
+ *   manifest.Merge(other);
+ *
+ *   RunReader reader;
+ *   reader.Open(manifest);
+ *   while (auto frame = reader.Next()) {
+ *     auto [events, sequence] = processor.Decode(frame);
+ *   }
+ *   if (reader.HasError()) { ... }
+ * @endcode
+ */
+class RunReader {
+public:
+  RunReader();
+  ~RunReader();
+
+  RunReader(const RunReader &) = delete;
+  RunReader &operator=(const RunReader &) = delete;
+
+  /**
+   * @brief Start reading the run of manifest from its first frame
+   * @param error Receives the reason on failure (may be null)
+   * @return false if a sequence number is held by more than one block
+   */
+  bool Open(const RunManifest &manifest, std::string *error = nullptr);
+  void Close();
+
+  /**
+   * @brief Only read blocks with events between firstNs and lastNs
+   *
+   * Selection is per block: frames of a selected block are all returned.
+   * Set before the first Next().
+   */
+  void SetTimeRange(double firstNs, double lastNs);
+
+  /// Next frame in sequence order; nullptr at the end of the run or on a
+  /// read error (see HasError)
+  std::unique_ptr<std::vector<uint8_t>> Next();
+
+  bool HasError() const { return !fError.empty(); }
+  const std::string &GetError() const { return fError; }
+
+  uint64_t GetFramesRead() const { return fFramesRead; }
+  uint64_t GetBytesRead() const { return fBytesRead; }
+  const RunManifest &GetManifest() const { return fManifest; }
+
+private:
+  bool Selected(const RunManifest::Block &block) const;
+  bool StartBlock(const RunManifest::Block &block);
+  std::unique_ptr<std::vector<uint8_t>> Fail(const std::string &reason);
+
+  RunManifest fManifest;  // Blocks sorted by sequence
+  std::vector<std::unique_ptr<std::ifstream>> fFiles;  // Opened on first use
+
+  size_t fBlock = 0;
+  bool fInBlock = false;
+  uint64_t fNextSequence = 0;
+  uint64_t fPosition = 0;  // Byte offset of the next frame in its file
+
+  bool fTimeRange = false;
+  double fFirstNs = 0.0;
+  double fLastNs = 0.0;
+
+  uint64_t fFramesRead = 0;
+  uint64_t fBytesRead = 0;
+  std::string fError;
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_RUN_READER_HPP
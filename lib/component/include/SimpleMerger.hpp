@@ -10,10 +10,10 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <vector>
@@ -22,6 +22,10 @@
 #include "delila/core/ComponentState.hpp"
 #include "delila/core/ComponentStatus.hpp"
 #include "delila/core/IDataComponent.hpp"
+#include "LatencyHistogram.hpp"
+#include "MetricsExporter.hpp"
+#include "RateEstimator.hpp"
+#include "SpillBuffer.hpp"
 
 namespace DELILA {
 
@@ -29,6 +33,7 @@ namespace Net {
 class ZMQTransport;
 class DataProcessor;
 class EOSTracker;
+class SequenceReorderer;
 }  // namespace Net
 
 /**
@@ -43,6 +48,20 @@ class EOSTracker;
  * Architecture:
  *   N ReceivingThreads -> Queue -> 1 SendingThread
  *
+ * The queue holds kMaxQueueSize frames; beyond that frames are dropped,
+ * as they are when the output cannot take them. In spill mode
+ * (SetSpillDirectory) the sending thread instead waits for the output,
+ * and the queue overflows into a spill file on local disk (see
+ * Net::SpillQueue) that is drained in order once downstream catches up.
+ *
+ * Each input's frames are followed in their own sequence numbers (see
+ * Net::SequenceReorderer), so loss and reordering are counted per source;
+ * a reorder window (SetReorderWindow) restores each source's order before
+ * frames are queued. Forwarded data frames keep their source's sequence
+ * number and carry the input (source_id) and their position in the merged
+ * stream (merge_sequence) in the header, so downstream can account for
+ * loss both per source and after the merger.
+ *
  * State transitions follow IComponent standard:
  *   Idle -> Configured -> Armed -> Running -> Configured
  */
@@ -75,6 +94,12 @@ public:
   void StartCommandListener() override;
   void StopCommandListener() override;
 
+  // === Metrics endpoint (OpenMetrics over HTTP, see MetricsExporter) ===
+  void SetMetricsAddress(const std::string &address);  ///< e.g. "*:9100"
+  std::string GetMetricsAddress() const;
+  bool StartMetricsExporter();
+  void StopMetricsExporter();
+
   // === Public control methods ===
   bool Arm();
   bool Start(uint32_t run_number);
@@ -92,10 +117,51 @@ public:
 
   /**
    * @brief Get current queue size
-   * @return Number of items in queue
+   * @return Number of items in the in-memory queue
    */
   size_t GetQueueSize() const;
 
+  /**
+   * @brief Enable spill mode
+   * @param directory Existing local directory for the spill file, which
+   *                  is created when armed; empty disables spill mode
+   *                  (default)
+   */
+  void SetSpillDirectory(const std::string &directory);
+  std::string GetSpillDirectory() const;
+
+  /**
+   * @brief Set the size of the spill file
+   * @param bytes Spill ring capacity (default: 1 GiB)
+   */
+  void SetSpillCapacity(uint64_t bytes);
+  uint64_t GetSpillCapacity() const;
+
+  /// Frames waiting in the spill file
+  size_t GetSpilledFrames() const;
+
+  /// Frames dropped this run (queue and spill file full, or output gone)
+  uint64_t GetDroppedFrames() const;
+
+  /**
+   * @brief Restore the order of each input
+   * @param frames Frames held per input while one is missing; 0 (default)
+   *               forwards frames as they arrive. Applies from the next
+   *               run.
+   */
+  void SetReorderWindow(size_t frames);
+  size_t GetReorderWindow() const;
+
+  /// Sequence accounting of one input this run
+  struct InputSequenceStats {
+    uint64_t received = 0;
+    uint64_t lost = 0;       ///< Missing from the source's sequence
+    uint64_t reordered = 0;  ///< Arrived after a later frame
+    uint64_t late = 0;       ///< Reordered beyond the window, not restored
+    uint64_t duplicates = 0; ///< Repeated frames, dropped
+  };
+  InputSequenceStats GetInputSequenceStats(size_t input) const;
+
   // === Testing utilities ===
   void ForceError(const std::string &message);
 
@@ -112,6 +178,10 @@ private:
   bool TransitionTo(ComponentState newState);
   void ReceivingLoop(size_t input_index);
   void SendingLoop();
+  // Queue frames for the sending thread (clears @p frames)
+  void QueueFrames(std::vector<std::unique_ptr<std::vector<uint8_t>>> &frames,
+                   uint64_t &counter);
+  InputSequenceStats SumInputSequenceStats() const;
 
   // === State ===
   std::atomic<ComponentState> fState{ComponentState::Idle};
@@ -128,12 +198,31 @@ private:
   std::atomic<uint64_t> fEventsProcessed{0};
   std::atomic<uint64_t> fBytesTransferred{0};
   std::atomic<uint64_t> fHeartbeatCounter{0};
+  LatencyRecorder fLatency;  // Recorded by the sending thread; receivers
+                             // sample with their own counters
+  mutable RateEstimator fRates;  // Counted by the sending thread
 
   // === Thread-safe queue for data buffering ===
-  std::queue<std::unique_ptr<std::vector<uint8_t>>> fDataQueue;
+  // Frame stamp: receive time if timed for latency, else 0
+  static constexpr size_t kMaxQueueSize = 10000;  // Prevent unbounded growth
+  Net::SpillQueue fDataQueue{kMaxQueueSize};
   mutable std::mutex fQueueMutex;
   std::condition_variable fQueueCondition;
-  static constexpr size_t kMaxQueueSize = 10000;  // Prevent unbounded growth
+  std::mutex fPushMutex;  // One receiver pushes at a time; held across the
+                          // spill write, which runs without fQueueMutex
+
+  // === Spill mode ===
+  std::string fSpillDirectory;
+  uint64_t fSpillCapacity = SpillBuffer::kDefaultCapacityBytes;
+  static constexpr std::chrono::milliseconds kSpillRetryInterval{100};
+
+  // === Per-input sequence tracking ===
+  // Source ids are one byte: input index + 1
+  static constexpr size_t kMaxInputs = 255;
+  std::vector<std::unique_ptr<Net::SequenceReorderer>> fReorderers;
+  mutable std::mutex fReorderersMutex;  // Guards the vector, not its items
+  size_t fReorderWindow = 0;
+  uint64_t fMergeSequence = 0;  // Next merge_sequence, sending thread only
 
   // === Threads ===
   std::vector<std::unique_ptr<std::thread>> fReceivingThreads;
@@ -155,6 +244,10 @@ private:
   std::unique_ptr<Net::ZMQTransport> fCommandTransport;
   std::unique_ptr<std::thread> fCommandListenerThread;
   std::atomic<bool> fCommandListenerRunning{false};
+
+  // === Metrics endpoint ===
+  MetricsEndpoint fMetrics;
+
   void CommandListenerLoop();
   void HandleCommand(const Command &cmd);
 };
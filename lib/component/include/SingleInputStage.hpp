@@ -0,0 +1,107 @@
+/**
+ * @file SingleInputStage.hpp
+ * @brief Base of the stages that transform one stream frame by frame
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StageComponent.hpp"
+
+namespace DELILA {
+
+/**
+ * @brief Receives one stream and hands each frame to ProcessFrame()
+ *
+ * Architecture:
+ *   ReceivingThread -> Queue -> ProcessingThread (ProcessFrame)
+ *
+ * The receiving thread drops frames while the queue is full. The
+ * processing thread times the frames sampled for latency, forwards EOS to
+ * every output in order and passes everything else to ProcessFrame(),
+ * which sends its results with SendFrame(). A stage with its own
+ * processing threads overrides StartProcessing()/StopProcessing() and
+ * takes the frames with PopFrame().
+ */
+class SingleInputStage : public StageComponent {
+public:
+  size_t GetQueueSize() const override;
+
+protected:
+  // Frame waiting for processing; index is the receive order in the run,
+  // enqueued_ns is non-zero only for frames sampled for latency timing
+  struct QueuedFrame {
+    std::unique_ptr<std::vector<uint8_t>> data;
+    uint64_t index = 0;
+    uint64_t enqueued_ns = 0;
+  };
+
+  /**
+   * @param name Prefix of the stage's log messages
+   * @param maxOutputs Outputs given a transport
+   */
+  explicit SingleInputStage(std::string name, size_t maxOutputs = 1);
+
+  /**
+   * @brief Transform one data frame and send the result
+   *
+   * Called on the processing thread for every frame that is not EOS; not
+   * used by stages that replace StartProcessing().
+   */
+  virtual void ProcessFrame(std::unique_ptr<std::vector<uint8_t>> & /*data*/) {
+  }
+
+  /// Start the threads that take frames from the queue
+  virtual void StartProcessing();
+
+  /// Wait for them; the queue is drained or, on abort, left
+  virtual void StopProcessing();
+
+  /**
+   * @brief Wait for the next frame in receive order
+   * @return false once stopped with the queue empty, or on abort
+   */
+  bool PopFrame(QueuedFrame &frame);
+
+  /**
+   * @brief Send a frame to one output and count it as processed
+   * @return false if the output is not connected or the send failed
+   */
+  bool SendFrame(size_t output, std::unique_ptr<std::vector<uint8_t>> &frame,
+                 uint32_t events);
+
+  /// Forward an EOS marker to every output
+  void SendEOS(std::unique_ptr<std::vector<uint8_t>> &eos);
+
+  // === StageComponent hooks ===
+  void StartThreads() override;
+  void StopThreads(bool graceful) override;
+
+  std::atomic<bool> fAbort{false};  // Non-graceful stop: drop the queue
+
+private:
+  void ReceivingLoop();
+  void ProcessingLoop();
+
+  const std::string fName;
+
+  // === Data queue ===
+  std::queue<QueuedFrame> fDataQueue;
+  mutable std::mutex fQueueMutex;
+  std::condition_variable fQueueCondition;
+
+  // === Threads ===
+  std::unique_ptr<std::thread> fReceivingThread;
+  std::unique_ptr<std::thread> fProcessingThread;
+};
+
+}  // namespace DELILA
@@ -0,0 +1,143 @@
+/**
+ * @file SpillBuffer.hpp
+ * @brief Spill mode for the output of a source
+ *
+ * ZMQTransport::SendBytes() drops a frame when downstream cannot take it.
+ * In spill mode a source holds such frames back instead: a bounded number
+ * in memory, the rest in a Net::SpillQueue ring file on local disk. The
+ * held frames are sent, in order and ahead of any newer frame, once the
+ * output is ready again.
+ */
+
+#ifndef DELILA_COMPONENT_SPILL_BUFFER_HPP
+#define DELILA_COMPONENT_SPILL_BUFFER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SpillQueue.hpp>
+
+namespace DELILA {
+
+/**
+ * @brief Holds back frames the output is not ready for
+ *
+ * Send() replaces the source's send call on the data path. It first sends
+ * held frames for as long as the output is ready, then sends the new frame
+ * if nothing is held any more and the output is still ready; otherwise the
+ * frame joins the held ones. Frames are only dropped when memory and the
+ * spill file are both full.
+ *
+ * The output is reached through two functions so that sources can route
+ * sends through a RetransmitServer: @p send behaves like
+ * ZMQTransport::SendBytes(), @p ready like
+ * ZMQTransport::WaitForSendReady().
+ *
+ * Not thread-safe, except for the counters: Send(), Drain() and Flush()
+ * are called by the thread that sends (or after it was joined).
+ *
+ * Usage:
+ * @code{.cpp}
+ * SpillBuffer spill;
+ * spill.Open("/data/spill/source.spill", 1ULL << 30, send, ready); // arm
+ * spill.Clear();               // when a run starts
+ * spill.Send(frame);           // for every frame
+ * spill.Drain();               // while idle
+ * spill.Flush(timeout);        // at stop, before EOS
+ * @endcode
+ */
+class SpillBuffer {
+public:
+  using SendFunction =
+      std::function<bool(std::unique_ptr<std::vector<uint8_t>> &)>;
+  using ReadyFunction = std::function<bool(std::chrono::milliseconds)>;
+
+  static constexpr size_t kDefaultMemoryFrames = 1024;
+  static constexpr uint64_t kDefaultCapacityBytes = 1ULL << 30;  // 1 GiB
+  static constexpr std::chrono::milliseconds kDefaultFlushTimeout{5000};
+
+  /// Spill file of a component: "<directory>/<componentId>.spill"
+  static std::string PathFor(const std::string &directory,
+                             const std::string &componentId);
+
+  SpillBuffer();
+  ~SpillBuffer();
+
+  SpillBuffer(const SpillBuffer &) = delete;
+  SpillBuffer &operator=(const SpillBuffer &) = delete;
+
+  /// Frames held in memory before spilling to disk
+  void SetMemoryFrames(size_t frames);
+
+  /**
+   * @brief Create the spill file and start holding frames back
+   * @param path Spill file on a local disk (removed by Close())
+   * @param capacityBytes Size of the spill file's ring
+   * @param error Receives the reason on failure, if not null
+   */
+  bool Open(const std::string &path, uint64_t capacityBytes, SendFunction send,
+            ReadyFunction ready, std::string *error = nullptr);
+  void Close();
+  bool IsOpen() const { return fQueue.IsSpillOpen(); }
+
+  /// New run: drop held frames and reset the counters
+  void Clear();
+
+  /**
+   * @brief Send a frame after the held ones, or hold it back
+   * @return true if the frame was sent or held; false if it was dropped
+   *         or the buffer is not open
+   */
+  bool Send(std::unique_ptr<std::vector<uint8_t>> &frame);
+
+  /// Send held frames while the output is ready, without waiting
+  void Drain();
+
+  /**
+   * @brief Send all held frames, waiting for the output
+   * @param timeout Longest wait for the output to become ready; when it
+   *        passes, the frames still held are dropped
+   * @return true if nothing was dropped
+   */
+  bool Flush(std::chrono::milliseconds timeout = kDefaultFlushTimeout);
+
+  // === Counters (since the last Clear()) ===
+  /// Frames held back, in memory and on disk
+  size_t GetHeldFrames() const { return fHeldFrames.load(); }
+  size_t GetSpilledFrames() const { return fSpilledFrames.load(); }
+  uint64_t GetSpilledBytes() const { return fSpilledBytes.load(); }
+  uint64_t GetCapacityBytes() const { return fCapacityBytes.load(); }
+  /// Spilled bytes over capacity, 0..1
+  double GetOccupancy() const;
+  /// Frames written to / read back from the spill file
+  uint64_t GetFramesSpilled() const { return fFramesSpilled.load(); }
+  uint64_t GetFramesRestored() const { return fFramesRestored.load(); }
+  /// Frames dropped because memory and disk were full, or by Flush()
+  uint64_t GetFramesDropped() const { return fFramesDropped.load(); }
+
+private:
+  bool SendHeld(std::chrono::milliseconds timeout);
+  void UpdateCounters();
+
+  Net::SpillQueue fQueue;
+  SendFunction fSend;
+  ReadyFunction fReady;
+
+  std::atomic<size_t> fHeldFrames{0};
+  std::atomic<size_t> fSpilledFrames{0};
+  std::atomic<uint64_t> fSpilledBytes{0};
+  std::atomic<uint64_t> fCapacityBytes{0};
+  std::atomic<uint64_t> fFramesSpilled{0};
+  std::atomic<uint64_t> fFramesRestored{0};
+  std::atomic<uint64_t> fFramesDropped{0};
+};
+
+} // namespace DELILA
+
+#endif // DELILA_COMPONENT_SPILL_BUFFER_HPP
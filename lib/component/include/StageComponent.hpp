@@ -0,0 +1,201 @@
+/**
+ * @file StageComponent.hpp
+ * @brief Lifecycle, transports and control shared by processing stages
+ *
+ * The processing stages (FilterStage, WaveformReducer, CalibrationStage,
+ * WaveformAnalyzer, Router, EventBuilder) differ only in what they do with
+ * the data. StageComponent holds everything else: the state machine, the
+ * data transports, the command channel, the metrics endpoint and the
+ * status report.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "delila/core/Command.hpp"
+#include "delila/core/ComponentState.hpp"
+#include "delila/core/ComponentStatus.hpp"
+#include "delila/core/IDataComponent.hpp"
+#include "LatencyHistogram.hpp"
+#include "MetricsExporter.hpp"
+#include "RateEstimator.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class ZMQTransport;
+}  // namespace Net
+
+/**
+ * @brief Base of the processing stages
+ *
+ * Initialize() connects a PULL transport to each input and binds a PUSH
+ * transport on each output (up to the limits given by the derived class);
+ * Arm() connects them. Start() and Stop() reset the run counters and hand
+ * over to StartThreads()/StopThreads(), where the stage runs its data
+ * threads.
+ *
+ * Derived classes call Shutdown() in their destructor, while their own
+ * members still exist.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class StageComponent : public IDataComponent {
+public:
+  ~StageComponent() override;
+
+  // Disable copy
+  StageComponent(const StageComponent &) = delete;
+  StageComponent &operator=(const StageComponent &) = delete;
+
+  // === IComponent interface ===
+  bool Initialize(const std::string &config_path) override;
+  void Run() override;
+  void Shutdown() override;
+  ComponentState GetState() const override;
+  std::string GetComponentId() const override;
+  ComponentStatus GetStatus() const override;
+
+  // === IDataComponent interface ===
+  void SetInputAddresses(const std::vector<std::string> &addresses) override;
+  void SetOutputAddresses(const std::vector<std::string> &addresses) override;
+  std::vector<std::string> GetInputAddresses() const override;
+  std::vector<std::string> GetOutputAddresses() const override;
+
+  // === Command channel ===
+  void SetCommandAddress(const std::string &address) override;
+  std::string GetCommandAddress() const override;
+  void StartCommandListener() override;
+  void StopCommandListener() override;
+
+  // === Metrics endpoint (OpenMetrics over HTTP, see MetricsExporter) ===
+  void SetMetricsAddress(const std::string &address);  ///< e.g. "*:9100"
+  std::string GetMetricsAddress() const;
+  bool StartMetricsExporter();
+  void StopMetricsExporter();
+
+  // === Public control methods ===
+  bool Arm();
+  bool Start(uint32_t run_number);
+  bool Stop(bool graceful);
+  void Reset();
+
+  // === Configuration ===
+  void SetComponentId(const std::string &id);
+
+  /// Data waiting between the receiving and the processing threads
+  virtual size_t GetQueueSize() const = 0;
+
+  // === Testing utilities ===
+  void ForceError(const std::string &message);
+
+protected:
+  /// No limit on the number of inputs or outputs
+  static constexpr size_t kAnyCount = std::numeric_limits<size_t>::max();
+
+  /// Bound of the queue behind the receiving threads
+  static constexpr size_t kMaxQueueSize = 10000;
+
+  /**
+   * @param maxInputs Inputs given a transport; further addresses are ignored
+   * @param maxOutputs Outputs given a transport, likewise
+   */
+  StageComponent(size_t maxInputs, size_t maxOutputs);
+
+  // === IComponent callbacks ===
+  bool OnConfigure(const nlohmann::json &config) override;
+  bool OnArm() override;
+  bool OnStart(uint32_t run_number) override;
+  bool OnStop(bool graceful) override;
+  void OnReset() override;
+
+  // === Stage hooks ===
+  // OnInitialize, ResetCounters, StartThreads and StopThreads run with
+  // fStateMutex held; AddMetrics and HandleConfigure do not
+
+  /**
+   * @brief Check the settings before the transports are created
+   *
+   * The default refuses a configuration file: the stages are configured
+   * through their setters. Set fErrorMessage when returning false.
+   */
+  virtual bool OnInitialize(const std::string &config_path);
+
+  /// Clear the stage's own run counters, on Start() and Reset()
+  virtual void ResetCounters() {}
+
+  /// Start the data threads; fRunning is still false
+  virtual void StartThreads() = 0;
+
+  /**
+   * @brief Stop the data threads and wait for them
+   * @param graceful Forward what was received first, rather than drop it
+   *
+   * Also called when nothing runs (Shutdown(), Reset()).
+   */
+  virtual void StopThreads(bool graceful) = 0;
+
+  /// Register the stage's own series on the metrics endpoint
+  virtual void AddMetrics(MetricsExporter & /*exporter*/) {}
+
+  /**
+   * @brief Handle the Configure command
+   * @param message Receives the response text
+   *
+   * The default initializes from Idle and accepts being configured already.
+   */
+  virtual bool HandleConfigure(const Command &cmd, std::string &message);
+
+  // === State ===
+  std::atomic<ComponentState> fState{ComponentState::Idle};
+  mutable std::mutex fStateMutex;
+  std::string fComponentId;
+
+  // === Addresses ===
+  std::vector<std::string> fInputAddresses;
+  std::vector<std::string> fOutputAddresses;
+
+  // === Run state ===
+  std::atomic<uint32_t> fRunNumber{0};
+  std::string fErrorMessage;
+  std::atomic<uint64_t> fEventsProcessed{0};
+  std::atomic<uint64_t> fBytesTransferred{0};
+  std::atomic<uint64_t> fBytesReceived{0};
+  std::atomic<uint64_t> fHeartbeatCounter{0};
+  LatencyRecorder fLatency;
+  mutable RateEstimator fRates;
+  std::atomic<bool> fRunning{false};
+  std::atomic<bool> fShutdownRequested{false};
+
+  // === Network components (one per address, in address order) ===
+  std::vector<std::unique_ptr<Net::ZMQTransport>> fInputTransports;
+  std::vector<std::unique_ptr<Net::ZMQTransport>> fOutputTransports;
+
+private:
+  void DisconnectTransports();
+  void CommandListenerLoop();
+  void HandleCommand(const Command &cmd);
+
+  const size_t fMaxInputs;
+  const size_t fMaxOutputs;
+
+  // === Command channel ===
+  std::string fCommandAddress;
+  std::unique_ptr<Net::ZMQTransport> fCommandTransport;
+  std::unique_ptr<std::thread> fCommandListenerThread;
+  std::atomic<bool> fCommandListenerRunning{false};
+
+  // === Metrics endpoint ===
+  MetricsEndpoint fMetrics;
+};
+
+}  // namespace DELILA
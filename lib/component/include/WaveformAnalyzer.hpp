@@ -0,0 +1,115 @@
+/**
+ * @file WaveformAnalyzer.hpp
+ * @brief Software PSD and CFD timing component
+ *
+ * WaveformAnalyzer recomputes energy, energyShort and the timestamp of
+ * full (waveform) events from analogProbe1 (see PulseAnalyzer), on
+ * several worker threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PulseAnalyzer.hpp"
+#include "SingleInputStage.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class DataProcessor;
+}  // namespace Net
+
+/**
+ * @brief Analyzes the waveforms of one stream
+ *
+ * Architecture:
+ *   ReceivingThread -> Queue -> AnalyzingThreads (decode, analyze, encode)
+ *                   -> SendingThread (sends in receive order)
+ *
+ * Frames are numbered on receipt; each worker analyzes whole frames with
+ * its own PulseAnalyzer, and the sending thread puts them back in order,
+ * so the output has the input's frame and event order. Full event frames
+ * keep their format and sequence number with the results written into
+ * energy, energyShort, timeStampNs and flags (PulseAnalyzer::FLAG_*).
+ * Events without a waveform, other frames and EOS pass unchanged.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class WaveformAnalyzer : public SingleInputStage {
+public:
+  WaveformAnalyzer();
+  ~WaveformAnalyzer() override;
+
+  // === Configuration ===
+
+  /**
+   * @brief Set gates, CFD and scale (only while not running)
+   * @param error Receives the reason if the settings are rejected
+   * @return false if they are inconsistent or the stage is running
+   */
+  bool SetSettings(const PulseAnalyzer::Settings &settings,
+                   std::string *error = nullptr);
+  PulseAnalyzer::Settings GetSettings() const;
+
+  /// Analyzing threads, at least 1 (default: 2; only while not running)
+  void SetWorkerThreads(uint32_t count);
+  uint32_t GetWorkerThreads() const;
+
+  /// Events analyzed this run, and those without a CFD crossing
+  uint64_t GetEventsAnalyzed() const;
+  uint64_t GetCfdFailures() const;
+
+protected:
+  // === SingleInputStage hooks ===
+  void ResetCounters() override;
+  void AddMetrics(MetricsExporter &exporter) override;
+  void StartProcessing() override;
+  void StopProcessing() override;
+
+private:
+  // Analyzed frame waiting for its turn to be sent; enqueued_ns/started_ns
+  // are non-zero only for frames sampled for latency timing. A null data is
+  // a dropped frame, which still takes its turn so the sending thread does
+  // not wait for it.
+  struct AnalyzedFrame {
+    std::unique_ptr<std::vector<uint8_t>> data;
+    uint64_t enqueued_ns = 0;
+    uint64_t started_ns = 0;
+    uint64_t header_timestamp = 0;
+    uint32_t event_count = 0;
+  };
+
+  void AnalyzingLoop(PulseAnalyzer analyzer);
+  void SendingLoop();
+  void AnalyzeFrame(AnalyzedFrame &frame, PulseAnalyzer &analyzer,
+                    Net::DataProcessor &processor);
+
+  // === Analysis (fixed while running; workers take copies) ===
+  PulseAnalyzer fAnalyzer;
+  uint32_t fWorkerThreads = 2;
+
+  std::atomic<uint64_t> fEventsAnalyzed{0};
+  std::atomic<uint64_t> fCfdFailures{0};
+
+  // === Analyzed frames waiting for their turn, by receive order ===
+  std::map<uint64_t, AnalyzedFrame> fDone;
+  std::mutex fDoneMutex;
+  std::condition_variable fDoneCondition;
+  std::atomic<bool> fWorkersFinished{false};
+
+  // === Threads ===
+  std::vector<std::thread> fAnalyzingThreads;
+  std::unique_ptr<std::thread> fSendingThread;
+};
+
+}  // namespace DELILA
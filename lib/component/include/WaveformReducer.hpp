@@ -0,0 +1,109 @@
+/**
+ * @file WaveformReducer.hpp
+ * @brief Waveform reduction component
+ *
+ * WaveformReducer converts full EventData streams to MinimalEventData and
+ * keeps waveforms only for a prescaled sample, selected channels or events
+ * matching rules (see EventFilter).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "EventFilter.hpp"
+#include "SingleInputStage.hpp"
+
+namespace DELILA {
+
+namespace Net {
+class DataProcessor;
+struct BinaryDataHeader;
+}  // namespace Net
+
+/**
+ * @brief Reduces full (waveform) event frames to minimal frames
+ *
+ * Architecture:
+ *   ReceivingThread -> Queue -> ProcessingThread (split, re-encode, send)
+ *
+ * Every full event frame becomes one minimal frame holding all of its
+ * events, followed, when any waveform is kept, by a full frame holding
+ * only those events. Each frame has its own sequence number; the full
+ * frame carries FRAME_FLAG_WAVEFORM_COMPANION and belongs to the minimal
+ * frame numbered one before it. Within a pair the events keep their order
+ * and are matched by module, channel and timestamp.
+ *
+ * A waveform is kept if any of the following selects the event:
+ *   - prescale N: every N-th event (0 = off)
+ *   - waveform channels: every event of a listed module/channel
+ *   - rules: events passing all rules (none = off)
+ * With nothing configured the stream is only converted. Minimal and built
+ * frames are forwarded unchanged; EOS is forwarded in order.
+ *
+ * State transitions follow IComponent standard:
+ *   Idle -> Configured -> Armed -> Running -> Configured
+ */
+class WaveformReducer : public SingleInputStage {
+public:
+  WaveformReducer();
+  ~WaveformReducer() override;
+
+  // === Configuration ===
+
+  /// Keep the waveform of every N-th event (0 = no prescaled sample)
+  void SetPrescale(uint32_t prescale);
+  uint32_t GetPrescale() const;
+
+  /// Keep the waveforms of these module/channel pairs
+  void SetWaveformChannels(
+      const std::vector<std::pair<uint8_t, uint8_t>> &channels);
+  std::vector<std::pair<uint8_t, uint8_t>> GetWaveformChannels() const;
+
+  /**
+   * @brief Add a waveform selection rule (only while not running)
+   * @param expression Rule text, e.g. "psd > 0.2" (see EventFilter)
+   * @param error Receives the reason if the rule is rejected (may be null)
+   * @return false if the rule is invalid or the stage is running
+   */
+  bool AddRule(const std::string &expression, std::string *error = nullptr);
+  void ClearRules();
+  std::vector<std::string> GetRules() const;
+
+  /// Events whose waveform was kept this run
+  uint64_t GetWaveformsKept() const;
+
+protected:
+  // === SingleInputStage hooks ===
+  void ResetCounters() override;
+  void AddMetrics(MetricsExporter &exporter) override;
+  void ProcessFrame(std::unique_ptr<std::vector<uint8_t>> &data) override;
+
+private:
+  void ReduceFrame(std::unique_ptr<std::vector<uint8_t>> &data,
+                   const Net::BinaryDataHeader &header);
+
+  // === Selection (fixed while running) ===
+  uint32_t fPrescale = 0;
+  std::vector<std::pair<uint8_t, uint8_t>> fWaveformChannels;
+  std::bitset<256 * 256> fChannelMask;  // Index: module << 8 | channel
+  EventFilter fFilter;
+
+  // === Reduction state (processing thread only) ===
+  EventFilter::Batch fBatch;
+  std::vector<uint8_t> fPass;
+  std::vector<uint64_t> fRuleCounts;  // Required by Evaluate(), not reported
+  uint64_t fPrescaleCounter = 0;
+  uint64_t fSequence = 0;
+
+  std::atomic<uint64_t> fWaveformsKept{0};
+  std::unique_ptr<Net::DataProcessor> fDataProcessor;
+};
+
+}  // namespace DELILA
@@ -3,11 +3,13 @@
 #include <ZMQTransport.hpp>
 #include <delila/core/ErrorCode.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace DELILA {
 
@@ -47,10 +49,11 @@ void CLIOperator::Shutdown() {
     fJobs.clear();
   }
 
-  // Clear components
+  // Clear components (jobs still running keep their channels alive)
   {
     std::lock_guard<std::mutex> lock(fComponentsMutex);
     fComponents.clear();
+    fCommandChannels.clear();
   }
 
   fState = ComponentState::Idle;
@@ -80,20 +83,9 @@ ComponentStatus CLIOperator::GetStatus() const {
 std::string CLIOperator::ConfigureAllAsync() {
   auto job_id = GenerateJobId();
 
-  ExecuteJob(job_id, [this]() {
-    std::lock_guard<std::mutex> lock(fComponentsMutex);
-
-    for (const auto &component : fComponents) {
-      Command cmd(CommandType::Configure);
-
-      auto response = SendCommandToComponent(component, cmd);
-      if (response.success) {
-        fComponentStates[component.component_id] = response.current_state;
-      } else {
-        throw std::runtime_error("Failed to configure " + component.component_id +
-                                 ": " + response.message);
-      }
-    }
+  ExecuteJob(job_id, [this, job_id]() {
+    Command cmd(CommandType::Configure);
+    FanOutCommand(job_id, cmd, "configure");
   });
 
   return job_id;
@@ -102,20 +94,9 @@ std::string CLIOperator::ConfigureAllAsync() {
 std::string CLIOperator::ArmAllAsync() {
   auto job_id = GenerateJobId();
 
-  ExecuteJob(job_id, [this]() {
-    std::lock_guard<std::mutex> lock(fComponentsMutex);
-
-    for (const auto &component : fComponents) {
-      Command cmd(CommandType::Arm);
-
-      auto response = SendCommandToComponent(component, cmd);
-      if (response.success) {
-        fComponentStates[component.component_id] = response.current_state;
-      } else {
-        throw std::runtime_error("Failed to arm " + component.component_id +
-                                 ": " + response.message);
-      }
-    }
+  ExecuteJob(job_id, [this, job_id]() {
+    Command cmd(CommandType::Arm);
+    FanOutCommand(job_id, cmd, "arm");
   });
 
   return job_id;
@@ -124,21 +105,10 @@ std::string CLIOperator::ArmAllAsync() {
 std::string CLIOperator::StartAllAsync(uint32_t run_number) {
   auto job_id = GenerateJobId();
 
-  ExecuteJob(job_id, [this, run_number]() {
-    std::lock_guard<std::mutex> lock(fComponentsMutex);
-
-    for (const auto &component : fComponents) {
-      Command cmd(CommandType::Start);
-      cmd.run_number = run_number;
-
-      auto response = SendCommandToComponent(component, cmd);
-      if (response.success) {
-        fComponentStates[component.component_id] = response.current_state;
-      } else {
-        throw std::runtime_error("Failed to start " + component.component_id +
-                                 ": " + response.message);
-      }
-    }
+  ExecuteJob(job_id, [this, job_id, run_number]() {
+    Command cmd(CommandType::Start);
+    cmd.run_number = run_number;
+    FanOutCommand(job_id, cmd, "start");
   });
 
   return job_id;
@@ -147,21 +117,10 @@ std::string CLIOperator::StartAllAsync(uint32_t run_number) {
 std::string CLIOperator::StopAllAsync(bool graceful) {
   auto job_id = GenerateJobId();
 
-  ExecuteJob(job_id, [this, graceful]() {
-    std::lock_guard<std::mutex> lock(fComponentsMutex);
-
-    for (const auto &component : fComponents) {
-      Command cmd(CommandType::Stop);
-      cmd.graceful = graceful;
-
-      auto response = SendCommandToComponent(component, cmd);
-      if (response.success) {
-        fComponentStates[component.component_id] = response.current_state;
-      } else {
-        throw std::runtime_error("Failed to stop " + component.component_id +
-                                 ": " + response.message);
-      }
-    }
+  ExecuteJob(job_id, [this, job_id, graceful]() {
+    Command cmd(CommandType::Stop);
+    cmd.graceful = graceful;
+    FanOutCommand(job_id, cmd, "stop");
   });
 
   return job_id;
@@ -170,20 +129,9 @@ std::string CLIOperator::StopAllAsync(bool graceful) {
 std::string CLIOperator::ResetAllAsync() {
   auto job_id = GenerateJobId();
 
-  ExecuteJob(job_id, [this]() {
-    std::lock_guard<std::mutex> lock(fComponentsMutex);
-
-    for (const auto &component : fComponents) {
-      Command cmd(CommandType::Reset);
-
-      auto response = SendCommandToComponent(component, cmd);
-      if (response.success) {
-        fComponentStates[component.component_id] = response.current_state;
-      } else {
-        throw std::runtime_error("Failed to reset " + component.component_id +
-                                 ": " + response.message);
-      }
-    }
+  ExecuteJob(job_id, [this, job_id]() {
+    Command cmd(CommandType::Reset);
+    FanOutCommand(job_id, cmd, "reset");
   });
 
   return job_id;
@@ -297,6 +245,62 @@ void CLIOperator::UnregisterComponent(const std::string &component_id) {
                        return addr.component_id == component_id;
                      }),
       fComponents.end());
+  fCommandChannels.erase(component_id);
+}
+
+void CLIOperator::SetCommandTimeout(std::chrono::milliseconds timeout) {
+  fCommandTimeoutMs = timeout.count();
+}
+
+std::chrono::milliseconds CLIOperator::GetCommandTimeout() const {
+  return std::chrono::milliseconds(fCommandTimeoutMs.load());
+}
+
+// === Command ordering ===
+
+CLIOperator::ComponentTier
+CLIOperator::GetComponentTier(const ComponentAddress &address) {
+  const auto &type = address.component_type;
+  auto contains = [&type](const char *word) {
+    return type.find(word) != std::string::npos;
+  };
+
+  if (contains("Source") || contains("Emulator")) {
+    return ComponentTier::Source;
+  }
+  if (contains("Writer") || contains("Monitor") || contains("Sink")) {
+    return ComponentTier::Sink;
+  }
+  return ComponentTier::Merger;
+}
+
+std::vector<std::vector<ComponentAddress>>
+CLIOperator::PlanCommandBatches(const std::vector<ComponentAddress> &components,
+                                CommandType type) {
+  if (components.empty()) {
+    return {};
+  }
+  if (type != CommandType::Start && type != CommandType::Stop) {
+    return {components};
+  }
+
+  // Sinks first for Start; registration order is kept within a batch
+  using Key = std::pair<int, uint32_t>;
+  std::map<Key, std::vector<ComponentAddress>> batches;
+  for (const auto &component : components) {
+    Key key(static_cast<int>(GetComponentTier(component)),
+            component.start_order);
+    batches[key].push_back(component);
+  }
+
+  std::vector<std::vector<ComponentAddress>> ordered;
+  for (auto &entry : batches) {
+    ordered.push_back(std::move(entry.second));
+  }
+  if (type == CommandType::Stop) {
+    std::reverse(ordered.begin(), ordered.end());
+  }
+  return ordered;
 }
 
 // === Testing utilities ===
@@ -401,41 +405,121 @@ void CLIOperator::ExecuteJob(const std::string &job_id,
 
 // === Command sending ===
 
+std::shared_ptr<CLIOperator::CommandChannel>
+CLIOperator::GetCommandChannel(const std::string &component_id) {
+  std::lock_guard<std::mutex> lock(fComponentsMutex);
+  auto &channel = fCommandChannels[component_id];
+  if (!channel) {
+    channel = std::make_shared<CommandChannel>();
+  }
+  return channel;
+}
+
 CommandResponse CLIOperator::SendCommandToComponent(const ComponentAddress &component,
                                                      const Command &cmd) {
   CommandResponse response;
   response.success = false;
   response.error_code = ErrorCode::CommunicationError;
 
-  // Create a temporary transport for this command
-  auto transport = std::make_unique<Net::ZMQTransport>();
-  Net::TransportConfig config;
-  config.command_address = component.command_address;
-  config.bind_command = false;  // Connect to component's REP socket
-  // Disable data and status sockets
-  config.data_address = "";
-  config.status_address = "";
-
-  if (!transport->Configure(config)) {
-    response.message = "Failed to configure transport";
-    return response;
-  }
+  auto channel = GetCommandChannel(component.component_id);
+  std::lock_guard<std::mutex> lock(channel->mutex);
+
+  // Connect once and keep the connection for later commands
+  if (!channel->transport) {
+    auto transport = std::make_unique<Net::ZMQTransport>();
+    Net::TransportConfig config;
+    config.command_address = component.command_address;
+    config.bind_command = false;  // Connect to component's REP socket
+    // Disable data and status sockets
+    config.data_address = "";
+    config.status_address = "";
+
+    if (!transport->Configure(config)) {
+      response.message = "Failed to configure transport";
+      return response;
+    }
 
-  if (!transport->Connect()) {
-    response.message = "Failed to connect to component";
-    return response;
+    if (!transport->Connect()) {
+      response.message = "Failed to connect to component";
+      return response;
+    }
+    channel->transport = std::move(transport);
   }
 
   // Send command and wait for response
-  auto receivedResponse = transport->SendCommand(cmd);
+  auto receivedResponse = channel->transport->SendCommand(cmd, GetCommandTimeout());
   if (receivedResponse) {
     response = *receivedResponse;
   } else {
     response.message = "No response from component";
+    // A REQ socket that missed its reply cannot send again: reconnect next time
+    channel->transport->Disconnect();
+    channel->transport.reset();
   }
 
-  transport->Disconnect();
   return response;
 }
 
+void CLIOperator::FanOutCommand(const std::string &job_id, const Command &cmd,
+                                const std::string &verb) {
+  std::vector<ComponentAddress> components;
+  {
+    std::lock_guard<std::mutex> lock(fComponentsMutex);
+    components = fComponents;
+  }
+
+  // Stop and Reset go through every batch even after a failure so that no
+  // component is left running; other commands abort at the failing batch
+  bool continueOnError =
+      cmd.type == CommandType::Stop || cmd.type == CommandType::Reset;
+  std::vector<std::string> failures;
+
+  for (const auto &batch : PlanCommandBatches(components, cmd.type)) {
+    std::vector<std::future<std::pair<CommandResponse, double>>> replies;
+    replies.reserve(batch.size());
+    for (const auto &component : batch) {
+      replies.push_back(std::async(std::launch::async, [this, component, cmd]() {
+        auto start = std::chrono::steady_clock::now();
+        auto response = SendCommandToComponent(component, cmd);
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+        return std::make_pair(response, ms);
+      }));
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+      auto [response, ms] = replies[i].get();
+      const auto &id = batch[i].component_id;
+
+      {
+        std::lock_guard<std::mutex> lock(fJobsMutex);
+        auto it = fJobs.find(job_id);
+        if (it != fJobs.end()) {
+          it->second.component_latency_ms[id] = ms;
+        }
+      }
+
+      if (response.success) {
+        std::lock_guard<std::mutex> lock(fComponentsMutex);
+        fComponentStates[id] = response.current_state;
+      } else {
+        failures.push_back(id + ": " + response.message);
+      }
+    }
+
+    if (!failures.empty() && !continueOnError) {
+      break;
+    }
+  }
+
+  if (!failures.empty()) {
+    std::string message = "Failed to " + verb + " ";
+    for (size_t i = 0; i < failures.size(); ++i) {
+      message += (i > 0 ? ", " : "") + failures[i];
+    }
+    throw std::runtime_error(message);
+  }
+}
+
 }  // namespace DELILA
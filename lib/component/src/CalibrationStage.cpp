@@ -0,0 +1,177 @@
+#include "CalibrationStage.hpp"
+
+#include <DataProcessor.hpp>
+
+#include <cstddef>
+
+namespace DELILA {
+
+CalibrationStage::CalibrationStage()
+    : SingleInputStage("CalibrationStage"),
+      fDataProcessor(std::make_unique<Net::DataProcessor>()) {}
+
+CalibrationStage::~CalibrationStage() { Shutdown(); }
+
+// === Configuration ===
+
+bool CalibrationStage::LoadCalibration(const std::string &path,
+                                       std::string *error) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    if (error) {
+      *error = "cannot change calibration while running";
+    }
+    return false;
+  }
+  return fTable.LoadFile(path, error);
+}
+
+bool CalibrationStage::LoadCalibrationJson(const std::string &text,
+                                           std::string *error) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    if (error) {
+      *error = "cannot change calibration while running";
+    }
+    return false;
+  }
+  return fTable.LoadJson(text, error);
+}
+
+bool CalibrationStage::SetCalibration(const CalibrationTable &table) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    return false;
+  }
+  fTable = table;
+  return true;
+}
+
+size_t CalibrationStage::GetCalibratedChannelCount() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fTable.GetChannelCount();
+}
+
+uint64_t CalibrationStage::GetUncalibratedEvents() const {
+  return fUncalibratedEvents.load();
+}
+
+// === SingleInputStage hooks ===
+
+bool CalibrationStage::OnInitialize(const std::string &config_path) {
+  // The configuration file is the calibration table
+  if (!config_path.empty()) {
+    std::string error;
+    if (!fTable.LoadFile(config_path, &error)) {
+      fErrorMessage = "Failed to load calibration: " + error;
+      return false;
+    }
+  }
+  return true;
+}
+
+void CalibrationStage::ResetCounters() { fUncalibratedEvents = 0; }
+
+void CalibrationStage::AddMetrics(MetricsExporter &exporter) {
+  exporter.AddCounter("uncalibrated_events",
+                      "Hits from channels without a calibration entry",
+                      [this] { return fUncalibratedEvents.load(); });
+  exporter.AddCounter("bytes_received", "Bytes received before calibration",
+                      [this] { return fBytesReceived.load(); });
+  exporter.AddGauge("calibrated_channels",
+                    "Channels with a calibration entry", [this] {
+                      return static_cast<double>(GetCalibratedChannelCount());
+                    });
+}
+
+bool CalibrationStage::HandleConfigure(const Command &cmd,
+                                       std::string &message) {
+  // A new calibration table may come with the command, as JSON in the
+  // payload or as a file path; it replaces the current one between runs
+  std::string error;
+  bool success = true;
+  if (!cmd.payload.empty()) {
+    success = LoadCalibrationJson(cmd.payload, &error);
+  } else if (!cmd.config_path.empty()) {
+    success = LoadCalibration(cmd.config_path, &error);
+  }
+  if (!success) {
+    message = "Failed to load calibration: " + error;
+    return false;
+  }
+
+  if (fState == ComponentState::Idle) {
+    success = Initialize("");
+  } else if (fState != ComponentState::Configured &&
+             fState != ComponentState::Armed) {
+    success = false;
+  }
+  message = success ? "Configured" : "Failed to configure";
+  return success;
+}
+
+void CalibrationStage::ProcessFrame(
+    std::unique_ptr<std::vector<uint8_t>> &data) {
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(*data, header)) {
+    return;
+  }
+
+  // Frames without raw hits are forwarded as they are
+  std::unique_ptr<std::vector<uint8_t>> output;
+  if (Net::DataProcessor::IsEventDataFormat(header.format_version) ||
+      header.format_version == Net::FORMAT_VERSION_MINIMAL_EVENTDATA) {
+    output = CalibrateFrame(data, header.format_version);
+    if (!output) {
+      return;
+    }
+    // Keep the source timestamp so frame age stays end-to-end, and the
+    // merger stamp so the frame can still be followed per source
+    Net::DataProcessor::CopySourceStamps(header, *output);
+  } else {
+    output = std::move(data);
+  }
+
+  SendFrame(0, output, header.event_count);
+}
+
+std::unique_ptr<std::vector<uint8_t>> CalibrationStage::CalibrateFrame(
+    std::unique_ptr<std::vector<uint8_t>> &data, uint32_t format) {
+  // Gather the hits into one contiguous batch
+  fHits.clear();
+  uint64_t sequence = 0;
+  if (format == Net::FORMAT_VERSION_MINIMAL_EVENTDATA) {
+    // Straight into the batch, without an allocation per hit
+    if (!fDataProcessor->DecodeMinimal(*data, fHits, sequence)) {
+      return nullptr;
+    }
+  } else {
+    auto [events, frameSequence] = fDataProcessor->Decode(data);
+    if (!events) {
+      return nullptr;
+    }
+    sequence = frameSequence;
+    fHits.reserve(events->size());
+    for (const auto &event : *events) {
+      fHits.emplace_back(event->module, event->channel, event->timeStampNs,
+                         event->energy, event->energyShort, event->flags);
+    }
+  }
+
+  // Calibrate straight into the output frame
+  const size_t count = fHits.size();
+  auto output = std::make_unique<std::vector<uint8_t>>(
+      Net::BINARY_DATA_HEADER_SIZE + count * sizeof(CalibratedEventData));
+  auto *records = reinterpret_cast<CalibratedEventData *>(
+      output->data() + Net::BINARY_DATA_HEADER_SIZE);
+  fUncalibratedEvents += fTable.Apply(fHits.data(), count, records);
+
+  if (!fDataProcessor->FinalizeFrame(
+          *output, Net::FORMAT_VERSION_CALIBRATED_EVENTDATA,
+          static_cast<uint32_t>(count), sequence)) {
+    return nullptr;
+  }
+  return output;
+}
+
+}  // namespace DELILA
@@ -0,0 +1,224 @@
+/**
+ * @file CalibrationTable.cpp
+ * @brief Calibration table loading and batch application
+ */
+
+#include "CalibrationTable.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+namespace DELILA {
+
+namespace {
+
+constexpr size_t kMaxKeys = 256 * 256;
+constexpr size_t kMaxLutSize = 65536;
+
+void Fail(std::string *error, const std::string &reason) {
+  if (error) {
+    *error = reason;
+  }
+}
+
+} // namespace
+
+CalibrationTable::CalibrationTable() { Clear(); }
+
+void CalibrationTable::Clear() {
+  fSlot.assign(kMaxKeys, 0);
+
+  // Slot 0: pass-through
+  fC0.assign(1, 0.0f);
+  fC1.assign(1, 1.0f);
+  fC2.assign(1, 0.0f);
+  fC3.assign(1, 0.0f);
+  fOffset.assign(1, 0.0);
+  fLutStart.assign(1, 0);
+  fLutSize.assign(1, 0);
+  fLut.clear();
+  fAnyLut = false;
+}
+
+uint16_t CalibrationTable::SlotFor(uint8_t module, uint8_t channel) {
+  uint16_t &slot = fSlot[Key(module, channel)];
+  if (slot == 0) {
+    slot = static_cast<uint16_t>(fC0.size());
+    fC0.push_back(0.0f);
+    fC1.push_back(1.0f);
+    fC2.push_back(0.0f);
+    fC3.push_back(0.0f);
+    fOffset.push_back(0.0);
+    fLutStart.push_back(0);
+    fLutSize.push_back(0);
+  }
+  return slot;
+}
+
+bool CalibrationTable::SetPolynomial(uint8_t module, uint8_t channel,
+                                     const std::vector<double> &coefficients) {
+  if (coefficients.empty() || coefficients.size() > kMaxTerms) {
+    return false;
+  }
+  double c[kMaxTerms] = {0.0, 0.0, 0.0, 0.0};
+  std::copy(coefficients.begin(), coefficients.end(), c);
+
+  uint16_t slot = SlotFor(module, channel);
+  fC0[slot] = static_cast<float>(c[0]);
+  fC1[slot] = static_cast<float>(c[1]);
+  fC2[slot] = static_cast<float>(c[2]);
+  fC3[slot] = static_cast<float>(c[3]);
+  fLutSize[slot] = 0;
+  return true;
+}
+
+bool CalibrationTable::SetLookupTable(uint8_t module, uint8_t channel,
+                                      const std::vector<float> &table) {
+  if (table.empty() || table.size() > kMaxLutSize) {
+    return false;
+  }
+  uint16_t slot = SlotFor(module, channel);
+  fLutStart[slot] = static_cast<uint32_t>(fLut.size());
+  fLutSize[slot] = static_cast<uint32_t>(table.size());
+  fLut.insert(fLut.end(), table.begin(), table.end());
+  fAnyLut = true;
+  return true;
+}
+
+void CalibrationTable::SetTimeOffset(uint8_t module, uint8_t channel,
+                                     double offsetNs) {
+  fOffset[SlotFor(module, channel)] = offsetNs;
+}
+
+bool CalibrationTable::LoadJson(const std::string &text, std::string *error) {
+  // Build a new table so a bad document leaves this one untouched
+  CalibrationTable table;
+  try {
+    auto json = nlohmann::json::parse(text);
+    const auto &channels = json.at("channels");
+    if (!channels.is_array()) {
+      Fail(error, "'channels' must be an array");
+      return false;
+    }
+
+    for (const auto &entry : channels) {
+      int module = entry.at("module").get<int>();
+      int channel = entry.at("channel").get<int>();
+      std::string where = "module " + std::to_string(module) + " channel " +
+                          std::to_string(channel);
+      if (module < 0 || module > 255 || channel < 0 || channel > 255) {
+        Fail(error, where + ": module/channel must be 0-255");
+        return false;
+      }
+      auto mod = static_cast<uint8_t>(module);
+      auto ch = static_cast<uint8_t>(channel);
+
+      if (entry.contains("poly") && entry.contains("lut")) {
+        Fail(error, where + ": give either 'poly' or 'lut'");
+        return false;
+      }
+      if (entry.contains("poly") &&
+          !table.SetPolynomial(mod, ch,
+                               entry["poly"].get<std::vector<double>>())) {
+        Fail(error, where + ": 'poly' needs 1 to 4 coefficients");
+        return false;
+      }
+      if (entry.contains("lut") &&
+          !table.SetLookupTable(mod, ch,
+                                entry["lut"].get<std::vector<float>>())) {
+        Fail(error, where + ": 'lut' needs 1 to 65536 entries");
+        return false;
+      }
+      table.SetTimeOffset(mod, ch, entry.value("time_offset", 0.0));
+    }
+  } catch (const std::exception &e) {
+    Fail(error, e.what());
+    return false;
+  }
+
+  *this = std::move(table);
+  return true;
+}
+
+bool CalibrationTable::LoadFile(const std::string &path, std::string *error) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    Fail(error, "cannot open " + path);
+    return false;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  return LoadJson(text.str(), error);
+}
+
+float CalibrationTable::CalibrateEnergy(uint8_t module, uint8_t channel,
+                                        uint16_t raw) const {
+  uint16_t s = fSlot[Key(module, channel)];
+  if (fLutSize[s] > 0) {
+    return fLut[fLutStart[s] + std::min<uint32_t>(raw, fLutSize[s] - 1)];
+  }
+  float x = raw;
+  return fC0[s] + x * (fC1[s] + x * (fC2[s] + x * fC3[s]));
+}
+
+size_t CalibrationTable::Apply(const MinimalEventData *hits, size_t count,
+                               CalibratedEventData *out) const {
+  fBatchSlot.resize(count);
+  fBatchEnergy.resize(count);
+  fBatchShort.resize(count);
+  uint16_t *slot = fBatchSlot.data();
+  float *energy = fBatchEnergy.data();
+  float *energyShort = fBatchShort.data();
+
+  // Packed records -> columns
+  size_t uncalibrated = 0;
+  for (size_t i = 0; i < count; ++i) {
+    slot[i] = fSlot[Key(hits[i].module, hits[i].channel)];
+    energy[i] = hits[i].energy;
+    energyShort[i] = hits[i].energyShort;
+    uncalibrated += (slot[i] == 0);
+  }
+
+  // Polynomial in Horner form; slot 0 is the identity
+  const float *c0 = fC0.data();
+  const float *c1 = fC1.data();
+  const float *c2 = fC2.data();
+  const float *c3 = fC3.data();
+  for (size_t i = 0; i < count; ++i) {
+    const uint16_t s = slot[i];
+    const float x = energy[i];
+    const float y = energyShort[i];
+    energy[i] = c0[s] + x * (c1[s] + x * (c2[s] + x * c3[s]));
+    energyShort[i] = c0[s] + y * (c1[s] + y * (c2[s] + y * c3[s]));
+  }
+
+  // Lookup tables replace the polynomial result
+  if (fAnyLut) {
+    for (size_t i = 0; i < count; ++i) {
+      const uint16_t s = slot[i];
+      const uint32_t size = fLutSize[s];
+      if (size > 0) {
+        const float *lut = fLut.data() + fLutStart[s];
+        energy[i] = lut[std::min<uint32_t>(hits[i].energy, size - 1)];
+        energyShort[i] = lut[std::min<uint32_t>(hits[i].energyShort, size - 1)];
+      }
+    }
+  }
+
+  // Columns -> packed records, with the time offset
+  const double *offset = fOffset.data();
+  for (size_t i = 0; i < count; ++i) {
+    out[i].module = hits[i].module;
+    out[i].channel = hits[i].channel;
+    out[i].rawEnergy = hits[i].energy;
+    out[i].energy = energy[i];
+    out[i].energyShort = energyShort[i];
+    out[i].timeStampNs = hits[i].timeStampNs + offset[slot[i]];
+    out[i].flags = hits[i].flags;
+  }
+  return uncalibrated;
+}
+
+} // namespace DELILA
@@ -0,0 +1,173 @@
+/**
+ * @file CoincidenceBuilder.cpp
+ * @brief Time ordering and coincidence grouping implementation
+ */
+
+#include "CoincidenceBuilder.hpp"
+
+#include <DataProcessor.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace DELILA {
+
+// === HitTimeBuckets ===
+
+HitTimeBuckets::HitTimeBuckets(double bucketNs) : fBucketNs(bucketNs) {}
+
+void HitTimeBuckets::Reset() {
+  for (auto &entry : fBuckets) {
+    entry.second.clear();
+    fSpare.push_back(std::move(entry.second));
+  }
+  fBuckets.clear();
+  fHaveLastBucket = false;
+  fReleased = false;
+  fHorizon = 0;
+  fBuffered = 0;
+  fLate = 0;
+}
+
+int64_t HitTimeBuckets::BucketIndex(double timeNs) const {
+  return static_cast<int64_t>(std::floor(timeNs / fBucketNs));
+}
+
+void HitTimeBuckets::Add(const MinimalEventData &hit) {
+  const int64_t index = BucketIndex(hit.timeStampNs);
+  if (fReleased && index < fHorizon) {
+    fLate++;
+    return;
+  }
+
+  if (!fHaveLastBucket || fLastBucket->first != index) {
+    auto it = fBuckets.find(index);
+    if (it == fBuckets.end()) {
+      Bucket bucket;
+      if (!fSpare.empty()) {
+        bucket = std::move(fSpare.back());
+        fSpare.pop_back();
+      }
+      it = fBuckets.emplace(index, std::move(bucket)).first;
+    }
+    fLastBucket = it;
+    fHaveLastBucket = true;
+  }
+  fLastBucket->second.push_back(hit);
+  fBuffered++;
+}
+
+void HitTimeBuckets::AppendSorted(Bucket &bucket,
+                                  std::vector<MinimalEventData> &out) {
+  // Ties broken by module/channel so the order does not depend on which
+  // input delivered first
+  std::sort(bucket.begin(), bucket.end(),
+            [](const MinimalEventData &a, const MinimalEventData &b) {
+              if (a.timeStampNs != b.timeStampNs) {
+                return a.timeStampNs < b.timeStampNs;
+              }
+              if (a.module != b.module) {
+                return a.module < b.module;
+              }
+              return a.channel < b.channel;
+            });
+  out.insert(out.end(), bucket.begin(), bucket.end());
+  fBuffered -= bucket.size();
+  bucket.clear();
+  fSpare.push_back(std::move(bucket));
+}
+
+size_t HitTimeBuckets::Release(double watermarkNs,
+                               std::vector<MinimalEventData> &out) {
+  // Buckets [.., end) are complete when end * width <= watermark
+  const int64_t end = BucketIndex(watermarkNs);
+  const size_t before = out.size();
+
+  while (!fBuckets.empty() && fBuckets.begin()->first < end) {
+    auto it = fBuckets.begin();
+    if (fHaveLastBucket && fLastBucket == it) {
+      fHaveLastBucket = false;
+    }
+    AppendSorted(it->second, out);
+    fBuckets.erase(it);
+  }
+  if (!fReleased || end > fHorizon) {
+    fHorizon = end;
+    fReleased = true;
+  }
+  return out.size() - before;
+}
+
+size_t HitTimeBuckets::ReleaseAll(std::vector<MinimalEventData> &out) {
+  const size_t before = out.size();
+  int64_t last = fHorizon;
+  for (auto &entry : fBuckets) {
+    AppendSorted(entry.second, out);
+    last = entry.first + 1;
+  }
+  fBuckets.clear();
+  fHaveLastBucket = false;
+  if (!fReleased || last > fHorizon) {
+    fHorizon = last;
+    fReleased = true;
+  }
+  return out.size() - before;
+}
+
+// === CoincidenceBuilder ===
+
+void CoincidenceBuilder::SetWindow(double preNs, double postNs) {
+  fPreNs = preNs;
+  fPostNs = postNs;
+}
+
+void CoincidenceBuilder::SetTriggerChannels(
+    const std::vector<std::pair<uint8_t, uint8_t>> &channels) {
+  fTriggers.reset();
+  for (const auto &[module, channel] : channels) {
+    fTriggers.set(Key(module, channel));
+  }
+  fAllTrigger = channels.empty();
+}
+
+uint32_t CoincidenceBuilder::Build(const std::vector<MinimalEventData> &hits,
+                                   std::vector<uint8_t> &payload) const {
+  uint32_t events = 0;
+  ForEachEvent(hits, [&](const MinimalEventData *first, uint32_t hitCount,
+                         uint32_t triggerIndex) {
+    Net::DataProcessor::AppendBuiltEvent(payload, first, hitCount,
+                                         triggerIndex);
+    events++;
+  });
+  return events;
+}
+
+size_t CoincidenceBuilder::FindCut(const std::vector<MinimalEventData> &hits,
+                                   double notBeforeNs, CutScan &scan) const {
+  for (size_t i = scan.position; i < hits.size(); ++i) {
+    if (!IsTrigger(hits[i])) {
+      continue;
+    }
+    const double t = hits[i].timeStampNs;
+    const double windowStart = t - fPreNs;
+    if (scan.haveTrigger && windowStart > scan.lastTrigger + fPostNs &&
+        windowStart >= notBeforeNs) {
+      // Everything the previous trigger's window covered lies before
+      // windowStart, so the cut goes right before this window
+      size_t cut = i;
+      while (cut > 0 && hits[cut - 1].timeStampNs >= windowStart) {
+        --cut;
+      }
+      scan.position = i - cut + 1;
+      scan.haveTrigger = true;
+      scan.lastTrigger = t;
+      return cut;
+    }
+    scan.haveTrigger = true;
+    scan.lastTrigger = t;
+  }
+  scan.position = hits.size();
+  return 0;
+}
+
+} // namespace DELILA
@@ -1,9 +1,17 @@
 #include "DigitizerSource.hpp"
+#include "MetricsExporter.hpp"
 #include <DataProcessor.hpp>
+#include <IDigitizer.hpp>
 #include <ZMQTransport.hpp>
 #include <delila/core/CommandResponse.hpp>
 #include <delila/core/ErrorCode.hpp>
+#include <delila/core/MinimalEventData.hpp>
 
+#ifdef HAS_CAEN_FELIB
+#include <DigitizerFactory.hpp>
+#endif
+
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 
@@ -25,8 +33,43 @@ bool DigitizerSource::Initialize(const std::string &config_path) {
   }
 
   // In mock mode, we don't need actual configuration
-  if (!fMockMode && !config_path.empty()) {
-    // TODO: Load configuration from file
+  if (!fMockMode) {
+    if (!fDigitizer && !config_path.empty()) {
+#ifdef HAS_CAEN_FELIB
+      Digitizer::ConfigurationManager digitizerConfig;
+      if (digitizerConfig.LoadFromFile(config_path) !=
+          Digitizer::ConfigurationManager::LoadResult::Success) {
+        fErrorMessage = "Failed to load digitizer configuration: " + config_path;
+        fState = ComponentState::Error;
+        return false;
+      }
+      try {
+        fDigitizer = Digitizer::DigitizerFactory::CreateDigitizer(digitizerConfig);
+      } catch (const std::exception &e) {
+        fErrorMessage = std::string("Failed to create digitizer: ") + e.what();
+        fState = ComponentState::Error;
+        return false;
+      }
+      if (fDigitizer && !fDigitizer->Initialize(digitizerConfig)) {
+        fDigitizer.reset();
+        fErrorMessage = "Failed to initialize digitizer";
+        fState = ComponentState::Error;
+        return false;
+      }
+#endif
+    }
+
+    if (!fDigitizer) {
+      fErrorMessage = "No digitizer available (enable mock mode or provide one)";
+      fState = ComponentState::Error;
+      return false;
+    }
+
+    if (!fDigitizer->Configure()) {
+      fErrorMessage = "Failed to configure digitizer";
+      fState = ComponentState::Error;
+      return false;
+    }
   }
 
   // Configure transport if we have output addresses
@@ -60,19 +103,23 @@ void DigitizerSource::Run() {
 void DigitizerSource::Shutdown() {
   fShutdownRequested = true;
   fRunning = false;
+  fAbort = true;
 
   // Stop command listener first
   StopCommandListener();
+  StopMetricsExporter();
 
   // Stop worker threads
-  if (fAcquisitionThread && fAcquisitionThread->joinable()) {
-    fAcquisitionThread->join();
-  }
-  if (fSendingThread && fSendingThread->joinable()) {
-    fSendingThread->join();
+  JoinWorkers();
+  ClearQueue();
+
+  if (fDigitizer && fState == ComponentState::Running) {
+    fDigitizer->StopAcquisition();
   }
 
   // Disconnect transport
+  fSpill.Close();
+  fRetransmit.Stop();
   if (fTransport) {
     fTransport->Disconnect();
   }
@@ -94,6 +141,16 @@ ComponentStatus DigitizerSource::GetStatus() const {
   status.run_number = fRunNumber.load();
   status.metrics.events_processed = fEventsProcessed.load();
   status.metrics.bytes_transferred = fBytesTransferred.load();
+  status.metrics.queue_size = static_cast<uint32_t>(GetQueueSize());
+  status.metrics.queue_max = static_cast<uint32_t>(fMaxQueueEvents);
+  uint64_t samples = fDrainLatencySamples.load();
+  if (samples > 0) {
+    status.metrics.drain_latency_us =
+        static_cast<double>(fDrainLatencyTotalUs.load()) / samples;
+  }
+  fLatency.Fill(status.metrics);
+  fRates.Fill(status.metrics.events_processed,
+              status.metrics.bytes_transferred, status.metrics);
   status.error_message = fErrorMessage;
   status.heartbeat_counter = fHeartbeatCounter.load();
   return status;
@@ -141,6 +198,85 @@ void DigitizerSource::SetMockEventRate(uint32_t events_per_second) {
   fMockEventRate = events_per_second;
 }
 
+void DigitizerSource::SetDigitizer(
+    std::unique_ptr<Digitizer::IDigitizer> digitizer) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Idle) {
+    fDigitizer = std::move(digitizer);
+  }
+}
+
+void DigitizerSource::SetDataMode(DigitizerSourceDataMode mode) {
+  fDataMode = mode;
+}
+
+DigitizerSourceDataMode DigitizerSource::GetDataMode() const {
+  return fDataMode;
+}
+
+void DigitizerSource::SetCompactWaveforms(bool enable) {
+  fCompactWaveforms = enable;
+}
+
+bool DigitizerSource::GetCompactWaveforms() const { return fCompactWaveforms; }
+
+void DigitizerSource::SetBatchSize(size_t events) {
+  fBatchSize = std::max<size_t>(1, events);
+}
+
+size_t DigitizerSource::GetBatchSize() const { return fBatchSize; }
+
+void DigitizerSource::SetBatchTimeoutMs(uint32_t ms) {
+  fBatchTimeoutMs = std::max<uint32_t>(1, ms);
+}
+
+uint32_t DigitizerSource::GetBatchTimeoutMs() const { return fBatchTimeoutMs; }
+
+void DigitizerSource::SetMaxQueueEvents(size_t events) {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  fMaxQueueEvents = std::max<size_t>(1, events);
+}
+
+size_t DigitizerSource::GetMaxQueueEvents() const {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  return fMaxQueueEvents;
+}
+
+void DigitizerSource::SetRetransmitAddress(const std::string &address) {
+  fRetransmitAddress = address;
+}
+
+std::string DigitizerSource::GetRetransmitAddress() const {
+  return fRetransmitAddress;
+}
+
+void DigitizerSource::SetReplayBufferSize(size_t frames) {
+  fReplayBufferSize = frames;
+}
+
+size_t DigitizerSource::GetReplayBufferSize() const {
+  return fReplayBufferSize;
+}
+
+void DigitizerSource::SetSpillDirectory(const std::string &directory) {
+  fSpillDirectory = directory;
+}
+
+std::string DigitizerSource::GetSpillDirectory() const {
+  return fSpillDirectory;
+}
+
+void DigitizerSource::SetSpillCapacity(uint64_t bytes) {
+  fSpillCapacity = bytes;
+}
+
+uint64_t DigitizerSource::GetSpillCapacity() const { return fSpillCapacity; }
+
+size_t DigitizerSource::GetQueueSize() const {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  return fQueuedEvents;
+}
+
 // === Testing utilities ===
 
 void DigitizerSource::ForceError(const std::string &message) {
@@ -171,6 +307,41 @@ bool DigitizerSource::OnArm() {
     }
   }
 
+  // Reliable delivery: the side channel stays bound until reset, so frames
+  // can still be recovered after the run has stopped
+  if (!fRetransmitAddress.empty() && !fRetransmit.IsRunning()) {
+    fRetransmit.SetCapacity(fReplayBufferSize,
+                            Net::ReplayBuffer::kDefaultMaxBytes);
+    if (!fRetransmit.Start(fRetransmitAddress, *fTransport)) {
+      fErrorMessage = "Failed to bind retransmit address";
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
+  if (!fSpillDirectory.empty() && !fSpill.IsOpen()) {
+    std::string error;
+    if (!fSpill.Open(
+            SpillBuffer::PathFor(fSpillDirectory, fComponentId), fSpillCapacity,
+            [this](std::unique_ptr<std::vector<uint8_t>> &data) {
+              return TransmitFrame(data);
+            },
+            [this](std::chrono::milliseconds timeout) {
+              return WaitForSendReady(timeout);
+            },
+            &error)) {
+      fErrorMessage = "Failed to open spill file: " + error;
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
+  if (!fMockMode && fDigitizer && !fDigitizer->ArmAcquisition()) {
+    fErrorMessage = "Failed to arm digitizer";
+    fState = ComponentState::Error;
+    return false;
+  }
+
   fState = ComponentState::Armed;
   return true;
 }
@@ -185,9 +356,33 @@ bool DigitizerSource::OnStart(uint32_t run_number) {
   fRunNumber = run_number;
   fEventsProcessed = 0;
   fBytesTransferred = 0;
+  fDrainLatencyTotalUs = 0;
+  fDrainLatencySamples = 0;
+  fLatency.Reset();
+  fRates.Reset();
+  fMockTimestampNs = 0.0;
+  ClearQueue();
+
+  // Sequence numbers restart with each run, as receivers of a retransmit
+  // side channel expect
+  fDataProcessor->ResetSequence();
+  fDataProcessor->EnableCompactWaveforms(fCompactWaveforms);
+  fRetransmit.Clear();
+  fSpill.Clear();
+
+  if (!fMockMode && fDigitizer && !fDigitizer->StartAcquisition()) {
+    fErrorMessage = "Failed to start digitizer";
+    fState = ComponentState::Error;
+    return false;
+  }
+
   fRunning = true;
+  fAbort = false;
+  fAcquisitionDone = false;
 
   // Start worker threads
+  fSendingThread =
+      std::make_unique<std::thread>(&DigitizerSource::SendingLoop, this);
   fAcquisitionThread =
       std::make_unique<std::thread>(&DigitizerSource::AcquisitionLoop, this);
 
@@ -205,30 +400,30 @@ bool DigitizerSource::OnStop(bool graceful) {
   fRunning = false;
 
   if (graceful) {
-    // Wait for threads to finish processing
-    if (fAcquisitionThread && fAcquisitionThread->joinable()) {
-      fAcquisitionThread->join();
-    }
-    if (fSendingThread && fSendingThread->joinable()) {
-      fSendingThread->join();
-    }
+    // Acquisition thread stops the digitizer and drains its buffer, then
+    // the sending thread flushes whatever is left in the queue
+    JoinWorkers();
+
+    // Frames held back in spill mode go first; EOS must follow them
+    fSpill.Flush();
 
     // Send EOS (End Of Stream) marker after all data has been sent
     if (fDataProcessor && fTransport && fTransport->IsConnected()) {
       auto eosMessage = fDataProcessor->CreateEOSMessage();
       if (eosMessage) {
-        fTransport->SendBytes(eosMessage);
+        SendFrame(eosMessage);
       }
     }
   } else {
-    // Detach threads for emergency stop - no EOS sent
-    if (fAcquisitionThread) {
-      fAcquisitionThread->detach();
-      fAcquisitionThread.reset();
-    }
-    if (fSendingThread) {
-      fSendingThread->detach();
-      fSendingThread.reset();
+    // Emergency stop - drop queued events, no EOS sent. Both loops wake
+    // within one batch timeout, so joining does not block for long.
+    fAbort = true;
+    fQueueNotEmpty.notify_all();
+    fQueueNotFull.notify_all();
+    JoinWorkers();
+    ClearQueue();
+    if (!fMockMode && fDigitizer) {
+      fDigitizer->StopAcquisition();
     }
   }
 
@@ -240,14 +435,16 @@ void DigitizerSource::OnReset() {
   std::lock_guard<std::mutex> lock(fStateMutex);
 
   // Stop everything
+  bool wasRunning = (fState == ComponentState::Running);
   fRunning = false;
+  fAbort = true;
   fShutdownRequested = false;
 
-  if (fAcquisitionThread && fAcquisitionThread->joinable()) {
-    fAcquisitionThread->join();
-  }
-  if (fSendingThread && fSendingThread->joinable()) {
-    fSendingThread->join();
+  JoinWorkers();
+  ClearQueue();
+
+  if (wasRunning && !fMockMode && fDigitizer) {
+    fDigitizer->StopAcquisition();
   }
 
   // Reset state
@@ -255,8 +452,12 @@ void DigitizerSource::OnReset() {
   fRunNumber = 0;
   fEventsProcessed = 0;
   fBytesTransferred = 0;
+  fDrainLatencyTotalUs = 0;
+  fDrainLatencySamples = 0;
 
   // Disconnect transport
+  fSpill.Close();
+  fRetransmit.Stop();
   if (fTransport) {
     fTransport->Disconnect();
   }
@@ -277,54 +478,279 @@ bool DigitizerSource::TransitionTo(ComponentState newState) {
 
 void DigitizerSource::AcquisitionLoop() {
   while (fRunning) {
+    std::unique_ptr<EventList> events;
     if (fMockMode) {
-      GenerateMockEvents();
-    } else {
-      // TODO: Read from actual digitizer
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      events = GenerateMockEvents();
+    } else if (fDigitizer) {
+      events = fDigitizer->GetEventData();
+    }
+
+    if (events && !events->empty()) {
+      if (!EnqueueEvents(std::move(events))) {
+        break;
+      }
+    } else if (!fMockMode) {
+      // Nothing in the digitizer buffer yet
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  if (!fMockMode && !fAbort) {
+    DrainDigitizer();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(fQueueMutex);
+    fAcquisitionDone = true;
+  }
+  fQueueNotEmpty.notify_all();
+}
+
+void DigitizerSource::DrainDigitizer() {
+  if (!fDigitizer) {
+    return;
+  }
+
+  fDigitizer->StopAcquisition();
+
+  // Events already read out by the digitizer are still delivered
+  while (!fAbort) {
+    auto events = fDigitizer->GetEventData();
+    if (!events || events->empty()) {
+      break;
+    }
+    if (!EnqueueEvents(std::move(events))) {
+      break;
     }
   }
 }
 
+bool DigitizerSource::EnqueueEvents(std::unique_ptr<EventList> events) {
+  std::unique_lock<std::mutex> lock(fQueueMutex);
+
+  // Block while full; the digitizer keeps buffering in the meantime
+  fQueueNotFull.wait(lock, [this] {
+    return fQueuedEvents < fMaxQueueEvents || fAbort;
+  });
+  if (fAbort) {
+    return false;
+  }
+
+  fQueuedEvents += events->size();
+  fEventQueue.push_back(QueuedBlock{std::move(events), 0, Clock::now()});
+  lock.unlock();
+
+  fQueueNotEmpty.notify_one();
+  return true;
+}
+
+size_t DigitizerSource::DequeueBatch(EventList &batch) {
+  const auto timeout = std::chrono::milliseconds(fBatchTimeoutMs);
+  const auto deadline = Clock::now() + timeout;
+
+  std::unique_lock<std::mutex> lock(fQueueMutex);
+
+  // Wait for a full batch, the batch timeout, or the end of acquisition
+  fQueueNotEmpty.wait_until(lock, deadline, [this] {
+    return fQueuedEvents >= fBatchSize || fAcquisitionDone || fAbort;
+  });
+  if (fAbort) {
+    return 0;
+  }
+
+  const auto now = Clock::now();
+  uint64_t latencyUs = 0;
+  uint64_t latencySamples = 0;
+  // Frame residency: the oldest block in the batch waited longest
+  fBatchEnqueued = fEventQueue.empty() ? now : fEventQueue.front().enqueued;
+
+  while (batch.size() < fBatchSize && !fEventQueue.empty()) {
+    auto &block = fEventQueue.front();
+    size_t available = block.events->size() - block.offset;
+    size_t take = std::min(available, fBatchSize - batch.size());
+
+    auto first = block.events->begin() + block.offset;
+    std::move(first, first + take, std::back_inserter(batch));
+    block.offset += take;
+    fQueuedEvents -= take;
+
+    latencyUs += take * static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::microseconds>(
+                                now - block.enqueued)
+                                .count());
+    latencySamples += take;
+
+    if (block.offset == block.events->size()) {
+      fEventQueue.pop_front();
+    }
+  }
+  lock.unlock();
+
+  if (latencySamples > 0) {
+    fDrainLatencyTotalUs += latencyUs;
+    fDrainLatencySamples += latencySamples;
+    fQueueNotFull.notify_all();
+  }
+
+  return batch.size();
+}
+
 void DigitizerSource::SendingLoop() {
-  // TODO: Implement queue-based sending
-  while (fRunning) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EventList batch;
+  batch.reserve(fBatchSize);
+
+  while (!fAbort) {
+    if (DequeueBatch(batch) > 0) {
+      SendBatch(batch);
+      batch.clear();
+      continue;
+    }
+
+    // Nothing new within the batch timeout: catch up on held-back frames
+    fSpill.Drain();
+
+    // Empty batch: finish once acquisition is done and the queue is drained
+    std::lock_guard<std::mutex> lock(fQueueMutex);
+    if (fAcquisitionDone && fEventQueue.empty()) {
+      break;
+    }
   }
 }
 
-void DigitizerSource::GenerateMockEvents() {
-  // Calculate sleep time based on event rate
-  auto sleepTime = std::chrono::microseconds(1000000 / fMockEventRate);
+void DigitizerSource::SendBatch(EventList &batch) {
+  if (!fTransport || !fTransport->IsConnected()) {
+    return;
+  }
 
-  // Create mock event
-  auto events =
-      std::make_unique<std::vector<std::unique_ptr<Digitizer::EventData>>>();
+  const bool timed = fLatency.Sample();
+  const uint64_t start = timed ? LatencyRecorder::Now() : 0;
+  if (timed) {
+    fLatency.RecordResidency(LatencyRecorder::ToNs(fBatchEnqueued), start);
+  }
 
-  auto event = std::make_unique<Digitizer::EventData>();
-  event->module = 0;
-  event->channel = 0;
-  event->timeStampNs = static_cast<double>(
-      std::chrono::duration_cast<std::chrono::nanoseconds>(
-          std::chrono::high_resolution_clock::now().time_since_epoch())
-          .count());
-  event->energy = static_cast<uint16_t>(1000 + (std::rand() % 1000));
-  event->energyShort = 0;
-  event->flags = 0;
-  events->push_back(std::move(event));
+  const size_t nEvents = batch.size();
+  std::unique_ptr<std::vector<uint8_t>> data;
+
+  if (fDataMode == DigitizerSourceDataMode::Minimal) {
+    auto minimal = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+    minimal->reserve(nEvents);
+    for (const auto &event : batch) {
+      minimal->push_back(std::make_unique<Digitizer::MinimalEventData>(
+          event->module, event->channel, event->timeStampNs, event->energy,
+          event->energyShort, event->flags));
+    }
+    data = fDataProcessor->ProcessWithAutoSequence(minimal);
+  } else {
+    // Process() takes the owning container; hand the batch over and back
+    auto events = std::make_unique<EventList>(std::move(batch));
+    data = fDataProcessor->ProcessWithAutoSequence(events);
+    batch = std::move(*events);
+  }
 
-  // Serialize and send
-  auto data = fDataProcessor->ProcessWithAutoSequence(events);
-  if (data && fTransport && fTransport->IsConnected()) {
+  if (data) {
     // Store size before SendBytes (which resets the unique_ptr)
     size_t dataSize = data->size();
-    if (fTransport->SendBytes(data)) {
-      fEventsProcessed++;
+    if (SendFrame(data)) {
+      fRates.CountEvents(batch);
+      fEventsProcessed += nEvents;
       fBytesTransferred += dataSize;
     }
+
+    if (timed) {
+      const uint64_t end = LatencyRecorder::Now();
+      fLatency.RecordProcessing(start, end);
+      // Process() stamps the header with the send time; the frame's age
+      // here is the time since its oldest events were read out
+      fLatency.RecordAgeSince(LatencyRecorder::ToNs(fBatchEnqueued), end);
+    }
+  }
+}
+
+bool DigitizerSource::SendFrame(std::unique_ptr<std::vector<uint8_t>> &data) {
+  if (fSpill.IsOpen()) {
+    return fSpill.Send(data);
+  }
+  return TransmitFrame(data);
+}
+
+bool DigitizerSource::TransmitFrame(
+    std::unique_ptr<std::vector<uint8_t>> &data) {
+  if (fRetransmit.IsRunning()) {
+    return fRetransmit.Send(data);
+  }
+  return fTransport->SendBytes(data);
+}
+
+bool DigitizerSource::WaitForSendReady(std::chrono::milliseconds timeout) {
+  if (fRetransmit.IsRunning()) {
+    return fRetransmit.WaitForSendReady(timeout);
+  }
+  return fTransport->WaitForSendReady(timeout);
+}
+
+std::unique_ptr<DigitizerSource::EventList>
+DigitizerSource::GenerateMockEvents() {
+  // Produce events in ~10 ms slices so high rates do not need one wakeup
+  // per event
+  const uint32_t rate = std::max<uint32_t>(1, fMockEventRate);
+  const double intervalNs = 1e9 / static_cast<double>(rate);
+  const size_t nEvents = std::max<size_t>(1, rate / 100);
+  const auto sliceEnd =
+      Clock::now() + std::chrono::nanoseconds(
+                         static_cast<int64_t>(intervalNs * nEvents));
+
+  std::uniform_int_distribution<int> channelDist(0, 15);
+  std::uniform_int_distribution<int> energyDist(1000, 1999);
+
+  auto events = std::make_unique<EventList>();
+  events->reserve(nEvents);
+  for (size_t i = 0; i < nEvents; ++i) {
+    fMockTimestampNs += intervalNs;
+
+    auto event = std::make_unique<Digitizer::EventData>();
+    event->module = 0;
+    event->channel = static_cast<uint8_t>(channelDist(fMockRng));
+    event->timeStampNs = fMockTimestampNs;
+    event->energy = static_cast<uint16_t>(energyDist(fMockRng));
+    event->energyShort = 0;
+    event->flags = 0;
+    events->push_back(std::move(event));
+  }
+
+  // Pace to the requested rate, staying responsive to Stop
+  while (fRunning && Clock::now() < sliceEnd) {
+    std::this_thread::sleep_for(std::min<Clock::duration>(
+        sliceEnd - Clock::now(), std::chrono::milliseconds(10)));
   }
 
-  std::this_thread::sleep_for(sleepTime);
+  return events;
+}
+
+void DigitizerSource::JoinWorkers() {
+  if (fAcquisitionThread && fAcquisitionThread->joinable()) {
+    fAcquisitionThread->join();
+  }
+  fAcquisitionThread.reset();
+
+  // Sending thread exits after acquisition is done and the queue is empty
+  {
+    std::lock_guard<std::mutex> lock(fQueueMutex);
+    fAcquisitionDone = true;
+  }
+  fQueueNotEmpty.notify_all();
+
+  if (fSendingThread && fSendingThread->joinable()) {
+    fSendingThread->join();
+  }
+  fSendingThread.reset();
+}
+
+void DigitizerSource::ClearQueue() {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  fEventQueue.clear();
+  fQueuedEvents = 0;
+  fQueueNotFull.notify_all();
 }
 
 // === Command channel ===
@@ -375,6 +801,63 @@ void DigitizerSource::StopCommandListener() {
   }
 }
 
+// === Metrics endpoint ===
+
+void DigitizerSource::SetMetricsAddress(const std::string &address) {
+  fMetrics.SetAddress(address);
+}
+
+std::string DigitizerSource::GetMetricsAddress() const {
+  return fMetrics.GetAddress();
+}
+
+bool DigitizerSource::StartMetricsExporter() {
+  MetricsExporter *exporter = fMetrics.Prepare(*this);
+  if (!exporter) {
+    return false;
+  }
+  exporter->AddCounter("frames_encoded", "Data frames serialized",
+                       [this] { return fDataProcessor->GetCurrentSequence(); });
+  if (!fRetransmitAddress.empty()) {
+    exporter->AddCounter("retransmit_requests",
+                         "Retransmission requests received",
+                         [this] { return fRetransmit.GetRequestsReceived(); });
+    exporter->AddCounter("frames_retransmitted", "Data frames sent again",
+                         [this] { return fRetransmit.GetFramesRetransmitted(); });
+    exporter->AddCounter("frames_unavailable",
+                         "Requested frames no longer in the replay buffer",
+                         [this] { return fRetransmit.GetFramesUnavailable(); });
+    exporter->AddGauge("replay_buffer_frames", "Frames kept for retransmission",
+                       [this] {
+                         return static_cast<double>(
+                             fRetransmit.GetBufferedFrames());
+                       });
+  }
+  if (!fSpillDirectory.empty()) {
+    exporter->AddCounter("frames_spilled",
+                         "Data frames written to the spill file",
+                         [this] { return fSpill.GetFramesSpilled(); });
+    exporter->AddCounter("frames_restored",
+                         "Data frames read back from the spill file",
+                         [this] { return fSpill.GetFramesRestored(); });
+    exporter->AddCounter("frames_dropped",
+                         "Data frames dropped with the spill file full",
+                         [this] { return fSpill.GetFramesDropped(); });
+    exporter->AddGauge("spill_frames", "Frames waiting in the spill file",
+                       [this] {
+                         return static_cast<double>(fSpill.GetSpilledFrames());
+                       });
+    exporter->AddGauge("spill_occupancy_ratio",
+                       "Fraction of the spill file in use",
+                       [this] { return fSpill.GetOccupancy(); });
+  }
+  return fMetrics.Start();
+}
+
+void DigitizerSource::StopMetricsExporter() {
+  fMetrics.Stop();
+}
+
 void DigitizerSource::CommandListenerLoop() {
   while (fCommandListenerRunning) {
     auto cmd = fCommandTransport->ReceiveCommand();
@@ -4,6 +4,7 @@
  */
 
 #include "Emulator.hpp"
+#include "MetricsExporter.hpp"
 
 #include <DataProcessor.hpp>
 #include <ZMQTransport.hpp>
@@ -12,6 +13,7 @@
 #include <delila/core/EventData.hpp>
 #include <delila/core/MinimalEventData.hpp>
 
+#include <algorithm>
 #include <chrono>
 
 namespace DELILA {
@@ -78,6 +80,7 @@ void Emulator::Shutdown() {
 
   // Stop command listener first
   StopCommandListener();
+  StopMetricsExporter();
 
   // Stop generation thread
   if (fGenerationThread && fGenerationThread->joinable()) {
@@ -86,6 +89,8 @@ void Emulator::Shutdown() {
   fGenerationThread.reset();
 
   // Disconnect transport
+  fSpill.Close();
+  fRetransmit.Stop();
   if (fTransport) {
     fTransport->Disconnect();
   }
@@ -107,6 +112,8 @@ ComponentStatus Emulator::GetStatus() const {
   status.run_number = fRunNumber.load();
   status.metrics.events_processed = fEventsProcessed.load();
   status.metrics.bytes_transferred = fBytesTransferred.load();
+  fRates.Fill(status.metrics.events_processed,
+              status.metrics.bytes_transferred, status.metrics);
   status.error_message = fErrorMessage;
   status.heartbeat_counter = fHeartbeatCounter.load();
   return status;
@@ -176,6 +183,63 @@ void Emulator::StopCommandListener() {
   }
 }
 
+// === Metrics endpoint ===
+
+void Emulator::SetMetricsAddress(const std::string& address) {
+  fMetrics.SetAddress(address);
+}
+
+std::string Emulator::GetMetricsAddress() const {
+  return fMetrics.GetAddress();
+}
+
+bool Emulator::StartMetricsExporter() {
+  MetricsExporter* exporter = fMetrics.Prepare(*this);
+  if (!exporter) {
+    return false;
+  }
+  exporter->AddCounter("frames_encoded", "Data frames serialized",
+                       [this] { return fDataProcessor->GetCurrentSequence(); });
+  if (!fRetransmitAddress.empty()) {
+    exporter->AddCounter("retransmit_requests",
+                         "Retransmission requests received",
+                         [this] { return fRetransmit.GetRequestsReceived(); });
+    exporter->AddCounter("frames_retransmitted", "Data frames sent again",
+                         [this] { return fRetransmit.GetFramesRetransmitted(); });
+    exporter->AddCounter("frames_unavailable",
+                         "Requested frames no longer in the replay buffer",
+                         [this] { return fRetransmit.GetFramesUnavailable(); });
+    exporter->AddGauge("replay_buffer_frames", "Frames kept for retransmission",
+                       [this] {
+                         return static_cast<double>(
+                             fRetransmit.GetBufferedFrames());
+                       });
+  }
+  if (!fSpillDirectory.empty()) {
+    exporter->AddCounter("frames_spilled",
+                         "Data frames written to the spill file",
+                         [this] { return fSpill.GetFramesSpilled(); });
+    exporter->AddCounter("frames_restored",
+                         "Data frames read back from the spill file",
+                         [this] { return fSpill.GetFramesRestored(); });
+    exporter->AddCounter("frames_dropped",
+                         "Data frames dropped with the spill file full",
+                         [this] { return fSpill.GetFramesDropped(); });
+    exporter->AddGauge("spill_frames", "Frames waiting in the spill file",
+                       [this] {
+                         return static_cast<double>(fSpill.GetSpilledFrames());
+                       });
+    exporter->AddGauge("spill_occupancy_ratio",
+                       "Fraction of the spill file in use",
+                       [this] { return fSpill.GetOccupancy(); });
+  }
+  return fMetrics.Start();
+}
+
+void Emulator::StopMetricsExporter() {
+  fMetrics.Stop();
+}
+
 // === Public control methods ===
 
 bool Emulator::Arm() { return OnArm(); }
@@ -219,6 +283,38 @@ void Emulator::SetWaveformSize(size_t size) { fWaveformSize = size; }
 
 size_t Emulator::GetWaveformSize() const { return fWaveformSize; }
 
+void Emulator::SetCompactWaveforms(bool enable) { fCompactWaveforms = enable; }
+
+bool Emulator::GetCompactWaveforms() const { return fCompactWaveforms; }
+
+void Emulator::SetBatchSize(size_t size) { fBatchSize = size; }
+
+size_t Emulator::GetBatchSize() const { return fBatchSize; }
+
+void Emulator::SetRetransmitAddress(const std::string& address) {
+  fRetransmitAddress = address;
+}
+
+std::string Emulator::GetRetransmitAddress() const {
+  return fRetransmitAddress;
+}
+
+void Emulator::SetReplayBufferSize(size_t frames) {
+  fReplayBufferSize = frames;
+}
+
+size_t Emulator::GetReplayBufferSize() const { return fReplayBufferSize; }
+
+void Emulator::SetSpillDirectory(const std::string& directory) {
+  fSpillDirectory = directory;
+}
+
+std::string Emulator::GetSpillDirectory() const { return fSpillDirectory; }
+
+void Emulator::SetSpillCapacity(uint64_t bytes) { fSpillCapacity = bytes; }
+
+uint64_t Emulator::GetSpillCapacity() const { return fSpillCapacity; }
+
 void Emulator::SetSeed(uint64_t seed) {
   fSeed = seed;
   fSeedSet = true;
@@ -254,6 +350,35 @@ bool Emulator::OnArm() {
     }
   }
 
+  // Reliable delivery: the side channel stays bound until reset, so frames
+  // can still be recovered after the run has stopped
+  if (!fRetransmitAddress.empty() && !fRetransmit.IsRunning()) {
+    fRetransmit.SetCapacity(fReplayBufferSize,
+                            Net::ReplayBuffer::kDefaultMaxBytes);
+    if (!fRetransmit.Start(fRetransmitAddress, *fTransport)) {
+      fErrorMessage = "Failed to bind retransmit address";
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
+  if (!fSpillDirectory.empty() && !fSpill.IsOpen()) {
+    std::string error;
+    if (!fSpill.Open(
+            SpillBuffer::PathFor(fSpillDirectory, fComponentId), fSpillCapacity,
+            [this](std::unique_ptr<std::vector<uint8_t>>& data) {
+              return TransmitFrame(data);
+            },
+            [this](std::chrono::milliseconds timeout) {
+              return WaitForSendReady(timeout);
+            },
+            &error)) {
+      fErrorMessage = "Failed to open spill file: " + error;
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
   fState = ComponentState::Armed;
   return true;
 }
@@ -268,11 +393,15 @@ bool Emulator::OnStart(uint32_t run_number) {
   fRunNumber = run_number;
   fEventsProcessed = 0;
   fBytesTransferred = 0;
+  fRates.Reset();
   fCurrentTimestampNs = 0.0;
   fRunning = true;
 
   // Reset sequence number in data processor
   fDataProcessor->ResetSequence();
+  fDataProcessor->EnableCompactWaveforms(fCompactWaveforms);
+  fRetransmit.Clear();
+  fSpill.Clear();
 
   // Start generation thread
   fGenerationThread =
@@ -297,11 +426,14 @@ bool Emulator::OnStop(bool graceful) {
       fGenerationThread->join();
     }
 
+    // Frames held back in spill mode go first; EOS must follow them
+    fSpill.Flush();
+
     // Send EOS marker
     if (fDataProcessor && fTransport && fTransport->IsConnected()) {
       auto eosMessage = fDataProcessor->CreateEOSMessage();
       if (eosMessage) {
-        fTransport->SendBytes(eosMessage);
+        SendFrame(eosMessage);
       }
     }
   } else {
@@ -336,6 +468,8 @@ void Emulator::OnReset() {
   fCurrentTimestampNs = 0.0;
 
   // Disconnect transport
+  fSpill.Close();
+  fRetransmit.Stop();
   if (fTransport) {
     fTransport->Disconnect();
   }
@@ -357,6 +491,7 @@ bool Emulator::TransitionTo(ComponentState newState) {
 void Emulator::GenerationLoop() {
   // Calculate interval between events in nanoseconds
   const double intervalNs = 1e9 / static_cast<double>(fEventRate);
+  const size_t batchSize = std::max<size_t>(fBatchSize, 1);
 
   // Distribution for channel and energy
   std::uniform_int_distribution<uint8_t> channelDist(0, fNumChannels - 1);
@@ -365,31 +500,42 @@ void Emulator::GenerationLoop() {
   // Small jitter for timestamp (±10%)
   std::uniform_real_distribution<double> jitterDist(0.9, 1.1);
 
-  while (fRunning) {
-    // Generate timestamp with jitter
-    fCurrentTimestampNs += intervalNs * jitterDist(fRng);
+  // Frames are paced against a deadline so sleep overshoot does not lower
+  // the rate; after a long stall the deadline restarts instead of bursting
+  using Clock = std::chrono::steady_clock;
+  const auto framePeriod = std::chrono::nanoseconds(
+      static_cast<int64_t>(intervalNs * static_cast<double>(batchSize)));
+  auto deadline = Clock::now();
 
+  while (fRunning) {
     if (fDataMode == EmulatorDataMode::Minimal) {
       // Generate MinimalEventData
       auto events =
           std::make_unique<std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+      events->reserve(batchSize);
+
+      for (size_t n = 0; n < batchSize; ++n) {
+        // Generate timestamp with jitter
+        fCurrentTimestampNs += intervalNs * jitterDist(fRng);
 
-      auto event = std::make_unique<Digitizer::MinimalEventData>();
-      event->module = fModuleNumber;
-      event->channel = channelDist(fRng);
-      event->timeStampNs = fCurrentTimestampNs;
-      event->energy = energyDist(fRng);
-      event->energyShort = static_cast<uint16_t>(event->energy * 0.8);
-      event->flags = 0;
+        auto event = std::make_unique<Digitizer::MinimalEventData>();
+        event->module = fModuleNumber;
+        event->channel = channelDist(fRng);
+        event->timeStampNs = fCurrentTimestampNs;
+        event->energy = energyDist(fRng);
+        event->energyShort = static_cast<uint16_t>(event->energy * 0.8);
+        event->flags = 0;
 
-      events->push_back(std::move(event));
+        events->push_back(std::move(event));
+      }
 
       // Serialize and send
       auto data = fDataProcessor->ProcessWithAutoSequence(events);
       if (data && fTransport && fTransport->IsConnected()) {
         size_t dataSize = data->size();
-        if (fTransport->SendBytes(data)) {
-          fEventsProcessed++;
+        if (SendFrame(data)) {
+          fRates.CountEvents(*events);
+          fEventsProcessed += events->size();
           fBytesTransferred += dataSize;
         }
       }
@@ -397,48 +543,79 @@ void Emulator::GenerationLoop() {
       // Generate full EventData
       auto events =
           std::make_unique<std::vector<std::unique_ptr<Digitizer::EventData>>>();
-
-      auto event = std::make_unique<Digitizer::EventData>(fWaveformSize);
-      event->module = fModuleNumber;
-      event->channel = channelDist(fRng);
-      event->timeStampNs = fCurrentTimestampNs;
-      event->energy = energyDist(fRng);
-      event->energyShort = static_cast<uint16_t>(event->energy * 0.8);
-      event->flags = 0;
-
-      // Generate waveform if enabled
-      if (fWaveformSize > 0) {
-        std::uniform_int_distribution<int32_t> waveformDist(0, 4095);
-        std::uniform_int_distribution<uint8_t> digitalDist(0, 1);
-
-        for (size_t i = 0; i < fWaveformSize; ++i) {
-          event->analogProbe1[i] = waveformDist(fRng);
-          event->analogProbe2[i] = waveformDist(fRng);
-          event->digitalProbe1[i] = digitalDist(fRng);
-          event->digitalProbe2[i] = digitalDist(fRng);
-          event->digitalProbe3[i] = digitalDist(fRng);
-          event->digitalProbe4[i] = digitalDist(fRng);
+      events->reserve(batchSize);
+
+      for (size_t n = 0; n < batchSize; ++n) {
+        // Generate timestamp with jitter
+        fCurrentTimestampNs += intervalNs * jitterDist(fRng);
+
+        auto event = std::make_unique<Digitizer::EventData>(fWaveformSize);
+        event->module = fModuleNumber;
+        event->channel = channelDist(fRng);
+        event->timeStampNs = fCurrentTimestampNs;
+        event->energy = energyDist(fRng);
+        event->energyShort = static_cast<uint16_t>(event->energy * 0.8);
+        event->flags = 0;
+
+        // Generate waveform if enabled
+        if (fWaveformSize > 0) {
+          std::uniform_int_distribution<int32_t> waveformDist(0, 4095);
+          std::uniform_int_distribution<uint8_t> digitalDist(0, 1);
+
+          for (size_t i = 0; i < fWaveformSize; ++i) {
+            event->analogProbe1[i] = waveformDist(fRng);
+            event->analogProbe2[i] = waveformDist(fRng);
+            event->digitalProbe1[i] = digitalDist(fRng);
+            event->digitalProbe2[i] = digitalDist(fRng);
+            event->digitalProbe3[i] = digitalDist(fRng);
+            event->digitalProbe4[i] = digitalDist(fRng);
+          }
         }
-      }
 
-      events->push_back(std::move(event));
+        events->push_back(std::move(event));
+      }
 
       // Serialize and send
       auto data = fDataProcessor->ProcessWithAutoSequence(events);
       if (data && fTransport && fTransport->IsConnected()) {
         size_t dataSize = data->size();
-        if (fTransport->SendBytes(data)) {
-          fEventsProcessed++;
+        if (SendFrame(data)) {
+          fRates.CountEvents(*events);
+          fEventsProcessed += events->size();
           fBytesTransferred += dataSize;
         }
       }
     }
 
     // Sleep to maintain event rate
-    auto sleepTime = std::chrono::microseconds(
-        static_cast<int64_t>(intervalNs / 1000.0));
-    std::this_thread::sleep_for(sleepTime);
+    deadline += framePeriod;
+    auto now = Clock::now();
+    if (deadline < now - std::chrono::milliseconds(100)) {
+      deadline = now;
+    }
+    std::this_thread::sleep_until(deadline);
+  }
+}
+
+bool Emulator::SendFrame(std::unique_ptr<std::vector<uint8_t>>& data) {
+  if (fSpill.IsOpen()) {
+    return fSpill.Send(data);
+  }
+  return TransmitFrame(data);
+}
+
+bool Emulator::TransmitFrame(std::unique_ptr<std::vector<uint8_t>>& data) {
+  if (fRetransmit.IsRunning()) {
+    return fRetransmit.Send(data);
+  }
+  return fTransport->SendBytes(data);
+}
+
+bool Emulator::WaitForSendReady(std::chrono::milliseconds timeout) {
+  if (fRetransmit.IsRunning()) {
+    return fRetransmit.WaitForSendReady(timeout);
   }
+  return fTransport->WaitForSendReady(timeout);
 }
 
 void Emulator::CommandListenerLoop() {
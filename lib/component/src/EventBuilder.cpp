@@ -0,0 +1,587 @@
+#include "EventBuilder.hpp"
+
+#include <DataProcessor.hpp>
+#include <EOSTracker.hpp>
+#include <ZMQTransport.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+namespace DELILA {
+
+EventBuilder::EventBuilder()
+    : StageComponent(kAnyCount, 1),
+      fDataProcessor(std::make_unique<Net::DataProcessor>()),
+      fEOSTracker(std::make_unique<Net::EOSTracker>()) {}
+
+EventBuilder::~EventBuilder() { Shutdown(); }
+
+// === Configuration ===
+
+void EventBuilder::SetCoincidenceWindow(double preNs, double postNs) {
+  fPreWindowNs = std::max(0.0, preNs);
+  fPostWindowNs = std::max(0.0, postNs);
+}
+
+double EventBuilder::GetPreWindowNs() const { return fPreWindowNs; }
+
+double EventBuilder::GetPostWindowNs() const { return fPostWindowNs; }
+
+void EventBuilder::SetTriggerChannels(
+    const std::vector<std::pair<uint8_t, uint8_t>> &channels) {
+  fTriggerChannels = channels;
+}
+
+std::vector<std::pair<uint8_t, uint8_t>>
+EventBuilder::GetTriggerChannels() const {
+  return fTriggerChannels;
+}
+
+void EventBuilder::SetMinHits(uint32_t hits) {
+  fMinHits = std::max<uint32_t>(1, hits);
+}
+
+uint32_t EventBuilder::GetMinHits() const { return fMinHits; }
+
+void EventBuilder::SetWorkerThreads(uint32_t count) {
+  fWorkerThreads = std::max<uint32_t>(1, count);
+}
+
+uint32_t EventBuilder::GetWorkerThreads() const { return fWorkerThreads; }
+
+void EventBuilder::SetSliceNs(double ns) { fSliceNs = std::max(0.0, ns); }
+
+double EventBuilder::GetSliceNs() const { return fSliceNs; }
+
+void EventBuilder::SetReorderWindowNs(double ns) {
+  fReorderWindowNs = std::max(0.0, ns);
+}
+
+double EventBuilder::GetReorderWindowNs() const { return fReorderWindowNs; }
+
+size_t EventBuilder::GetQueueSize() const {
+  std::lock_guard<std::mutex> lock(fHitQueueMutex);
+  return fHitQueue.size();
+}
+
+// === StageComponent hooks ===
+
+void EventBuilder::ResetCounters() {
+  fHitsReceived = 0;
+  fLateHits = 0;
+  fForcedCuts = 0;
+  fEOSReceivedCount = 0;
+  fEOSTracker->Reset();
+}
+
+void EventBuilder::StartThreads() {
+  // Settings are copied so workers read them without locking
+  fBuilder.SetWindow(fPreWindowNs, fPostWindowNs);
+  fBuilder.SetTriggerChannels(fTriggerChannels);
+  fBuilder.SetMinHits(fMinHits);
+
+  // Clear any leftovers of the previous run
+  {
+    std::lock_guard<std::mutex> queueLock(fHitQueueMutex);
+    fHitQueue.clear();
+  }
+  {
+    std::lock_guard<std::mutex> sliceLock(fSliceMutex);
+    fJobQueue.clear();
+    fSliceQueue.clear();
+    fSortDone = false;
+  }
+
+  // Register the sources with the EOS tracker
+  for (size_t i = 0; i < fInputTransports.size(); ++i) {
+    fEOSTracker->RegisterSource("input_" + std::to_string(i));
+  }
+  fAllEOS = false;
+  fReceiveDone = false;
+  fAbort = false;
+  fRunning = true;
+
+  // Downstream stages first, so nothing waits on a missing consumer
+  fSendingThread =
+      std::make_unique<std::thread>(&EventBuilder::SendingLoop, this);
+  fBuildThreads.clear();
+  for (uint32_t i = 0; i < fWorkerThreads; ++i) {
+    fBuildThreads.push_back(
+        std::make_unique<std::thread>(&EventBuilder::BuildWorker, this));
+  }
+  fSortingThread =
+      std::make_unique<std::thread>(&EventBuilder::SortingLoop, this);
+
+  // Start receiving threads (one per input)
+  fReceivingThreads.clear();
+  for (size_t i = 0; i < fInputTransports.size(); ++i) {
+    fReceivingThreads.push_back(
+        std::make_unique<std::thread>(&EventBuilder::ReceivingLoop, this, i));
+  }
+}
+
+void EventBuilder::StopThreads(bool graceful) {
+  // Graceful: stop receiving, then let every stage drain into the output.
+  // Otherwise every stage exits as soon as it wakes up.
+  fRunning = false;
+  if (!graceful) {
+    fAbort = true;
+  }
+  auto wakeAll = [this] {
+    {
+      std::lock_guard<std::mutex> lock(fHitQueueMutex);
+    }
+    fHitQueueNotEmpty.notify_all();
+    fHitQueueNotFull.notify_all();
+    {
+      std::lock_guard<std::mutex> lock(fSliceMutex);
+    }
+    fJobAvailable.notify_all();
+    fSliceAvailable.notify_all();
+    fSliceSpace.notify_all();
+  };
+  wakeAll();
+
+  for (auto &thread : fReceivingThreads) {
+    if (thread && thread->joinable()) {
+      thread->join();
+    }
+  }
+  fReceivingThreads.clear();
+
+  // Nothing more enters the queue; the sorter flushes what is buffered
+  fReceiveDone = true;
+  wakeAll();
+  if (fSortingThread && fSortingThread->joinable()) {
+    fSortingThread->join();
+  }
+  fSortingThread.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(fSliceMutex);
+    fSortDone = true;
+  }
+  wakeAll();
+  for (auto &thread : fBuildThreads) {
+    if (thread && thread->joinable()) {
+      thread->join();
+    }
+  }
+  fBuildThreads.clear();
+  if (fSendingThread && fSendingThread->joinable()) {
+    fSendingThread->join();
+  }
+  fSendingThread.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(fHitQueueMutex);
+    fHitQueue.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(fSliceMutex);
+    fJobQueue.clear();
+    fSliceQueue.clear();
+  }
+}
+
+bool EventBuilder::DecodeHits(std::unique_ptr<std::vector<uint8_t>> &data,
+                              Net::DataProcessor &processor,
+                              std::vector<MinimalEventData> &hits) {
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(*data, header)) {
+    return false;
+  }
+
+  switch (header.format_version) {
+  case Net::FORMAT_VERSION_MINIMAL_EVENTDATA: {
+    auto [events, sequence] = processor.DecodeMinimal(data);
+    if (!events) {
+      return false;
+    }
+    hits.reserve(events->size());
+    for (const auto &event : *events) {
+      if (event) {
+        hits.push_back(*event);
+      }
+    }
+    return true;
+  }
+  case Net::FORMAT_VERSION_EVENTDATA:
+  case Net::FORMAT_VERSION_COMPACT_EVENTDATA: {
+    auto [events, sequence] = processor.Decode(data);
+    if (!events) {
+      return false;
+    }
+    hits.reserve(events->size());
+    for (const auto &event : *events) {
+      if (event) {
+        hits.emplace_back(event->module, event->channel, event->timeStampNs,
+                          event->energy, event->energyShort, event->flags);
+      }
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+void EventBuilder::ReceivingLoop(size_t input_index) {
+  if (input_index >= fInputTransports.size()) {
+    return;
+  }
+
+  auto &transport = fInputTransports[input_index];
+  Net::DataProcessor processor;  // Decoding is per thread
+  uint64_t frames = 0;           // Latency sampling counter for this input
+
+  while (fRunning) {
+    // Check if transport is valid
+    if (!transport || !transport->IsConnected()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+
+    // Receive data from transport
+    auto data = transport->ReceiveBytes();
+
+    // Check fRunning again after potentially blocking receive
+    if (!fRunning) {
+      break;
+    }
+
+    if (!data || data->empty()) {
+      // No data available, sleep briefly
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    // Check for EOS marker
+    if (Net::DataProcessor::IsEOSMessage(data->data(), data->size())) {
+      fEOSTracker->ReceiveEOS("input_" + std::to_string(input_index));
+      fEOSReceivedCount++;
+
+      // This input's hits are queued already; once every input has sent
+      // EOS the sorter can flush everything
+      if (fEOSTracker->AllReceived()) {
+        {
+          std::lock_guard<std::mutex> lock(fHitQueueMutex);
+          fAllEOS = true;
+        }
+        fHitQueueNotEmpty.notify_all();
+      }
+      continue;
+    }
+
+    fBytesTransferred += data->size();
+    fHeartbeatCounter++;
+
+    HitBatch batch;
+    if (!DecodeHits(data, processor, batch.hits)) {
+      std::cerr << "EventBuilder: Failed to decode frame from input "
+                << input_index << std::endl;
+      continue;
+    }
+    if (batch.hits.empty()) {
+      continue;
+    }
+    fHitsReceived += batch.hits.size();
+
+    // Only frames chosen for latency timing carry a receive stamp
+    bool timed = (frames++ & fLatency.GetSampleMask()) == 0;
+    batch.received_ns = timed ? LatencyRecorder::Now() : 0;
+    batch.input = input_index;
+
+    // Block rather than drop: a lost batch would corrupt coincidences
+    {
+      std::unique_lock<std::mutex> lock(fHitQueueMutex);
+      fHitQueueNotFull.wait(lock, [this] {
+        return fHitQueue.size() < kMaxQueueSize || !fRunning || fAbort;
+      });
+      if (fAbort) {
+        break;
+      }
+      fHitQueue.push_back(std::move(batch));
+    }
+    fHitQueueNotEmpty.notify_one();
+  }
+}
+
+void EventBuilder::SortingLoop() {
+  HitTimeBuckets buckets(kBucketNs);
+  std::vector<MinimalEventData> slice;  // Time-ordered, not yet dispatched
+  CoincidenceBuilder::CutScan scan;
+  uint64_t sliceOldest = 0;
+
+  // Per-module progress: newest hit time and when it was last heard from
+  std::array<double, 256> newest{};
+  std::array<uint64_t, 256> lastSeen{};
+  std::vector<uint8_t> modules;  // Modules seen in this run
+
+  // Modules of an input that has not started yet are unknown; wait for
+  // every input before releasing anything
+  std::vector<bool> inputSeen(fInputTransports.size(), false);
+  size_t inputsWaiting = inputSeen.size();
+  const uint64_t startNs = LatencyRecorder::Now();
+
+  auto dispatchAll = [&] {
+    if (!slice.empty()) {
+      DispatchSlice(std::move(slice), sliceOldest);
+      slice.clear();
+    }
+    scan = CoincidenceBuilder::CutScan{};
+    sliceOldest = 0;
+  };
+
+  while (true) {
+    HitBatch batch;
+    bool haveBatch = false;
+    bool finished = false;
+    {
+      std::unique_lock<std::mutex> lock(fHitQueueMutex);
+      // Time out now and then so idle modules are noticed
+      fHitQueueNotEmpty.wait_for(lock, std::chrono::milliseconds(100), [this] {
+        return !fHitQueue.empty() || fAllEOS || fReceiveDone || fAbort;
+      });
+      if (fAbort) {
+        return;
+      }
+      if (!fHitQueue.empty()) {
+        batch = std::move(fHitQueue.front());
+        fHitQueue.pop_front();
+        haveBatch = true;
+      } else if (fAllEOS || fReceiveDone) {
+        finished = true;
+      }
+    }
+
+    if (finished) {
+      break;
+    }
+
+    const uint64_t now = LatencyRecorder::Now();
+    if (haveBatch) {
+      fHitQueueNotFull.notify_one();
+      if (batch.input < inputSeen.size() && !inputSeen[batch.input]) {
+        inputSeen[batch.input] = true;
+        inputsWaiting--;
+      }
+      for (const auto &hit : batch.hits) {
+        if (lastSeen[hit.module] == 0) {
+          modules.push_back(hit.module);
+          newest[hit.module] = hit.timeStampNs;
+        }
+        newest[hit.module] = std::max(newest[hit.module], hit.timeStampNs);
+        lastSeen[hit.module] = now;
+        fRates.CountEvent(hit.module, hit.channel);
+        buckets.Add(hit);
+      }
+      if (sliceOldest == 0) {
+        sliceOldest = batch.received_ns;
+      }
+    }
+
+    // Everything before the slowest active module's progress is complete
+    double watermark = std::numeric_limits<double>::infinity();
+    bool anyActive = false;
+    for (uint8_t module : modules) {
+      if (now - lastSeen[module] > kModuleIdleNs) {
+        continue;
+      }
+      watermark = std::min(watermark, newest[module] - fReorderWindowNs);
+      anyActive = true;
+    }
+
+    if (inputsWaiting > 0 && now - startNs < kModuleIdleNs) {
+      continue;
+    }
+
+    if (anyActive) {
+      buckets.Release(watermark, slice);
+    } else if (buckets.GetBufferedCount() > 0 || !slice.empty()) {
+      // Every module has gone quiet: nothing more is coming for now
+      buckets.ReleaseAll(slice);
+      dispatchAll();
+    }
+    fLateHits = buckets.GetLateCount();
+
+    // Hand complete slices to the workers
+    while (!slice.empty()) {
+      size_t cut = fBuilder.FindCut(
+          slice, slice.front().timeStampNs + fSliceNs, scan);
+      if (cut == 0) {
+        if (slice.size() >= kMaxSliceHits) {
+          // No gap between windows for far too long; bound memory and
+          // accept that an event may be split here
+          fForcedCuts++;
+          dispatchAll();
+        }
+        break;
+      }
+      std::vector<MinimalEventData> rest(slice.begin() + cut, slice.end());
+      slice.resize(cut);
+      DispatchSlice(std::move(slice), sliceOldest);
+      slice = std::move(rest);
+      sliceOldest = 0;
+    }
+  }
+
+  // End of run: flush everything, then the EOS marker if upstream sent it
+  buckets.ReleaseAll(slice);
+  fLateHits = buckets.GetLateCount();
+  dispatchAll();
+  if (fAllEOS) {
+    DispatchEOS();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(fSliceMutex);
+    fSortDone = true;
+  }
+  fJobAvailable.notify_all();
+  fSliceAvailable.notify_all();
+}
+
+void EventBuilder::DispatchSlice(std::vector<MinimalEventData> &&hits,
+                                 uint64_t oldest_ns) {
+  BuildJob job;
+  job.hits = std::move(hits);
+  job.oldest_ns = oldest_ns;
+  auto future = job.result.get_future();
+
+  // Bound the slices in flight so a slow output holds back the sorter
+  const size_t maxInFlight = 2 * static_cast<size_t>(fWorkerThreads) + 2;
+  {
+    std::unique_lock<std::mutex> lock(fSliceMutex);
+    fSliceSpace.wait(lock, [this, maxInFlight] {
+      return fSliceQueue.size() < maxInFlight || fAbort;
+    });
+    if (fAbort) {
+      return;
+    }
+    fJobQueue.push_back(std::move(job));
+    fSliceQueue.push_back(std::move(future));
+  }
+  fJobAvailable.notify_one();
+  fSliceAvailable.notify_one();
+}
+
+void EventBuilder::DispatchEOS() {
+  std::promise<BuiltSlice> marker;
+  BuiltSlice slice;
+  slice.eos = true;
+  marker.set_value(std::move(slice));
+  {
+    std::lock_guard<std::mutex> lock(fSliceMutex);
+    fSliceQueue.push_back(marker.get_future());
+  }
+  fSliceAvailable.notify_one();
+}
+
+void EventBuilder::BuildWorker() {
+  while (true) {
+    BuildJob job;
+    {
+      std::unique_lock<std::mutex> lock(fSliceMutex);
+      fJobAvailable.wait(lock, [this] {
+        return !fJobQueue.empty() || fSortDone || fAbort;
+      });
+      if (fAbort || fJobQueue.empty()) {
+        return;
+      }
+      job = std::move(fJobQueue.front());
+      fJobQueue.pop_front();
+    }
+
+    BuiltSlice slice;
+    slice.frame = std::make_unique<std::vector<uint8_t>>(
+        Net::BINARY_DATA_HEADER_SIZE);
+    slice.frame->reserve(Net::BINARY_DATA_HEADER_SIZE +
+                         job.hits.size() * sizeof(MinimalEventData));
+    slice.events = fBuilder.Build(job.hits, *slice.frame);
+    slice.oldest_ns = job.oldest_ns;
+    job.result.set_value(std::move(slice));
+  }
+}
+
+void EventBuilder::SendingLoop() {
+  uint64_t sequence = 0;
+
+  while (true) {
+    std::future<BuiltSlice> pending;
+    {
+      std::unique_lock<std::mutex> lock(fSliceMutex);
+      fSliceAvailable.wait(lock, [this] {
+        return !fSliceQueue.empty() || fSortDone || fAbort;
+      });
+      if (fAbort || fSliceQueue.empty()) {
+        break;
+      }
+      pending = std::move(fSliceQueue.front());
+      fSliceQueue.pop_front();
+    }
+    fSliceSpace.notify_one();
+
+    // Slices finish out of order; they are sent in the order dispatched
+    while (pending.wait_for(std::chrono::milliseconds(10)) !=
+           std::future_status::ready) {
+      if (fAbort) {
+        return;
+      }
+    }
+    BuiltSlice slice = pending.get();
+
+    auto &output = fOutputTransports[0];
+    if (!output || !output->IsConnected()) {
+      continue;
+    }
+
+    if (slice.eos) {
+      auto eosData = fDataProcessor->CreateEOSMessage();
+      output->SendBytes(eosData);
+      continue;
+    }
+
+    if (slice.events == 0) {
+      continue;
+    }
+
+    const bool timed = slice.oldest_ns != 0;
+    const uint64_t start = timed ? LatencyRecorder::Now() : 0;
+    if (timed) {
+      fLatency.RecordResidency(slice.oldest_ns, start);
+    }
+
+    const uint32_t events = slice.events;
+    if (fDataProcessor->FinalizeFrame(*slice.frame,
+                                      Net::FORMAT_VERSION_BUILT_EVENTDATA,
+                                      events, sequence++) &&
+        output->SendBytes(slice.frame)) {
+      fEventsProcessed += events;
+    }
+
+    if (timed) {
+      fLatency.RecordProcessing(start, LatencyRecorder::Now());
+    }
+  }
+}
+
+void EventBuilder::AddMetrics(MetricsExporter &exporter) {
+  exporter.AddCounter("hits_received", "Hits received from all inputs",
+                      [this] { return fHitsReceived.load(); });
+  exporter.AddCounter("late_hits",
+                      "Hits dropped for arriving after their time was built",
+                      [this] { return fLateHits.load(); });
+  exporter.AddCounter("forced_cuts",
+                      "Slices cut without a gap between coincidence windows",
+                      [this] { return fForcedCuts.load(); });
+  exporter.AddCounter("eos_received", "End-of-stream markers received",
+                      [this] {
+                        return static_cast<uint64_t>(fEOSReceivedCount.load());
+                      });
+}
+
+}  // namespace DELILA
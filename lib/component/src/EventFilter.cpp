@@ -0,0 +1,237 @@
+/**
+ * @file EventFilter.cpp
+ * @brief Event selection rule parsing and batch evaluation
+ */
+
+#include "EventFilter.hpp"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace DELILA {
+
+namespace {
+
+bool ParseField(const std::string &name, EventFilter::Field &field) {
+  if (name == "module") {
+    field = EventFilter::Field::Module;
+  } else if (name == "channel") {
+    field = EventFilter::Field::Channel;
+  } else if (name == "energy") {
+    field = EventFilter::Field::Energy;
+  } else if (name == "energy_short") {
+    field = EventFilter::Field::EnergyShort;
+  } else if (name == "psd") {
+    field = EventFilter::Field::PsdRatio;
+  } else if (name == "multiplicity") {
+    field = EventFilter::Field::Multiplicity;
+  } else if (name == "flags") {
+    field = EventFilter::Field::Flags;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool ParseMask(const std::string &text, uint64_t &mask) {
+  mask = 0;
+  std::stringstream parts(text);
+  std::string part;
+  while (std::getline(parts, part, '|')) {
+    if (part == "pileup") {
+      mask |= MinimalEventData::FLAG_PILEUP;
+    } else if (part == "trigger_lost") {
+      mask |= MinimalEventData::FLAG_TRIGGER_LOST;
+    } else if (part == "over_range") {
+      mask |= MinimalEventData::FLAG_OVER_RANGE;
+    } else {
+      try {
+        size_t used = 0;
+        mask |= std::stoull(part, &used, 0);
+        if (used != part.size()) {
+          return false;
+        }
+      } catch (const std::exception &) {
+        return false;
+      }
+    }
+  }
+  return mask != 0;
+}
+
+void Fail(std::string *error, const char *reason) {
+  if (error) {
+    *error = reason;
+  }
+}
+
+// Evaluation helpers: one pass per rule over a column
+void TestRange(const std::vector<float> &column, float lo, float hi,
+               bool negate, uint8_t *result) {
+  const size_t n = column.size();
+  const float *v = column.data();
+  const uint8_t flip = negate ? 1 : 0;
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = static_cast<uint8_t>((v[i] >= lo) & (v[i] <= hi)) ^ flip;
+  }
+}
+
+void TestFlags(const std::vector<uint64_t> &column, uint64_t mask, bool anySet,
+               uint8_t *result) {
+  const size_t n = column.size();
+  const uint64_t *v = column.data();
+  const uint8_t flip = anySet ? 0 : 1;
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = static_cast<uint8_t>((v[i] & mask) != 0) ^ flip;
+  }
+}
+
+} // namespace
+
+// === Batch ===
+
+void EventFilter::Batch::Clear() {
+  module.clear();
+  channel.clear();
+  energy.clear();
+  energyShort.clear();
+  psd.clear();
+  multiplicity.clear();
+  flags.clear();
+}
+
+void EventFilter::Batch::Add(uint8_t mod, uint8_t ch, uint16_t en,
+                             uint16_t enShort, uint64_t fl,
+                             uint32_t hits) {
+  module.push_back(mod);
+  channel.push_back(ch);
+  energy.push_back(en);
+  energyShort.push_back(enShort);
+  psd.push_back(en > 0 ? (static_cast<float>(en) - enShort) / en : 0.0f);
+  multiplicity.push_back(static_cast<float>(hits));
+  flags.push_back(fl);
+}
+
+// === Rules ===
+
+bool EventFilter::AddRule(const std::string &expression, std::string *error) {
+  std::istringstream in(expression);
+  std::string name, op, value, extra;
+  if (!(in >> name >> op >> value) || (in >> extra)) {
+    Fail(error, "expected '<field> <op> <value>'");
+    return false;
+  }
+
+  Rule rule;
+  rule.expression = expression;
+  if (!ParseField(name, rule.field)) {
+    Fail(error, "unknown field");
+    return false;
+  }
+
+  if (rule.field == Field::Flags) {
+    if (op != "none" && op != "any") {
+      Fail(error, "flags rules use 'none' or 'any'");
+      return false;
+    }
+    if (!ParseMask(value, rule.mask)) {
+      Fail(error, "invalid flag mask");
+      return false;
+    }
+    rule.anySet = (op == "any");
+    fRules.push_back(rule);
+    return true;
+  }
+
+  double number = 0.0;
+  try {
+    size_t used = 0;
+    number = std::stod(value, &used);
+    if (used != value.size() || !std::isfinite(number)) {
+      throw std::invalid_argument(value);
+    }
+  } catch (const std::exception &) {
+    Fail(error, "invalid number");
+    return false;
+  }
+
+  // Every comparison becomes a closed float range, possibly negated
+  const float v = static_cast<float>(number);
+  const float inf = std::numeric_limits<float>::infinity();
+  rule.lo = -inf;
+  rule.hi = inf;
+  if (op == "<") {
+    rule.hi = std::nextafter(v, -inf);
+  } else if (op == "<=") {
+    rule.hi = v;
+  } else if (op == ">") {
+    rule.lo = std::nextafter(v, inf);
+  } else if (op == ">=") {
+    rule.lo = v;
+  } else if (op == "==" || op == "!=") {
+    rule.lo = v;
+    rule.hi = v;
+    rule.negate = (op == "!=");
+  } else {
+    Fail(error, "unknown operator");
+    return false;
+  }
+
+  fRules.push_back(rule);
+  return true;
+}
+
+size_t EventFilter::Evaluate(const Batch &batch, std::vector<uint8_t> &pass,
+                             std::vector<uint64_t> &ruleCounts) const {
+  const size_t n = batch.Size();
+  pass.assign(n, 1);
+  if (ruleCounts.size() < fRules.size()) {
+    ruleCounts.resize(fRules.size(), 0);
+  }
+  fRuleResult.resize(n);
+  uint8_t *result = fRuleResult.data();
+
+  for (size_t r = 0; r < fRules.size(); ++r) {
+    const Rule &rule = fRules[r];
+    switch (rule.field) {
+    case Field::Module:
+      TestRange(batch.module, rule.lo, rule.hi, rule.negate, result);
+      break;
+    case Field::Channel:
+      TestRange(batch.channel, rule.lo, rule.hi, rule.negate, result);
+      break;
+    case Field::Energy:
+      TestRange(batch.energy, rule.lo, rule.hi, rule.negate, result);
+      break;
+    case Field::EnergyShort:
+      TestRange(batch.energyShort, rule.lo, rule.hi, rule.negate, result);
+      break;
+    case Field::PsdRatio:
+      TestRange(batch.psd, rule.lo, rule.hi, rule.negate, result);
+      break;
+    case Field::Multiplicity:
+      TestRange(batch.multiplicity, rule.lo, rule.hi, rule.negate, result);
+      break;
+    case Field::Flags:
+      TestFlags(batch.flags, rule.mask, rule.anySet, result);
+      break;
+    }
+
+    uint64_t passed = 0;
+    for (size_t i = 0; i < n; ++i) {
+      passed += result[i];
+      pass[i] &= result[i];
+    }
+    ruleCounts[r] += passed;
+  }
+
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += pass[i];
+  }
+  return total;
+}
+
+} // namespace DELILA
@@ -1,9 +1,11 @@
 #include "FileWriter.hpp"
+#include "MetricsExporter.hpp"
 #include <DataProcessor.hpp>
 #include <ZMQTransport.hpp>
 #include <delila/core/CommandResponse.hpp>
 #include <delila/core/ErrorCode.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
@@ -65,6 +67,7 @@ void FileWriter::Shutdown() {
 
   // Stop command listener first
   StopCommandListener();
+  StopMetricsExporter();
 
   // Stop worker threads
   if (fReceivingThread && fReceivingThread->joinable()) {
@@ -79,6 +82,10 @@ void FileWriter::Shutdown() {
   if (fTransport) {
     fTransport->Disconnect();
   }
+  if (fRetransmitTransport) {
+    fRetransmitTransport->Disconnect();
+    fRetransmitTransport.reset();
+  }
 
   fState = ComponentState::Idle;
 }
@@ -97,7 +104,13 @@ ComponentStatus FileWriter::GetStatus() const {
   status.run_number = fRunNumber.load();
   status.metrics.events_processed = fEventsProcessed.load();
   status.metrics.bytes_transferred = fBytesTransferred.load();
+  fLatency.Fill(status.metrics);
+  fRates.Fill(status.metrics.events_processed,
+              status.metrics.bytes_transferred, status.metrics);
   status.error_message = fErrorMessage;
+  if (status.error_message.empty() && fMergedInput.load()) {
+    status.error_message = kMergedInputError;
+  }
   status.heartbeat_counter = fHeartbeatCounter.load();
   return status;
 }
@@ -145,6 +158,47 @@ void FileWriter::SetFilePrefix(const std::string &prefix) {
 
 std::string FileWriter::GetFilePrefix() const { return fFilePrefix; }
 
+void FileWriter::SetWriteManifest(bool enable) { fWriteManifest = enable; }
+
+bool FileWriter::GetWriteManifest() const { return fWriteManifest; }
+
+std::string FileWriter::GetManifestPath() const {
+  if (!fWriteManifest) {
+    return "";
+  }
+  return RunManifest::ManifestPathFor(GenerateFilePath(fRunNumber));
+}
+
+void FileWriter::SetRetransmitAddress(const std::string &address) {
+  fRetransmitAddress = address;
+}
+
+std::string FileWriter::GetRetransmitAddress() const {
+  return fRetransmitAddress;
+}
+
+void FileWriter::SetRetransmitTimeoutMs(uint32_t ms) {
+  fRetransmitTimeoutMs = ms;
+}
+
+uint32_t FileWriter::GetRetransmitTimeoutMs() const {
+  return fRetransmitTimeoutMs;
+}
+
+uint64_t FileWriter::GetFramesRecovered() const {
+  return fRecovery.GetRecovered();
+}
+
+uint64_t FileWriter::GetFramesLost() const { return fRecovery.GetLost(); }
+
+uint64_t FileWriter::GetRetransmitRequests() const {
+  return fRecovery.GetRequestsSent();
+}
+
+const LatencyHistogram &FileWriter::GetRecoveryLatency() const {
+  return fRecoveryLatency;
+}
+
 // === Testing utilities ===
 
 void FileWriter::ForceError(const std::string &message) {
@@ -175,6 +229,23 @@ bool FileWriter::OnArm() {
     }
   }
 
+  // Reliable delivery: requests go to the source's RetransmitServer
+  if (!fRetransmitAddress.empty() && !fRetransmitTransport) {
+    auto transport = std::make_unique<Net::ZMQTransport>();
+    Net::TransportConfig config;
+    config.data_address = fRetransmitAddress;
+    config.bind_data = false;
+    config.data_pattern = "PUSH";
+    config.status_address = config.data_address;
+    config.command_address = "";
+    if (!transport->Configure(config) || !transport->Connect()) {
+      fErrorMessage = "Failed to connect retransmit address";
+      fState = ComponentState::Error;
+      return false;
+    }
+    fRetransmitTransport = std::move(transport);
+  }
+
   fState = ComponentState::Armed;
   return true;
 }
@@ -189,7 +260,15 @@ bool FileWriter::OnStart(uint32_t run_number) {
   fRunNumber = run_number;
   fEventsProcessed = 0;
   fBytesTransferred = 0;
+  fLatency.Reset();
+  fRates.Reset();
   fReceivedEOS = false;  // Reset EOS flag for new run
+  fEOSPending = false;
+  fReliable = fRetransmitTransport != nullptr;
+  fMergedInput = false;
+  fRecovery.Reset();
+  fRecovery.SetTimeout(std::chrono::milliseconds(fRetransmitTimeoutMs));
+  fRecoveryLatency.Reset();
 
   // Open output file
   if (!OpenOutputFile(run_number)) {
@@ -269,6 +348,10 @@ void FileWriter::OnReset() {
   if (fTransport) {
     fTransport->Disconnect();
   }
+  if (fRetransmitTransport) {
+    fRetransmitTransport->Disconnect();
+    fRetransmitTransport.reset();
+  }
 
   fState = ComponentState::Idle;
 }
@@ -300,29 +383,93 @@ void FileWriter::ReceivingLoop() {
       break;
     }
 
+    // Reliable delivery: drop duplicates, request what is missing (also
+    // when nothing arrived, to retry)
+    if (fReliable) {
+      bool keep = !data || data->empty() || AcceptSequence(*data);
+      RequestMissing();
+      if (!keep) {
+        continue;
+      }
+    }
+
     if (data && !data->empty()) {
       // Check for EOS (End Of Stream) marker
       if (Net::DataProcessor::IsEOSMessage(data->data(), data->size())) {
-        fReceivedEOS.store(true);
         // EOS received - upstream has finished sending data
         // Continue running to allow graceful shutdown
+        if (fRecovery.GetMissing() > 0) {
+          fEOSPending = true;  // Set once the missing frames are in
+        } else {
+          fReceivedEOS.store(true);
+        }
         continue;
       }
 
       // Store the size before any operations
+      const bool timed = fLatency.Sample();
+      const uint64_t start = timed ? LatencyRecorder::Now() : 0;
       size_t dataSize = data->size();
-      const uint8_t *dataPtr = data->data();
-
-      // Decode events
-      auto [events, sequence] = fDataProcessor->Decode(data);
-      if (events && !events->empty()) {
-        // Write to file - use stored values since data is still valid
-        if (fOutputFile && fOutputFile->is_open()) {
-          fOutputFile->write(reinterpret_cast<const char *>(dataPtr),
-                             static_cast<std::streamsize>(dataSize));
-          fEventsProcessed += events->size();
+      Net::BinaryDataHeader header;
+      bool peeked = Net::DataProcessor::PeekHeader(*data, header);
+      bool stamped = timed && peeked;
+
+      if (peeked &&
+          header.format_version == Net::FORMAT_VERSION_BUILT_EVENTDATA) {
+        // Built events (EventBuilder output): validate, write as received
+        auto [built, builtSequence] = fDataProcessor->DecodeBuilt(data);
+        if (built && !built->empty() && fOutputFile &&
+            fOutputFile->is_open()) {
+          WriteFrame(*data, header);
+          fRates.CountFrame(*data);
+          fEventsProcessed += built->size();
+          fBytesTransferred += dataSize;
+        }
+      } else if (peeked && header.format_version ==
+                               Net::FORMAT_VERSION_MINIMAL_EVENTDATA) {
+        // Minimal events (Emulator default): validate, write as received
+        auto [minimal, minimalSequence] = fDataProcessor->DecodeMinimal(data);
+        if (minimal && !minimal->empty() && fOutputFile &&
+            fOutputFile->is_open()) {
+          WriteFrame(*data, header);
+          fRates.CountFrame(*data);
+          fEventsProcessed += minimal->size();
           fBytesTransferred += dataSize;
         }
+      } else if (peeked && header.format_version ==
+                               Net::FORMAT_VERSION_CALIBRATED_EVENTDATA) {
+        // Calibrated events (CalibrationStage output): validate, write as
+        // received
+        auto [calibrated, calibratedSequence] =
+            fDataProcessor->DecodeCalibrated(data);
+        if (calibrated && !calibrated->empty() && fOutputFile &&
+            fOutputFile->is_open()) {
+          WriteFrame(*data, header);
+          fRates.CountFrame(*data);
+          fEventsProcessed += calibrated->size();
+          fBytesTransferred += dataSize;
+        }
+      } else {
+        // Decode events
+        auto [events, sequence] = fDataProcessor->Decode(data);
+        if (events && !events->empty()) {
+          // Write to file - use stored values since data is still valid
+          if (fOutputFile && fOutputFile->is_open()) {
+            WriteFrame(*data, header);
+            fRates.CountEvents(*events);
+            fEventsProcessed += events->size();
+            fBytesTransferred += dataSize;
+          }
+        }
+      }
+
+      // FileWriter has no queue of its own: no residency, only processing
+      if (timed) {
+        const uint64_t end = LatencyRecorder::Now();
+        fLatency.RecordProcessing(start, end);
+        if (stamped) {
+          fLatency.RecordAge(header.timestamp, end);
+        }
       }
     } else {
       // No data available, sleep briefly
@@ -338,6 +485,71 @@ void FileWriter::WritingLoop() {
   }
 }
 
+void FileWriter::WriteFrame(const std::vector<uint8_t> &data,
+                            const Net::BinaryDataHeader &header) {
+  fOutputFile->write(reinterpret_cast<const char *>(data.data()),
+                     static_cast<std::streamsize>(data.size()));
+
+  if (fWriteManifest) {
+    // Event time range from the records, without decoding them again
+    double firstNs = 0.0;
+    double lastNs = 0.0;
+    if (Net::DataProcessor::ScanRecords(data, fRecords) && !fRecords.empty()) {
+      firstNs = lastNs = fRecords[0].timeStampNs;
+      for (const auto &record : fRecords) {
+        firstNs = std::min(firstNs, record.timeStampNs);
+        lastNs = std::max(lastNs, record.timeStampNs);
+      }
+    }
+    fManifest.AddFrame(0, header.sequence_number, fFileOffset, data.size(),
+                       header.event_count, firstNs, lastNs);
+  }
+  fFileOffset += data.size();
+}
+
+bool FileWriter::AcceptSequence(const std::vector<uint8_t> &data) {
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(data, header)) {
+    return true;  // Not a frame: rejected by the decoders as before
+  }
+  if (header.source_id != 0) {
+    DisableReliableDelivery();
+    return true;
+  }
+
+  uint64_t recoveryNs = 0;
+  auto outcome = fRecovery.Accept(header.sequence_number,
+                                  Net::GapRecovery::Clock::now(), &recoveryNs);
+  if (outcome == Net::GapRecovery::Outcome::Recovered) {
+    fRecoveryLatency.Record(recoveryNs);
+  }
+  return outcome != Net::GapRecovery::Outcome::Duplicate;
+}
+
+void FileWriter::RequestMissing() {
+  for (const auto &range :
+       fRecovery.TakeRequests(Net::GapRecovery::Clock::now())) {
+    auto request = Net::GapRecovery::EncodeRequest(range);
+    fRetransmitTransport->SendBytes(request);
+  }
+
+  if (fEOSPending && fRecovery.GetMissing() == 0) {
+    fEOSPending = false;
+    fReceivedEOS.store(true);
+  }
+}
+
+void FileWriter::DisableReliableDelivery() {
+  std::cerr << "FileWriter: " << kMergedInputError << std::endl;
+  fReliable = false;
+  fMergedInput.store(true);
+  fRecovery.Reset();  // Gaps so far are other sources' frames, not losses
+  if (fEOSPending) {
+    fEOSPending = false;
+    fReceivedEOS.store(true);
+  }
+}
+
 std::string FileWriter::GenerateFilename(uint32_t run_number) const {
   std::ostringstream oss;
   oss << fFilePrefix << std::setfill('0') << std::setw(6) << run_number
@@ -345,15 +557,23 @@ std::string FileWriter::GenerateFilename(uint32_t run_number) const {
   return oss.str();
 }
 
-bool FileWriter::OpenOutputFile(uint32_t run_number) {
-  std::string filename = GenerateFilename(run_number);
+std::string FileWriter::GenerateFilePath(uint32_t run_number) const {
   std::string full_path = fOutputPath;
   if (!full_path.empty() && full_path.back() != '/') {
     full_path += '/';
   }
-  full_path += filename;
+  return full_path + GenerateFilename(run_number);
+}
 
-  fOutputFile = std::make_unique<std::ofstream>(full_path, std::ios::binary);
+bool FileWriter::OpenOutputFile(uint32_t run_number) {
+  fOutputFilePath = GenerateFilePath(run_number);
+  fFileOffset = 0;
+  fManifest.Clear();
+  fManifest.SetRunNumber(run_number);
+  fManifest.AddFile(fOutputFilePath);
+
+  fOutputFile =
+      std::make_unique<std::ofstream>(fOutputFilePath, std::ios::binary);
   return fOutputFile && fOutputFile->is_open();
 }
 
@@ -361,6 +581,15 @@ void FileWriter::CloseOutputFile() {
   if (fOutputFile) {
     if (fOutputFile->is_open()) {
       fOutputFile->close();
+
+      // The manifest only describes complete files
+      std::string error;
+      if (fWriteManifest &&
+          !fManifest.Save(RunManifest::ManifestPathFor(fOutputFilePath),
+                          &error)) {
+        std::cerr << "FileWriter: Failed to save run manifest: " << error
+                  << std::endl;
+      }
     }
     fOutputFile.reset();
   }
@@ -412,6 +641,49 @@ void FileWriter::StopCommandListener() {
   }
 }
 
+// === Metrics endpoint ===
+
+void FileWriter::SetMetricsAddress(const std::string &address) {
+  fMetrics.SetAddress(address);
+}
+
+std::string FileWriter::GetMetricsAddress() const {
+  return fMetrics.GetAddress();
+}
+
+bool FileWriter::StartMetricsExporter() {
+  MetricsExporter *exporter = fMetrics.Prepare(*this);
+  if (!exporter) {
+    return false;
+  }
+  if (!fRetransmitAddress.empty()) {
+    exporter->AddCounter("retransmit_requests",
+                         "Retransmission requests sent",
+                         [this] { return fRecovery.GetRequestsSent(); });
+    exporter->AddCounter("frames_recovered",
+                         "Missing frames received by retransmission",
+                         [this] { return fRecovery.GetRecovered(); });
+    exporter->AddCounter("frames_lost",
+                         "Missing frames given up on after the timeout",
+                         [this] { return fRecovery.GetLost(); });
+    exporter->AddGauge("frames_missing", "Frames requested, not yet received",
+                       [this] {
+                         return static_cast<double>(fRecovery.GetMissing());
+                       });
+    exporter->AddGauge("recovery_latency_p99_seconds",
+                       "99th percentile of gap detection to recovery",
+                       [this] {
+                         return fRecoveryLatency.GetValueAtPercentile(99.0) *
+                                1e-9;
+                       });
+  }
+  return fMetrics.Start();
+}
+
+void FileWriter::StopMetricsExporter() {
+  fMetrics.Stop();
+}
+
 void FileWriter::CommandListenerLoop() {
   while (fCommandListenerRunning) {
     auto cmd = fCommandTransport->ReceiveCommand();
@@ -0,0 +1,195 @@
+#include "FilterStage.hpp"
+
+#include <DataProcessor.hpp>
+
+#include <cstddef>
+
+namespace DELILA {
+
+FilterStage::FilterStage()
+    : SingleInputStage("FilterStage"),
+      fDataProcessor(std::make_unique<Net::DataProcessor>()) {}
+
+FilterStage::~FilterStage() { Shutdown(); }
+
+// === Configuration ===
+
+bool FilterStage::AddRule(const std::string &expression, std::string *error) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    if (error) {
+      *error = "cannot change rules while running";
+    }
+    return false;
+  }
+  return fFilter.AddRule(expression, error);
+}
+
+void FilterStage::ClearRules() {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState != ComponentState::Running) {
+    fFilter.Clear();
+  }
+}
+
+std::vector<std::string> FilterStage::GetRules() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  std::vector<std::string> rules;
+  for (const auto &rule : fFilter.GetRules()) {
+    rules.push_back(rule.expression);
+  }
+  return rules;
+}
+
+std::vector<uint64_t> FilterStage::GetRuleCounts() const {
+  std::lock_guard<std::mutex> lock(fRuleCountsMutex);
+  return fRuleCounts;
+}
+
+uint64_t FilterStage::GetEventsReceived() const {
+  return fEventsReceived.load();
+}
+
+// === SingleInputStage hooks ===
+
+void FilterStage::ResetCounters() {
+  fEventsReceived = 0;
+  fSequence = 0;
+  fFrameRuleCounts.assign(fFilter.GetRuleCount(), 0);
+  {
+    std::lock_guard<std::mutex> countsLock(fRuleCountsMutex);
+    fRuleCounts.assign(fFilter.GetRuleCount(), 0);
+  }
+}
+
+void FilterStage::AddMetrics(MetricsExporter &exporter) {
+  exporter.AddCounter("events_received", "Events received before filtering",
+                      [this] { return fEventsReceived.load(); });
+  exporter.AddCounter("bytes_received", "Bytes received before filtering",
+                      [this] { return fBytesReceived.load(); });
+
+  // One counter per rule, in rule order; the help text is the rule
+  auto rules = GetRules();
+  for (size_t r = 0; r < rules.size(); ++r) {
+    exporter.AddCounter("filter_rule_" + std::to_string(r) + "_passed",
+                        "Events passing '" + rules[r] + "'", [this, r] {
+                          std::lock_guard<std::mutex> lock(fRuleCountsMutex);
+                          return r < fRuleCounts.size() ? fRuleCounts[r]
+                                                        : uint64_t{0};
+                        });
+  }
+}
+
+void FilterStage::ProcessFrame(std::unique_ptr<std::vector<uint8_t>> &data) {
+  uint32_t passed = 0;
+  auto output = FilterFrame(data, passed);
+
+  // Publish this frame's per-rule counts
+  {
+    std::lock_guard<std::mutex> lock(fRuleCountsMutex);
+    for (size_t r = 0; r < fFrameRuleCounts.size(); ++r) {
+      fRuleCounts[r] += fFrameRuleCounts[r];
+      fFrameRuleCounts[r] = 0;
+    }
+  }
+
+  if (output) {
+    SendFrame(0, output, passed);
+  }
+}
+
+std::unique_ptr<std::vector<uint8_t>> FilterStage::FilterFrame(
+    std::unique_ptr<std::vector<uint8_t>> &data, uint32_t &passed) {
+  passed = 0;
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(*data, header)) {
+    return nullptr;
+  }
+
+  // Evaluate the batch and move the passing events into a new list
+  auto select = [this, &passed](auto &events, auto addToBatch) {
+    using List = typename std::remove_reference_t<decltype(*events)>;
+    auto selected = std::make_unique<List>();
+    fBatch.Clear();
+    for (const auto &event : *events) {
+      addToBatch(*event);
+    }
+    fEventsReceived += events->size();
+    passed = static_cast<uint32_t>(
+        fFilter.Evaluate(fBatch, fPass, fFrameRuleCounts));
+    selected->reserve(passed);
+    for (size_t i = 0; i < events->size(); ++i) {
+      if (fPass[i]) {
+        selected->push_back(std::move((*events)[i]));
+      }
+    }
+    return selected;
+  };
+
+  std::unique_ptr<std::vector<uint8_t>> output;
+  switch (header.format_version) {
+  case Net::FORMAT_VERSION_MINIMAL_EVENTDATA: {
+    auto [events, sequence] = fDataProcessor->DecodeMinimal(data);
+    if (!events) {
+      break;
+    }
+    auto selected = select(events, [this](const MinimalEventData &event) {
+      fBatch.Add(event);
+    });
+    if (passed > 0) {
+      output = fDataProcessor->Process(selected, fSequence);
+    }
+    break;
+  }
+  case Net::FORMAT_VERSION_EVENTDATA:
+  case Net::FORMAT_VERSION_COMPACT_EVENTDATA: {
+    auto [events, sequence] = fDataProcessor->Decode(data);
+    if (!events) {
+      break;
+    }
+    auto selected = select(events, [this](const Digitizer::EventData &event) {
+      fBatch.Add(event.module, event.channel, event.energy, event.energyShort,
+                 event.flags);
+    });
+    if (passed > 0) {
+      // Re-encode in the encoding the frame came in
+      fDataProcessor->EnableCompactWaveforms(
+          header.format_version == Net::FORMAT_VERSION_COMPACT_EVENTDATA);
+      output = fDataProcessor->Process(selected, fSequence);
+    }
+    break;
+  }
+  case Net::FORMAT_VERSION_BUILT_EVENTDATA: {
+    auto [events, sequence] = fDataProcessor->DecodeBuilt(data);
+    if (!events) {
+      break;
+    }
+    auto selected =
+        select(events, [this](const Digitizer::BuiltEventData &event) {
+          fBatch.Add(event.GetTrigger(),
+                     static_cast<uint32_t>(event.GetMultiplicity()));
+        });
+    if (passed > 0) {
+      output = fDataProcessor->Process(selected, fSequence);
+    }
+    break;
+  }
+  default:
+    // No rules apply (e.g. calibrated frames): forward the frame as it
+    // is (header only changes below, the payload checksum stays valid)
+    fEventsReceived += header.event_count;
+    passed = header.event_count;
+    output = std::move(data);
+    break;
+  }
+
+  // Keep the source timestamp so frame age stays end-to-end, and the
+  // merger stamp; the frame is numbered in this stage's sequence
+  if (output) {
+    Net::DataProcessor::CopySourceStamps(header, *output);
+    Net::DataProcessor::SetStreamSequence(*output, fSequence++);
+  }
+  return output;
+}
+
+}  // namespace DELILA
@@ -0,0 +1,220 @@
+/**
+ * @file HistogramShard.cpp
+ * @brief Per-worker integer histogram accumulator implementation
+ */
+
+#include "HistogramShard.hpp"
+
+#include <delila/core/EventData.hpp>
+#include <delila/core/MinimalEventData.hpp>
+
+#include <algorithm>
+
+namespace DELILA {
+
+namespace {
+
+constexpr uint32_t kEnergyVsChannelStride = HistogramShard::kChannelBins + 2;
+constexpr uint32_t kEnergyVsModuleStride = HistogramShard::kModuleBins + 2;
+
+}  // namespace
+
+HistogramShard::HistogramShard() : HistogramShard(Layout()) {}
+
+HistogramShard::HistogramShard(const Layout& layout) : fLayout(layout) {
+  if (fLayout.energy) {
+    MutableBins(Histogram::Energy).assign(kEnergyBins + 2, 0);
+  }
+  if (fLayout.channel) {
+    MutableBins(Histogram::Channel).assign(kChannelBins + 2, 0);
+  }
+  if (fLayout.module) {
+    MutableBins(Histogram::Module).assign(kModuleBins + 2, 0);
+  }
+  if (fLayout.timing) {
+    MutableBins(Histogram::TimeDiff).assign(kTimeDiffBins + 2, 0);
+  }
+  if (fLayout.two_d) {
+    MutableBins(Histogram::EnergyVsChannel)
+        .assign(kEnergyVsChannelStride * (k2DEnergyBins + 2), 0);
+    MutableBins(Histogram::EnergyVsModule)
+        .assign(kEnergyVsModuleStride * (k2DEnergyBins + 2), 0);
+  }
+}
+
+// === Filling ===
+
+void HistogramShard::Fill(
+    const std::vector<std::unique_ptr<Digitizer::MinimalEventData>>& events) {
+  for (const auto& event : events) {
+    auto i = fBlock.size++;
+    fBlock.energy[i] = event->energy;
+    fBlock.channel[i] = event->channel;
+    fBlock.module[i] = event->module;
+    fBlock.timestamp[i] = event->timeStampNs;
+    if (fBlock.size == kBlockSize) {
+      FillBlock();
+    }
+  }
+  FillBlock();
+  fEventCount += events.size();
+}
+
+void HistogramShard::Fill(
+    const std::vector<std::unique_ptr<Digitizer::EventData>>& events) {
+  const Digitizer::EventData* latestWaveform = nullptr;
+
+  for (const auto& event : events) {
+    auto i = fBlock.size++;
+    fBlock.energy[i] = event->energy;
+    fBlock.channel[i] = event->channel;
+    fBlock.module[i] = event->module;
+    fBlock.timestamp[i] = event->timeStampNs;
+    if (fBlock.size == kBlockSize) {
+      FillBlock();
+    }
+
+    if (fLayout.waveform && event->module == fLayout.waveform_module &&
+        event->channel == fLayout.waveform_channel &&
+        event->waveformSize > 0) {
+      latestWaveform = event.get();
+    }
+  }
+  FillBlock();
+  fEventCount += events.size();
+
+  // Only the last matching waveform of a batch can be displayed
+  if (latestWaveform) {
+    auto size = std::min(latestWaveform->waveformSize,
+                         latestWaveform->analogProbe1.size());
+    fWaveform.assign(latestWaveform->analogProbe1.begin(),
+                     latestWaveform->analogProbe1.begin() + size);
+    fHasWaveform = true;
+  }
+}
+
+void HistogramShard::FillBlock() {
+  const size_t n = fBlock.size;
+  if (n == 0) {
+    return;
+  }
+  auto& idx = fBinScratch;
+
+  // Integer axes starting at zero: bin = min(value >> shift, nbins) + 1.
+  // Values are unsigned, so there is no underflow; anything past the last
+  // bin lands in the overflow bin (nbins + 1), as TH1::Fill would do.
+  auto fill1D = [&](Histogram h, const std::array<uint32_t, kBlockSize>& v,
+                    uint32_t nbins) {
+    auto& bins = MutableBins(h);
+    if (bins.empty()) {
+      return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      idx[i] = std::min(v[i], nbins) + 1;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      ++bins[idx[i]];
+    }
+    fEntries[static_cast<size_t>(h)] += n;
+  };
+
+  auto fill2D = [&](Histogram h, const std::array<uint32_t, kBlockSize>& x,
+                    uint32_t nbinsX, uint32_t stride) {
+    auto& bins = MutableBins(h);
+    if (bins.empty()) {
+      return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t binX = std::min(x[i], nbinsX) + 1;
+      uint32_t binY =
+          std::min(fBlock.energy[i] >> k2DEnergyShift, k2DEnergyBins) + 1;
+      idx[i] = binX + stride * binY;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      ++bins[idx[i]];
+    }
+    fEntries[static_cast<size_t>(h)] += n;
+  };
+
+  fill1D(Histogram::Energy, fBlock.energy, kEnergyBins);
+  fill1D(Histogram::Channel, fBlock.channel, kChannelBins);
+  fill1D(Histogram::Module, fBlock.module, kModuleBins);
+  fill2D(Histogram::EnergyVsChannel, fBlock.channel, kChannelBins,
+         kEnergyVsChannelStride);
+  fill2D(Histogram::EnergyVsModule, fBlock.module, kModuleBins,
+         kEnergyVsModuleStride);
+
+  // Time differences depend on the previous event, so this stays serial
+  auto& timeBins = MutableBins(Histogram::TimeDiff);
+  if (!timeBins.empty()) {
+    uint64_t filled = 0;
+    for (size_t i = 0; i < n; ++i) {
+      double timestamp = fBlock.timestamp[i];
+      if (fPreviousTimestamp > 0) {
+        ++timeBins[TimeDiffBin(timestamp - fPreviousTimestamp)];
+        ++filled;
+      }
+      fPreviousTimestamp = timestamp;
+    }
+    fEntries[static_cast<size_t>(Histogram::TimeDiff)] += filled;
+  }
+
+  fBlock.size = 0;
+}
+
+void HistogramShard::FillTimeDifference(double previous, double current) {
+  auto& timeBins = MutableBins(Histogram::TimeDiff);
+  if (timeBins.empty() || !(previous > 0)) {
+    return;
+  }
+  ++timeBins[TimeDiffBin(current - previous)];
+  ++fEntries[static_cast<size_t>(Histogram::TimeDiff)];
+}
+
+size_t HistogramShard::TimeDiffBin(double diffNs) {
+  double diffUs = diffNs / 1000.0;
+  if (!(diffUs >= 0)) {
+    return 0;
+  }
+  if (diffUs >= kTimeDiffMaxUs) {
+    return kTimeDiffBins + 1;
+  }
+  return 1 + static_cast<size_t>(kTimeDiffBins * diffUs / kTimeDiffMaxUs);
+}
+
+void HistogramShard::Merge(const HistogramShard& other) {
+  for (size_t h = 0; h < kHistogramCount; ++h) {
+    auto& bins = fBins[h];
+    const auto& otherBins = other.fBins[h];
+    if (bins.size() != otherBins.size()) {
+      continue;
+    }
+    for (size_t i = 0; i < bins.size(); ++i) {
+      bins[i] += otherBins[i];
+    }
+    fEntries[h] += other.fEntries[h];
+  }
+  fEventCount += other.fEventCount;
+
+  if (other.fHasWaveform) {
+    fWaveform = other.fWaveform;
+    fHasWaveform = true;
+  }
+}
+
+void HistogramShard::ClearCounts() {
+  for (auto& bins : fBins) {
+    std::fill(bins.begin(), bins.end(), 0);
+  }
+  fEntries.fill(0);
+  fEventCount = 0;
+  fHasWaveform = false;
+}
+
+void HistogramShard::Reset() {
+  ClearCounts();
+  fPreviousTimestamp = 0.0;
+  fWaveform.clear();
+}
+
+}  // namespace DELILA
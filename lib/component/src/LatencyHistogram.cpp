@@ -0,0 +1,163 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Latency histogram and recorder implementation
+ */
+
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DELILA {
+
+namespace {
+
+constexpr uint64_t kExactLimit = uint64_t{2} << LatencyHistogram::kSubBucketBits;
+constexpr uint64_t kMaxValue =
+    (uint64_t{2} << LatencyHistogram::kMaxExponent) - 1;
+
+double ToUs(uint64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+}  // namespace
+
+// === LatencyHistogram ===
+
+LatencyHistogram::LatencyHistogram() { Reset(); }
+
+size_t LatencyHistogram::BucketIndex(uint64_t valueNs) {
+  if (valueNs < kExactLimit) {
+    return static_cast<size_t>(valueNs);
+  }
+  valueNs = std::min(valueNs, kMaxValue);
+  int exponent = 63 - __builtin_clzll(valueNs);
+  int shift = exponent - kSubBucketBits;
+  // valueNs >> shift is in [64, 128): the top 7 bits of the value
+  return (static_cast<size_t>(shift) << kSubBucketBits) +
+         static_cast<size_t>(valueNs >> shift);
+}
+
+uint64_t LatencyHistogram::BucketMidpoint(size_t index) {
+  if (index < kExactLimit) {
+    return index;
+  }
+  size_t shift = (index >> kSubBucketBits) - 1;
+  uint64_t mantissa = (index & ((size_t{1} << kSubBucketBits) - 1)) +
+                      (uint64_t{1} << kSubBucketBits);
+  uint64_t lower = mantissa << shift;
+  return lower + ((uint64_t{1} << shift) >> 1);
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+  uint64_t total = 0;
+  for (const auto& bucket : fCounts) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const {
+  Counts counts;
+  uint64_t total = Snapshot(counts);
+  return ValueAtPercentile(counts, total, percentile);
+}
+
+LatencySummary LatencyHistogram::GetSummary() const {
+  // Percentiles from one snapshot so they are mutually consistent
+  Counts counts;
+  LatencySummary summary;
+  summary.count = Snapshot(counts);
+  summary.p50_us = ToUs(ValueAtPercentile(counts, summary.count, 50.0));
+  summary.p99_us = ToUs(ValueAtPercentile(counts, summary.count, 99.0));
+  summary.p999_us = ToUs(ValueAtPercentile(counts, summary.count, 99.9));
+  summary.max_us = ToUs(GetMax());
+  return summary;
+}
+
+uint64_t LatencyHistogram::Snapshot(Counts& counts) const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    counts[i] = fCounts[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  return total;
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(const Counts& counts,
+                                             uint64_t total,
+                                             double percentile) const {
+  if (total == 0) {
+    return 0;
+  }
+  double clamped = std::min(100.0, std::max(0.0, percentile));
+  uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total)));
+
+  // The bucket midpoint can exceed the largest value actually seen
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return std::min(BucketMidpoint(i), GetMax());
+    }
+  }
+  return GetMax();
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : fCounts) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  fMax.store(0, std::memory_order_relaxed);
+}
+
+// === LatencyRecorder ===
+
+LatencyRecorder::LatencyRecorder() { Reset(); }
+
+uint64_t LatencyRecorder::Now() {
+  return ToNs(std::chrono::steady_clock::now());
+}
+
+uint64_t LatencyRecorder::ToNs(std::chrono::steady_clock::time_point t) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch())
+          .count());
+}
+
+void LatencyRecorder::Reset() {
+  fResidency.Reset();
+  fProcessing.Reset();
+  fAge.Reset();
+
+  uint64_t unixNs = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  fUnixOffsetNs = unixNs - Now();
+
+  fFrameCounter = 0;
+  fLastSampleNs = 0;
+  fSampleMask.store(0, std::memory_order_relaxed);
+}
+
+void LatencyRecorder::AdaptStride(uint64_t sampleNs) {
+  // Interval between timed frames = stride x frame interval; keep it
+  // within [1x, 4x] kMinSampleIntervalNs
+  uint64_t interval = Elapsed(fLastSampleNs, sampleNs);
+  fLastSampleNs = sampleNs;
+
+  uint32_t mask = GetSampleMask();
+  if (interval < kMinSampleIntervalNs && mask < kMaxSampleMask) {
+    fSampleMask.store(mask * 2 + 1, std::memory_order_relaxed);
+  } else if (interval > 4 * kMinSampleIntervalNs && mask > 0) {
+    fSampleMask.store(mask >> 1, std::memory_order_relaxed);
+  }
+}
+
+void LatencyRecorder::Fill(ComponentMetrics& metrics) const {
+  metrics.residency = fResidency.GetSummary();
+  metrics.processing = fProcessing.GetSummary();
+  metrics.frame_age = fAge.GetSummary();
+}
+
+}  // namespace DELILA
@@ -0,0 +1,480 @@
+/**
+ * @file MetricsExporter.cpp
+ * @brief Embedded OpenMetrics HTTP endpoint implementation
+ */
+
+#include "MetricsExporter.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace DELILA {
+
+namespace {
+
+constexpr int kPollIntervalMs = 200;     // Stop() latency
+constexpr int kRequestTimeoutMs = 1000;  // Slow or idle clients
+constexpr size_t kMaxRequestBytes = 8192;
+
+constexpr ComponentState kAllStates[] = {
+    ComponentState::Idle,     ComponentState::Configuring,
+    ComponentState::Configured, ComponentState::Arming,
+    ComponentState::Armed,    ComponentState::Starting,
+    ComponentState::Running,  ComponentState::Stopping,
+    ComponentState::Error};
+
+void AppendUint(std::string &out, uint64_t value) {
+  char buf[24];
+  int n = std::snprintf(buf, sizeof(buf), "%" PRIu64, value);
+  out.append(buf, static_cast<size_t>(n));
+}
+
+void AppendDouble(std::string &out, double value) {
+  if (std::isnan(value)) {
+    out += "NaN";
+  } else if (std::isinf(value)) {
+    out += value > 0 ? "+Inf" : "-Inf";
+  } else {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.10g", value);
+    out.append(buf, static_cast<size_t>(n));
+  }
+}
+
+// Label values escape backslash, double quote and newline
+void AppendLabelValue(std::string &out, const std::string &value) {
+  for (char c : value) {
+    if (c == '\\') {
+      out += "\\\\";
+    } else if (c == '"') {
+      out += "\\\"";
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+}
+
+// HELP text escapes backslash and newline (OpenMetrics)
+void AppendHelp(std::string &out, const std::string &help) {
+  for (char c : help) {
+    if (c == '\\') {
+      out += "\\\\";
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+}
+
+// Writes metric families sharing the component="<id>" label
+class OpenMetricsWriter {
+public:
+  OpenMetricsWriter(std::string &out, const std::string &componentId)
+      : fOut(out) {
+    fLabels = "{component=\"";
+    AppendLabelValue(fLabels, componentId);
+    fLabels += '"';
+  }
+
+  void Family(const char *name, const char *type, const std::string &help,
+              const char *unit = nullptr) {
+    fOut += "# TYPE delila_";
+    fOut += name;
+    fOut += ' ';
+    fOut += type;
+    fOut += '\n';
+    if (unit) {
+      fOut += "# UNIT delila_";
+      fOut += name;
+      fOut += ' ';
+      fOut += unit;
+      fOut += '\n';
+    }
+    fOut += "# HELP delila_";
+    fOut += name;
+    fOut += ' ';
+    AppendHelp(fOut, help);
+    fOut += '\n';
+  }
+
+  // Sample name, labels (component plus optional extra pairs), no value
+  void Begin(const char *name, const char *suffix = "",
+             const char *extra = nullptr) {
+    fOut += "delila_";
+    fOut += name;
+    fOut += suffix;
+    fOut += fLabels;
+    if (extra) {
+      fOut += ',';
+      fOut += extra;
+    }
+    fOut += "} ";
+  }
+
+  void Counter(const char *name, const std::string &help, uint64_t value) {
+    Family(name, "counter", help);
+    Begin(name, "_total");
+    AppendUint(fOut, value);
+    fOut += '\n';
+  }
+
+  void Gauge(const char *name, const std::string &help, double value,
+             const char *unit = nullptr) {
+    Family(name, "gauge", help, unit);
+    Begin(name);
+    AppendDouble(fOut, value);
+    fOut += '\n';
+  }
+
+  std::string &Out() { return fOut; }
+
+private:
+  std::string &fOut;
+  std::string fLabels;
+};
+
+void AppendLatency(OpenMetricsWriter &writer, const char *stage,
+                   const LatencySummary &summary) {
+  std::string &out = writer.Out();
+  const struct {
+    const char *quantile;
+    double us;
+  } points[] = {{"0.5", summary.p50_us},
+                {"0.99", summary.p99_us},
+                {"0.999", summary.p999_us}};
+
+  char labels[64];
+  for (const auto &point : points) {
+    std::snprintf(labels, sizeof(labels), "stage=\"%s\",quantile=\"%s\"",
+                  stage, point.quantile);
+    writer.Begin("frame_latency_seconds", "", labels);
+    AppendDouble(out, point.us * 1e-6);
+    out += '\n';
+  }
+  std::snprintf(labels, sizeof(labels), "stage=\"%s\"", stage);
+  writer.Begin("frame_latency_seconds", "_count", labels);
+  AppendUint(out, summary.count);
+  out += '\n';
+}
+
+void AppendLatencyMax(OpenMetricsWriter &writer, const char *stage,
+                      const LatencySummary &summary) {
+  char labels[32];
+  std::snprintf(labels, sizeof(labels), "stage=\"%s\"", stage);
+  writer.Begin("frame_latency_max_seconds", "", labels);
+  AppendDouble(writer.Out(), summary.max_us * 1e-6);
+  writer.Out() += '\n';
+}
+
+bool ParseAddress(const std::string &address, sockaddr_in &addr) {
+  std::string host;
+  std::string port = address;
+  auto colon = address.rfind(':');
+  if (colon != std::string::npos) {
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+  }
+
+  char *end = nullptr;
+  errno = 0;
+  unsigned long value = std::strtoul(port.c_str(), &end, 10);
+  if (port.empty() || *end != '\0' || errno != 0 || value > 65535) {
+    return false;
+  }
+
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(value));
+
+  if (host.empty() || host == "*" || host == "0.0.0.0") {
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    return true;
+  }
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) == 1) {
+    return true;
+  }
+
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *result = nullptr;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+    return false;
+  }
+  addr.sin_addr = reinterpret_cast<sockaddr_in *>(result->ai_addr)->sin_addr;
+  freeaddrinfo(result);
+  return true;
+}
+
+bool SendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(const IComponent &component)
+    : fComponent(component) {}
+
+MetricsExporter::~MetricsExporter() { Stop(); }
+
+// === Extra metrics ===
+
+void MetricsExporter::AddCounter(const std::string &name,
+                                 const std::string &help,
+                                 std::function<uint64_t()> read) {
+  fExtras.push_back(ExtraMetric{name, help, std::move(read), nullptr});
+}
+
+void MetricsExporter::AddGauge(const std::string &name,
+                               const std::string &help,
+                               std::function<double()> read) {
+  fExtras.push_back(ExtraMetric{name, help, nullptr, std::move(read)});
+}
+
+// === Server ===
+
+bool MetricsExporter::Start(const std::string &address) {
+  if (fRunning) {
+    return false;
+  }
+
+  sockaddr_in addr;
+  if (!ParseAddress(address, addr)) {
+    return false;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  socklen_t len = sizeof(addr);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, 16) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+    close(fd);
+    return false;
+  }
+
+  fListenFd = fd;
+  fPort = ntohs(addr.sin_port);
+  fRunning = true;
+  fThread = std::make_unique<std::thread>(&MetricsExporter::ServeLoop, this);
+  return true;
+}
+
+void MetricsExporter::Stop() {
+  fRunning = false;
+  if (fThread && fThread->joinable()) {
+    fThread->join();
+  }
+  fThread.reset();
+
+  if (fListenFd >= 0) {
+    close(fListenFd);
+    fListenFd = -1;
+  }
+  fPort = 0;
+}
+
+void MetricsExporter::ServeLoop() {
+  // Sized for a typical response once, then reused
+  fBody.reserve(8192);
+  fResponse.reserve(8192);
+
+  pollfd pfd{fListenFd, POLLIN, 0};
+  while (fRunning) {
+    if (poll(&pfd, 1, kPollIntervalMs) <= 0 || !(pfd.revents & POLLIN)) {
+      continue;
+    }
+    int client = accept4(fListenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      continue;
+    }
+    HandleConnection(client);
+    close(client);
+  }
+}
+
+void MetricsExporter::HandleConnection(int fd) {
+  timeval timeout{kRequestTimeoutMs / 1000, (kRequestTimeoutMs % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  // Only the request line matters; read until the end of the headers
+  char request[kMaxRequestBytes];
+  size_t received = 0;
+  while (received < sizeof(request) - 1) {
+    ssize_t n = recv(fd, request + received, sizeof(request) - 1 - received, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    received += static_cast<size_t>(n);
+    request[received] = '\0';
+    if (std::strstr(request, "\r\n\r\n") || std::strstr(request, "\n\n")) {
+      break;
+    }
+  }
+  request[received] = '\0';
+
+  const char *status = "200 OK";
+  const char *contentType = kContentType;
+  const char *path = std::strchr(request, ' ');
+  if (std::strncmp(request, "GET ", 4) != 0) {
+    status = "405 Method Not Allowed";
+  } else if (!path || (std::strncmp(path, " /metrics ", 10) != 0 &&
+                       std::strncmp(path, " /metrics?", 10) != 0)) {
+    status = "404 Not Found";
+  }
+
+  if (std::strcmp(status, "200 OK") == 0) {
+    Render(fBody);
+  } else {
+    fBody = status;
+    fBody += '\n';
+    contentType = "text/plain; charset=utf-8";
+  }
+
+  fResponse = "HTTP/1.1 ";
+  fResponse += status;
+  fResponse += "\r\nContent-Type: ";
+  fResponse += contentType;
+  fResponse += "\r\nContent-Length: ";
+  AppendUint(fResponse, fBody.size());
+  fResponse += "\r\nConnection: close\r\n\r\n";
+  fResponse += fBody;
+  SendAll(fd, fResponse);
+}
+
+// === Rendering ===
+
+void MetricsExporter::Render(std::string &out) const {
+  const ComponentStatus status = fComponent.GetStatus();
+  const ComponentMetrics &m = status.metrics;
+
+  out.clear();
+  OpenMetricsWriter writer(out, status.component_id);
+
+  writer.Family("state", "stateset", "Current component state");
+  for (ComponentState state : kAllStates) {
+    std::string label = "delila_state=\"" + ComponentStateToString(state) + '"';
+    writer.Begin("state", "", label.c_str());
+    out += state == status.state ? "1\n" : "0\n";
+  }
+
+  writer.Gauge("run_number", "Current run number (0 if not running)",
+               status.run_number);
+  writer.Counter("events_processed", "Events processed this run",
+                 m.events_processed);
+  writer.Counter("bytes_transferred", "Bytes sent or written this run",
+                 m.bytes_transferred);
+  writer.Gauge("queue_size", "Items waiting in the component queue",
+               m.queue_size);
+  writer.Gauge("queue_max", "Component queue capacity", m.queue_max);
+  writer.Gauge("event_rate", "Events per second (EWMA, ~2 s)", m.event_rate);
+  writer.Gauge("data_rate", "Data rate in MB/s (EWMA, ~2 s)", m.data_rate);
+  writer.Gauge("event_rate_avg", "Events per second over the last ~10 s",
+               m.event_rate_avg);
+  writer.Gauge("data_rate_avg", "Data rate in MB/s over the last ~10 s",
+               m.data_rate_avg);
+  writer.Gauge("drain_latency_seconds", "Mean queue wait before send",
+               m.drain_latency_us * 1e-6, "seconds");
+  writer.Gauge("sampling_fraction", "Fraction of events analysed (1 = all)",
+               m.sampling_fraction);
+
+  writer.Family("frame_latency_seconds", "summary",
+                "Per-frame latency of a sample of frames, by stage",
+                "seconds");
+  AppendLatency(writer, "residency", m.residency);
+  AppendLatency(writer, "processing", m.processing);
+  AppendLatency(writer, "frame_age", m.frame_age);
+
+  writer.Family("frame_latency_max_seconds", "gauge",
+                "Largest per-frame latency this run, by stage", "seconds");
+  AppendLatencyMax(writer, "residency", m.residency);
+  AppendLatencyMax(writer, "processing", m.processing);
+  AppendLatencyMax(writer, "frame_age", m.frame_age);
+
+  if (!m.channel_rates.empty()) {
+    writer.Family("channel_event_rate", "gauge",
+                  "Events per second by module and channel (EWMA, ~2 s)");
+    char labels[48];
+    for (const auto &rate : m.channel_rates) {
+      std::snprintf(labels, sizeof(labels), "module=\"%u\",channel=\"%u\"",
+                    static_cast<unsigned>(rate.module),
+                    static_cast<unsigned>(rate.channel));
+      writer.Begin("channel_event_rate", "", labels);
+      AppendDouble(out, rate.event_rate);
+      out += '\n';
+    }
+  }
+
+  for (const auto &extra : fExtras) {
+    if (extra.counter) {
+      writer.Counter(extra.name.c_str(), extra.help, extra.counter());
+    } else {
+      writer.Gauge(extra.name.c_str(), extra.help, extra.gauge());
+    }
+  }
+
+  out += "# EOF\n";
+}
+
+// === MetricsEndpoint ===
+
+MetricsExporter *MetricsEndpoint::Prepare(const IComponent &component) {
+  if (fAddress.empty() || IsRunning()) {
+    return nullptr;
+  }
+  fExporter = std::make_unique<MetricsExporter>(component);
+  return fExporter.get();
+}
+
+bool MetricsEndpoint::Start() {
+  if (IsRunning()) {
+    return false;
+  }
+  if (!fExporter || !fExporter->Start(fAddress)) {
+    fExporter.reset();
+    return false;
+  }
+  return true;
+}
+
+void MetricsEndpoint::Stop() {
+  if (fExporter) {
+    fExporter->Stop();
+    fExporter.reset();
+  }
+}
+
+} // namespace DELILA
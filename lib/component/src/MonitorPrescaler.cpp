@@ -0,0 +1,101 @@
+/**
+ * @file MonitorPrescaler.cpp
+ * @brief Adaptive frame sampling implementation
+ */
+
+#include "MonitorPrescaler.hpp"
+
+#include <algorithm>
+
+namespace DELILA {
+
+MonitorPrescaler::MonitorPrescaler() : MonitorPrescaler(Config()) {}
+
+MonitorPrescaler::MonitorPrescaler(const Config& config) : fConfig(config) {}
+
+void MonitorPrescaler::SetConfig(const Config& config) {
+  fConfig = config;
+  Reset();
+}
+
+void MonitorPrescaler::Reset() {
+  fTargetFraction = 1.0;
+  fLagMs = 0.0;
+  fBaselineNs = 0;
+  fHasBaseline = false;
+  fNextControlNs = 0;
+  fEventsSeen = 0;
+  fEventsAdmitted = 0;
+}
+
+bool MonitorPrescaler::Admit(const Frame& frame) {
+  fEventsSeen += frame.event_count;
+
+  bool admit = true;
+  if (fConfig.enabled) {
+    UpdateTarget(frame);
+    admit = fTargetFraction >= 1.0 || Draw();
+  }
+
+  if (admit) {
+    fEventsAdmitted += frame.event_count;
+  }
+  return admit;
+}
+
+double MonitorPrescaler::GetSamplingFraction() const {
+  if (fEventsSeen == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(fEventsAdmitted) /
+         static_cast<double>(fEventsSeen);
+}
+
+uint64_t MonitorPrescaler::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void MonitorPrescaler::UpdateTarget(const Frame& frame) {
+  // Lag relative to the fastest frame seen: removes clock offset between
+  // the sender's host and ours, leaving only the backlog
+  int64_t rawLag = static_cast<int64_t>(frame.receive_time_ns) -
+                   static_cast<int64_t>(frame.header_timestamp_ns);
+  if (!fHasBaseline || rawLag < fBaselineNs) {
+    fBaselineNs = rawLag;
+    fHasBaseline = true;
+  }
+  fLagMs = static_cast<double>(rawLag - fBaselineNs) / 1e6;
+
+  if (frame.receive_time_ns < fNextControlNs) {
+    return;
+  }
+  fNextControlNs = frame.receive_time_ns +
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       fConfig.control_interval)
+                       .count();
+
+  bool overloaded = fLagMs > fConfig.lag_high_ms ||
+                    frame.pending_bytes > fConfig.queue_high_bytes;
+  bool relaxed = fLagMs < fConfig.lag_low_ms &&
+                 frame.pending_bytes < fConfig.queue_high_bytes / 4;
+
+  if (overloaded) {
+    fTargetFraction = std::max(fConfig.min_fraction, fTargetFraction * 0.5);
+  } else if (relaxed) {
+    fTargetFraction = std::min(1.0, fTargetFraction * 1.25);
+  }
+}
+
+bool MonitorPrescaler::Draw() {
+  // xorshift64*: cheap and good enough to decorrelate from source order
+  fRandomState ^= fRandomState >> 12;
+  fRandomState ^= fRandomState << 25;
+  fRandomState ^= fRandomState >> 27;
+  uint64_t r = fRandomState * 0x2545F4914F6CDD1DULL;
+  return static_cast<double>(r >> 11) * (1.0 / 9007199254740992.0) <
+         fTargetFraction;
+}
+
+}  // namespace DELILA
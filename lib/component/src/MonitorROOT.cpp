@@ -4,6 +4,7 @@
  */
 
 #include "MonitorROOT.hpp"
+#include "MetricsExporter.hpp"
 
 #include <DataProcessor.hpp>
 #include <ZMQTransport.hpp>
@@ -19,10 +20,31 @@
 #include <THttpServer.h>
 #include <TROOT.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 
 namespace DELILA {
 
+namespace {
+
+/// Add a shard's counts for @p h to @p hist, touching only non-empty bins
+void AddShardBins(TH1* hist, const HistogramShard& shard,
+                  HistogramShard::Histogram h) {
+  if (!hist || shard.Entries(h) == 0) {
+    return;
+  }
+  const auto& bins = shard.Bins(h);
+  for (size_t bin = 0; bin < bins.size(); ++bin) {
+    if (bins[bin] != 0) {
+      hist->AddBinContent(static_cast<int>(bin), bins[bin]);
+    }
+  }
+  hist->SetEntries(hist->GetEntries() + static_cast<double>(shard.Entries(h)));
+}
+
+}  // namespace
+
 MonitorROOT::MonitorROOT()
     : fTransport(std::make_unique<Net::ZMQTransport>()),
       fDataProcessor(std::make_unique<Net::DataProcessor>()) {
@@ -92,6 +114,7 @@ void MonitorROOT::Shutdown() {
 
   // Stop command listener first
   StopCommandListener();
+  StopMetricsExporter();
 
   // Stop receive thread
   if (fReceiveThread && fReceiveThread->joinable()) {
@@ -127,6 +150,9 @@ ComponentStatus MonitorROOT::GetStatus() const {
   status.run_number = fRunNumber.load();
   status.metrics.events_processed = fEventsProcessed.load();
   status.metrics.bytes_transferred = fBytesTransferred.load();
+  status.metrics.sampling_fraction = fSamplingFraction.load();
+  fRates.Fill(status.metrics.events_processed,
+              status.metrics.bytes_transferred, status.metrics);
   status.error_message = fErrorMessage;
   status.heartbeat_counter = fHeartbeatCounter.load();
   return status;
@@ -196,6 +222,33 @@ void MonitorROOT::StopCommandListener() {
   }
 }
 
+// === Metrics endpoint ===
+
+void MonitorROOT::SetMetricsAddress(const std::string& address) {
+  fMetrics.SetAddress(address);
+}
+
+std::string MonitorROOT::GetMetricsAddress() const {
+  return fMetrics.GetAddress();
+}
+
+bool MonitorROOT::StartMetricsExporter() {
+  MetricsExporter* exporter = fMetrics.Prepare(*this);
+  if (!exporter) {
+    return false;
+  }
+  exporter->AddGauge("frame_queue_bytes",
+                     "Bytes waiting for the decode workers",
+                     [this] {
+                       return static_cast<double>(fQueuedBytes.load());
+                     });
+  return fMetrics.Start();
+}
+
+void MonitorROOT::StopMetricsExporter() {
+  fMetrics.Stop();
+}
+
 // === Public control methods ===
 
 bool MonitorROOT::Arm() { return OnArm(); }
@@ -218,6 +271,12 @@ void MonitorROOT::SetUpdateInterval(uint32_t ms) { fUpdateInterval = ms; }
 
 uint32_t MonitorROOT::GetUpdateInterval() const { return fUpdateInterval; }
 
+void MonitorROOT::SetWorkerThreads(uint32_t count) {
+  fWorkerThreads = std::max<uint32_t>(1, count);
+}
+
+uint32_t MonitorROOT::GetWorkerThreads() const { return fWorkerThreads; }
+
 // === Histogram configuration ===
 
 void MonitorROOT::EnableEnergyHistogram(bool enable) {
@@ -259,6 +318,28 @@ std::pair<uint8_t, uint8_t> MonitorROOT::GetWaveformChannel() const {
   return {fWaveformModule, fWaveformChannel};
 }
 
+// === Overload handling ===
+
+void MonitorROOT::EnablePrescaling(bool enable) {
+  fPrescalerConfig.enabled = enable;
+}
+
+bool MonitorROOT::IsPrescalingEnabled() const {
+  return fPrescalerConfig.enabled;
+}
+
+void MonitorROOT::SetPrescalerConfig(const MonitorPrescaler::Config& config) {
+  fPrescalerConfig = config;
+}
+
+MonitorPrescaler::Config MonitorROOT::GetPrescalerConfig() const {
+  return fPrescalerConfig;
+}
+
+double MonitorROOT::GetSamplingFraction() const {
+  return fSamplingFraction.load();
+}
+
 // === Testing utilities ===
 
 void MonitorROOT::ForceError(const std::string& message) {
@@ -303,10 +384,13 @@ bool MonitorROOT::OnStart(uint32_t run_number) {
   fRunNumber = run_number;
   fEventsProcessed = 0;
   fBytesTransferred = 0;
-  fPreviousTimestamp = 0.0;
+  fRates.Reset();
+  fPrescaler.SetConfig(fPrescalerConfig);
+  fSamplingFraction = 1.0;
   fRunning = true;
 
-  // Reset histograms for new run
+  // One fill shard per decode worker, then reset histograms for new run
+  CreateShards();
   ResetHistograms();
 
   // Start receive thread
@@ -326,16 +410,20 @@ bool MonitorROOT::OnStop(bool graceful) {
 
   fRunning = false;
 
-  if (graceful) {
-    // Wait for receive thread to finish
-    if (fReceiveThread && fReceiveThread->joinable()) {
-      fReceiveThread->join();
-    }
-  } else {
-    // Emergency stop - detach thread
-    if (fReceiveThread) {
-      fReceiveThread->detach();
+  if (!graceful) {
+    // Emergency stop - drop queued frames so the workers finish at once
+    {
+      std::lock_guard<std::mutex> queueLock(fFrameQueueMutex);
+      fFrameQueue.clear();
+      fQueuedBytes = 0;
     }
+    fFrameQueueNotFull.notify_all();
+  }
+
+  // Join either way: the receive thread and its workers use the shards,
+  // which the next Start() rebuilds
+  if (fReceiveThread && fReceiveThread->joinable()) {
+    fReceiveThread->join();
   }
   fReceiveThread.reset();
 
@@ -360,7 +448,7 @@ void MonitorROOT::OnReset() {
   fRunNumber = 0;
   fEventsProcessed = 0;
   fBytesTransferred = 0;
-  fPreviousTimestamp = 0.0;
+  fSamplingFraction = 1.0;
 
   // Disconnect transport
   if (fTransport) {
@@ -385,6 +473,30 @@ bool MonitorROOT::TransitionTo(ComponentState newState) {
 }
 
 void MonitorROOT::ReceiveLoop() {
+  {
+    std::lock_guard<std::mutex> lock(fFrameQueueMutex);
+    fFrameQueue.clear();
+    fQueuedBytes = 0;
+    fReceiveDone = false;
+    fNextOrdinal = 0;
+  }
+  {
+    std::lock_guard<std::mutex> lock(fSpanMutex);
+    fPendingSpans.clear();
+    fNextSpan = 0;
+    fLastTimestamp = 0.0;
+  }
+  fFoldRequested = false;
+
+  // One decode/fill worker per shard
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < fShards.size(); ++i) {
+    workers.emplace_back(&MonitorROOT::DecodeWorker, this, i);
+  }
+
+  auto interval = std::chrono::milliseconds(fUpdateInterval);
+  auto lastFold = std::chrono::steady_clock::now();
+
   while (fRunning) {
     // Receive raw bytes from transport
     auto data = fTransport->ReceiveBytes();
@@ -396,117 +508,172 @@ void MonitorROOT::ReceiveLoop() {
 
     if (!data || data->empty()) {
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
-      continue;
+    } else if (fDataProcessor->IsEOSMessage(*data)) {
+      break;
+    } else {
+      // Channel rates count every frame, prescaled or not
+      fRates.CountFrame(*data);
+      if (!AdmitFrame(*data)) {
+        // Skipped by the prescaler: only the header was read
+        fBytesTransferred += data->size();
+      } else {
+        EnqueueFrame(std::move(data));
+      }
     }
 
-    // Check for EOS message
-    if (fDataProcessor->IsEOSMessage(*data)) {
-      break;
+    auto now = std::chrono::steady_clock::now();
+    if (fFoldRequested.exchange(false) || now - lastFold >= interval) {
+      FoldShards();
+      lastFold = now;
     }
+  }
+
+  // Let the workers finish what was already received, then publish
+  {
+    std::lock_guard<std::mutex> lock(fFrameQueueMutex);
+    fReceiveDone = true;
+  }
+  fFrameQueueNotEmpty.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  FoldShards();
+}
+
+void MonitorROOT::DecodeWorker(size_t index) {
+  Net::DataProcessor processor;
+  FillShard& shard = *fShards[index];
+  uint64_t ordinal = 0;
+
+  while (auto data = DequeueFrame(ordinal)) {
+    Net::BinaryDataHeader header;
+    bool peeked = Net::DataProcessor::PeekHeader(*data, header);
 
-    // Try to decode as MinimalEventData first
-    auto [minimalEvents, minimalSeq] = fDataProcessor->DecodeMinimal(data);
-
-    if (minimalEvents && !minimalEvents->empty()) {
-      std::lock_guard<std::mutex> lock(fHistMutex);
-
-      for (const auto& event : *minimalEvents) {
-        // Fill energy histogram
-        if (fHEnergy && fEnableEnergyHist) {
-          fHEnergy->Fill(event->energy);
-        }
-
-        // Fill channel histogram
-        if (fHChannel && fEnableChannelHist) {
-          fHChannel->Fill(event->channel);
-        }
-
-        // Fill module histogram
-        if (fHModule) {
-          fHModule->Fill(event->module);
-        }
-
-        // Fill timing histogram
-        if (fHTimeDiff && fEnableTimingHist) {
-          if (fPreviousTimestamp > 0) {
-            double timeDiff =
-                (event->timeStampNs - fPreviousTimestamp) / 1000.0;  // us
-            fHTimeDiff->Fill(timeDiff);
-          }
-          fPreviousTimestamp = event->timeStampNs;
-        }
-
-        // Fill 2D histogram
-        if (fHEnergyVsChannel && fEnable2DHist) {
-          fHEnergyVsChannel->Fill(event->channel, event->energy);
-        }
-        if (fHEnergyVsModule && fEnable2DHist) {
-          fHEnergyVsModule->Fill(event->module, event->energy);
-        }
-
-        fEventsProcessed++;
+    size_t eventCount = 0;
+    bool needsFold = false;
+    FrameSpan span;
+
+    // Decode once, with the decoder the header asks for. Time differences
+    // are taken within the frame only; see FillFrameBoundaries()
+    auto fill = [&](const auto& events) {
+      if (!events || events->empty()) {
+        return;
+      }
+      span.filled = true;
+      span.first = events->front()->timeStampNs;
+      span.last = events->back()->timeStampNs;
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.hist.BreakTimeSequence();
+      shard.hist.Fill(*events);
+      needsFold = shard.hist.NeedsFold();
+      eventCount = events->size();
+    };
+    switch (peeked ? header.format_version : 0) {
+      case Net::FORMAT_VERSION_MINIMAL_EVENTDATA: {
+        auto [events, sequence] = processor.DecodeMinimal(data);
+        fill(events);
+        break;
       }
+      case Net::FORMAT_VERSION_EVENTDATA:
+      case Net::FORMAT_VERSION_COMPACT_EVENTDATA: {
+        auto [events, sequence] = processor.Decode(data);
+        fill(events);
+        break;
+      }
+      default:
+        // Unknown format - drop the frame
+        break;
+    }
+
+    if (fEnableTimingHist) {
+      FillFrameBoundaries(ordinal, span, shard);
+    }
+    if (eventCount > 0) {
+      fEventsProcessed += eventCount;
       fBytesTransferred += data->size();
-      continue;
     }
+    if (needsFold) {
+      fFoldRequested = true;
+    }
+  }
+}
 
-    // Try to decode as full EventData
-    auto [fullEvents, fullSeq] = fDataProcessor->Decode(data);
-
-    if (fullEvents && !fullEvents->empty()) {
-      std::lock_guard<std::mutex> lock(fHistMutex);
-
-      for (const auto& event : *fullEvents) {
-        // Fill energy histogram
-        if (fHEnergy && fEnableEnergyHist) {
-          fHEnergy->Fill(event->energy);
-        }
-
-        // Fill channel histogram
-        if (fHChannel && fEnableChannelHist) {
-          fHChannel->Fill(event->channel);
-        }
-
-        // Fill module histogram
-        if (fHModule) {
-          fHModule->Fill(event->module);
-        }
-
-        // Fill timing histogram
-        if (fHTimeDiff && fEnableTimingHist) {
-          if (fPreviousTimestamp > 0) {
-            double timeDiff =
-                (event->timeStampNs - fPreviousTimestamp) / 1000.0;  // us
-            fHTimeDiff->Fill(timeDiff);
-          }
-          fPreviousTimestamp = event->timeStampNs;
-        }
-
-        // Fill 2D histogram
-        if (fHEnergyVsChannel && fEnable2DHist) {
-          fHEnergyVsChannel->Fill(event->channel, event->energy);
-        }
-        if (fHEnergyVsModule && fEnable2DHist) {
-          fHEnergyVsModule->Fill(event->module, event->energy);
-        }
-
-        // Update waveform if enabled and matching channel
-        if (fGWaveform && fEnableWaveform && event->module == fWaveformModule &&
-            event->channel == fWaveformChannel && event->waveformSize > 0) {
-          fGWaveform->Set(event->waveformSize);
-          for (size_t i = 0; i < event->waveformSize; ++i) {
-            fGWaveform->SetPoint(i, static_cast<double>(i),
-                                 static_cast<double>(event->analogProbe1[i]));
-          }
-        }
-
-        fEventsProcessed++;
+void MonitorROOT::FillFrameBoundaries(uint64_t ordinal,
+                                      const FrameSpan& span,
+                                      FillShard& shard) {
+  // Every dequeued frame reports its span, empty or not, so the join
+  // below never waits for a frame that will not come
+  std::vector<std::pair<double, double>> boundaries;
+  {
+    std::lock_guard<std::mutex> lock(fSpanMutex);
+    fPendingSpans.emplace(ordinal, span);
+    auto it = fPendingSpans.begin();
+    while (it != fPendingSpans.end() && it->first == fNextSpan) {
+      if (it->second.filled) {
+        boundaries.emplace_back(fLastTimestamp, it->second.first);
+        fLastTimestamp = it->second.last;
       }
-      fBytesTransferred += data->size();
+      it = fPendingSpans.erase(it);
+      ++fNextSpan;
+    }
+  }
+
+  if (!boundaries.empty()) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& [previous, current] : boundaries) {
+      shard.hist.FillTimeDifference(previous, current);
     }
   }
 }
 
+void MonitorROOT::EnqueueFrame(std::unique_ptr<std::vector<uint8_t>> data) {
+  std::unique_lock<std::mutex> lock(fFrameQueueMutex);
+  while (fFrameQueue.size() >= kMaxQueuedFrames) {
+    if (!fRunning) {
+      return;
+    }
+    fFrameQueueNotFull.wait_for(lock, std::chrono::milliseconds(100));
+  }
+  fQueuedBytes += data->size();
+  fFrameQueue.push_back(std::move(data));
+  lock.unlock();
+  fFrameQueueNotEmpty.notify_one();
+}
+
+std::unique_ptr<std::vector<uint8_t>> MonitorROOT::DequeueFrame(
+    uint64_t& ordinal) {
+  std::unique_lock<std::mutex> lock(fFrameQueueMutex);
+  fFrameQueueNotEmpty.wait(
+      lock, [this]() { return !fFrameQueue.empty() || fReceiveDone; });
+  if (fFrameQueue.empty()) {
+    return nullptr;
+  }
+  auto data = std::move(fFrameQueue.front());
+  fFrameQueue.pop_front();
+  fQueuedBytes -= data->size();
+  ordinal = fNextOrdinal++;
+  lock.unlock();
+  fFrameQueueNotFull.notify_one();
+  return data;
+}
+
+bool MonitorROOT::AdmitFrame(const std::vector<uint8_t>& data) {
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(data, header)) {
+    return true;  // Let the decoder reject it
+  }
+
+  MonitorPrescaler::Frame frame;
+  frame.header_timestamp_ns = header.timestamp;
+  frame.event_count = header.event_count;
+  frame.pending_bytes = fTransport->GetPendingDataBytes() + fQueuedBytes;
+  frame.receive_time_ns = MonitorPrescaler::NowNs();
+
+  bool admitted = fPrescaler.Admit(frame);
+  fSamplingFraction = fPrescaler.GetSamplingFraction();
+  return admitted;
+}
+
 void MonitorROOT::CommandListenerLoop() {
   while (fCommandListenerRunning) {
     auto cmd = fCommandTransport->ReceiveCommand();
@@ -637,6 +804,16 @@ void MonitorROOT::CreateHistograms() {
   }
 }
 
+void MonitorROOT::CreateShards() {
+  std::lock_guard<std::mutex> lock(fHistMutex);
+
+  // Binned like the histograms; rebuilt per run so enable flags apply
+  fShards.clear();
+  for (uint32_t i = 0; i < fWorkerThreads; ++i) {
+    fShards.push_back(std::make_unique<FillShard>(MakeShardLayout()));
+  }
+}
+
 void MonitorROOT::ResetHistograms() {
   std::lock_guard<std::mutex> lock(fHistMutex);
 
@@ -647,6 +824,12 @@ void MonitorROOT::ResetHistograms() {
   if (fHEnergyVsChannel) fHEnergyVsChannel->Reset();
   if (fHEnergyVsModule) fHEnergyVsModule->Reset();
   if (fGWaveform) fGWaveform->Set(0);
+  LabelHistograms(1.0);
+
+  for (auto& shard : fShards) {
+    std::lock_guard<std::mutex> shardLock(shard->mutex);
+    shard->hist.Reset();
+  }
 }
 
 void MonitorROOT::DeleteHistograms() {
@@ -669,6 +852,80 @@ void MonitorROOT::DeleteHistograms() {
   fHEnergyVsModule = nullptr;
   delete fGWaveform;
   fGWaveform = nullptr;
+
+  fShards.clear();
+}
+
+HistogramShard::Layout MonitorROOT::MakeShardLayout() const {
+  HistogramShard::Layout layout;
+  layout.energy = fEnableEnergyHist;
+  layout.channel = fEnableChannelHist;
+  layout.module = true;
+  layout.timing = fEnableTimingHist;
+  layout.two_d = fEnable2DHist;
+  layout.waveform = fEnableWaveform;
+  layout.waveform_module = fWaveformModule;
+  layout.waveform_channel = fWaveformChannel;
+  return layout;
+}
+
+void MonitorROOT::FoldShards() {
+  using Histogram = HistogramShard::Histogram;
+  std::lock_guard<std::mutex> lock(fHistMutex);
+
+  for (auto& shard : fShards) {
+    std::lock_guard<std::mutex> shardLock(shard->mutex);
+    const auto& hist = shard->hist;
+
+    AddShardBins(fHEnergy, hist, Histogram::Energy);
+    AddShardBins(fHChannel, hist, Histogram::Channel);
+    AddShardBins(fHModule, hist, Histogram::Module);
+    AddShardBins(fHTimeDiff, hist, Histogram::TimeDiff);
+    AddShardBins(fHEnergyVsChannel, hist, Histogram::EnergyVsChannel);
+    AddShardBins(fHEnergyVsModule, hist, Histogram::EnergyVsModule);
+
+    if (fGWaveform && hist.HasWaveform()) {
+      const auto& waveform = hist.GetWaveform();
+      fGWaveform->Set(static_cast<int>(waveform.size()));
+      for (size_t i = 0; i < waveform.size(); ++i) {
+        fGWaveform->SetPoint(static_cast<int>(i), static_cast<double>(i),
+                             static_cast<double>(waveform[i]));
+      }
+    }
+
+    shard->hist.ClearCounts();
+  }
+
+  double fraction = fSamplingFraction.load();
+  if (fraction != fLabeledFraction) {
+    LabelHistograms(fraction);
+  }
+}
+
+void MonitorROOT::LabelHistograms(double samplingFraction) {
+  // Called with fHistMutex held
+  char suffix[48] = "";
+  if (samplingFraction < 1.0) {
+    std::snprintf(suffix, sizeof(suffix), " [sampled %.3g%%]",
+                  samplingFraction * 100.0);
+  }
+
+  for (TH1* hist : {static_cast<TH1*>(fHEnergy), static_cast<TH1*>(fHChannel),
+                    static_cast<TH1*>(fHModule), static_cast<TH1*>(fHTimeDiff),
+                    static_cast<TH1*>(fHEnergyVsChannel),
+                    static_cast<TH1*>(fHEnergyVsModule)}) {
+    if (!hist) {
+      continue;
+    }
+    // A title without ';' leaves the axis titles alone
+    std::string title = hist->GetTitle();
+    auto pos = title.find(" [sampled");
+    if (pos != std::string::npos) {
+      title.erase(pos);
+    }
+    hist->SetTitle((title + suffix).c_str());
+  }
+  fLabeledFraction = samplingFraction;
 }
 
 }  // namespace DELILA
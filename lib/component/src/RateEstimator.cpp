@@ -0,0 +1,316 @@
+/**
+ * @file RateEstimator.cpp
+ * @brief Event/data rate estimation implementation
+ */
+
+#include "RateEstimator.hpp"
+
+#include <DataProcessor.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+
+namespace DELILA {
+
+namespace {
+
+constexpr double kBytesPerMB = 1e6;
+
+// Serialized EventData (format version 1): fixed fields, then six
+// { u32 length, samples } arrays. Offsets follow DataProcessor::Serialize.
+using Event = Digitizer::EventData;
+constexpr size_t kModuleOffset = sizeof(Event::timeStampNs) +
+                                 sizeof(Event::waveformSize) +
+                                 sizeof(Event::energy) +
+                                 sizeof(Event::energyShort);
+constexpr size_t kFixedSize =
+    kModuleOffset + sizeof(Event::module) + sizeof(Event::channel) +
+    sizeof(Event::timeResolution) + 6 * sizeof(uint8_t) /* probe types */ +
+    sizeof(Event::downSampleFactor) + sizeof(Event::flags) +
+    sizeof(Event::aMax);
+
+// Compact EventData (format version 5): the same fixed fields, six u32
+// sample counts, then int16 analog samples and one bit per digital sample
+constexpr size_t kCompactCountsSize = 6 * sizeof(uint32_t);
+
+// Serialized MinimalEventData (format version 2): packed 22-byte records
+constexpr size_t kMinimalSize = sizeof(Digitizer::MinimalEventData);
+constexpr size_t kCalibratedSize = sizeof(Digitizer::CalibratedEventData);
+
+double Ewma(double previous, double instant, double alpha) {
+  return previous + alpha * (instant - previous);
+}
+
+} // namespace
+
+RateEstimator::RateEstimator(double timeConstantS, double windowS)
+    : fTimeConstantNs(timeConstantS * 1e9),
+      fWindowNs(static_cast<uint64_t>(windowS * 1e9)) {
+  for (auto &count : fChannelCounts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  for (auto &slot : fModuleSlot) {
+    slot.store(0, std::memory_order_relaxed);
+  }
+  for (auto &module : fSlotModule) {
+    module.store(0, std::memory_order_relaxed);
+  }
+  Reset();
+}
+
+uint64_t RateEstimator::Now() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void RateEstimator::Reset() { Reset(Now()); }
+
+void RateEstimator::Reset(uint64_t nowNs) {
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  for (auto &count : fChannelCounts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  for (auto &slot : fModuleSlot) {
+    slot.store(0, std::memory_order_relaxed);
+  }
+  fSlotsUsed.store(0, std::memory_order_relaxed);
+  fUnmapped.store(0, std::memory_order_relaxed);
+
+  fChannelLast.fill(0);
+  fChannelRate.fill(0.0);
+  fEventRate = fByteRate = fEventRateAvg = fByteRateAvg = 0.0;
+  Rebase(Sample{nowNs, 0, 0});
+}
+
+// === Data path ===
+
+size_t RateEstimator::AssignSlot(uint8_t module) {
+  uint32_t used = fSlotsUsed.load(std::memory_order_relaxed);
+  if (used >= kMaxModules) {
+    return kMaxModules;
+  }
+  // Publish the module before the slot count; Fill() reads in reverse
+  fSlotModule[used].store(module, std::memory_order_relaxed);
+  fModuleSlot[module].store(static_cast<uint8_t>(used + 1),
+                            std::memory_order_relaxed);
+  fSlotsUsed.store(used + 1, std::memory_order_release);
+  return used;
+}
+
+bool RateEstimator::CountFrame(const uint8_t *data, size_t size) {
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(data, size, header) ||
+      header.message_type != Net::MESSAGE_TYPE_DATA ||
+      header.compression_type != Net::COMPRESSION_NONE ||
+      header.header_size > size) {
+    return false;
+  }
+
+  const uint8_t *p = data + header.header_size;
+  const uint8_t *end = data + size;
+
+  if (header.format_version == Net::FORMAT_VERSION_MINIMAL_EVENTDATA) {
+    for (uint32_t i = 0; i < header.event_count; ++i) {
+      if (static_cast<size_t>(end - p) < kMinimalSize) {
+        return false;
+      }
+      // module and channel are the first two bytes of the record
+      CountEvent(p[0], p[1]);
+      p += kMinimalSize;
+    }
+    return true;
+  }
+
+  if (header.format_version == Net::FORMAT_VERSION_CALIBRATED_EVENTDATA) {
+    for (uint32_t i = 0; i < header.event_count; ++i) {
+      if (static_cast<size_t>(end - p) < kCalibratedSize) {
+        return false;
+      }
+      // Same leading module/channel bytes as the minimal record
+      CountEvent(p[0], p[1]);
+      p += kCalibratedSize;
+    }
+    return true;
+  }
+
+  if (header.format_version == Net::FORMAT_VERSION_EVENTDATA) {
+    for (uint32_t i = 0; i < header.event_count; ++i) {
+      if (static_cast<size_t>(end - p) < kFixedSize) {
+        return false;
+      }
+      CountEvent(p[kModuleOffset], p[kModuleOffset + 1]);
+      p += kFixedSize;
+
+      // Skip the waveform arrays (2 x int32, 4 x uint8)
+      for (size_t sampleSize : {4, 4, 1, 1, 1, 1}) {
+        uint32_t length;
+        if (static_cast<size_t>(end - p) < sizeof(length)) {
+          return false;
+        }
+        std::memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        if (static_cast<uint64_t>(length) * sampleSize >
+            static_cast<size_t>(end - p)) {
+          return false;
+        }
+        p += static_cast<size_t>(length) * sampleSize;
+      }
+    }
+    return true;
+  }
+
+  if (header.format_version == Net::FORMAT_VERSION_COMPACT_EVENTDATA) {
+    for (uint32_t i = 0; i < header.event_count; ++i) {
+      if (static_cast<size_t>(end - p) < kFixedSize + kCompactCountsSize) {
+        return false;
+      }
+      CountEvent(p[kModuleOffset], p[kModuleOffset + 1]);
+      p += kFixedSize;
+
+      uint32_t counts[6];
+      std::memcpy(counts, p, sizeof(counts));
+      p += sizeof(counts);
+      uint64_t payload =
+          (static_cast<uint64_t>(counts[0]) + counts[1]) * sizeof(int16_t);
+      for (size_t k = 2; k < 6; ++k) {
+        payload += (static_cast<uint64_t>(counts[k]) + 7) / 8;
+      }
+      if (payload > static_cast<size_t>(end - p)) {
+        return false;
+      }
+      p += payload;
+    }
+    return true;
+  }
+
+  if (header.format_version == Net::FORMAT_VERSION_BUILT_EVENTDATA) {
+    // Rates are per hit, so channel rates match the unbuilt stream
+    for (uint32_t i = 0; i < header.event_count; ++i) {
+      Digitizer::BuiltEventRecordHeader record;
+      if (static_cast<size_t>(end - p) < sizeof(record)) {
+        return false;
+      }
+      std::memcpy(&record, p, sizeof(record));
+      p += sizeof(record);
+      if (static_cast<uint64_t>(record.hitCount) * kMinimalSize >
+          static_cast<size_t>(end - p)) {
+        return false;
+      }
+      for (uint32_t h = 0; h < record.hitCount; ++h) {
+        CountEvent(p[0], p[1]);
+        p += kMinimalSize;
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// === Reader side ===
+
+void RateEstimator::Fill(uint64_t totalEvents, uint64_t totalBytes,
+                         ComponentMetrics &metrics) {
+  Fill(totalEvents, totalBytes, Now(), metrics);
+}
+
+void RateEstimator::Fill(uint64_t totalEvents, uint64_t totalBytes,
+                         uint64_t nowNs, ComponentMetrics &metrics) {
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  UpdateLocked(Sample{nowNs, totalEvents, totalBytes});
+
+  metrics.event_rate = fEventRate;
+  metrics.data_rate = fByteRate / kBytesPerMB;
+  metrics.event_rate_avg = fEventRateAvg;
+  metrics.data_rate_avg = fByteRateAvg / kBytesPerMB;
+
+  metrics.channel_rates.clear();
+  uint32_t used = fSlotsUsed.load(std::memory_order_acquire);
+  for (uint32_t slot = 0; slot < used; ++slot) {
+    uint8_t module = fSlotModule[slot].load(std::memory_order_relaxed);
+    for (size_t channel = 0; channel < kMaxChannels; ++channel) {
+      size_t index = slot * kMaxChannels + channel;
+      if (fChannelLast[index] > 0) {
+        metrics.channel_rates.push_back(ChannelRate{
+            module, static_cast<uint8_t>(channel), fChannelRate[index]});
+      }
+    }
+  }
+}
+
+void RateEstimator::UpdateLocked(const Sample &now) {
+  if (now.events < fLast.events || now.bytes < fLast.bytes ||
+      now.time_ns < fLast.time_ns) {
+    // Totals were reset without Reset(): start over from here
+    Rebase(now);
+    return;
+  }
+
+  const uint64_t dt = now.time_ns - fLast.time_ns;
+  if (dt < kMinSampleIntervalNs) {
+    return;
+  }
+
+  // The first interval after a (re)start seeds the averages directly
+  const double seconds = dt * 1e-9;
+  const double alpha =
+      fHaveRate ? 1.0 - std::exp(-static_cast<double>(dt) / fTimeConstantNs)
+                : 1.0;
+  fHaveRate = true;
+  fEventRate = Ewma(fEventRate, (now.events - fLast.events) / seconds, alpha);
+  fByteRate = Ewma(fByteRate, (now.bytes - fLast.bytes) / seconds, alpha);
+
+  uint32_t used = fSlotsUsed.load(std::memory_order_acquire);
+  for (size_t index = 0; index < used * kMaxChannels; ++index) {
+    uint64_t count = fChannelCounts[index].load(std::memory_order_relaxed);
+    uint64_t delta = count - fChannelLast[index];
+    fChannelRate[index] = Ewma(fChannelRate[index], delta / seconds, alpha);
+    fChannelLast[index] = count;
+  }
+
+  // Window: mean rate since the oldest kept sample no older than the
+  // window (or the previous sample if polling is sparser than that)
+  Sample base = fLast;
+  for (size_t i = 0; i < fWindowSize; ++i) {
+    const Sample &s =
+        fWindow[(fWindowHead + kWindowSlots - fWindowSize + i) % kWindowSlots];
+    if (now.time_ns - s.time_ns <= fWindowNs) {
+      base = s;
+      break;
+    }
+  }
+  const double windowSeconds = (now.time_ns - base.time_ns) * 1e-9;
+  fEventRateAvg = (now.events - base.events) / windowSeconds;
+  fByteRateAvg = (now.bytes - base.bytes) / windowSeconds;
+
+  // Keep samples about window / kWindowSlots apart so the ring spans the
+  // whole window whatever the polling rate
+  const Sample &newest =
+      fWindow[(fWindowHead + kWindowSlots - 1) % kWindowSlots];
+  if (fWindowSize == 0 ||
+      now.time_ns - newest.time_ns >= fWindowNs / kWindowSlots) {
+    fWindow[fWindowHead] = now;
+    fWindowHead = (fWindowHead + 1) % kWindowSlots;
+    if (fWindowSize < kWindowSlots) {
+      ++fWindowSize;
+    }
+  }
+
+  fLast = now;
+}
+
+void RateEstimator::Rebase(const Sample &now) {
+  fLast = now;
+  fHaveRate = false;
+  fWindow[0] = now;
+  fWindowHead = 1;
+  fWindowSize = 1;
+}
+
+} // namespace DELILA
@@ -0,0 +1,135 @@
+#include "RetransmitServer.hpp"
+
+#include <DataProcessor.hpp>
+#include <GapRecovery.hpp>
+#include <ZMQTransport.hpp>
+
+namespace DELILA {
+
+RetransmitServer::RetransmitServer() = default;
+
+RetransmitServer::~RetransmitServer() { Stop(); }
+
+void RetransmitServer::SetCapacity(size_t maxFrames, size_t maxBytes) {
+  std::lock_guard<std::mutex> lock(fSendMutex);
+  fReplay.SetCapacity(maxFrames, maxBytes);
+  UpdateBuffered();
+}
+
+bool RetransmitServer::Start(const std::string &address,
+                             Net::ZMQTransport &output) {
+  if (fRunning || address.empty()) {
+    return false;
+  }
+
+  auto transport = std::make_unique<Net::ZMQTransport>();
+  Net::TransportConfig config;
+  config.data_address = address;
+  config.bind_data = true;
+  config.data_pattern = "PULL";
+  config.status_address = config.data_address;
+  config.command_address = "";
+  if (!transport->Configure(config) || !transport->Connect()) {
+    return false;
+  }
+
+  fRequestTransport = std::move(transport);
+  fOutput = &output;
+  fRunning = true;
+  fThread = std::make_unique<std::thread>(&RetransmitServer::ServeLoop, this);
+  return true;
+}
+
+void RetransmitServer::Stop() {
+  fRunning = false;
+  if (fThread && fThread->joinable()) {
+    fThread->join();
+  }
+  fThread.reset();
+
+  if (fRequestTransport) {
+    fRequestTransport->Disconnect();
+    fRequestTransport.reset();
+  }
+
+  std::lock_guard<std::mutex> lock(fSendMutex);
+  fOutput = nullptr;
+}
+
+void RetransmitServer::Clear() {
+  std::lock_guard<std::mutex> lock(fSendMutex);
+  fReplay.Clear();
+  UpdateBuffered();
+  fRequests = 0;
+  fRetransmitted = 0;
+  fUnavailable = 0;
+}
+
+bool RetransmitServer::Send(std::unique_ptr<std::vector<uint8_t>> &frame) {
+  if (!frame) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(fSendMutex);
+  if (!fOutput) {
+    return false;
+  }
+  // Kept before sending: ZeroMQ takes the buffer even if it drops it
+  fReplay.Store(*frame);
+  UpdateBuffered();
+  return fOutput->SendBytes(frame);
+}
+
+bool RetransmitServer::WaitForSendReady(std::chrono::milliseconds timeout) {
+  std::lock_guard<std::mutex> lock(fSendMutex);
+  return fOutput && fOutput->WaitForSendReady(timeout);
+}
+
+void RetransmitServer::ServeLoop() {
+  while (fRunning) {
+    // Returns after the receive timeout when idle
+    auto request = fRequestTransport->ReceiveBytes();
+    if (request && fRunning) {
+      Serve(*request);
+    }
+  }
+}
+
+void RetransmitServer::Serve(const std::vector<uint8_t> &request) {
+  Net::GapRecovery::Range range;
+  if (!Net::GapRecovery::DecodeRequest(request, range)) {
+    return;
+  }
+  fRequests++;
+
+  std::lock_guard<std::mutex> lock(fSendMutex);
+
+  // Only the newest GetMaxFrames() sequence numbers can still be buffered
+  const uint64_t window = fReplay.GetMaxFrames();
+  if (range.last - range.first >= window) {
+    fUnavailable += range.last - range.first + 1 - window;
+    range.first = range.last - window + 1;
+  }
+
+  for (uint64_t sequence = range.first;; ++sequence) {
+    const auto *frame = fReplay.Find(sequence);
+    if (!frame) {
+      fUnavailable++;
+    } else {
+      auto copy = std::make_unique<std::vector<uint8_t>>(*frame);
+      if (fOutput && fOutput->SendBytes(copy)) {
+        fRetransmitted++;
+      }
+    }
+    if (sequence == range.last) {
+      break;
+    }
+  }
+}
+
+void RetransmitServer::UpdateBuffered() {
+  fBufferedFrames = fReplay.GetFrames();
+  fBufferedBytes = fReplay.GetBytes();
+}
+
+} // namespace DELILA
@@ -0,0 +1,192 @@
+/**
+ * @file RouteTable.cpp
+ * @brief Route range parsing and lookup table construction
+ */
+
+#include "RouteTable.hpp"
+
+#include <stdexcept>
+
+namespace DELILA {
+
+namespace {
+
+constexpr size_t kMaxKeys = 256 * 256;
+
+void Fail(std::string *error, const std::string &reason) {
+  if (error) {
+    *error = reason;
+  }
+}
+
+// Unsigned number up to max, all of text
+bool ParseNumber(const std::string &text, unsigned long max,
+                 unsigned long &value) {
+  if (text.empty() || text[0] == '-' || text[0] == '+') {
+    return false;
+  }
+  try {
+    size_t used = 0;
+    value = std::stoul(text, &used, 0);
+    return used == text.size() && value <= max;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+// "module" or "module:channel"; a bare module covers channels 0-255, so
+// it gives the first or the last key of the module
+bool ParseEndpoint(const std::string &text, bool last, uint16_t &key) {
+  unsigned long module = 0;
+  unsigned long channel = last ? 255 : 0;
+  size_t colon = text.find(':');
+  if (colon == std::string::npos) {
+    if (!ParseNumber(text, 255, module)) {
+      return false;
+    }
+  } else if (!ParseNumber(text.substr(0, colon), 255, module) ||
+             !ParseNumber(text.substr(colon + 1), 255, channel)) {
+    return false;
+  }
+  key = static_cast<uint16_t>((module << 8) | channel);
+  return true;
+}
+
+} // namespace
+
+RouteTable::RouteTable() { Rebuild(); }
+
+bool RouteTable::SetOutputs(size_t count, std::string *error) {
+  if (count == 0 || count > kMaxOutputs) {
+    Fail(error, "number of outputs must be 1 to " +
+                    std::to_string(kMaxOutputs));
+    return false;
+  }
+  for (const auto &range : fRanges) {
+    if (range.output >= count) {
+      Fail(error, "range '" + range.spec + "' needs output " +
+                      std::to_string(range.output) + " of " +
+                      std::to_string(count));
+      return false;
+    }
+  }
+  fOutputs = count;
+  Rebuild();
+  return true;
+}
+
+void RouteTable::SetKey(Key key) {
+  fKey = key;
+  Rebuild();
+}
+
+bool RouteTable::SetTimeSlice(double sliceNs) {
+  if (!(sliceNs > 0.0)) {
+    return false;
+  }
+  fSliceNs = sliceNs;
+  return true;
+}
+
+bool RouteTable::SetFrameBlock(uint32_t frames) {
+  if (frames == 0) {
+    return false;
+  }
+  fFrameBlock = frames;
+  return true;
+}
+
+bool RouteTable::AddRange(const std::string &spec, std::string *error) {
+  size_t equals = spec.find('=');
+  if (equals == std::string::npos) {
+    Fail(error, "expected <first>[-<last>]=<output>");
+    return false;
+  }
+  std::string span = spec.substr(0, equals);
+  size_t dash = span.find('-');
+  std::string firstText = span.substr(0, dash);
+  std::string lastText =
+      dash == std::string::npos ? firstText : span.substr(dash + 1);
+
+  Range range;
+  range.spec = spec;
+  if (!ParseEndpoint(firstText, false, range.first) ||
+      !ParseEndpoint(lastText, true, range.last)) {
+    Fail(error, "expected <module>[:<channel>] at both ends of '" + span +
+                    "'");
+    return false;
+  }
+  if (range.first > range.last) {
+    Fail(error, "range '" + span + "' is reversed");
+    return false;
+  }
+
+  unsigned long output = 0;
+  if (!ParseNumber(spec.substr(equals + 1), kMaxOutputs - 1, output) ||
+      output >= fOutputs) {
+    Fail(error, "output must be 0 to " + std::to_string(fOutputs - 1));
+    return false;
+  }
+  range.output = static_cast<uint8_t>(output);
+
+  fRanges.push_back(range);
+  Rebuild();
+  return true;
+}
+
+void RouteTable::ClearRanges() {
+  fRanges.clear();
+  Rebuild();
+}
+
+std::vector<std::string> RouteTable::GetRanges() const {
+  std::vector<std::string> specs;
+  for (const auto &range : fRanges) {
+    specs.push_back(range.spec);
+  }
+  return specs;
+}
+
+bool RouteTable::ParseKey(const std::string &name, Key &key) {
+  if (name == "module") {
+    key = Key::Module;
+  } else if (name == "channel") {
+    key = Key::Channel;
+  } else if (name == "time") {
+    key = Key::Time;
+  } else if (name == "frame") {
+    key = Key::Frame;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char *RouteTable::KeyName(Key key) {
+  switch (key) {
+  case Key::Module:
+    return "module";
+  case Key::Channel:
+    return "channel";
+  case Key::Time:
+    return "time";
+  case Key::Frame:
+    return "frame";
+  }
+  return "unknown";
+}
+
+void RouteTable::Rebuild() {
+  fTable.resize(kMaxKeys);
+  for (size_t key = 0; key < kMaxKeys; ++key) {
+    size_t value = fKey == Key::Channel ? key : key >> 8;
+    fTable[key] = static_cast<uint8_t>(value % fOutputs);
+  }
+  for (const auto &range : fRanges) {
+    for (size_t key = range.first; key <= range.last; ++key) {
+      fTable[key] = range.output;
+    }
+  }
+}
+
+} // namespace DELILA
@@ -0,0 +1,262 @@
+#include "Router.hpp"
+
+#include <DataProcessor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace DELILA {
+
+Router::Router()
+    : SingleInputStage("Router", RouteTable::kMaxOutputs),
+      fDataProcessor(std::make_unique<Net::DataProcessor>()) {}
+
+Router::~Router() { Shutdown(); }
+
+// === IDataComponent interface ===
+
+void Router::SetOutputAddresses(const std::vector<std::string> &addresses) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  fOutputAddresses = addresses;
+  // Ranges are checked against the outputs; a mismatch fails Initialize
+  fRoutes.SetOutputs(std::clamp<size_t>(addresses.size(), 1,
+                                        RouteTable::kMaxOutputs));
+}
+
+// === Configuration ===
+
+bool Router::SetRouteKey(RouteTable::Key key) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    return false;
+  }
+  fRoutes.SetKey(key);
+  return true;
+}
+
+RouteTable::Key Router::GetRouteKey() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fRoutes.GetKey();
+}
+
+bool Router::SetTimeSlice(double sliceNs) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    return false;
+  }
+  return fRoutes.SetTimeSlice(sliceNs);
+}
+
+double Router::GetTimeSlice() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fRoutes.GetTimeSlice();
+}
+
+bool Router::SetFrameBlock(uint32_t frames) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    return false;
+  }
+  return fRoutes.SetFrameBlock(frames);
+}
+
+uint32_t Router::GetFrameBlock() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fRoutes.GetFrameBlock();
+}
+
+bool Router::AddRange(const std::string &spec, std::string *error) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    if (error) {
+      *error = "cannot change ranges while running";
+    }
+    return false;
+  }
+  return fRoutes.AddRange(spec, error);
+}
+
+void Router::ClearRanges() {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState != ComponentState::Running) {
+    fRoutes.ClearRanges();
+  }
+}
+
+std::vector<std::string> Router::GetRanges() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fRoutes.GetRanges();
+}
+
+std::vector<uint64_t> Router::GetOutputCounts() const {
+  std::lock_guard<std::mutex> lock(fOutputCountsMutex);
+  return fOutputCounts;
+}
+
+uint64_t Router::GetFramesForwarded() const { return fFramesForwarded.load(); }
+
+uint64_t Router::GetFramesSplit() const { return fFramesSplit.load(); }
+
+// === SingleInputStage hooks ===
+
+bool Router::OnInitialize(const std::string &config_path) {
+  if (!fRoutes.SetOutputs(fOutputAddresses.size(), &fErrorMessage)) {
+    return false;
+  }
+  return SingleInputStage::OnInitialize(config_path);
+}
+
+void Router::ResetCounters() {
+  const size_t outputs = fOutputTransports.size();
+  fFramesForwarded = 0;
+  fFramesSplit = 0;
+  fFramesRejected = 0;
+  fFrameCounts.assign(outputs, 0);
+  fFrameEvents.assign(outputs, 0);
+  fSequences.assign(outputs, 0);
+  fFrameNumber = 0;
+  {
+    std::lock_guard<std::mutex> countsLock(fOutputCountsMutex);
+    fOutputCounts.assign(outputs, 0);
+  }
+}
+
+void Router::AddMetrics(MetricsExporter &exporter) {
+  exporter.AddCounter("bytes_received", "Bytes received before routing",
+                      [this] { return fBytesReceived.load(); });
+  exporter.AddCounter("router_frames_forwarded",
+                      "Frames forwarded to one output unchanged",
+                      [this] { return fFramesForwarded.load(); });
+  exporter.AddCounter("router_frames_split",
+                      "Frames split across several outputs",
+                      [this] { return fFramesSplit.load(); });
+  exporter.AddCounter("router_frames_rejected",
+                      "Frames dropped as malformed or corrupted",
+                      [this] { return fFramesRejected.load(); });
+
+  // One counter per output, in output order; the help text is the address
+  for (size_t o = 0; o < fOutputAddresses.size(); ++o) {
+    exporter.AddCounter("router_output_" + std::to_string(o) + "_events",
+                        "Events sent to " + fOutputAddresses[o], [this, o] {
+                          std::lock_guard<std::mutex> lock(fOutputCountsMutex);
+                          return o < fOutputCounts.size() ? fOutputCounts[o]
+                                                          : uint64_t{0};
+                        });
+  }
+}
+
+void Router::ProcessFrame(std::unique_ptr<std::vector<uint8_t>> &data) {
+  RouteFrame(data);
+
+  // Publish this frame's per-output counts
+  {
+    std::lock_guard<std::mutex> lock(fOutputCountsMutex);
+    for (size_t o = 0; o < fFrameCounts.size(); ++o) {
+      fOutputCounts[o] += fFrameCounts[o];
+      fFrameCounts[o] = 0;
+    }
+  }
+}
+
+void Router::RouteFrame(std::unique_ptr<std::vector<uint8_t>> &data) {
+  Net::BinaryDataHeader header;
+  if (fRoutes.GetKey() == RouteTable::Key::Frame) {
+    // Whole frames, numbered in receive order across all outputs
+    if (!Net::DataProcessor::PeekHeader(*data, header) ||
+        header.message_type != Net::MESSAGE_TYPE_DATA ||
+        data->size() < Net::BINARY_DATA_HEADER_SIZE + header.uncompressed_size) {
+      fFramesRejected++;
+      return;
+    }
+    const size_t output = fRoutes.RouteBlock(fFrameNumber);
+    Net::DataProcessor::SetStreamSequence(*data, fFrameNumber++);
+    fFramesForwarded++;
+    SendToOutput(output, data, header.event_count);
+    return;
+  }
+
+  if (!Net::DataProcessor::PeekHeader(*data, header) ||
+      !Net::DataProcessor::ScanRecords(*data, fRecords)) {
+    fFramesRejected++;
+    return;
+  }
+  if (fRecords.empty()) {
+    return;
+  }
+
+  // Route every record and size the per-output frames
+  const size_t count = fRecords.size();
+  const size_t numOutputs = fOutputTransports.size();
+  fRecordOutput.resize(count);
+  fFrameBytes.assign(numOutputs, 0);
+  std::fill(fFrameEvents.begin(), fFrameEvents.end(), 0);
+  const Net::EventRecordRef *records = fRecords.data();
+  uint8_t *outputs = fRecordOutput.data();
+  for (size_t i = 0; i < count; ++i) {
+    outputs[i] = static_cast<uint8_t>(fRoutes.Route(
+        records[i].module, records[i].channel, records[i].timeStampNs));
+    fFrameBytes[outputs[i]] += records[i].size;
+    fFrameEvents[outputs[i]]++;
+  }
+  const uint8_t first = outputs[0];
+  const bool single = fFrameEvents[first] == count;
+
+  if (single) {
+    // Zero-copy: forward the frame with the output's sequence number
+    Net::DataProcessor::SetStreamSequence(*data, fSequences[first]);
+    fFramesForwarded++;
+    SendToOutput(first, data, static_cast<uint32_t>(count));
+    return;
+  }
+
+  // The records are copied into fresh frames with new checksums, so check
+  // the old one first
+  if (header.checksum_type == Net::CHECKSUM_CRC32 &&
+      !Net::DataProcessor::VerifyCRC32(
+          data->data() + Net::BINARY_DATA_HEADER_SIZE,
+          header.uncompressed_size, header.checksum)) {
+    fFramesRejected++;
+    return;
+  }
+
+  std::vector<std::unique_ptr<std::vector<uint8_t>>> split(numOutputs);
+  for (size_t o = 0; o < numOutputs; ++o) {
+    if (fFrameEvents[o] > 0) {
+      split[o] = std::make_unique<std::vector<uint8_t>>();
+      split[o]->reserve(Net::BINARY_DATA_HEADER_SIZE + fFrameBytes[o]);
+      split[o]->resize(Net::BINARY_DATA_HEADER_SIZE);
+    }
+  }
+  const uint8_t *source = data->data();
+  for (size_t i = 0; i < count; ++i) {
+    auto &frame = *split[outputs[i]];
+    frame.insert(frame.end(), source + records[i].offset,
+                 source + records[i].offset + records[i].size);
+  }
+
+  fFramesSplit++;
+  for (size_t o = 0; o < numOutputs; ++o) {
+    auto &frame = split[o];
+    if (!frame ||
+        !fDataProcessor->FinalizeFrame(*frame, header.format_version,
+                                       fFrameEvents[o], fSequences[o])) {
+      continue;
+    }
+    // Keep the source timestamp so frame age stays end-to-end, and the
+    // merger stamp, renumbered like the frame
+    Net::DataProcessor::CopySourceStamps(header, *frame);
+    Net::DataProcessor::SetStreamSequence(*frame, fSequences[o]);
+    SendToOutput(o, frame, fFrameEvents[o]);
+  }
+}
+
+void Router::SendToOutput(size_t output,
+                          std::unique_ptr<std::vector<uint8_t>> &frame,
+                          uint32_t events) {
+  fSequences[output]++;
+  if (SendFrame(output, frame, events)) {
+    fFrameCounts[output] += events;
+  }
+}
+
+}  // namespace DELILA
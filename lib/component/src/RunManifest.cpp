@@ -0,0 +1,273 @@
+/**
+ * @file RunManifest.cpp
+ * @brief Run manifest bookkeeping and JSON storage
+ */
+
+#include "RunManifest.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace DELILA {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void Fail(std::string *error, const std::string &reason) {
+  if (error) {
+    *error = reason;
+  }
+}
+
+bool BySequence(const RunManifest::Block &a, const RunManifest::Block &b) {
+  return a.firstSequence < b.firstSequence;
+}
+
+// Relative to dir when the file lies below it, absolute otherwise
+std::string StoredName(const std::string &file, const fs::path &dir) {
+  fs::path absolute = fs::absolute(file).lexically_normal();
+  fs::path relative = absolute.lexically_relative(dir);
+  if (relative.empty() || *relative.begin() == "..") {
+    return absolute.generic_string();
+  }
+  return relative.generic_string();
+}
+
+} // namespace
+
+size_t RunManifest::AddFile(const std::string &path) {
+  auto it = std::find(fFiles.begin(), fFiles.end(), path);
+  if (it != fFiles.end()) {
+    return static_cast<size_t>(it - fFiles.begin());
+  }
+  fFiles.push_back(path);
+  return fFiles.size() - 1;
+}
+
+void RunManifest::AddFrame(size_t file, uint64_t sequence, uint64_t offset,
+                           uint64_t bytes, uint32_t events, double firstNs,
+                           double lastNs) {
+  if (!fBlocks.empty()) {
+    Block &last = fBlocks.back();
+    if (last.file == file && last.lastSequence + 1 == sequence &&
+        last.offset + last.bytes == offset) {
+      last.lastSequence = sequence;
+      last.bytes += bytes;
+      if (events > 0) {
+        if (last.events == 0) {
+          last.firstNs = firstNs;
+          last.lastNs = lastNs;
+        } else {
+          last.firstNs = std::min(last.firstNs, firstNs);
+          last.lastNs = std::max(last.lastNs, lastNs);
+        }
+      }
+      last.events += events;
+      return;
+    }
+  }
+
+  Block block;
+  block.file = file;
+  block.firstSequence = sequence;
+  block.lastSequence = sequence;
+  block.offset = offset;
+  block.bytes = bytes;
+  block.events = events;
+  block.firstNs = events > 0 ? firstNs : 0.0;
+  block.lastNs = events > 0 ? lastNs : 0.0;
+  fBlocks.push_back(block);
+}
+
+bool RunManifest::Merge(const RunManifest &other, std::string *error) {
+  const bool empty = fFiles.empty() && fBlocks.empty();
+  if (!empty && other.fRunNumber != fRunNumber) {
+    Fail(error, "run " + std::to_string(other.fRunNumber) +
+                    " cannot be merged into run " +
+                    std::to_string(fRunNumber));
+    return false;
+  }
+  if (empty) {
+    fRunNumber = other.fRunNumber;
+  }
+
+  std::vector<size_t> files;
+  for (const auto &file : other.fFiles) {
+    files.push_back(AddFile(file));
+  }
+  for (Block block : other.fBlocks) {
+    block.file = files[block.file];
+    fBlocks.push_back(block);
+  }
+  return true;
+}
+
+void RunManifest::Sort() {
+  std::stable_sort(fBlocks.begin(), fBlocks.end(), BySequence);
+}
+
+void RunManifest::Clear() {
+  fRunNumber = 0;
+  fFiles.clear();
+  fBlocks.clear();
+}
+
+uint64_t RunManifest::GetFrames() const {
+  uint64_t frames = 0;
+  for (const auto &block : fBlocks) {
+    frames += block.Frames();
+  }
+  return frames;
+}
+
+uint64_t RunManifest::GetEvents() const {
+  uint64_t events = 0;
+  for (const auto &block : fBlocks) {
+    events += block.events;
+  }
+  return events;
+}
+
+std::vector<RunManifest::SequenceRange> RunManifest::FindGaps() const {
+  std::vector<Block> blocks = fBlocks;
+  std::stable_sort(blocks.begin(), blocks.end(), BySequence);
+
+  std::vector<SequenceRange> gaps;
+  if (blocks.empty()) {
+    return gaps;
+  }
+  // Highest sequence number held by the blocks so far
+  uint64_t covered = blocks[0].lastSequence;
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    if (blocks[i].firstSequence > covered + 1) {
+      gaps.push_back({covered + 1, blocks[i].firstSequence - 1});
+    }
+    covered = std::max(covered, blocks[i].lastSequence);
+  }
+  return gaps;
+}
+
+std::vector<RunManifest::SequenceRange> RunManifest::FindOverlaps() const {
+  std::vector<Block> blocks = fBlocks;
+  std::stable_sort(blocks.begin(), blocks.end(), BySequence);
+
+  std::vector<SequenceRange> overlaps;
+  if (blocks.empty()) {
+    return overlaps;
+  }
+  uint64_t covered = blocks[0].lastSequence;
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    if (blocks[i].firstSequence <= covered) {
+      overlaps.push_back({blocks[i].firstSequence,
+                          std::min(blocks[i].lastSequence, covered)});
+    }
+    covered = std::max(covered, blocks[i].lastSequence);
+  }
+  return overlaps;
+}
+
+bool RunManifest::Save(const std::string &path, std::string *error) const {
+  fs::path dir = fs::absolute(fs::path(path).parent_path()).lexically_normal();
+
+  nlohmann::json json;
+  json["run_number"] = fRunNumber;
+  json["files"] = nlohmann::json::array();
+  for (const auto &file : fFiles) {
+    json["files"].push_back(StoredName(file, dir));
+  }
+  json["blocks"] = nlohmann::json::array();
+  for (const auto &block : fBlocks) {
+    json["blocks"].push_back({{"file", block.file},
+                              {"first_sequence", block.firstSequence},
+                              {"last_sequence", block.lastSequence},
+                              {"offset", block.offset},
+                              {"bytes", block.bytes},
+                              {"events", block.events},
+                              {"first_ns", block.firstNs},
+                              {"last_ns", block.lastNs}});
+  }
+
+  // Write to a temporary file first so readers never see half a manifest
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary);
+    if (!file.is_open()) {
+      Fail(error, "cannot write " + temporary);
+      return false;
+    }
+    file << json.dump(1) << '\n';
+    if (!file.good()) {
+      Fail(error, "cannot write " + temporary);
+      return false;
+    }
+  }
+  std::error_code ec;
+  fs::rename(temporary, path, ec);
+  if (ec) {
+    Fail(error, "cannot rename " + temporary + ": " + ec.message());
+    return false;
+  }
+  return true;
+}
+
+bool RunManifest::Load(const std::string &path, std::string *error) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    Fail(error, "cannot open " + path);
+    return false;
+  }
+
+  // Build a new manifest so a bad document leaves this one untouched
+  RunManifest manifest;
+  fs::path dir = fs::path(path).parent_path();
+  try {
+    auto json = nlohmann::json::parse(file);
+    manifest.fRunNumber = json.at("run_number").get<uint32_t>();
+    for (const auto &name : json.at("files")) {
+      fs::path stored(name.get<std::string>());
+      manifest.fFiles.push_back(stored.is_relative()
+                                    ? (dir / stored).lexically_normal().string()
+                                    : stored.string());
+    }
+    for (const auto &entry : json.at("blocks")) {
+      Block block;
+      block.file = entry.at("file").get<size_t>();
+      block.firstSequence = entry.at("first_sequence").get<uint64_t>();
+      block.lastSequence = entry.at("last_sequence").get<uint64_t>();
+      block.offset = entry.at("offset").get<uint64_t>();
+      block.bytes = entry.at("bytes").get<uint64_t>();
+      block.events = entry.at("events").get<uint64_t>();
+      block.firstNs = entry.value("first_ns", 0.0);
+      block.lastNs = entry.value("last_ns", 0.0);
+      if (block.file >= manifest.fFiles.size() ||
+          block.lastSequence < block.firstSequence) {
+        Fail(error, path + ": invalid block at sequence " +
+                        std::to_string(block.firstSequence));
+        return false;
+      }
+      manifest.fBlocks.push_back(block);
+    }
+  } catch (const std::exception &e) {
+    Fail(error, path + ": " + e.what());
+    return false;
+  }
+
+  *this = std::move(manifest);
+  return true;
+}
+
+std::string RunManifest::ManifestPathFor(const std::string &dataPath) {
+  std::string base = dataPath;
+  const std::string extension = ".dat";
+  if (base.size() >= extension.size() &&
+      base.compare(base.size() - extension.size(), extension.size(),
+                   extension) == 0) {
+    base.resize(base.size() - extension.size());
+  }
+  return base + ".manifest.json";
+}
+
+} // namespace DELILA
@@ -0,0 +1,153 @@
+/**
+ * @file RunReader.cpp
+ * @brief Sequence-ordered reading of a run over its manifest
+ */
+
+#include "RunReader.hpp"
+
+#include <DataProcessor.hpp>
+
+namespace DELILA {
+
+RunReader::RunReader() = default;
+
+RunReader::~RunReader() { Close(); }
+
+bool RunReader::Open(const RunManifest &manifest, std::string *error) {
+  Close();
+
+  auto overlaps = manifest.FindOverlaps();
+  if (!overlaps.empty()) {
+    if (error) {
+      *error = "sequence numbers " +
+               std::to_string(overlaps.front().firstSequence) + "-" +
+               std::to_string(overlaps.front().lastSequence) +
+               " are held by more than one block";
+    }
+    return false;
+  }
+
+  fManifest = manifest;
+  fManifest.Sort();
+  fFiles.resize(fManifest.GetFiles().size());
+  return true;
+}
+
+void RunReader::Close() {
+  fFiles.clear();
+  fManifest.Clear();
+  fBlock = 0;
+  fInBlock = false;
+  fNextSequence = 0;
+  fPosition = 0;
+  fFramesRead = 0;
+  fBytesRead = 0;
+  fError.clear();
+}
+
+void RunReader::SetTimeRange(double firstNs, double lastNs) {
+  fTimeRange = true;
+  fFirstNs = firstNs;
+  fLastNs = lastNs;
+}
+
+std::unique_ptr<std::vector<uint8_t>> RunReader::Next() {
+  const auto &blocks = fManifest.GetBlocks();
+  while (fError.empty() && fBlock < blocks.size()) {
+    const auto &block = blocks[fBlock];
+    if (!fInBlock) {
+      if (!Selected(block)) {
+        fBlock++;
+        continue;
+      }
+      if (!StartBlock(block)) {
+        return nullptr;
+      }
+    }
+
+    if (fNextSequence > block.lastSequence) {
+      if (fPosition != block.offset + block.bytes) {
+        return Fail("block " + std::to_string(block.firstSequence) + "-" +
+                    std::to_string(block.lastSequence) +
+                    " is shorter than in the manifest");
+      }
+      fInBlock = false;
+      fBlock++;
+      continue;
+    }
+
+    // Header first: it gives the payload size
+    auto &file = *fFiles[block.file];
+    auto frame = std::make_unique<std::vector<uint8_t>>(
+        Net::BINARY_DATA_HEADER_SIZE);
+    Net::BinaryDataHeader header;
+    if (!file.read(reinterpret_cast<char *>(frame->data()),
+                   static_cast<std::streamsize>(frame->size())) ||
+        !Net::DataProcessor::PeekHeader(*frame, header)) {
+      return Fail("no frame header for sequence " +
+                  std::to_string(fNextSequence));
+    }
+    const uint64_t frameSize =
+        Net::BINARY_DATA_HEADER_SIZE + uint64_t{header.uncompressed_size};
+    if (header.sequence_number != fNextSequence ||
+        fPosition + frameSize > block.offset + block.bytes) {
+      return Fail("frame " + std::to_string(header.sequence_number) +
+                  " found where the manifest has " +
+                  std::to_string(fNextSequence));
+    }
+
+    frame->resize(frameSize);
+    if (!file.read(reinterpret_cast<char *>(frame->data()) +
+                       Net::BINARY_DATA_HEADER_SIZE,
+                   static_cast<std::streamsize>(header.uncompressed_size))) {
+      return Fail("frame " + std::to_string(fNextSequence) + " is truncated");
+    }
+
+    fPosition += frameSize;
+    fNextSequence++;
+    fFramesRead++;
+    fBytesRead += frameSize;
+    return frame;
+  }
+  return nullptr;
+}
+
+bool RunReader::Selected(const RunManifest::Block &block) const {
+  if (!fTimeRange) {
+    return true;
+  }
+  return block.events > 0 && block.lastNs >= fFirstNs &&
+         block.firstNs <= fLastNs;
+}
+
+bool RunReader::StartBlock(const RunManifest::Block &block) {
+  auto &file = fFiles[block.file];
+  if (!file) {
+    const std::string &path = fManifest.GetFiles()[block.file];
+    file = std::make_unique<std::ifstream>(path, std::ios::binary);
+    if (!file->is_open()) {
+      Fail("cannot open " + path);
+      return false;
+    }
+  }
+
+  file->clear();
+  file->seekg(static_cast<std::streamoff>(block.offset));
+  if (!file->good()) {
+    Fail("cannot seek to block " + std::to_string(block.firstSequence));
+    return false;
+  }
+
+  fInBlock = true;
+  fNextSequence = block.firstSequence;
+  fPosition = block.offset;
+  return true;
+}
+
+std::unique_ptr<std::vector<uint8_t>> RunReader::Fail(
+    const std::string &reason) {
+  fError = reason;
+  return nullptr;
+}
+
+} // namespace DELILA
@@ -1,7 +1,9 @@
 #include "SimpleMerger.hpp"
+#include "MetricsExporter.hpp"
 
 #include <DataProcessor.hpp>
 #include <EOSTracker.hpp>
+#include <SequenceReorderer.hpp>
 #include <ZMQTransport.hpp>
 #include <delila/core/CommandResponse.hpp>
 #include <delila/core/ErrorCode.hpp>
@@ -37,6 +39,12 @@ bool SimpleMerger::Initialize(const std::string &config_path) {
     return false;
   }
 
+  if (fInputAddresses.size() > kMaxInputs) {
+    fErrorMessage = "Too many input addresses (at most " +
+                    std::to_string(kMaxInputs) + ")";
+    return false;
+  }
+
   // Load configuration from file if provided
   if (!config_path.empty()) {
     // TODO: Load configuration from file
@@ -62,6 +70,15 @@ bool SimpleMerger::Initialize(const std::string &config_path) {
     fInputTransports.push_back(std::move(transport));
   }
 
+  // One sequence tracker per input
+  {
+    std::lock_guard<std::mutex> reorderersLock(fReorderersMutex);
+    fReorderers.clear();
+    for (size_t i = 0; i < fInputAddresses.size(); ++i) {
+      fReorderers.push_back(std::make_unique<Net::SequenceReorderer>());
+    }
+  }
+
   // Create output transport
   fOutputTransport = std::make_unique<Net::ZMQTransport>();
   Net::TransportConfig outputConfig;
@@ -97,6 +114,7 @@ void SimpleMerger::Shutdown() {
 
   // Stop command listener first
   StopCommandListener();
+  StopMetricsExporter();
 
   // Stop worker threads
   for (auto &thread : fReceivingThreads) {
@@ -122,12 +140,11 @@ void SimpleMerger::Shutdown() {
     fOutputTransport->Disconnect();
   }
 
-  // Clear queue
+  // Clear queue and remove the spill file
   {
     std::lock_guard<std::mutex> lock(fQueueMutex);
-    while (!fDataQueue.empty()) {
-      fDataQueue.pop();
-    }
+    fDataQueue.CloseSpill();
+    fDataQueue.Clear();
   }
 
   fState = ComponentState::Idle;
@@ -149,6 +166,9 @@ ComponentStatus SimpleMerger::GetStatus() const {
   status.metrics.bytes_transferred = fBytesTransferred.load();
   status.metrics.queue_size = static_cast<uint32_t>(GetQueueSize());
   status.metrics.queue_max = static_cast<uint32_t>(kMaxQueueSize);
+  fLatency.Fill(status.metrics);
+  fRates.Fill(status.metrics.events_processed,
+              status.metrics.bytes_transferred, status.metrics);
   status.error_message = fErrorMessage;
   status.heartbeat_counter = fHeartbeatCounter.load();
   return status;
@@ -192,7 +212,59 @@ size_t SimpleMerger::GetInputCount() const { return fInputAddresses.size(); }
 
 size_t SimpleMerger::GetQueueSize() const {
   std::lock_guard<std::mutex> lock(fQueueMutex);
-  return fDataQueue.size();
+  return fDataQueue.GetMemorySize();
+}
+
+void SimpleMerger::SetSpillDirectory(const std::string &directory) {
+  fSpillDirectory = directory;
+}
+
+std::string SimpleMerger::GetSpillDirectory() const { return fSpillDirectory; }
+
+void SimpleMerger::SetSpillCapacity(uint64_t bytes) { fSpillCapacity = bytes; }
+
+uint64_t SimpleMerger::GetSpillCapacity() const { return fSpillCapacity; }
+
+size_t SimpleMerger::GetSpilledFrames() const {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  return fDataQueue.GetSpilledFrames();
+}
+
+uint64_t SimpleMerger::GetDroppedFrames() const {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  return fDataQueue.GetDropped();
+}
+
+void SimpleMerger::SetReorderWindow(size_t frames) { fReorderWindow = frames; }
+
+size_t SimpleMerger::GetReorderWindow() const { return fReorderWindow; }
+
+SimpleMerger::InputSequenceStats
+SimpleMerger::GetInputSequenceStats(size_t input) const {
+  InputSequenceStats stats;
+  std::lock_guard<std::mutex> lock(fReorderersMutex);
+  if (input < fReorderers.size()) {
+    const auto &reorderer = *fReorderers[input];
+    stats.received = reorderer.GetReceived();
+    stats.lost = reorderer.GetLost();
+    stats.reordered = reorderer.GetReordered();
+    stats.late = reorderer.GetLate();
+    stats.duplicates = reorderer.GetDuplicates();
+  }
+  return stats;
+}
+
+SimpleMerger::InputSequenceStats SimpleMerger::SumInputSequenceStats() const {
+  InputSequenceStats total;
+  std::lock_guard<std::mutex> lock(fReorderersMutex);
+  for (const auto &reorderer : fReorderers) {
+    total.received += reorderer->GetReceived();
+    total.lost += reorderer->GetLost();
+    total.reordered += reorderer->GetReordered();
+    total.late += reorderer->GetLate();
+    total.duplicates += reorderer->GetDuplicates();
+  }
+  return total;
 }
 
 // === Testing utilities ===
@@ -237,6 +309,20 @@ bool SimpleMerger::OnArm() {
     }
   }
 
+  // Spill mode: the file stays open until reset
+  if (!fSpillDirectory.empty()) {
+    std::lock_guard<std::mutex> queueLock(fQueueMutex);
+    std::string error;
+    if (!fDataQueue.IsSpillOpen() &&
+        !fDataQueue.OpenSpill(
+            SpillBuffer::PathFor(fSpillDirectory, fComponentId),
+            fSpillCapacity, &error)) {
+      fErrorMessage = "Failed to open spill file: " + error;
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
   fState = ComponentState::Armed;
   return true;
 }
@@ -252,13 +338,23 @@ bool SimpleMerger::OnStart(uint32_t run_number) {
   fEventsProcessed = 0;
   fBytesTransferred = 0;
   fEOSReceivedCount = 0;
+  fLatency.Reset();
+  fRates.Reset();
+  fMergeSequence = 0;
+
+  // Sequences start over with the run
+  {
+    std::lock_guard<std::mutex> reorderersLock(fReorderersMutex);
+    for (auto &reorderer : fReorderers) {
+      reorderer->SetWindow(fReorderWindow);
+      reorderer->Reset();
+    }
+  }
 
   // Clear any leftover data in queue
   {
     std::lock_guard<std::mutex> queueLock(fQueueMutex);
-    while (!fDataQueue.empty()) {
-      fDataQueue.pop();
-    }
+    fDataQueue.Clear();
   }
 
   // Reset EOS tracker and register sources
@@ -352,12 +448,11 @@ void SimpleMerger::OnReset() {
   fBytesTransferred = 0;
   fEOSReceivedCount = 0;
 
-  // Clear queue
+  // Clear queue and remove the spill file
   {
     std::lock_guard<std::mutex> queueLock(fQueueMutex);
-    while (!fDataQueue.empty()) {
-      fDataQueue.pop();
-    }
+    fDataQueue.CloseSpill();
+    fDataQueue.Clear();
   }
 
   // Disconnect transports
@@ -390,11 +485,16 @@ bool SimpleMerger::TransitionTo(ComponentState newState) {
 }
 
 void SimpleMerger::ReceivingLoop(size_t input_index) {
-  if (input_index >= fInputTransports.size()) {
+  if (input_index >= fInputTransports.size() ||
+      input_index >= fReorderers.size()) {
     return;
   }
 
   auto &transport = fInputTransports[input_index];
+  auto &reorderer = *fReorderers[input_index];
+  const auto sourceId = static_cast<uint8_t>(input_index + 1);
+  std::vector<std::unique_ptr<std::vector<uint8_t>>> ready;
+  uint64_t frames = 0;  // Latency sampling counter for this input
 
   while (fRunning) {
     // Check if transport is valid
@@ -412,10 +512,12 @@ void SimpleMerger::ReceivingLoop(size_t input_index) {
     }
 
     if (data && !data->empty()) {
-      size_t dataSize = data->size();
-
       // Check for EOS marker
       if (Net::DataProcessor::IsEOSMessage(data->data(), data->size())) {
+        // Frames held for reordering go out ahead of the EOS
+        reorderer.Flush(ready);
+        QueueFrames(ready, frames);
+
         fEOSTracker->ReceiveEOS("input_" + std::to_string(input_index));
         fEOSReceivedCount++;
 
@@ -426,36 +528,81 @@ void SimpleMerger::ReceivingLoop(size_t input_index) {
         continue;
       }
 
-      // Push data to queue (for sending thread)
-      {
-        std::lock_guard<std::mutex> lock(fQueueMutex);
-
-        // Check queue size limit
-        if (fDataQueue.size() >= kMaxQueueSize) {
-          std::cerr << "SimpleMerger: Queue overflow! Dropping data."
-                    << std::endl;
-          continue;
-        }
-
-        fDataQueue.push(std::move(data));
-        fBytesTransferred += dataSize;
+      // Data frames are followed in the sequence of this input's stream
+      // and leave stamped with its source id
+      Net::BinaryDataHeader header;
+      if (Net::DataProcessor::PeekHeader(*data, header) &&
+          header.message_type == Net::MESSAGE_TYPE_DATA) {
+        const uint64_t sequence = Net::DataProcessor::GetStreamSequence(header);
+        Net::DataProcessor::SetSourceId(*data, sourceId);
+        reorderer.Push(sequence, std::move(data), ready);
+      } else {
+        ready.push_back(std::move(data));
       }
-      fQueueCondition.notify_one();
+      QueueFrames(ready, frames);
 
-      // Update event count (decode to count events)
-      // Note: We're counting bytes here; for accurate event count,
-      // we'd need to decode, but that adds overhead
+      // Events are counted from the frame header by the sending thread
       fHeartbeatCounter++;
     } else {
       // No data available, sleep briefly
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
   }
+
+  // Stopped without EOS: pass on what is still held, if anyone sends it
+  reorderer.Flush(ready);
+  QueueFrames(ready, frames);
+}
+
+void SimpleMerger::QueueFrames(
+    std::vector<std::unique_ptr<std::vector<uint8_t>>> &frames,
+    uint64_t &counter) {
+  if (frames.empty()) {
+    return;
+  }
+
+  // Push data to queue (for sending thread)
+  {
+    std::lock_guard<std::mutex> pushLock(fPushMutex);
+    std::unique_lock<std::mutex> lock(fQueueMutex);
+    for (auto &data : frames) {
+      const size_t dataSize = data->size();
+
+      // Only frames chosen for latency timing carry a receive stamp
+      bool timed = (counter++ & fLatency.GetSampleMask()) == 0;
+
+      // Beyond the queue size limit frames go to the spill file, if any.
+      // The file is written without fQueueMutex so the sending thread and
+      // metrics scrapes are not held up by the disk.
+      Net::SpillQueue::Frame frame{std::move(data),
+                                   timed ? LatencyRecorder::Now() : 0};
+      Net::SpillQueue::Reservation reservation;
+      auto result = fDataQueue.BeginPush(frame, reservation);
+      if (result == Net::SpillQueue::PushResult::Reserved) {
+        lock.unlock();
+        const bool written = fDataQueue.WriteReserved(reservation, frame);
+        lock.lock();
+        result = fDataQueue.EndPush(reservation, written)
+                     ? Net::SpillQueue::PushResult::Stored
+                     : Net::SpillQueue::PushResult::Dropped;
+      }
+      if (result == Net::SpillQueue::PushResult::Dropped) {
+        std::cerr << "SimpleMerger: Queue overflow! Dropping data."
+                  << std::endl;
+        continue;
+      }
+      fBytesTransferred += dataSize;
+    }
+  }
+  frames.clear();
+  fQueueCondition.notify_one();
 }
 
 void SimpleMerger::SendingLoop() {
-  while (fRunning || !fDataQueue.empty()) {
-    std::unique_ptr<std::vector<uint8_t>> data;
+  const bool spill = fDataQueue.IsSpillOpen();  // Only changes when idle
+
+  while (true) {
+    Net::SpillQueue::Frame frame;
 
     // Wait for data in queue
     {
@@ -463,24 +610,65 @@ void SimpleMerger::SendingLoop() {
 
       // Wait until there's data or we should stop
       fQueueCondition.wait(lock, [this] {
-        return !fDataQueue.empty() || !fRunning;
+        return !fDataQueue.Empty() || !fRunning;
       });
 
-      if (fDataQueue.empty()) {
+      if (!fDataQueue.Pop(frame)) {
         if (!fRunning) {
           break;
         }
         continue;
       }
+    }
+
+    // Spill mode: hold the frame until the output can take it, meanwhile
+    // the queue overflows to disk. A sink that stays away past the flush
+    // timeout at stop loses what is left.
+    if (spill && fOutputTransport) {
+      const bool running = fRunning;
+      if (!fOutputTransport->WaitForSendReady(
+              running ? kSpillRetryInterval
+                      : SpillBuffer::kDefaultFlushTimeout)) {
+        std::lock_guard<std::mutex> lock(fQueueMutex);
+        fDataQueue.Requeue(std::move(frame));
+        if (!running) {
+          fDataQueue.DropAll();
+          break;
+        }
+        continue;
+      }
+    }
 
-      data = std::move(fDataQueue.front());
-      fDataQueue.pop();
+    const bool timed = frame.stamp != 0;
+    const uint64_t start = timed ? LatencyRecorder::Now() : 0;
+    if (timed) {
+      fLatency.RecordResidency(frame.stamp, start);
     }
 
     // Send data to downstream
+    auto &data = frame.data;
     if (data && !data->empty() && fOutputTransport &&
         fOutputTransport->IsConnected()) {
-      fOutputTransport->SendBytes(data);
+      Net::BinaryDataHeader header;
+      bool peeked = Net::DataProcessor::PeekHeader(*data, header);
+      bool stamped = timed && peeked;
+      if (peeked && header.message_type == Net::MESSAGE_TYPE_DATA) {
+        // Numbered in send order: a frame lost after the merger leaves a
+        // gap in the merged stream
+        Net::DataProcessor::SetMergeSequence(*data, fMergeSequence++);
+      }
+      fRates.CountFrame(*data);
+      if (fOutputTransport->SendBytes(data) && peeked) {
+        fEventsProcessed += header.event_count;
+      }
+
+      if (timed) {
+        const uint64_t end = LatencyRecorder::Now();
+        fLatency.RecordProcessing(start, end);
+        if (stamped) {
+          fLatency.RecordAge(header.timestamp, end);
+        }
+      }
     }
   }
 
@@ -538,6 +726,72 @@ void SimpleMerger::StopCommandListener() {
   }
 }
 
+// === Metrics endpoint ===
+
+void SimpleMerger::SetMetricsAddress(const std::string &address) {
+  fMetrics.SetAddress(address);
+}
+
+std::string SimpleMerger::GetMetricsAddress() const {
+  return fMetrics.GetAddress();
+}
+
+bool SimpleMerger::StartMetricsExporter() {
+  MetricsExporter *exporter = fMetrics.Prepare(*this);
+  if (!exporter) {
+    return false;
+  }
+  exporter->AddCounter("eos_received", "End-of-stream markers received",
+                       [this] {
+                         return static_cast<uint64_t>(fEOSReceivedCount.load());
+                       });
+  exporter->AddCounter("frames_dropped", "Data frames dropped on overflow",
+                       [this] { return GetDroppedFrames(); });
+  exporter->AddCounter("input_frames_lost",
+                       "Frames missing from the sources' sequences",
+                       [this] { return SumInputSequenceStats().lost; });
+  exporter->AddCounter("input_frames_reordered",
+                       "Frames that arrived after a later one of their source",
+                       [this] { return SumInputSequenceStats().reordered; });
+  exporter->AddCounter("input_frames_late",
+                       "Reordered frames forwarded out of order",
+                       [this] { return SumInputSequenceStats().late; });
+  exporter->AddCounter("input_frames_duplicate",
+                       "Repeated frames dropped",
+                       [this] { return SumInputSequenceStats().duplicates; });
+  if (!fSpillDirectory.empty()) {
+    exporter->AddCounter("frames_spilled",
+                         "Data frames written to the spill file", [this] {
+                           std::lock_guard<std::mutex> lock(fQueueMutex);
+                           return fDataQueue.GetTotalSpilled();
+                         });
+    exporter->AddCounter("frames_restored",
+                         "Data frames read back from the spill file", [this] {
+                           std::lock_guard<std::mutex> lock(fQueueMutex);
+                           return fDataQueue.GetTotalRestored();
+                         });
+    exporter->AddGauge("spill_frames", "Frames waiting in the spill file",
+                       [this] {
+                         return static_cast<double>(GetSpilledFrames());
+                       });
+    exporter->AddGauge("spill_occupancy_ratio",
+                       "Fraction of the spill file in use", [this] {
+                         std::lock_guard<std::mutex> lock(fQueueMutex);
+                         const uint64_t capacity = fDataQueue.GetSpillCapacity();
+                         return capacity == 0
+                                    ? 0.0
+                                    : static_cast<double>(
+                                          fDataQueue.GetSpilledBytes()) /
+                                          static_cast<double>(capacity);
+                       });
+  }
+  return fMetrics.Start();
+}
+
+void SimpleMerger::StopMetricsExporter() {
+  fMetrics.Stop();
+}
+
 void SimpleMerger::CommandListenerLoop() {
   while (fCommandListenerRunning) {
     auto cmd = fCommandTransport->ReceiveCommand();
@@ -0,0 +1,213 @@
+#include "SingleInputStage.hpp"
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include <chrono>
+#include <iostream>
+
+namespace DELILA {
+
+SingleInputStage::SingleInputStage(std::string name, size_t maxOutputs)
+    : StageComponent(1, maxOutputs), fName(std::move(name)) {}
+
+size_t SingleInputStage::GetQueueSize() const {
+  std::lock_guard<std::mutex> lock(fQueueMutex);
+  return fDataQueue.size();
+}
+
+// === StageComponent hooks ===
+
+void SingleInputStage::StartThreads() {
+  // Clear any leftover data in queue
+  {
+    std::lock_guard<std::mutex> queueLock(fQueueMutex);
+    while (!fDataQueue.empty()) {
+      fDataQueue.pop();
+    }
+  }
+
+  fAbort = false;
+  fRunning = true;
+
+  // Downstream first, so nothing waits on a missing consumer
+  StartProcessing();
+  fReceivingThread =
+      std::make_unique<std::thread>(&SingleInputStage::ReceivingLoop, this);
+}
+
+void SingleInputStage::StopThreads(bool graceful) {
+  fRunning = false;
+  if (!graceful) {
+    fAbort = true;
+  }
+
+  // Upstream first: once the receiver is done nothing enters the queue
+  if (fReceivingThread && fReceivingThread->joinable()) {
+    fReceivingThread->join();
+  }
+  fReceivingThread.reset();
+
+  {
+    std::lock_guard<std::mutex> lock(fQueueMutex);
+  }
+  fQueueCondition.notify_all();
+  StopProcessing();
+
+  // Clear queue
+  {
+    std::lock_guard<std::mutex> lock(fQueueMutex);
+    while (!fDataQueue.empty()) {
+      fDataQueue.pop();
+    }
+  }
+}
+
+void SingleInputStage::StartProcessing() {
+  fProcessingThread =
+      std::make_unique<std::thread>(&SingleInputStage::ProcessingLoop, this);
+}
+
+void SingleInputStage::StopProcessing() {
+  if (fProcessingThread && fProcessingThread->joinable()) {
+    fProcessingThread->join();
+  }
+  fProcessingThread.reset();
+}
+
+// === Helper methods ===
+
+bool SingleInputStage::PopFrame(QueuedFrame &frame) {
+  std::unique_lock<std::mutex> lock(fQueueMutex);
+
+  fQueueCondition.wait(lock,
+                       [this] { return !fDataQueue.empty() || !fRunning; });
+
+  // Drain the queue before leaving, unless aborted
+  if (fAbort || fDataQueue.empty()) {
+    return false;
+  }
+
+  frame = std::move(fDataQueue.front());
+  fDataQueue.pop();
+  return true;
+}
+
+bool SingleInputStage::SendFrame(size_t output,
+                                 std::unique_ptr<std::vector<uint8_t>> &frame,
+                                 uint32_t events) {
+  auto &transport = fOutputTransports[output];
+  if (!transport || !transport->IsConnected()) {
+    return false;
+  }
+  size_t frameSize = frame->size();
+  fRates.CountFrame(*frame);
+  if (!transport->SendBytes(frame)) {
+    return false;
+  }
+  fEventsProcessed += events;
+  fBytesTransferred += frameSize;
+  return true;
+}
+
+void SingleInputStage::SendEOS(std::unique_ptr<std::vector<uint8_t>> &eos) {
+  // Every output gets its own EOS
+  for (size_t o = 0; o < fOutputTransports.size(); ++o) {
+    auto marker = o + 1 < fOutputTransports.size()
+                      ? std::make_unique<std::vector<uint8_t>>(*eos)
+                      : std::move(eos);
+    if (fOutputTransports[o]->IsConnected()) {
+      fOutputTransports[o]->SendBytes(marker);
+    }
+  }
+}
+
+void SingleInputStage::ReceivingLoop() {
+  auto &transport = fInputTransports[0];
+  uint64_t frames = 0;  // Receive order, also the latency sampling counter
+
+  while (fRunning) {
+    // Check if transport is valid
+    if (!transport || !transport->IsConnected()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+
+    // Receive data from transport
+    auto data = transport->ReceiveBytes();
+
+    // Check fRunning again after potentially blocking receive
+    if (!fRunning) {
+      break;
+    }
+
+    if (data && !data->empty()) {
+      size_t dataSize = data->size();
+
+      // EOS goes through the queue so it stays behind the data
+      {
+        std::lock_guard<std::mutex> lock(fQueueMutex);
+
+        // Check queue size limit
+        if (fDataQueue.size() >= kMaxQueueSize) {
+          std::cerr << fName << ": Queue overflow! Dropping data."
+                    << std::endl;
+          continue;
+        }
+
+        // Only frames chosen for latency timing carry a receive stamp
+        QueuedFrame frame;
+        frame.index = frames;
+        frame.enqueued_ns =
+            (frames & fLatency.GetSampleMask()) == 0 ? LatencyRecorder::Now()
+                                                     : 0;
+        frame.data = std::move(data);
+        frames++;
+        fDataQueue.push(std::move(frame));
+        fBytesReceived += dataSize;
+      }
+      fQueueCondition.notify_one();
+      fHeartbeatCounter++;
+    } else {
+      // No data available, sleep briefly
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+void SingleInputStage::ProcessingLoop() {
+  QueuedFrame frame;
+
+  while (PopFrame(frame)) {
+    const bool timed = frame.enqueued_ns != 0;
+    const uint64_t start = timed ? LatencyRecorder::Now() : 0;
+    if (timed) {
+      fLatency.RecordResidency(frame.enqueued_ns, start);
+    }
+
+    auto &data = frame.data;
+    if (!data || data->empty()) {
+      continue;
+    }
+
+    if (Net::DataProcessor::IsEOSMessage(data->data(), data->size())) {
+      SendEOS(data);
+      continue;
+    }
+
+    Net::BinaryDataHeader header;
+    bool stamped = timed && Net::DataProcessor::PeekHeader(*data, header);
+
+    ProcessFrame(data);
+
+    if (timed) {
+      const uint64_t end = LatencyRecorder::Now();
+      fLatency.RecordProcessing(start, end);
+      if (stamped) {
+        fLatency.RecordAge(header.timestamp, end);
+      }
+    }
+  }
+}
+
+}  // namespace DELILA
@@ -0,0 +1,132 @@
+#include "SpillBuffer.hpp"
+
+namespace DELILA {
+
+std::string SpillBuffer::PathFor(const std::string &directory,
+                                 const std::string &componentId) {
+  std::string path = directory;
+  if (!path.empty() && path.back() != '/') {
+    path += '/';
+  }
+  return path + (componentId.empty() ? "component" : componentId) + ".spill";
+}
+
+SpillBuffer::SpillBuffer() : fQueue(kDefaultMemoryFrames) {}
+
+SpillBuffer::~SpillBuffer() { Close(); }
+
+void SpillBuffer::SetMemoryFrames(size_t frames) {
+  fQueue.SetMemoryFrames(frames);
+}
+
+bool SpillBuffer::Open(const std::string &path, uint64_t capacityBytes,
+                       SendFunction send, ReadyFunction ready,
+                       std::string *error) {
+  if (!send || !ready) {
+    return false;
+  }
+  if (!fQueue.OpenSpill(path, capacityBytes, error)) {
+    return false;
+  }
+  fSend = std::move(send);
+  fReady = std::move(ready);
+  fCapacityBytes = capacityBytes;
+  UpdateCounters();
+  return true;
+}
+
+void SpillBuffer::Close() {
+  fQueue.CloseSpill();
+  fQueue.Clear();
+  fSend = nullptr;
+  fReady = nullptr;
+  fCapacityBytes = 0;
+  UpdateCounters();
+}
+
+void SpillBuffer::Clear() {
+  fQueue.Clear();
+  UpdateCounters();
+}
+
+bool SpillBuffer::Send(std::unique_ptr<std::vector<uint8_t>> &frame) {
+  if (!IsOpen()) {
+    return false;
+  }
+
+  bool held = true;
+  if (SendHeld(std::chrono::milliseconds(0)) &&
+      fReady(std::chrono::milliseconds(0))) {
+    if (fSend(frame)) {
+      held = false;
+    } else if (!frame) {
+      // Handed over and lost anyway
+      UpdateCounters();
+      return false;
+    }
+  }
+
+  bool accepted = true;
+  if (held) {
+    accepted = fQueue.Push(Net::SpillQueue::Frame{std::move(frame)});
+  }
+  UpdateCounters();
+  return accepted;
+}
+
+void SpillBuffer::Drain() {
+  if (IsOpen()) {
+    SendHeld(std::chrono::milliseconds(0));
+    UpdateCounters();
+  }
+}
+
+bool SpillBuffer::Flush(std::chrono::milliseconds timeout) {
+  if (!IsOpen()) {
+    return true;
+  }
+  bool flushed = SendHeld(timeout);
+  if (!flushed) {
+    fQueue.DropAll();
+  }
+  UpdateCounters();
+  return flushed;
+}
+
+double SpillBuffer::GetOccupancy() const {
+  const uint64_t capacity = fCapacityBytes.load();
+  if (capacity == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(fSpilledBytes.load()) /
+         static_cast<double>(capacity);
+}
+
+bool SpillBuffer::SendHeld(std::chrono::milliseconds timeout) {
+  Net::SpillQueue::Frame frame;
+  while (!fQueue.Empty()) {
+    if (!fReady(timeout)) {
+      return false;
+    }
+    if (!fQueue.Pop(frame)) {
+      continue;  // Unreadable spill, counted as dropped; try what is left
+    }
+    if (!fSend(frame.data) && frame.data) {
+      // Not taken after all: keep it first in line
+      fQueue.Requeue(std::move(frame));
+      return false;
+    }
+  }
+  return true;
+}
+
+void SpillBuffer::UpdateCounters() {
+  fHeldFrames = fQueue.Size();
+  fSpilledFrames = fQueue.GetSpilledFrames();
+  fSpilledBytes = fQueue.GetSpilledBytes();
+  fFramesSpilled = fQueue.GetTotalSpilled();
+  fFramesRestored = fQueue.GetTotalRestored();
+  fFramesDropped = fQueue.GetDropped();
+}
+
+} // namespace DELILA
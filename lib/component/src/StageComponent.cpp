@@ -0,0 +1,441 @@
+#include "StageComponent.hpp"
+
+#include <ZMQTransport.hpp>
+#include <delila/core/CommandResponse.hpp>
+#include <delila/core/ErrorCode.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace DELILA {
+
+StageComponent::StageComponent(size_t maxInputs, size_t maxOutputs)
+    : fMaxInputs(maxInputs), fMaxOutputs(maxOutputs) {}
+
+StageComponent::~StageComponent() = default;
+
+// === IComponent interface ===
+
+bool StageComponent::Initialize(const std::string &config_path) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+
+  if (fState != ComponentState::Idle) {
+    return false;
+  }
+
+  // Validate: must have at least one input and one output
+  if (fInputAddresses.empty()) {
+    fErrorMessage = "No input addresses configured";
+    return false;
+  }
+
+  if (fOutputAddresses.empty()) {
+    fErrorMessage = "No output addresses configured";
+    return false;
+  }
+
+  if (!OnInitialize(config_path)) {
+    return false;
+  }
+
+  // Create input transports
+  fInputTransports.clear();
+  const size_t inputs = std::min(fInputAddresses.size(), fMaxInputs);
+  for (size_t i = 0; i < inputs; ++i) {
+    auto transport = std::make_unique<Net::ZMQTransport>();
+    Net::TransportConfig inputConfig;
+    inputConfig.data_address = fInputAddresses[i];
+    inputConfig.bind_data = false;  // Connect to upstream
+    inputConfig.data_pattern = "PULL";
+    // Disable status and command sockets
+    inputConfig.status_address = inputConfig.data_address;
+    inputConfig.command_address = "";
+
+    if (!transport->Configure(inputConfig)) {
+      fErrorMessage =
+          "Failed to configure input transport: " + fInputAddresses[i];
+      fState = ComponentState::Error;
+      return false;
+    }
+    fInputTransports.push_back(std::move(transport));
+  }
+
+  // Create output transports
+  fOutputTransports.clear();
+  const size_t outputs = std::min(fOutputAddresses.size(), fMaxOutputs);
+  for (size_t i = 0; i < outputs; ++i) {
+    auto transport = std::make_unique<Net::ZMQTransport>();
+    Net::TransportConfig outputConfig;
+    outputConfig.data_address = fOutputAddresses[i];
+    outputConfig.bind_data = true;  // Bind for downstream
+    outputConfig.data_pattern = "PUSH";
+    outputConfig.status_address = outputConfig.data_address;
+    outputConfig.command_address = "";
+
+    if (!transport->Configure(outputConfig)) {
+      fErrorMessage =
+          "Failed to configure output transport: " + fOutputAddresses[i];
+      fState = ComponentState::Error;
+      return false;
+    }
+    fOutputTransports.push_back(std::move(transport));
+  }
+
+  fState = ComponentState::Configured;
+  return true;
+}
+
+void StageComponent::Run() {
+  // Main loop - wait for shutdown
+  while (!fShutdownRequested) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+void StageComponent::Shutdown() {
+  fShutdownRequested = true;
+
+  // Stop command listener first
+  StopCommandListener();
+  StopMetricsExporter();
+
+  StopThreads(false);
+  DisconnectTransports();
+
+  fState = ComponentState::Idle;
+}
+
+ComponentState StageComponent::GetState() const { return fState.load(); }
+
+std::string StageComponent::GetComponentId() const { return fComponentId; }
+
+ComponentStatus StageComponent::GetStatus() const {
+  ComponentStatus status;
+  status.component_id = fComponentId;
+  status.state = fState.load();
+  status.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  status.run_number = fRunNumber.load();
+  status.metrics.events_processed = fEventsProcessed.load();
+  status.metrics.bytes_transferred = fBytesTransferred.load();
+  status.metrics.queue_size = static_cast<uint32_t>(GetQueueSize());
+  status.metrics.queue_max = static_cast<uint32_t>(kMaxQueueSize);
+  fLatency.Fill(status.metrics);
+  fRates.Fill(status.metrics.events_processed,
+              status.metrics.bytes_transferred, status.metrics);
+  status.error_message = fErrorMessage;
+  status.heartbeat_counter = fHeartbeatCounter.load();
+  return status;
+}
+
+// === IDataComponent interface ===
+
+void StageComponent::SetInputAddresses(
+    const std::vector<std::string> &addresses) {
+  fInputAddresses = addresses;
+}
+
+void StageComponent::SetOutputAddresses(
+    const std::vector<std::string> &addresses) {
+  fOutputAddresses = addresses;
+}
+
+std::vector<std::string> StageComponent::GetInputAddresses() const {
+  return fInputAddresses;
+}
+
+std::vector<std::string> StageComponent::GetOutputAddresses() const {
+  return fOutputAddresses;
+}
+
+// === Public control methods ===
+
+bool StageComponent::Arm() { return OnArm(); }
+
+bool StageComponent::Start(uint32_t run_number) { return OnStart(run_number); }
+
+bool StageComponent::Stop(bool graceful) { return OnStop(graceful); }
+
+void StageComponent::Reset() { OnReset(); }
+
+// === Configuration ===
+
+void StageComponent::SetComponentId(const std::string &id) {
+  fComponentId = id;
+}
+
+// === Testing utilities ===
+
+void StageComponent::ForceError(const std::string &message) {
+  fErrorMessage = message;
+  fState = ComponentState::Error;
+}
+
+// === IComponent callbacks ===
+
+bool StageComponent::OnConfigure(const nlohmann::json & /*config*/) {
+  // Already handled in Initialize
+  return true;
+}
+
+bool StageComponent::OnArm() {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+
+  if (fState != ComponentState::Configured) {
+    return false;
+  }
+
+  // Connect input transports
+  for (size_t i = 0; i < fInputTransports.size(); ++i) {
+    auto &transport = fInputTransports[i];
+    if (transport && !transport->IsConnected() && !transport->Connect()) {
+      fErrorMessage =
+          "Failed to connect input transport: " + fInputAddresses[i];
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
+  // Connect output transports
+  for (size_t i = 0; i < fOutputTransports.size(); ++i) {
+    auto &transport = fOutputTransports[i];
+    if (transport && !transport->IsConnected() && !transport->Connect()) {
+      fErrorMessage =
+          "Failed to connect output transport: " + fOutputAddresses[i];
+      fState = ComponentState::Error;
+      return false;
+    }
+  }
+
+  fState = ComponentState::Armed;
+  return true;
+}
+
+bool StageComponent::OnStart(uint32_t run_number) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+
+  if (fState != ComponentState::Armed) {
+    return false;
+  }
+
+  fRunNumber = run_number;
+  fEventsProcessed = 0;
+  fBytesTransferred = 0;
+  fBytesReceived = 0;
+  fLatency.Reset();
+  fRates.Reset();
+  ResetCounters();
+
+  StartThreads();
+
+  fState = ComponentState::Running;
+  return true;
+}
+
+bool StageComponent::OnStop(bool graceful) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+
+  if (fState != ComponentState::Running) {
+    return false;
+  }
+
+  StopThreads(graceful);
+
+  fState = ComponentState::Configured;
+  return true;
+}
+
+void StageComponent::OnReset() {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+
+  // Stop everything
+  fShutdownRequested = false;
+  StopThreads(false);
+
+  // Reset state
+  fErrorMessage.clear();
+  fRunNumber = 0;
+  fEventsProcessed = 0;
+  fBytesTransferred = 0;
+  fBytesReceived = 0;
+  ResetCounters();
+
+  DisconnectTransports();
+
+  fState = ComponentState::Idle;
+}
+
+// === Stage hooks ===
+
+bool StageComponent::OnInitialize(const std::string &config_path) {
+  // Configured through the setters only: refuse a file rather than
+  // silently ignore it
+  if (!config_path.empty()) {
+    fErrorMessage = "Configuration files are not supported: " + config_path;
+    return false;
+  }
+  return true;
+}
+
+bool StageComponent::HandleConfigure(const Command & /*cmd*/,
+                                     std::string &message) {
+  bool success = (fState == ComponentState::Idle);
+  if (success) {
+    success = Initialize("");
+  } else if (fState == ComponentState::Configured) {
+    success = true;
+  }
+  message = success ? "Configured" : "Failed to configure";
+  return success;
+}
+
+// === Helper methods ===
+
+void StageComponent::DisconnectTransports() {
+  for (auto &transport : fInputTransports) {
+    if (transport) {
+      transport->Disconnect();
+    }
+  }
+  fInputTransports.clear();
+
+  for (auto &transport : fOutputTransports) {
+    if (transport) {
+      transport->Disconnect();
+    }
+  }
+  fOutputTransports.clear();
+}
+
+// === Command channel ===
+
+void StageComponent::SetCommandAddress(const std::string &address) {
+  fCommandAddress = address;
+}
+
+std::string StageComponent::GetCommandAddress() const {
+  return fCommandAddress;
+}
+
+void StageComponent::StartCommandListener() {
+  if (fCommandListenerRunning || fCommandAddress.empty()) {
+    return;
+  }
+
+  // Create and configure command transport
+  fCommandTransport = std::make_unique<Net::ZMQTransport>();
+  Net::TransportConfig config;
+  config.command_address = fCommandAddress;
+  config.bind_command = true;
+  // Disable data and status sockets
+  config.data_address = "";
+  config.status_address = "";
+
+  if (!fCommandTransport->Configure(config) || !fCommandTransport->Connect()) {
+    fCommandTransport.reset();
+    return;
+  }
+
+  fCommandListenerRunning = true;
+  fCommandListenerThread = std::make_unique<std::thread>(
+      &StageComponent::CommandListenerLoop, this);
+}
+
+void StageComponent::StopCommandListener() {
+  fCommandListenerRunning = false;
+
+  if (fCommandListenerThread && fCommandListenerThread->joinable()) {
+    fCommandListenerThread->join();
+  }
+  fCommandListenerThread.reset();
+
+  if (fCommandTransport) {
+    fCommandTransport->Disconnect();
+    fCommandTransport.reset();
+  }
+}
+
+// === Metrics endpoint ===
+
+void StageComponent::SetMetricsAddress(const std::string &address) {
+  fMetrics.SetAddress(address);
+}
+
+std::string StageComponent::GetMetricsAddress() const {
+  return fMetrics.GetAddress();
+}
+
+bool StageComponent::StartMetricsExporter() {
+  MetricsExporter *exporter = fMetrics.Prepare(*this);
+  if (!exporter) {
+    return false;
+  }
+  AddMetrics(*exporter);
+  return fMetrics.Start();
+}
+
+void StageComponent::StopMetricsExporter() { fMetrics.Stop(); }
+
+void StageComponent::CommandListenerLoop() {
+  while (fCommandListenerRunning) {
+    auto cmd = fCommandTransport->ReceiveCommand();
+    if (cmd) {
+      HandleCommand(*cmd);
+    }
+  }
+}
+
+void StageComponent::HandleCommand(const Command &cmd) {
+  bool success = false;
+  std::string message;
+
+  switch (cmd.type) {
+  case CommandType::Configure:
+    success = HandleConfigure(cmd, message);
+    break;
+
+  case CommandType::Arm:
+    success = Arm();
+    message = success ? "Armed" : "Failed to arm";
+    break;
+
+  case CommandType::Start:
+    success = Start(cmd.run_number);
+    message = success ? "Started" : "Failed to start";
+    break;
+
+  case CommandType::Stop:
+    success = Stop(cmd.graceful);
+    message = success ? "Stopped" : "Failed to stop";
+    break;
+
+  case CommandType::Reset:
+    Reset();
+    success = true;
+    message = "Reset";
+    break;
+
+  case CommandType::GetStatus:
+    success = true;
+    message = "Status OK";
+    break;
+
+  default:
+    success = false;
+    message = "Unknown command";
+    break;
+  }
+
+  CommandResponse response;
+  response.request_id = cmd.request_id;
+  response.success = success;
+  response.error_code =
+      success ? ErrorCode::Success : ErrorCode::InvalidStateTransition;
+  response.current_state = fState.load();
+  response.message = message;
+
+  fCommandTransport->SendCommandResponse(response);
+}
+
+}  // namespace DELILA
@@ -0,0 +1,220 @@
+#include "WaveformAnalyzer.hpp"
+
+#include <DataProcessor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace DELILA {
+
+WaveformAnalyzer::WaveformAnalyzer() : SingleInputStage("WaveformAnalyzer") {}
+
+WaveformAnalyzer::~WaveformAnalyzer() { Shutdown(); }
+
+// === Configuration ===
+
+bool WaveformAnalyzer::SetSettings(const PulseAnalyzer::Settings &settings,
+                                   std::string *error) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    if (error) {
+      *error = "cannot change settings while running";
+    }
+    return false;
+  }
+  return fAnalyzer.SetSettings(settings, error);
+}
+
+PulseAnalyzer::Settings WaveformAnalyzer::GetSettings() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fAnalyzer.GetSettings();
+}
+
+void WaveformAnalyzer::SetWorkerThreads(uint32_t count) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState != ComponentState::Running) {
+    fWorkerThreads = std::max<uint32_t>(count, 1);
+  }
+}
+
+uint32_t WaveformAnalyzer::GetWorkerThreads() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fWorkerThreads;
+}
+
+uint64_t WaveformAnalyzer::GetEventsAnalyzed() const {
+  return fEventsAnalyzed.load();
+}
+
+uint64_t WaveformAnalyzer::GetCfdFailures() const { return fCfdFailures.load(); }
+
+// === SingleInputStage hooks ===
+
+void WaveformAnalyzer::ResetCounters() {
+  fEventsAnalyzed = 0;
+  fCfdFailures = 0;
+}
+
+void WaveformAnalyzer::AddMetrics(MetricsExporter &exporter) {
+  exporter.AddCounter("events_analyzed", "Events with a waveform analyzed",
+                      [this] { return fEventsAnalyzed.load(); });
+  exporter.AddCounter("cfd_failures", "Analyzed events without CFD crossing",
+                      [this] { return fCfdFailures.load(); });
+  exporter.AddCounter("bytes_received", "Bytes received before analysis",
+                      [this] { return fBytesReceived.load(); });
+}
+
+void WaveformAnalyzer::StartProcessing() {
+  {
+    std::lock_guard<std::mutex> doneLock(fDoneMutex);
+    fDone.clear();
+  }
+  fWorkersFinished = false;
+
+  fSendingThread =
+      std::make_unique<std::thread>(&WaveformAnalyzer::SendingLoop, this);
+  for (uint32_t i = 0; i < fWorkerThreads; ++i) {
+    fAnalyzingThreads.emplace_back(&WaveformAnalyzer::AnalyzingLoop, this,
+                                   fAnalyzer);
+  }
+}
+
+void WaveformAnalyzer::StopProcessing() {
+  // Once the workers are done, every frame they took is in fDone and the
+  // sending thread can drain it
+  for (auto &thread : fAnalyzingThreads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  fAnalyzingThreads.clear();
+
+  {
+    std::lock_guard<std::mutex> lock(fDoneMutex);
+    fWorkersFinished = true;
+  }
+  fDoneCondition.notify_all();
+  if (fSendingThread && fSendingThread->joinable()) {
+    fSendingThread->join();
+  }
+  fSendingThread.reset();
+}
+
+// === Helper methods ===
+
+void WaveformAnalyzer::AnalyzingLoop(PulseAnalyzer analyzer) {
+  Net::DataProcessor processor;
+  QueuedFrame queued;
+
+  while (PopFrame(queued)) {
+    AnalyzedFrame frame;
+    frame.data = std::move(queued.data);
+    frame.enqueued_ns = queued.enqueued_ns;
+    if (frame.enqueued_ns != 0) {
+      frame.started_ns = LatencyRecorder::Now();
+    }
+    AnalyzeFrame(frame, analyzer, processor);
+
+    {
+      std::lock_guard<std::mutex> lock(fDoneMutex);
+      fDone.emplace(queued.index, std::move(frame));
+    }
+    fDoneCondition.notify_one();
+  }
+}
+
+void WaveformAnalyzer::AnalyzeFrame(AnalyzedFrame &frame,
+                                    PulseAnalyzer &analyzer,
+                                    Net::DataProcessor &processor) {
+  auto &data = frame.data;
+  if (!data || data->empty() ||
+      Net::DataProcessor::IsEOSMessage(data->data(), data->size())) {
+    return;
+  }
+
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(*data, header)) {
+    data.reset();
+    return;
+  }
+  frame.header_timestamp = header.timestamp;
+  frame.event_count = header.event_count;
+
+  // Only full event frames carry waveforms; the rest is forwarded as is
+  if (!Net::DataProcessor::IsEventDataFormat(header.format_version)) {
+    return;
+  }
+
+  auto [events, sequence] = processor.Decode(data);
+  if (!events) {
+    data.reset();
+    return;
+  }
+
+  uint64_t analyzed = 0;
+  uint64_t cfdFailures = 0;
+  for (auto &event : *events) {
+    if (analyzer.Apply(*event)) {
+      analyzed++;
+      cfdFailures += (event->flags & PulseAnalyzer::FLAG_NO_CFD) != 0;
+    }
+  }
+  fEventsAnalyzed += analyzed;
+  fCfdFailures += cfdFailures;
+
+  // Same sequence number and waveform encoding; keep the source timestamp
+  // so frame age stays end-to-end, and the merger stamp
+  processor.EnableCompactWaveforms(header.format_version ==
+                                   Net::FORMAT_VERSION_COMPACT_EVENTDATA);
+  auto output = processor.Process(events, sequence);
+  if (output) {
+    Net::DataProcessor::CopySourceStamps(header, *output);
+  }
+  data = std::move(output);
+}
+
+void WaveformAnalyzer::SendingLoop() {
+  uint64_t next = 0;
+
+  while (true) {
+    AnalyzedFrame frame;
+
+    // Wait for the next frame in receive order
+    {
+      std::unique_lock<std::mutex> lock(fDoneMutex);
+
+      fDoneCondition.wait(lock, [this, next] {
+        return fDone.count(next) > 0 || fWorkersFinished;
+      });
+
+      auto it = fDone.find(next);
+      if (fAbort || it == fDone.end()) {
+        break;  // Workers finished and everything was sent, or aborted
+      }
+      frame = std::move(it->second);
+      fDone.erase(it);
+    }
+    next++;
+
+    auto &data = frame.data;
+    if (!data) {
+      continue;
+    }
+
+    if (Net::DataProcessor::IsEOSMessage(data->data(), data->size())) {
+      SendEOS(data);
+      continue;
+    }
+
+    SendFrame(0, data, frame.event_count);
+
+    if (frame.enqueued_ns != 0) {
+      const uint64_t end = LatencyRecorder::Now();
+      fLatency.RecordResidency(frame.enqueued_ns, frame.started_ns);
+      fLatency.RecordProcessing(frame.started_ns, end);
+      fLatency.RecordAge(frame.header_timestamp, end);
+    }
+  }
+}
+
+}  // namespace DELILA
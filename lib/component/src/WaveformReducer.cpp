@@ -0,0 +1,193 @@
+#include "WaveformReducer.hpp"
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include <cstddef>
+
+namespace DELILA {
+
+WaveformReducer::WaveformReducer()
+    : SingleInputStage("WaveformReducer"),
+      fDataProcessor(std::make_unique<Net::DataProcessor>()) {}
+
+WaveformReducer::~WaveformReducer() { Shutdown(); }
+
+// === Configuration ===
+
+void WaveformReducer::SetPrescale(uint32_t prescale) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState != ComponentState::Running) {
+    fPrescale = prescale;
+  }
+}
+
+uint32_t WaveformReducer::GetPrescale() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fPrescale;
+}
+
+void WaveformReducer::SetWaveformChannels(
+    const std::vector<std::pair<uint8_t, uint8_t>> &channels) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    return;
+  }
+  fWaveformChannels = channels;
+  fChannelMask.reset();
+  for (const auto &[module, channel] : channels) {
+    fChannelMask.set((static_cast<size_t>(module) << 8) | channel);
+  }
+}
+
+std::vector<std::pair<uint8_t, uint8_t>>
+WaveformReducer::GetWaveformChannels() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  return fWaveformChannels;
+}
+
+bool WaveformReducer::AddRule(const std::string &expression,
+                              std::string *error) {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState == ComponentState::Running) {
+    if (error) {
+      *error = "cannot change rules while running";
+    }
+    return false;
+  }
+  return fFilter.AddRule(expression, error);
+}
+
+void WaveformReducer::ClearRules() {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  if (fState != ComponentState::Running) {
+    fFilter.Clear();
+  }
+}
+
+std::vector<std::string> WaveformReducer::GetRules() const {
+  std::lock_guard<std::mutex> lock(fStateMutex);
+  std::vector<std::string> rules;
+  for (const auto &rule : fFilter.GetRules()) {
+    rules.push_back(rule.expression);
+  }
+  return rules;
+}
+
+uint64_t WaveformReducer::GetWaveformsKept() const {
+  return fWaveformsKept.load();
+}
+
+// === SingleInputStage hooks ===
+
+void WaveformReducer::ResetCounters() {
+  fWaveformsKept = 0;
+  fSequence = 0;
+  fPrescaleCounter = 0;
+}
+
+void WaveformReducer::AddMetrics(MetricsExporter &exporter) {
+  exporter.AddCounter("waveforms_kept", "Events forwarded with waveform",
+                      [this] { return fWaveformsKept.load(); });
+  exporter.AddCounter("bytes_received", "Bytes received before reduction",
+                      [this] { return fBytesReceived.load(); });
+}
+
+void WaveformReducer::ProcessFrame(
+    std::unique_ptr<std::vector<uint8_t>> &data) {
+  Net::BinaryDataHeader header;
+  if (!Net::DataProcessor::PeekHeader(*data, header)) {
+    return;
+  }
+
+  if (Net::DataProcessor::IsEventDataFormat(header.format_version)) {
+    ReduceFrame(data, header);
+  } else {
+    // Nothing to reduce: forward as is, in this stage's numbering (the
+    // checksum covers the payload only, so it stays valid)
+    Net::DataProcessor::SetStreamSequence(*data, fSequence++);
+    SendFrame(0, data, header.event_count);
+  }
+}
+
+void WaveformReducer::ReduceFrame(std::unique_ptr<std::vector<uint8_t>> &data,
+                                  const Net::BinaryDataHeader &header) {
+  auto [events, sequence] = fDataProcessor->Decode(data);
+  if (!events) {
+    return;
+  }
+
+  // Rules are evaluated over the whole frame at once
+  const bool useRules = fFilter.GetRuleCount() > 0;
+  if (useRules) {
+    fBatch.Clear();
+    for (const auto &event : *events) {
+      fBatch.Add(event->module, event->channel, event->energy,
+                 event->energyShort, event->flags);
+    }
+    fFilter.Evaluate(fBatch, fPass, fRuleCounts);
+  }
+
+  auto minimal = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+  auto waveforms = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::EventData>>>();
+  minimal->reserve(events->size());
+
+  for (size_t i = 0; i < events->size(); ++i) {
+    auto &event = (*events)[i];
+    minimal->push_back(std::make_unique<Digitizer::MinimalEventData>(
+        event->module, event->channel, event->timeStampNs, event->energy,
+        event->energyShort, event->flags));
+
+    bool keep = (useRules && fPass[i]) ||
+                fChannelMask.test((static_cast<size_t>(event->module) << 8) |
+                                  event->channel);
+    if (fPrescale > 0 && fPrescaleCounter++ % fPrescale == 0) {
+      keep = true;
+    }
+    if (keep) {
+      waveforms->push_back(std::move(event));
+    }
+  }
+
+  // Each frame gets its own sequence number (merge sequence too, when
+  // merged), so gap detection downstream sees a plain stream; both keep the
+  // source timestamp and merger stamp
+  auto stamp = [this, &header](std::vector<uint8_t> &frame) {
+    Net::DataProcessor::CopySourceStamps(header, frame);
+    Net::DataProcessor::SetStreamSequence(frame, fSequence++);
+  };
+
+  auto minimalFrame = fDataProcessor->Process(minimal, fSequence);
+  if (!minimalFrame) {
+    return;
+  }
+  stamp(*minimalFrame);
+  if (!SendFrame(0, minimalFrame, static_cast<uint32_t>(minimal->size()))) {
+    return;
+  }
+
+  if (waveforms->empty()) {
+    return;
+  }
+  // Kept waveforms go out in the encoding they came in
+  fDataProcessor->EnableCompactWaveforms(
+      header.format_version == Net::FORMAT_VERSION_COMPACT_EVENTDATA);
+  auto waveformFrame = fDataProcessor->Process(waveforms, fSequence);
+  if (!waveformFrame) {
+    return;
+  }
+  stamp(*waveformFrame);
+  // Pairs it with the minimal frame just sent
+  Net::DataProcessor::SetFrameFlags(
+      *waveformFrame, header.frame_flags | Net::FRAME_FLAG_WAVEFORM_COMPANION);
+  // Its events were counted with the minimal frame
+  size_t waveformSize = waveformFrame->size();
+  if (fOutputTransports[0]->SendBytes(waveformFrame)) {
+    fWaveformsKept += waveforms->size();
+    fBytesTransferred += waveformSize;
+  }
+}
+
+}  // namespace DELILA
@@ -4,9 +4,33 @@
 #include "ComponentState.hpp"
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace DELILA {
 
+/**
+ * @brief Latency distribution of one pipeline stage (microseconds)
+ *
+ * Percentiles come from a log-bucketed histogram, accurate to ~1%, of a
+ * regular sample of frames.
+ */
+struct LatencySummary {
+  uint64_t count = 0;    ///< Frames timed this run
+  double p50_us = 0.0;   ///< Median
+  double p99_us = 0.0;   ///< 99th percentile
+  double p999_us = 0.0;  ///< 99.9th percentile
+  double max_us = 0.0;   ///< Largest value recorded
+};
+
+/**
+ * @brief Event rate of one digitizer channel
+ */
+struct ChannelRate {
+  uint8_t module = 0;       ///< Module number
+  uint8_t channel = 0;      ///< Channel within the module
+  double event_rate = 0.0;  ///< Events per second (EWMA, like event_rate)
+};
+
 /**
  * @brief Performance metrics for a component
  */
@@ -15,8 +39,20 @@ struct ComponentMetrics {
   uint64_t bytes_transferred = 0; ///< Total bytes transferred
   uint32_t queue_size = 0;        ///< Current queue size
   uint32_t queue_max = 0;         ///< Maximum queue capacity
-  double event_rate = 0.0;        ///< Events per second
-  double data_rate = 0.0;         ///< Data rate in MB/s
+  double event_rate = 0.0;        ///< Events per second (EWMA, ~2 s)
+  double data_rate = 0.0;         ///< Data rate in MB/s (EWMA, ~2 s)
+  double drain_latency_us = 0.0;  ///< Mean queue wait before send (us)
+  double sampling_fraction = 1.0; ///< Fraction of events analysed (1 = all)
+
+  // Per-frame latency (all zero if the component does not record it)
+  LatencySummary residency;       ///< Wait in the component's queue
+  LatencySummary processing;      ///< Decode/encode/send or write of a frame
+  LatencySummary frame_age;       ///< Now minus BinaryDataHeader timestamp
+
+  // Rates averaged over the last ~10 s, and per channel (RateEstimator)
+  double event_rate_avg = 0.0;    ///< Events per second, window mean
+  double data_rate_avg = 0.0;     ///< MB/s, window mean
+  std::vector<ChannelRate> channel_rates; ///< Channels seen this run
 };
 
 /**
@@ -6,6 +6,7 @@
 #include "IComponent.hpp"
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,9 @@ struct JobStatus {
   std::chrono::system_clock::time_point created_at;   ///< When job was created
   std::chrono::system_clock::time_point completed_at; ///< When job finished
 
+  /// Command round-trip time per component (ms), filled in as replies arrive
+  std::map<std::string, double> component_latency_ms;
+
   JobStatus()
       : state(JobState::Pending),
         created_at(std::chrono::system_clock::now()) {}
@@ -0,0 +1,125 @@
+#ifndef CONFIGURATIONENGINE_HPP
+#define CONFIGURATIONENGINE_HPP
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DELILA
+{
+namespace Digitizer
+{
+
+/**
+ * @brief Timing and write statistics of one Configure() call
+ */
+struct ConfigureReport {
+  struct Phase {
+    std::string name;
+    double ms = 0.0;
+  };
+
+  std::vector<Phase> phases;
+  size_t parameters = 0;  ///< Per-channel parameters in the configuration
+  size_t writes = 0;      ///< SetValue calls issued
+  size_t unchanged = 0;   ///< Parameters skipped (already applied)
+  size_t failed = 0;      ///< SetValue calls that returned an error
+  bool resetPerformed = false;
+  double totalMs = 0.0;
+
+  void Print(std::ostream &os) const;
+};
+
+/**
+ * @brief Measures consecutive phases into a ConfigureReport
+ */
+class PhaseTimer
+{
+ public:
+  explicit PhaseTimer(ConfigureReport &report);
+
+  /// Close the current phase under @p name and start the next one
+  void Mark(const std::string &name);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  ConfigureReport &fReport;
+  Clock::time_point fStart;
+  Clock::time_point fLast;
+};
+
+/**
+ * @brief Writes digitizer parameters, skipping values already on the board
+ *
+ * The applier remembers the last value written for every (expanded)
+ * parameter path. Plan() diffs a configuration against that state and
+ * returns only the writes that change something. Channel ranges such as
+ * /ch/0..31/par/X are expanded for the diff and the changed channels are
+ * coalesced back into ranges, so an unchanged board costs no SetValue
+ * calls and a fully changed range still costs one.
+ *
+ * Paths are compared case-insensitively (FELib paths are); values are
+ * compared as written in the configuration.
+ */
+class ParameterApplier
+{
+ public:
+  using Config = std::vector<std::array<std::string, 2>>;
+  using Setter =
+      std::function<bool(const std::string &path, const std::string &value)>;
+
+  struct Write {
+    std::string path;
+    std::string value;
+    size_t channels = 1;  ///< Per-channel parameters covered by this write
+  };
+
+  /**
+   * @brief Compute the writes needed to reach @p config
+   * @param unchanged Optional output: parameters already at their value
+   */
+  std::vector<Write> Plan(const Config &config,
+                          size_t *unchanged = nullptr) const;
+
+  /**
+   * @brief Whether the board must be reset before applying @p config
+   *
+   * True if nothing was applied yet, or if a previously applied parameter
+   * is no longer part of the configuration (its old value would persist).
+   */
+  bool NeedsReset(const Config &config) const;
+
+  /**
+   * @brief Issue the planned writes and record the successful ones
+   * @return Number of failed writes
+   */
+  size_t Apply(const std::vector<Write> &writes, const Setter &setter);
+
+  /// Forget the applied state (call after a hardware reset)
+  void Invalidate() { fApplied.clear(); }
+
+  size_t GetAppliedCount() const { return fApplied.size(); }
+
+  /**
+   * @brief Expand /ch/A..B/ into one path per channel
+   *
+   * Paths without a range are returned unchanged.
+   */
+  static std::vector<std::string> ExpandChannels(const std::string &path);
+
+ private:
+  std::unordered_map<std::string, std::string> fApplied;
+
+  static bool IsDevicePath(const std::string &path);
+  static std::string NormalizePath(const std::string &path);
+};
+
+}  // namespace Digitizer
+}  // namespace DELILA
+
+#endif  // CONFIGURATIONENGINE_HPP
@@ -9,6 +9,7 @@
 #include <thread>
 #include <vector>
 
+#include "ConfigurationEngine.hpp"
 #include "ConfigurationManager.hpp"
 #include "IDecoder.hpp"
 #include "PHA1Decoder.hpp"
@@ -58,6 +59,10 @@ class Digitizer1 : public IDigitizer
   // Control methods
   bool SendSWTrigger() override;
   bool CheckStatus() override;
+  ConfigureReport GetConfigureReport() const override
+  {
+    return fConfigureReport;
+  }
 
   // Getters
   uint64_t GetHandle() const override { return fHandle; }
@@ -85,6 +90,8 @@ class Digitizer1 : public IDigitizer
   // === Data Processing ===
   std::unique_ptr<IDecoder> fDecoder;
   std::unique_ptr<ParameterValidator> fParameterValidator;
+  ParameterApplier fParameterApplier;
+  ConfigureReport fConfigureReport;
   bool fDataTakingFlag = false;
   bool fArmedFlag = false;  // Track armed state for two-phase start
   std::vector<std::thread> fReadDataThreads;
@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+#include "ConfigurationEngine.hpp"
 #include "ConfigurationManager.hpp"
 #include "../../../include/delila/core/EventData.hpp"
 
@@ -190,6 +191,19 @@ class IDigitizer
    * @note This method should be non-blocking and safe to call frequently
    */
   virtual bool CheckStatus() = 0;
+
+  /**
+   * @brief Get timing and write statistics of the last Configure() call
+   *
+   * @return Report of the last configuration; empty if the implementation
+   *         does not collect one
+   *
+   * @see ConfigureReport
+   */
+  virtual ConfigureReport GetConfigureReport() const
+  {
+    return ConfigureReport();
+  }
   
   /** @} */
 
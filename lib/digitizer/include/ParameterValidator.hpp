@@ -8,6 +8,7 @@
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -22,6 +23,14 @@ namespace Digitizer
  * This class provides comprehensive validation of digitizer parameters
  * using device tree definitions, with support for custom validation rules,
  * detailed error reporting, and extensible validation types.
+ *
+ * The device tree is compiled once, at construction, into a flat hash
+ * index keyed by parameter path ("par/<name>", "ch/par/<name>").
+ * Channel parameters that are identical on every channel share a single
+ * channel-wildcard entry; only channels that differ get their own
+ * "ch/<n>/par/<name>" entry. Each entry holds the precomputed type, numeric range and
+ * allowed-value set, so validating a configuration does no JSON traversal.
+ * The device tree must outlive the validator.
  */
 class ParameterValidator
 {
@@ -74,6 +83,24 @@ class ParameterValidator
     Array
   };
 
+  /**
+   * @brief Precompiled definition of one device tree parameter
+   */
+  struct ParameterInfo {
+    ParameterType type = ParameterType::Unknown;
+    bool hasMin = false;
+    bool hasMax = false;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    std::string minText;  ///< Range limits as written in the device tree
+    std::string maxText;
+    std::vector<std::string> allowedValues;  ///< In device tree order
+    std::unordered_set<std::string> allowedLower;  ///< Lowercased, for lookup
+    const nlohmann::json *definition = nullptr;  ///< Node in the device tree
+
+    bool SameConstraints(const ParameterInfo &other) const;
+  };
+
   // Custom validation function type
   using CustomValidator = std::function<ValidationResult(
       const std::string &path, const std::string &value,
@@ -123,6 +150,8 @@ class ParameterValidator
   std::vector<std::string> GetAllowedValues(const std::string &paramPath) const;
 
   // Device tree utilities
+  const ParameterInfo *FindParameter(const std::string &paramPath) const;
+  size_t GetIndexSize() const { return index_.size(); }
   bool IsParameterSupported(const std::string &paramPath) const;
   std::vector<std::string> GetSupportedParameters() const;
   std::vector<std::string> GetChannelParameters(
@@ -150,6 +179,14 @@ class ParameterValidator
   std::map<std::string, CustomValidator> customValidators_;
   std::unordered_set<std::string> ignorePatterns_;
 
+  // Compiled device tree
+  std::unordered_map<std::string, ParameterInfo> index_;
+  std::unordered_set<std::string> channels_;
+  size_t channelOverrides_ = 0;  ///< Entries that differ from the wildcard
+
+  void BuildIndex();
+  ParameterInfo CompileParameter(const nlohmann::json &paramDef) const;
+
   // Parameter path processing
   std::vector<std::string> ExpandChannelRange(
       const std::string &configPath) const;
@@ -158,30 +195,27 @@ class ParameterValidator
                       const std::string &pattern) const;
 
   // Validation engine
-  ValidationResult ValidateParameterValue(const nlohmann::json &paramDef,
+  ValidationResult ValidateParameterValue(const ParameterInfo &info,
                                           const std::string &paramPath,
                                           const std::string &value) const;
-  ValidationResult ValidateNumberParameter(const nlohmann::json &paramDef,
+  ValidationResult ValidateNumberParameter(const ParameterInfo &info,
                                            const std::string &paramPath,
                                            const std::string &value) const;
-  ValidationResult ValidateIntegerParameter(const nlohmann::json &paramDef,
+  ValidationResult ValidateIntegerParameter(const ParameterInfo &info,
                                             const std::string &paramPath,
                                             const std::string &value) const;
-  ValidationResult ValidateStringParameter(const nlohmann::json &paramDef,
+  ValidationResult ValidateStringParameter(const ParameterInfo &info,
                                            const std::string &paramPath,
                                            const std::string &value) const;
-  ValidationResult ValidateBooleanParameter(const nlohmann::json &paramDef,
+  ValidationResult ValidateBooleanParameter(const ParameterInfo &info,
                                             const std::string &paramPath,
                                             const std::string &value) const;
-  ValidationResult ValidateEnumParameter(const nlohmann::json &paramDef,
+  ValidationResult ValidateEnumParameter(const ParameterInfo &info,
                                          const std::string &paramPath,
                                          const std::string &value) const;
-
-  // Device tree navigation
-  nlohmann::json GetParameterDefinition(const std::string &paramPath) const;
-  nlohmann::json GetChannelParameterDefinition(
-      const std::string &channel, const std::string &paramName) const;
-  nlohmann::json GetRootParameterDefinition(const std::string &paramName) const;
+  ValidationResult ValidateAllowedValue(const ParameterInfo &info,
+                                        const std::string &paramPath,
+                                        const std::string &value) const;
 
   // Utility methods
   std::string FormatValidationMessage(const ValidationResult &result) const;
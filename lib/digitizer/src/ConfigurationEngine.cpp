@@ -0,0 +1,246 @@
+#include "ConfigurationEngine.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <unordered_set>
+
+
+namespace DELILA
+{
+namespace Digitizer
+{
+
+namespace
+{
+
+// Channel range split out of a path like /ch/0..31/par/X
+struct ChannelRange {
+  std::string prefix;  // "/ch/"
+  std::string suffix;  // "/par/X"
+  int first = 0;
+  int last = 0;
+};
+
+bool ParseChannelRange(const std::string &path, ChannelRange &range)
+{
+  size_t chPos = path.find("/ch/");
+  if (chPos == std::string::npos) {
+    return false;
+  }
+
+  size_t rangeStart = chPos + 4;
+  size_t rangeEnd = path.find('/', rangeStart);
+  if (rangeEnd == std::string::npos) {
+    return false;
+  }
+
+  std::string rangeStr = path.substr(rangeStart, rangeEnd - rangeStart);
+  size_t dotDotPos = rangeStr.find("..");
+  if (dotDotPos == std::string::npos) {
+    return false;
+  }
+
+  try {
+    range.first = std::stoi(rangeStr.substr(0, dotDotPos));
+    range.last = std::stoi(rangeStr.substr(dotDotPos + 2));
+  } catch (const std::exception &) {
+    return false;
+  }
+
+  if (range.first < 0 || range.first > range.last || range.last > 1000) {
+    return false;
+  }
+
+  range.prefix = path.substr(0, rangeStart);
+  range.suffix = path.substr(rangeEnd);
+  return true;
+}
+
+std::string ChannelPath(const ChannelRange &range, int first, int last)
+{
+  if (first == last) {
+    return range.prefix + std::to_string(first) + range.suffix;
+  }
+  return range.prefix + std::to_string(first) + ".." + std::to_string(last) +
+         range.suffix;
+}
+
+}  // namespace
+
+// ============================================================================
+// ConfigureReport / PhaseTimer
+// ============================================================================
+
+void ConfigureReport::Print(std::ostream &os) const
+{
+  os << "Configure: " << std::fixed << std::setprecision(1) << totalMs
+     << " ms (";
+  for (size_t i = 0; i < phases.size(); ++i) {
+    if (i > 0) os << ", ";
+    os << phases[i].name << " " << phases[i].ms;
+  }
+  os << "), " << writes << " writes, " << unchanged << " unchanged, "
+     << failed << " failed" << (resetPerformed ? ", with reset" : "")
+     << std::endl;
+}
+
+PhaseTimer::PhaseTimer(ConfigureReport &report)
+    : fReport(report), fStart(Clock::now()), fLast(fStart)
+{
+}
+
+void PhaseTimer::Mark(const std::string &name)
+{
+  auto now = Clock::now();
+  fReport.phases.push_back(
+      {name, std::chrono::duration<double, std::milli>(now - fLast).count()});
+  fReport.totalMs =
+      std::chrono::duration<double, std::milli>(now - fStart).count();
+  fLast = now;
+}
+
+// ============================================================================
+// ParameterApplier
+// ============================================================================
+
+std::vector<ParameterApplier::Write> ParameterApplier::Plan(
+    const Config &config, size_t *unchanged) const
+{
+  std::vector<Write> writes;
+  size_t skipped = 0;
+
+  // Values planned earlier in this pass shadow the applied state, so a
+  // later line overriding part of an earlier range is diffed correctly
+  std::unordered_map<std::string, std::string> planned;
+  auto isCurrent = [&](const std::string &key, const std::string &value) {
+    auto it = planned.find(key);
+    if (it != planned.end()) return it->second == value;
+    auto applied = fApplied.find(key);
+    return applied != fApplied.end() && applied->second == value;
+  };
+
+  for (const auto &[path, value] : config) {
+    if (!IsDevicePath(path)) {
+      continue;
+    }
+
+    ChannelRange range;
+    if (!ParseChannelRange(path, range)) {
+      std::string key = NormalizePath(path);
+      if (isCurrent(key, value)) {
+        skipped++;
+      } else {
+        writes.push_back({path, value, 1});
+      }
+      planned[key] = value;
+      continue;
+    }
+
+    // Emit one write per run of consecutive changed channels
+    int runStart = -1;
+    for (int ch = range.first; ch <= range.last + 1; ++ch) {
+      bool changed = false;
+      if (ch <= range.last) {
+        std::string key = NormalizePath(ChannelPath(range, ch, ch));
+        changed = !isCurrent(key, value);
+        if (!changed) skipped++;
+        planned[key] = value;
+      }
+
+      if (changed && runStart < 0) {
+        runStart = ch;
+      } else if (!changed && runStart >= 0) {
+        writes.push_back({ChannelPath(range, runStart, ch - 1), value,
+                          static_cast<size_t>(ch - runStart)});
+        runStart = -1;
+      }
+    }
+  }
+
+  if (unchanged) {
+    *unchanged = skipped;
+  }
+  return writes;
+}
+
+bool ParameterApplier::NeedsReset(const Config &config) const
+{
+  if (fApplied.empty()) {
+    return true;
+  }
+
+  std::unordered_set<std::string> wanted;
+  wanted.reserve(fApplied.size());
+  for (const auto &[path, value] : config) {
+    if (!IsDevicePath(path)) {
+      continue;
+    }
+    for (const auto &expanded : ExpandChannels(path)) {
+      wanted.insert(NormalizePath(expanded));
+    }
+  }
+
+  for (const auto &[key, value] : fApplied) {
+    if (wanted.find(key) == wanted.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t ParameterApplier::Apply(const std::vector<Write> &writes,
+                               const Setter &setter)
+{
+  size_t failed = 0;
+
+  for (const auto &write : writes) {
+    bool ok = setter(write.path, write.value);
+    for (const auto &expanded : ExpandChannels(write.path)) {
+      if (ok) {
+        fApplied[NormalizePath(expanded)] = write.value;
+      } else {
+        // Board state unknown - make sure the next plan rewrites it
+        fApplied.erase(NormalizePath(expanded));
+      }
+    }
+    if (!ok) {
+      failed++;
+    }
+  }
+
+  return failed;
+}
+
+std::vector<std::string> ParameterApplier::ExpandChannels(
+    const std::string &path)
+{
+  ChannelRange range;
+  if (!ParseChannelRange(path, range)) {
+    return {path};
+  }
+
+  std::vector<std::string> expanded;
+  expanded.reserve(range.last - range.first + 1);
+  for (int ch = range.first; ch <= range.last; ++ch) {
+    expanded.push_back(ChannelPath(range, ch, ch));
+  }
+  return expanded;
+}
+
+bool ParameterApplier::IsDevicePath(const std::string &path)
+{
+  // Only parameters that start with '/' are CAEN digitizer paths
+  return !path.empty() && path[0] == '/';
+}
+
+std::string ParameterApplier::NormalizePath(const std::string &path)
+{
+  std::string lower = path;
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return lower;
+}
+
+}  // namespace Digitizer
+}  // namespace DELILA
@@ -80,20 +80,32 @@ bool Digitizer1::Initialize(const ConfigurationManager &config)
 
 bool Digitizer1::Configure()
 {
-  // Reset the digitizer to a known state
-  if (!ResetDigitizer()) {
-    return false;
+  fConfigureReport = ConfigureReport();
+  PhaseTimer timer(fConfigureReport);
+
+  // Reset the digitizer to a known state. On reconfiguration the reset is
+  // skipped when every applied parameter is still configured, so only the
+  // changed values are written.
+  if (fParameterApplier.NeedsReset(fConfig)) {
+    if (!ResetDigitizer()) {
+      return false;
+    }
+    fParameterApplier.Invalidate();
+    fConfigureReport.resetPerformed = true;
   }
+  timer.Mark("reset");
 
   // Validate parameters before applying them
   if (!ValidateParameters()) {
     std::cerr << "Parameter validation failed. Try to configure." << std::endl;
   }
+  timer.Mark("validate");
 
   // Apply all configuration parameters
   if (!ApplyConfiguration()) {
     return false;
   }
+  timer.Mark("apply");
 
   // Configure record length
   if (!ConfigureRecordLength()) {
@@ -120,7 +132,9 @@ bool Digitizer1::Configure()
     std::cerr << "Failed to enable fine timestamp" << std::endl;
     return false;
   }
+  timer.Mark("readout");
 
+  fConfigureReport.Print(std::cout);
   return true;
 }
 
@@ -332,6 +346,10 @@ bool Digitizer1::Open(const std::string &url)
 {
   std::cout << "Open URL: " << url << std::endl;
 
+  // New handle (re-open, power cycle): nothing is known to be applied, so
+  // the next Configure() resets the board and writes every parameter
+  fParameterApplier.Invalidate();
+
   // Try CAEN_FELib_Open up to 3 times
   constexpr int maxRetries = 3;
   int err = static_cast<int>(CAEN_FELib_InternalError);
@@ -597,15 +615,22 @@ bool Digitizer1::ResetDigitizer() { return SendCommand("/cmd/Reset"); }
 
 bool Digitizer1::ApplyConfiguration()
 {
-  bool status = true;
-
-  for (const auto &config : fConfig) {
-    // Only use parameters that start with '/' (CAEN digitizer paths)
-    if (!config[0].empty() && config[0][0] == '/') {
-      status &= SetParameter(config[0], config[1]);
-    }
-  }
-  return status;
+  // Write only the parameters that differ from what is already on the board
+  size_t unchanged = 0;
+  auto writes = fParameterApplier.Plan(fConfig, &unchanged);
+
+  fConfigureReport.unchanged = unchanged;
+  fConfigureReport.parameters = unchanged;
+  for (const auto &write : writes) {
+    fConfigureReport.parameters += write.channels;
+  }
+  fConfigureReport.writes = writes.size();
+  fConfigureReport.failed = fParameterApplier.Apply(
+      writes, [this](const std::string &path, const std::string &value) {
+        return SetParameter(path, value);
+      });
+
+  return fConfigureReport.failed == 0;
 }
 
 bool Digitizer1::ConfigureRecordLength()
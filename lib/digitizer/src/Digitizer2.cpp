@@ -96,20 +96,33 @@ bool Digitizer2::Initialize(const ConfigurationManager &config)
 
 bool Digitizer2::Configure()
 {
-  // Reset the digitizer to a known state
-  if (!ResetDigitizer()) {
-    return false;
+  fConfigureReport = ConfigureReport();
+  PhaseTimer timer(fConfigureReport);
+
+  // Reset the digitizer to a known state. On reconfiguration the reset is
+  // skipped when every applied parameter is still configured, so only the
+  // changed values are written (AMax register writes are not tracked).
+  if (fFirmwareType == FirmwareType::AMAX ||
+      fParameterApplier.NeedsReset(fConfig)) {
+    if (!ResetDigitizer()) {
+      return false;
+    }
+    fParameterApplier.Invalidate();
+    fConfigureReport.resetPerformed = true;
   }
+  timer.Mark("reset");
 
   // Validate parameters before applying them
   if (!ValidateParameters()) {
     std::cerr << "Parameter validation failed. Try configuration." << std::endl;
   }
+  timer.Mark("validate");
 
   // Apply all configuration parameters
   if (!ApplyConfiguration()) {
     return false;
   }
+  timer.Mark("apply");
 
   // Configure record length (skip for AMax - uses registers instead)
   if (fFirmwareType != FirmwareType::AMAX) {
@@ -142,7 +155,9 @@ bool Digitizer2::Configure()
   if (!ConfigureSampleRate()) {
     return false;
   }
+  timer.Mark("readout");
 
+  fConfigureReport.Print(std::cout);
   return true;
 }
 
@@ -159,15 +174,23 @@ bool Digitizer2::ApplyConfiguration()
     return ConfigureAMax();
   }
 
-  // Standard configuration for other firmware types
-  bool status = true;
-  for (const auto &config : fConfig) {
-    // Only use parameters that start with '/' (CAEN digitizer paths)
-    if (!config[0].empty() && config[0][0] == '/') {
-      status &= SetParameter(config[0], config[1]);
-    }
+  // Standard configuration for other firmware types: write only the
+  // parameters that differ from what is already on the board
+  size_t unchanged = 0;
+  auto writes = fParameterApplier.Plan(fConfig, &unchanged);
+
+  fConfigureReport.unchanged = unchanged;
+  fConfigureReport.parameters = unchanged;
+  for (const auto &write : writes) {
+    fConfigureReport.parameters += write.channels;
   }
-  return status;
+  fConfigureReport.writes = writes.size();
+  fConfigureReport.failed = fParameterApplier.Apply(
+      writes, [this](const std::string &path, const std::string &value) {
+        return SetParameter(path, value);
+      });
+
+  return fConfigureReport.failed == 0;
 }
 
 bool Digitizer2::ConfigureRecordLength()
@@ -523,6 +546,10 @@ bool Digitizer2::Open(const std::string &url)
 {
   std::cout << "Open URL: " << url << std::endl;
 
+  // New handle (re-open, power cycle): nothing is known to be applied, so
+  // the next Configure() resets the board and writes every parameter
+  fParameterApplier.Invalidate();
+
   // Try CAEN_FELib_Open up to 3 times
   constexpr int maxRetries = 3;
   int err = static_cast<int>(CAEN_FELib_InternalError);
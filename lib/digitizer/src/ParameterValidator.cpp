@@ -20,6 +20,158 @@ namespace Digitizer
 ParameterValidator::ParameterValidator(const nlohmann::json &deviceTree)
     : deviceTree_(deviceTree)
 {
+  BuildIndex();
+}
+
+bool ParameterValidator::ParameterInfo::SameConstraints(
+    const ParameterInfo &other) const
+{
+  return type == other.type && hasMin == other.hasMin &&
+         hasMax == other.hasMax && minText == other.minText &&
+         maxText == other.maxText && allowedValues == other.allowedValues;
+}
+
+// ============================================================================
+// Device Tree Index
+// ============================================================================
+
+void ParameterValidator::BuildIndex()
+{
+  index_.clear();
+  channels_.clear();
+  channelOverrides_ = 0;
+
+  auto lower = [](std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    return str;
+  };
+
+  if (deviceTree_.contains("par") && deviceTree_["par"].is_object()) {
+    for (const auto &[name, paramDef] : deviceTree_["par"].items()) {
+      if (paramDef.is_object()) {
+        index_.emplace("par/" + lower(name), CompileParameter(paramDef));
+      }
+    }
+  }
+
+  if (!deviceTree_.contains("ch") || !deviceTree_["ch"].is_object()) {
+    return;
+  }
+
+  // Channel parameters are collapsed into one "ch/par/<name>" entry; a
+  // channel whose definition differs gets its own "ch/<n>/par/<name>"
+  for (const auto &[channel, channelNode] : deviceTree_["ch"].items()) {
+    if (!channelNode.is_object()) {
+      continue;  // "handle"
+    }
+    channels_.insert(channel);
+
+    if (!channelNode.contains("par") || !channelNode["par"].is_object()) {
+      continue;
+    }
+
+    for (const auto &[name, paramDef] : channelNode["par"].items()) {
+      if (!paramDef.is_object()) {
+        continue;
+      }
+
+      std::string paramName = lower(name);
+      auto info = CompileParameter(paramDef);
+      auto it = index_.find("ch/par/" + paramName);
+      if (it == index_.end()) {
+        index_.emplace("ch/par/" + paramName, std::move(info));
+      } else if (!it->second.SameConstraints(info)) {
+        index_.emplace("ch/" + channel + "/par/" + paramName, std::move(info));
+        channelOverrides_++;
+      }
+    }
+  }
+}
+
+ParameterValidator::ParameterInfo ParameterValidator::CompileParameter(
+    const nlohmann::json &paramDef) const
+{
+  ParameterInfo info;
+  info.definition = &paramDef;
+  info.type = ParseParameterType(paramDef);
+
+  auto readLimit = [&paramDef](const char *key, std::string &text,
+                               double &value) {
+    if (!paramDef.contains(key) || !paramDef[key].is_object() ||
+        !paramDef[key].contains("value") ||
+        !paramDef[key]["value"].is_string()) {
+      return false;
+    }
+    text = paramDef[key]["value"].get<std::string>();
+    try {
+      value = std::stod(text);
+    } catch (const std::exception &) {
+      return false;
+    }
+    return true;
+  };
+  info.hasMin = readLimit("minvalue", info.minText, info.minValue);
+  info.hasMax = readLimit("maxvalue", info.maxText, info.maxValue);
+
+  // allowedvalues: {"0": {"value": ...}, "1": ..., "handle": .., "value": N}
+  if (paramDef.contains("allowedvalues") &&
+      paramDef["allowedvalues"].is_object()) {
+    const auto &allowed = paramDef["allowedvalues"];
+    for (size_t i = 0;; ++i) {
+      auto key = std::to_string(i);
+      if (!allowed.contains(key) || !allowed[key].is_object() ||
+          !allowed[key].contains("value")) {
+        break;
+      }
+      auto value = allowed[key]["value"].get<std::string>();
+      std::string valueLower = value;
+      std::transform(valueLower.begin(), valueLower.end(), valueLower.begin(),
+                     ::tolower);
+      info.allowedValues.push_back(std::move(value));
+      info.allowedLower.insert(std::move(valueLower));
+    }
+  }
+
+  return info;
+}
+
+const ParameterValidator::ParameterInfo *ParameterValidator::FindParameter(
+    const std::string &paramPath) const
+{
+  std::string paramName = MapConfigToDeviceTree(paramPath);
+  if (paramName.empty()) {
+    return nullptr;
+  }
+
+  std::unordered_map<std::string, ParameterInfo>::const_iterator it;
+
+  size_t chPos = paramPath.find("/ch/");
+  if (chPos != std::string::npos) {
+    size_t chStart = chPos + 4;
+    size_t chEnd = paramPath.find('/', chStart);
+    if (chEnd == std::string::npos) {
+      return nullptr;
+    }
+
+    std::string channel = paramPath.substr(chStart, chEnd - chStart);
+    if (channels_.find(channel) == channels_.end()) {
+      return nullptr;
+    }
+
+    if (channelOverrides_ > 0) {
+      it = index_.find("ch/" + channel + "/par/" + paramName);
+      if (it != index_.end()) {
+        return &it->second;
+      }
+    }
+    it = index_.find("ch/par/" + paramName);
+  } else if (paramPath.find("/par/") != std::string::npos) {
+    it = index_.find("par/" + paramName);
+  } else {
+    return nullptr;
+  }
+
+  return it != index_.end() ? &it->second : nullptr;
 }
 
 // ============================================================================
@@ -108,18 +260,18 @@ ParameterValidator::ValidationResult
 ParameterValidator::ValidateSingleParameter(const std::string &paramPath,
                                             const std::string &value)
 {
+  const ParameterInfo *info = FindParameter(paramPath);
+
   // Check custom validators first
   for (const auto &[pattern, validator] : customValidators_) {
     if (MatchesPattern(paramPath, pattern)) {
-      auto paramDef = GetParameterDefinition(paramPath);
-      return validator(paramPath, value, paramDef);
+      static const nlohmann::json emptyDef;
+      return validator(paramPath, value,
+                       info ? *info->definition : emptyDef);
     }
   }
 
-  // Get parameter definition from device tree
-  nlohmann::json paramDef = GetParameterDefinition(paramPath);
-
-  if (paramDef.empty()) {
+  if (!info) {
     if (allowUnknownParameters_) {
       return ValidationResult(true, paramPath, value, "",
                               "Parameter not found in device tree");
@@ -130,7 +282,7 @@ ParameterValidator::ValidateSingleParameter(const std::string &paramPath,
   }
 
   // Validate based on parameter definition
-  return ValidateParameterValue(paramDef, paramPath, value);
+  return ValidateParameterValue(*info, paramPath, value);
 }
 
 // ============================================================================
@@ -177,25 +329,76 @@ bool ParameterValidator::IsIgnored(const std::string &paramPath) const
 ParameterValidator::ParameterType ParameterValidator::GetParameterType(
     const std::string &paramPath) const
 {
-  auto paramDef = GetParameterDefinition(paramPath);
-  return ParseParameterType(paramDef);
+  const ParameterInfo *info = FindParameter(paramPath);
+  return info ? info->type : ParameterType::Unknown;
 }
 
 std::optional<std::string> ParameterValidator::GetParameterDescription(
     const std::string &paramPath) const
 {
-  auto paramDef = GetParameterDefinition(paramPath);
-  if (paramDef.contains("description") &&
-      paramDef["description"].contains("value")) {
-    return paramDef["description"]["value"].get<std::string>();
+  const ParameterInfo *info = FindParameter(paramPath);
+  if (info && info->definition->contains("description") &&
+      (*info->definition)["description"].contains("value")) {
+    return (*info->definition)["description"]["value"].get<std::string>();
   }
   return std::nullopt;
 }
 
+std::optional<std::pair<std::string, std::string>>
+ParameterValidator::GetParameterRange(const std::string &paramPath) const
+{
+  const ParameterInfo *info = FindParameter(paramPath);
+  if (!info || !info->hasMin || !info->hasMax) {
+    return std::nullopt;
+  }
+  return std::make_pair(info->minText, info->maxText);
+}
+
+std::vector<std::string> ParameterValidator::GetAllowedValues(
+    const std::string &paramPath) const
+{
+  const ParameterInfo *info = FindParameter(paramPath);
+  return info ? info->allowedValues : std::vector<std::string>();
+}
+
 bool ParameterValidator::IsParameterSupported(
     const std::string &paramPath) const
 {
-  return !GetParameterDefinition(paramPath).empty();
+  return FindParameter(paramPath) != nullptr;
+}
+
+std::vector<std::string> ParameterValidator::GetSupportedParameters() const
+{
+  // Index keys as device paths; channel parameters are listed once as
+  // /ch/<n>/par/<name> with a literal "<n>"
+  std::vector<std::string> params;
+  params.reserve(index_.size());
+  for (const auto &[key, info] : index_) {
+    if (key.compare(0, 7, "ch/par/") == 0) {
+      params.push_back("/ch/<n>/par/" + key.substr(7));
+    } else if (key.compare(0, 4, "par/") == 0) {
+      params.push_back("/" + key);
+    }
+  }
+  std::sort(params.begin(), params.end());
+  return params;
+}
+
+std::vector<std::string> ParameterValidator::GetChannelParameters(
+    const std::string &channel) const
+{
+  std::vector<std::string> params;
+  if (channels_.find(channel) == channels_.end()) {
+    return params;
+  }
+
+  for (const auto &[key, info] : index_) {
+    if (key.compare(0, 7, "ch/par/") == 0) {
+      params.push_back("/ch/" + channel + "/par/" + key.substr(7));
+    }
+  }
+  std::sort(params.begin(), params.end());
+  return params;
 }
 
 // ============================================================================
@@ -289,22 +492,20 @@ bool ParameterValidator::MatchesPattern(const std::string &path,
 // ============================================================================
 
 ParameterValidator::ValidationResult ParameterValidator::ValidateParameterValue(
-    const nlohmann::json &paramDef, const std::string &paramPath,
+    const ParameterInfo &info, const std::string &paramPath,
     const std::string &value) const
 {
-  ParameterType type = ParseParameterType(paramDef);
-
-  switch (type) {
+  switch (info.type) {
     case ParameterType::Number:
-      return ValidateNumberParameter(paramDef, paramPath, value);
+      return ValidateNumberParameter(info, paramPath, value);
     case ParameterType::Integer:
-      return ValidateIntegerParameter(paramDef, paramPath, value);
+      return ValidateIntegerParameter(info, paramPath, value);
     case ParameterType::String:
-      return ValidateStringParameter(paramDef, paramPath, value);
+      return ValidateStringParameter(info, paramPath, value);
     case ParameterType::Boolean:
-      return ValidateBooleanParameter(paramDef, paramPath, value);
+      return ValidateBooleanParameter(info, paramPath, value);
     case ParameterType::Enum:
-      return ValidateEnumParameter(paramDef, paramPath, value);
+      return ValidateEnumParameter(info, paramPath, value);
     default:
       return ValidationResult(true, paramPath, value, "",
                               "Unknown parameter type");
@@ -312,35 +513,23 @@ ParameterValidator::ValidationResult ParameterValidator::ValidateParameterValue(
 }
 
 ParameterValidator::ValidationResult
-ParameterValidator::ValidateNumberParameter(const nlohmann::json &paramDef,
+ParameterValidator::ValidateNumberParameter(const ParameterInfo &info,
                                             const std::string &paramPath,
                                             const std::string &value) const
 {
   try {
     double numValue = std::stod(value);
 
-    if (paramDef.contains("minvalue") &&
-        paramDef["minvalue"].contains("value")) {
-      double minVal =
-          std::stod(paramDef["minvalue"]["value"].get<std::string>());
-      if (numValue < minVal) {
-        return ValidationResult(
-            false, paramPath, value,
-            "Value " + value + " below minimum: " +
-                paramDef["minvalue"]["value"].get<std::string>());
-      }
+    if (info.hasMin && numValue < info.minValue) {
+      return ValidationResult(
+          false, paramPath, value,
+          "Value " + value + " below minimum: " + info.minText);
     }
 
-    if (paramDef.contains("maxvalue") &&
-        paramDef["maxvalue"].contains("value")) {
-      double maxVal =
-          std::stod(paramDef["maxvalue"]["value"].get<std::string>());
-      if (numValue > maxVal) {
-        return ValidationResult(
-            false, paramPath, value,
-            "Value " + value + " above maximum: " +
-                paramDef["maxvalue"]["value"].get<std::string>());
-      }
+    if (info.hasMax && numValue > info.maxValue) {
+      return ValidationResult(
+          false, paramPath, value,
+          "Value " + value + " above maximum: " + info.maxText);
     }
 
     return ValidationResult(true, paramPath, value);
@@ -350,33 +539,25 @@ ParameterValidator::ValidateNumberParameter(const nlohmann::json &paramDef,
 }
 
 ParameterValidator::ValidationResult
-ParameterValidator::ValidateIntegerParameter(const nlohmann::json &paramDef,
+ParameterValidator::ValidateIntegerParameter(const ParameterInfo &info,
                                              const std::string &paramPath,
                                              const std::string &value) const
 {
   try {
-    int intValue = std::stoi(value);
-
-    if (paramDef.contains("minvalue") &&
-        paramDef["minvalue"].contains("value")) {
-      int minVal = std::stoi(paramDef["minvalue"]["value"].get<std::string>());
-      if (intValue < minVal) {
-        return ValidationResult(
-            false, paramPath, value,
-            "Value " + value + " below minimum: " +
-                paramDef["minvalue"]["value"].get<std::string>());
-      }
+    // 64-bit registers: parse as long long and compare in double, since
+    // the limits need not fit in an int
+    const double intValue = static_cast<double>(std::stoll(value));
+
+    if (info.hasMin && intValue < info.minValue) {
+      return ValidationResult(
+          false, paramPath, value,
+          "Value " + value + " below minimum: " + info.minText);
     }
 
-    if (paramDef.contains("maxvalue") &&
-        paramDef["maxvalue"].contains("value")) {
-      int maxVal = std::stoi(paramDef["maxvalue"]["value"].get<std::string>());
-      if (intValue > maxVal) {
-        return ValidationResult(
-            false, paramPath, value,
-            "Value " + value + " above maximum: " +
-                paramDef["maxvalue"]["value"].get<std::string>());
-      }
+    if (info.hasMax && intValue > info.maxValue) {
+      return ValidationResult(
+          false, paramPath, value,
+          "Value " + value + " above maximum: " + info.maxText);
     }
 
     return ValidationResult(true, paramPath, value);
@@ -386,16 +567,16 @@ ParameterValidator::ValidateIntegerParameter(const nlohmann::json &paramDef,
 }
 
 ParameterValidator::ValidationResult
-ParameterValidator::ValidateStringParameter(const nlohmann::json &paramDef,
+ParameterValidator::ValidateStringParameter(const ParameterInfo &info,
                                             const std::string &paramPath,
                                             const std::string &value) const
 {
-  // Basic string validation - can be extended for allowed values
-  return ValidationResult(true, paramPath, value);
+  // Free-form unless the device tree lists allowed values
+  return ValidateAllowedValue(info, paramPath, value);
 }
 
 ParameterValidator::ValidationResult
-ParameterValidator::ValidateBooleanParameter(const nlohmann::json &paramDef,
+ParameterValidator::ValidateBooleanParameter(const ParameterInfo & /*info*/,
                                              const std::string &paramPath,
                                              const std::string &value) const
 {
@@ -412,56 +593,35 @@ ParameterValidator::ValidateBooleanParameter(const nlohmann::json &paramDef,
 }
 
 ParameterValidator::ValidationResult ParameterValidator::ValidateEnumParameter(
-    const nlohmann::json &paramDef, const std::string &paramPath,
+    const ParameterInfo &info, const std::string &paramPath,
     const std::string &value) const
 {
-  // Enum validation would check against allowed values
-  return ValidationResult(true, paramPath, value);
+  return ValidateAllowedValue(info, paramPath, value);
 }
 
-// ============================================================================
-// Device Tree Navigation
-// ============================================================================
-
-nlohmann::json ParameterValidator::GetParameterDefinition(
-    const std::string &paramPath) const
+ParameterValidator::ValidationResult ParameterValidator::ValidateAllowedValue(
+    const ParameterInfo &info, const std::string &paramPath,
+    const std::string &value) const
 {
-  if (paramPath.find("/ch/") != std::string::npos) {
-    size_t chStart = paramPath.find("/ch/") + 4;
-    size_t chEnd = paramPath.find("/", chStart);
-
-    if (chEnd == std::string::npos) return nlohmann::json();
-
-    std::string channel = paramPath.substr(chStart, chEnd - chStart);
-    std::string paramName = MapConfigToDeviceTree(paramPath);
-
-    return GetChannelParameterDefinition(channel, paramName);
-  } else if (paramPath.find("/par/") != std::string::npos) {
-    std::string paramName = MapConfigToDeviceTree(paramPath);
-    return GetRootParameterDefinition(paramName);
+  if (info.allowedLower.empty()) {
+    return ValidationResult(true, paramPath, value);
   }
 
-  return nlohmann::json();
-}
-
-nlohmann::json ParameterValidator::GetChannelParameterDefinition(
-    const std::string &channel, const std::string &paramName) const
-{
-  if (deviceTree_.contains("ch") && deviceTree_["ch"].contains(channel) &&
-      deviceTree_["ch"][channel].contains("par") &&
-      deviceTree_["ch"][channel]["par"].contains(paramName)) {
-    return deviceTree_["ch"][channel]["par"][paramName];
+  // FELib compares enumerated values case-insensitively
+  std::string lowerValue = value;
+  std::transform(lowerValue.begin(), lowerValue.end(), lowerValue.begin(),
+                 ::tolower);
+  if (info.allowedLower.count(lowerValue) > 0) {
+    return ValidationResult(true, paramPath, value);
   }
-  return nlohmann::json();
-}
 
-nlohmann::json ParameterValidator::GetRootParameterDefinition(
-    const std::string &paramName) const
-{
-  if (deviceTree_.contains("par") && deviceTree_["par"].contains(paramName)) {
-    return deviceTree_["par"][paramName];
+  std::string allowed;
+  for (const auto &candidate : info.allowedValues) {
+    if (!allowed.empty()) allowed += ", ";
+    allowed += candidate;
   }
-  return nlohmann::json();
+  return ValidationResult(false, paramPath, value,
+                          "Value not allowed (allowed: " + allowed + ")");
 }
 
 // ============================================================================
@@ -7,9 +7,13 @@
 #include <utility>
 #include <vector>
 
+#include "../../../include/delila/core/BuiltEventData.hpp"
+#include "../../../include/delila/core/CalibratedEventData.hpp"
 #include "../../../include/delila/core/EventData.hpp"
 #include "../../../include/delila/core/MinimalEventData.hpp"
 
+using DELILA::Digitizer::BuiltEventData;
+using DELILA::Digitizer::CalibratedEventData;
 using DELILA::Digitizer::EventData;
 using DELILA::Digitizer::MinimalEventData;
 
@@ -30,10 +34,15 @@ struct BinaryDataHeader {
   uint64_t timestamp;  // 8 bytes: Unix timestamp in nanoseconds since epoch
   uint8_t compression_type;  // 1 byte: 0=none
   uint8_t checksum_type;     // 1 byte: 0=none, 1=CRC32
-  uint8_t message_type;      // 1 byte: 0=Data, 2=EndOfStream
-  uint8_t reserved[13];      // 13 bytes: future use
+  uint8_t message_type;      // 1 byte: 0=Data, 2=EOS, 3=Retransmit request
+  uint8_t source_id;         // 1 byte: merger input + 1, 0=not merged
+  uint8_t merge_sequence[8];  // 8 bytes: position in the merged stream
+  uint8_t frame_flags;        // 1 byte: FRAME_FLAG_* bits, 0=none
+  uint8_t reserved[2];        // 2 bytes: future use
 };  // Total: 64 bytes
 
+static_assert(sizeof(BinaryDataHeader) == 64, "BinaryDataHeader is 64 bytes");
+
 constexpr uint32_t BINARY_DATA_HEADER_SIZE = 64;
 constexpr uint64_t BINARY_DATA_MAGIC_NUMBER =
     0x44454C494C413200;  // "DELILA2\0"
@@ -43,6 +52,12 @@ constexpr uint32_t FORMAT_VERSION_EVENTDATA =
     1;  // Full EventData with waveforms
 constexpr uint32_t FORMAT_VERSION_MINIMAL_EVENTDATA =
     2;  // MinimalEventData (22 bytes)
+constexpr uint32_t FORMAT_VERSION_BUILT_EVENTDATA =
+    3;  // Coincidence events of MinimalEventData hits (EventBuilder)
+constexpr uint32_t FORMAT_VERSION_CALIBRATED_EVENTDATA =
+    4;  // CalibratedEventData (28 bytes, CalibrationStage)
+constexpr uint32_t FORMAT_VERSION_COMPACT_EVENTDATA =
+    5;  // EventData with int16 analog and bit-packed digital probes
 
 // Compression type constants (LZ4 removed - not used)
 constexpr uint8_t COMPRESSION_NONE = 0;
@@ -54,6 +69,22 @@ constexpr uint8_t CHECKSUM_CRC32 = 1;
 // Message type constants for data stream
 constexpr uint8_t MESSAGE_TYPE_DATA = 0;
 constexpr uint8_t MESSAGE_TYPE_EOS = 2;  // End Of Stream
+// Receiver -> sender on the retransmit side channel (see GapRecovery)
+constexpr uint8_t MESSAGE_TYPE_RETRANSMIT_REQUEST = 3;
+
+// Frame flag bits (BinaryDataHeader::frame_flags)
+// Waveforms of events in the frame numbered one before (WaveformReducer)
+constexpr uint8_t FRAME_FLAG_WAVEFORM_COMPANION = 0x01;
+
+// Where one event record lies in a frame, with the fields it is routed by
+// (for built events those of the trigger hit)
+struct EventRecordRef {
+  uint32_t offset;  // From the start of the frame
+  uint32_t size;    // Bytes, including any per-record header
+  uint8_t module;
+  uint8_t channel;
+  double timeStampNs;
+};
 
 class DataProcessor
 {
@@ -65,6 +96,23 @@ class DataProcessor
   void EnableChecksum(bool enable = true) { checksum_enabled_ = enable; }
   bool IsChecksumEnabled() const { return checksum_enabled_; }
 
+  // Write EventData as format version 5: analog probes as int16_t, each
+  // digital probe as a bit plane. A frame with samples that do not fit
+  // (analog outside int16_t, digital other than 0/1) is written as
+  // version 1. Decode() reads both.
+  void EnableCompactWaveforms(bool enable = true)
+  {
+    compact_waveforms_ = enable;
+  }
+  bool IsCompactWaveformsEnabled() const { return compact_waveforms_; }
+
+  // Full EventData frames, in either encoding (format version 1 or 5)
+  static bool IsEventDataFormat(uint32_t format_version)
+  {
+    return format_version == FORMAT_VERSION_EVENTDATA ||
+           format_version == FORMAT_VERSION_COMPACT_EVENTDATA;
+  }
+
   // Main processing methods
   std::unique_ptr<std::vector<uint8_t>> Process(
       const std::unique_ptr<std::vector<std::unique_ptr<EventData>>> &events,
@@ -82,6 +130,43 @@ class DataProcessor
             uint64_t>
   DecodeMinimal(const std::unique_ptr<std::vector<uint8_t>> &data);
 
+  // Minimal events into one contiguous batch (replaces its contents), for
+  // hot paths that would otherwise allocate every event
+  bool DecodeMinimal(const std::vector<uint8_t> &data,
+                     std::vector<MinimalEventData> &events,
+                     uint64_t &sequence_number);
+
+  // Built (coincidence) events, format version 3
+  std::unique_ptr<std::vector<uint8_t>> Process(
+      const std::unique_ptr<std::vector<std::unique_ptr<BuiltEventData>>>
+          &events,
+      uint64_t sequence_number);
+
+  std::pair<std::unique_ptr<std::vector<std::unique_ptr<BuiltEventData>>>,
+            uint64_t>
+  DecodeBuilt(const std::unique_ptr<std::vector<uint8_t>> &data);
+
+  // Calibrated events, format version 4
+  std::unique_ptr<std::vector<uint8_t>> Process(
+      const std::unique_ptr<std::vector<std::unique_ptr<CalibratedEventData>>>
+          &events,
+      uint64_t sequence_number);
+
+  std::pair<std::unique_ptr<std::vector<std::unique_ptr<CalibratedEventData>>>,
+            uint64_t>
+  DecodeCalibrated(const std::unique_ptr<std::vector<uint8_t>> &data);
+
+  // Append one built event record (BuiltEventRecordHeader + hits) to a
+  // payload, for producers that serialize without building BuiltEventData
+  static void AppendBuiltEvent(std::vector<uint8_t> &payload,
+                               const MinimalEventData *hits,
+                               uint32_t hit_count, uint32_t trigger_index);
+
+  // Fill in the header of a frame whose payload was written after
+  // BINARY_DATA_HEADER_SIZE reserved bytes (checksum as configured)
+  bool FinalizeFrame(std::vector<uint8_t> &frame, uint32_t format_version,
+                     uint32_t event_count, uint64_t sequence_number);
+
   // Sequence number management
   uint64_t GetNextSequence();
   uint64_t GetCurrentSequence() const;
@@ -102,8 +187,45 @@ class DataProcessor
   static bool IsEOSMessage(const std::vector<uint8_t> &data);
   static bool IsEOSMessage(const uint8_t *data, size_t size);
 
+  // Copy out the header without touching the payload (no checksum check).
+  // Returns false if the frame is too short or the magic number is wrong.
+  static bool PeekHeader(const std::vector<uint8_t> &data,
+                         BinaryDataHeader &header);
+  static bool PeekHeader(const uint8_t *data, size_t size,
+                         BinaryDataHeader &header);
+
+  // Merger stamp (see SimpleMerger). Header bytes only: the payload
+  // checksum stays valid.
+  static uint64_t GetMergeSequence(const BinaryDataHeader &header);
+  static bool SetSourceId(std::vector<uint8_t> &data, uint8_t source_id);
+  static bool SetMergeSequence(std::vector<uint8_t> &data,
+                               uint64_t merge_sequence);
+  static bool SetFrameFlags(std::vector<uint8_t> &data, uint8_t frame_flags);
+
+  // Sequence of the stream a frame arrived in: the merge sequence of a
+  // merged frame, else the sequence number its source gave it
+  static uint64_t GetStreamSequence(const BinaryDataHeader &header);
+
+  // Renumber a frame: its sequence number and, for a merged frame, the
+  // merge sequence that downstream follows instead (header only)
+  static bool SetStreamSequence(std::vector<uint8_t> &data, uint64_t sequence);
+
+  // Carry the source timestamp, merger stamp and frame flags of a frame
+  // over to one made from it, whose header Process() or FinalizeFrame()
+  // filled in afresh (header only)
+  static bool CopySourceStamps(const BinaryDataHeader &source,
+                               std::vector<uint8_t> &data);
+
+  // Locate the event records of a data frame (formats 1-4) without
+  // decoding them, so records can be regrouped by copying bytes (no
+  // checksum check). Returns false if the frame is not a data frame or
+  // its records do not add up to the payload.
+  static bool ScanRecords(const std::vector<uint8_t> &data,
+                          std::vector<EventRecordRef> &records);
+
  private:
   bool checksum_enabled_ = true;  // Default: CRC32 checksum ON
+  bool compact_waveforms_ = false;  // Default: format version 1
 
   // Sequence counter for auto-sequence processing
   std::atomic<uint64_t> sequence_counter_{0};
@@ -119,6 +241,14 @@ class DataProcessor
   std::unique_ptr<std::vector<std::unique_ptr<EventData>>> Deserialize(
       const std::unique_ptr<std::vector<uint8_t>> &data);
 
+  // Format version 5
+  static bool FitsCompact(
+      const std::vector<std::unique_ptr<EventData>> &events);
+  std::unique_ptr<std::vector<uint8_t>> SerializeCompact(
+      const std::vector<std::unique_ptr<EventData>> &events);
+  std::unique_ptr<std::vector<std::unique_ptr<EventData>>> DeserializeCompact(
+      const uint8_t *data, size_t size);
+
   std::unique_ptr<std::vector<std::unique_ptr<MinimalEventData>>>
   DeserializeMinimal(const std::unique_ptr<std::vector<uint8_t>> &data);
 
@@ -0,0 +1,142 @@
+/**
+ * @file GapRecovery.hpp
+ * @brief Receiver side of reliable delivery: turns sequence gaps into
+ *        retransmission requests
+ *
+ * SequenceGapDetector only reports that frames were lost. In reliable
+ * delivery mode the receiver also remembers which sequence numbers are
+ * missing, asks the sender to resend them over a side channel (the
+ * sender answers from its ReplayBuffer) and accounts for every missing
+ * frame as either recovered or, after a timeout, lost.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "SequenceGapDetector.hpp"
+
+namespace DELILA {
+namespace Net {
+
+/**
+ * @brief Tracks missing sequence numbers and when to request them
+ *
+ * Retransmitted frames arrive after later frames, so they are accepted
+ * out of order; frames that are neither new nor missing are duplicates
+ * (a frame requested twice and sent twice) and should be dropped.
+ * Sequence numbers are expected to start at 0 each run, so frames lost
+ * before the first one received are recovered as well.
+ *
+ * Accept() and TakeRequests() are called from the receiving thread only;
+ * the counters can be read from any thread.
+ *
+ * Usage:
+ *   GapRecovery recovery;
+ *   for each received frame:
+ *       if (recovery.Accept(header.sequence_number, now) ==
+ *           GapRecovery::Outcome::Duplicate) continue;
+ *       ... handle frame ...
+ *   periodically (also when nothing arrives):
+ *       for (auto &range : recovery.TakeRequests(now))
+ *           repair.SendBytes(GapRecovery::EncodeRequest(range));
+ */
+class GapRecovery {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Inclusive range of sequence numbers
+    struct Range {
+        uint64_t first;
+        uint64_t last;
+    };
+
+    enum class Outcome {
+        InOrder,    ///< Next expected frame
+        Gap,        ///< Frame after a gap; the frames before it are missing
+        Recovered,  ///< A missing frame arrived (retransmitted)
+        Duplicate   ///< Already received, or given up on: drop it
+    };
+
+    static constexpr size_t kDefaultMaxMissing = 65536;
+
+    GapRecovery() = default;
+
+    /// Time between requests for a frame that is still missing (default 100 ms)
+    void SetRetryInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds GetRetryInterval() const { return retry_interval_; }
+
+    /// Time after which a missing frame counts as lost (default 5 s)
+    void SetTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds GetTimeout() const { return timeout_; }
+
+    /// Most frames tracked as missing; beyond it the oldest count as lost
+    void SetMaxMissing(size_t frames);
+
+    /**
+     * @brief Account for a received frame
+     * @param recoveryNs Set to the time since the gap was detected when the
+     *                   outcome is Recovered
+     */
+    Outcome Accept(uint64_t sequence, Clock::time_point now,
+                   uint64_t* recoveryNs = nullptr);
+
+    /**
+     * @brief Ranges to request now
+     *
+     * Returns the missing frames whose retry time has come, coalesced into
+     * ranges, and schedules their next request. Frames missing for longer
+     * than the timeout are dropped from tracking and counted as lost.
+     */
+    std::vector<Range> TakeRequests(Clock::time_point now);
+
+    /// Forget all state and counters (call at the start of a run)
+    void Reset();
+
+    /// Frames currently missing (requested, not yet recovered or lost)
+    size_t GetMissing() const { return missing_count_.load(); }
+    uint64_t GetGapCount() const { return gaps_.load(); }
+    uint64_t GetRequestsSent() const { return requests_.load(); }
+    uint64_t GetRecovered() const { return recovered_.load(); }
+    uint64_t GetLost() const { return lost_.load(); }
+    uint64_t GetDuplicates() const { return duplicates_.load(); }
+
+    // === Side channel messages ===
+
+    /// Retransmission request: a header-only frame (MESSAGE_TYPE_RETRANSMIT_REQUEST)
+    /// with the first sequence in the header and the last as payload
+    static std::unique_ptr<std::vector<uint8_t>> EncodeRequest(const Range& range);
+    static bool DecodeRequest(const std::vector<uint8_t>& data, Range& range);
+
+private:
+    struct Missing {
+        Clock::time_point detected;
+        Clock::time_point nextRequest;
+    };
+
+    void AddMissing(uint64_t first, uint64_t last, Clock::time_point now);
+    void UpdateMissingCount() { missing_count_.store(missing_.size()); }
+
+    std::chrono::milliseconds retry_interval_{100};
+    std::chrono::milliseconds timeout_{5000};
+    size_t max_missing_ = kDefaultMaxMissing;
+
+    SequenceGapDetector detector_;
+    std::map<uint64_t, Missing> missing_;
+
+    std::atomic<size_t> missing_count_{0};
+    std::atomic<uint64_t> gaps_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> recovered_{0};
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> duplicates_{0};
+};
+
+}  // namespace Net
+}  // namespace DELILA
@@ -0,0 +1,93 @@
+/**
+ * @file ReplayBuffer.hpp
+ * @brief Bounded store of recently sent frames, for retransmission
+ *
+ * In reliable delivery mode a sender keeps a copy of the last frames it
+ * sent, keyed by BinaryDataHeader::sequence_number, so that frames a
+ * receiver reports missing (see GapRecovery) can be sent again.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace DELILA {
+namespace Net {
+
+/**
+ * @brief FIFO of sent frames bounded by frame count and bytes
+ *
+ * Frames must be stored in increasing sequence order (as
+ * DataProcessor::ProcessWithAutoSequence produces them); lookups are a
+ * binary search. When either bound is exceeded the oldest frames are
+ * evicted and their buffers reused for new frames, so a full buffer stores
+ * a frame with one copy and no allocation.
+ *
+ * Not thread-safe: the sender serializes Store() and Find() itself.
+ *
+ * Usage:
+ *   ReplayBuffer replay(4096, 256 << 20);
+ *   replay.Store(*frame);            // before handing the frame to ZeroMQ
+ *   if (auto *frame = replay.Find(sequence)) {
+ *       // resend a copy of *frame
+ *   }
+ */
+class ReplayBuffer {
+public:
+    static constexpr size_t kDefaultMaxFrames = 4096;
+    static constexpr size_t kDefaultMaxBytes = 256 * 1024 * 1024;
+
+    explicit ReplayBuffer(size_t maxFrames = kDefaultMaxFrames,
+                          size_t maxBytes = kDefaultMaxBytes);
+
+    /**
+     * @brief Change the bounds (evicts at once if now over them)
+     * @param maxFrames At least 1
+     */
+    void SetCapacity(size_t maxFrames, size_t maxBytes);
+    size_t GetMaxFrames() const { return max_frames_; }
+    size_t GetMaxBytes() const { return max_bytes_; }
+
+    /**
+     * @brief Keep a copy of a frame under its header's sequence number
+     * @return false if the frame has no valid header or its sequence is not
+     *         above the last one stored (the frame is not kept)
+     */
+    bool Store(const std::vector<uint8_t>& frame);
+
+    /**
+     * @brief Frame stored under @p sequence
+     * @return nullptr if it was never stored or has been evicted; otherwise
+     *         valid until the next Store(), SetCapacity() or Clear()
+     */
+    const std::vector<uint8_t>* Find(uint64_t sequence) const;
+
+    /// Forget all frames (new run: sequence numbers restart)
+    void Clear();
+
+    size_t GetFrames() const { return entries_.size(); }
+    size_t GetBytes() const { return bytes_; }
+    /// Frames evicted to stay within the bounds since the last Clear()
+    uint64_t GetEvicted() const { return evicted_; }
+
+private:
+    struct Entry {
+        uint64_t sequence;
+        std::vector<uint8_t> frame;
+    };
+
+    void EvictOldest();
+
+    size_t max_frames_;
+    size_t max_bytes_;
+    std::deque<Entry> entries_;
+    std::vector<std::vector<uint8_t>> spare_;  // Evicted buffers for reuse
+    size_t bytes_ = 0;
+    uint64_t evicted_ = 0;
+};
+
+}  // namespace Net
+}  // namespace DELILA
@@ -0,0 +1,123 @@
+/**
+ * @file SequenceReorderer.hpp
+ * @brief Per-stream sequence accounting with an optional reorder window
+ *
+ * A merger receives each source on its own connection. This class follows
+ * the sequence numbers of one such stream: it counts frames that are
+ * missing, out of order, late or duplicated, and can hold a few frames
+ * back to put the stream into sequence order again.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace DELILA {
+namespace Net {
+
+/**
+ * @brief Restores the order of one stream within a bounded window
+ *
+ * With a window of 0 frames are passed on as they arrive and only
+ * counted. With a window of N, a frame that arrives ahead of a missing
+ * one is held until the missing frame arrives or N frames are held; then
+ * the missing frame is given up (counted as lost) and the held frames are
+ * released in order.
+ *
+ * A frame that arrives after it was given up (late) is still passed on,
+ * out of order, and no longer counts as lost. A frame whose sequence was
+ * already passed on or is held (a duplicate) is dropped and counted in
+ * GetDuplicates(); no other frame is ever dropped. The given-up sequences
+ * of the newest kMaxGivenUpRanges gaps are remembered; a frame from an
+ * older gap counts as a duplicate. The first frame sets the expected
+ * sequence, as in SequenceGapDetector.
+ *
+ * Push(), Flush() and Reset() are called from one thread; the counters
+ * can be read from any thread.
+ *
+ * Usage:
+ *   SequenceReorderer reorderer(16);
+ *   std::vector<SequenceReorderer::Frame> ready;
+ *   for each received frame:
+ *       reorderer.Push(header.sequence_number, std::move(frame), ready);
+ *       forward ready frames, then ready.clear();
+ *   at end of stream:
+ *       reorderer.Flush(ready);
+ */
+class SequenceReorderer {
+public:
+    using Frame = std::unique_ptr<std::vector<uint8_t>>;
+
+    /// Gaps remembered for late frames (bounds memory on a lossy stream)
+    static constexpr size_t kMaxGivenUpRanges = 4096;
+
+    explicit SequenceReorderer(size_t window = 0);
+
+    /// Frames held at most while waiting for a missing one
+    void SetWindow(size_t frames) { window_ = frames; }
+    size_t GetWindow() const { return window_; }
+
+    /**
+     * @brief Take a frame
+     * @param sequence The frame's sequence number in this stream
+     * @param ready Receives the frames that can be passed on, in order
+     */
+    void Push(uint64_t sequence, Frame frame, std::vector<Frame>& ready);
+
+    /**
+     * @brief Release all held frames in order (end of stream)
+     *
+     * Gaps between them are given up.
+     */
+    void Flush(std::vector<Frame>& ready);
+
+    /**
+     * @brief Reset state and counters (call at start of new run)
+     *
+     * Held frames are discarded.
+     */
+    void Reset();
+
+    // === Counters (since the last Reset()) ===
+    uint64_t GetReceived() const { return received_.load(); }
+    /// Sequence numbers given up and not received since
+    uint64_t GetLost() const { return lost_.load(); }
+    /// Frames that arrived after a higher sequence number
+    uint64_t GetReordered() const { return reordered_.load(); }
+    /// Reordered frames that arrived after they were given up
+    uint64_t GetLate() const { return late_.load(); }
+    /// Frames dropped because their sequence was already seen
+    uint64_t GetDuplicates() const { return duplicates_.load(); }
+    size_t GetHeld() const { return held_count_.load(); }
+
+private:
+    /// Pass on held frames that follow next_ without a gap
+    void ReleaseContiguous(std::vector<Frame>& ready);
+    void GiveUpOldestGap(std::vector<Frame>& ready);
+    /// Count [from, to) as lost and remember it for late frames
+    void GiveUp(uint64_t from, uint64_t to);
+    /// Take @p sequence out of the given-up ranges; false if not in one
+    bool Recover(uint64_t sequence);
+
+    size_t window_;
+    bool started_ = false;
+    uint64_t next_ = 0;     ///< Next sequence expected in order
+    uint64_t highest_ = 0;  ///< Highest sequence received
+    std::map<uint64_t, Frame> held_;
+    std::map<uint64_t, uint64_t> given_up_;  ///< [first, end) not received
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> reordered_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<size_t> held_count_{0};
+};
+
+}  // namespace Net
+}  // namespace DELILA
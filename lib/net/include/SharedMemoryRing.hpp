@@ -0,0 +1,206 @@
+/**
+ * @file SharedMemoryRing.hpp
+ * @brief POSIX shared-memory ring buffer for same-host data channels
+ *
+ * Components running on the same host can exchange data frames through a
+ * shared-memory ring instead of a ZeroMQ socket. Frames are stored
+ * verbatim (BinaryDataHeader + payload), so the receiving side sees exactly
+ * the bytes DataProcessor produced. ZMQTransport selects this backend for
+ * data addresses of the form "shm://name".
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace DELILA {
+namespace Net {
+
+/**
+ * @brief Single-producer, multi-consumer ring in POSIX shared memory
+ *
+ * Two delivery modes mirror the ZeroMQ patterns used for data channels:
+ *  - Distribute (PUSH/PULL): every frame goes to exactly one consumer.
+ *    Consumers claim frames from a shared cursor.
+ *  - Broadcast (PUB/SUB): every attached subscriber sees every frame
+ *    published after it attached. Each subscriber owns a cursor slot.
+ *
+ * In Distribute mode the producer never overwrites unread frames; when the
+ * ring is full it waits for space (backpressure) instead of dropping. In
+ * Broadcast mode it never waits: like a PUB socket, it overwrites the
+ * oldest frames, and a subscriber that lags by more than the ring loses
+ * them (see GetDroppedFrames()). Idle consumers and a blocked producer
+ * sleep on futexes (Linux) and are woken only when there are waiters, so
+ * the fast path is free of system calls.
+ *
+ * The side that binds owns the segment: it creates it (replacing a stale
+ * one left by a crashed run) and unlinks it on Close(). Connecting sides
+ * attach to an existing segment.
+ *
+ * Usage:
+ *   SharedMemoryRing ring;
+ *   ring.Create("daq0", SharedMemoryRing::Mode::Distribute, 64 << 20);
+ *   ring.Write(frame.data(), frame.size(), 100ms);
+ *
+ *   SharedMemoryRing reader;
+ *   reader.Attach("daq0", SharedMemoryRing::Role::Consumer,
+ *                 SharedMemoryRing::Mode::Distribute);
+ *   auto frame = reader.Read(1000ms);
+ */
+class SharedMemoryRing {
+public:
+    enum class Mode : uint32_t {
+        Distribute = 1,  ///< PUSH/PULL: each frame to one consumer
+        Broadcast = 2    ///< PUB/SUB: each frame to every subscriber
+    };
+
+    enum class Role {
+        Producer,
+        Consumer
+    };
+
+    /// Maximum number of simultaneously attached subscribers (Broadcast)
+    static constexpr uint32_t kMaxSubscribers = 16;
+
+    /// Smallest accepted ring size; smaller requests are rounded up
+    static constexpr size_t kMinCapacity = 64 * 1024;
+
+    /**
+     * @brief Zero-copy view of a received frame
+     *
+     * Valid until Release() is called on the ring. In Broadcast mode the
+     * producer may overwrite it meanwhile; Release() tells.
+     */
+    struct FrameView {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    SharedMemoryRing() = default;
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    /**
+     * @brief Create (own) the segment and join it in @p role
+     * @param name Segment name without leading '/'
+     * @param capacity Data area in bytes, rounded up to a power of two
+     * @return false if the segment could not be created or joined
+     */
+    bool Create(const std::string& name, Mode mode, size_t capacity,
+                Role role = Role::Producer);
+
+    /**
+     * @brief Attach to a segment created by another process or thread
+     * @return false if the segment does not exist (yet), the mode does not
+     *         match, or the requested role is unavailable
+     */
+    bool Attach(const std::string& name, Role role, Mode mode);
+
+    /**
+     * @brief Leave the segment; the owner also unlinks it
+     */
+    void Close();
+
+    bool IsOpen() const { return header_ != nullptr; }
+
+    /// True once the owner has closed the segment (consumers should re-attach)
+    bool IsClosedByOwner() const;
+
+    // === Producer ===
+
+    /**
+     * @brief Reserve space for a frame of @p size bytes
+     * @param timeout Wait for space (Distribute only; Broadcast never waits)
+     * @return Pointer to write the frame to, or nullptr on timeout
+     */
+    uint8_t* Reserve(size_t size, std::chrono::milliseconds timeout);
+
+    /// Publish the frame obtained from the last Reserve()
+    void Commit();
+
+    /// Copy @p size bytes into the ring as one frame
+    bool Write(const void* data, size_t size, std::chrono::milliseconds timeout);
+
+    // === Consumer ===
+
+    /**
+     * @brief Wait for the next frame and return a view into the ring
+     * @return Empty view (data == nullptr) on timeout
+     */
+    FrameView Peek(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Hand the frame obtained from the last Peek() back to the producer
+     * @return false if the frame was overwritten while it was held
+     *         (Broadcast), in which case the view must be discarded
+     */
+    bool Release();
+
+    /// Copy the next frame out of the ring, skipping overwritten ones
+    std::unique_ptr<std::vector<uint8_t>> Read(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Frames lost to overwriting (Broadcast)
+     *
+     * A subscriber gets its own count, the producer the sum over the
+     * attached subscribers. Frames overwritten before a stalled subscriber
+     * reached them are included.
+     */
+    uint64_t GetDroppedFrames() const;
+
+    // === Introspection ===
+
+    size_t GetCapacity() const { return capacity_; }
+
+    /// Largest frame that Write()/Reserve() accept
+    size_t GetMaxFrameSize() const;
+
+    /// Bytes published but not yet released by the slowest consumer
+    size_t GetUsedBytes() const;
+
+    /// Map "shm://name" to "name"; empty if @p address is not an shm address
+    static std::string ParseAddress(const std::string& address);
+
+private:
+    struct Header;
+    struct Record;
+
+    bool MapSegment(int fd, size_t total_size);
+    bool JoinAs(Role role);
+    Record* RecordAt(uint64_t position) const;
+    uint64_t ReleasedPosition() const;
+    uint64_t LowWaterMark();
+    void Overwrite(uint64_t end);
+    uint64_t NextRecord(uint64_t position) const;
+    bool Intact(uint64_t position) const;
+    void WakeConsumers();
+    void WakeProducer();
+
+    Header* header_ = nullptr;
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mapped_size_ = 0;
+    std::string name_;
+    bool owner_ = false;
+    Role role_ = Role::Consumer;
+    int subscriber_slot_ = -1;
+
+    // Producer: frame between Reserve() and Commit()
+    uint64_t pending_end_ = 0;
+    // Consumer: frame between Peek() and Release()
+    uint64_t peeked_position_ = 0;
+    uint64_t peeked_end_ = 0;
+    uint64_t peeked_index_ = 0;
+    bool has_peeked_ = false;
+};
+
+}  // namespace Net
+}  // namespace DELILA
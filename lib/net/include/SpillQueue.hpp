@@ -0,0 +1,176 @@
+/**
+ * @file SpillQueue.hpp
+ * @brief Bounded frame queue that overflows into a disk ring
+ *
+ * When downstream is slow, a component can either drop frames or let its
+ * queue grow without bound. A SpillQueue keeps a bounded number of frames
+ * in memory and appends the overflow, as raw frames, to a fixed-size ring
+ * file on local disk. Frames come back out in the order they were pushed,
+ * so a short stall at the sink is absorbed without losing data.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace DELILA {
+namespace Net {
+
+/**
+ * @brief FIFO of frames: bounded in memory, then spilled to a ring file
+ *
+ * Push() keeps a frame in memory while nothing is on disk and the memory
+ * bound is not reached; otherwise it appends the frame to the spill file.
+ * Once anything is on disk every later frame goes there too, so memory
+ * only ever holds frames older than those on disk and Pop() can serve
+ * memory first, then disk, in push order.
+ *
+ * The spill file is a byte ring of fixed capacity written with
+ * pwrite()/pread(): records are appended at the tail and consumed at the
+ * head, and the file never grows beyond the capacity. Nothing is synced:
+ * the file only has to outlive a stall, not a crash, and is removed by
+ * CloseSpill(). Without a spill file the queue is a plain bounded FIFO
+ * that drops frames once full.
+ *
+ * Not thread-safe: the owner serializes all calls. An owner that must not
+ * hold its lock across disk I/O pushes in two phases instead (see
+ * BeginPush()).
+ *
+ * Usage:
+ *   SpillQueue queue(10000);
+ *   queue.OpenSpill("/data/spill/merger.spill", 1ULL << 30);
+ *   queue.Push(SpillQueue::Frame{std::move(data)});  // false: dropped
+ *   SpillQueue::Frame frame;
+ *   while (queue.Pop(frame)) {
+ *       // send frame.data; if it cannot go yet: queue.Requeue(...)
+ *   }
+ */
+class SpillQueue {
+public:
+    static constexpr size_t kDefaultMemoryFrames = 10000;
+
+    struct Frame {
+        std::unique_ptr<std::vector<uint8_t>> data;
+        uint64_t stamp = 0;  ///< Opaque to the queue (e.g. an enqueue time)
+    };
+
+    /// Region of the spill file set aside for one frame by BeginPush()
+    struct Reservation {
+        uint64_t position = 0;
+        uint64_t size = 0;  ///< Record header included
+    };
+
+    enum class PushResult { Stored, Dropped, Reserved };
+
+    explicit SpillQueue(size_t memoryFrames = kDefaultMemoryFrames);
+    ~SpillQueue();
+
+    SpillQueue(const SpillQueue&) = delete;
+    SpillQueue& operator=(const SpillQueue&) = delete;
+
+    /// Frames held in memory before spilling (at least 1)
+    void SetMemoryFrames(size_t memoryFrames);
+    size_t GetMemoryFrames() const { return memory_frames_; }
+
+    /**
+     * @brief Create (or truncate) the spill file
+     * @param path File on a local disk; removed again by CloseSpill()
+     * @param capacityBytes Ring size; a frame larger than this minus a
+     *        16-byte record header can never be spilled
+     * @param error Receives the reason on failure, if not null
+     */
+    bool OpenSpill(const std::string& path, uint64_t capacityBytes,
+                   std::string* error = nullptr);
+
+    /// Drop the frames on disk, close and remove the spill file
+    void CloseSpill();
+    bool IsSpillOpen() const { return fd_ >= 0; }
+    const std::string& GetSpillPath() const { return path_; }
+    uint64_t GetSpillCapacity() const { return capacity_; }
+
+    /**
+     * @brief Append a frame
+     * @return false if it fit neither in memory nor on disk; the frame is
+     *         then dropped and counted in GetDropped()
+     */
+    bool Push(Frame&& frame);
+
+    /**
+     * @brief First phase of Push(), without the disk write
+     *
+     * Stored: the frame was moved into memory. Dropped: as a failed Push().
+     * Reserved: @p reservation holds room in the spill file; the owner
+     * calls WriteReserved() (no serialization needed) and then EndPush().
+     * Only one push may be outstanding, and CloseSpill() must wait for it.
+     */
+    PushResult BeginPush(Frame& frame, Reservation& reservation);
+
+    /// Write @p frame into its reserved region; touches no queue state
+    bool WriteReserved(const Reservation& reservation, const Frame& frame) const;
+
+    /**
+     * @brief Make a written frame visible to Pop()
+     * @return false if the write failed or the spilled frames were dropped
+     *         meanwhile; the frame is then counted in GetDropped()
+     */
+    bool EndPush(const Reservation& reservation, bool written);
+
+    /**
+     * @brief Take the oldest frame
+     * @return false if the queue is empty. A spilled frame that cannot be
+     *         read back ends the spill: everything on disk is counted as
+     *         dropped and the next Pop() continues with newer frames.
+     */
+    bool Pop(Frame& frame);
+
+    /// Put a frame taken by Pop() back at the front (e.g. output not ready)
+    void Requeue(Frame&& frame);
+
+    /// Drop all frames, counting them in GetDropped()
+    void DropAll();
+
+    /// Drop all frames and reset the counters (new run)
+    void Clear();
+
+    bool Empty() const { return memory_.empty() && disk_frames_ == 0; }
+    size_t Size() const { return memory_.size() + disk_frames_; }
+    size_t GetMemorySize() const { return memory_.size(); }
+
+    /// Frames and bytes (record headers included) on disk right now
+    size_t GetSpilledFrames() const { return disk_frames_; }
+    uint64_t GetSpilledBytes() const { return tail_ - head_; }
+
+    // === Totals since the last Clear() ===
+    uint64_t GetTotalSpilled() const { return total_spilled_; }
+    uint64_t GetTotalRestored() const { return total_restored_; }
+    uint64_t GetDropped() const { return dropped_; }
+
+private:
+    bool Restore(Frame& frame);
+    void DropSpilled();
+    bool WriteRing(uint64_t position, const void* data, size_t size) const;
+    bool ReadRing(uint64_t position, void* data, size_t size) const;
+
+    size_t memory_frames_;
+    std::deque<Frame> memory_;
+
+    int fd_ = -1;
+    std::string path_;
+    uint64_t capacity_ = 0;
+    uint64_t head_ = 0;  // Ring positions; file offset is position % capacity_
+    uint64_t tail_ = 0;
+    size_t disk_frames_ = 0;
+    bool reserved_ = false;  // A BeginPush() awaits its EndPush()
+
+    uint64_t total_spilled_ = 0;
+    uint64_t total_restored_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+}  // namespace Net
+}  // namespace DELILA
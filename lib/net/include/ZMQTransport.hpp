@@ -23,6 +23,7 @@
 #include "../../core/include/delila/core/Command.hpp"
 #include "../../core/include/delila/core/CommandResponse.hpp"
 #include "../../core/include/delila/core/ComponentState.hpp"
+#include "StatusCodec.hpp"
 
 // Forward declarations
 namespace DELILA::Digitizer
@@ -37,6 +38,8 @@ class MinimalEventData;
 namespace DELILA::Net
 {
 
+class SharedMemoryRing;
+
 /**
  * @brief Configuration structure for ZMQ transport layer
  * 
@@ -71,6 +74,10 @@ struct TransportConfig {
    * - "SUB": Subscriber socket (receive broadcasts)  
    * - "PUSH": Push socket (load-balanced distribution)
    * - "PULL": Pull socket (receive load-balanced messages)
+   *
+   * A data_address of the form "shm://name" selects a same-host
+   * shared-memory ring instead of a socket; only PUB/SUB and PUSH/PULL
+   * are supported there.
    */
   std::string data_pattern = "PUB";
 
@@ -83,33 +90,35 @@ struct TransportConfig {
    * @note Only relevant when data_pattern is "PUB" or "SUB"
    */
   bool is_publisher = true;
-};
 
-/**
- * @brief Component status structure for health monitoring
- * 
- * Used for system health monitoring and diagnostics. Provides
- * comprehensive status information including metrics and error states.
- * 
- * @par Usage Example:
- * @code{.cpp}
- * ComponentStatus status;
- * status.component_id = "digitizer_01";
- * status.state = "ACQUIRING";
- * status.timestamp = std::chrono::system_clock::now();
- * status.metrics["events_per_second"] = 125000.0;
- * status.heartbeat_counter++;
- * 
- * transport.SendStatus(status);
- * @endcode
- */
-struct ComponentStatus {
-  std::string component_id;                               ///< Unique component identifier
-  std::string state;                                      ///< Current operational state
-  std::chrono::system_clock::time_point timestamp;       ///< Status timestamp
-  std::map<std::string, double> metrics;                 ///< Performance metrics
-  std::string error_message;                             ///< Last error message (if any)
-  uint64_t heartbeat_counter = 0;                        ///< Incremental heartbeat counter
+  /**
+   * @brief Ring size in bytes for shared-memory data channels
+   *
+   * Used when data_address is "shm://name" and this side binds (creates
+   * the segment). Frames larger than half the ring are rejected.
+   */
+  size_t shm_buffer_size = 64 * 1024 * 1024;
+
+  /**
+   * @brief Wire format for outgoing status messages
+   *
+   * - "json": the default, readable by every existing status consumer
+   * - "binary": compact fixed-layout message (StatusCodec); opt in once
+   *   the receivers use ReceiveStatus() or StatusCodec::Decode()
+   *
+   * ReceiveStatus() accepts both regardless of this setting.
+   */
+  std::string status_format = "json";
+
+  /**
+   * @brief Create sockets on the process-wide context
+   *
+   * Components in one process can only reach each other over "inproc://"
+   * when their sockets share a ZeroMQ context. Any inproc:// address turns
+   * this on automatically; set it explicitly to share the context (and its
+   * I/O thread) for other transports as well.
+   */
+  bool shared_context = false;
 };
 
 // KISS: Simple, focused interface
@@ -119,6 +128,11 @@ class ZMQTransport
   ZMQTransport();
   virtual ~ZMQTransport();
 
+  // Process-wide context used for inproc:// and shared_context transports.
+  // Lives while any transport holds it.
+  static std::shared_ptr<zmq::context_t> SharedContext();
+  bool UsesSharedContext() const;
+
   // Connection management
   bool Configure(const TransportConfig &config);
   bool ConfigureFromJSON(const nlohmann::json &config);
@@ -131,6 +145,22 @@ class ZMQTransport
   bool SendBytes(std::unique_ptr<std::vector<uint8_t>> &data);
   std::unique_ptr<std::vector<uint8_t>> ReceiveBytes();
 
+  // Waits up to timeout until SendBytes() would queue a frame rather than
+  // drop it (ZeroMQ: a peer is connected and below its high-water mark).
+  // shm:// channels return true once the ring exists: over PUSH SendBytes()
+  // waits for space itself and leaves the frame in place if it times out;
+  // over PUB it never waits.
+  bool WaitForSendReady(std::chrono::milliseconds timeout);
+
+  // Bytes queued on the data channel but not yet received. Only known for
+  // shm:// channels; ZeroMQ does not expose its queues, so this returns 0.
+  size_t GetPendingDataBytes() const;
+
+  // Frames a lagging shm:// PUB/SUB subscriber lost to overwriting: its own
+  // on the SUB side, the sum over subscribers on the PUB side. ZeroMQ does
+  // not report its drops, so this returns 0 for other channels.
+  uint64_t GetDroppedDataFrames() const;
+
   // Status functions
   bool SendStatus(const ComponentStatus &status);
   std::unique_ptr<ComponentStatus> ReceiveStatus();
@@ -152,15 +182,19 @@ class ZMQTransport
   TransportConfig fConfig;
 
   // ZeroMQ context and sockets (KISS - byte transport only)
-  std::unique_ptr<zmq::context_t> fContext;
+  // The context is chosen in Connect(): private, or SharedContext()
+  std::shared_ptr<zmq::context_t> fContext;
   std::unique_ptr<zmq::socket_t> fDataSocket;     // Data socket
   std::unique_ptr<zmq::socket_t> fStatusSocket;   // For status communication
   std::unique_ptr<zmq::socket_t> fCommandSocket;  // For command REQ/REP
 
-  // Helper methods for JSON status serialization
-  std::string SerializeStatus(const ComponentStatus &status) const;
-  std::unique_ptr<ComponentStatus> DeserializeStatus(
-      const std::string &json) const;
+  // Shared-memory data channel (data_address "shm://name")
+  std::unique_ptr<SharedMemoryRing> fShmRing;
+  std::string fShmPattern;
+  bool OpenSharedMemoryRing();
+
+  // Reused encode buffer for SendStatus
+  std::vector<uint8_t> fStatusBuffer;
 
   // Helper methods for JSON command serialization
   std::string SerializeCommand(const DELILA::Command &cmd) const;
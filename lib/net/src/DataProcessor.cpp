@@ -1,12 +1,177 @@
 #include "../include/DataProcessor.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstring>
+#include <mutex>
 #include <stdexcept>
 
 namespace DELILA::Net
 {
 
+namespace
+{
+
+// Format version 5 record: the fixed fields of version 1, the sample
+// counts of the six probes, then int16_t analog samples and one bit plane
+// (LSB first) per digital probe
+constexpr size_t kCompactProbeCount = 6;
+constexpr size_t kCompactCountsSize = kCompactProbeCount * sizeof(uint32_t);
+
+size_t PlaneBytes(size_t samples) { return (samples + 7) / 8; }
+
+size_t CompactPayloadSize(const uint32_t (&counts)[kCompactProbeCount])
+{
+  return (size_t{counts[0]} + counts[1]) * sizeof(int16_t) +
+         PlaneBytes(counts[2]) + PlaneBytes(counts[3]) +
+         PlaneBytes(counts[4]) + PlaneBytes(counts[5]);
+}
+
+void GetProbeCounts(const EventData &event,
+                    uint32_t (&counts)[kCompactProbeCount])
+{
+  counts[0] = static_cast<uint32_t>(event.analogProbe1.size());
+  counts[1] = static_cast<uint32_t>(event.analogProbe2.size());
+  counts[2] = static_cast<uint32_t>(event.digitalProbe1.size());
+  counts[3] = static_cast<uint32_t>(event.digitalProbe2.size());
+  counts[4] = static_cast<uint32_t>(event.digitalProbe3.size());
+  counts[5] = static_cast<uint32_t>(event.digitalProbe4.size());
+}
+
+// Fixed fields in the order of DataProcessor::Serialize()
+uint8_t *WriteFixedFields(uint8_t *p, const EventData &event)
+{
+  auto put = [&p](const auto &field) {
+    std::memcpy(p, &field, sizeof(field));
+    p += sizeof(field);
+  };
+  put(event.timeStampNs);
+  put(event.waveformSize);
+  put(event.energy);
+  put(event.energyShort);
+  put(event.module);
+  put(event.channel);
+  put(event.timeResolution);
+  put(event.analogProbe1Type);
+  put(event.analogProbe2Type);
+  put(event.digitalProbe1Type);
+  put(event.digitalProbe2Type);
+  put(event.digitalProbe3Type);
+  put(event.digitalProbe4Type);
+  put(event.downSampleFactor);
+  put(event.flags);
+  put(event.aMax);
+  return p;
+}
+
+const uint8_t *ReadFixedFields(const uint8_t *p, EventData &event)
+{
+  auto get = [&p](auto &field) {
+    std::memcpy(&field, p, sizeof(field));
+    p += sizeof(field);
+  };
+  get(event.timeStampNs);
+  get(event.waveformSize);
+  get(event.energy);
+  get(event.energyShort);
+  get(event.module);
+  get(event.channel);
+  get(event.timeResolution);
+  get(event.analogProbe1Type);
+  get(event.analogProbe2Type);
+  get(event.digitalProbe1Type);
+  get(event.digitalProbe2Type);
+  get(event.digitalProbe3Type);
+  get(event.digitalProbe4Type);
+  get(event.downSampleFactor);
+  get(event.flags);
+  get(event.aMax);
+  return p;
+}
+
+// The sample loops below are flat, so the compiler vectorizes them
+// (sign-extending loads for analog, byte-wide table copies for digital)
+
+uint8_t *PackAnalog(uint8_t *p, const std::vector<int32_t> &samples)
+{
+  const int32_t *src = samples.data();
+  const size_t n = samples.size();
+  for (size_t i = 0; i < n; ++i) {
+    const auto value = static_cast<int16_t>(src[i]);
+    std::memcpy(p + i * sizeof(int16_t), &value, sizeof(value));
+  }
+  return p + n * sizeof(int16_t);
+}
+
+const uint8_t *UnpackAnalog(const uint8_t *p, std::vector<int32_t> &samples)
+{
+  int32_t *dst = samples.data();
+  const size_t n = samples.size();
+  for (size_t i = 0; i < n; ++i) {
+    int16_t value;
+    std::memcpy(&value, p + i * sizeof(int16_t), sizeof(value));
+    dst[i] = value;
+  }
+  return p + n * sizeof(int16_t);
+}
+
+uint8_t *PackDigital(uint8_t *p, const std::vector<uint8_t> &samples)
+{
+  const uint8_t *src = samples.data();
+  const size_t n = samples.size();
+  const size_t full = n / 8;
+  for (size_t b = 0; b < full; ++b) {
+    const uint8_t *s = src + b * 8;
+    p[b] = static_cast<uint8_t>(s[0] | s[1] << 1 | s[2] << 2 | s[3] << 3 |
+                                s[4] << 4 | s[5] << 5 | s[6] << 6 |
+                                s[7] << 7);
+  }
+  if (n % 8 != 0) {
+    uint8_t last = 0;
+    for (size_t i = full * 8; i < n; ++i) {
+      last |= static_cast<uint8_t>(src[i] << (i % 8));
+    }
+    p[full] = last;
+  }
+  return p + PlaneBytes(n);
+}
+
+// Samples of every byte value, bit 0 first
+struct BitPlaneTable {
+  uint8_t samples[256][8];
+  BitPlaneTable()
+  {
+    for (int value = 0; value < 256; ++value) {
+      for (int bit = 0; bit < 8; ++bit) {
+        samples[value][bit] = static_cast<uint8_t>((value >> bit) & 1);
+      }
+    }
+  }
+};
+const BitPlaneTable &BitPlanes()
+{
+  static const BitPlaneTable table;
+  return table;
+}
+
+const uint8_t *UnpackDigital(const uint8_t *p, std::vector<uint8_t> &samples)
+{
+  const auto &planes = BitPlanes();
+  uint8_t *dst = samples.data();
+  const size_t n = samples.size();
+  const size_t full = n / 8;
+  for (size_t b = 0; b < full; ++b) {
+    std::memcpy(dst + b * 8, planes.samples[p[b]], 8);
+  }
+  if (n % 8 != 0) {
+    std::memcpy(dst + full * 8, planes.samples[p[full]], n % 8);
+  }
+  return p + PlaneBytes(n);
+}
+
+}  // namespace
+
 // Static member initialization
 uint32_t DataProcessor::crc32_table_[256];
 bool DataProcessor::table_initialized_ = false;
@@ -30,9 +195,13 @@ void DataProcessor::InitializeCRC32Table()
 
 uint32_t DataProcessor::CalculateCRC32(const uint8_t *data, size_t length)
 {
-  if (!table_initialized_) {
-    InitializeCRC32Table();
-  }
+  // Decoders may run on several threads; build the table exactly once
+  static std::once_flag table_once;
+  std::call_once(table_once, []() {
+    if (!table_initialized_) {
+      InitializeCRC32Table();
+    }
+  });
 
   uint32_t crc = 0xFFFFFFFF;
   for (size_t i = 0; i < length; ++i) {
@@ -56,11 +225,15 @@ std::unique_ptr<std::vector<uint8_t>> DataProcessor::Process(
     return nullptr;
   }
 
+  // Compact encoding only where it is lossless
+  const bool compact = compact_waveforms_ && FitsCompact(*events);
+
   // Create header
   BinaryDataHeader header{};
   header.magic_number = BINARY_DATA_MAGIC_NUMBER;
   header.sequence_number = sequence_number;
-  header.format_version = FORMAT_VERSION_EVENTDATA;
+  header.format_version =
+      compact ? FORMAT_VERSION_COMPACT_EVENTDATA : FORMAT_VERSION_EVENTDATA;
   header.header_size = BINARY_DATA_HEADER_SIZE;
   header.event_count = events->size();
   header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -73,7 +246,7 @@ std::unique_ptr<std::vector<uint8_t>> DataProcessor::Process(
   header.message_type = MESSAGE_TYPE_DATA;
 
   // Serialize event data
-  auto serializedData = Serialize(events);
+  auto serializedData = compact ? SerializeCompact(*events) : Serialize(events);
   if (!serializedData) {
     return nullptr;
   }
@@ -194,7 +367,7 @@ DataProcessor::Decode(const std::unique_ptr<std::vector<uint8_t>> &data)
   }
 
   // Validate format version
-  if (header->format_version != FORMAT_VERSION_EVENTDATA) {
+  if (!IsEventDataFormat(header->format_version)) {
     return {nullptr, 0};
   }
 
@@ -211,19 +384,24 @@ DataProcessor::Decode(const std::unique_ptr<std::vector<uint8_t>> &data)
     return {nullptr, 0};  // Size mismatch
   }
 
-  auto payload = std::make_unique<std::vector<uint8_t>>(
-      data->begin() + sizeof(BinaryDataHeader),
-      data->begin() + sizeof(BinaryDataHeader) + header->uncompressed_size);
+  const uint8_t *p = data->data() + sizeof(BinaryDataHeader);
 
   // CRC32 verification (conditional)
   if (checksum_enabled_ && header->checksum_type == CHECKSUM_CRC32) {
-    if (!VerifyCRC32(payload->data(), payload->size(), header->checksum)) {
+    if (!VerifyCRC32(p, header->uncompressed_size, header->checksum)) {
       return {nullptr, 0};  // Checksum verification failed
     }
   }
 
-  // Deserialization to EventData
-  auto events = Deserialize(payload);
+  // Deserialization to EventData (format 5 straight from the frame)
+  std::unique_ptr<std::vector<std::unique_ptr<EventData>>> events;
+  if (header->format_version == FORMAT_VERSION_COMPACT_EVENTDATA) {
+    events = DeserializeCompact(p, header->uncompressed_size);
+  } else {
+    auto payload = std::make_unique<std::vector<uint8_t>>(
+        p, p + header->uncompressed_size);
+    events = Deserialize(payload);
+  }
   if (!events) {
     return {nullptr, 0};  // Deserialization failed
   }
@@ -293,7 +471,243 @@ DataProcessor::DecodeMinimal(const std::unique_ptr<std::vector<uint8_t>> &data)
   return {std::move(events), sequence_number};
 }
 
+bool DataProcessor::DecodeMinimal(const std::vector<uint8_t> &data,
+                                  std::vector<MinimalEventData> &events,
+                                  uint64_t &sequence_number)
+{
+  BinaryDataHeader header;
+  if (!PeekHeader(data, header)) {
+    return false;
+  }
+
+  const size_t payloadSize =
+      static_cast<size_t>(header.event_count) * sizeof(MinimalEventData);
+  if (header.format_version != FORMAT_VERSION_MINIMAL_EVENTDATA ||
+      header.header_size != BINARY_DATA_HEADER_SIZE ||
+      header.uncompressed_size != payloadSize ||
+      data.size() < BINARY_DATA_HEADER_SIZE + payloadSize) {
+    return false;
+  }
+
+  const uint8_t *p = data.data() + BINARY_DATA_HEADER_SIZE;
+
+  // CRC32 verification (conditional)
+  if (checksum_enabled_ && header.checksum_type == CHECKSUM_CRC32) {
+    if (!VerifyCRC32(p, payloadSize, header.checksum)) {
+      return false;
+    }
+  }
+
+  // Records are packed, so the payload is copied as one block
+  events.resize(header.event_count);
+  std::memcpy(static_cast<void *>(events.data()), p, payloadSize);
+  sequence_number = header.sequence_number;
+  return true;
+}
+
 // Internal methods - serialization implementation (copied from Serializer, simplified)
+std::unique_ptr<std::vector<uint8_t>> DataProcessor::Process(
+    const std::unique_ptr<std::vector<std::unique_ptr<BuiltEventData>>>
+        &events,
+    uint64_t sequence_number)
+{
+  if (!events) {
+    return nullptr;
+  }
+
+  // Serialize directly after the header space
+  auto result = std::make_unique<std::vector<uint8_t>>(BINARY_DATA_HEADER_SIZE);
+  uint32_t eventCount = 0;
+  for (const auto &event : *events) {
+    if (!event || event->hits.empty() ||
+        event->triggerIndex >= event->hits.size()) {
+      continue;
+    }
+    AppendBuiltEvent(*result, event->hits.data(),
+                     static_cast<uint32_t>(event->hits.size()),
+                     event->triggerIndex);
+    eventCount++;
+  }
+
+  if (!FinalizeFrame(*result, FORMAT_VERSION_BUILT_EVENTDATA, eventCount,
+                     sequence_number)) {
+    return nullptr;
+  }
+  return result;
+}
+
+std::pair<std::unique_ptr<std::vector<std::unique_ptr<BuiltEventData>>>,
+          uint64_t>
+DataProcessor::DecodeBuilt(const std::unique_ptr<std::vector<uint8_t>> &data)
+{
+  BinaryDataHeader header;
+  if (!data || !PeekHeader(*data, header)) {
+    return {nullptr, 0};
+  }
+
+  if (header.format_version != FORMAT_VERSION_BUILT_EVENTDATA ||
+      header.header_size != BINARY_DATA_HEADER_SIZE ||
+      data->size() < BINARY_DATA_HEADER_SIZE + header.uncompressed_size) {
+    return {nullptr, 0};
+  }
+
+  const uint8_t *p = data->data() + BINARY_DATA_HEADER_SIZE;
+  const uint8_t *end = p + header.uncompressed_size;
+
+  // CRC32 verification (conditional)
+  if (checksum_enabled_ && header.checksum_type == CHECKSUM_CRC32) {
+    if (!VerifyCRC32(p, header.uncompressed_size, header.checksum)) {
+      return {nullptr, 0};
+    }
+  }
+
+  auto events = std::make_unique<std::vector<std::unique_ptr<BuiltEventData>>>();
+  events->reserve(header.event_count);
+  for (uint32_t i = 0; i < header.event_count; ++i) {
+    Digitizer::BuiltEventRecordHeader record;
+    if (static_cast<size_t>(end - p) < sizeof(record)) {
+      return {nullptr, 0};
+    }
+    std::memcpy(&record, p, sizeof(record));
+    p += sizeof(record);
+
+    const size_t hitBytes =
+        static_cast<size_t>(record.hitCount) * sizeof(MinimalEventData);
+    if (static_cast<size_t>(end - p) < hitBytes ||
+        record.triggerIndex >= record.hitCount) {
+      return {nullptr, 0};
+    }
+
+    auto event = std::make_unique<BuiltEventData>();
+    event->triggerIndex = record.triggerIndex;
+    event->hits.resize(record.hitCount);
+    std::memcpy(event->hits.data(), p, hitBytes);
+    p += hitBytes;
+    events->push_back(std::move(event));
+  }
+
+  return {std::move(events), header.sequence_number};
+}
+
+std::unique_ptr<std::vector<uint8_t>> DataProcessor::Process(
+    const std::unique_ptr<std::vector<std::unique_ptr<CalibratedEventData>>>
+        &events,
+    uint64_t sequence_number)
+{
+  if (!events) {
+    return nullptr;
+  }
+
+  // Records are packed, so they are copied as they are
+  auto result = std::make_unique<std::vector<uint8_t>>(BINARY_DATA_HEADER_SIZE);
+  result->reserve(BINARY_DATA_HEADER_SIZE +
+                  events->size() * sizeof(CalibratedEventData));
+  uint32_t eventCount = 0;
+  for (const auto &event : *events) {
+    if (!event) {
+      continue;
+    }
+    const auto *bytes = reinterpret_cast<const uint8_t *>(event.get());
+    result->insert(result->end(), bytes, bytes + sizeof(CalibratedEventData));
+    eventCount++;
+  }
+
+  if (!FinalizeFrame(*result, FORMAT_VERSION_CALIBRATED_EVENTDATA, eventCount,
+                     sequence_number)) {
+    return nullptr;
+  }
+  return result;
+}
+
+std::pair<std::unique_ptr<std::vector<std::unique_ptr<CalibratedEventData>>>,
+          uint64_t>
+DataProcessor::DecodeCalibrated(
+    const std::unique_ptr<std::vector<uint8_t>> &data)
+{
+  BinaryDataHeader header;
+  if (!data || !PeekHeader(*data, header)) {
+    return {nullptr, 0};
+  }
+
+  const size_t payloadSize =
+      static_cast<size_t>(header.event_count) * sizeof(CalibratedEventData);
+  if (header.format_version != FORMAT_VERSION_CALIBRATED_EVENTDATA ||
+      header.header_size != BINARY_DATA_HEADER_SIZE ||
+      header.uncompressed_size != payloadSize ||
+      data->size() < BINARY_DATA_HEADER_SIZE + payloadSize) {
+    return {nullptr, 0};
+  }
+
+  const uint8_t *p = data->data() + BINARY_DATA_HEADER_SIZE;
+
+  // CRC32 verification (conditional)
+  if (checksum_enabled_ && header.checksum_type == CHECKSUM_CRC32) {
+    if (!VerifyCRC32(p, payloadSize, header.checksum)) {
+      return {nullptr, 0};
+    }
+  }
+
+  auto events =
+      std::make_unique<std::vector<std::unique_ptr<CalibratedEventData>>>();
+  events->reserve(header.event_count);
+  for (uint32_t i = 0; i < header.event_count; ++i) {
+    auto event = std::make_unique<CalibratedEventData>();
+    std::memcpy(event.get(), p, sizeof(CalibratedEventData));
+    p += sizeof(CalibratedEventData);
+    events->push_back(std::move(event));
+  }
+
+  return {std::move(events), header.sequence_number};
+}
+
+void DataProcessor::AppendBuiltEvent(std::vector<uint8_t> &payload,
+                                     const MinimalEventData *hits,
+                                     uint32_t hit_count,
+                                     uint32_t trigger_index)
+{
+  Digitizer::BuiltEventRecordHeader record{hit_count, trigger_index};
+  const size_t hitBytes =
+      static_cast<size_t>(hit_count) * sizeof(MinimalEventData);
+
+  size_t offset = payload.size();
+  payload.resize(offset + sizeof(record) + hitBytes);
+  std::memcpy(payload.data() + offset, &record, sizeof(record));
+  std::memcpy(payload.data() + offset + sizeof(record), hits, hitBytes);
+}
+
+bool DataProcessor::FinalizeFrame(std::vector<uint8_t> &frame,
+                                  uint32_t format_version,
+                                  uint32_t event_count,
+                                  uint64_t sequence_number)
+{
+  if (frame.size() < BINARY_DATA_HEADER_SIZE) {
+    return false;
+  }
+
+  const uint8_t *payload = frame.data() + BINARY_DATA_HEADER_SIZE;
+  const size_t payloadSize = frame.size() - BINARY_DATA_HEADER_SIZE;
+
+  BinaryDataHeader header{};
+  header.magic_number = BINARY_DATA_MAGIC_NUMBER;
+  header.sequence_number = sequence_number;
+  header.format_version = format_version;
+  header.header_size = BINARY_DATA_HEADER_SIZE;
+  header.event_count = event_count;
+  header.uncompressed_size = static_cast<uint32_t>(payloadSize);
+  header.compressed_size = static_cast<uint32_t>(payloadSize);
+  header.checksum =
+      checksum_enabled_ ? CalculateCRC32(payload, payloadSize) : 0;
+  header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  header.compression_type = COMPRESSION_NONE;
+  header.checksum_type = checksum_enabled_ ? CHECKSUM_CRC32 : CHECKSUM_NONE;
+  header.message_type = MESSAGE_TYPE_DATA;
+
+  std::memcpy(frame.data(), &header, sizeof(header));
+  return true;
+}
+
 std::unique_ptr<std::vector<uint8_t>> DataProcessor::Serialize(
     const std::unique_ptr<std::vector<std::unique_ptr<EventData>>> &events)
 {
@@ -552,6 +966,114 @@ DataProcessor::DeserializeMinimal(
   return events;
 }
 
+// Format version 5 (compact waveforms)
+bool DataProcessor::FitsCompact(
+    const std::vector<std::unique_ptr<EventData>> &events)
+{
+  for (const auto &event : events) {
+    if (!event) continue;
+
+    // Branch-free range checks over each probe
+    int32_t low = 0;
+    int32_t high = 0;
+    for (const auto *probe : {&event->analogProbe1, &event->analogProbe2}) {
+      for (int32_t sample : *probe) {
+        low = std::min(low, sample);
+        high = std::max(high, sample);
+      }
+    }
+    if (low < INT16_MIN || high > INT16_MAX) {
+      return false;
+    }
+
+    uint8_t bits = 0;
+    for (const auto *probe : {&event->digitalProbe1, &event->digitalProbe2,
+                              &event->digitalProbe3, &event->digitalProbe4}) {
+      for (uint8_t sample : *probe) {
+        bits |= sample;
+      }
+    }
+    if (bits > 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<std::vector<uint8_t>> DataProcessor::SerializeCompact(
+    const std::vector<std::unique_ptr<EventData>> &events)
+{
+  // Exact size first: one allocation, then plain stores
+  size_t total = 0;
+  for (const auto &event : events) {
+    if (!event) continue;
+    uint32_t counts[kCompactProbeCount];
+    GetProbeCounts(*event, counts);
+    total += Digitizer::EVENTDATA_SIZE + kCompactCountsSize +
+             CompactPayloadSize(counts);
+  }
+
+  auto result = std::make_unique<std::vector<uint8_t>>(total);
+  uint8_t *p = result->data();
+  for (const auto &event : events) {
+    if (!event) continue;
+    p = WriteFixedFields(p, *event);
+    uint32_t counts[kCompactProbeCount];
+    GetProbeCounts(*event, counts);
+    std::memcpy(p, counts, kCompactCountsSize);
+    p += kCompactCountsSize;
+    p = PackAnalog(p, event->analogProbe1);
+    p = PackAnalog(p, event->analogProbe2);
+    p = PackDigital(p, event->digitalProbe1);
+    p = PackDigital(p, event->digitalProbe2);
+    p = PackDigital(p, event->digitalProbe3);
+    p = PackDigital(p, event->digitalProbe4);
+  }
+
+  return result;
+}
+
+std::unique_ptr<std::vector<std::unique_ptr<EventData>>>
+DataProcessor::DeserializeCompact(const uint8_t *data, size_t size)
+{
+  auto events = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+
+  const uint8_t *p = data;
+  const uint8_t *end = data + size;
+  while (p < end) {
+    // Fixed fields and counts, then the samples they announce
+    if (static_cast<size_t>(end - p) <
+        Digitizer::EVENTDATA_SIZE + kCompactCountsSize) {
+      return nullptr;
+    }
+    auto event = std::make_unique<EventData>();
+    p = ReadFixedFields(p, *event);
+    uint32_t counts[kCompactProbeCount];
+    std::memcpy(counts, p, kCompactCountsSize);
+    p += kCompactCountsSize;
+    if (static_cast<size_t>(end - p) < CompactPayloadSize(counts)) {
+      return nullptr;
+    }
+
+    event->analogProbe1.resize(counts[0]);
+    event->analogProbe2.resize(counts[1]);
+    event->digitalProbe1.resize(counts[2]);
+    event->digitalProbe2.resize(counts[3]);
+    event->digitalProbe3.resize(counts[4]);
+    event->digitalProbe4.resize(counts[5]);
+    p = UnpackAnalog(p, event->analogProbe1);
+    p = UnpackAnalog(p, event->analogProbe2);
+    p = UnpackDigital(p, event->digitalProbe1);
+    p = UnpackDigital(p, event->digitalProbe2);
+    p = UnpackDigital(p, event->digitalProbe3);
+    p = UnpackDigital(p, event->digitalProbe4);
+
+    events->push_back(std::move(event));
+  }
+
+  return events;
+}
+
 // Sequence number management
 uint64_t DataProcessor::GetNextSequence()
 {
@@ -634,4 +1156,236 @@ bool DataProcessor::IsEOSMessage(const uint8_t *data, size_t size)
   return header->message_type == MESSAGE_TYPE_EOS;
 }
 
+bool DataProcessor::PeekHeader(const std::vector<uint8_t> &data,
+                               BinaryDataHeader &header)
+{
+  return PeekHeader(data.data(), data.size(), header);
+}
+
+bool DataProcessor::PeekHeader(const uint8_t *data, size_t size,
+                               BinaryDataHeader &header)
+{
+  if (!data || size < sizeof(BinaryDataHeader)) {
+    return false;
+  }
+
+  std::memcpy(&header, data, sizeof(BinaryDataHeader));
+  return header.magic_number == BINARY_DATA_MAGIC_NUMBER;
+}
+
+uint64_t DataProcessor::GetMergeSequence(const BinaryDataHeader &header)
+{
+  uint64_t merge_sequence;
+  std::memcpy(&merge_sequence, header.merge_sequence, sizeof(merge_sequence));
+  return merge_sequence;
+}
+
+bool DataProcessor::SetSourceId(std::vector<uint8_t> &data, uint8_t source_id)
+{
+  if (data.size() < sizeof(BinaryDataHeader)) {
+    return false;
+  }
+  data[offsetof(BinaryDataHeader, source_id)] = source_id;
+  return true;
+}
+
+bool DataProcessor::SetMergeSequence(std::vector<uint8_t> &data,
+                                     uint64_t merge_sequence)
+{
+  if (data.size() < sizeof(BinaryDataHeader)) {
+    return false;
+  }
+  std::memcpy(data.data() + offsetof(BinaryDataHeader, merge_sequence),
+              &merge_sequence, sizeof(merge_sequence));
+  return true;
+}
+
+bool DataProcessor::SetFrameFlags(std::vector<uint8_t> &data,
+                                  uint8_t frame_flags)
+{
+  if (data.size() < sizeof(BinaryDataHeader)) {
+    return false;
+  }
+  data[offsetof(BinaryDataHeader, frame_flags)] = frame_flags;
+  return true;
+}
+
+uint64_t DataProcessor::GetStreamSequence(const BinaryDataHeader &header)
+{
+  return header.source_id != 0 ? GetMergeSequence(header)
+                               : header.sequence_number;
+}
+
+bool DataProcessor::SetStreamSequence(std::vector<uint8_t> &data,
+                                      uint64_t sequence)
+{
+  if (data.size() < sizeof(BinaryDataHeader)) {
+    return false;
+  }
+  std::memcpy(data.data() + offsetof(BinaryDataHeader, sequence_number),
+              &sequence, sizeof(sequence));
+  if (data[offsetof(BinaryDataHeader, source_id)] != 0) {
+    SetMergeSequence(data, sequence);
+  }
+  return true;
+}
+
+bool DataProcessor::CopySourceStamps(const BinaryDataHeader &source,
+                                     std::vector<uint8_t> &data)
+{
+  if (data.size() < sizeof(BinaryDataHeader)) {
+    return false;
+  }
+  std::memcpy(data.data() + offsetof(BinaryDataHeader, timestamp),
+              &source.timestamp, sizeof(source.timestamp));
+  data[offsetof(BinaryDataHeader, source_id)] = source.source_id;
+  std::memcpy(data.data() + offsetof(BinaryDataHeader, merge_sequence),
+              source.merge_sequence, sizeof(source.merge_sequence));
+  data[offsetof(BinaryDataHeader, frame_flags)] = source.frame_flags;
+  return true;
+}
+
+bool DataProcessor::ScanRecords(const std::vector<uint8_t> &data,
+                                std::vector<EventRecordRef> &records)
+{
+  records.clear();
+  BinaryDataHeader header;
+  if (!PeekHeader(data, header) || header.message_type != MESSAGE_TYPE_DATA ||
+      header.header_size != BINARY_DATA_HEADER_SIZE ||
+      data.size() < BINARY_DATA_HEADER_SIZE + size_t{header.uncompressed_size}) {
+    return false;
+  }
+
+  const uint8_t *base = data.data();
+  const size_t end = BINARY_DATA_HEADER_SIZE + size_t{header.uncompressed_size};
+  size_t offset = BINARY_DATA_HEADER_SIZE;
+  records.reserve(header.event_count);
+
+  // Fixed-size records with module, channel first and the timestamp at
+  // time_offset (MinimalEventData, CalibratedEventData)
+  auto scanFixed = [&](size_t record_size, size_t time_offset) {
+    if (end - offset != size_t{header.event_count} * record_size) {
+      return false;
+    }
+    for (; offset < end; offset += record_size) {
+      EventRecordRef ref;
+      ref.offset = static_cast<uint32_t>(offset);
+      ref.size = static_cast<uint32_t>(record_size);
+      ref.module = base[offset];
+      ref.channel = base[offset + 1];
+      std::memcpy(&ref.timeStampNs, base + offset + time_offset,
+                  sizeof(ref.timeStampNs));
+      records.push_back(ref);
+    }
+    return true;
+  };
+
+  switch (header.format_version) {
+  case FORMAT_VERSION_MINIMAL_EVENTDATA:
+    return scanFixed(sizeof(MinimalEventData),
+                     offsetof(MinimalEventData, timeStampNs));
+
+  case FORMAT_VERSION_CALIBRATED_EVENTDATA:
+    return scanFixed(sizeof(CalibratedEventData),
+                     offsetof(CalibratedEventData, timeStampNs));
+
+  case FORMAT_VERSION_BUILT_EVENTDATA:
+    while (offset < end) {
+      Digitizer::BuiltEventRecordHeader record;
+      if (end - offset < sizeof(record)) {
+        return false;
+      }
+      std::memcpy(&record, base + offset, sizeof(record));
+      const size_t hitBytes =
+          static_cast<size_t>(record.hitCount) * sizeof(MinimalEventData);
+      if (record.triggerIndex >= record.hitCount ||
+          end - offset - sizeof(record) < hitBytes) {
+        return false;
+      }
+      MinimalEventData trigger;
+      std::memcpy(static_cast<void *>(&trigger),
+                  base + offset + sizeof(record) +
+                      record.triggerIndex * sizeof(MinimalEventData),
+                  sizeof(trigger));
+      records.push_back({static_cast<uint32_t>(offset),
+                         static_cast<uint32_t>(sizeof(record) + hitBytes),
+                         trigger.module, trigger.channel,
+                         trigger.timeStampNs});
+      offset += sizeof(record) + hitBytes;
+    }
+    break;
+
+  case FORMAT_VERSION_EVENTDATA: {
+    // Fixed fields as written by Serialize(), then six probes, each a
+    // uint32_t sample count followed by the samples
+    constexpr size_t kModuleOffset =
+        Digitizer::TIMESTAMPNS_SIZE + Digitizer::WAVEFORMSIZE_SIZE +
+        Digitizer::ENERGY_SIZE + Digitizer::ENERGYSHORT_SIZE;
+    constexpr size_t kSampleSizes[] = {sizeof(int32_t), sizeof(int32_t),
+                                       sizeof(uint8_t), sizeof(uint8_t),
+                                       sizeof(uint8_t), sizeof(uint8_t)};
+    while (offset < end) {
+      size_t cursor = offset + Digitizer::EVENTDATA_SIZE;
+      if (cursor > end) {
+        return false;
+      }
+      for (size_t sampleSize : kSampleSizes) {
+        uint32_t count;
+        if (end - cursor < sizeof(count)) {
+          return false;
+        }
+        std::memcpy(&count, base + cursor, sizeof(count));
+        cursor += sizeof(count);
+        if ((end - cursor) / sampleSize < count) {
+          return false;
+        }
+        cursor += static_cast<size_t>(count) * sampleSize;
+      }
+      EventRecordRef ref;
+      ref.offset = static_cast<uint32_t>(offset);
+      ref.size = static_cast<uint32_t>(cursor - offset);
+      ref.module = base[offset + kModuleOffset];
+      ref.channel = base[offset + kModuleOffset + Digitizer::MODULE_SIZE];
+      std::memcpy(&ref.timeStampNs, base + offset, sizeof(ref.timeStampNs));
+      records.push_back(ref);
+      offset = cursor;
+    }
+    break;
+  }
+
+  case FORMAT_VERSION_COMPACT_EVENTDATA: {
+    // Fixed fields as in version 1, then the six sample counts up front
+    constexpr size_t kModuleOffset =
+        Digitizer::TIMESTAMPNS_SIZE + Digitizer::WAVEFORMSIZE_SIZE +
+        Digitizer::ENERGY_SIZE + Digitizer::ENERGYSHORT_SIZE;
+    while (offset < end) {
+      size_t cursor = offset + Digitizer::EVENTDATA_SIZE + kCompactCountsSize;
+      if (cursor > end) {
+        return false;
+      }
+      uint32_t counts[kCompactProbeCount];
+      std::memcpy(counts, base + offset + Digitizer::EVENTDATA_SIZE,
+                  kCompactCountsSize);
+      if (end - cursor < CompactPayloadSize(counts)) {
+        return false;
+      }
+      cursor += CompactPayloadSize(counts);
+      EventRecordRef ref;
+      ref.offset = static_cast<uint32_t>(offset);
+      ref.size = static_cast<uint32_t>(cursor - offset);
+      ref.module = base[offset + kModuleOffset];
+      ref.channel = base[offset + kModuleOffset + Digitizer::MODULE_SIZE];
+      std::memcpy(&ref.timeStampNs, base + offset, sizeof(ref.timeStampNs));
+      records.push_back(ref);
+      offset = cursor;
+    }
+    break;
+  }
+
+  default:
+    return false;
+  }
+  return records.size() == header.event_count;
+}
+
 }  // namespace DELILA::Net
\ No newline at end of file
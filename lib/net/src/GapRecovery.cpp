@@ -0,0 +1,172 @@
+/**
+ * @file GapRecovery.cpp
+ * @brief Implementation of GapRecovery
+ */
+
+#include "GapRecovery.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "DataProcessor.hpp"
+
+namespace DELILA {
+namespace Net {
+
+void GapRecovery::SetRetryInterval(std::chrono::milliseconds interval)
+{
+    retry_interval_ = std::max(interval, std::chrono::milliseconds(1));
+}
+
+void GapRecovery::SetTimeout(std::chrono::milliseconds timeout)
+{
+    timeout_ = timeout;
+}
+
+void GapRecovery::SetMaxMissing(size_t frames)
+{
+    max_missing_ = std::max<size_t>(frames, 1);
+}
+
+GapRecovery::Outcome GapRecovery::Accept(uint64_t sequence, Clock::time_point now,
+                                         uint64_t* recoveryNs)
+{
+    // Frames lost before the first one received
+    const bool first = !detector_.HasExpectedSequence();
+
+    switch (detector_.Check(sequence)) {
+        case SequenceGapDetector::Result::Ok:
+            if (first && sequence > 0) {
+                gaps_++;
+                AddMissing(0, sequence - 1, now);
+                return Outcome::Gap;
+            }
+            return Outcome::InOrder;
+
+        case SequenceGapDetector::Result::Gap: {
+            auto gap = detector_.GetLastGap();
+            gaps_++;
+            AddMissing(gap->expected, gap->received - 1, now);
+            return Outcome::Gap;
+        }
+
+        case SequenceGapDetector::Result::BackwardsSequence:
+            break;
+    }
+
+    auto it = missing_.find(sequence);
+    if (it == missing_.end()) {
+        duplicates_++;
+        return Outcome::Duplicate;
+    }
+    if (recoveryNs) {
+        *recoveryNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now - it->second.detected)
+                .count());
+    }
+    missing_.erase(it);
+    UpdateMissingCount();
+    recovered_++;
+    return Outcome::Recovered;
+}
+
+std::vector<GapRecovery::Range> GapRecovery::TakeRequests(Clock::time_point now)
+{
+    std::vector<Range> ranges;
+    for (auto it = missing_.begin(); it != missing_.end();) {
+        if (now - it->second.detected >= timeout_) {
+            lost_++;
+            it = missing_.erase(it);
+            continue;
+        }
+        if (it->second.nextRequest <= now) {
+            it->second.nextRequest = now + retry_interval_;
+            if (!ranges.empty() && ranges.back().last + 1 == it->first) {
+                ranges.back().last = it->first;
+            } else {
+                ranges.push_back({it->first, it->first});
+            }
+        }
+        ++it;
+    }
+    UpdateMissingCount();
+    requests_ += ranges.size();
+    return ranges;
+}
+
+void GapRecovery::Reset()
+{
+    detector_.Reset();
+    missing_.clear();
+    UpdateMissingCount();
+    gaps_ = 0;
+    requests_ = 0;
+    recovered_ = 0;
+    lost_ = 0;
+    duplicates_ = 0;
+}
+
+void GapRecovery::AddMissing(uint64_t first, uint64_t last, Clock::time_point now)
+{
+    // A gap too large to track: its oldest frames are lost at once
+    const uint64_t frames = last - first + 1;
+    if (frames > max_missing_) {
+        lost_ += frames - max_missing_;
+        first = last - max_missing_ + 1;
+    }
+
+    for (uint64_t sequence = first; sequence <= last; ++sequence) {
+        missing_.emplace_hint(missing_.end(), sequence, Missing{now, now});
+    }
+    while (missing_.size() > max_missing_) {
+        lost_++;
+        missing_.erase(missing_.begin());
+    }
+    UpdateMissingCount();
+}
+
+std::unique_ptr<std::vector<uint8_t>> GapRecovery::EncodeRequest(const Range& range)
+{
+    BinaryDataHeader header{};
+    header.magic_number = BINARY_DATA_MAGIC_NUMBER;
+    header.sequence_number = range.first;
+    header.format_version = FORMAT_VERSION_EVENTDATA;
+    header.header_size = BINARY_DATA_HEADER_SIZE;
+    header.uncompressed_size = sizeof(uint64_t);
+    header.compressed_size = sizeof(uint64_t);
+    header.compression_type = COMPRESSION_NONE;
+    header.checksum_type = CHECKSUM_NONE;
+    header.message_type = MESSAGE_TYPE_RETRANSMIT_REQUEST;
+
+    auto data = std::make_unique<std::vector<uint8_t>>(BINARY_DATA_HEADER_SIZE +
+                                                       sizeof(uint64_t));
+    std::memcpy(data->data(), &header, sizeof(header));
+    std::memcpy(data->data() + BINARY_DATA_HEADER_SIZE, &range.last,
+                sizeof(uint64_t));
+    return data;
+}
+
+bool GapRecovery::DecodeRequest(const std::vector<uint8_t>& data, Range& range)
+{
+    BinaryDataHeader header;
+    if (!DataProcessor::PeekHeader(data, header) ||
+        header.message_type != MESSAGE_TYPE_RETRANSMIT_REQUEST ||
+        header.uncompressed_size != sizeof(uint64_t) ||
+        data.size() != BINARY_DATA_HEADER_SIZE + sizeof(uint64_t)) {
+        return false;
+    }
+
+    Range decoded;
+    decoded.first = header.sequence_number;
+    std::memcpy(&decoded.last, data.data() + BINARY_DATA_HEADER_SIZE,
+                sizeof(uint64_t));
+    if (decoded.last < decoded.first) {
+        return false;
+    }
+    range = decoded;
+    return true;
+}
+
+}  // namespace Net
+}  // namespace DELILA
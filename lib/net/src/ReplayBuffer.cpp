@@ -0,0 +1,93 @@
+/**
+ * @file ReplayBuffer.cpp
+ * @brief Implementation of ReplayBuffer
+ */
+
+#include "ReplayBuffer.hpp"
+
+#include <algorithm>
+
+#include "DataProcessor.hpp"
+
+namespace DELILA {
+namespace Net {
+
+namespace {
+// Evicted buffers kept for reuse; more would only hold memory
+constexpr size_t kMaxSpareBuffers = 8;
+}  // namespace
+
+ReplayBuffer::ReplayBuffer(size_t maxFrames, size_t maxBytes)
+    : max_frames_(std::max<size_t>(maxFrames, 1)), max_bytes_(maxBytes)
+{
+}
+
+void ReplayBuffer::SetCapacity(size_t maxFrames, size_t maxBytes)
+{
+    max_frames_ = std::max<size_t>(maxFrames, 1);
+    max_bytes_ = maxBytes;
+    while (entries_.size() > max_frames_ ||
+           (!entries_.empty() && bytes_ > max_bytes_)) {
+        EvictOldest();
+    }
+}
+
+bool ReplayBuffer::Store(const std::vector<uint8_t>& frame)
+{
+    BinaryDataHeader header;
+    if (!DataProcessor::PeekHeader(frame, header)) {
+        return false;
+    }
+    if (!entries_.empty() && header.sequence_number <= entries_.back().sequence) {
+        return false;
+    }
+
+    while (!entries_.empty() && (entries_.size() >= max_frames_ ||
+                                 bytes_ + frame.size() > max_bytes_)) {
+        EvictOldest();
+    }
+
+    Entry entry;
+    entry.sequence = header.sequence_number;
+    if (!spare_.empty()) {
+        entry.frame = std::move(spare_.back());
+        spare_.pop_back();
+    }
+    entry.frame.assign(frame.begin(), frame.end());
+    bytes_ += frame.size();
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+const std::vector<uint8_t>* ReplayBuffer::Find(uint64_t sequence) const
+{
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), sequence,
+        [](const Entry& entry, uint64_t value) { return entry.sequence < value; });
+    if (it == entries_.end() || it->sequence != sequence) {
+        return nullptr;
+    }
+    return &it->frame;
+}
+
+void ReplayBuffer::Clear()
+{
+    while (!entries_.empty()) {
+        EvictOldest();
+    }
+    evicted_ = 0;
+}
+
+void ReplayBuffer::EvictOldest()
+{
+    Entry& oldest = entries_.front();
+    bytes_ -= oldest.frame.size();
+    if (spare_.size() < kMaxSpareBuffers) {
+        spare_.push_back(std::move(oldest.frame));
+    }
+    entries_.pop_front();
+    evicted_++;
+}
+
+}  // namespace Net
+}  // namespace DELILA
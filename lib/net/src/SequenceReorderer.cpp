@@ -0,0 +1,145 @@
+/**
+ * @file SequenceReorderer.cpp
+ * @brief Implementation of SequenceReorderer
+ */
+
+#include "SequenceReorderer.hpp"
+
+namespace DELILA {
+namespace Net {
+
+SequenceReorderer::SequenceReorderer(size_t window) : window_(window) {}
+
+void SequenceReorderer::Push(uint64_t sequence, Frame frame,
+                             std::vector<Frame>& ready)
+{
+    received_++;
+
+    // First frame - set expected
+    if (!started_) {
+        started_ = true;
+        next_ = sequence;
+        highest_ = sequence;
+    }
+
+    // Behind the expected sequence: late if given up on, else a duplicate
+    if (sequence < next_) {
+        if (!Recover(sequence)) {
+            duplicates_++;
+            return;
+        }
+        reordered_++;
+        late_++;
+        lost_--;
+        ready.push_back(std::move(frame));
+        return;
+    }
+
+    if (held_.count(sequence) != 0) {
+        duplicates_++;
+        return;
+    }
+
+    if (sequence < highest_) {
+        reordered_++;
+    } else {
+        highest_ = sequence;
+    }
+
+    if (sequence == next_) {
+        ready.push_back(std::move(frame));
+        next_++;
+        ReleaseContiguous(ready);
+        return;
+    }
+
+    // Ahead of a missing frame
+    if (window_ == 0) {
+        GiveUp(next_, sequence);
+        next_ = sequence + 1;
+        ready.push_back(std::move(frame));
+        return;
+    }
+
+    held_.emplace(sequence, std::move(frame));
+    while (held_.size() > window_) {
+        GiveUpOldestGap(ready);
+    }
+    held_count_ = held_.size();
+}
+
+void SequenceReorderer::Flush(std::vector<Frame>& ready)
+{
+    while (!held_.empty()) {
+        GiveUpOldestGap(ready);
+    }
+    held_count_ = 0;
+}
+
+void SequenceReorderer::Reset()
+{
+    started_ = false;
+    next_ = 0;
+    highest_ = 0;
+    held_.clear();
+    given_up_.clear();
+    received_ = 0;
+    lost_ = 0;
+    reordered_ = 0;
+    late_ = 0;
+    duplicates_ = 0;
+    held_count_ = 0;
+}
+
+void SequenceReorderer::ReleaseContiguous(std::vector<Frame>& ready)
+{
+    auto it = held_.begin();
+    while (it != held_.end() && it->first == next_) {
+        ready.push_back(std::move(it->second));
+        next_++;
+        it = held_.erase(it);
+    }
+    held_count_ = held_.size();
+}
+
+void SequenceReorderer::GiveUpOldestGap(std::vector<Frame>& ready)
+{
+    const uint64_t first = held_.begin()->first;
+    GiveUp(next_, first);
+    next_ = first;
+    ReleaseContiguous(ready);
+}
+
+void SequenceReorderer::GiveUp(uint64_t from, uint64_t to)
+{
+    lost_ += to - from;
+    given_up_.emplace(from, to);
+    if (given_up_.size() > kMaxGivenUpRanges) {
+        given_up_.erase(given_up_.begin());
+    }
+}
+
+bool SequenceReorderer::Recover(uint64_t sequence)
+{
+    auto it = given_up_.upper_bound(sequence);
+    if (it == given_up_.begin()) {
+        return false;
+    }
+    --it;
+    const uint64_t first = it->first;
+    const uint64_t end = it->second;
+    if (sequence >= end) {
+        return false;
+    }
+    given_up_.erase(it);
+    if (first < sequence) {
+        given_up_.emplace(first, sequence);
+    }
+    if (sequence + 1 < end) {
+        given_up_.emplace(sequence + 1, end);
+    }
+    return true;
+}
+
+}  // namespace Net
+}  // namespace DELILA
@@ -0,0 +1,701 @@
+/**
+ * @file SharedMemoryRing.cpp
+ * @brief Implementation of SharedMemoryRing
+ */
+
+#include "SharedMemoryRing.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace DELILA {
+namespace Net {
+
+namespace {
+
+constexpr uint64_t kMagic = 0x44454C494C41524EULL;  // "DELILARN"
+constexpr uint32_t kVersion = 2;
+constexpr size_t kAlignment = 16;  // Also the record header size
+
+// Record states
+constexpr uint32_t kPending = 0;   // Published, not yet released
+constexpr uint32_t kConsumed = 1;  // Released by a consumer (Distribute)
+constexpr uint32_t kPadding = 2;   // Filler up to the end of the ring
+
+// Subscriber slot states (Broadcast)
+constexpr uint32_t kSlotFree = 0;
+constexpr uint32_t kSlotActive = 1;
+constexpr uint32_t kSlotJoining = 2;  // Cursor not valid yet
+
+using Clock = std::chrono::steady_clock;
+
+size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+size_t RoundUpToPowerOfTwo(size_t value)
+{
+    size_t result = SharedMemoryRing::kMinCapacity;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool ProcessAlive(int32_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+// Futexes are shared (not FUTEX_PRIVATE) so that waiters in other
+// processes mapping the same segment are woken
+void FutexWait(std::atomic<uint32_t>* word, uint32_t expected,
+               std::chrono::nanoseconds timeout)
+{
+#ifdef __linux__
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+            &ts, nullptr, 0);
+#else
+    // No futex: poll with a short sleep
+    if (word->load() == expected) {
+        std::this_thread::sleep_for(
+            std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(200)));
+    }
+#endif
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+            nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+// Sleep on @p seq until @p ready() holds or @p deadline passes.
+// Wakers bump @p seq before checking @p waiters, so a wakeup between the
+// ready() check and the futex call makes FUTEX_WAIT return immediately.
+template <typename Ready>
+bool WaitUntil(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters,
+               Clock::time_point deadline, Ready ready)
+{
+    while (true) {
+        uint32_t observed = seq.load();
+        if (ready()) {
+            return true;
+        }
+        auto now = Clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        waiters.fetch_add(1);
+        FutexWait(&seq, observed, deadline - now);
+        waiters.fetch_sub(1);
+    }
+}
+
+}  // namespace
+
+// Shared layout at the start of the segment. Cursors are absolute byte
+// positions; the ring offset is position & (capacity - 1).
+struct SharedMemoryRing::Header {
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t mode;
+    uint64_t capacity;
+    std::atomic<uint32_t> closed;
+    std::atomic<int32_t> owner_pid;
+    std::atomic<uint32_t> producer_active;
+    std::atomic<int32_t> producer_pid;
+
+    alignas(64) std::atomic<uint64_t> head;  // End of published frames
+    alignas(64) std::atomic<uint64_t> tail;  // Start of live data
+    alignas(64) std::atomic<uint64_t> claim; // Distribute: next unclaimed frame
+
+    alignas(64) std::atomic<uint32_t> data_seq;
+    std::atomic<uint32_t> data_waiters;
+    alignas(64) std::atomic<uint32_t> space_seq;
+    std::atomic<uint32_t> space_waiters;
+
+    std::atomic<uint64_t> frames;  // Index of the next frame published
+
+    struct alignas(64) Subscriber {
+        std::atomic<uint32_t> active;  // kSlotFree, kSlotJoining or kSlotActive
+        std::atomic<int32_t> pid;
+        std::atomic<uint64_t> cursor;
+        std::atomic<uint64_t> next_index;  // Frame expected next
+        std::atomic<uint64_t> dropped;     // Frames found overwritten
+    };
+    Subscriber subscribers[kMaxSubscribers];
+};
+
+// Frame header inside the data area, followed by the frame bytes
+struct SharedMemoryRing::Record {
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> length;
+    std::atomic<uint64_t> index;  // Frame number; padding: the next frame's
+};
+
+SharedMemoryRing::~SharedMemoryRing() { Close(); }
+
+std::string SharedMemoryRing::ParseAddress(const std::string& address)
+{
+    static const std::string kScheme = "shm://";
+    if (address.compare(0, kScheme.size(), kScheme) != 0) {
+        return "";
+    }
+    return address.substr(kScheme.size());
+}
+
+bool SharedMemoryRing::Create(const std::string& name, Mode mode,
+                              size_t capacity, Role role)
+{
+    if (IsOpen() || name.empty()) {
+        return false;
+    }
+
+    std::string shm_name = "/" + name;
+
+    // Refuse to replace a segment whose owner is still running
+    int existing = shm_open(shm_name.c_str(), O_RDWR, 0);
+    if (existing >= 0) {
+        struct stat st;
+        bool in_use = false;
+        if (fstat(existing, &st) == 0 &&
+            static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+            void* addr = mmap(nullptr, sizeof(Header), PROT_READ | PROT_WRITE,
+                              MAP_SHARED, existing, 0);
+            if (addr != MAP_FAILED) {
+                auto* old = static_cast<Header*>(addr);
+                in_use = old->magic.load() == kMagic && old->closed.load() == 0 &&
+                         ProcessAlive(old->owner_pid.load());
+                munmap(addr, sizeof(Header));
+            }
+        }
+        close(existing);
+        if (in_use) {
+            return false;
+        }
+        shm_unlink(shm_name.c_str());
+    }
+
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t ring_capacity = RoundUpToPowerOfTwo(capacity);
+    size_t total_size = AlignUp(sizeof(Header), 64) + ring_capacity;
+    if (ftruncate(fd, static_cast<off_t>(total_size)) != 0 ||
+        !MapSegment(fd, total_size)) {
+        close(fd);
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+    close(fd);
+
+    // ftruncate zero-fills the segment, which is a valid initial state for
+    // every atomic; construct the header in place and publish it last
+    header_ = new (header_) Header();
+    header_->version = kVersion;
+    header_->mode = static_cast<uint32_t>(mode);
+    header_->capacity = ring_capacity;
+    header_->owner_pid.store(static_cast<int32_t>(getpid()));
+    header_->magic.store(kMagic, std::memory_order_release);
+
+    capacity_ = ring_capacity;
+    name_ = shm_name;
+    owner_ = true;
+
+    if (!JoinAs(role)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemoryRing::Attach(const std::string& name, Role role, Mode mode)
+{
+    if (IsOpen() || name.empty()) {
+        return false;
+    }
+
+    std::string shm_name = "/" + name;
+    int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) <= AlignUp(sizeof(Header), 64) ||
+        !MapSegment(fd, static_cast<size_t>(st.st_size))) {
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    if (header_->magic.load(std::memory_order_acquire) != kMagic ||
+        header_->version != kVersion ||
+        header_->mode != static_cast<uint32_t>(mode) ||
+        header_->closed.load() != 0 ||
+        AlignUp(sizeof(Header), 64) + header_->capacity > mapped_size_) {
+        Close();
+        return false;
+    }
+
+    capacity_ = header_->capacity;
+    name_ = shm_name;
+    owner_ = false;
+
+    if (!JoinAs(role)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemoryRing::MapSegment(int fd, size_t total_size)
+{
+    void* addr = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    header_ = static_cast<Header*>(addr);
+    data_ = static_cast<uint8_t*>(addr) + AlignUp(sizeof(Header), 64);
+    mapped_size_ = total_size;
+    return true;
+}
+
+bool SharedMemoryRing::JoinAs(Role role)
+{
+    role_ = role;
+    auto pid = static_cast<int32_t>(getpid());
+
+    if (role == Role::Producer) {
+        uint32_t expected = 0;
+        if (!header_->producer_active.compare_exchange_strong(expected, 1)) {
+            // Take over from a producer process that died without leaving
+            int32_t previous = header_->producer_pid.load();
+            if (previous == pid || ProcessAlive(previous)) {
+                return false;
+            }
+        }
+        header_->producer_pid.store(pid);
+        return true;
+    }
+
+    if (static_cast<Mode>(header_->mode) != Mode::Broadcast) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < kMaxSubscribers; ++i) {
+        auto& slot = header_->subscribers[i];
+        uint32_t expected = slot.active.load();
+        if (expected != kSlotFree && ProcessAlive(slot.pid.load())) {
+            continue;
+        }
+        // The producer ignores the slot until its cursor is valid
+        if (!slot.active.compare_exchange_strong(expected, kSlotJoining)) {
+            continue;
+        }
+        slot.pid.store(pid);
+        slot.dropped.store(0);
+        // Read after head, frames may already count a frame being published
+        // past it; Release() copes with that
+        slot.cursor.store(header_->head.load(std::memory_order_acquire));
+        slot.next_index.store(header_->frames.load(std::memory_order_acquire));
+        slot.active.store(kSlotActive, std::memory_order_release);
+        subscriber_slot_ = static_cast<int>(i);
+        return true;
+    }
+    return false;
+}
+
+void SharedMemoryRing::Close()
+{
+    if (!header_) {
+        return;
+    }
+
+    if (role_ == Role::Producer) {
+        header_->producer_active.store(0);
+    } else if (subscriber_slot_ >= 0) {
+        header_->subscribers[subscriber_slot_].active.store(kSlotFree);
+    }
+
+    if (owner_) {
+        header_->closed.store(1);
+        WakeConsumers();
+        WakeProducer();
+        shm_unlink(name_.c_str());
+    }
+
+    munmap(header_, mapped_size_);
+    header_ = nullptr;
+    data_ = nullptr;
+    capacity_ = 0;
+    mapped_size_ = 0;
+    name_.clear();
+    owner_ = false;
+    subscriber_slot_ = -1;
+    pending_end_ = 0;
+    has_peeked_ = false;
+}
+
+bool SharedMemoryRing::IsClosedByOwner() const
+{
+    return header_ && header_->closed.load() != 0;
+}
+
+SharedMemoryRing::Record* SharedMemoryRing::RecordAt(uint64_t position) const
+{
+    static_assert(sizeof(Record) == kAlignment, "records must keep frames aligned");
+    return reinterpret_cast<Record*>(data_ + (position & (capacity_ - 1)));
+}
+
+size_t SharedMemoryRing::GetMaxFrameSize() const
+{
+    // A frame plus the padding before it must always fit into the ring
+    return capacity_ / 2 - sizeof(Record);
+}
+
+uint64_t SharedMemoryRing::ReleasedPosition() const
+{
+    if (static_cast<Mode>(header_->mode) == Mode::Distribute) {
+        // Released frames are reclaimed in order; never past the claim cursor
+        uint64_t tail = header_->tail.load(std::memory_order_acquire);
+        uint64_t claim = header_->claim.load(std::memory_order_acquire);
+        while (tail < claim) {
+            Record* record = RecordAt(tail);
+            uint32_t state = record->state.load(std::memory_order_acquire);
+            if (state != kConsumed && state != kPadding) {
+                break;
+            }
+            tail += sizeof(Record) +
+                    AlignUp(record->length.load(std::memory_order_relaxed), kAlignment);
+        }
+        return tail;
+    }
+
+    uint64_t low = header_->head.load(std::memory_order_acquire);
+    for (auto& slot : header_->subscribers) {
+        if (slot.active.load() == kSlotActive) {
+            low = std::min(low, slot.cursor.load(std::memory_order_acquire));
+        }
+    }
+    return low;
+}
+
+uint64_t SharedMemoryRing::LowWaterMark()
+{
+    uint64_t low = ReleasedPosition();
+    header_->tail.store(low, std::memory_order_release);
+    return low;
+}
+
+void SharedMemoryRing::Overwrite(uint64_t end)
+{
+    // Records between tail and head are intact until the new frame is
+    // written, so the walk sees valid lengths
+    uint64_t old_tail = header_->tail.load(std::memory_order_relaxed);
+    uint64_t tail = old_tail;
+    while (end - tail > capacity_) {
+        tail = NextRecord(tail);
+    }
+    if (tail == old_tail) {
+        return;
+    }
+    // Published before the overwrite starts: a subscriber that still sees
+    // its record at or past tail after reading it read it intact
+    header_->tail.store(tail, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+uint64_t SharedMemoryRing::NextRecord(uint64_t position) const
+{
+    Record* record = RecordAt(position);
+    return position + sizeof(Record) +
+           AlignUp(record->length.load(std::memory_order_relaxed), kAlignment);
+}
+
+uint64_t SharedMemoryRing::GetDroppedFrames() const
+{
+    if (!header_ || static_cast<Mode>(header_->mode) != Mode::Broadcast) {
+        return 0;
+    }
+
+    // Frames a subscriber has not reached yet but that were overwritten
+    // already count too, so a stalled subscriber's losses show up
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    uint64_t oldest = tail < header_->head.load(std::memory_order_acquire)
+                          ? RecordAt(tail)->index.load(std::memory_order_relaxed)
+                          : header_->frames.load(std::memory_order_acquire);
+    auto lost = [oldest](const Header::Subscriber& slot) {
+        uint64_t next = slot.next_index.load(std::memory_order_acquire);
+        return slot.dropped.load() + (oldest > next ? oldest - next : 0);
+    };
+
+    if (role_ == Role::Consumer) {
+        return subscriber_slot_ >= 0 ? lost(header_->subscribers[subscriber_slot_]) : 0;
+    }
+    uint64_t dropped = 0;
+    for (auto& slot : header_->subscribers) {
+        if (slot.active.load() == kSlotActive) {
+            dropped += lost(slot);
+        }
+    }
+    return dropped;
+}
+
+size_t SharedMemoryRing::GetUsedBytes() const
+{
+    if (!header_) {
+        return 0;
+    }
+    return static_cast<size_t>(header_->head.load(std::memory_order_acquire) -
+                               ReleasedPosition());
+}
+
+void SharedMemoryRing::WakeConsumers()
+{
+    header_->data_seq.fetch_add(1);
+    if (header_->data_waiters.load() != 0) {
+        FutexWakeAll(&header_->data_seq);
+    }
+}
+
+void SharedMemoryRing::WakeProducer()
+{
+    header_->space_seq.fetch_add(1);
+    if (header_->space_waiters.load() != 0) {
+        FutexWakeAll(&header_->space_seq);
+    }
+}
+
+uint8_t* SharedMemoryRing::Reserve(size_t size, std::chrono::milliseconds timeout)
+{
+    if (!header_ || role_ != Role::Producer || pending_end_ != 0 ||
+        size > GetMaxFrameSize()) {
+        return nullptr;
+    }
+
+    uint64_t position = header_->head.load(std::memory_order_relaxed);
+    size_t needed = sizeof(Record) + AlignUp(size, kAlignment);
+    size_t offset = static_cast<size_t>(position & (capacity_ - 1));
+    size_t padding = (offset + needed > capacity_) ? capacity_ - offset : 0;
+    uint64_t end = position + padding + needed;
+
+    if (static_cast<Mode>(header_->mode) == Mode::Broadcast) {
+        // Like a PUB socket, never wait for subscribers: the oldest frames
+        // make room, and subscribers that had not read them lose them
+        Overwrite(end);
+    } else {
+        auto deadline = Clock::now() + timeout;
+        bool fits = WaitUntil(header_->space_seq, header_->space_waiters, deadline,
+                              [&]() {
+                                  return header_->closed.load() != 0 ||
+                                         end - LowWaterMark() <= capacity_;
+                              });
+        if (!fits) {
+            return nullptr;
+        }
+    }
+    if (header_->closed.load() != 0) {
+        return nullptr;
+    }
+
+    uint64_t index = header_->frames.load(std::memory_order_relaxed);
+    if (padding > 0) {
+        Record* filler = RecordAt(position);
+        filler->length.store(static_cast<uint32_t>(padding - sizeof(Record)),
+                             std::memory_order_relaxed);
+        filler->state.store(kPadding, std::memory_order_relaxed);
+        filler->index.store(index, std::memory_order_relaxed);
+    }
+
+    Record* record = RecordAt(position + padding);
+    record->length.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    record->state.store(kPending, std::memory_order_relaxed);
+    record->index.store(index, std::memory_order_relaxed);
+
+    pending_end_ = end;
+    return reinterpret_cast<uint8_t*>(record) + sizeof(Record);
+}
+
+void SharedMemoryRing::Commit()
+{
+    if (!header_ || pending_end_ == 0) {
+        return;
+    }
+    header_->frames.fetch_add(1, std::memory_order_relaxed);
+    header_->head.store(pending_end_, std::memory_order_release);
+    pending_end_ = 0;
+    WakeConsumers();
+}
+
+bool SharedMemoryRing::Write(const void* data, size_t size,
+                             std::chrono::milliseconds timeout)
+{
+    uint8_t* target = Reserve(size, timeout);
+    if (!target) {
+        return false;
+    }
+    std::memcpy(target, data, size);
+    Commit();
+    return true;
+}
+
+SharedMemoryRing::FrameView SharedMemoryRing::Peek(std::chrono::milliseconds timeout)
+{
+    FrameView view;
+    if (!header_ || role_ != Role::Consumer || has_peeked_) {
+        return view;
+    }
+
+    bool distribute = static_cast<Mode>(header_->mode) == Mode::Distribute;
+    std::atomic<uint64_t>& cursor =
+        distribute ? header_->claim : header_->subscribers[subscriber_slot_].cursor;
+    auto deadline = Clock::now() + timeout;
+
+    while (true) {
+        bool available = WaitUntil(
+            header_->data_seq, header_->data_waiters, deadline, [&]() {
+                return header_->closed.load() != 0 ||
+                       cursor.load(std::memory_order_acquire) <
+                           header_->head.load(std::memory_order_acquire);
+            });
+        if (!available || header_->closed.load() != 0) {
+            return view;
+        }
+
+        uint64_t position = cursor.load(std::memory_order_acquire);
+        if (position >= header_->head.load(std::memory_order_acquire)) {
+            continue;  // Another consumer took it
+        }
+
+        if (!distribute) {
+            // Overwritten: skip to the oldest frame left. The frame numbers
+            // tell Release() how many were lost.
+            uint64_t tail = header_->tail.load(std::memory_order_acquire);
+            if (position < tail) {
+                cursor.store(tail, std::memory_order_release);
+                continue;
+            }
+        }
+
+        Record* record = RecordAt(position);
+        uint32_t length = record->length.load(std::memory_order_relaxed);
+        uint32_t state = record->state.load(std::memory_order_relaxed);
+        uint64_t index = record->index.load(std::memory_order_relaxed);
+        uint64_t next = position + sizeof(Record) + AlignUp(length, kAlignment);
+
+        if (distribute) {
+            // The record cannot be reused while the claim cursor is still
+            // at it, so a successful claim validates what was read above
+            if (!cursor.compare_exchange_strong(position, next)) {
+                continue;
+            }
+        } else {
+            if (!Intact(position)) {
+                continue;
+            }
+            if (state == kPadding) {
+                cursor.store(next, std::memory_order_release);
+                continue;
+            }
+        }
+
+        if (state == kPadding) {
+            continue;
+        }
+
+        peeked_position_ = position;
+        peeked_end_ = next;
+        peeked_index_ = index;
+        has_peeked_ = true;
+        view.data = reinterpret_cast<const uint8_t*>(record) + sizeof(Record);
+        view.size = length;
+        return view;
+    }
+}
+
+bool SharedMemoryRing::Release()
+{
+    if (!header_ || !has_peeked_) {
+        return false;
+    }
+    has_peeked_ = false;
+
+    if (static_cast<Mode>(header_->mode) == Mode::Distribute) {
+        RecordAt(peeked_position_)->state.store(kConsumed, std::memory_order_release);
+        WakeProducer();
+        return true;
+    }
+    auto& slot = header_->subscribers[subscriber_slot_];
+    slot.cursor.store(peeked_end_, std::memory_order_release);
+    if (!Intact(peeked_position_)) {
+        // Counted with the next frame read intact
+        return false;
+    }
+    // A frame number below the expected one only happens right after
+    // joining (see JoinAs())
+    uint64_t expected = slot.next_index.load(std::memory_order_relaxed);
+    if (peeked_index_ > expected) {
+        slot.dropped.fetch_add(peeked_index_ - expected);
+    }
+    slot.next_index.store(peeked_index_ + 1, std::memory_order_release);
+    return true;
+}
+
+bool SharedMemoryRing::Intact(uint64_t position) const
+{
+    // Orders the reads of the record before the tail check (seqlock)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header_->tail.load(std::memory_order_relaxed) <= position;
+}
+
+std::unique_ptr<std::vector<uint8_t>> SharedMemoryRing::Read(
+    std::chrono::milliseconds timeout)
+{
+    auto deadline = Clock::now() + timeout;
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Clock::now());
+        FrameView view = Peek(std::max(remaining, std::chrono::milliseconds(0)));
+        if (!view.data) {
+            return nullptr;
+        }
+        auto frame =
+            std::make_unique<std::vector<uint8_t>>(view.data, view.data + view.size);
+        // A frame overwritten while being copied counts as dropped
+        if (Release()) {
+            return frame;
+        }
+    }
+}
+
+}  // namespace Net
+}  // namespace DELILA
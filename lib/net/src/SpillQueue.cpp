@@ -0,0 +1,274 @@
+/**
+ * @file SpillQueue.cpp
+ * @brief Implementation of SpillQueue
+ */
+
+#include "SpillQueue.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace DELILA {
+namespace Net {
+
+namespace {
+
+// Header of every record in the spill file
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t size;   // Payload bytes
+    uint64_t stamp;  // Frame::stamp
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader must be 16 bytes");
+
+constexpr uint32_t kRecordMagic = 0x4C495053;  // "SPIL"
+
+}  // namespace
+
+SpillQueue::SpillQueue(size_t memoryFrames)
+    : memory_frames_(std::max<size_t>(memoryFrames, 1))
+{
+}
+
+SpillQueue::~SpillQueue() { CloseSpill(); }
+
+void SpillQueue::SetMemoryFrames(size_t memoryFrames)
+{
+    memory_frames_ = std::max<size_t>(memoryFrames, 1);
+}
+
+bool SpillQueue::OpenSpill(const std::string& path, uint64_t capacityBytes,
+                           std::string* error)
+{
+    CloseSpill();
+
+    if (capacityBytes <= sizeof(RecordHeader)) {
+        if (error) {
+            *error = "spill capacity too small";
+        }
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        if (error) {
+            *error = path + ": " + std::strerror(errno);
+        }
+        return false;
+    }
+
+    fd_ = fd;
+    path_ = path;
+    capacity_ = capacityBytes;
+    head_ = 0;
+    tail_ = 0;
+    disk_frames_ = 0;
+    return true;
+}
+
+void SpillQueue::CloseSpill()
+{
+    if (fd_ < 0) {
+        return;
+    }
+    dropped_ += disk_frames_;
+    ::close(fd_);
+    ::unlink(path_.c_str());
+    fd_ = -1;
+    path_.clear();
+    capacity_ = 0;
+    head_ = 0;
+    tail_ = 0;
+    disk_frames_ = 0;
+}
+
+bool SpillQueue::Push(Frame&& frame)
+{
+    Reservation reservation;
+    switch (BeginPush(frame, reservation)) {
+    case PushResult::Stored:
+        return true;
+    case PushResult::Dropped:
+        return false;
+    case PushResult::Reserved:
+        break;
+    }
+    return EndPush(reservation, WriteReserved(reservation, frame));
+}
+
+SpillQueue::PushResult SpillQueue::BeginPush(Frame& frame,
+                                             Reservation& reservation)
+{
+    if (!frame.data) {
+        return PushResult::Dropped;
+    }
+
+    if (disk_frames_ == 0 && !reserved_ && memory_.size() < memory_frames_) {
+        memory_.push_back(std::move(frame));
+        return PushResult::Stored;
+    }
+
+    const uint64_t size = frame.data->size();
+    const uint64_t needed = sizeof(RecordHeader) + size;
+    if (IsSpillOpen() && !reserved_ && size <= UINT32_MAX &&
+        needed <= capacity_ - (tail_ - head_)) {
+        reservation.position = tail_;
+        reservation.size = needed;
+        reserved_ = true;
+        return PushResult::Reserved;
+    }
+
+    dropped_++;
+    return PushResult::Dropped;
+}
+
+bool SpillQueue::WriteReserved(const Reservation& reservation,
+                               const Frame& frame) const
+{
+    const uint64_t size = frame.data->size();
+    RecordHeader header{kRecordMagic, static_cast<uint32_t>(size), frame.stamp};
+    return WriteRing(reservation.position, &header, sizeof(header)) &&
+           WriteRing(reservation.position + sizeof(header), frame.data->data(),
+                     size);
+}
+
+bool SpillQueue::EndPush(const Reservation& reservation, bool written)
+{
+    reserved_ = false;
+    // DropAll() or Clear() in between reset the ring under the write
+    if (!written || reservation.position != tail_ || !IsSpillOpen()) {
+        dropped_++;
+        return false;
+    }
+    tail_ += reservation.size;
+    disk_frames_++;
+    total_spilled_++;
+    return true;
+}
+
+bool SpillQueue::Pop(Frame& frame)
+{
+    if (!memory_.empty()) {
+        frame = std::move(memory_.front());
+        memory_.pop_front();
+        return true;
+    }
+
+    if (disk_frames_ == 0) {
+        return false;
+    }
+    if (!Restore(frame)) {
+        DropSpilled();
+        return false;
+    }
+    total_restored_++;
+    return true;
+}
+
+void SpillQueue::Requeue(Frame&& frame)
+{
+    if (frame.data) {
+        memory_.push_front(std::move(frame));
+    }
+}
+
+void SpillQueue::DropAll()
+{
+    dropped_ += memory_.size();
+    memory_.clear();
+    DropSpilled();
+}
+
+void SpillQueue::Clear()
+{
+    memory_.clear();
+    head_ = 0;
+    tail_ = 0;
+    disk_frames_ = 0;
+    total_spilled_ = 0;
+    total_restored_ = 0;
+    dropped_ = 0;
+}
+
+bool SpillQueue::Restore(Frame& frame)
+{
+    RecordHeader header;
+    if (!ReadRing(head_, &header, sizeof(header)) || header.magic != kRecordMagic ||
+        sizeof(header) + header.size > tail_ - head_) {
+        return false;
+    }
+
+    auto data = std::make_unique<std::vector<uint8_t>>(header.size);
+    if (!ReadRing(head_ + sizeof(header), data->data(), header.size)) {
+        return false;
+    }
+
+    frame.data = std::move(data);
+    frame.stamp = header.stamp;
+    head_ += sizeof(header) + header.size;
+    if (--disk_frames_ == 0 && !reserved_) {
+        // Drained: start over at the beginning of the file
+        head_ = 0;
+        tail_ = 0;
+    }
+    return true;
+}
+
+void SpillQueue::DropSpilled()
+{
+    dropped_ += disk_frames_;
+    head_ = 0;
+    tail_ = 0;
+    disk_frames_ = 0;
+}
+
+bool SpillQueue::WriteRing(uint64_t position, const void* data,
+                           size_t size) const
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        // A record that runs past the end of the file continues at offset 0
+        const uint64_t offset = position % capacity_;
+        const size_t chunk =
+            static_cast<size_t>(std::min<uint64_t>(size, capacity_ - offset));
+        ssize_t written = ::pwrite(fd_, bytes, chunk, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        position += static_cast<uint64_t>(written);
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool SpillQueue::ReadRing(uint64_t position, void* data, size_t size) const
+{
+    auto* bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        const uint64_t offset = position % capacity_;
+        const size_t chunk =
+            static_cast<size_t>(std::min<uint64_t>(size, capacity_ - offset));
+        ssize_t got = ::pread(fd_, bytes, chunk, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        position += static_cast<uint64_t>(got);
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+}  // namespace Net
+}  // namespace DELILA
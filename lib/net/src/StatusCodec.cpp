@@ -0,0 +1,436 @@
+/**
+ * @file StatusCodec.cpp
+ * @brief Implementation of StatusCodec
+ */
+
+#include "StatusCodec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <nlohmann/json.hpp>
+
+namespace DELILA::Net
+{
+
+static_assert(sizeof(BinaryStatusHeader) == BINARY_STATUS_HEADER_SIZE,
+              "BinaryStatusHeader must be 64 bytes");
+
+namespace
+{
+
+constexpr size_t kMaxLength = 0xFFFF;
+constexpr size_t kChannelRateSize = 2 * sizeof(uint8_t) + sizeof(double);
+
+uint16_t ClampLength(size_t length)
+{
+  return static_cast<uint16_t>(std::min(length, kMaxLength));
+}
+
+template <typename T>
+uint8_t *Put(uint8_t *out, const T &value)
+{
+  std::memcpy(out, &value, sizeof(T));
+  return out + sizeof(T);
+}
+
+uint8_t *PutBytes(uint8_t *out, const std::string &s, uint16_t length)
+{
+  std::memcpy(out, s.data(), length);
+  return out + length;
+}
+
+// Bounds-checked cursor over a received message
+class Reader
+{
+ public:
+  Reader(const uint8_t *data, size_t size) : fPos(data), fEnd(data + size) {}
+
+  template <typename T>
+  bool Get(T &value)
+  {
+    if (Remaining() < sizeof(T)) return false;
+    std::memcpy(&value, fPos, sizeof(T));
+    fPos += sizeof(T);
+    return true;
+  }
+
+  bool GetString(std::string &s, size_t length)
+  {
+    if (Remaining() < length) return false;
+    s.assign(reinterpret_cast<const char *>(fPos), length);
+    fPos += length;
+    return true;
+  }
+
+  bool Skip(size_t length)
+  {
+    if (Remaining() < length) return false;
+    fPos += length;
+    return true;
+  }
+
+  size_t Remaining() const { return static_cast<size_t>(fEnd - fPos); }
+
+ private:
+  const uint8_t *fPos;
+  const uint8_t *fEnd;
+};
+
+uint64_t ToNs(std::chrono::system_clock::time_point t)
+{
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch())
+          .count());
+}
+
+std::chrono::system_clock::time_point FromNs(uint64_t ns)
+{
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::nanoseconds(ns)));
+}
+
+uint8_t *PutLatency(uint8_t *out, const DELILA::LatencySummary &l)
+{
+  out = Put(out, l.count);
+  out = Put(out, l.p50_us);
+  out = Put(out, l.p99_us);
+  out = Put(out, l.p999_us);
+  return Put(out, l.max_us);
+}
+
+bool GetLatency(Reader &block, DELILA::LatencySummary &l)
+{
+  DELILA::LatencySummary value;
+  if (!block.Get(value.count) || !block.Get(value.p50_us) ||
+      !block.Get(value.p99_us) || !block.Get(value.p999_us) ||
+      !block.Get(value.max_us)) {
+    return false;
+  }
+  l = value;
+  return true;
+}
+
+// Reads the fields the block carries, stopping at metrics_size
+void ReadMetrics(Reader block, DELILA::ComponentMetrics &m)
+{
+  if (!block.Get(m.events_processed) || !block.Get(m.bytes_transferred)) return;
+  if (!block.Get(m.queue_size) || !block.Get(m.queue_max)) return;
+  if (!block.Get(m.event_rate) || !block.Get(m.data_rate)) return;
+  if (!block.Get(m.drain_latency_us) || !block.Get(m.sampling_fraction)) return;
+  if (!GetLatency(block, m.residency) || !GetLatency(block, m.processing)) return;
+  if (!GetLatency(block, m.frame_age)) return;
+  if (!block.Get(m.event_rate_avg) || !block.Get(m.data_rate_avg)) return;
+}
+
+nlohmann::json LatencyToJson(const DELILA::LatencySummary &l)
+{
+  return {{"count", l.count},
+          {"p50_us", l.p50_us},
+          {"p99_us", l.p99_us},
+          {"p999_us", l.p999_us},
+          {"max_us", l.max_us}};
+}
+
+void LatencyFromJson(const nlohmann::json &j, const char *key,
+                     DELILA::LatencySummary &l)
+{
+  if (j.contains(key) && j[key].is_object()) {
+    const auto &jl = j[key];
+    l.count = jl.value("count", l.count);
+    l.p50_us = jl.value("p50_us", l.p50_us);
+    l.p99_us = jl.value("p99_us", l.p99_us);
+    l.p999_us = jl.value("p999_us", l.p999_us);
+    l.max_us = jl.value("max_us", l.max_us);
+  }
+}
+
+nlohmann::json ChannelRatesToJson(
+    const std::vector<DELILA::ChannelRate> &rates)
+{
+  auto json = nlohmann::json::array();
+  for (const auto &r : rates) {
+    json.push_back(
+        {{"module", r.module}, {"channel", r.channel}, {"rate", r.event_rate}});
+  }
+  return json;
+}
+
+void ChannelRatesFromJson(const nlohmann::json &j,
+                          std::vector<DELILA::ChannelRate> &rates)
+{
+  if (!j.contains("channel_rates") || !j["channel_rates"].is_array()) {
+    return;
+  }
+  for (const auto &jr : j["channel_rates"]) {
+    if (jr.is_object()) {
+      rates.push_back(DELILA::ChannelRate{jr.value("module", uint8_t{0}),
+                                          jr.value("channel", uint8_t{0}),
+                                          jr.value("rate", 0.0)});
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<uint8_t> StatusCodec::EncodeBinary(const ComponentStatus &status)
+{
+  std::vector<uint8_t> out;
+  EncodeBinary(status, out);
+  return out;
+}
+
+void StatusCodec::EncodeBinary(const ComponentStatus &status,
+                               std::vector<uint8_t> &out)
+{
+  BinaryStatusHeader header{};
+  header.magic_number = BINARY_STATUS_MAGIC_NUMBER;
+  header.format_version = STATUS_FORMAT_VERSION;
+  header.header_size = BINARY_STATUS_HEADER_SIZE;
+  header.run_number = status.run_number;
+  header.heartbeat_counter = status.heartbeat_counter;
+  header.timestamp = ToNs(status.timestamp);
+  header.metrics_size = STATUS_METRICS_SIZE;
+  header.id_length = ClampLength(status.component_id.size());
+  header.state_length = ClampLength(status.state.size());
+  header.error_length = ClampLength(status.error_message.size());
+  header.counter_count = ClampLength(status.metrics.size());
+  header.channel_rate_count =
+      ClampLength(status.component_metrics.channel_rates.size());
+
+  size_t payload = STATUS_METRICS_SIZE + header.id_length +
+                   header.state_length + header.error_length;
+  size_t counters = 0;
+  for (const auto &[key, value] : status.metrics) {
+    if (counters++ == header.counter_count) break;
+    payload += sizeof(uint16_t) + ClampLength(key.size()) + sizeof(double);
+  }
+  payload += header.channel_rate_count * kChannelRateSize;
+  header.payload_size = static_cast<uint32_t>(payload);
+
+  out.resize(BINARY_STATUS_HEADER_SIZE + payload);
+  uint8_t *p = Put(out.data(), header);
+
+  const auto &m = status.component_metrics;
+  p = Put(p, m.events_processed);
+  p = Put(p, m.bytes_transferred);
+  p = Put(p, m.queue_size);
+  p = Put(p, m.queue_max);
+  p = Put(p, m.event_rate);
+  p = Put(p, m.data_rate);
+  p = Put(p, m.drain_latency_us);
+  p = Put(p, m.sampling_fraction);
+  p = PutLatency(p, m.residency);
+  p = PutLatency(p, m.processing);
+  p = PutLatency(p, m.frame_age);
+  p = Put(p, m.event_rate_avg);
+  p = Put(p, m.data_rate_avg);
+
+  p = PutBytes(p, status.component_id, header.id_length);
+  p = PutBytes(p, status.state, header.state_length);
+  p = PutBytes(p, status.error_message, header.error_length);
+
+  counters = 0;
+  for (const auto &[key, value] : status.metrics) {
+    if (counters++ == header.counter_count) break;
+    uint16_t keyLength = ClampLength(key.size());
+    p = Put(p, keyLength);
+    p = PutBytes(p, key, keyLength);
+    p = Put(p, value);
+  }
+
+  for (uint16_t i = 0; i < header.channel_rate_count; ++i) {
+    const auto &rate = m.channel_rates[i];
+    p = Put(p, rate.module);
+    p = Put(p, rate.channel);
+    p = Put(p, rate.event_rate);
+  }
+}
+
+std::unique_ptr<ComponentStatus> StatusCodec::DecodeBinary(
+    const std::vector<uint8_t> &data)
+{
+  return DecodeBinary(data.data(), data.size());
+}
+
+std::unique_ptr<ComponentStatus> StatusCodec::DecodeBinary(const uint8_t *data,
+                                                           size_t size)
+{
+  if (!IsBinaryStatus(data, size)) {
+    return nullptr;
+  }
+
+  BinaryStatusHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.format_version == 0 ||
+      header.format_version > STATUS_FORMAT_VERSION ||
+      header.header_size < BINARY_STATUS_HEADER_SIZE ||
+      header.header_size > size ||
+      header.payload_size > size - header.header_size) {
+    return nullptr;
+  }
+
+  Reader reader(data + header.header_size, header.payload_size);
+  auto status = std::make_unique<ComponentStatus>();
+  status->run_number = header.run_number;
+  status->heartbeat_counter = header.heartbeat_counter;
+  status->timestamp = FromNs(header.timestamp);
+
+  if (reader.Remaining() < header.metrics_size) {
+    return nullptr;
+  }
+  ReadMetrics(Reader(data + header.header_size, header.metrics_size),
+              status->component_metrics);
+  reader.Skip(header.metrics_size);
+
+  if (!reader.GetString(status->component_id, header.id_length) ||
+      !reader.GetString(status->state, header.state_length) ||
+      !reader.GetString(status->error_message, header.error_length)) {
+    return nullptr;
+  }
+
+  std::string key;
+  for (uint16_t i = 0; i < header.counter_count; ++i) {
+    uint16_t keyLength = 0;
+    double value = 0.0;
+    if (!reader.Get(keyLength) || !reader.GetString(key, keyLength) ||
+        !reader.Get(value)) {
+      return nullptr;
+    }
+    // Keys were written in map order
+    status->metrics.emplace_hint(status->metrics.end(), key, value);
+  }
+
+  auto &rates = status->component_metrics.channel_rates;
+  if (reader.Remaining() < header.channel_rate_count * kChannelRateSize) {
+    return nullptr;
+  }
+  rates.resize(header.channel_rate_count);
+  for (auto &rate : rates) {
+    reader.Get(rate.module);
+    reader.Get(rate.channel);
+    reader.Get(rate.event_rate);
+  }
+
+  return status;
+}
+
+bool StatusCodec::IsBinaryStatus(const uint8_t *data, size_t size)
+{
+  if (!data || size < BINARY_STATUS_HEADER_SIZE) {
+    return false;
+  }
+  uint64_t magic;
+  std::memcpy(&magic, data, sizeof(magic));
+  return magic == BINARY_STATUS_MAGIC_NUMBER;
+}
+
+std::string StatusCodec::EncodeJson(const ComponentStatus &status)
+{
+  const auto &m = status.component_metrics;
+  nlohmann::json json = {
+      {"component_id", status.component_id},
+      {"state", status.state},
+      {"error_message", status.error_message},
+      {"heartbeat_counter", status.heartbeat_counter},
+      {"run_number", status.run_number},
+      {"timestamp_ns", ToNs(status.timestamp)},
+      {"component_metrics",
+       {{"events_processed", m.events_processed},
+        {"bytes_transferred", m.bytes_transferred},
+        {"queue_size", m.queue_size},
+        {"queue_max", m.queue_max},
+        {"event_rate", m.event_rate},
+        {"data_rate", m.data_rate},
+        {"drain_latency_us", m.drain_latency_us},
+        {"sampling_fraction", m.sampling_fraction},
+        {"residency", LatencyToJson(m.residency)},
+        {"processing", LatencyToJson(m.processing)},
+        {"frame_age", LatencyToJson(m.frame_age)},
+        {"event_rate_avg", m.event_rate_avg},
+        {"data_rate_avg", m.data_rate_avg},
+        {"channel_rates", ChannelRatesToJson(m.channel_rates)}}}};
+  if (!status.metrics.empty()) {
+    json["metrics"] = status.metrics;
+  }
+  // Error messages may carry raw device strings; never throw on bad UTF-8
+  return json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+std::unique_ptr<ComponentStatus> StatusCodec::DecodeJson(const std::string &json)
+{
+  try {
+    auto j = nlohmann::json::parse(json);
+    if (!j.is_object()) {
+      return nullptr;
+    }
+
+    auto status = std::make_unique<ComponentStatus>();
+    status->component_id = j.value("component_id", "");
+    status->state = j.value("state", "");
+    status->error_message = j.value("error_message", "");
+    status->heartbeat_counter = j.value("heartbeat_counter", uint64_t{0});
+    status->run_number = j.value("run_number", uint32_t{0});
+    status->timestamp = FromNs(j.value("timestamp_ns", uint64_t{0}));
+
+    if (j.contains("component_metrics") && j["component_metrics"].is_object()) {
+      const auto &jm = j["component_metrics"];
+      auto &m = status->component_metrics;
+      m.events_processed = jm.value("events_processed", m.events_processed);
+      m.bytes_transferred = jm.value("bytes_transferred", m.bytes_transferred);
+      m.queue_size = jm.value("queue_size", m.queue_size);
+      m.queue_max = jm.value("queue_max", m.queue_max);
+      m.event_rate = jm.value("event_rate", m.event_rate);
+      m.data_rate = jm.value("data_rate", m.data_rate);
+      m.drain_latency_us = jm.value("drain_latency_us", m.drain_latency_us);
+      m.sampling_fraction = jm.value("sampling_fraction", m.sampling_fraction);
+      LatencyFromJson(jm, "residency", m.residency);
+      LatencyFromJson(jm, "processing", m.processing);
+      LatencyFromJson(jm, "frame_age", m.frame_age);
+      m.event_rate_avg = jm.value("event_rate_avg", m.event_rate_avg);
+      m.data_rate_avg = jm.value("data_rate_avg", m.data_rate_avg);
+      ChannelRatesFromJson(jm, m.channel_rates);
+    }
+
+    if (j.contains("metrics") && j["metrics"].is_object()) {
+      for (const auto &[key, value] : j["metrics"].items()) {
+        if (value.is_number()) {
+          status->metrics[key] = value.get<double>();
+        }
+      }
+    }
+    return status;
+
+  } catch (const nlohmann::json::exception &e) {
+    return nullptr;
+  }
+}
+
+std::unique_ptr<ComponentStatus> StatusCodec::Decode(const uint8_t *data,
+                                                     size_t size)
+{
+  if (IsBinaryStatus(data, size)) {
+    return DecodeBinary(data, size);
+  }
+  if (!data || size == 0) {
+    return nullptr;
+  }
+  return DecodeJson(std::string(reinterpret_cast<const char *>(data), size));
+}
+
+ComponentStatus StatusCodec::FromComponentStatus(
+    const DELILA::ComponentStatus &status)
+{
+  ComponentStatus out;
+  out.component_id = status.component_id;
+  out.state = DELILA::ComponentStateToString(status.state);
+  out.timestamp = std::chrono::system_clock::time_point(
+      std::chrono::milliseconds(status.timestamp));
+  out.run_number = status.run_number;
+  out.component_metrics = status.metrics;
+  out.error_message = status.error_message;
+  out.heartbeat_counter = status.heartbeat_counter;
+  return out;
+}
+
+}  // namespace DELILA::Net
@@ -3,17 +3,42 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <thread>
+
+#include "SharedMemoryRing.hpp"
 
 namespace DELILA::Net
 {
 
-ZMQTransport::ZMQTransport()
+ZMQTransport::ZMQTransport() = default;
+
+ZMQTransport::~ZMQTransport() { Disconnect(); }
+
+std::shared_ptr<zmq::context_t> ZMQTransport::SharedContext()
 {
-  // Initialize ZMQ context following KISS principle
-  fContext = std::make_unique<zmq::context_t>(1);
+  // Held weakly so the context is terminated with its last socket and not
+  // during static destruction, where zmq_ctx_term could block
+  static std::mutex mutex;
+  static std::weak_ptr<zmq::context_t> shared;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto context = shared.lock();
+  if (!context) {
+    context = std::make_shared<zmq::context_t>(1);
+    shared = context;
+  }
+  return context;
 }
 
-ZMQTransport::~ZMQTransport() { Disconnect(); }
+bool ZMQTransport::UsesSharedContext() const
+{
+  auto is_inproc = [](const std::string &address) {
+    return address.rfind("inproc://", 0) == 0;
+  };
+  return fConfig.shared_context || is_inproc(fConfig.data_address) ||
+         is_inproc(fConfig.status_address) ||
+         is_inproc(fConfig.command_address);
+}
 
 bool ZMQTransport::IsConnected() const { return fConnected; }
 
@@ -28,6 +53,10 @@ bool ZMQTransport::Configure(const TransportConfig &config)
     return false;  // Reject completely empty configuration
   }
 
+  if (config.status_format != "binary" && config.status_format != "json") {
+    return false;
+  }
+
   // Validate data pattern only if data channel is configured
   if (has_data) {
     if (config.data_pattern != "PUB" && config.data_pattern != "SUB" &&
@@ -36,6 +65,15 @@ bool ZMQTransport::Configure(const TransportConfig &config)
         config.data_pattern != "PAIR") {
       return false;  // Reject invalid pattern
     }
+
+    // Shared-memory rings implement the two data distribution patterns only
+    if (config.data_address.rfind("shm://", 0) == 0) {
+      if (SharedMemoryRing::ParseAddress(config.data_address).empty() ||
+          (config.data_pattern != "PUB" && config.data_pattern != "SUB" &&
+           config.data_pattern != "PUSH" && config.data_pattern != "PULL")) {
+        return false;
+      }
+    }
   }
 
   // Store valid configuration
@@ -75,6 +113,15 @@ bool ZMQTransport::ConfigureFromJSON(const nlohmann::json &config)
     if (config.contains("bind_command")) {
       transport_config.bind_command = config["bind_command"];
     }
+    if (config.contains("shm_buffer_size")) {
+      transport_config.shm_buffer_size = config["shm_buffer_size"];
+    }
+    if (config.contains("status_format")) {
+      transport_config.status_format = config["status_format"];
+    }
+    if (config.contains("shared_context")) {
+      transport_config.shared_context = config["shared_context"];
+    }
 
     return Configure(transport_config);
 
@@ -121,6 +168,12 @@ bool ZMQTransport::Connect()
   }
 
   try {
+    // inproc:// peers must share a context; everything else gets its own
+    if (!fContext) {
+      fContext = UsesSharedContext() ? SharedContext()
+                                     : std::make_shared<zmq::context_t>(1);
+    }
+
     // Only create data socket if data_address is configured
     if (!fConfig.data_address.empty()) {
       // Determine effective pattern
@@ -132,7 +185,14 @@ bool ZMQTransport::Connect()
       }
 
       // Create sockets based on effective pattern
-      if (effective_pattern == "PUB" || effective_pattern == "PUSH" ||
+      if (!SharedMemoryRing::ParseAddress(fConfig.data_address).empty()) {
+        // Same-host shared-memory ring instead of a data socket
+        fShmPattern = effective_pattern;
+        if (!OpenSharedMemoryRing() && fConfig.bind_data) {
+          fShmRing.reset();
+          return false;
+        }
+      } else if (effective_pattern == "PUB" || effective_pattern == "PUSH" ||
           effective_pattern == "DEALER") {
         // Sending patterns
         int socket_type;
@@ -258,6 +318,9 @@ void ZMQTransport::Disconnect()
 {
   fConnected = false;
 
+  // Leave (and, if bound, unlink) the shared-memory ring
+  fShmRing.reset();
+
   // Clean up sockets following KISS principle
   if (fDataSocket) {
     fDataSocket->close();
@@ -273,28 +336,52 @@ void ZMQTransport::Disconnect()
     fCommandSocket->close();
     fCommandSocket.reset();
   }
+
+  // Sockets are closed, so releasing the context cannot block
+  fContext.reset();
 }
 
 // Core byte-based transport implementation
 bool ZMQTransport::SendBytes(std::unique_ptr<std::vector<uint8_t>> &data)
 {
-  // Must be connected first
-  if (!fConnected || !fDataSocket) {
+  // Check for null or empty data
+  if (!data || data->empty()) {
     return false;
   }
 
-  // Check for null or empty data
-  if (!data || data->empty()) {
+  if (fConnected && fShmRing) {
+    // Connecting side attaches once the binding side has created the ring
+    if (!OpenSharedMemoryRing()) {
+      return false;
+    }
+    // PUSH: a full ring means the consumer is behind, so wait for space
+    // rather than drop, bounded like the receive timeout. PUB never waits;
+    // lagging subscribers lose the oldest frames instead.
+    if (!fShmRing->Write(data->data(), data->size(),
+                         std::chrono::milliseconds(1000))) {
+      return false;
+    }
+    data.reset();
+    return true;
+  }
+
+  // Must be connected first
+  if (!fConnected || !fDataSocket) {
     return false;
   }
 
   try {
-    // Create message and copy data
-    zmq::message_t message(data->size());
-    std::memcpy(message.data(), data->data(), data->size());
-
-    // Clear the original data to indicate ownership transfer
-    data.reset();
+    // Hand the buffer to ZeroMQ instead of copying it: the message frees
+    // the vector once sent (or dropped). Over inproc:// the frame reaches
+    // the receiving socket without any further copy.
+    auto *buffer = data.get();
+    zmq::message_t message(
+        buffer->data(), buffer->size(),
+        [](void *, void *hint) {
+          delete static_cast<std::vector<uint8_t> *>(hint);
+        },
+        buffer);
+    data.release();
 
     auto result = fDataSocket->send(message, zmq::send_flags::dontwait);
     return result.has_value();
@@ -306,6 +393,15 @@ bool ZMQTransport::SendBytes(std::unique_ptr<std::vector<uint8_t>> &data)
 
 std::unique_ptr<std::vector<uint8_t>> ZMQTransport::ReceiveBytes()
 {
+  if (fConnected && fShmRing) {
+    if (!OpenSharedMemoryRing()) {
+      // Ring not created yet - behave like a receive timeout
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      return nullptr;
+    }
+    return fShmRing->Read(std::chrono::milliseconds(1000));
+  }
+
   // Must be connected first
   if (!fConnected || !fDataSocket) {
     return nullptr;
@@ -334,6 +430,69 @@ std::unique_ptr<std::vector<uint8_t>> ZMQTransport::ReceiveBytes()
   }
 }
 
+bool ZMQTransport::WaitForSendReady(std::chrono::milliseconds timeout)
+{
+  if (fConnected && fShmRing) {
+    return OpenSharedMemoryRing();
+  }
+
+  if (!fConnected || !fDataSocket) {
+    return false;
+  }
+
+  try {
+    zmq::pollitem_t item{fDataSocket->handle(), 0, ZMQ_POLLOUT, 0};
+    return zmq::poll(&item, 1, timeout) > 0;
+  } catch (const zmq::error_t &e) {
+    return false;
+  }
+}
+
+size_t ZMQTransport::GetPendingDataBytes() const
+{
+  if (fShmRing && fShmRing->IsOpen()) {
+    return fShmRing->GetUsedBytes();
+  }
+  return 0;
+}
+
+uint64_t ZMQTransport::GetDroppedDataFrames() const
+{
+  if (fShmRing && fShmRing->IsOpen()) {
+    return fShmRing->GetDroppedFrames();
+  }
+  return 0;
+}
+
+bool ZMQTransport::OpenSharedMemoryRing()
+{
+  if (!fShmRing) {
+    fShmRing = std::make_unique<SharedMemoryRing>();
+  }
+
+  // The binding side recreates the ring on reconnect; connecting sides
+  // drop a ring whose owner went away and attach to its replacement
+  if (fShmRing->IsOpen()) {
+    if (!fShmRing->IsClosedByOwner()) {
+      return true;
+    }
+    fShmRing->Close();
+  }
+
+  std::string name = SharedMemoryRing::ParseAddress(fConfig.data_address);
+  auto mode = (fShmPattern == "PUB" || fShmPattern == "SUB")
+                  ? SharedMemoryRing::Mode::Broadcast
+                  : SharedMemoryRing::Mode::Distribute;
+  auto role = (fShmPattern == "PUB" || fShmPattern == "PUSH")
+                  ? SharedMemoryRing::Role::Producer
+                  : SharedMemoryRing::Role::Consumer;
+
+  if (fConfig.bind_data) {
+    return fShmRing->Create(name, mode, fConfig.shm_buffer_size, role);
+  }
+  return fShmRing->Attach(name, role, mode);
+}
+
 bool ZMQTransport::SendStatus(const ComponentStatus &status)
 {
   // Must be connected first
@@ -342,12 +501,14 @@ bool ZMQTransport::SendStatus(const ComponentStatus &status)
   }
 
   try {
-    // Serialize status to JSON
-    std::string json = SerializeStatus(status);
-
-    // Send as ZMQ message
-    zmq::message_t message(json.size());
-    std::memcpy(message.data(), json.c_str(), json.size());
+    zmq::message_t message;
+    if (fConfig.status_format == "json") {
+      std::string json = StatusCodec::EncodeJson(status);
+      message.rebuild(json.data(), json.size());
+    } else {
+      StatusCodec::EncodeBinary(status, fStatusBuffer);
+      message.rebuild(fStatusBuffer.data(), fStatusBuffer.size());
+    }
 
     auto result = fStatusSocket->send(message, zmq::send_flags::dontwait);
     return result.has_value();
@@ -373,90 +534,15 @@ std::unique_ptr<ComponentStatus> ZMQTransport::ReceiveStatus()
       return nullptr;
     }
 
-    // Convert to string and deserialize
-    std::string json(static_cast<const char *>(message.data()), message.size());
-    return DeserializeStatus(json);
+    // Binary or JSON, told apart by the magic number
+    return StatusCodec::Decode(static_cast<const uint8_t *>(message.data()),
+                               message.size());
 
   } catch (const zmq::error_t &e) {
     return nullptr;
   }
 }
 
-// Simple JSON serialization following KISS principle
-std::string ZMQTransport::SerializeStatus(const ComponentStatus &status) const
-{
-  std::ostringstream json;
-  json << "{";
-  json << "\"component_id\":\"" << status.component_id << "\",";
-  json << "\"state\":\"" << status.state << "\",";
-  json << "\"error_message\":\"" << status.error_message << "\",";
-  json << "\"heartbeat_counter\":" << status.heartbeat_counter;
-
-  // Serialize metrics map
-  if (!status.metrics.empty()) {
-    json << ",\"metrics\":{";
-    bool first = true;
-    for (const auto &[key, value] : status.metrics) {
-      if (!first) json << ",";
-      json << "\"" << key << "\":" << value;
-      first = false;
-    }
-    json << "}";
-  }
-  json << "}";
-  return json.str();
-}
-
-std::unique_ptr<ComponentStatus> ZMQTransport::DeserializeStatus(
-    const std::string &json) const
-{
-  // Very simple JSON parsing - follows KISS principle
-  auto status = std::make_unique<ComponentStatus>();
-
-  // Extract component_id
-  size_t pos = json.find("\"component_id\":\"");
-  if (pos != std::string::npos) {
-    pos += 16;  // Length of "component_id":"
-    size_t end = json.find("\"", pos);
-    if (end != std::string::npos) {
-      status->component_id = json.substr(pos, end - pos);
-    }
-  }
-
-  // Extract state
-  pos = json.find("\"state\":\"");
-  if (pos != std::string::npos) {
-    pos += 9;  // Length of "state":"
-    size_t end = json.find("\"", pos);
-    if (end != std::string::npos) {
-      status->state = json.substr(pos, end - pos);
-    }
-  }
-
-  // Extract error_message
-  pos = json.find("\"error_message\":\"");
-  if (pos != std::string::npos) {
-    pos += 17;  // Length of "error_message":"
-    size_t end = json.find("\"", pos);
-    if (end != std::string::npos) {
-      status->error_message = json.substr(pos, end - pos);
-    }
-  }
-
-  // Extract heartbeat_counter
-  pos = json.find("\"heartbeat_counter\":");
-  if (pos != std::string::npos) {
-    pos += 20;  // Length of "heartbeat_counter":
-    size_t end = json.find_first_not_of("0123456789", pos);
-    if (end != std::string::npos) {
-      std::string counter_str = json.substr(pos, end - pos);
-      status->heartbeat_counter = std::stoull(counter_str);
-    }
-  }
-
-  return status;
-}
-
 // Command channel implementation (REQ/REP pattern)
 std::optional<DELILA::CommandResponse> ZMQTransport::SendCommand(
     const DELILA::Command &cmd, std::chrono::milliseconds timeout)
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "CalibrationTable.hpp"
+#include "delila/core/CalibratedEventData.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+using DELILA::CalibrationTable;
+using DELILA::Digitizer::CalibratedEventData;
+using DELILA::Digitizer::MinimalEventData;
+
+// CalibrationStage hot path: hits per second through the table alone, and
+// through a whole frame (decode, calibrate, encode the calibrated frame).
+
+namespace {
+
+constexpr size_t kFrameEvents = 4096;
+constexpr int kModules = 4;
+constexpr int kChannels = 16;
+
+std::vector<MinimalEventData> MakeHits(size_t count)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> energy(0, 16000);
+  std::vector<MinimalEventData> hits;
+  hits.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint16_t e = static_cast<uint16_t>(energy(rng));
+    hits.emplace_back(static_cast<uint8_t>(rng() % kModules),
+                      static_cast<uint8_t>(rng() % kChannels), 10.0 * i, e,
+                      static_cast<uint16_t>(e * 0.8), 0);
+  }
+  return hits;
+}
+
+// Quadratic calibration on every channel; with lut set, every fourth
+// channel uses a lookup table instead
+CalibrationTable MakeTable(bool lut)
+{
+  CalibrationTable table;
+  std::vector<float> values(16384);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = 0.3f * static_cast<float>(i);
+  }
+  for (int m = 0; m < kModules; ++m) {
+    for (int c = 0; c < kChannels; ++c) {
+      auto mod = static_cast<uint8_t>(m);
+      auto ch = static_cast<uint8_t>(c);
+      if (lut && c % 4 == 0) {
+        table.SetLookupTable(mod, ch, values);
+      } else {
+        table.SetPolynomial(mod, ch, {0.5, 0.25 + 0.001 * c, 1e-7});
+      }
+      table.SetTimeOffset(mod, ch, 2.0 * c);
+    }
+  }
+  return table;
+}
+
+}  // namespace
+
+static void BM_Apply(benchmark::State &state)
+{
+  auto hits = MakeHits(kFrameEvents);
+  auto table = MakeTable(state.range(0) != 0);
+  std::vector<CalibratedEventData> out(hits.size());
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(table.Apply(hits.data(), hits.size(), out.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kFrameEvents);
+}
+BENCHMARK(BM_Apply)->Arg(0)->Arg(1);
+
+// Whole frame as the calibrating thread sees it
+static void BM_CalibrateFrame(benchmark::State &state)
+{
+  DELILA::Net::DataProcessor processor;
+  auto hits = MakeHits(kFrameEvents);
+  auto source =
+      std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+  for (const auto &hit : hits) {
+    source->push_back(std::make_unique<MinimalEventData>(hit));
+  }
+  auto input = processor.Process(source, 0);
+  auto table = MakeTable(false);
+  std::vector<MinimalEventData> batch;
+
+  for (auto _ : state) {
+    auto frame = std::make_unique<std::vector<uint8_t>>(*input);
+    uint64_t sequence = 0;
+    processor.DecodeMinimal(*frame, batch, sequence);
+    std::vector<uint8_t> output(DELILA::Net::BINARY_DATA_HEADER_SIZE +
+                                batch.size() * sizeof(CalibratedEventData));
+    table.Apply(batch.data(), batch.size(),
+                reinterpret_cast<CalibratedEventData *>(
+                    output.data() + DELILA::Net::BINARY_DATA_HEADER_SIZE));
+    processor.FinalizeFrame(output,
+                            DELILA::Net::FORMAT_VERSION_CALIBRATED_EVENTDATA,
+                            static_cast<uint32_t>(batch.size()), sequence);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.iterations() * kFrameEvents);
+}
+BENCHMARK(BM_CalibrateFrame);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,202 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "CoincidenceBuilder.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+using DELILA::CoincidenceBuilder;
+using DELILA::HitTimeBuckets;
+using DELILA::Digitizer::MinimalEventData;
+
+// EventBuilder hot path: hits per second through time ordering
+// (HitTimeBuckets) and coincidence building (CoincidenceBuilder) on one
+// core, and building of independent time slices on several cores.
+
+namespace {
+
+constexpr size_t kModules = 8;
+constexpr size_t kBatch = 1024;  // Hits per module per delivery
+
+// Per-module time-ordered streams, ~4 MHz total with correlated clusters:
+// a trigger on module 0 channel 0 followed by hits on other modules
+std::vector<std::vector<MinimalEventData>> MakeStreams(size_t hits)
+{
+  std::mt19937 rng(42);
+  std::exponential_distribution<double> gap(1.0 / 1000.0);
+  std::uniform_int_distribution<int> module(1, kModules - 1);
+  std::uniform_int_distribution<int> channel(0, 15);
+  std::uniform_real_distribution<double> delay(0.0, 150.0);
+
+  std::vector<std::vector<MinimalEventData>> streams(kModules);
+  double t = 0.0;
+  size_t made = 0;
+  while (made < hits) {
+    t += gap(rng);
+    streams[0].emplace_back(0, 0, t, 1000, 100, 0);
+    made++;
+    for (int i = 0; i < 3 && made < hits; ++i, ++made) {
+      auto m = static_cast<uint8_t>(module(rng));
+      streams[m].emplace_back(m, static_cast<uint8_t>(channel(rng)),
+                              t + delay(rng), 1000, 100, 0);
+    }
+  }
+  for (size_t m = 0; m < kModules; ++m) {
+    std::sort(streams[m].begin(), streams[m].end(),
+              [](const MinimalEventData &a, const MinimalEventData &b) {
+                return a.timeStampNs < b.timeStampNs;
+              });
+  }
+  return streams;
+}
+
+std::vector<MinimalEventData> MergeSorted(
+    const std::vector<std::vector<MinimalEventData>> &streams)
+{
+  std::vector<MinimalEventData> all;
+  for (const auto &stream : streams) {
+    all.insert(all.end(), stream.begin(), stream.end());
+  }
+  std::stable_sort(all.begin(), all.end(),
+                   [](const MinimalEventData &a, const MinimalEventData &b) {
+                     return a.timeStampNs < b.timeStampNs;
+                   });
+  return all;
+}
+
+CoincidenceBuilder MakeBuilder()
+{
+  CoincidenceBuilder builder;
+  builder.SetWindow(200.0, 200.0);
+  builder.SetTriggerChannels({{0, 0}});
+  return builder;
+}
+
+}  // namespace
+
+// One core, as the sorting thread plus a single worker: interleaved
+// per-module batches -> buckets -> watermark release -> slice cuts -> build
+static void BM_SortAndBuild(benchmark::State &state)
+{
+  const size_t total = 1 << 20;
+  auto streams = MakeStreams(total);
+  auto builder = MakeBuilder();
+  const double sliceNs = 1e6;
+
+  HitTimeBuckets buckets(16000.0);
+  std::vector<MinimalEventData> slice;
+  std::vector<uint8_t> payload;
+  uint64_t events = 0;
+
+  for (auto _ : state) {
+    buckets.Reset();
+    slice.clear();
+    CoincidenceBuilder::CutScan scan;
+    std::vector<size_t> next(kModules, 0);
+    std::vector<double> newest(kModules, 0.0);
+
+    auto buildSlice = [&](std::vector<MinimalEventData> &hits) {
+      payload.assign(DELILA::Net::BINARY_DATA_HEADER_SIZE, 0);
+      events += builder.Build(hits, payload);
+    };
+
+    bool remaining = true;
+    while (remaining) {
+      remaining = false;
+      for (size_t m = 0; m < kModules; ++m) {
+        size_t end = std::min(next[m] + kBatch, streams[m].size());
+        for (; next[m] < end; ++next[m]) {
+          buckets.Add(streams[m][next[m]]);
+        }
+        if (end > 0) {
+          newest[m] = streams[m][end - 1].timeStampNs;
+        }
+        remaining = remaining || next[m] < streams[m].size();
+      }
+      buckets.Release(*std::min_element(newest.begin(), newest.end()), slice);
+
+      while (!slice.empty()) {
+        size_t cut = builder.FindCut(
+            slice, slice.front().timeStampNs + sliceNs, scan);
+        if (cut == 0) {
+          break;
+        }
+        std::vector<MinimalEventData> head(slice.begin(), slice.begin() + cut);
+        slice.erase(slice.begin(), slice.begin() + cut);
+        buildSlice(head);
+      }
+    }
+    buckets.ReleaseAll(slice);
+    buildSlice(slice);
+  }
+  benchmark::DoNotOptimize(events);
+  state.SetItemsProcessed(state.iterations() * total);
+}
+BENCHMARK(BM_SortAndBuild)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Building alone on sorted hits (the worker cost per hit)
+static void BM_BuildSorted(benchmark::State &state)
+{
+  auto hits = MergeSorted(MakeStreams(1 << 20));
+  auto builder = MakeBuilder();
+  std::vector<uint8_t> payload;
+
+  for (auto _ : state) {
+    payload.assign(DELILA::Net::BINARY_DATA_HEADER_SIZE, 0);
+    benchmark::DoNotOptimize(builder.Build(hits, payload));
+  }
+  state.SetItemsProcessed(state.iterations() * hits.size());
+}
+BENCHMARK(BM_BuildSorted)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Time-slice partitioning: the sorted stream is cut at safe points into
+// ~1 ms slices and each thread builds every N-th slice, as the worker
+// pool does. The time for one pass over all slices should fall with the
+// thread count.
+static void BM_BuildPartitioned(benchmark::State &state)
+{
+  static const std::vector<std::vector<MinimalEventData>> slices = [] {
+    auto hits = MergeSorted(MakeStreams(1 << 21));
+    auto builder = MakeBuilder();
+    std::vector<std::vector<MinimalEventData>> result;
+    CoincidenceBuilder::CutScan scan;
+    while (true) {
+      size_t cut =
+          builder.FindCut(hits, hits.front().timeStampNs + 1e6, scan);
+      if (cut == 0) {
+        break;
+      }
+      result.emplace_back(hits.begin(), hits.begin() + cut);
+      hits.erase(hits.begin(), hits.begin() + cut);
+    }
+    result.push_back(hits);
+    return result;
+  }();
+
+  auto builder = MakeBuilder();
+  std::vector<uint8_t> payload;
+  uint64_t processed = 0;
+
+  for (auto _ : state) {
+    for (size_t i = state.thread_index(); i < slices.size();
+         i += state.threads()) {
+      payload.assign(DELILA::Net::BINARY_DATA_HEADER_SIZE, 0);
+      benchmark::DoNotOptimize(builder.Build(slices[i], payload));
+      processed += slices[i].size();
+    }
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(BM_BuildPartitioned)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
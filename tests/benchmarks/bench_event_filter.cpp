@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "EventFilter.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+using DELILA::EventFilter;
+using DELILA::Digitizer::MinimalEventData;
+
+// FilterStage hot path: events per second through rule evaluation, and
+// through a whole frame (decode, evaluate, re-encode the passing events).
+
+namespace {
+
+constexpr size_t kFrameEvents = 4096;
+
+using EventList = std::vector<std::unique_ptr<MinimalEventData>>;
+
+// Flat low-energy background with a 15% high-energy component and 5%
+// pileup, so the default rules keep roughly one event in eight
+std::unique_ptr<EventList> MakeEvents(size_t count)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> background(0, 800);
+  std::uniform_int_distribution<int> peak(1000, 4000);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  auto events = std::make_unique<EventList>();
+  for (size_t i = 0; i < count; ++i) {
+    uint16_t energy = static_cast<uint16_t>(
+        unit(rng) < 0.15 ? peak(rng) : background(rng));
+    uint64_t flags = unit(rng) < 0.05 ? MinimalEventData::FLAG_PILEUP : 0;
+    events->push_back(std::make_unique<MinimalEventData>(
+        static_cast<uint8_t>(i % 4), static_cast<uint8_t>(i % 16),
+        10.0 * i, energy, static_cast<uint16_t>(energy * 0.8), flags));
+  }
+  return events;
+}
+
+EventFilter MakeFilter(int rules)
+{
+  static const char *kRules[] = {"energy >= 1000", "flags none pileup",
+                                 "psd > 0.1", "channel != 15"};
+  EventFilter filter;
+  for (int r = 0; r < rules; ++r) {
+    filter.AddRule(kRules[r]);
+  }
+  return filter;
+}
+
+}  // namespace
+
+// Column fill plus evaluation of N rules over one frame's batch
+static void BM_Evaluate(benchmark::State &state)
+{
+  auto events = MakeEvents(kFrameEvents);
+  auto filter = MakeFilter(static_cast<int>(state.range(0)));
+  EventFilter::Batch batch;
+  std::vector<uint8_t> pass;
+  std::vector<uint64_t> counts;
+
+  for (auto _ : state) {
+    batch.Clear();
+    for (const auto &event : *events) {
+      batch.Add(*event);
+    }
+    benchmark::DoNotOptimize(filter.Evaluate(batch, pass, counts));
+  }
+  state.SetItemsProcessed(state.iterations() * kFrameEvents);
+}
+BENCHMARK(BM_Evaluate)->DenseRange(1, 4);
+
+// Whole frame as the filtering thread sees it, with the reduction in
+// bytes reported as a counter
+static void BM_FilterFrame(benchmark::State &state)
+{
+  DELILA::Net::DataProcessor processor;
+  auto source = MakeEvents(kFrameEvents);
+  auto input = processor.Process(source, 0);
+  const size_t inputSize = input->size();
+  auto filter = MakeFilter(2);
+  EventFilter::Batch batch;
+  std::vector<uint8_t> pass;
+  std::vector<uint64_t> counts;
+  size_t outputSize = 0;
+
+  for (auto _ : state) {
+    auto frame = std::make_unique<std::vector<uint8_t>>(*input);
+    auto [events, sequence] = processor.DecodeMinimal(frame);
+    batch.Clear();
+    for (const auto &event : *events) {
+      batch.Add(*event);
+    }
+    filter.Evaluate(batch, pass, counts);
+    auto selected = std::make_unique<EventList>();
+    for (size_t i = 0; i < events->size(); ++i) {
+      if (pass[i]) {
+        selected->push_back(std::move((*events)[i]));
+      }
+    }
+    auto output = processor.Process(selected, sequence);
+    outputSize = output->size();
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.iterations() * kFrameEvents);
+  state.counters["reduction"] =
+      static_cast<double>(inputSize) / static_cast<double>(outputSize);
+}
+BENCHMARK(BM_FilterFrame);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "DataProcessor.hpp"
+#include "LatencyHistogram.hpp"
+
+using DELILA::LatencyHistogram;
+using DELILA::LatencyRecorder;
+
+// Cost of the always-on per-frame latency instrumentation. At 1 M frames/s
+// a frame has a 1 us budget, so "overhead_pct_1MHz" (ns per frame / 10) is
+// the share of that budget the instrumentation uses; the target is < 1%
+// (BM_InstrumentFrameAt1MHz). BM_TimedFrame is the cost of a frame that is
+// actually timed, which sampling keeps off most frames.
+
+namespace {
+
+void ReportOverhead(benchmark::State &state,
+                    std::chrono::steady_clock::time_point start)
+{
+  double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start)
+                  .count() /
+              static_cast<double>(state.iterations());
+  state.counters["overhead_pct_1MHz"] = ns / 10.0;
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+// One histogram update, values spread over many buckets
+static void BM_Record(benchmark::State &state)
+{
+  LatencyHistogram histogram;
+  std::mt19937_64 rng(3);
+  std::lognormal_distribution<double> dist(9.0, 1.5);
+  std::vector<uint64_t> values(4096);
+  for (auto &v : values) v = static_cast<uint64_t>(dist(rng));
+
+  size_t i = 0;
+  for (auto _ : state) {
+    histogram.Record(values[i++ & 4095]);
+  }
+  benchmark::DoNotOptimize(histogram.GetMax());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Record);
+
+namespace {
+
+struct StampedFrame {
+  std::vector<uint8_t> bytes = std::vector<uint8_t>(4096);
+
+  StampedFrame()
+  {
+    DELILA::Net::BinaryDataHeader stamp{};
+    stamp.magic_number = DELILA::Net::BINARY_DATA_MAGIC_NUMBER;
+    stamp.timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    std::memcpy(bytes.data(), &stamp, sizeof(stamp));
+  }
+};
+
+// What a component does for a frame chosen for timing: two clock reads,
+// header peek, residency + processing + age updates
+void TimeFrame(LatencyRecorder &recorder, const StampedFrame &frame,
+               uint64_t enqueued)
+{
+  const uint64_t start = LatencyRecorder::Now();
+  recorder.RecordResidency(enqueued, start);
+  DELILA::Net::BinaryDataHeader header;
+  bool stamped = DELILA::Net::DataProcessor::PeekHeader(frame.bytes, header);
+  const uint64_t end = LatencyRecorder::Now();
+  recorder.RecordProcessing(start, end);
+  if (stamped) recorder.RecordAge(header.timestamp, end);
+}
+
+}  // namespace
+
+// Cost of one timed frame (what sampling avoids paying on every frame)
+static void BM_TimedFrame(benchmark::State &state)
+{
+  LatencyRecorder recorder;
+  StampedFrame frame;
+
+  auto begin = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    TimeFrame(recorder, frame, LatencyRecorder::Now());
+  }
+  ReportOverhead(state, begin);
+}
+BENCHMARK(BM_TimedFrame);
+
+// Average per-frame cost at 1 M frames/s. A 1 us-paced warm-up lets the
+// recorder settle on the stride a 1 MHz stream gets; the timed loop then
+// runs unpaced with that stride (decisions from the warmed-up recorder,
+// timing work into a second one so the stride does not move)
+static void BM_InstrumentFrameAt1MHz(benchmark::State &state)
+{
+  LatencyRecorder paced;
+  StampedFrame frame;
+  uint64_t next = LatencyRecorder::Now();
+  for (int i = 0; i < 200000; ++i) {
+    next += 1000;
+    while (LatencyRecorder::Now() < next) {
+    }
+    if (paced.Sample()) {
+      TimeFrame(paced, frame, next);
+    }
+  }
+
+  LatencyRecorder recorder;
+  auto begin = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    if (paced.Sample()) {
+      TimeFrame(recorder, frame, LatencyRecorder::Now());
+    }
+  }
+  ReportOverhead(state, begin);
+  state.counters["stride"] = paced.GetSampleMask() + 1.0;
+}
+BENCHMARK(BM_InstrumentFrameAt1MHz);
+
+// Reader side: one GetStatus() worth of percentiles
+static void BM_Summary(benchmark::State &state)
+{
+  LatencyRecorder recorder;
+  for (uint64_t i = 0; i < 100000; ++i) {
+    recorder.RecordProcessing(0, 1000 + (i * 7919) % 500000);
+  }
+
+  for (auto _ : state) {
+    DELILA::ComponentMetrics metrics;
+    recorder.Fill(metrics);
+    benchmark::DoNotOptimize(metrics.processing.p999_us);
+  }
+}
+BENCHMARK(BM_Summary)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
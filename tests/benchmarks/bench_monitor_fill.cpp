@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "HistogramShard.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+#ifdef HAS_ROOT
+#include <TH1F.h>
+#include <TH1I.h>
+#include <TH2F.h>
+#endif
+
+using DELILA::HistogramShard;
+using DELILA::Digitizer::MinimalEventData;
+
+// Sustained MonitorROOT fill rate: events per second through the
+// integer-bin shard, per thread and with several threads each owning a
+// shard, against the per-event TH1::Fill path it replaces.
+
+namespace {
+
+using EventBatch = std::vector<std::unique_ptr<MinimalEventData>>;
+
+EventBatch MakeBatch(size_t size)
+{
+  std::mt19937 rng(1234);
+  std::normal_distribution<double> energy(4000.0, 1500.0);
+  std::uniform_int_distribution<int> channel(0, 63);
+  std::uniform_int_distribution<int> module(0, 7);
+
+  EventBatch batch;
+  batch.reserve(size);
+  double timestamp = 1000.0;
+  for (size_t i = 0; i < size; ++i) {
+    timestamp += 250.0;
+    double e = std::max(0.0, std::min(65535.0, energy(rng)));
+    batch.push_back(std::make_unique<MinimalEventData>(
+        static_cast<uint8_t>(module(rng)), static_cast<uint8_t>(channel(rng)),
+        timestamp, static_cast<uint16_t>(e), 0, 0));
+  }
+  return batch;
+}
+
+HistogramShard::Layout MakeLayout(bool all)
+{
+  HistogramShard::Layout layout;
+  layout.timing = all;
+  layout.two_d = all;
+  return layout;
+}
+
+}  // namespace
+
+// Fill only; arg 0 = batch size, arg 1 = all histograms enabled
+static void BM_ShardFill(benchmark::State &state)
+{
+  auto batch = MakeBatch(static_cast<size_t>(state.range(0)));
+  HistogramShard shard(MakeLayout(state.range(1) != 0));
+
+  for (auto _ : state) {
+    shard.Fill(batch);
+    if (shard.NeedsFold()) shard.ClearCounts();
+  }
+  benchmark::DoNotOptimize(shard.GetEventCount());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShardFill)
+    ->ArgsProduct({{64, 1024, 8192}, {0, 1}})
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Cost of one update: merge a shard into an accumulator and clear it
+static void BM_ShardFold(benchmark::State &state)
+{
+  auto layout = MakeLayout(state.range(0) != 0);
+  auto batch = MakeBatch(1024);
+  HistogramShard shard(layout);
+  HistogramShard total(layout);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    shard.Fill(batch);
+    state.ResumeTiming();
+    total.Merge(shard);
+    shard.ClearCounts();
+  }
+  benchmark::DoNotOptimize(total.GetEventCount());
+}
+BENCHMARK(BM_ShardFold)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+#ifdef HAS_ROOT
+
+// Previous MonitorROOT path: per-event virtual Fill() under one mutex
+static void BM_RootFillUnderMutex(benchmark::State &state)
+{
+  auto batch = MakeBatch(static_cast<size_t>(state.range(0)));
+  TH1F energy("bench_energy", "", 16384, 0, 16384);
+  TH1I channel("bench_channel", "", 64, 0, 64);
+  TH1I module("bench_module", "", 16, 0, 16);
+  TH2F energyVsChannel("bench_evc", "", 64, 0, 64, 1024, 0, 16384);
+  std::mutex mutex;
+
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &event : batch) {
+      energy.Fill(event->energy);
+      channel.Fill(event->channel);
+      module.Fill(event->module);
+      energyVsChannel.Fill(event->channel, event->energy);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RootFillUnderMutex)->Arg(1024)->Arg(8192)->UseRealTime();
+
+#endif  // HAS_ROOT
+
+BENCHMARK_MAIN();
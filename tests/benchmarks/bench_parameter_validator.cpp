@@ -0,0 +1,181 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ParameterValidator.hpp"
+
+using DELILA::Digitizer::ParameterValidator;
+
+namespace {
+
+using Config = std::vector<std::array<std::string, 2>>;
+
+// Device trees checked in under lib/digitizer/DevTree
+nlohmann::json LoadDevTree(const std::string &name)
+{
+  std::string here = __FILE__;
+  std::string root = here.substr(0, here.rfind("tests/benchmarks"));
+  std::ifstream file(root + "lib/digitizer/DevTree/" + name + ".json");
+  if (!file) {
+    return nlohmann::json();
+  }
+  return nlohmann::json::parse(file, nullptr, false);
+}
+
+bool IsWritable(const nlohmann::json &paramDef)
+{
+  return paramDef.is_object() && paramDef.contains("accessmode") &&
+         paramDef["accessmode"].value("value", "") == "READ_WRITE";
+}
+
+std::string DefaultValue(const nlohmann::json &paramDef)
+{
+  if (paramDef.contains("defaultvalue")) {
+    return paramDef["defaultvalue"].value("value", "0");
+  }
+  return paramDef.value("value", "0");
+}
+
+// Every writable parameter of the board at its default value, one line per
+// channel - the worst case for a configuration without channel ranges
+Config MakeFullBoardConfig(const nlohmann::json &tree)
+{
+  Config config;
+  for (const auto &[name, paramDef] : tree["par"].items()) {
+    if (IsWritable(paramDef)) {
+      config.push_back({"/par/" + name, DefaultValue(paramDef)});
+    }
+  }
+  for (const auto &[channel, channelNode] : tree["ch"].items()) {
+    if (!channelNode.is_object() || !channelNode.contains("par")) continue;
+    for (const auto &[name, paramDef] : channelNode["par"].items()) {
+      if (IsWritable(paramDef)) {
+        config.push_back(
+            {"/ch/" + channel + "/par/" + name, DefaultValue(paramDef)});
+      }
+    }
+  }
+  return config;
+}
+
+// Per-parameter lookup the way the validator resolved paths before it was
+// indexed: walk the JSON and copy the definition node
+nlohmann::json JsonWalkLookup(const nlohmann::json &tree,
+                              const std::string &path)
+{
+  std::string name = path.substr(path.find_last_of('/') + 1);
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+  if (path.find("/ch/") != std::string::npos) {
+    size_t chStart = path.find("/ch/") + 4;
+    std::string channel = path.substr(chStart, path.find('/', chStart) - chStart);
+    if (tree.contains("ch") && tree["ch"].contains(channel) &&
+        tree["ch"][channel].contains("par") &&
+        tree["ch"][channel]["par"].contains(name)) {
+      return tree["ch"][channel]["par"][name];
+    }
+  } else if (tree.contains("par") && tree["par"].contains(name)) {
+    return tree["par"][name];
+  }
+  return nlohmann::json();
+}
+
+}  // namespace
+
+// Cost of compiling the device tree into the index (once per Open)
+static void BM_CompileIndex(benchmark::State &state, const char *devTree)
+{
+  auto tree = LoadDevTree(devTree);
+  if (tree.is_discarded() || tree.empty()) {
+    state.SkipWithError("DevTree JSON not found");
+    return;
+  }
+
+  for (auto _ : state) {
+    ParameterValidator validator(tree);
+    benchmark::DoNotOptimize(validator.GetIndexSize());
+  }
+}
+BENCHMARK_CAPTURE(BM_CompileIndex, PSD1, "PSD1")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CompileIndex, PSD2, "PSD2")->Unit(benchmark::kMicrosecond);
+
+// Validating a full board configuration against the index
+static void BM_ValidateBoardConfig(benchmark::State &state, const char *devTree)
+{
+  auto tree = LoadDevTree(devTree);
+  if (tree.is_discarded() || tree.empty()) {
+    state.SkipWithError("DevTree JSON not found");
+    return;
+  }
+
+  auto config = MakeFullBoardConfig(tree);
+  ParameterValidator validator(tree);
+  validator.SetSilentMode(true);
+
+  for (auto _ : state) {
+    auto summary = validator.ValidateParameters(config);
+    benchmark::DoNotOptimize(summary.validParameters);
+  }
+
+  state.SetItemsProcessed(state.iterations() * config.size());
+  state.counters["params"] = static_cast<double>(config.size());
+}
+BENCHMARK_CAPTURE(BM_ValidateBoardConfig, PSD1, "PSD1")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ValidateBoardConfig, PSD2, "PSD2")->Unit(benchmark::kMicrosecond);
+
+// Baseline: definition lookup by JSON traversal only (no validation)
+static void BM_JsonWalkLookup(benchmark::State &state, const char *devTree)
+{
+  auto tree = LoadDevTree(devTree);
+  if (tree.is_discarded() || tree.empty()) {
+    state.SkipWithError("DevTree JSON not found");
+    return;
+  }
+
+  auto config = MakeFullBoardConfig(tree);
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (const auto &entry : config) {
+      found += JsonWalkLookup(tree, entry[0]).empty() ? 0 : 1;
+    }
+    benchmark::DoNotOptimize(found);
+  }
+
+  state.SetItemsProcessed(state.iterations() * config.size());
+}
+BENCHMARK_CAPTURE(BM_JsonWalkLookup, PSD1, "PSD1")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_JsonWalkLookup, PSD2, "PSD2")->Unit(benchmark::kMicrosecond);
+
+// Indexed lookup alone, for comparison with BM_JsonWalkLookup
+static void BM_IndexedLookup(benchmark::State &state, const char *devTree)
+{
+  auto tree = LoadDevTree(devTree);
+  if (tree.is_discarded() || tree.empty()) {
+    state.SkipWithError("DevTree JSON not found");
+    return;
+  }
+
+  auto config = MakeFullBoardConfig(tree);
+  ParameterValidator validator(tree);
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (const auto &entry : config) {
+      found += validator.FindParameter(entry[0]) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(found);
+  }
+
+  state.SetItemsProcessed(state.iterations() * config.size());
+}
+BENCHMARK_CAPTURE(BM_IndexedLookup, PSD1, "PSD1")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_IndexedLookup, PSD2, "PSD2")->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,370 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DataProcessor.hpp"
+#include "Emulator.hpp"
+#include "FileWriter.hpp"
+#include "SequenceGapDetector.hpp"
+#include "SimpleMerger.hpp"
+#ifdef HAS_ROOT
+#include "MonitorROOT.hpp"
+#endif
+
+using namespace DELILA;
+
+// End-to-end pipeline: N Emulators -> SimpleMerger -> FileWriter (or
+// MonitorROOT), all components in this process, over inproc://, shm://,
+// ipc:// or tcp://. Each run measures a fixed window of steady-state running
+// and reports, as counters:
+//   events_per_s, MB_per_s    delivered to the sink during the window
+//   offered_per_s             what the emulators were asked to generate
+//   lost_events               generated but never delivered (whole run)
+//   lost_frames               sequence gaps in the written file (writer)
+//   age_p50/p99/p999_us       frame age at the sink (writer)
+//   merger_residency_p99_us   wait in the merger queue
+//   cpu_<stage>               CPU of that stage's threads, % of one core
+//
+// Keep results for release-to-release comparison with
+//   bench_pipeline --benchmark_out=pipeline.json --benchmark_out_format=json
+// tests/benchmarks/bench_pipeline.sh runs the same sweep with one process
+// per component.
+
+namespace {
+
+constexpr int kSources = 2;
+constexpr auto kWarmup = std::chrono::milliseconds(500);
+constexpr auto kWindow = std::chrono::seconds(2);
+
+// Channels 0..kSources-1 feed the merger, channel kSources leaves it
+std::string MakeAddress(const std::string &scheme, int run, int channel)
+{
+  std::string tag = std::to_string(getpid()) + "_" + std::to_string(run) +
+                    "_" + std::to_string(channel);
+  int port = 29000 + (run * (kSources + 1) + channel) % 2000;
+  if (scheme == "inproc") return "inproc://delila_pipe_" + tag;
+  if (scheme == "shm") return "shm://delila_pipe_" + tag;
+  if (scheme == "ipc") return "ipc:///tmp/delila_pipe_" + tag;
+  return "tcp://127.0.0.1:" + std::to_string(port);
+}
+
+// === Per-thread CPU from /proc (Linux) ===
+
+std::set<int> ListThreads()
+{
+  std::set<int> tids;
+  std::error_code ec;
+  for (const auto &entry :
+       std::filesystem::directory_iterator("/proc/self/task", ec)) {
+    tids.insert(std::atoi(entry.path().filename().c_str()));
+  }
+  return tids;
+}
+
+// utime + stime in seconds; 0 once the thread has exited
+double ThreadCpuSeconds(int tid)
+{
+  std::ifstream file("/proc/self/task/" + std::to_string(tid) + "/stat");
+  std::string line;
+  if (!std::getline(file, line)) return 0.0;
+
+  // Fields after the ")" closing the thread name: state is field 3,
+  // utime and stime are fields 14 and 15
+  std::istringstream fields(line.substr(line.rfind(')') + 2));
+  std::string field;
+  unsigned long long utime = 0, stime = 0;
+  for (int i = 3; i <= 15 && fields >> field; ++i) {
+    if (i == 14) utime = std::stoull(field);
+    if (i == 15) stime = std::stoull(field);
+  }
+  return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+// Threads are attributed to the stage whose Initialize/Arm/Start created
+// them, by diffing the thread list around each call
+class CpuAccounting
+{
+ public:
+  CpuAccounting() : fKnown(ListThreads()) {}
+
+  bool Track(const std::string &stage, const std::function<bool()> &step)
+  {
+    bool ok = step();
+    for (int tid : ListThreads()) {
+      if (fKnown.insert(tid).second) fThreads[stage].push_back(tid);
+    }
+    return ok;
+  }
+
+  std::map<std::string, double> Snapshot() const
+  {
+    std::map<std::string, double> cpu;
+    for (const auto &[stage, tids] : fThreads) {
+      for (int tid : tids) cpu[stage] += ThreadCpuSeconds(tid);
+    }
+    return cpu;
+  }
+
+ private:
+  std::set<int> fKnown;
+  std::map<std::string, std::vector<int>> fThreads;
+};
+
+// Frames lost between emulators and disk: one detector per module, since
+// each emulator numbers its own frames
+uint64_t CountLostFrames(const std::filesystem::path &dir)
+{
+  std::map<uint8_t, DELILA::Net::SequenceGapDetector> detectors;
+  uint64_t lost = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(dir)) {
+    std::ifstream file(entry.path(), std::ios::binary);
+    std::vector<uint8_t> frame(DELILA::Net::BINARY_DATA_HEADER_SIZE);
+    DELILA::Net::BinaryDataHeader header;
+    while (file.read(reinterpret_cast<char *>(frame.data()),
+                     DELILA::Net::BINARY_DATA_HEADER_SIZE)) {
+      std::memcpy(&header, frame.data(), sizeof(header));
+      frame.resize(header.header_size + header.compressed_size);
+      if (!file.read(reinterpret_cast<char *>(frame.data()) +
+                         DELILA::Net::BINARY_DATA_HEADER_SIZE,
+                     frame.size() - DELILA::Net::BINARY_DATA_HEADER_SIZE)) {
+        break;
+      }
+      // Module of the first event (offset 20 in a serialized EventData)
+      uint8_t module = frame.size() > header.header_size + 20
+                           ? frame[header.header_size + 20]
+                           : 0;
+      auto &detector = detectors[module];
+      if (detector.Check(header.sequence_number) ==
+          DELILA::Net::SequenceGapDetector::Result::Gap) {
+        lost += detector.GetLastGap()->dropped_count;
+      }
+      frame.resize(DELILA::Net::BINARY_DATA_HEADER_SIZE);
+    }
+  }
+  return lost;
+}
+
+// Wait until @p count stops changing (pipeline drained) or the timeout
+void WaitForDrain(const std::function<uint64_t()> &count)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  uint64_t last = count();
+  while (std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t now = count();
+    if (now == last) return;
+    last = now;
+  }
+}
+
+enum class Sink { Writer, Monitor };
+
+// Args: event rate per source, events per frame, waveform samples
+void RunPipeline(benchmark::State &state, const char *scheme, Sink sinkKind)
+{
+  const auto rate = static_cast<uint32_t>(state.range(0));
+  const auto batch = static_cast<size_t>(state.range(1));
+  const auto waveform = static_cast<size_t>(state.range(2));
+
+  static int run = 0;
+  run++;
+  std::vector<std::string> sourceAddresses;
+  for (int i = 0; i < kSources; ++i) {
+    sourceAddresses.push_back(MakeAddress(scheme, run, i));
+  }
+  const std::string mergedAddress = MakeAddress(scheme, run, kSources);
+  const auto outputDir = std::filesystem::temp_directory_path() /
+                         ("delila_bench_pipeline_" + std::to_string(getpid()));
+  std::filesystem::create_directories(outputDir);
+
+  std::vector<std::unique_ptr<Emulator>> emulators;
+  for (int i = 0; i < kSources; ++i) {
+    auto emulator = std::make_unique<Emulator>();
+    emulator->SetComponentId("emulator_" + std::to_string(i));
+    emulator->SetModuleNumber(static_cast<uint8_t>(i));
+    emulator->SetEventRate(rate);
+    emulator->SetBatchSize(batch);
+    emulator->SetDataMode(EmulatorDataMode::Full);
+    emulator->SetWaveformSize(waveform);
+    emulator->SetSeed(i + 1);
+    emulator->SetOutputAddresses({sourceAddresses[i]});
+    emulators.push_back(std::move(emulator));
+  }
+
+  SimpleMerger merger;
+  merger.SetComponentId("merger");
+  merger.SetInputAddresses(sourceAddresses);
+  merger.SetOutputAddresses({mergedAddress});
+
+  // The sink, behind the few calls the harness needs
+  FileWriter writer;
+  std::function<bool()> sinkInit, sinkArm, sinkStart;
+  std::function<void()> sinkStop;
+  std::function<ComponentStatus()> sinkStatus;
+#ifdef HAS_ROOT
+  MonitorROOT monitor;
+#endif
+  if (sinkKind == Sink::Writer) {
+    writer.SetComponentId("writer");
+    writer.SetInputAddresses({mergedAddress});
+    writer.SetOutputPath(outputDir.string());
+    writer.SetFilePrefix("bench_");
+    sinkInit = [&] { return writer.Initialize(""); };
+    sinkArm = [&] { return writer.Arm(); };
+    sinkStart = [&] { return writer.Start(1); };
+    sinkStop = [&] {
+      writer.Stop(true);
+      writer.Shutdown();
+    };
+    sinkStatus = [&] { return writer.GetStatus(); };
+  } else {
+#ifdef HAS_ROOT
+    monitor.SetComponentId("monitor");
+    monitor.SetInputAddresses({mergedAddress});
+    monitor.SetHttpPort(28000 + getpid() % 1000);
+    sinkInit = [&] { return monitor.Initialize(""); };
+    sinkArm = [&] { return monitor.Arm(); };
+    sinkStart = [&] { return monitor.Start(1); };
+    sinkStop = [&] {
+      monitor.Stop(true);
+      monitor.Shutdown();
+    };
+    sinkStatus = [&] { return monitor.GetStatus(); };
+#endif
+  }
+  const std::string sinkName = sinkKind == Sink::Writer ? "writer" : "monitor";
+
+  auto generated = [&] {
+    uint64_t total = 0;
+    for (const auto &emulator : emulators) {
+      total += emulator->GetStatus().metrics.events_processed;
+    }
+    return total;
+  };
+  auto delivered = [&] { return sinkStatus().metrics.events_processed; };
+
+  for (auto _ : state) {
+    // Bind from the sources downstream, then start from the sink upstream
+    CpuAccounting cpu;
+    bool ok = true;
+    for (auto &emulator : emulators) {
+      ok = ok && cpu.Track("emulators", [&] {
+        return emulator->Initialize("") && emulator->Arm();
+      });
+    }
+    ok = ok && cpu.Track("merger", [&] {
+      return merger.Initialize("") && merger.Arm();
+    });
+    ok = ok && cpu.Track(sinkName, [&] { return sinkInit() && sinkArm(); });
+    ok = ok && cpu.Track(sinkName, sinkStart);
+    ok = ok && cpu.Track("merger", [&] { return merger.Start(1); });
+    for (auto &emulator : emulators) {
+      ok = ok && cpu.Track("emulators", [&] { return emulator->Start(1); });
+    }
+    if (!ok) {
+      state.SkipWithError("Failed to bring up the pipeline");
+      break;
+    }
+
+    std::this_thread::sleep_for(kWarmup);
+    const auto cpuBefore = cpu.Snapshot();
+    const uint64_t eventsBefore = delivered();
+    const uint64_t bytesBefore = sinkStatus().metrics.bytes_transferred;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::this_thread::sleep_for(kWindow);
+
+    const auto cpuAfter = cpu.Snapshot();
+    const ComponentStatus sinkAtEnd = sinkStatus();
+    const ComponentStatus mergerAtEnd = merger.GetStatus();
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    state.SetIterationTime(seconds);
+
+    // Stop the sources, let the rest drain, then count what got through
+    for (auto &emulator : emulators) {
+      emulator->Stop(true);
+    }
+    WaitForDrain(delivered);
+    const uint64_t totalGenerated = generated();
+    const uint64_t totalDelivered = delivered();
+    merger.Stop(true);
+    sinkStop();
+    merger.Shutdown();
+    for (auto &emulator : emulators) {
+      emulator->Shutdown();
+    }
+
+    const auto &m = sinkAtEnd.metrics;
+    state.counters["offered_per_s"] = static_cast<double>(rate) * kSources;
+    state.counters["events_per_s"] =
+        (m.events_processed - eventsBefore) / seconds;
+    state.counters["MB_per_s"] =
+        (m.bytes_transferred - bytesBefore) / seconds / 1e6;
+    state.counters["lost_events"] = static_cast<double>(
+        totalGenerated > totalDelivered ? totalGenerated - totalDelivered : 0);
+    if (sinkKind == Sink::Writer) {
+      state.counters["lost_frames"] =
+          static_cast<double>(CountLostFrames(outputDir));
+      state.counters["age_p50_us"] = m.frame_age.p50_us;
+      state.counters["age_p99_us"] = m.frame_age.p99_us;
+      state.counters["age_p999_us"] = m.frame_age.p999_us;
+    }
+    state.counters["merger_residency_p99_us"] =
+        mergerAtEnd.metrics.residency.p99_us;
+    for (const auto &[stage, after] : cpuAfter) {
+      auto before = cpuBefore.find(stage);
+      double used = after - (before != cpuBefore.end() ? before->second : 0.0);
+      state.counters["cpu_" + stage] = 100.0 * used / seconds;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(outputDir, ec);
+}
+
+void PipelineArgs(benchmark::internal::Benchmark *b)
+{
+  b->ArgNames({"rate", "batch", "waveform"})
+      ->ArgsProduct({{10000, 100000}, {1, 100}, {0, 512}})
+      ->Iterations(1)
+      ->UseManualTime()
+      ->Unit(benchmark::kSecond);
+}
+
+}  // namespace
+
+static void BM_PipelineToWriter(benchmark::State &state, const char *scheme)
+{
+  RunPipeline(state, scheme, Sink::Writer);
+}
+BENCHMARK_CAPTURE(BM_PipelineToWriter, inproc, "inproc")->Apply(PipelineArgs);
+BENCHMARK_CAPTURE(BM_PipelineToWriter, shm, "shm")->Apply(PipelineArgs);
+BENCHMARK_CAPTURE(BM_PipelineToWriter, ipc, "ipc")->Apply(PipelineArgs);
+BENCHMARK_CAPTURE(BM_PipelineToWriter, tcp, "tcp")->Apply(PipelineArgs);
+
+#ifdef HAS_ROOT
+static void BM_PipelineToMonitor(benchmark::State &state, const char *scheme)
+{
+  RunPipeline(state, scheme, Sink::Monitor);
+}
+BENCHMARK_CAPTURE(BM_PipelineToMonitor, inproc, "inproc")->Apply(PipelineArgs);
+BENCHMARK_CAPTURE(BM_PipelineToMonitor, shm, "shm")->Apply(PipelineArgs);
+BENCHMARK_CAPTURE(BM_PipelineToMonitor, ipc, "ipc")->Apply(PipelineArgs);
+BENCHMARK_CAPTURE(BM_PipelineToMonitor, tcp, "tcp")->Apply(PipelineArgs);
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,215 @@
+#!/bin/bash
+#
+# bench_pipeline.sh - Multi-process pipeline benchmark
+#
+# Runs 2 x delila_emulator -> delila_merger -> delila_writer (or
+# delila_monitor), one process per component, for every combination of
+# transport, event rate, batch size and waveform length. Prints a JSON
+# array with, per run: sustained throughput at the sink, events lost,
+# sink frame-age quantiles and CPU per process (% of one core).
+# bench_pipeline (the C++ benchmark) runs the same sweep in one process.
+#
+# Usage:
+#   ./bench_pipeline.sh [writer|monitor] > pipeline.json
+#
+# Environment (space-separated sweep values):
+#   TRANSPORTS  default: "ipc tcp"
+#   RATES       events/s per emulator, default: "10000 100000"
+#   BATCHES     events per frame, default: "1 100"
+#   WAVEFORMS   samples per event, default: "0 512"
+#   WINDOW      measurement window in seconds, default: 5
+#   BIN_DIR     directory with the example executables
+#
+# Requires curl (components are read through their --metrics endpoint).
+#
+
+set -e
+
+SINK="${1:-writer}"
+TRANSPORTS="${TRANSPORTS:-ipc tcp}"
+RATES="${RATES:-10000 100000}"
+BATCHES="${BATCHES:-1 100}"
+WAVEFORMS="${WAVEFORMS:-0 512}"
+WINDOW="${WINDOW:-5}"
+
+WORK_DIR="$(mktemp -d /tmp/delila_bench_pipeline.XXXXXX)"
+CLK_TCK="$(getconf CLK_TCK)"
+
+# Metrics ports: emulators, merger, sink
+EMU0_METRICS=9301
+EMU1_METRICS=9302
+MERGER_METRICS=9303
+SINK_METRICS=9304
+HTTP_PORT=9380
+
+# Find executables (in build/examples or current directory)
+if [ -z "$BIN_DIR" ]; then
+    if [ -f "./build/examples/delila_writer" ]; then
+        BIN_DIR="./build/examples"
+    elif [ -f "./delila_writer" ]; then
+        BIN_DIR="."
+    else
+        echo "ERROR: Cannot find DELILA2 executables (set BIN_DIR)." >&2
+        exit 1
+    fi
+fi
+if [ "$SINK" = "monitor" ] && [ ! -f "$BIN_DIR/delila_monitor" ]; then
+    echo "ERROR: delila_monitor not available (ROOT not installed)" >&2
+    exit 1
+fi
+if ! command -v curl > /dev/null; then
+    echo "ERROR: curl is required" >&2
+    exit 1
+fi
+
+PIDS=""
+cleanup() {
+    for pid in $PIDS; do
+        kill -TERM "$pid" 2>/dev/null || true
+    done
+    wait 2>/dev/null || true
+    rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+# metric <port> <name> [label text]: first sample value, 0 if absent
+metric() {
+    curl -s --max-time 2 "http://127.0.0.1:$1/metrics" |
+        awk -v name="$2{" -v label="$3" \
+            'index($1, name) == 1 && index($1, label) { print $2; found = 1; exit }
+             END { if (!found) print 0 }'
+}
+
+# cpu_seconds <pid>: utime + stime of the whole process
+cpu_seconds() {
+    awk -v tck="$CLK_TCK" '{ printf "%.3f", ($14 + $15) / tck }' "/proc/$1/stat"
+}
+
+address() {  # address <transport> <channel> <bind|connect>
+    case "$1" in
+        ipc) echo "ipc://$WORK_DIR/channel$2" ;;
+        shm) echo "shm://delila_bench_$$_$2" ;;
+        *)   if [ "$3" = "bind" ]; then echo "tcp://*:$((5590 + $2))"
+             else echo "tcp://127.0.0.1:$((5590 + $2))"; fi ;;
+    esac
+}
+
+run_one() {  # run_one <transport> <rate> <batch> <waveform>
+    local transport=$1 rate=$2 batch=$3 waveform=$4
+    local data_dir="$WORK_DIR/data"
+    rm -rf "$data_dir"
+    mkdir -p "$data_dir"
+
+    # Downstream first, as in start_pipeline.sh
+    if [ "$SINK" = "writer" ]; then
+        "$BIN_DIR/delila_writer" -i "$(address "$transport" 2 connect)" \
+            -d "$data_dir" -p bench_ --metrics "127.0.0.1:$SINK_METRICS" \
+            > "$WORK_DIR/sink.log" 2>&1 &
+    else
+        "$BIN_DIR/delila_monitor" -i "$(address "$transport" 2 connect)" \
+            -p "$HTTP_PORT" --metrics "127.0.0.1:$SINK_METRICS" \
+            > "$WORK_DIR/sink.log" 2>&1 &
+    fi
+    local sink_pid=$!
+    sleep 1
+    "$BIN_DIR/delila_merger" \
+        -i "$(address "$transport" 0 connect)" \
+        -i "$(address "$transport" 1 connect)" \
+        -o "$(address "$transport" 2 bind)" \
+        --metrics "127.0.0.1:$MERGER_METRICS" > "$WORK_DIR/merger.log" 2>&1 &
+    local merger_pid=$!
+    sleep 1
+    local emu_pids=""
+    for i in 0 1; do
+        local port=$EMU0_METRICS
+        [ "$i" = 1 ] && port=$EMU1_METRICS
+        "$BIN_DIR/delila_emulator" -o "$(address "$transport" "$i" bind)" \
+            -m "$i" -r "$rate" -b "$batch" --full --waveform "$waveform" \
+            --seed $((i + 1)) --metrics "127.0.0.1:$port" \
+            > "$WORK_DIR/emulator$i.log" 2>&1 &
+        emu_pids="$emu_pids $!"
+    done
+    PIDS="$emu_pids $merger_pid $sink_pid"
+
+    # Warm up, then measure a fixed window
+    sleep 1
+    local events0 bytes0 t0 cpu_emu0 cpu_merger0 cpu_sink0
+    events0=$(metric $SINK_METRICS delila_events_processed_total)
+    bytes0=$(metric $SINK_METRICS delila_bytes_transferred_total)
+    cpu_emu0=$(for pid in $emu_pids; do cpu_seconds "$pid"; echo; done |
+               awk '{ s += $1 } END { print s }')
+    cpu_merger0=$(cpu_seconds $merger_pid)
+    cpu_sink0=$(cpu_seconds $sink_pid)
+    t0=$(date +%s.%N)
+
+    sleep "$WINDOW"
+
+    local events1 bytes1 t1 cpu_emu1 cpu_merger1 cpu_sink1 p50 p99 p999
+    events1=$(metric $SINK_METRICS delila_events_processed_total)
+    bytes1=$(metric $SINK_METRICS delila_bytes_transferred_total)
+    cpu_emu1=$(for pid in $emu_pids; do cpu_seconds "$pid"; echo; done |
+               awk '{ s += $1 } END { print s }')
+    cpu_merger1=$(cpu_seconds $merger_pid)
+    cpu_sink1=$(cpu_seconds $sink_pid)
+    t1=$(date +%s.%N)
+    p50=$(metric $SINK_METRICS delila_frame_latency_seconds 'stage="frame_age",quantile="0.5"')
+    p99=$(metric $SINK_METRICS delila_frame_latency_seconds 'stage="frame_age",quantile="0.99"')
+    p999=$(metric $SINK_METRICS delila_frame_latency_seconds 'stage="frame_age",quantile="0.999"')
+
+    # Stop the emulators; they print their totals on exit
+    kill -TERM $emu_pids
+    wait $emu_pids 2>/dev/null || true
+    local generated
+    generated=$(cat "$WORK_DIR"/emulator*.log |
+                awk '/^Total events:/ { s += $3 } END { print s + 0 }')
+
+    # Let the merger and sink drain, then count what got through
+    local delivered last=-1
+    for _ in $(seq 25); do
+        delivered=$(metric $SINK_METRICS delila_events_processed_total)
+        [ "$delivered" = "$last" ] && break
+        last=$delivered
+        sleep 0.2
+    done
+    kill -TERM $merger_pid $sink_pid
+    wait $merger_pid $sink_pid 2>/dev/null || true
+    PIDS=""
+
+    awk -v transport="$transport" -v sink="$SINK" -v rate="$rate" \
+        -v batch="$batch" -v waveform="$waveform" \
+        -v e0="$events0" -v e1="$events1" -v b0="$bytes0" -v b1="$bytes1" \
+        -v t0="$t0" -v t1="$t1" -v gen="$generated" -v del="$delivered" \
+        -v p50="$p50" -v p99="$p99" -v p999="$p999" \
+        -v ce0="$cpu_emu0" -v ce1="$cpu_emu1" \
+        -v cm0="$cpu_merger0" -v cm1="$cpu_merger1" \
+        -v cs0="$cpu_sink0" -v cs1="$cpu_sink1" 'BEGIN {
+        dt = t1 - t0
+        lost = gen > del ? gen - del : 0
+        printf "{\"transport\":\"%s\",\"sink\":\"%s\",\"rate\":%d,", transport, sink, rate
+        printf "\"batch\":%d,\"waveform\":%d,\"seconds\":%.3f,", batch, waveform, dt
+        printf "\"offered_per_s\":%d,\"events_per_s\":%.1f,", 2 * rate, (e1 - e0) / dt
+        printf "\"MB_per_s\":%.3f,\"generated\":%d,", (b1 - b0) / dt / 1e6, gen
+        printf "\"delivered\":%d,\"lost_events\":%d,", del, lost
+        printf "\"age_p50_us\":%.1f,\"age_p99_us\":%.1f,", p50 * 1e6, p99 * 1e6
+        printf "\"age_p999_us\":%.1f,\"cpu_emulators\":%.1f,", p999 * 1e6, 100 * (ce1 - ce0) / dt
+        printf "\"cpu_merger\":%.1f,\"cpu_%s\":%.1f}", 100 * (cm1 - cm0) / dt, sink, 100 * (cs1 - cs0) / dt
+    }'
+}
+
+echo "["
+first=1
+for transport in $TRANSPORTS; do
+    for rate in $RATES; do
+        for batch in $BATCHES; do
+            for waveform in $WAVEFORMS; do
+                echo "  $transport rate=$rate batch=$batch waveform=$waveform" >&2
+                [ $first = 1 ] || echo ","
+                first=0
+                printf "  "
+                run_one "$transport" "$rate" "$batch" "$waveform"
+            done
+        done
+    done
+done
+echo ""
+echo "]"
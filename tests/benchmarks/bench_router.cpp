@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "RouteTable.hpp"
+#include "delila/core/EventData.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+using DELILA::RouteTable;
+using DELILA::Digitizer::EventData;
+using DELILA::Digitizer::MinimalEventData;
+using DELILA::Net::DataProcessor;
+using DELILA::Net::EventRecordRef;
+
+// Router hot path: split one frame across four outputs by module, either
+// by locating and copying records (what Router does) or by decoding and
+// re-encoding the events. Arg: 0 = minimal frame, N = full frame with
+// N-sample waveforms.
+
+namespace {
+
+constexpr size_t kOutputs = 4;
+constexpr int kModules = 8;
+
+size_t FrameEvents(size_t samples) { return samples == 0 ? 4096 : 256; }
+
+std::unique_ptr<std::vector<uint8_t>> MakeFrame(DataProcessor &processor,
+                                                size_t samples)
+{
+  std::mt19937 rng(42);
+  const size_t count = FrameEvents(samples);
+  if (samples == 0) {
+    auto events =
+        std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    for (size_t i = 0; i < count; ++i) {
+      events->push_back(std::make_unique<MinimalEventData>(
+          static_cast<uint8_t>(rng() % kModules),
+          static_cast<uint8_t>(rng() % 16), 10.0 * i, 1000, 800, 0));
+    }
+    return processor.Process(events, 0);
+  }
+  auto events = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+  for (size_t i = 0; i < count; ++i) {
+    auto event = std::make_unique<EventData>(samples);
+    event->module = static_cast<uint8_t>(rng() % kModules);
+    event->channel = static_cast<uint8_t>(rng() % 16);
+    event->timeStampNs = 10.0 * i;
+    event->analogProbe1.assign(samples, 1000);
+    event->digitalProbe1.assign(samples, 0);
+    events->push_back(std::move(event));
+  }
+  return processor.Process(events, 0);
+}
+
+RouteTable MakeRoutes()
+{
+  RouteTable routes;
+  routes.SetOutputs(kOutputs);
+  return routes;
+}
+
+}  // namespace
+
+static void BM_SplitRecords(benchmark::State &state)
+{
+  DataProcessor processor;
+  const size_t samples = static_cast<size_t>(state.range(0));
+  auto input = MakeFrame(processor, samples);
+  auto routes = MakeRoutes();
+  std::vector<EventRecordRef> records;
+  DELILA::Net::BinaryDataHeader header;
+  DataProcessor::PeekHeader(*input, header);
+
+  std::vector<uint8_t> routed;
+  for (auto _ : state) {
+    // Route and size the outputs first, then copy, as Router does
+    DataProcessor::ScanRecords(*input, records);
+    routed.resize(records.size());
+    std::vector<size_t> bytes(kOutputs, 0);
+    std::vector<uint32_t> counts(kOutputs, 0);
+    for (size_t i = 0; i < records.size(); ++i) {
+      routed[i] = static_cast<uint8_t>(routes.Route(
+          records[i].module, records[i].channel, records[i].timeStampNs));
+      bytes[routed[i]] += records[i].size;
+      counts[routed[i]]++;
+    }
+    std::vector<std::vector<uint8_t>> outputs(kOutputs);
+    for (size_t o = 0; o < kOutputs; ++o) {
+      outputs[o].reserve(DELILA::Net::BINARY_DATA_HEADER_SIZE + bytes[o]);
+      outputs[o].resize(DELILA::Net::BINARY_DATA_HEADER_SIZE);
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+      auto &output = outputs[routed[i]];
+      output.insert(output.end(), input->data() + records[i].offset,
+                    input->data() + records[i].offset + records[i].size);
+    }
+    for (size_t o = 0; o < kOutputs; ++o) {
+      processor.FinalizeFrame(outputs[o], header.format_version, counts[o], 0);
+    }
+    benchmark::DoNotOptimize(outputs);
+  }
+  state.SetItemsProcessed(state.iterations() * FrameEvents(samples));
+  state.SetBytesProcessed(state.iterations() * input->size());
+}
+BENCHMARK(BM_SplitRecords)->Arg(0)->Arg(1000);
+
+// The same split through Decode / Process
+static void BM_SplitDecoded(benchmark::State &state)
+{
+  DataProcessor processor;
+  const size_t samples = static_cast<size_t>(state.range(0));
+  auto input = MakeFrame(processor, samples);
+  auto routes = MakeRoutes();
+
+  auto split = [&](auto events) {
+    using List = typename std::remove_reference_t<decltype(*events)>;
+    std::vector<std::unique_ptr<List>> outputs(kOutputs);
+    for (auto &output : outputs) {
+      output = std::make_unique<List>();
+    }
+    for (auto &event : *events) {
+      size_t o = routes.Route(event->module, event->channel,
+                              event->timeStampNs);
+      outputs[o]->push_back(std::move(event));
+    }
+    for (auto &output : outputs) {
+      benchmark::DoNotOptimize(processor.Process(output, 0));
+    }
+  };
+
+  for (auto _ : state) {
+    if (samples == 0) {
+      split(processor.DecodeMinimal(input).first);
+    } else {
+      split(processor.Decode(input).first);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * FrameEvents(samples));
+  state.SetBytesProcessed(state.iterations() * input->size());
+}
+BENCHMARK(BM_SplitDecoded)->Arg(0)->Arg(1000);
+
+BENCHMARK_MAIN();
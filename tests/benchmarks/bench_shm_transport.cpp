@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ZMQTransport.hpp"
+
+using DELILA::Net::TransportConfig;
+using DELILA::Net::ZMQTransport;
+
+// Compares the shm:// data channel with ZeroMQ tcp:// and ipc:// on the
+// same host, through the ZMQTransport byte interface the components use.
+
+namespace {
+
+std::string MakeAddress(const std::string &scheme, int channel)
+{
+  static int run = 0;
+  std::string tag = std::to_string(getpid()) + "_" + std::to_string(run++) +
+                    "_" + std::to_string(channel);
+  if (scheme == "shm") return "shm://delila_bench_" + tag;
+  if (scheme == "ipc") return "ipc:///tmp/delila_bench_" + tag;
+  return "tcp://127.0.0.1:" + std::to_string(27000 + (run * 2 + channel) % 2000);
+}
+
+TransportConfig MakeConfig(const std::string &address, const std::string &pattern,
+                           bool bind)
+{
+  TransportConfig config;
+  config.data_address = address;
+  config.status_address = "";
+  config.command_address = "";
+  config.data_pattern = pattern;
+  config.bind_data = bind;
+  config.is_publisher = (pattern == "PUSH");
+  return config;
+}
+
+bool OpenPair(ZMQTransport &sender, ZMQTransport &receiver, const std::string &address)
+{
+  return sender.Configure(MakeConfig(address, "PUSH", true)) && sender.Connect() &&
+         receiver.Configure(MakeConfig(address, "PULL", false)) && receiver.Connect();
+}
+
+// Send one frame, retrying while the channel is at its high-water mark
+void SendFrame(ZMQTransport &transport, const std::vector<uint8_t> &frame)
+{
+  while (true) {
+    auto data = std::make_unique<std::vector<uint8_t>>(frame);
+    if (transport.SendBytes(data)) return;
+  }
+}
+
+}  // namespace
+
+// Streaming throughput: one sender, one receiver thread draining
+static void BM_Throughput(benchmark::State &state, const char *scheme)
+{
+  ZMQTransport sender, receiver;
+  if (!OpenPair(sender, receiver, MakeAddress(scheme, 0))) {
+    state.SkipWithError("Failed to open channel");
+    return;
+  }
+
+  std::vector<uint8_t> frame(static_cast<size_t>(state.range(0)), 0x5A);
+  std::atomic<int64_t> received{0};
+  std::atomic<bool> running{true};
+  std::thread drain([&]() {
+    while (running.load()) {
+      if (receiver.ReceiveBytes()) received.fetch_add(1);
+    }
+  });
+
+  // Let connecting sockets / lazy ring attach settle
+  SendFrame(sender, frame);
+  while (received.load() == 0) std::this_thread::yield();
+
+  int64_t sent = 1;
+  for (auto _ : state) {
+    SendFrame(sender, frame);
+    sent++;
+  }
+  while (received.load() < sent) std::this_thread::yield();
+
+  running = false;
+  drain.join();
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_Throughput, shm, "shm")->RangeMultiplier(16)->Range(64, 1 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Throughput, ipc, "ipc")->RangeMultiplier(16)->Range(64, 1 << 20)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Throughput, tcp, "tcp")->RangeMultiplier(16)->Range(64, 1 << 20)->UseRealTime();
+
+// Round-trip latency: ping over one channel, echo back over another
+static void BM_RoundTrip(benchmark::State &state, const char *scheme)
+{
+  ZMQTransport ping_tx, ping_rx, pong_tx, pong_rx;
+  if (!OpenPair(ping_tx, ping_rx, MakeAddress(scheme, 0)) ||
+      !OpenPair(pong_tx, pong_rx, MakeAddress(scheme, 1))) {
+    state.SkipWithError("Failed to open channels");
+    return;
+  }
+
+  std::atomic<bool> running{true};
+  std::thread echo([&]() {
+    while (running.load()) {
+      auto data = ping_rx.ReceiveBytes();
+      if (data) pong_tx.SendBytes(data);
+    }
+  });
+
+  std::vector<uint8_t> frame(static_cast<size_t>(state.range(0)), 0xA5);
+
+  // Warm up both directions
+  SendFrame(ping_tx, frame);
+  while (!pong_rx.ReceiveBytes()) {
+  }
+
+  for (auto _ : state) {
+    SendFrame(ping_tx, frame);
+    auto reply = pong_rx.ReceiveBytes();
+    if (!reply) {
+      state.SkipWithError("Echo timed out");
+      break;
+    }
+  }
+
+  running = false;
+  echo.join();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_RoundTrip, shm, "shm")->Arg(64)->Arg(64 << 10)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_RoundTrip, ipc, "ipc")->Arg(64)->Arg(64 << 10)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_RoundTrip, tcp, "tcp")->Arg(64)->Arg(64 << 10)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
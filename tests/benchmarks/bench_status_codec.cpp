@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "StatusCodec.hpp"
+
+using DELILA::Net::ComponentStatus;
+using DELILA::Net::StatusCodec;
+
+// Cost of one status/heartbeat message in the binary and JSON formats.
+// Every component encodes one per report interval and the operator decodes
+// one per component, so besides the per-message time each benchmark reports
+// "cpu_pct_100Hz": percent of one core spent on status at 100 reports/s
+// (per component when encoding, per monitored component when decoding).
+
+namespace {
+
+// arg = number of extra key/value counters
+ComponentStatus MakeStatus(int counters)
+{
+  ComponentStatus status;
+  status.component_id = "digitizer_01";
+  status.state = "Running";
+  status.timestamp = std::chrono::system_clock::now();
+  status.run_number = 42;
+  status.heartbeat_counter = 1000;
+  status.component_metrics.events_processed = 123456789;
+  status.component_metrics.bytes_transferred = 9876543210;
+  status.component_metrics.queue_size = 12;
+  status.component_metrics.queue_max = 1000;
+  status.component_metrics.event_rate = 1.25e6;
+  status.component_metrics.data_rate = 27.5;
+  status.component_metrics.drain_latency_us = 85.0;
+  for (int i = 0; i < counters; ++i) {
+    status.metrics["board" + std::to_string(i / 8) + "_ch" +
+                   std::to_string(i % 8) + "_rate_hz"] = 1000.0 + i;
+  }
+  return status;
+}
+
+void ReportCost(benchmark::State &state,
+                std::chrono::steady_clock::time_point start, size_t bytes)
+{
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  double perMessage = seconds / static_cast<double>(state.iterations());
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.counters["cpu_pct_100Hz"] = perMessage * 100.0 * 100.0;
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+static void BM_EncodeBinary(benchmark::State &state)
+{
+  auto status = MakeStatus(static_cast<int>(state.range(0)));
+  std::vector<uint8_t> buffer;
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    status.heartbeat_counter++;
+    StatusCodec::EncodeBinary(status, buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  ReportCost(state, start, buffer.size());
+}
+BENCHMARK(BM_EncodeBinary)->Arg(0)->Arg(8)->Arg(64);
+
+static void BM_DecodeBinary(benchmark::State &state)
+{
+  auto buffer = StatusCodec::EncodeBinary(MakeStatus(static_cast<int>(state.range(0))));
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    auto status = StatusCodec::DecodeBinary(buffer);
+    benchmark::DoNotOptimize(status.get());
+  }
+  ReportCost(state, start, buffer.size());
+}
+BENCHMARK(BM_DecodeBinary)->Arg(0)->Arg(8)->Arg(64);
+
+static void BM_EncodeJson(benchmark::State &state)
+{
+  auto status = MakeStatus(static_cast<int>(state.range(0)));
+  std::string json;
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    status.heartbeat_counter++;
+    json = StatusCodec::EncodeJson(status);
+    benchmark::DoNotOptimize(json.data());
+  }
+  ReportCost(state, start, json.size());
+}
+BENCHMARK(BM_EncodeJson)->Arg(0)->Arg(8)->Arg(64);
+
+static void BM_DecodeJson(benchmark::State &state)
+{
+  auto json = StatusCodec::EncodeJson(MakeStatus(static_cast<int>(state.range(0))));
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    auto status = StatusCodec::DecodeJson(json);
+    benchmark::DoNotOptimize(status.get());
+  }
+  ReportCost(state, start, json.size());
+}
+BENCHMARK(BM_DecodeJson)->Arg(0)->Arg(8)->Arg(64);
+
+BENCHMARK_MAIN();
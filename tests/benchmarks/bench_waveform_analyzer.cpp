@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "PulseAnalyzer.hpp"
+#include "delila/core/EventData.hpp"
+
+using DELILA::PulseAnalyzer;
+using DELILA::Digitizer::EventData;
+
+// WaveformAnalyzer hot path on 500-2000 sample waveforms: one waveform
+// through PulseAnalyzer, and a whole frame as one worker sees it (decode,
+// analyze, encode). Workers analyze frames in parallel, so the stage rate
+// is about this times the worker count.
+
+namespace {
+
+constexpr size_t kFrameEvents = 256;
+
+// Negative pulses with random start and amplitude on a noisy baseline
+std::unique_ptr<std::vector<std::unique_ptr<EventData>>> MakeEvents(
+    size_t count, size_t samples)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> start(60.0, 68.0);
+  std::uniform_real_distribution<double> amplitude(200.0, 8000.0);
+  std::normal_distribution<double> noise(0.0, 3.0);
+
+  auto events = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+  for (size_t n = 0; n < count; ++n) {
+    auto event = std::make_unique<EventData>(samples);
+    double t0 = start(rng);
+    double a = amplitude(rng);
+    for (size_t i = 0; i < samples; ++i) {
+      double t = static_cast<double>(i) - t0;
+      double pulse = t <= 0.0 ? 0.0
+                     : t < 6.0 ? a * t / 6.0
+                               : a * std::exp(-(t - 6.0) / 40.0);
+      event->analogProbe1[i] =
+          static_cast<int32_t>(std::lround(8000.0 - pulse + noise(rng)));
+    }
+    event->timeStampNs = 1000.0 * n;
+    events->push_back(std::move(event));
+  }
+  return events;
+}
+
+PulseAnalyzer MakeAnalyzer(size_t samples)
+{
+  PulseAnalyzer::Settings settings;
+  settings.longGate = static_cast<uint32_t>(samples / 2);  // Gate grows too
+  PulseAnalyzer analyzer;
+  analyzer.SetSettings(settings);
+  return analyzer;
+}
+
+}  // namespace
+
+static void BM_AnalyzeWaveform(benchmark::State &state)
+{
+  const size_t samples = static_cast<size_t>(state.range(0));
+  auto events = MakeEvents(64, samples);
+  auto analyzer = MakeAnalyzer(samples);
+  size_t i = 0;
+
+  for (auto _ : state) {
+    const auto &waveform = (*events)[i++ % events->size()]->analogProbe1;
+    benchmark::DoNotOptimize(analyzer.Analyze(waveform.data(), samples));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * samples * sizeof(int32_t));
+}
+BENCHMARK(BM_AnalyzeWaveform)->Arg(500)->Arg(1000)->Arg(2000);
+
+static void BM_AnalyzeFrame(benchmark::State &state)
+{
+  const size_t samples = static_cast<size_t>(state.range(0));
+  DELILA::Net::DataProcessor processor;
+  auto source = MakeEvents(kFrameEvents, samples);
+  auto input = processor.Process(source, 0);
+  auto analyzer = MakeAnalyzer(samples);
+
+  for (auto _ : state) {
+    auto frame = std::make_unique<std::vector<uint8_t>>(*input);
+    auto [events, sequence] = processor.Decode(frame);
+    for (auto &event : *events) {
+      analyzer.Apply(*event);
+    }
+    auto output = processor.Process(events, sequence);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.iterations() * kFrameEvents);
+  state.SetBytesProcessed(state.iterations() * input->size());
+}
+BENCHMARK(BM_AnalyzeFrame)->Arg(500)->Arg(1000)->Arg(2000);
+
+BENCHMARK_MAIN();
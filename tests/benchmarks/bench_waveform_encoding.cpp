@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "delila/core/EventData.hpp"
+
+using DELILA::Digitizer::EventData;
+using DELILA::Net::DataProcessor;
+
+// Waveform frames on the wire: format version 1 (int32_t analog, one byte
+// per digital sample) against version 5 (int16_t analog, bit planes).
+// Arguments are samples per waveform and the format (0 = v1, 1 = v5).
+// MB/s counts the events' samples as held in memory, so both formats are
+// measured against the same amount of data; bytes_per_event is the wire
+// size.
+
+namespace {
+
+constexpr size_t kFrameEvents = 64;
+
+using Events = std::unique_ptr<std::vector<std::unique_ptr<EventData>>>;
+
+// 14-bit ADC traces with sparse digital gates, as a digitizer sends them
+Events MakeEvents(size_t samples)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int32_t> adc(0, 16383);
+  auto events = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+  for (size_t i = 0; i < kFrameEvents; ++i) {
+    auto event = std::make_unique<EventData>(samples);
+    event->timeStampNs = 1000.0 * i;
+    event->module = 0;
+    event->channel = static_cast<uint8_t>(i % 16);
+    event->energy = static_cast<uint16_t>(adc(rng));
+    for (size_t s = 0; s < samples; ++s) {
+      event->analogProbe1[s] = adc(rng);
+      event->analogProbe2[s] = adc(rng) - 8192;
+      event->digitalProbe1[s] = s > samples / 4 && s < samples / 2;
+      event->digitalProbe2[s] = (rng() % 8) == 0;
+      event->digitalProbe3[s] = s > samples / 3;
+      event->digitalProbe4[s] = 0;
+    }
+    events->push_back(std::move(event));
+  }
+  return events;
+}
+
+// Sample bytes of one frame in EventData
+int64_t SampleBytes(size_t samples)
+{
+  return static_cast<int64_t>(kFrameEvents * samples *
+                              (2 * sizeof(int32_t) + 4 * sizeof(uint8_t)));
+}
+
+}  // namespace
+
+static void BM_Encode(benchmark::State &state)
+{
+  const auto samples = static_cast<size_t>(state.range(0));
+  DataProcessor processor;
+  processor.EnableCompactWaveforms(state.range(1) != 0);
+  auto events = MakeEvents(samples);
+
+  size_t frameSize = 0;
+  for (auto _ : state) {
+    auto frame = processor.Process(events, 0);
+    frameSize = frame->size();
+    benchmark::DoNotOptimize(frame);
+  }
+  state.SetBytesProcessed(state.iterations() * SampleBytes(samples));
+  state.counters["bytes_per_event"] =
+      static_cast<double>(frameSize) / kFrameEvents;
+}
+BENCHMARK(BM_Encode)->ArgsProduct({{256, 1024, 4096}, {0, 1}});
+
+static void BM_Decode(benchmark::State &state)
+{
+  const auto samples = static_cast<size_t>(state.range(0));
+  DataProcessor processor;
+  processor.EnableCompactWaveforms(state.range(1) != 0);
+  auto input = processor.Process(MakeEvents(samples), 0);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto frame = std::make_unique<std::vector<uint8_t>>(*input);
+    state.ResumeTiming();
+    auto [events, sequence] = processor.Decode(frame);
+    benchmark::DoNotOptimize(events);
+  }
+  state.SetBytesProcessed(state.iterations() * SampleBytes(samples));
+  state.counters["bytes_per_event"] =
+      static_cast<double>(input->size()) / kFrameEvents;
+}
+BENCHMARK(BM_Decode)->ArgsProduct({{256, 1024, 4096}, {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,188 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "RunManifest.hpp"
+#include "RunReader.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+using DELILA::RunManifest;
+using DELILA::RunReader;
+using DELILA::Digitizer::MinimalEventData;
+using DELILA::Net::DataProcessor;
+using DELILA::Net::EventRecordRef;
+
+// FileWriter farm: the cost of indexing frames for the run manifest, the
+// aggregate write rate of N writers each holding every N-th block of a run
+// (one thread and file per writer, as with one FileWriter per disk), and
+// reading the run back in order with RunReader.
+
+namespace {
+
+constexpr size_t kFrameEvents = 4096;  // ~90 kB minimal frames
+constexpr uint64_t kBlock = 64;
+constexpr uint64_t kRunFrames = 1024;
+
+std::unique_ptr<std::vector<uint8_t>> MakeFrame(DataProcessor &processor,
+                                                uint64_t sequence)
+{
+  auto events =
+      std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+  for (size_t i = 0; i < kFrameEvents; ++i) {
+    events->push_back(std::make_unique<MinimalEventData>(
+        0, static_cast<uint8_t>(i % 16),
+        10.0 * (sequence * kFrameEvents + i), 1000, 800, 0));
+  }
+  return processor.Process(events, sequence);
+}
+
+std::filesystem::path BenchDir()
+{
+  auto dir = std::filesystem::temp_directory_path() / "delila_bench_farm";
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+// What FileWriter does per frame with a manifest enabled
+void IndexFrame(RunManifest &manifest, std::vector<EventRecordRef> &records,
+                const std::vector<uint8_t> &frame, uint64_t sequence,
+                uint64_t offset)
+{
+  double firstNs = 0.0;
+  double lastNs = 0.0;
+  if (DataProcessor::ScanRecords(frame, records) && !records.empty()) {
+    firstNs = lastNs = records[0].timeStampNs;
+    for (const auto &record : records) {
+      firstNs = std::min(firstNs, record.timeStampNs);
+      lastNs = std::max(lastNs, record.timeStampNs);
+    }
+  }
+  manifest.AddFrame(0, sequence, offset, frame.size(),
+                    static_cast<uint32_t>(records.size()), firstNs, lastNs);
+}
+
+// Writer w of n writes frames of blocks b with b % n == w; returns its
+// manifest
+RunManifest WriteShare(const std::vector<std::unique_ptr<std::vector<uint8_t>>>
+                           &frames,
+                       const std::string &path, uint64_t writer,
+                       uint64_t writers)
+{
+  RunManifest manifest;
+  manifest.AddFile(path);
+  std::vector<EventRecordRef> records;
+  std::ofstream file(path, std::ios::binary);
+  uint64_t offset = 0;
+  for (uint64_t f = 0; f < frames.size(); ++f) {
+    if ((f / kBlock) % writers != writer) {
+      continue;
+    }
+    const auto &frame = *frames[f];
+    file.write(reinterpret_cast<const char *>(frame.data()),
+               static_cast<std::streamsize>(frame.size()));
+    IndexFrame(manifest, records, frame, f, offset);
+    offset += frame.size();
+  }
+  return manifest;
+}
+
+std::vector<std::unique_ptr<std::vector<uint8_t>>> MakeRun(
+    DataProcessor &processor)
+{
+  std::vector<std::unique_ptr<std::vector<uint8_t>>> frames;
+  for (uint64_t f = 0; f < kRunFrames; ++f) {
+    frames.push_back(MakeFrame(processor, f));
+  }
+  return frames;
+}
+
+}  // namespace
+
+// Manifest indexing per frame (Arg 1) against none (Arg 0)
+static void BM_IndexFrame(benchmark::State &state)
+{
+  DataProcessor processor;
+  auto frame = MakeFrame(processor, 0);
+  const bool index = state.range(0) != 0;
+  RunManifest manifest;
+  std::vector<EventRecordRef> records;
+  uint64_t sequence = 0;
+  for (auto _ : state) {
+    if (index) {
+      IndexFrame(manifest, records, *frame, sequence, sequence * frame->size());
+    }
+    sequence++;
+    benchmark::DoNotOptimize(manifest);
+  }
+  state.SetBytesProcessed(state.iterations() * frame->size());
+}
+BENCHMARK(BM_IndexFrame)->Arg(0)->Arg(1);
+
+// One run written by N writers in parallel, one file each
+static void BM_FarmWrite(benchmark::State &state)
+{
+  DataProcessor processor;
+  auto frames = MakeRun(processor);
+  const uint64_t writers = static_cast<uint64_t>(state.range(0));
+  auto dir = BenchDir();
+  size_t runBytes = 0;
+  for (const auto &frame : frames) {
+    runBytes += frame->size();
+  }
+
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    std::vector<RunManifest> manifests(writers);
+    for (uint64_t w = 0; w < writers; ++w) {
+      threads.emplace_back([&, w] {
+        manifests[w] = WriteShare(
+            frames, (dir / ("w" + std::to_string(w) + ".dat")).string(), w,
+            writers);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    benchmark::DoNotOptimize(manifests);
+  }
+  state.SetBytesProcessed(state.iterations() * runBytes);
+  std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_FarmWrite)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// Reading the run back in sequence order from N files
+static void BM_ReadRun(benchmark::State &state)
+{
+  DataProcessor processor;
+  auto frames = MakeRun(processor);
+  const uint64_t writers = static_cast<uint64_t>(state.range(0));
+  auto dir = BenchDir();
+  RunManifest run;
+  for (uint64_t w = 0; w < writers; ++w) {
+    run.Merge(WriteShare(
+        frames, (dir / ("w" + std::to_string(w) + ".dat")).string(), w,
+        writers));
+  }
+
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    RunReader reader;
+    reader.Open(run);
+    while (auto frame = reader.Next()) {
+      benchmark::DoNotOptimize(frame->data());
+    }
+    bytes += reader.GetBytesRead();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_ReadRun)->Arg(1)->Arg(4);
+
+BENCHMARK_MAIN();
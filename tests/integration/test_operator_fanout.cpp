@@ -0,0 +1,253 @@
+/**
+ * @file test_operator_fanout.cpp
+ * @brief CLIOperator command fan-out against 100 fake components
+ *
+ * Each fake component answers commands on its own REP socket after a fixed
+ * processing delay and records the order in which commands arrived. The
+ * tests check the tier ordering of Start/Stop and measure how long a full
+ * Configure/Arm/Start/Stop cycle takes with concurrent fan-out.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CLIOperator.hpp"
+#include "ZMQTransport.hpp"
+#include "test_utils.hpp"
+
+using namespace DELILA;
+using namespace DELILA::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Global arrival counter shared by all fake components
+std::atomic<uint64_t> gArrival{0};
+
+/**
+ * @brief Minimal command responder standing in for a real component
+ */
+class FakeComponent {
+public:
+  FakeComponent(std::string id, std::string type, std::string address,
+                std::chrono::milliseconds delay)
+      : fId(std::move(id)), fType(std::move(type)),
+        fAddress(std::move(address)), fDelay(delay) {}
+
+  ~FakeComponent() { Stop(); }
+
+  bool Start() {
+    Net::TransportConfig config;
+    config.command_address = fAddress;
+    config.bind_command = true;
+    config.data_address = "";
+    config.status_address = "";
+    if (!fTransport.Configure(config) || !fTransport.Connect()) {
+      return false;
+    }
+    fRunning = true;
+    fThread = std::thread([this]() { Loop(); });
+    return true;
+  }
+
+  /// Let the loop exit without waiting for it (stop many in parallel)
+  void RequestStop() { fRunning = false; }
+
+  void Stop() {
+    fRunning = false;
+    if (fThread.joinable()) {
+      fThread.join();
+    }
+    fTransport.Disconnect();
+  }
+
+  ComponentAddress Address() const {
+    ComponentAddress addr;
+    addr.component_id = fId;
+    addr.command_address = fAddress;
+    addr.component_type = fType;
+    return addr;
+  }
+
+  /// Arrival index of the last command of @p type (0 if never received)
+  uint64_t ArrivalOf(CommandType type) const {
+    return fArrivals[static_cast<int>(type)].load();
+  }
+
+  const std::string &Type() const { return fType; }
+
+private:
+  void Loop() {
+    while (fRunning) {
+      auto cmd = fTransport.ReceiveCommand(100ms);
+      if (!cmd) {
+        continue;
+      }
+      if (static_cast<int>(cmd->type) < 32) {
+        fArrivals[static_cast<int>(cmd->type)] = ++gArrival;
+      }
+      std::this_thread::sleep_for(fDelay);
+      fTransport.SendCommandResponse(
+          CommandResponse::Success(cmd->request_id, StateAfter(cmd->type)));
+    }
+  }
+
+  static ComponentState StateAfter(CommandType type) {
+    switch (type) {
+    case CommandType::Configure:
+      return ComponentState::Configured;
+    case CommandType::Arm:
+      return ComponentState::Armed;
+    case CommandType::Start:
+      return ComponentState::Running;
+    case CommandType::Stop:
+      return ComponentState::Configured;
+    default:
+      return ComponentState::Idle;
+    }
+  }
+
+  std::string fId;
+  std::string fType;
+  std::string fAddress;
+  std::chrono::milliseconds fDelay;
+  Net::ZMQTransport fTransport;
+  std::atomic<bool> fRunning{false};
+  std::thread fThread;
+  std::atomic<uint64_t> fArrivals[32] = {};  // Indexed by CommandType
+};
+
+}  // namespace
+
+class OperatorFanOutTest : public ::testing::Test {
+protected:
+  static constexpr int kSources = 60;
+  static constexpr int kMergers = 10;
+  static constexpr int kSinks = 30;
+  static constexpr auto kDelay = 20ms;
+  static constexpr int kBasePort = 26100;
+
+  void SetUp() override {
+    operator_ = std::make_unique<CLIOperator>();
+    operator_->SetComponentId("fanout_operator");
+    operator_->SetCommandTimeout(2000ms);
+    ASSERT_TRUE(operator_->Initialize(""));
+
+    int port = kBasePort;
+    auto add = [&](const std::string &prefix, const std::string &type, int count) {
+      for (int i = 0; i < count; ++i) {
+        auto address = "tcp://127.0.0.1:" + std::to_string(port++);
+        components_.push_back(std::make_unique<FakeComponent>(
+            prefix + std::to_string(i), type, address, kDelay));
+      }
+    };
+    add("source_", "DigitizerSource", kSources);
+    add("merger_", "SimpleMerger", kMergers);
+    add("writer_", "FileWriter", kSinks);
+
+    for (auto &component : components_) {
+      ASSERT_TRUE(component->Start());
+      operator_->RegisterComponent(component->Address());
+    }
+    WaitForConnection(50);
+  }
+
+  void TearDown() override {
+    operator_->Shutdown();
+    for (auto &component : components_) {
+      component->RequestStop();
+    }
+    components_.clear();
+  }
+
+  /// Run a job to completion and return its wall time
+  std::chrono::milliseconds RunJob(const std::string &job_id) {
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(WaitForCondition(
+        [&]() {
+          return operator_->GetJobStatus(job_id).state != JobState::Running;
+        },
+        10000, 1));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(operator_->GetJobStatus(job_id).state, JobState::Completed)
+        << operator_->GetJobStatus(job_id).error_message;
+    return elapsed;
+  }
+
+  /// Latest and earliest arrival of @p type per component type
+  std::pair<uint64_t, uint64_t> ArrivalRange(const std::string &type,
+                                             CommandType command) const {
+    uint64_t first = UINT64_MAX, last = 0;
+    for (const auto &component : components_) {
+      if (component->Type() != type) continue;
+      first = std::min(first, component->ArrivalOf(command));
+      last = std::max(last, component->ArrivalOf(command));
+    }
+    return {first, last};
+  }
+
+  std::unique_ptr<CLIOperator> operator_;
+  std::vector<std::unique_ptr<FakeComponent>> components_;
+};
+
+TEST_F(OperatorFanOutTest, FullCycleWithHundredComponents) {
+  auto configure = RunJob(operator_->ConfigureAllAsync());
+  auto arm = RunJob(operator_->ArmAllAsync());
+  auto start = RunJob(operator_->StartAllAsync(1));
+  EXPECT_TRUE(operator_->IsAllInState(ComponentState::Running));
+  auto stop = RunJob(operator_->StopAllAsync(true));
+
+  std::cout << "[fan-out] 100 components, " << kDelay.count()
+            << " ms per command: configure " << configure.count()
+            << " ms, arm " << arm.count() << " ms, start " << start.count()
+            << " ms, stop " << stop.count() << " ms" << std::endl;
+
+  // Serial fan-out would need 100 x 20 ms = 2 s per transition; tiered
+  // concurrent fan-out needs about one delay per tier
+  EXPECT_LT(configure, 1000ms);
+  EXPECT_LT(start, 1000ms);
+  EXPECT_LT(stop, 1000ms);
+}
+
+TEST_F(OperatorFanOutTest, StartRunsSinksThenMergersThenSources) {
+  RunJob(operator_->StartAllAsync(7));
+
+  auto sinks = ArrivalRange("FileWriter", CommandType::Start);
+  auto mergers = ArrivalRange("SimpleMerger", CommandType::Start);
+  auto sources = ArrivalRange("DigitizerSource", CommandType::Start);
+
+  EXPECT_GT(sinks.first, 0u);
+  EXPECT_LT(sinks.second, mergers.first);
+  EXPECT_LT(mergers.second, sources.first);
+}
+
+TEST_F(OperatorFanOutTest, StopRunsSourcesThenMergersThenSinks) {
+  RunJob(operator_->StopAllAsync(true));
+
+  auto sinks = ArrivalRange("FileWriter", CommandType::Stop);
+  auto mergers = ArrivalRange("SimpleMerger", CommandType::Stop);
+  auto sources = ArrivalRange("DigitizerSource", CommandType::Stop);
+
+  EXPECT_GT(sources.first, 0u);
+  EXPECT_LT(sources.second, mergers.first);
+  EXPECT_LT(mergers.second, sinks.first);
+}
+
+TEST_F(OperatorFanOutTest, JobReportsLatencyPerComponent) {
+  auto job_id = operator_->ConfigureAllAsync();
+  RunJob(job_id);
+
+  auto status = operator_->GetJobStatus(job_id);
+  ASSERT_EQ(status.component_latency_ms.size(), components_.size());
+  for (const auto &[id, ms] : status.component_latency_ms) {
+    EXPECT_GE(ms, 15.0) << id;
+  }
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_reliable_delivery.cpp
+ * @brief Integration test for reliable delivery (retransmission)
+ *
+ * Emulator -> lossy link -> FileWriter, with the retransmit side channel
+ * from the writer back to the emulator. The link drops every few frames,
+ * retransmissions included; the written run must still be complete.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+#include <delila/core/MinimalEventData.hpp>
+
+#include "Emulator.hpp"
+#include "FileWriter.hpp"
+#include "RunManifest.hpp"
+#include "test_utils.hpp"
+
+using namespace DELILA;
+using namespace DELILA::test;
+
+namespace {
+
+/**
+ * @brief Forwards frames from one address to another, dropping some
+ *
+ * Stands in for a network that loses frames: every kDropEvery-th data
+ * frame is discarded. EOS is always forwarded (its loss cannot be
+ * detected from sequence numbers).
+ */
+class LossyLink {
+ public:
+  static constexpr uint64_t kDropEvery = 7;
+
+  bool Start(const std::string &from, const std::string &to) {
+    Net::TransportConfig in;
+    in.data_address = from;
+    in.bind_data = false;
+    in.data_pattern = "PULL";
+    in.status_address = in.data_address;
+    in.command_address = "";
+    Net::TransportConfig out = in;
+    out.data_address = to;
+    out.bind_data = true;
+    out.data_pattern = "PUSH";
+    out.status_address = out.data_address;
+    if (!input_.Configure(in) || !input_.Connect() ||
+        !output_.Configure(out) || !output_.Connect()) {
+      return false;
+    }
+    running_ = true;
+    thread_ = std::thread([this] { Forward(); });
+    return true;
+  }
+
+  void Stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  uint64_t GetDropped() const { return dropped_.load(); }
+
+ private:
+  void Forward() {
+    uint64_t frames = 0;
+    while (running_) {
+      auto data = input_.ReceiveBytes();
+      if (!data) {
+        continue;
+      }
+      if (!Net::DataProcessor::IsEOSMessage(*data) &&
+          ++frames % kDropEvery == 0) {
+        dropped_++;
+        continue;
+      }
+      output_.SendBytes(data);
+    }
+  }
+
+  Net::ZMQTransport input_;
+  Net::ZMQTransport output_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace
+
+class ReliableDeliveryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "delila_reliable_test";
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override {
+    writer_.Shutdown();
+    link_.Stop();
+    emulator_.Shutdown();
+    std::filesystem::remove_all(dir_);
+  }
+
+  std::filesystem::path dir_;
+  Emulator emulator_;
+  LossyLink link_;
+  FileWriter writer_;
+};
+
+TEST_F(ReliableDeliveryTest, LostFramesAreRetransmitted) {
+  const std::string source = "inproc://reliable_test_source";
+  const std::string sink = "inproc://reliable_test_sink";
+  const std::string retransmit = "inproc://reliable_test_retransmit";
+
+  emulator_.SetComponentId("emulator");
+  emulator_.SetOutputAddresses({source});
+  emulator_.SetRetransmitAddress(retransmit);
+  emulator_.SetEventRate(20000);
+  emulator_.SetBatchSize(20);  // ~1000 frames/s
+  emulator_.SetSeed(11);
+  ASSERT_TRUE(emulator_.Initialize(""));
+  ASSERT_TRUE(emulator_.Arm());
+  ASSERT_TRUE(link_.Start(source, sink));
+
+  writer_.SetComponentId("writer");
+  writer_.SetInputAddresses({sink});
+  writer_.SetOutputPath(dir_.string());
+  writer_.SetWriteManifest(true);
+  writer_.SetRetransmitAddress(retransmit);
+  ASSERT_TRUE(writer_.Initialize(""));
+  ASSERT_TRUE(writer_.Arm());
+  ASSERT_TRUE(writer_.Start(1));
+  ASSERT_TRUE(emulator_.Start(1));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  ASSERT_TRUE(emulator_.Stop(true));
+
+  // EOS is only reported once every missing frame has been recovered
+  ASSERT_TRUE(WaitForCondition([&] { return writer_.HasReceivedEOS(); },
+                               10000));
+  ASSERT_TRUE(writer_.Stop(true));
+
+  EXPECT_GT(link_.GetDropped(), 0u);
+  EXPECT_GT(writer_.GetFramesRecovered(), 0u);
+  EXPECT_GT(writer_.GetRetransmitRequests(), 0u);
+  EXPECT_EQ(writer_.GetFramesLost(), 0u);
+  EXPECT_EQ(writer_.GetRecoveryLatency().GetCount(),
+            writer_.GetFramesRecovered());
+  EXPECT_EQ(writer_.GetStatus().metrics.events_processed,
+            emulator_.GetStatus().metrics.events_processed);
+
+  // Every frame the emulator sent is in the file exactly once
+  RunManifest manifest;
+  std::string error;
+  ASSERT_TRUE(manifest.Load(writer_.GetManifestPath(), &error)) << error;
+  manifest.Sort();
+  EXPECT_TRUE(manifest.FindGaps().empty());
+  EXPECT_TRUE(manifest.FindOverlaps().empty());
+  ASSERT_FALSE(manifest.GetBlocks().empty());
+  EXPECT_EQ(manifest.GetBlocks().front().firstSequence, 0u);
+  EXPECT_EQ(manifest.GetFrames(),
+            manifest.GetBlocks().back().lastSequence + 1);
+}
+
+TEST_F(ReliableDeliveryTest, MergedInputDisablesReliableDelivery) {
+  const std::string sink = "inproc://reliable_test_merged_sink";
+
+  // Stands in for a merger: frames of two sources, same sequence numbers
+  Net::ZMQTransport merger;
+  Net::TransportConfig config;
+  config.data_address = sink;
+  config.status_address = sink;
+  config.command_address = "";
+  config.bind_data = true;
+  config.data_pattern = "PUSH";
+  ASSERT_TRUE(merger.Configure(config));
+  ASSERT_TRUE(merger.Connect());
+
+  writer_.SetComponentId("writer");
+  writer_.SetInputAddresses({sink});
+  writer_.SetOutputPath(dir_.string());
+  writer_.SetRetransmitAddress("inproc://reliable_test_merged_retransmit");
+  ASSERT_TRUE(writer_.Initialize(""));
+  ASSERT_TRUE(writer_.Arm());
+  ASSERT_TRUE(writer_.Start(1));
+  WaitForConnection();
+
+  Net::DataProcessor processor;
+  constexpr uint64_t kFrames = 5;
+  uint64_t mergeSequence = 0;
+  for (uint64_t sequence = 0; sequence < kFrames; ++sequence) {
+    for (uint8_t source = 1; source <= 2; ++source) {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<MinimalEventData>>>();
+      events->push_back(std::make_unique<MinimalEventData>(
+          source, 0, sequence * 1000.0, 100, 50, 0));
+      auto frame = processor.Process(events, sequence);
+      ASSERT_TRUE(frame);
+      Net::DataProcessor::SetSourceId(*frame, source);
+      Net::DataProcessor::SetMergeSequence(*frame, mergeSequence++);
+      ASSERT_TRUE(merger.SendBytes(frame));
+    }
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(merger.SendBytes(eos));
+
+  // EOS is not held back for "missing" frames of the other source
+  ASSERT_TRUE(WaitForCondition([&] { return writer_.HasReceivedEOS(); },
+                               5000));
+  ASSERT_TRUE(writer_.Stop(true));
+  merger.Disconnect();
+
+  // No frame is dropped as a duplicate of the other source's
+  auto status = writer_.GetStatus();
+  EXPECT_EQ(status.metrics.events_processed, 2 * kFrames);
+  EXPECT_NE(status.error_message.find("Reliable delivery disabled"),
+            std::string::npos);
+  EXPECT_EQ(writer_.GetRetransmitRequests(), 0u);
+  EXPECT_EQ(writer_.GetFramesLost(), 0u);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_spill_mode.cpp
+ * @brief Integration test for spill mode in SimpleMerger
+ *
+ * Emulator -> SimpleMerger (spill mode) -> sink that connects late. The
+ * merger has to hold the frames it cannot send until the sink is there;
+ * none may be dropped.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "Emulator.hpp"
+#include "SimpleMerger.hpp"
+#include "test_utils.hpp"
+
+using namespace DELILA;
+using namespace DELILA::test;
+
+class SpillModeTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    merger_.Shutdown();
+    emulator_.Shutdown();
+    if (sink_) {
+      sink_->Disconnect();
+    }
+  }
+
+  Emulator emulator_;
+  SimpleMerger merger_;
+  std::unique_ptr<Net::ZMQTransport> sink_;
+};
+
+TEST_F(SpillModeTest, LateSinkReceivesEveryFrame) {
+  const std::string source = "inproc://spill_test_source";
+  const std::string output = "inproc://spill_test_output";
+
+  merger_.SetComponentId("spill_test_merger");
+  merger_.SetInputAddresses({source});
+  merger_.SetOutputAddresses({output});
+  merger_.SetSpillDirectory(std::filesystem::temp_directory_path().string());
+  ASSERT_TRUE(merger_.Initialize(""));
+  ASSERT_TRUE(merger_.Arm());
+  ASSERT_TRUE(merger_.Start(1));
+
+  emulator_.SetComponentId("emulator");
+  emulator_.SetOutputAddresses({source});
+  emulator_.SetEventRate(20000);
+  emulator_.SetBatchSize(20);  // ~1000 frames/s
+  emulator_.SetSeed(5);
+  ASSERT_TRUE(emulator_.Initialize(""));
+  ASSERT_TRUE(emulator_.Arm());
+  ASSERT_TRUE(emulator_.Start(1));
+
+  // Nobody downstream yet: frames pile up in the merger
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  sink_ = std::make_unique<Net::ZMQTransport>();
+  Net::TransportConfig config;
+  config.data_address = output;
+  config.bind_data = false;
+  config.data_pattern = "PULL";
+  config.status_address = config.data_address;
+  config.command_address = "";
+  ASSERT_TRUE(sink_->Configure(config));
+  ASSERT_TRUE(sink_->Connect());
+
+  ASSERT_TRUE(emulator_.Stop(true));
+  const uint64_t sent = emulator_.GetStatus().metrics.events_processed;
+  ASSERT_TRUE(WaitForCondition(
+      [&] { return merger_.GetStatus().metrics.events_processed == sent; },
+      5000));
+  WaitForConnection(200);  // Let the merger take the emulator's EOS
+  ASSERT_TRUE(merger_.Stop(true));
+
+  uint64_t events = 0;
+  bool eos = false;
+  while (!eos) {
+    auto data = sink_->ReceiveBytes();
+    ASSERT_NE(data, nullptr) << "Sink timed out before EOS";
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      eos = true;
+      continue;
+    }
+    Net::BinaryDataHeader header;
+    ASSERT_TRUE(Net::DataProcessor::PeekHeader(*data, header));
+    events += header.event_count;
+  }
+
+  EXPECT_GT(events, 0u);
+  EXPECT_EQ(events, sent);
+  EXPECT_EQ(merger_.GetDroppedFrames(), 0u);
+}
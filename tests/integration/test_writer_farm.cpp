@@ -0,0 +1,148 @@
+/**
+ * @file test_writer_farm.cpp
+ * @brief Integration test for the FileWriter farm
+ *
+ * Router (frame key) -> two FileWriters with run manifests; the merged
+ * manifest must let RunReader return every frame in the order the router
+ * received it, although each writer only holds every other block.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "FileWriter.hpp"
+#include "Router.hpp"
+#include "RunManifest.hpp"
+#include "RunReader.hpp"
+#include "test_utils.hpp"
+
+using namespace DELILA;
+using namespace DELILA::test;
+
+class WriterFarmTest : public ::testing::Test {
+ protected:
+  static constexpr int kWriters = 2;
+
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "delila_farm_test";
+    for (int w = 0; w < kWriters; ++w) {
+      std::filesystem::create_directories(dir_ / ("disk" + std::to_string(w)));
+    }
+  }
+
+  void TearDown() override {
+    for (auto &writer : writers_) {
+      writer->Shutdown();
+    }
+    if (router_) {
+      router_->Shutdown();
+    }
+    std::filesystem::remove_all(dir_);
+  }
+
+  std::filesystem::path dir_;
+  std::unique_ptr<Router> router_;
+  std::vector<std::unique_ptr<FileWriter>> writers_;
+};
+
+TEST_F(WriterFarmTest, RunReaderRestoresTheReceiveOrder) {
+  constexpr int kFrames = 48;  // 12 blocks of 4, 6 per writer
+  constexpr int kEventsPerFrame = 16;
+
+  auto source = std::make_unique<Net::ZMQTransport>();
+  Net::TransportConfig config;
+  config.data_address = "inproc://farm_test_in";
+  config.bind_data = true;
+  config.data_pattern = "PUSH";
+  config.status_address = config.data_address;
+  config.command_address = "";
+  ASSERT_TRUE(source->Configure(config) && source->Connect());
+
+  std::vector<std::string> outputs;
+  for (int w = 0; w < kWriters; ++w) {
+    outputs.push_back("inproc://farm_test_out" + std::to_string(w));
+  }
+  router_ = std::make_unique<Router>();
+  router_->SetInputAddresses({config.data_address});
+  router_->SetOutputAddresses(outputs);
+  ASSERT_TRUE(router_->SetRouteKey(RouteTable::Key::Frame));
+  ASSERT_TRUE(router_->SetFrameBlock(4));
+  ASSERT_TRUE(router_->Initialize(""));
+  ASSERT_TRUE(router_->Arm());
+
+  for (int w = 0; w < kWriters; ++w) {
+    auto writer = std::make_unique<FileWriter>();
+    writer->SetComponentId("writer_" + std::to_string(w));
+    writer->SetInputAddresses({outputs[w]});
+    writer->SetOutputPath((dir_ / ("disk" + std::to_string(w))).string());
+    writer->SetWriteManifest(true);
+    ASSERT_TRUE(writer->Initialize(""));
+    ASSERT_TRUE(writer->Arm());
+    ASSERT_TRUE(writer->Start(7));
+    writers_.push_back(std::move(writer));
+  }
+  ASSERT_TRUE(router_->Start(7));
+
+  // Frame f holds times 100 * (f * kEventsPerFrame + i)
+  Net::DataProcessor processor;
+  for (int f = 0; f < kFrames; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+    for (int i = 0; i < kEventsPerFrame; ++i) {
+      events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+          0, i, 100.0 * (f * kEventsPerFrame + i), 100, 50, 0));
+    }
+    auto frame = processor.Process(events, 0);
+    ASSERT_TRUE(source->SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source->SendBytes(eos));
+
+  for (auto &writer : writers_) {
+    EXPECT_TRUE(WaitForCondition([&] { return writer->HasReceivedEOS(); },
+                                 5000));
+  }
+  EXPECT_TRUE(router_->Stop(true));
+
+  // Each writer saves its manifest on stop; merge them into the run's
+  RunManifest run;
+  for (auto &writer : writers_) {
+    ASSERT_TRUE(writer->Stop(true));
+    RunManifest part;
+    std::string error;
+    ASSERT_TRUE(part.Load(writer->GetManifestPath(), &error)) << error;
+    EXPECT_EQ(part.GetFrames(), static_cast<uint64_t>(kFrames / kWriters));
+    ASSERT_TRUE(run.Merge(part, &error)) << error;
+  }
+  EXPECT_EQ(run.GetRunNumber(), 7u);
+  EXPECT_EQ(run.GetFiles().size(), static_cast<size_t>(kWriters));
+  EXPECT_TRUE(run.FindGaps().empty());
+  ASSERT_TRUE(run.Save((dir_ / "run_000007.manifest.json").string()));
+
+  RunManifest saved;
+  ASSERT_TRUE(saved.Load((dir_ / "run_000007.manifest.json").string()));
+  RunReader reader;
+  ASSERT_TRUE(reader.Open(saved));
+  double lastTime = -1.0;
+  uint64_t expected = 0;
+  while (auto frame = reader.Next()) {
+    auto [events, sequence] = processor.DecodeMinimal(frame);
+    ASSERT_NE(events, nullptr);
+    EXPECT_EQ(sequence, expected++);
+    for (const auto &event : *events) {
+      EXPECT_GT(event->timeStampNs, lastTime);
+      lastTime = event->timeStampNs;
+    }
+  }
+  EXPECT_FALSE(reader.HasError()) << reader.GetError();
+  EXPECT_EQ(expected, static_cast<uint64_t>(kFrames));
+}
@@ -0,0 +1,265 @@
+/**
+ * @file test_calibration_stage.cpp
+ * @brief Unit tests for CalibrationStage component
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "CalibrationStage.hpp"
+#include "delila/core/ComponentState.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+class CalibrationStageTest : public ::testing::Test {
+ protected:
+  void SetUp() override { stage_ = std::make_unique<CalibrationStage>(); }
+
+  void TearDown() override {
+    if (stage_) {
+      stage_->Shutdown();
+    }
+  }
+
+  std::unique_ptr<CalibrationStage> stage_;
+};
+
+// === Initial State Tests ===
+
+TEST_F(CalibrationStageTest, InitialDefaults) {
+  EXPECT_EQ(stage_->GetCalibratedChannelCount(), 0u);
+  EXPECT_EQ(stage_->GetUncalibratedEvents(), 0u);
+}
+
+// === State Transition Tests ===
+
+TEST_F(CalibrationStageTest, InitializeFailsWithBadTable) {
+  stage_->SetInputAddresses({"tcp://localhost:5555"});
+  stage_->SetOutputAddresses({"tcp://localhost:6666"});
+  EXPECT_FALSE(stage_->Initialize("/nonexistent/calibration.json"));
+  EXPECT_EQ(stage_->GetState(), ComponentState::Idle);
+  EXPECT_FALSE(stage_->GetStatus().error_message.empty());
+}
+
+TEST_F(CalibrationStageTest, TableIsFixedWhileRunning) {
+  stage_->SetInputAddresses({"tcp://localhost:5555"});
+  stage_->SetOutputAddresses({"tcp://localhost:6666"});
+
+  const std::string table =
+      R"({"channels": [{"module": 0, "channel": 0, "poly": [0, 2]}]})";
+  EXPECT_TRUE(stage_->LoadCalibrationJson(table));
+  EXPECT_EQ(stage_->GetCalibratedChannelCount(), 1u);
+
+  EXPECT_TRUE(stage_->Initialize(""));
+  EXPECT_TRUE(stage_->Arm());
+  EXPECT_TRUE(stage_->Start(5));
+  EXPECT_EQ(stage_->GetState(), ComponentState::Running);
+
+  std::string error;
+  EXPECT_FALSE(stage_->LoadCalibrationJson(R"({"channels": []})", &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(stage_->SetCalibration(CalibrationTable()));
+  EXPECT_EQ(stage_->GetCalibratedChannelCount(), 1u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_TRUE(stage_->Stop(true));
+  EXPECT_EQ(stage_->GetState(), ComponentState::Configured);
+
+  // Between runs the table can be swapped
+  EXPECT_TRUE(stage_->SetCalibration(CalibrationTable()));
+  EXPECT_EQ(stage_->GetCalibratedChannelCount(), 0u);
+}
+
+// === Calibration Tests ===
+
+// Minimal and full frames come out as calibrated frames with the same
+// sequence numbers, event order and calibrated energies/timestamps
+TEST_F(CalibrationStageTest, CalibratesMinimalAndFullFrames) {
+  constexpr int kFrames = 10;
+  constexpr int kEventsPerFrame = 100;
+
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://calibration_stage_test_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  // Channels 0-3 calibrated (gain 0.5, offset 10 ns), 4-7 not
+  CalibrationTable table;
+  for (uint8_t ch = 0; ch < 4; ++ch) {
+    ASSERT_TRUE(table.SetPolynomial(0, ch, {1.0, 0.5}));
+    table.SetTimeOffset(0, ch, 10.0);
+  }
+  ASSERT_TRUE(stage_->SetCalibration(table));
+
+  stage_->SetInputAddresses({"inproc://calibration_stage_test_in"});
+  stage_->SetOutputAddresses({"inproc://calibration_stage_test_out"});
+  ASSERT_TRUE(stage_->Initialize(""));
+  ASSERT_TRUE(stage_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://calibration_stage_test_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(stage_->Start(1));
+
+  Net::DataProcessor processor;
+  for (int f = 0; f < kFrames; ++f) {
+    std::unique_ptr<std::vector<uint8_t>> frame;
+    if (f % 2 == 0) {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+      for (int e = 0; e < kEventsPerFrame; ++e) {
+        int n = f * kEventsPerFrame + e;
+        events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+            0, static_cast<uint8_t>(n % 8), 100.0 * n,
+            static_cast<uint16_t>(n), 0, 0));
+      }
+      frame = processor.Process(events, 1000 + f);
+    } else {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<Digitizer::EventData>>>();
+      for (int e = 0; e < kEventsPerFrame; ++e) {
+        int n = f * kEventsPerFrame + e;
+        auto event = std::make_unique<Digitizer::EventData>(16);
+        event->module = 0;
+        event->channel = static_cast<uint8_t>(n % 8);
+        event->timeStampNs = 100.0 * n;
+        event->energy = static_cast<uint16_t>(n);
+        events->push_back(std::move(event));
+      }
+      frame = processor.Process(events, 1000 + f);
+    }
+    ASSERT_TRUE(source.SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source.SendBytes(eos));
+
+  int received = 0;
+  uint64_t expectedSequence = 1000;
+  bool gotEos = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+    auto data = sink.ReceiveBytes();
+    if (!data) {
+      continue;
+    }
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      gotEos = true;
+      break;
+    }
+    auto [events, sequence] = processor.DecodeCalibrated(data);
+    ASSERT_NE(events, nullptr);
+    ASSERT_EQ(events->size(), static_cast<size_t>(kEventsPerFrame));
+    EXPECT_EQ(sequence, expectedSequence++);
+    for (const auto &event : *events) {
+      int n = received++;
+      ASSERT_EQ(event->rawEnergy, n);
+      if (n % 8 < 4) {
+        EXPECT_FLOAT_EQ(event->energy, 1.0f + 0.5f * n);
+        EXPECT_DOUBLE_EQ(event->timeStampNs, 100.0 * n + 10.0);
+      } else {
+        EXPECT_FLOAT_EQ(event->energy, static_cast<float>(n));
+        EXPECT_DOUBLE_EQ(event->timeStampNs, 100.0 * n);
+      }
+    }
+  }
+
+  EXPECT_TRUE(gotEos);
+  EXPECT_EQ(received, kFrames * kEventsPerFrame);
+  EXPECT_TRUE(stage_->Stop(true));
+  EXPECT_EQ(stage_->GetUncalibratedEvents(),
+            static_cast<uint64_t>(kFrames * kEventsPerFrame / 2));
+  EXPECT_EQ(stage_->GetStatus().metrics.events_processed,
+            static_cast<uint64_t>(kFrames * kEventsPerFrame));
+}
+
+// A frame from a merger keeps its merger stamp, flags, sequence number and
+// source timestamp through calibration, so it can still be followed per
+// source downstream.
+TEST_F(CalibrationStageTest, KeepsMergerStamps) {
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://calibration_stage_test_stamp_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  CalibrationTable table;
+  ASSERT_TRUE(table.SetPolynomial(0, 0, {1.0, 0.5}));
+  ASSERT_TRUE(stage_->SetCalibration(table));
+  stage_->SetInputAddresses({"inproc://calibration_stage_test_stamp_in"});
+  stage_->SetOutputAddresses({"inproc://calibration_stage_test_stamp_out"});
+  ASSERT_TRUE(stage_->Initialize(""));
+  ASSERT_TRUE(stage_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://calibration_stage_test_stamp_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(stage_->Start(1));
+
+  Net::DataProcessor processor;
+  auto events = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+  events->push_back(
+      std::make_unique<Digitizer::MinimalEventData>(0, 0, 100.0, 200, 0, 0));
+  auto frame = processor.Process(events, 12);
+  ASSERT_TRUE(frame);
+  ASSERT_TRUE(Net::DataProcessor::SetSourceId(*frame, 3));
+  ASSERT_TRUE(Net::DataProcessor::SetMergeSequence(*frame, 345));
+  ASSERT_TRUE(Net::DataProcessor::SetFrameFlags(*frame, 0x80));
+  Net::BinaryDataHeader sent;
+  ASSERT_TRUE(Net::DataProcessor::PeekHeader(*frame, sent));
+  ASSERT_TRUE(source.SendBytes(frame));
+
+  std::unique_ptr<std::vector<uint8_t>> data;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!data && std::chrono::steady_clock::now() < deadline) {
+    data = sink.ReceiveBytes();
+  }
+  ASSERT_NE(data, nullptr);
+
+  Net::BinaryDataHeader header;
+  ASSERT_TRUE(Net::DataProcessor::PeekHeader(*data, header));
+  EXPECT_EQ(header.format_version, Net::FORMAT_VERSION_CALIBRATED_EVENTDATA);
+  EXPECT_EQ(header.sequence_number, 12u);
+  EXPECT_EQ(header.source_id, 3u);
+  EXPECT_EQ(Net::DataProcessor::GetMergeSequence(header), 345u);
+  EXPECT_EQ(header.frame_flags, 0x80u);
+  EXPECT_EQ(header.timestamp, sent.timestamp);
+  auto [decoded, sequence] = processor.DecodeCalibrated(data);
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_FLOAT_EQ((*decoded)[0]->energy, 101.0f);
+
+  EXPECT_TRUE(stage_->Stop(true));
+}
+
+}  // namespace test
+}  // namespace DELILA
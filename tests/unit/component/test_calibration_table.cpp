@@ -0,0 +1,146 @@
+/**
+ * @file test_calibration_table.cpp
+ * @brief Unit tests for CalibrationTable
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "CalibrationTable.hpp"
+
+namespace DELILA {
+namespace test {
+
+TEST(CalibrationTableTest, EmptyTablePassesThrough) {
+  CalibrationTable table;
+  EXPECT_EQ(table.GetChannelCount(), 0u);
+  EXPECT_FALSE(table.HasChannel(0, 0));
+  EXPECT_FLOAT_EQ(table.CalibrateEnergy(0, 0, 1234), 1234.0f);
+  EXPECT_DOUBLE_EQ(table.GetTimeOffset(0, 0), 0.0);
+
+  MinimalEventData hit(1, 2, 100.5, 1000, 200, 0x4);
+  CalibratedEventData out;
+  EXPECT_EQ(table.Apply(&hit, 1, &out), 1u);
+  EXPECT_EQ(out.module, 1);
+  EXPECT_EQ(out.channel, 2);
+  EXPECT_EQ(out.rawEnergy, 1000);
+  EXPECT_FLOAT_EQ(out.energy, 1000.0f);
+  EXPECT_FLOAT_EQ(out.energyShort, 200.0f);
+  EXPECT_DOUBLE_EQ(out.timeStampNs, 100.5);
+  EXPECT_EQ(out.flags, 0x4u);
+}
+
+TEST(CalibrationTableTest, PolynomialAndTimeOffset) {
+  CalibrationTable table;
+  ASSERT_TRUE(table.SetPolynomial(0, 1, {2.0, 0.5, 0.001}));
+  table.SetTimeOffset(0, 1, -12.5);
+  EXPECT_FALSE(table.SetPolynomial(0, 2, {}));
+  EXPECT_FALSE(table.SetPolynomial(0, 2, {1, 2, 3, 4, 5}));
+  EXPECT_EQ(table.GetChannelCount(), 1u);
+
+  // 2 + 0.5 * 100 + 0.001 * 100^2
+  EXPECT_FLOAT_EQ(table.CalibrateEnergy(0, 1, 100), 62.0f);
+
+  std::vector<MinimalEventData> hits = {
+      MinimalEventData(0, 1, 1000.0, 100, 40, 0),
+      MinimalEventData(0, 0, 1000.0, 100, 40, 0),
+  };
+  std::vector<CalibratedEventData> out(hits.size());
+  EXPECT_EQ(table.Apply(hits.data(), hits.size(), out.data()), 1u);
+  EXPECT_FLOAT_EQ(out[0].energy, 62.0f);
+  EXPECT_FLOAT_EQ(out[0].energyShort, 2.0f + 20.0f + 1.6f);
+  EXPECT_DOUBLE_EQ(out[0].timeStampNs, 987.5);
+  EXPECT_FLOAT_EQ(out[1].energy, 100.0f);
+  EXPECT_DOUBLE_EQ(out[1].timeStampNs, 1000.0);
+}
+
+TEST(CalibrationTableTest, LookupTableClampsAboveLastEntry) {
+  CalibrationTable table;
+  ASSERT_TRUE(table.SetLookupTable(2, 3, {0.0f, 1.5f, 3.0f}));
+  EXPECT_FALSE(table.SetLookupTable(2, 4, {}));
+
+  MinimalEventData hits[] = {MinimalEventData(2, 3, 0.0, 1, 2, 0),
+                             MinimalEventData(2, 3, 0.0, 500, 0, 0)};
+  CalibratedEventData out[2];
+  EXPECT_EQ(table.Apply(hits, 2, out), 0u);
+  EXPECT_FLOAT_EQ(out[0].energy, 1.5f);
+  EXPECT_FLOAT_EQ(out[0].energyShort, 3.0f);
+  EXPECT_FLOAT_EQ(out[1].energy, 3.0f);
+  EXPECT_FLOAT_EQ(out[1].energyShort, 0.0f);
+}
+
+// Apply() must agree with CalibrateEnergy() over a large mixed batch
+TEST(CalibrationTableTest, BatchMatchesSingleHit) {
+  CalibrationTable table;
+  for (uint8_t ch = 0; ch < 8; ++ch) {
+    ASSERT_TRUE(table.SetPolynomial(0, ch, {0.1 * ch, 0.25 + 0.01 * ch}));
+  }
+  ASSERT_TRUE(table.SetLookupTable(1, 0, std::vector<float>(4096, 7.0f)));
+
+  std::vector<MinimalEventData> hits;
+  for (int i = 0; i < 1000; ++i) {
+    hits.emplace_back(static_cast<uint8_t>(i % 3 == 0), static_cast<uint8_t>(i % 9),
+                      10.0 * i, static_cast<uint16_t>(i * 37 % 8000), 0, 0);
+  }
+  std::vector<CalibratedEventData> out(hits.size());
+  table.Apply(hits.data(), hits.size(), out.data());
+  for (size_t i = 0; i < hits.size(); ++i) {
+    EXPECT_FLOAT_EQ(out[i].energy,
+                    table.CalibrateEnergy(hits[i].module, hits[i].channel,
+                                          hits[i].energy))
+        << i;
+  }
+}
+
+TEST(CalibrationTableTest, LoadJson) {
+  CalibrationTable table;
+  std::string error;
+  ASSERT_TRUE(table.LoadJson(R"({"channels": [
+      {"module": 0, "channel": 0, "poly": [1.0, 2.0], "time_offset": 5.0},
+      {"module": 0, "channel": 1, "lut": [0.0, 10.0]}]})",
+                             &error))
+      << error;
+  EXPECT_EQ(table.GetChannelCount(), 2u);
+  EXPECT_FLOAT_EQ(table.CalibrateEnergy(0, 0, 10), 21.0f);
+  EXPECT_DOUBLE_EQ(table.GetTimeOffset(0, 0), 5.0);
+  EXPECT_FLOAT_EQ(table.CalibrateEnergy(0, 1, 1), 10.0f);
+}
+
+TEST(CalibrationTableTest, InvalidJsonKeepsTable) {
+  CalibrationTable table;
+  ASSERT_TRUE(table.SetPolynomial(0, 0, {0.0, 2.0}));
+
+  std::string error;
+  EXPECT_FALSE(table.LoadJson("not json", &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(table.LoadJson(
+      R"({"channels": [{"module": 300, "channel": 0, "poly": [1.0]}]})",
+      &error));
+  EXPECT_FALSE(table.LoadJson(
+      R"({"channels": [{"module": 0, "channel": 0, "poly": [1], "lut": [1]}]})",
+      &error));
+  EXPECT_FALSE(table.LoadFile("/nonexistent/calibration.json", &error));
+
+  EXPECT_EQ(table.GetChannelCount(), 1u);
+  EXPECT_FLOAT_EQ(table.CalibrateEnergy(0, 0, 10), 20.0f);
+}
+
+TEST(CalibrationTableTest, LoadFile) {
+  std::string path = "/tmp/delila_calibration_table_test.json";
+  {
+    std::ofstream file(path);
+    file << R"({"channels": [{"module": 4, "channel": 5, "poly": [0, 0.5]}]})";
+  }
+  CalibrationTable table;
+  EXPECT_TRUE(table.LoadFile(path));
+  EXPECT_TRUE(table.HasChannel(4, 5));
+  EXPECT_FLOAT_EQ(table.CalibrateEnergy(4, 5, 100), 50.0f);
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -420,3 +420,120 @@ TEST_F(CLIOperatorTest, FullLifecycleWithNoComponents) {
   std::this_thread::sleep_for(200ms);
   EXPECT_EQ(operator_->GetJobStatus(reset_job).state, JobState::Completed);
 }
+
+// === Command Ordering Tests ===
+
+namespace {
+
+ComponentAddress MakeAddress(const std::string &id, const std::string &type,
+                             uint32_t start_order = 0) {
+  ComponentAddress addr;
+  addr.component_id = id;
+  addr.command_address = "tcp://localhost:5555";
+  addr.component_type = type;
+  addr.start_order = start_order;
+  return addr;
+}
+
+std::vector<std::string> BatchIds(const std::vector<ComponentAddress> &batch) {
+  std::vector<std::string> ids;
+  for (const auto &addr : batch) {
+    ids.push_back(addr.component_id);
+  }
+  return ids;
+}
+
+}  // namespace
+
+TEST_F(CLIOperatorTest, ComponentTierFromType) {
+  using Tier = CLIOperator::ComponentTier;
+  EXPECT_EQ(CLIOperator::GetComponentTier(MakeAddress("a", "DigitizerSource")),
+            Tier::Source);
+  EXPECT_EQ(CLIOperator::GetComponentTier(MakeAddress("b", "Emulator")),
+            Tier::Source);
+  EXPECT_EQ(CLIOperator::GetComponentTier(MakeAddress("c", "SimpleMerger")),
+            Tier::Merger);
+  EXPECT_EQ(CLIOperator::GetComponentTier(MakeAddress("d", "FileWriter")),
+            Tier::Sink);
+  EXPECT_EQ(CLIOperator::GetComponentTier(MakeAddress("e", "MonitorROOT")),
+            Tier::Sink);
+  EXPECT_EQ(CLIOperator::GetComponentTier(MakeAddress("f", "")),
+            Tier::Merger);
+}
+
+TEST_F(CLIOperatorTest, StartBatchesRunFromSinksToSources) {
+  std::vector<ComponentAddress> components = {
+      MakeAddress("source_01", "DigitizerSource"),
+      MakeAddress("writer_01", "FileWriter"),
+      MakeAddress("merger_01", "SimpleMerger"),
+      MakeAddress("source_02", "Emulator"),
+      MakeAddress("monitor_01", "MonitorROOT")};
+
+  auto batches = CLIOperator::PlanCommandBatches(components, CommandType::Start);
+  ASSERT_EQ(batches.size(), 3u);
+  EXPECT_EQ(BatchIds(batches[0]),
+            (std::vector<std::string>{"writer_01", "monitor_01"}));
+  EXPECT_EQ(BatchIds(batches[1]), (std::vector<std::string>{"merger_01"}));
+  EXPECT_EQ(BatchIds(batches[2]),
+            (std::vector<std::string>{"source_01", "source_02"}));
+}
+
+TEST_F(CLIOperatorTest, StopBatchesAreReverseOfStart) {
+  std::vector<ComponentAddress> components = {
+      MakeAddress("source_01", "DigitizerSource"),
+      MakeAddress("merger_01", "SimpleMerger"),
+      MakeAddress("writer_01", "FileWriter")};
+
+  auto batches = CLIOperator::PlanCommandBatches(components, CommandType::Stop);
+  ASSERT_EQ(batches.size(), 3u);
+  EXPECT_EQ(batches[0][0].component_id, "source_01");
+  EXPECT_EQ(batches[1][0].component_id, "merger_01");
+  EXPECT_EQ(batches[2][0].component_id, "writer_01");
+}
+
+TEST_F(CLIOperatorTest, StartOrderSplitsATier) {
+  std::vector<ComponentAddress> components = {
+      MakeAddress("merger_b", "SimpleMerger", 1),
+      MakeAddress("merger_a", "SimpleMerger", 0)};
+
+  auto batches = CLIOperator::PlanCommandBatches(components, CommandType::Start);
+  ASSERT_EQ(batches.size(), 2u);
+  EXPECT_EQ(batches[0][0].component_id, "merger_a");
+  EXPECT_EQ(batches[1][0].component_id, "merger_b");
+}
+
+TEST_F(CLIOperatorTest, OtherCommandsUseSingleBatch) {
+  std::vector<ComponentAddress> components = {
+      MakeAddress("source_01", "DigitizerSource"),
+      MakeAddress("writer_01", "FileWriter")};
+
+  for (auto type : {CommandType::Configure, CommandType::Arm, CommandType::Reset}) {
+    auto batches = CLIOperator::PlanCommandBatches(components, type);
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0].size(), 2u);
+  }
+  EXPECT_TRUE(CLIOperator::PlanCommandBatches({}, CommandType::Start).empty());
+}
+
+TEST_F(CLIOperatorTest, CommandTimeoutIsConfigurable) {
+  EXPECT_EQ(operator_->GetCommandTimeout(), 5000ms);
+  operator_->SetCommandTimeout(250ms);
+  EXPECT_EQ(operator_->GetCommandTimeout(), 250ms);
+}
+
+TEST_F(CLIOperatorTest, UnreachableComponentFailsWithinTimeout) {
+  operator_->Initialize("");
+  operator_->SetCommandTimeout(100ms);
+  auto addr = MakeAddress("ghost_01", "FileWriter");
+  addr.command_address = "tcp://127.0.0.1:25999";
+  operator_->RegisterComponent(addr);
+
+  auto job_id = operator_->ConfigureAllAsync();
+  std::this_thread::sleep_for(400ms);
+
+  auto status = operator_->GetJobStatus(job_id);
+  EXPECT_EQ(status.state, JobState::Failed);
+  EXPECT_NE(status.error_message.find("ghost_01"), std::string::npos);
+  ASSERT_EQ(status.component_latency_ms.count("ghost_01"), 1u);
+  EXPECT_GE(status.component_latency_ms.at("ghost_01"), 90.0);
+}
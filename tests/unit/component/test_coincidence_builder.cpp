@@ -0,0 +1,269 @@
+/**
+ * @file test_coincidence_builder.cpp
+ * @brief Unit tests for HitTimeBuckets and CoincidenceBuilder
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "CoincidenceBuilder.hpp"
+
+namespace DELILA {
+namespace test {
+
+namespace {
+
+MinimalEventData Hit(uint8_t module, uint8_t channel, double timeNs) {
+  return MinimalEventData(module, channel, timeNs, 100, 50, 0);
+}
+
+struct Event {
+  std::vector<double> times;
+  uint32_t trigger;
+};
+
+std::vector<Event> Collect(const CoincidenceBuilder &builder,
+                           const std::vector<MinimalEventData> &hits) {
+  std::vector<Event> events;
+  builder.ForEachEvent(hits, [&](const MinimalEventData *first,
+                                 uint32_t count, uint32_t trigger) {
+    Event event{{}, trigger};
+    for (uint32_t i = 0; i < count; ++i) {
+      event.times.push_back(first[i].timeStampNs);
+    }
+    events.push_back(event);
+  });
+  return events;
+}
+
+// Several modules, each time-ordered, with clustered hits
+std::vector<MinimalEventData> RandomStream(size_t count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::exponential_distribution<double> gap(1.0 / 400.0);
+  std::uniform_int_distribution<int> module(0, 3);
+  std::uniform_int_distribution<int> channel(0, 15);
+  std::vector<MinimalEventData> hits;
+  double t = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    t += gap(rng);
+    hits.push_back(Hit(static_cast<uint8_t>(module(rng)),
+                       static_cast<uint8_t>(channel(rng)), t));
+  }
+  return hits;
+}
+
+}  // namespace
+
+// === HitTimeBuckets ===
+
+TEST(HitTimeBucketsTest, ReleasesInTimeOrderUpToWatermark) {
+  HitTimeBuckets buckets(100.0);
+  buckets.Add(Hit(1, 0, 250.0));
+  buckets.Add(Hit(0, 0, 50.0));
+  buckets.Add(Hit(2, 0, 120.0));
+  buckets.Add(Hit(0, 1, 10.0));
+
+  std::vector<MinimalEventData> out;
+  EXPECT_EQ(buckets.Release(199.0, out), 2u);  // Only bucket [0, 100)
+  ASSERT_EQ(out.size(), 2u);
+  EXPECT_EQ(out[0].timeStampNs, 10.0);
+  EXPECT_EQ(out[1].timeStampNs, 50.0);
+
+  EXPECT_EQ(buckets.Release(300.0, out), 2u);
+  ASSERT_EQ(out.size(), 4u);
+  EXPECT_EQ(out[2].timeStampNs, 120.0);
+  EXPECT_EQ(out[3].timeStampNs, 250.0);
+  EXPECT_EQ(buckets.GetBufferedCount(), 0u);
+}
+
+TEST(HitTimeBucketsTest, TiesOrderedByModuleAndChannel) {
+  HitTimeBuckets buckets(100.0);
+  buckets.Add(Hit(2, 0, 5.0));
+  buckets.Add(Hit(1, 3, 5.0));
+  buckets.Add(Hit(1, 1, 5.0));
+
+  std::vector<MinimalEventData> out;
+  buckets.ReleaseAll(out);
+  ASSERT_EQ(out.size(), 3u);
+  EXPECT_EQ(out[0].channel, 1);
+  EXPECT_EQ(out[1].channel, 3);
+  EXPECT_EQ(out[2].module, 2);
+}
+
+TEST(HitTimeBucketsTest, LateHitsAreDroppedAndCounted) {
+  HitTimeBuckets buckets(100.0);
+  buckets.Add(Hit(0, 0, 150.0));
+  std::vector<MinimalEventData> out;
+  buckets.Release(200.0, out);
+
+  buckets.Add(Hit(1, 0, 120.0));  // Bucket [100, 200) is gone
+  buckets.Add(Hit(1, 0, 210.0));
+  EXPECT_EQ(buckets.GetLateCount(), 1u);
+  EXPECT_EQ(buckets.GetBufferedCount(), 1u);
+
+  buckets.Reset();
+  EXPECT_EQ(buckets.GetLateCount(), 0u);
+  EXPECT_EQ(buckets.GetBufferedCount(), 0u);
+}
+
+TEST(HitTimeBucketsTest, MergedStreamsMatchFullSort) {
+  auto hits = RandomStream(20000, 7);
+  auto expected = hits;
+
+  // Deliver per-module streams in interleaved batches
+  HitTimeBuckets buckets(16000.0);
+  std::vector<MinimalEventData> out;
+  std::vector<std::vector<MinimalEventData>> perModule(4);
+  for (const auto &hit : hits) {
+    perModule[hit.module].push_back(hit);
+  }
+  std::vector<size_t> next(4, 0);
+  std::vector<double> newest(4, 0.0);
+  bool remaining = true;
+  while (remaining) {
+    remaining = false;
+    for (size_t m = 0; m < 4; ++m) {
+      size_t end = std::min(next[m] + 37 * (m + 1), perModule[m].size());
+      for (; next[m] < end; ++next[m]) {
+        buckets.Add(perModule[m][next[m]]);
+        newest[m] = perModule[m][next[m]].timeStampNs;
+      }
+      remaining = remaining || next[m] < perModule[m].size();
+    }
+    buckets.Release(*std::min_element(newest.begin(), newest.end()), out);
+  }
+  buckets.ReleaseAll(out);
+
+  EXPECT_EQ(buckets.GetLateCount(), 0u);
+  ASSERT_EQ(out.size(), expected.size());
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_EQ(out[i].timeStampNs, expected[i].timeStampNs) << "at " << i;
+  }
+}
+
+// === CoincidenceBuilder ===
+
+TEST(CoincidenceBuilderTest, GroupsHitsAroundTrigger) {
+  CoincidenceBuilder builder;
+  builder.SetWindow(100.0, 200.0);
+  builder.SetTriggerChannels({{0, 0}});
+
+  std::vector<MinimalEventData> hits = {
+      Hit(1, 0, 850.0),   // Before the window
+      Hit(1, 1, 910.0),   // In the window (pre)
+      Hit(0, 0, 1000.0),  // Trigger
+      Hit(1, 2, 1200.0),  // In the window (post edge)
+      Hit(1, 3, 1250.0),  // After the window
+  };
+  auto events = Collect(builder, hits);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].times, (std::vector<double>{910.0, 1000.0, 1200.0}));
+  EXPECT_EQ(events[0].trigger, 1u);
+}
+
+TEST(CoincidenceBuilderTest, TriggerInsideEarlierWindowIsAbsorbed) {
+  CoincidenceBuilder builder;
+  builder.SetWindow(50.0, 100.0);
+
+  std::vector<MinimalEventData> hits = {
+      Hit(0, 0, 0.0), Hit(0, 1, 80.0), Hit(0, 2, 150.0), Hit(0, 3, 260.0)};
+  auto events = Collect(builder, hits);
+
+  // 0 opens [-50, 100]; 150 opens [100, 250] but 80 is already claimed
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0].times, (std::vector<double>{0.0, 80.0}));
+  EXPECT_EQ(events[1].times, (std::vector<double>{150.0}));
+  EXPECT_EQ(events[2].times, (std::vector<double>{260.0}));
+}
+
+TEST(CoincidenceBuilderTest, MinHitsDiscardsSmallEvents) {
+  CoincidenceBuilder builder;
+  builder.SetWindow(10.0, 10.0);
+  builder.SetMinHits(2);
+
+  std::vector<MinimalEventData> hits = {Hit(0, 0, 0.0), Hit(1, 0, 5.0),
+                                        Hit(0, 0, 100.0)};
+  auto events = Collect(builder, hits);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].times.size(), 2u);
+}
+
+TEST(CoincidenceBuilderTest, NoTriggerNoEvents) {
+  CoincidenceBuilder builder;
+  builder.SetTriggerChannels({{9, 9}});
+  auto hits = RandomStream(1000, 1);
+  EXPECT_TRUE(Collect(builder, hits).empty());
+}
+
+TEST(CoincidenceBuilderTest, BuildSerializesDecodableEvents) {
+  CoincidenceBuilder builder;
+  builder.SetWindow(100.0, 100.0);
+  builder.SetTriggerChannels({{0, 0}});
+  std::vector<MinimalEventData> hits = {Hit(1, 0, 950.0), Hit(0, 0, 1000.0),
+                                        Hit(0, 0, 5000.0)};
+
+  auto frame = std::make_unique<std::vector<uint8_t>>(
+      Net::BINARY_DATA_HEADER_SIZE);
+  uint32_t events = builder.Build(hits, *frame);
+  ASSERT_EQ(events, 2u);
+
+  Net::DataProcessor processor;
+  ASSERT_TRUE(processor.FinalizeFrame(
+      *frame, Net::FORMAT_VERSION_BUILT_EVENTDATA, events, 42));
+  auto [decoded, sequence] = processor.DecodeBuilt(frame);
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_EQ(sequence, 42u);
+  ASSERT_EQ(decoded->size(), 2u);
+  EXPECT_EQ((*decoded)[0]->GetMultiplicity(), 2u);
+  EXPECT_EQ((*decoded)[0]->GetTriggerTimeNs(), 1000.0);
+  EXPECT_EQ((*decoded)[1]->GetMultiplicity(), 1u);
+}
+
+TEST(CoincidenceBuilderTest, SlicedBuildMatchesWholeBuild) {
+  CoincidenceBuilder builder;
+  builder.SetWindow(300.0, 500.0);
+  builder.SetTriggerChannels({{0, 0}, {1, 0}, {2, 3}, {3, 7}, {0, 5}});
+  auto hits = RandomStream(50000, 3);
+  auto whole = Collect(builder, hits);
+  ASSERT_GT(whole.size(), 100u);
+
+  // Feed in pieces as the sorter does, cutting at the first safe point
+  // after each slice length
+  std::vector<Event> sliced;
+  std::vector<MinimalEventData> slice;
+  CoincidenceBuilder::CutScan scan;
+  size_t cuts = 0;
+  for (size_t begin = 0; begin < hits.size(); begin += 1000) {
+    size_t end = std::min(begin + 1000, hits.size());
+    slice.insert(slice.end(), hits.begin() + begin, hits.begin() + end);
+    while (true) {
+      size_t cut =
+          builder.FindCut(slice, slice.front().timeStampNs + 200000.0, scan);
+      if (cut == 0) {
+        break;
+      }
+      std::vector<MinimalEventData> head(slice.begin(), slice.begin() + cut);
+      auto part = Collect(builder, head);
+      sliced.insert(sliced.end(), part.begin(), part.end());
+      slice.erase(slice.begin(), slice.begin() + cut);
+      cuts++;
+    }
+  }
+  auto part = Collect(builder, slice);
+  sliced.insert(sliced.end(), part.begin(), part.end());
+
+  EXPECT_GT(cuts, 10u);
+  ASSERT_EQ(sliced.size(), whole.size());
+  for (size_t i = 0; i < whole.size(); ++i) {
+    ASSERT_EQ(sliced[i].times, whole[i].times) << "event " << i;
+    ASSERT_EQ(sliced[i].trigger, whole[i].trigger) << "event " << i;
+  }
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -5,15 +5,73 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <DataProcessor.hpp>
 #include <DigitizerSource.hpp>
+#include <IDigitizer.hpp>
+#include <ZMQTransport.hpp>
 #include <delila/core/ComponentState.hpp>
 #include <delila/core/ComponentStatus.hpp>
+#include <atomic>
 #include <thread>
 #include <chrono>
 
 namespace DELILA {
 namespace test {
 
+/**
+ * @brief IDigitizer stand-in that hands out a fixed number of events
+ */
+class FakeDigitizer : public Digitizer::IDigitizer {
+public:
+  FakeDigitizer(size_t total_events, size_t chunk_size)
+      : total_(total_events), chunk_(chunk_size) {}
+
+  bool Initialize(const Digitizer::ConfigurationManager &) override {
+    return true;
+  }
+  bool Configure() override { configured++; return true; }
+  bool ArmAcquisition() override { armed++; return true; }
+  bool StartAcquisition() override { started++; return true; }
+  bool StopAcquisition() override { stopped++; return true; }
+  bool SendSWTrigger() override { return true; }
+  bool CheckStatus() override { return true; }
+
+  std::unique_ptr<std::vector<std::unique_ptr<Digitizer::EventData>>>
+  GetEventData() override {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::EventData>>>();
+    while (events->size() < chunk_ && produced_ < total_) {
+      auto event = std::make_unique<Digitizer::EventData>();
+      event->module = 3;
+      event->channel = static_cast<uint8_t>(produced_ % 16);
+      event->timeStampNs = static_cast<double>(produced_) * 100.0;
+      event->energy = static_cast<uint16_t>(produced_ % 4096);
+      events->push_back(std::move(event));
+      produced_++;
+    }
+    return events;
+  }
+
+  void PrintDeviceInfo() override {}
+  const nlohmann::json &GetDeviceTreeJSON() const override { return tree_; }
+  Digitizer::FirmwareType GetType() const override {
+    return Digitizer::FirmwareType::PSD2;
+  }
+  uint64_t GetHandle() const override { return 0; }
+  uint8_t GetModuleNumber() const override { return 3; }
+
+  std::atomic<int> configured{0};
+  std::atomic<int> armed{0};
+  std::atomic<int> started{0};
+  std::atomic<int> stopped{0};
+
+private:
+  size_t total_;
+  size_t chunk_;
+  std::atomic<size_t> produced_{0};
+  nlohmann::json tree_;
+};
+
 class DigitizerSourceTest : public ::testing::Test {
 protected:
   void SetUp() override {
@@ -229,5 +287,130 @@ TEST_F(DigitizerSourceTest, HasDataProcessorForEOS) {
   EXPECT_EQ(source_->GetState(), ComponentState::Configured);
 }
 
+// === Hardware Path Tests ===
+
+TEST_F(DigitizerSourceTest, HardwareModeWithoutDigitizerFails) {
+  source_->SetOutputAddresses({"tcp://localhost:5555"});
+
+  EXPECT_FALSE(source_->Initialize(""));
+  EXPECT_EQ(source_->GetState(), ComponentState::Error);
+}
+
+TEST_F(DigitizerSourceTest, InjectedDigitizerFollowsLifecycle) {
+  auto digitizer = std::make_unique<FakeDigitizer>(0, 1);
+  auto *fake = digitizer.get();
+  source_->SetDigitizer(std::move(digitizer));
+  source_->SetOutputAddresses({"tcp://localhost:5555"});
+
+  ASSERT_TRUE(source_->Initialize(""));
+  EXPECT_EQ(fake->configured, 1);
+
+  ASSERT_TRUE(source_->Arm());
+  EXPECT_EQ(fake->armed, 1);
+
+  ASSERT_TRUE(source_->Start(1));
+  EXPECT_EQ(fake->started, 1);
+
+  ASSERT_TRUE(source_->Stop(true));
+  EXPECT_GE(fake->stopped, 1);
+}
+
+// === Batching and Queue Tests ===
+
+TEST_F(DigitizerSourceTest, BatchingDefaults) {
+  EXPECT_EQ(source_->GetBatchSize(), 1024u);
+  EXPECT_EQ(source_->GetBatchTimeoutMs(), 10u);
+  EXPECT_EQ(source_->GetDataMode(), DigitizerSourceDataMode::Full);
+}
+
+TEST_F(DigitizerSourceTest, ZeroBatchSizeIsClamped) {
+  source_->SetBatchSize(0);
+  EXPECT_EQ(source_->GetBatchSize(), 1u);
+}
+
+TEST_F(DigitizerSourceTest, ZeroBatchTimeoutIsClamped) {
+  source_->SetBatchTimeoutMs(0);
+  EXPECT_EQ(source_->GetBatchTimeoutMs(), 1u);
+}
+
+TEST_F(DigitizerSourceTest, StatusReportsQueueCapacity) {
+  source_->SetMaxQueueEvents(500);
+
+  auto status = source_->GetStatus();
+  EXPECT_EQ(status.metrics.queue_max, 500u);
+  EXPECT_EQ(status.metrics.queue_size, 0u);
+}
+
+class DigitizerSourceBatchTest
+    : public DigitizerSourceTest,
+      public ::testing::WithParamInterface<DigitizerSourceDataMode> {};
+
+TEST_P(DigitizerSourceBatchTest, HardwareEventsAreSentInBatches) {
+  const std::string address = "tcp://127.0.0.1:25626";
+  constexpr size_t kTotal = 1000;
+  constexpr size_t kBatch = 256;
+  constexpr uint32_t kTimeoutMs = 20;
+
+  source_->SetDigitizer(std::make_unique<FakeDigitizer>(kTotal, 100));
+  source_->SetOutputAddresses({address});
+  source_->SetDataMode(GetParam());
+  source_->SetBatchSize(kBatch);
+  source_->SetBatchTimeoutMs(kTimeoutMs);
+  ASSERT_TRUE(source_->Initialize(""));
+  ASSERT_TRUE(source_->Arm());
+
+  Net::ZMQTransport receiver;
+  Net::TransportConfig config;
+  config.data_address = address;
+  config.status_address = "";
+  config.command_address = "";
+  config.bind_data = false;
+  config.data_pattern = "PULL";
+  ASSERT_TRUE(receiver.Configure(config));
+  ASSERT_TRUE(receiver.Connect());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  ASSERT_TRUE(source_->Start(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_TRUE(source_->Stop(true));
+
+  Net::DataProcessor processor;
+  size_t received = 0;
+  bool sawEOS = false;
+  while (!sawEOS) {
+    auto data = receiver.ReceiveBytes();
+    ASSERT_NE(data, nullptr);
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      sawEOS = true;
+      break;
+    }
+    size_t n = 0;
+    if (GetParam() == DigitizerSourceDataMode::Minimal) {
+      auto [events, seq] = processor.DecodeMinimal(data);
+      ASSERT_NE(events, nullptr);
+      n = events->size();
+    } else {
+      auto [events, seq] = processor.Decode(data);
+      ASSERT_NE(events, nullptr);
+      n = events->size();
+    }
+    EXPECT_LE(n, kBatch);
+    received += n;
+  }
+
+  EXPECT_EQ(received, kTotal);
+  auto status = source_->GetStatus();
+  EXPECT_EQ(status.metrics.events_processed, kTotal);
+  EXPECT_EQ(status.metrics.queue_size, 0u);
+  // The last, partial batch waits out the batch timeout; nothing should
+  // wait much longer than that
+  EXPECT_GT(status.metrics.drain_latency_us, 0.0);
+  EXPECT_LT(status.metrics.drain_latency_us, 5 * kTimeoutMs * 1000.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(DataModes, DigitizerSourceBatchTest,
+                         ::testing::Values(DigitizerSourceDataMode::Full,
+                                           DigitizerSourceDataMode::Minimal));
+
 } // namespace test
 } // namespace DELILA
@@ -306,6 +306,27 @@ TEST_F(EmulatorTest, WaveformSizeOnlyUsedInFullMode) {
   EXPECT_EQ(emulator_->GetWaveformSize(), 1024);
 }
 
+TEST_F(EmulatorTest, CanSetBatchSize) {
+  emulator_->SetBatchSize(64);
+  EXPECT_EQ(emulator_->GetBatchSize(), 64);
+}
+
+TEST_F(EmulatorTest, CanSetRetransmitAddress) {
+  EXPECT_TRUE(emulator_->GetRetransmitAddress().empty());  // Off by default
+  emulator_->SetRetransmitAddress("tcp://*:5565");
+  emulator_->SetReplayBufferSize(128);
+  EXPECT_EQ(emulator_->GetRetransmitAddress(), "tcp://*:5565");
+  EXPECT_EQ(emulator_->GetReplayBufferSize(), 128);
+}
+
+TEST_F(EmulatorTest, CanSetSpillDirectory) {
+  EXPECT_TRUE(emulator_->GetSpillDirectory().empty());  // Off by default
+  emulator_->SetSpillDirectory("/data/spill");
+  emulator_->SetSpillCapacity(1 << 20);
+  EXPECT_EQ(emulator_->GetSpillDirectory(), "/data/spill");
+  EXPECT_EQ(emulator_->GetSpillCapacity(), 1u << 20);
+}
+
 // === Default Values Tests ===
 
 TEST_F(EmulatorTest, DefaultNumChannelsIs16) {
@@ -316,6 +337,10 @@ TEST_F(EmulatorTest, DefaultEventRateIs1000) {
   EXPECT_EQ(emulator_->GetEventRate(), 1000);
 }
 
+TEST_F(EmulatorTest, DefaultBatchSizeIs1) {
+  EXPECT_EQ(emulator_->GetBatchSize(), 1);
+}
+
 TEST_F(EmulatorTest, DefaultEnergyRangeIs0To16383) {
   auto [min, max] = emulator_->GetEnergyRange();
   EXPECT_EQ(min, 0);
@@ -0,0 +1,153 @@
+/**
+ * @file test_event_builder.cpp
+ * @brief Unit tests for EventBuilder component
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "EventBuilder.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+class EventBuilderTest : public ::testing::Test {
+ protected:
+  void SetUp() override { builder_ = std::make_unique<EventBuilder>(); }
+
+  void TearDown() override {
+    if (builder_) {
+      builder_->Shutdown();
+    }
+  }
+
+  std::unique_ptr<EventBuilder> builder_;
+};
+
+// === Configuration Tests ===
+
+TEST_F(EventBuilderTest, DefaultConfiguration) {
+  EXPECT_DOUBLE_EQ(builder_->GetPreWindowNs(), 500.0);
+  EXPECT_DOUBLE_EQ(builder_->GetPostWindowNs(), 500.0);
+  EXPECT_TRUE(builder_->GetTriggerChannels().empty());
+  EXPECT_EQ(builder_->GetMinHits(), 1u);
+  EXPECT_EQ(builder_->GetWorkerThreads(), 1u);
+  EXPECT_DOUBLE_EQ(builder_->GetReorderWindowNs(), 0.0);
+  EXPECT_EQ(builder_->GetQueueSize(), 0);
+}
+
+TEST_F(EventBuilderTest, ConfigurationIsClamped) {
+  builder_->SetCoincidenceWindow(-10.0, 250.0);
+  builder_->SetMinHits(0);
+  builder_->SetWorkerThreads(0);
+  builder_->SetTriggerChannels({{0, 0}, {1, 15}});
+
+  EXPECT_DOUBLE_EQ(builder_->GetPreWindowNs(), 0.0);
+  EXPECT_DOUBLE_EQ(builder_->GetPostWindowNs(), 250.0);
+  EXPECT_EQ(builder_->GetMinHits(), 1u);
+  EXPECT_EQ(builder_->GetWorkerThreads(), 1u);
+  EXPECT_EQ(builder_->GetTriggerChannels().size(), 2u);
+}
+
+// === Building Tests ===
+
+// Two modules stream hits; module 0 channel 0 triggers and module 1
+// answers 20 ns later. Every trigger must come out as one 2-hit event,
+// in time order, whatever the number of workers.
+TEST_F(EventBuilderTest, BuildsCoincidencesAcrossInputs) {
+  constexpr int kFrames = 50;
+  constexpr int kHitsPerFrame = 100;
+
+  std::vector<std::unique_ptr<Net::ZMQTransport>> sources;
+  for (int i = 0; i < 2; ++i) {
+    auto source = std::make_unique<Net::ZMQTransport>();
+    Net::TransportConfig config;
+    config.data_address = "inproc://event_builder_test_in" + std::to_string(i);
+    config.bind_data = true;
+    config.data_pattern = "PUSH";
+    config.status_address = config.data_address;
+    config.command_address = "";
+    ASSERT_TRUE(source->Configure(config));
+    ASSERT_TRUE(source->Connect());
+    sources.push_back(std::move(source));
+  }
+
+  builder_->SetInputAddresses(
+      {"inproc://event_builder_test_in0", "inproc://event_builder_test_in1"});
+  builder_->SetOutputAddresses({"inproc://event_builder_test_out"});
+  builder_->SetCoincidenceWindow(100.0, 100.0);
+  builder_->SetTriggerChannels({{0, 0}});
+  builder_->SetWorkerThreads(3);
+  builder_->SetSliceNs(10000.0);
+  ASSERT_TRUE(builder_->Initialize(""));
+  ASSERT_TRUE(builder_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://event_builder_test_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(builder_->Start(1));
+
+  Net::DataProcessor processor;
+  for (int f = 0; f < kFrames; ++f) {
+    for (int m = 0; m < 2; ++m) {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+      for (int h = 0; h < kHitsPerFrame; ++h) {
+        double t = 1000.0 * (f * kHitsPerFrame + h) + 20.0 * m;
+        events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+            m, 0, t, 100, 50, 0));
+      }
+      auto frame = processor.Process(events, f);
+      ASSERT_TRUE(sources[m]->SendBytes(frame));
+    }
+  }
+  for (auto &source : sources) {
+    auto eos = processor.CreateEOSMessage();
+    ASSERT_TRUE(source->SendBytes(eos));
+  }
+
+  size_t events = 0;
+  double lastTrigger = -1.0;
+  bool eos = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!eos && std::chrono::steady_clock::now() < deadline) {
+    auto data = sink.ReceiveBytes();
+    if (!data) {
+      continue;
+    }
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      eos = true;
+      break;
+    }
+    auto [built, sequence] = processor.DecodeBuilt(data);
+    ASSERT_NE(built, nullptr);
+    for (const auto &event : *built) {
+      ASSERT_EQ(event->GetMultiplicity(), 2u);
+      EXPECT_EQ(event->GetTrigger().module, 0);
+      EXPECT_GT(event->GetTriggerTimeNs(), lastTrigger);
+      lastTrigger = event->GetTriggerTimeNs();
+      events++;
+    }
+  }
+
+  EXPECT_TRUE(eos);
+  EXPECT_EQ(events, static_cast<size_t>(kFrames * kHitsPerFrame));
+  EXPECT_TRUE(builder_->Stop(true));
+  EXPECT_EQ(builder_->GetStatus().metrics.events_processed,
+            static_cast<uint64_t>(kFrames * kHitsPerFrame));
+}
+
+}  // namespace test
+}  // namespace DELILA
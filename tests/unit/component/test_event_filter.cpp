@@ -0,0 +1,154 @@
+/**
+ * @file test_event_filter.cpp
+ * @brief Unit tests for EventFilter rule parsing and batch evaluation
+ */
+
+#include <gtest/gtest.h>
+
+#include "EventFilter.hpp"
+
+namespace DELILA {
+namespace test {
+
+class EventFilterTest : public ::testing::Test {
+ protected:
+  // Evaluate the current rules on the batch, return the pass vector
+  std::vector<uint8_t> Run() {
+    std::vector<uint8_t> pass;
+    passed_ = filter_.Evaluate(batch_, pass, counts_);
+    return pass;
+  }
+
+  EventFilter filter_;
+  EventFilter::Batch batch_;
+  std::vector<uint64_t> counts_;
+  size_t passed_ = 0;
+};
+
+// === Parsing ===
+
+TEST_F(EventFilterTest, AcceptsValidRules) {
+  EXPECT_TRUE(filter_.AddRule("energy >= 100"));
+  EXPECT_TRUE(filter_.AddRule("module == 2"));
+  EXPECT_TRUE(filter_.AddRule("psd > 0.25"));
+  EXPECT_TRUE(filter_.AddRule("multiplicity >= 2"));
+  EXPECT_TRUE(filter_.AddRule("flags none pileup|over_range"));
+  EXPECT_TRUE(filter_.AddRule("flags any 0x4"));
+  ASSERT_EQ(filter_.GetRuleCount(), 6u);
+  EXPECT_EQ(filter_.GetRules()[0].expression, "energy >= 100");
+  EXPECT_EQ(filter_.GetRules()[4].mask,
+            MinimalEventData::FLAG_PILEUP | MinimalEventData::FLAG_OVER_RANGE);
+}
+
+TEST_F(EventFilterTest, RejectsInvalidRules) {
+  std::string error;
+  EXPECT_FALSE(filter_.AddRule("", &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(filter_.AddRule("energy >= ", &error));
+  EXPECT_FALSE(filter_.AddRule("charge > 10", &error));
+  EXPECT_EQ(error, "unknown field");
+  EXPECT_FALSE(filter_.AddRule("energy => 10", &error));
+  EXPECT_EQ(error, "unknown operator");
+  EXPECT_FALSE(filter_.AddRule("energy > 10abc", &error));
+  EXPECT_EQ(error, "invalid number");
+  EXPECT_FALSE(filter_.AddRule("energy > 10 extra"));
+  EXPECT_FALSE(filter_.AddRule("flags > 1"));
+  EXPECT_FALSE(filter_.AddRule("flags none bogus"));
+  EXPECT_FALSE(filter_.AddRule("flags any 0"));
+  EXPECT_EQ(filter_.GetRuleCount(), 0u);
+}
+
+// === Evaluation ===
+
+TEST_F(EventFilterTest, NoRulesPassesEverything) {
+  batch_.Add(0, 0, 10, 5, 0);
+  batch_.Add(1, 1, 20, 5, 0);
+  auto pass = Run();
+  EXPECT_EQ(passed_, 2u);
+  EXPECT_EQ(pass, (std::vector<uint8_t>{1, 1}));
+}
+
+TEST_F(EventFilterTest, ComparisonOperators) {
+  for (uint16_t e : {99, 100, 101}) {
+    batch_.Add(0, 0, e, 0, 0);
+  }
+
+  struct Case {
+    const char *rule;
+    std::vector<uint8_t> expected;
+  };
+  for (const auto &c : {Case{"energy < 100", {1, 0, 0}},
+                        Case{"energy <= 100", {1, 1, 0}},
+                        Case{"energy > 100", {0, 0, 1}},
+                        Case{"energy >= 100", {0, 1, 1}},
+                        Case{"energy == 100", {0, 1, 0}},
+                        Case{"energy != 100", {1, 0, 1}}}) {
+    filter_.Clear();
+    counts_.clear();
+    ASSERT_TRUE(filter_.AddRule(c.rule));
+    EXPECT_EQ(Run(), c.expected) << c.rule;
+  }
+}
+
+TEST_F(EventFilterTest, FlagRules) {
+  batch_.Add(0, 0, 10, 0, 0);
+  batch_.Add(0, 0, 10, 0, MinimalEventData::FLAG_PILEUP);
+  batch_.Add(0, 0, 10, 0, MinimalEventData::FLAG_OVER_RANGE);
+
+  ASSERT_TRUE(filter_.AddRule("flags none pileup"));
+  EXPECT_EQ(Run(), (std::vector<uint8_t>{1, 0, 1}));
+
+  filter_.Clear();
+  ASSERT_TRUE(filter_.AddRule("flags any pileup|over_range"));
+  EXPECT_EQ(Run(), (std::vector<uint8_t>{0, 1, 1}));
+}
+
+TEST_F(EventFilterTest, PsdAndMultiplicity) {
+  batch_.Add(0, 0, 100, 90, 0, 1);  // psd 0.1
+  batch_.Add(0, 0, 100, 50, 0, 3);  // psd 0.5
+  batch_.Add(0, 0, 0, 0, 0, 2);     // psd 0 (zero energy)
+
+  ASSERT_TRUE(filter_.AddRule("psd > 0.3"));
+  EXPECT_EQ(Run(), (std::vector<uint8_t>{0, 1, 0}));
+
+  filter_.Clear();
+  ASSERT_TRUE(filter_.AddRule("multiplicity >= 2"));
+  EXPECT_EQ(Run(), (std::vector<uint8_t>{0, 1, 1}));
+}
+
+TEST_F(EventFilterTest, RulesAreAndedAndCountedSeparately) {
+  batch_.Add(0, 0, 50, 0, 0);
+  batch_.Add(0, 1, 150, 0, 0);
+  batch_.Add(1, 0, 150, 0, MinimalEventData::FLAG_PILEUP);
+  batch_.Add(1, 1, 250, 0, 0);
+
+  ASSERT_TRUE(filter_.AddRule("energy >= 100"));
+  ASSERT_TRUE(filter_.AddRule("flags none pileup"));
+  ASSERT_TRUE(filter_.AddRule("module == 1"));
+
+  auto pass = Run();
+  EXPECT_EQ(pass, (std::vector<uint8_t>{0, 0, 0, 1}));
+  EXPECT_EQ(passed_, 1u);
+  EXPECT_EQ(counts_, (std::vector<uint64_t>{3, 3, 2}));
+
+  // Counts accumulate across batches
+  Run();
+  EXPECT_EQ(counts_, (std::vector<uint64_t>{6, 6, 4}));
+}
+
+TEST_F(EventFilterTest, BatchFromMinimalEvent) {
+  MinimalEventData hit(3, 7, 1000.0, 400, 100, MinimalEventData::FLAG_PILEUP);
+  batch_.Add(hit);
+  ASSERT_EQ(batch_.Size(), 1u);
+  EXPECT_FLOAT_EQ(batch_.module[0], 3.0f);
+  EXPECT_FLOAT_EQ(batch_.channel[0], 7.0f);
+  EXPECT_FLOAT_EQ(batch_.psd[0], 0.75f);
+  EXPECT_FLOAT_EQ(batch_.multiplicity[0], 1.0f);
+  EXPECT_EQ(batch_.flags[0], MinimalEventData::FLAG_PILEUP);
+
+  batch_.Clear();
+  EXPECT_EQ(batch_.Size(), 0u);
+}
+
+}  // namespace test
+}  // namespace DELILA
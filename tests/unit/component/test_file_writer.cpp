@@ -201,6 +201,46 @@ TEST_F(FileWriterTest, CreatesFileOnStart) {
   writer_->Stop(true);
 }
 
+TEST_F(FileWriterTest, ManifestIsWrittenOnStopWhenEnabled) {
+  EXPECT_FALSE(writer_->GetWriteManifest());
+  EXPECT_TRUE(writer_->GetManifestPath().empty());
+
+  writer_->SetInputAddresses({"tcp://localhost:5555"});
+  writer_->SetOutputPath(test_dir_.string());
+  writer_->SetFilePrefix("test_");
+  writer_->SetWriteManifest(true);
+  writer_->Initialize("");
+  writer_->Arm();
+  writer_->Start(42);
+
+  auto manifest = test_dir_ / "test_000042.manifest.json";
+  EXPECT_EQ(std::filesystem::path(writer_->GetManifestPath()), manifest);
+  EXPECT_FALSE(std::filesystem::exists(manifest));  // Only complete files
+
+  writer_->Stop(true);
+  EXPECT_TRUE(std::filesystem::exists(manifest));
+}
+
+TEST_F(FileWriterTest, RetransmitChannelConnectsWhenArmed) {
+  EXPECT_TRUE(writer_->GetRetransmitAddress().empty());  // Off by default
+  EXPECT_EQ(writer_->GetRetransmitTimeoutMs(), 5000u);
+
+  writer_->SetInputAddresses({"tcp://localhost:5555"});
+  writer_->SetOutputPath(test_dir_.string());
+  writer_->SetRetransmitAddress("tcp://localhost:5565");
+  writer_->SetRetransmitTimeoutMs(1000);
+  writer_->Initialize("");
+  EXPECT_TRUE(writer_->Arm());
+  EXPECT_TRUE(writer_->Start(1));
+
+  // Nothing received: nothing to recover
+  EXPECT_TRUE(writer_->Stop(true));
+  EXPECT_EQ(writer_->GetFramesRecovered(), 0u);
+  EXPECT_EQ(writer_->GetFramesLost(), 0u);
+  EXPECT_EQ(writer_->GetRetransmitRequests(), 0u);
+  EXPECT_EQ(writer_->GetRecoveryLatency().GetCount(), 0u);
+}
+
 // === Graceful vs Emergency Stop Tests ===
 
 TEST_F(FileWriterTest, GracefulStopFlushesData) {
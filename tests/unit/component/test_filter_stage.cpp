@@ -0,0 +1,307 @@
+/**
+ * @file test_filter_stage.cpp
+ * @brief Unit tests for FilterStage component
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "FilterStage.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+class FilterStageTest : public ::testing::Test {
+ protected:
+  void SetUp() override { filter_ = std::make_unique<FilterStage>(); }
+
+  void TearDown() override {
+    if (filter_) {
+      filter_->Shutdown();
+    }
+  }
+
+  std::unique_ptr<FilterStage> filter_;
+};
+
+// === Initial State Tests ===
+
+TEST_F(FilterStageTest, InitialDefaults) {
+  EXPECT_TRUE(filter_->GetRules().empty());
+  EXPECT_EQ(filter_->GetEventsReceived(), 0u);
+}
+
+// === Configuration Tests ===
+
+TEST_F(FilterStageTest, AddAndClearRules) {
+  std::string error;
+  EXPECT_TRUE(filter_->AddRule("energy >= 100"));
+  EXPECT_FALSE(filter_->AddRule("energy >>= 100", &error));
+  EXPECT_FALSE(error.empty());
+  ASSERT_EQ(filter_->GetRules().size(), 1u);
+  EXPECT_EQ(filter_->GetRules()[0], "energy >= 100");
+
+  filter_->ClearRules();
+  EXPECT_TRUE(filter_->GetRules().empty());
+}
+
+TEST_F(FilterStageTest, RulesAreFixedWhileRunning) {
+  filter_->SetInputAddresses({"tcp://localhost:5555"});
+  filter_->SetOutputAddresses({"tcp://localhost:6666"});
+  ASSERT_TRUE(filter_->AddRule("energy > 10"));
+
+  ASSERT_TRUE(filter_->Initialize(""));
+  ASSERT_TRUE(filter_->Arm());
+  ASSERT_TRUE(filter_->Start(3));
+
+  EXPECT_FALSE(filter_->AddRule("energy < 1000"));
+  filter_->ClearRules();
+  EXPECT_EQ(filter_->GetRules().size(), 1u);
+  EXPECT_EQ(filter_->GetRuleCounts().size(), 1u);
+  EXPECT_TRUE(filter_->Stop(true));
+}
+
+// === Filtering Tests ===
+
+// Every fourth hit is above threshold and every tenth is piled up; only
+// clean high-energy hits must reach the sink, followed by EOS.
+TEST_F(FilterStageTest, ForwardsOnlyPassingEvents) {
+  constexpr int kFrames = 20;
+  constexpr int kHitsPerFrame = 100;
+
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://filter_stage_test_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  filter_->SetInputAddresses({"inproc://filter_stage_test_in"});
+  filter_->SetOutputAddresses({"inproc://filter_stage_test_out"});
+  ASSERT_TRUE(filter_->AddRule("energy >= 1000"));
+  ASSERT_TRUE(filter_->AddRule("flags none pileup"));
+  ASSERT_TRUE(filter_->Initialize(""));
+  ASSERT_TRUE(filter_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://filter_stage_test_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(filter_->Start(1));
+
+  Net::DataProcessor processor;
+  uint64_t expected = 0;
+  uint64_t highEnergy = 0;
+  uint64_t clean = 0;
+  for (int f = 0; f < kFrames; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+    for (int h = 0; h < kHitsPerFrame; ++h) {
+      int n = f * kHitsPerFrame + h;
+      uint16_t energy = (n % 4 == 0) ? 2000 : 100;
+      uint64_t flags = (n % 10 == 0) ? Digitizer::MinimalEventData::FLAG_PILEUP
+                                     : 0;
+      highEnergy += (energy >= 1000);
+      clean += (flags == 0);
+      expected += (energy >= 1000 && flags == 0);
+      events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+          0, h % 16, 10.0 * n, energy, 50, flags));
+    }
+    auto frame = processor.Process(events, f);
+    ASSERT_TRUE(source.SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source.SendBytes(eos));
+
+  uint64_t received = 0;
+  double lastTime = -1.0;
+  bool gotEos = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+    auto data = sink.ReceiveBytes();
+    if (!data) {
+      continue;
+    }
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      gotEos = true;
+      break;
+    }
+    auto [events, sequence] = processor.DecodeMinimal(data);
+    ASSERT_NE(events, nullptr);
+    for (const auto &event : *events) {
+      EXPECT_GE(event->energy, 1000);
+      EXPECT_EQ(event->flags & Digitizer::MinimalEventData::FLAG_PILEUP, 0u);
+      EXPECT_GT(event->timeStampNs, lastTime);
+      lastTime = event->timeStampNs;
+      received++;
+    }
+  }
+
+  EXPECT_TRUE(gotEos);
+  EXPECT_EQ(received, expected);
+  EXPECT_TRUE(filter_->Stop(true));
+  EXPECT_EQ(filter_->GetStatus().metrics.events_processed, expected);
+  EXPECT_EQ(filter_->GetEventsReceived(),
+            static_cast<uint64_t>(kFrames * kHitsPerFrame));
+  EXPECT_EQ(filter_->GetRuleCounts(),
+            (std::vector<uint64_t>{highEnergy, clean}));
+}
+
+// Calibrated frames have no filter rules; they must pass unchanged and
+// renumbered into the filter's own sequence.
+TEST_F(FilterStageTest, ForwardsOtherFormatsUnchanged) {
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://filter_stage_test_other_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  filter_->SetInputAddresses({"inproc://filter_stage_test_other_in"});
+  filter_->SetOutputAddresses({"inproc://filter_stage_test_other_out"});
+  ASSERT_TRUE(filter_->AddRule("energy >= 1000"));
+  ASSERT_TRUE(filter_->Initialize(""));
+  ASSERT_TRUE(filter_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://filter_stage_test_other_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(filter_->Start(1));
+
+  Net::DataProcessor processor;
+  auto events = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::CalibratedEventData>>>();
+  for (int h = 0; h < 10; ++h) {
+    events->push_back(std::make_unique<Digitizer::CalibratedEventData>(
+        0, h, 100, 12.5f, 3.0f, 10.0 * h, 0));
+  }
+  auto frame = processor.Process(events, 41);
+  ASSERT_TRUE(frame);
+  const std::vector<uint8_t> sent = *frame;
+  ASSERT_TRUE(source.SendBytes(frame));
+
+  std::unique_ptr<std::vector<uint8_t>> data;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!data && std::chrono::steady_clock::now() < deadline) {
+    data = sink.ReceiveBytes();
+  }
+  ASSERT_NE(data, nullptr);
+
+  Net::BinaryDataHeader header;
+  ASSERT_TRUE(Net::DataProcessor::PeekHeader(*data, header));
+  EXPECT_EQ(header.format_version, Net::FORMAT_VERSION_CALIBRATED_EVENTDATA);
+  EXPECT_EQ(header.sequence_number, 0u);
+  ASSERT_EQ(data->size(), sent.size());
+  EXPECT_TRUE(std::equal(data->begin() + Net::BINARY_DATA_HEADER_SIZE,
+                         data->end(),
+                         sent.begin() + Net::BINARY_DATA_HEADER_SIZE));
+  auto [decoded, sequence] = processor.DecodeCalibrated(data);
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_EQ(decoded->size(), 10u);
+
+  EXPECT_TRUE(filter_->Stop(true));
+  EXPECT_EQ(filter_->GetStatus().metrics.events_processed, 10u);
+}
+
+// Frames from a merger keep their source id and flags; the merge sequence
+// is renumbered with the frame, so the filter's output stays one gap-free
+// stream when frames are dropped.
+TEST_F(FilterStageTest, KeepsMergerStamps) {
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://filter_stage_test_stamp_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  filter_->SetInputAddresses({"inproc://filter_stage_test_stamp_in"});
+  filter_->SetOutputAddresses({"inproc://filter_stage_test_stamp_out"});
+  ASSERT_TRUE(filter_->AddRule("energy >= 1000"));
+  ASSERT_TRUE(filter_->Initialize(""));
+  ASSERT_TRUE(filter_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://filter_stage_test_stamp_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(filter_->Start(1));
+
+  // Merged frames 100-103 of sources 1 and 2; 101 has no passing event
+  Net::DataProcessor processor;
+  std::vector<uint64_t> timestamps;
+  for (int f = 0; f < 4; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+    events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+        0, 0, 10.0 * f, f == 1 ? 10 : 2000, 0, 0));
+    auto frame = processor.Process(events, f / 2);
+    ASSERT_TRUE(frame);
+    ASSERT_TRUE(Net::DataProcessor::SetSourceId(*frame, 1 + f % 2));
+    ASSERT_TRUE(Net::DataProcessor::SetMergeSequence(*frame, 100 + f));
+    ASSERT_TRUE(Net::DataProcessor::SetFrameFlags(*frame, 0x80));
+    Net::BinaryDataHeader sent;
+    ASSERT_TRUE(Net::DataProcessor::PeekHeader(*frame, sent));
+    if (f != 1) {
+      timestamps.push_back(sent.timestamp);
+    }
+    ASSERT_TRUE(source.SendBytes(frame));
+  }
+
+  const uint8_t expectedSources[] = {1, 1, 2};
+  for (uint64_t i = 0; i < 3; ++i) {
+    std::unique_ptr<std::vector<uint8_t>> data;
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!data && std::chrono::steady_clock::now() < deadline) {
+      data = sink.ReceiveBytes();
+    }
+    ASSERT_NE(data, nullptr);
+
+    Net::BinaryDataHeader header;
+    ASSERT_TRUE(Net::DataProcessor::PeekHeader(*data, header));
+    EXPECT_EQ(header.sequence_number, i);
+    EXPECT_EQ(Net::DataProcessor::GetMergeSequence(header), i);
+    EXPECT_EQ(header.source_id, expectedSources[i]);
+    EXPECT_EQ(header.frame_flags, 0x80u);
+    EXPECT_EQ(header.timestamp, timestamps[i]);
+  }
+
+  EXPECT_TRUE(filter_->Stop(true));
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -0,0 +1,246 @@
+/**
+ * @file test_histogram_shard.cpp
+ * @brief Unit tests for the MonitorROOT fill accumulator
+ *
+ * Bin numbers are checked against ROOT's fixed-width binning formula,
+ * bin = 1 + int(nbins * (x - min) / (max - min)), so a fold with
+ * AddBinContent reproduces what TH1::Fill would have produced.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "HistogramShard.hpp"
+#include "delila/core/EventData.hpp"
+#include "delila/core/MinimalEventData.hpp"
+
+namespace DELILA {
+namespace test {
+
+using Digitizer::EventData;
+using Digitizer::MinimalEventData;
+using Histogram = HistogramShard::Histogram;
+
+namespace {
+
+std::unique_ptr<MinimalEventData> MakeEvent(uint8_t module, uint8_t channel,
+                                            uint16_t energy,
+                                            double timestamp = 0.0) {
+  return std::make_unique<MinimalEventData>(module, channel, timestamp, energy,
+                                            0, 0);
+}
+
+/// ROOT TAxis::FindFixBin for a fixed-width axis
+int RootBin(double x, int nbins, double min, double max) {
+  if (x < min) return 0;
+  if (x >= max) return nbins + 1;
+  return 1 + static_cast<int>(nbins * (x - min) / (max - min));
+}
+
+HistogramShard::Layout FullLayout() {
+  HistogramShard::Layout layout;
+  layout.timing = true;
+  layout.two_d = true;
+  return layout;
+}
+
+}  // namespace
+
+TEST(HistogramShardTest, DefaultLayoutMatchesMonitorDefaults) {
+  HistogramShard shard;
+
+  EXPECT_TRUE(shard.IsEnabled(Histogram::Energy));
+  EXPECT_TRUE(shard.IsEnabled(Histogram::Channel));
+  EXPECT_TRUE(shard.IsEnabled(Histogram::Module));
+  EXPECT_FALSE(shard.IsEnabled(Histogram::TimeDiff));
+  EXPECT_FALSE(shard.IsEnabled(Histogram::EnergyVsChannel));
+  EXPECT_EQ(shard.Bins(Histogram::Energy).size(),
+            HistogramShard::kEnergyBins + 2);
+}
+
+TEST(HistogramShardTest, OneDimensionalBinsIncludeUnderAndOverflow) {
+  HistogramShard shard;
+  std::vector<std::unique_ptr<MinimalEventData>> events;
+  events.push_back(MakeEvent(0, 0, 0));
+  events.push_back(MakeEvent(3, 63, 16383));
+  events.push_back(MakeEvent(16, 64, 16384));
+  events.push_back(MakeEvent(255, 255, 65535));
+
+  shard.Fill(events);
+
+  const auto& energy = shard.Bins(Histogram::Energy);
+  EXPECT_EQ(energy[1], 1u);
+  EXPECT_EQ(energy[16384], 1u);
+  EXPECT_EQ(energy[16385], 2u);  // overflow
+
+  const auto& channel = shard.Bins(Histogram::Channel);
+  EXPECT_EQ(channel[1], 1u);
+  EXPECT_EQ(channel[64], 1u);
+  EXPECT_EQ(channel[65], 2u);
+
+  const auto& module = shard.Bins(Histogram::Module);
+  EXPECT_EQ(module[1], 1u);
+  EXPECT_EQ(module[4], 1u);
+  EXPECT_EQ(module[17], 2u);
+
+  EXPECT_EQ(shard.Entries(Histogram::Energy), 4u);
+  EXPECT_EQ(shard.GetEventCount(), 4u);
+}
+
+TEST(HistogramShardTest, TwoDimensionalBinsUseRootGlobalNumbering) {
+  HistogramShard shard(FullLayout());
+  std::vector<std::unique_ptr<MinimalEventData>> events;
+  events.push_back(MakeEvent(2, 3, 100));
+
+  shard.Fill(events);
+
+  // binx = 3 + 1, biny = 100 / 16 + 1, global = binx + (64 + 2) * biny
+  const auto& bins = shard.Bins(Histogram::EnergyVsChannel);
+  EXPECT_EQ(bins[4 + 66 * 7], 1u);
+
+  const auto& moduleBins = shard.Bins(Histogram::EnergyVsModule);
+  EXPECT_EQ(moduleBins[3 + 18 * 7], 1u);
+}
+
+TEST(HistogramShardTest, MatchesRootBinningForRandomEvents) {
+  HistogramShard shard(FullLayout());
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> energy(0, 20000);
+  std::uniform_int_distribution<int> channel(0, 70);
+  std::uniform_int_distribution<int> module(0, 20);
+
+  // More than one internal block, with a ragged tail
+  std::vector<std::unique_ptr<MinimalEventData>> events;
+  for (int i = 0; i < 1000; ++i) {
+    events.push_back(MakeEvent(module(rng), channel(rng), energy(rng)));
+  }
+  shard.Fill(events);
+
+  std::vector<uint32_t> energyRef(HistogramShard::kEnergyBins + 2, 0);
+  std::vector<uint32_t> twoDRef(66 * 1026, 0);
+  for (const auto& e : events) {
+    energyRef[RootBin(e->energy, 16384, 0, 16384)]++;
+    int binX = RootBin(e->channel, 64, 0, 64);
+    int binY = RootBin(e->energy, 1024, 0, 16384);
+    twoDRef[binX + 66 * binY]++;
+  }
+
+  EXPECT_EQ(shard.Bins(Histogram::Energy), energyRef);
+  EXPECT_EQ(shard.Bins(Histogram::EnergyVsChannel), twoDRef);
+}
+
+TEST(HistogramShardTest, TimeDifferenceCarriesAcrossFills) {
+  HistogramShard shard(FullLayout());
+  std::vector<std::unique_ptr<MinimalEventData>> first;
+  first.push_back(MakeEvent(0, 0, 0, 1000.0));
+  first.push_back(MakeEvent(0, 0, 0, 6500.0));  // +5.5 us
+  shard.Fill(first);
+
+  std::vector<std::unique_ptr<MinimalEventData>> second;
+  second.push_back(MakeEvent(0, 0, 0, 2006500.0));  // +2000 us
+  second.push_back(MakeEvent(0, 0, 0, 2006000.0));  // negative
+  shard.Fill(second);
+
+  const auto& bins = shard.Bins(Histogram::TimeDiff);
+  EXPECT_EQ(bins[RootBin(5.5, 1000, 0, 1000)], 1u);
+  EXPECT_EQ(bins[1001], 1u);  // overflow
+  EXPECT_EQ(bins[0], 1u);     // underflow
+  // The first event of the run has no reference
+  EXPECT_EQ(shard.Entries(Histogram::TimeDiff), 3u);
+}
+
+TEST(HistogramShardTest, ClearCountsKeepsTimeReference) {
+  HistogramShard shard(FullLayout());
+  std::vector<std::unique_ptr<MinimalEventData>> events;
+  events.push_back(MakeEvent(0, 1, 10, 1000.0));
+  shard.Fill(events);
+
+  shard.ClearCounts();
+  EXPECT_EQ(shard.GetEventCount(), 0u);
+  EXPECT_EQ(shard.Bins(Histogram::Channel)[2], 0u);
+
+  events.clear();
+  events.push_back(MakeEvent(0, 1, 10, 3000.0));
+  shard.Fill(events);
+  EXPECT_EQ(shard.Bins(Histogram::TimeDiff)[RootBin(2.0, 1000, 0, 1000)], 1u);
+
+  shard.Reset();
+  events.clear();
+  events.push_back(MakeEvent(0, 1, 10, 5000.0));
+  shard.Fill(events);
+  EXPECT_EQ(shard.Entries(Histogram::TimeDiff), 0u);
+}
+
+TEST(HistogramShardTest, BreakTimeSequenceSkipsFrameBoundary) {
+  HistogramShard shard(FullLayout());
+  std::vector<std::unique_ptr<MinimalEventData>> events;
+  events.push_back(MakeEvent(0, 0, 0, 1000.0));
+  events.push_back(MakeEvent(0, 0, 0, 2000.0));
+  shard.Fill(events);
+
+  shard.BreakTimeSequence();
+  shard.Fill(events);
+
+  // One difference per frame; none across the break
+  EXPECT_EQ(shard.Entries(Histogram::TimeDiff), 2u);
+}
+
+TEST(HistogramShardTest, FillTimeDifferenceJoinsFrames) {
+  HistogramShard shard(FullLayout());
+  shard.FillTimeDifference(1000.0, 4000.0);  // +3 us
+  shard.FillTimeDifference(0.0, 4000.0);     // No previous event
+  EXPECT_EQ(shard.Bins(Histogram::TimeDiff)[RootBin(3.0, 1000, 0, 1000)], 1u);
+  EXPECT_EQ(shard.Entries(Histogram::TimeDiff), 1u);
+
+  HistogramShard disabled;  // Timing off: no bins, nothing filled
+  disabled.FillTimeDifference(1000.0, 4000.0);
+  EXPECT_EQ(disabled.Entries(Histogram::TimeDiff), 0u);
+}
+
+TEST(HistogramShardTest, MergeAddsCounts) {
+  HistogramShard a, b;
+  std::vector<std::unique_ptr<MinimalEventData>> events;
+  events.push_back(MakeEvent(1, 2, 300));
+  a.Fill(events);
+  b.Fill(events);
+  b.Fill(events);
+
+  a.Merge(b);
+
+  EXPECT_EQ(a.Bins(Histogram::Energy)[301], 3u);
+  EXPECT_EQ(a.Entries(Histogram::Channel), 3u);
+  EXPECT_EQ(a.GetEventCount(), 3u);
+}
+
+TEST(HistogramShardTest, KeepsLatestWaveformOfSelectedChannel) {
+  HistogramShard::Layout layout;
+  layout.waveform = true;
+  layout.waveform_module = 1;
+  layout.waveform_channel = 5;
+  HistogramShard shard(layout);
+
+  std::vector<std::unique_ptr<EventData>> events;
+  for (int i = 0; i < 3; ++i) {
+    auto event = std::make_unique<EventData>(4);
+    event->module = 1;
+    event->channel = (i == 1) ? 6 : 5;
+    event->energy = 100;
+    event->analogProbe1.assign(4, i);
+    events.push_back(std::move(event));
+  }
+
+  shard.Fill(events);
+
+  ASSERT_TRUE(shard.HasWaveform());
+  EXPECT_EQ(shard.GetWaveform(), std::vector<int32_t>(4, 2));
+  EXPECT_EQ(shard.Bins(Histogram::Energy)[101], 3u);
+
+  shard.ClearCounts();
+  EXPECT_FALSE(shard.HasWaveform());
+}
+
+}  // namespace test
+}  // namespace DELILA
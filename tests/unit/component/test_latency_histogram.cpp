@@ -0,0 +1,190 @@
+/**
+ * @file test_latency_histogram.cpp
+ * @brief Unit tests for LatencyHistogram and LatencyRecorder
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+
+namespace DELILA {
+namespace test {
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+  LatencyHistogram histogram;
+  auto summary = histogram.GetSummary();
+
+  EXPECT_EQ(summary.count, 0u);
+  EXPECT_DOUBLE_EQ(summary.p50_us, 0.0);
+  EXPECT_DOUBLE_EQ(summary.max_us, 0.0);
+}
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndNarrow) {
+  size_t previous = 0;
+  for (uint64_t v = 1; v < (uint64_t{1} << 30); v += 1 + v / 256) {
+    size_t index = LatencyHistogram::BucketIndex(v);
+    ASSERT_LT(index, LatencyHistogram::kBucketCount);
+    ASSERT_GE(index, previous);
+    ASSERT_LE(index, previous + 1) << "gap at " << v;
+    previous = index;
+
+    // Midpoint within 1/128 of the value
+    double mid = static_cast<double>(LatencyHistogram::BucketMidpoint(index));
+    ASSERT_NEAR(mid, static_cast<double>(v), v / 128.0 + 0.5) << v;
+  }
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram histogram;
+  for (uint64_t v = 1; v <= 100; ++v) {
+    histogram.Record(v);
+  }
+
+  EXPECT_EQ(histogram.GetCount(), 100u);
+  EXPECT_EQ(histogram.GetValueAtPercentile(50.0), 50u);
+  EXPECT_EQ(histogram.GetValueAtPercentile(99.0), 99u);
+  EXPECT_EQ(histogram.GetValueAtPercentile(100.0), 100u);
+  EXPECT_EQ(histogram.GetMax(), 100u);
+}
+
+TEST(LatencyHistogramTest, PercentilesMatchSortedSamples) {
+  LatencyHistogram histogram;
+  std::mt19937_64 rng(7);
+  std::lognormal_distribution<double> dist(10.0, 1.5);  // ~22 us median
+
+  std::vector<uint64_t> samples(100000);
+  for (auto& s : samples) {
+    s = static_cast<uint64_t>(dist(rng));
+    histogram.Record(s);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  for (double p : {50.0, 99.0, 99.9}) {
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    double exact = static_cast<double>(samples[rank - 1]);
+    double reported = static_cast<double>(histogram.GetValueAtPercentile(p));
+    EXPECT_NEAR(reported, exact, exact * 0.01) << "p" << p;
+  }
+
+  auto summary = histogram.GetSummary();
+  EXPECT_EQ(summary.count, samples.size());
+  EXPECT_DOUBLE_EQ(summary.max_us, samples.back() / 1000.0);
+  EXPECT_LE(summary.p50_us, summary.p99_us);
+  EXPECT_LE(summary.p99_us, summary.p999_us);
+  EXPECT_LE(summary.p999_us, summary.max_us);
+}
+
+TEST(LatencyHistogramTest, HugeValuesAreClamped) {
+  LatencyHistogram histogram;
+  histogram.Record(UINT64_MAX);
+
+  EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX),
+            LatencyHistogram::kBucketCount - 1);
+  EXPECT_EQ(histogram.GetCount(), 1u);
+  EXPECT_EQ(histogram.GetMax(), UINT64_MAX);
+}
+
+TEST(LatencyHistogramTest, ReaderSeesProgressWhileWriterRecords) {
+  LatencyHistogram histogram;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    for (int i = 0; i < 200000; ++i) {
+      histogram.Record(1000 + i % 5000);
+    }
+    done = true;
+  });
+
+  uint64_t last = 0;
+  while (!done) {
+    uint64_t count = histogram.GetSummary().count;
+    EXPECT_GE(count, last);
+    last = count;
+  }
+  writer.join();
+  EXPECT_EQ(histogram.GetCount(), 200000u);
+}
+
+TEST(LatencyRecorderTest, RecordsThreeStages) {
+  LatencyRecorder recorder;
+  uint64_t t0 = LatencyRecorder::Now();
+
+  recorder.RecordResidency(t0, t0 + 5000);
+  recorder.RecordProcessing(t0 + 5000, t0 + 7000);
+  recorder.RecordProcessing(t0 + 7000, t0 + 6000);  // clock order clamps to 0
+
+  ComponentMetrics metrics;
+  recorder.Fill(metrics);
+  EXPECT_EQ(metrics.residency.count, 1u);
+  EXPECT_NEAR(metrics.residency.p50_us, 5.0, 0.05);
+  EXPECT_EQ(metrics.processing.count, 2u);
+  EXPECT_NEAR(metrics.processing.max_us, 2.0, 0.02);
+  EXPECT_EQ(metrics.frame_age.count, 0u);
+}
+
+TEST(LatencyRecorderTest, AgeIsMeasuredAgainstUnixTime) {
+  LatencyRecorder recorder;
+  uint64_t unixNow = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+
+  // Frame stamped 3 ms ago
+  recorder.RecordAge(unixNow - 3000000, LatencyRecorder::Now());
+  recorder.RecordAge(0, LatencyRecorder::Now());  // unstamped: ignored
+
+  auto age = recorder.Age().GetSummary();
+  EXPECT_EQ(age.count, 1u);
+  EXPECT_GT(age.p50_us, 2900.0);
+  EXPECT_LT(age.p50_us, 3500.0);
+}
+
+TEST(LatencyRecorderTest, AgeSinceMonotonicOrigin) {
+  LatencyRecorder recorder;
+  const uint64_t now = LatencyRecorder::Now();
+  recorder.RecordAgeSince(now - 2000000, now);
+
+  auto age = recorder.Age().GetSummary();
+  EXPECT_EQ(age.count, 1u);
+  EXPECT_NEAR(age.p50_us, 2000.0, 25.0);
+}
+
+TEST(LatencyRecorderTest, StrideFollowsFrameRate) {
+  LatencyRecorder recorder;
+  EXPECT_EQ(recorder.GetSampleMask(), 0u);
+
+  // 1 M frames/s: frames 1 us apart, only sampled ones are timed
+  uint64_t t = LatencyRecorder::Now();
+  for (int i = 0; i < 100000; ++i) {
+    t += 1000;
+    if (recorder.Sample()) recorder.RecordProcessing(t, t + 100);
+  }
+  uint32_t stride = recorder.GetSampleMask() + 1;
+  EXPECT_GE(stride * 1000u, LatencyRecorder::kMinSampleIntervalNs);
+  EXPECT_LE(stride * 1000u, 4 * LatencyRecorder::kMinSampleIntervalNs);
+
+  // Rate drops to 1 k frames/s: back to timing every frame
+  for (int i = 0; i < 100; ++i) {
+    t += 1000000;
+    if (recorder.Sample()) recorder.RecordProcessing(t, t + 100);
+  }
+  EXPECT_EQ(recorder.GetSampleMask(), 0u);
+}
+
+TEST(LatencyRecorderTest, ResetClearsHistograms) {
+  LatencyRecorder recorder;
+  recorder.RecordResidency(0, 1000);
+  recorder.Reset();
+
+  EXPECT_EQ(recorder.Residency().GetCount(), 0u);
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -0,0 +1,244 @@
+/**
+ * @file test_metrics_exporter.cpp
+ * @brief Unit tests for the OpenMetrics HTTP endpoint
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "MetricsExporter.hpp"
+#include "SimpleMerger.hpp"
+
+namespace DELILA {
+namespace test {
+
+namespace {
+
+class FakeComponent : public IComponent {
+public:
+  bool Initialize(const std::string &) override { return true; }
+  void Run() override {}
+  void Shutdown() override {}
+  ComponentState GetState() const override { return fStatus.state; }
+  std::string GetComponentId() const override { return fStatus.component_id; }
+  ComponentStatus GetStatus() const override { return fStatus; }
+
+  ComponentStatus fStatus{};
+
+protected:
+  bool OnConfigure(const nlohmann::json &) override { return true; }
+  bool OnArm() override { return true; }
+  bool OnStart(uint32_t) override { return true; }
+  bool OnStop(bool) override { return true; }
+  void OnReset() override {}
+};
+
+bool HaveCurl() { return std::system("command -v curl > /dev/null 2>&1") == 0; }
+
+// Body followed by a last line "<http code> <content type>"
+std::string Curl(uint16_t port, const std::string &path) {
+  std::string command = "curl -s --max-time 5 -w '\\n%{http_code} "
+                        "%{content_type}' http://127.0.0.1:" +
+                        std::to_string(port) + path;
+  std::string output;
+  FILE *pipe = popen(command.c_str(), "r");
+  if (!pipe) {
+    return output;
+  }
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+    output.append(buffer, n);
+  }
+  pclose(pipe);
+  return output;
+}
+
+bool Contains(const std::string &text, const std::string &line) {
+  return text.find(line) != std::string::npos;
+}
+
+} // namespace
+
+class MetricsExporterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    fComponent.fStatus.component_id = "merger_01";
+    fComponent.fStatus.state = ComponentState::Running;
+    fComponent.fStatus.run_number = 7;
+    fComponent.fStatus.metrics.events_processed = 123456;
+    fComponent.fStatus.metrics.bytes_transferred = 9876543210ULL;
+    fComponent.fStatus.metrics.queue_size = 12;
+    fComponent.fStatus.metrics.queue_max = 10000;
+    fComponent.fStatus.metrics.event_rate = 1.5e6;
+  fComponent.fStatus.metrics.event_rate_avg = 1.25e6;
+  fComponent.fStatus.metrics.channel_rates = {{2, 13, 250.5}};
+    fComponent.fStatus.metrics.processing.count = 500;
+    fComponent.fStatus.metrics.processing.p99_us = 250.0;
+    fComponent.fStatus.metrics.processing.max_us = 1000.0;
+  }
+
+  FakeComponent fComponent;
+};
+
+TEST_F(MetricsExporterTest, RendersComponentMetrics) {
+  MetricsExporter exporter(fComponent);
+  std::string text;
+  exporter.Render(text);
+
+  EXPECT_TRUE(Contains(text, "# TYPE delila_events_processed counter\n"));
+  EXPECT_TRUE(Contains(
+      text, "delila_events_processed_total{component=\"merger_01\"} 123456\n"));
+  EXPECT_TRUE(Contains(
+      text,
+      "delila_bytes_transferred_total{component=\"merger_01\"} 9876543210\n"));
+  EXPECT_TRUE(Contains(text, "delila_queue_size{component=\"merger_01\"} 12\n"));
+  EXPECT_TRUE(Contains(text, "delila_event_rate{component=\"merger_01\"} 1500000\n"));
+  EXPECT_TRUE(Contains(text, "delila_run_number{component=\"merger_01\"} 7\n"));
+  EXPECT_TRUE(
+      Contains(text, "delila_event_rate_avg{component=\"merger_01\"} 1250000\n"));
+  EXPECT_TRUE(Contains(text, "delila_channel_event_rate{component=\"merger_01\","
+                             "module=\"2\",channel=\"13\"} 250.5\n"));
+
+  // State as a stateset, exactly one state set
+  EXPECT_TRUE(Contains(text, "# TYPE delila_state stateset\n"));
+  EXPECT_TRUE(Contains(
+      text,
+      "delila_state{component=\"merger_01\",delila_state=\"Running\"} 1\n"));
+  EXPECT_TRUE(Contains(
+      text, "delila_state{component=\"merger_01\",delila_state=\"Idle\"} 0\n"));
+
+  // Latency summaries in seconds
+  EXPECT_TRUE(Contains(text, "# UNIT delila_frame_latency_seconds seconds\n"));
+  EXPECT_TRUE(Contains(text, "delila_frame_latency_seconds{component=\"merger_01\","
+                             "stage=\"processing\",quantile=\"0.99\"} 0.00025\n"));
+  EXPECT_TRUE(Contains(text, "delila_frame_latency_seconds_count{component="
+                             "\"merger_01\",stage=\"processing\"} 500\n"));
+  EXPECT_TRUE(Contains(text, "delila_frame_latency_max_seconds{component="
+                             "\"merger_01\",stage=\"processing\"} 0.001\n"));
+
+  ASSERT_GE(text.size(), 6u);
+  EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+TEST_F(MetricsExporterTest, EscapesLabelValues) {
+  fComponent.fStatus.component_id = "a\"b\\c\nd";
+  MetricsExporter exporter(fComponent);
+  std::string text;
+  exporter.Render(text);
+
+  EXPECT_TRUE(Contains(text, "{component=\"a\\\"b\\\\c\\nd\"}"));
+}
+
+TEST_F(MetricsExporterTest, EscapesHelpText) {
+  MetricsExporter exporter(fComponent);
+  exporter.AddCounter("rule_passed", "Events passing 'a\\b'\nnext",
+                      [] { return uint64_t{1}; });
+  std::string text;
+  exporter.Render(text);
+
+  EXPECT_TRUE(Contains(
+      text, "# HELP delila_rule_passed Events passing 'a\\\\b'\\nnext\n"));
+}
+
+TEST_F(MetricsExporterTest, RendersRegisteredCounters) {
+  uint64_t frames = 42;
+  MetricsExporter exporter(fComponent);
+  exporter.AddCounter("frames_dropped", "Frames dropped", [&] { return frames; });
+  exporter.AddGauge("pool_free", "Free buffers", [] { return 3.5; });
+
+  std::string text;
+  exporter.Render(text);
+  EXPECT_TRUE(Contains(text, "# TYPE delila_frames_dropped counter\n"));
+  EXPECT_TRUE(Contains(
+      text, "delila_frames_dropped_total{component=\"merger_01\"} 42\n"));
+  EXPECT_TRUE(Contains(text, "delila_pool_free{component=\"merger_01\"} 3.5\n"));
+
+  frames = 43;
+  exporter.Render(text);
+  EXPECT_TRUE(Contains(
+      text, "delila_frames_dropped_total{component=\"merger_01\"} 43\n"));
+}
+
+TEST_F(MetricsExporterTest, RejectsInvalidAddress) {
+  MetricsExporter exporter(fComponent);
+  EXPECT_FALSE(exporter.Start("localhost:http"));
+  EXPECT_FALSE(exporter.Start("127.0.0.1:70000"));
+  EXPECT_FALSE(exporter.IsRunning());
+}
+
+TEST_F(MetricsExporterTest, CurlScrapesMetrics) {
+  if (!HaveCurl()) {
+    GTEST_SKIP() << "curl not available";
+  }
+
+  MetricsExporter exporter(fComponent);
+  ASSERT_TRUE(exporter.Start("127.0.0.1:0"));
+  ASSERT_NE(exporter.GetPort(), 0);
+
+  std::string output = Curl(exporter.GetPort(), "/metrics");
+  EXPECT_TRUE(Contains(
+      output, "delila_events_processed_total{component=\"merger_01\"} 123456\n"));
+  EXPECT_TRUE(Contains(output, "# EOF\n\n200 "
+                               "application/openmetrics-text; version=1.0.0"));
+
+  // Each scrape sees current values
+  fComponent.fStatus.metrics.events_processed = 123457;
+  output = Curl(exporter.GetPort(), "/metrics");
+  EXPECT_TRUE(Contains(
+      output, "delila_events_processed_total{component=\"merger_01\"} 123457\n"));
+
+  output = Curl(exporter.GetPort(), "/");
+  EXPECT_TRUE(Contains(output, "\n404 "));
+
+  exporter.Stop();
+  EXPECT_FALSE(exporter.IsRunning());
+}
+
+TEST_F(MetricsExporterTest, PortIsReleasedOnStop) {
+  MetricsExporter exporter(fComponent);
+  ASSERT_TRUE(exporter.Start("127.0.0.1:0"));
+  uint16_t port = exporter.GetPort();
+  exporter.Stop();
+
+  EXPECT_TRUE(exporter.Start("127.0.0.1:" + std::to_string(port)));
+  EXPECT_EQ(exporter.GetPort(), port);
+}
+
+TEST(MetricsEndpointTest, ComponentStartsExporterOnlyWithAddress) {
+  SimpleMerger merger;
+  EXPECT_FALSE(merger.StartMetricsExporter());
+
+  merger.SetMetricsAddress("127.0.0.1:0");
+  EXPECT_EQ(merger.GetMetricsAddress(), "127.0.0.1:0");
+  EXPECT_TRUE(merger.StartMetricsExporter());
+  EXPECT_FALSE(merger.StartMetricsExporter());
+  merger.StopMetricsExporter();
+}
+
+TEST_F(MetricsExporterTest, EndpointDiscardsExporterThatFailsToBind) {
+  MetricsEndpoint endpoint;
+  EXPECT_EQ(endpoint.Prepare(fComponent), nullptr);
+
+  endpoint.SetAddress("localhost:http");
+  ASSERT_NE(endpoint.Prepare(fComponent), nullptr);
+  EXPECT_FALSE(endpoint.Start());
+  EXPECT_FALSE(endpoint.IsRunning());
+
+  endpoint.SetAddress("127.0.0.1:0");
+  MetricsExporter *exporter = endpoint.Prepare(fComponent);
+  ASSERT_NE(exporter, nullptr);
+  exporter->AddGauge("pool_free", "Free buffers", [] { return 3.5; });
+  EXPECT_TRUE(endpoint.Start());
+  EXPECT_TRUE(endpoint.IsRunning());
+  EXPECT_EQ(endpoint.Prepare(fComponent), nullptr);
+
+  endpoint.Stop();
+  EXPECT_FALSE(endpoint.IsRunning());
+}
+
+} // namespace test
+} // namespace DELILA
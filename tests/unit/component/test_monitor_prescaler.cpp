@@ -0,0 +1,180 @@
+/**
+ * @file test_monitor_prescaler.cpp
+ * @brief Unit tests for MonitorPrescaler (MonitorROOT overload handling)
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "MonitorPrescaler.hpp"
+
+namespace DELILA {
+namespace test {
+
+namespace {
+
+constexpr uint64_t kMs = 1000000;  // ns
+
+/// Simulated stream: frames sent every @c period, received after @c lag
+class FrameClock {
+ public:
+  explicit FrameClock(uint64_t offsetNs = 0) : fOffset(offsetNs) {}
+
+  MonitorPrescaler::Frame Next(uint64_t lagNs, size_t pending = 0) {
+    fSent += kMs;
+    MonitorPrescaler::Frame frame;
+    frame.header_timestamp_ns = fSent;
+    frame.event_count = 100;
+    frame.pending_bytes = pending;
+    frame.receive_time_ns = fSent + fOffset + lagNs;
+    return frame;
+  }
+
+ private:
+  uint64_t fOffset;
+  uint64_t fSent{1000 * kMs};
+};
+
+MonitorPrescaler::Config TestConfig() {
+  MonitorPrescaler::Config config;
+  config.lag_high_ms = 50.0;
+  config.lag_low_ms = 10.0;
+  config.queue_high_bytes = 1 << 20;
+  config.control_interval = std::chrono::milliseconds(10);
+  return config;
+}
+
+}  // namespace
+
+TEST(MonitorPrescalerTest, AdmitsEverythingWithoutLag) {
+  MonitorPrescaler prescaler(TestConfig());
+  FrameClock clock;
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(prescaler.Admit(clock.Next(2 * kMs)));
+  }
+  EXPECT_DOUBLE_EQ(prescaler.GetSamplingFraction(), 1.0);
+  EXPECT_FALSE(prescaler.IsSampling());
+  EXPECT_EQ(prescaler.GetEventsSeen(), 100000u);
+}
+
+TEST(MonitorPrescalerTest, ConstantClockOffsetIsNotLag) {
+  MonitorPrescaler prescaler(TestConfig());
+  FrameClock clock(10000 * kMs);  // Receiver clock 10 s ahead
+
+  for (int i = 0; i < 1000; ++i) {
+    prescaler.Admit(clock.Next(kMs));
+  }
+  EXPECT_LT(prescaler.GetLagMs(), 1.0);
+  EXPECT_DOUBLE_EQ(prescaler.GetTargetFraction(), 1.0);
+}
+
+TEST(MonitorPrescalerTest, ShedsLoadWhenFallingBehind) {
+  MonitorPrescaler prescaler(TestConfig());
+  FrameClock clock;
+
+  // Lag grows by 0.5 ms per frame: the monitor is at 2/3 of the input rate
+  for (int i = 0; i < 400; ++i) {
+    prescaler.Admit(clock.Next(i * kMs / 2));
+  }
+
+  EXPECT_GT(prescaler.GetLagMs(), 50.0);
+  EXPECT_LT(prescaler.GetTargetFraction(), 0.5);
+  EXPECT_TRUE(prescaler.IsSampling());
+  EXPECT_LT(prescaler.GetSamplingFraction(), 1.0);
+}
+
+TEST(MonitorPrescalerTest, QueueDepthAloneTriggersShedding) {
+  MonitorPrescaler prescaler(TestConfig());
+  FrameClock clock;
+
+  for (int i = 0; i < 100; ++i) {
+    prescaler.Admit(clock.Next(kMs, 2 << 20));
+  }
+  EXPECT_LT(prescaler.GetTargetFraction(), 1.0);
+}
+
+TEST(MonitorPrescalerTest, TargetIsBoundedByMinFraction) {
+  auto config = TestConfig();
+  config.min_fraction = 0.125;
+  MonitorPrescaler prescaler(config);
+  FrameClock clock;
+
+  for (int i = 0; i < 2000; ++i) {
+    prescaler.Admit(clock.Next(i * kMs));
+  }
+  EXPECT_DOUBLE_EQ(prescaler.GetTargetFraction(), 0.125);
+}
+
+TEST(MonitorPrescalerTest, RecoversOnceCaughtUp) {
+  MonitorPrescaler prescaler(TestConfig());
+  FrameClock clock;
+
+  for (int i = 0; i < 200; ++i) {
+    prescaler.Admit(clock.Next(i * kMs));
+  }
+  ASSERT_LT(prescaler.GetTargetFraction(), 1.0);
+
+  for (int i = 0; i < 1000; ++i) {
+    prescaler.Admit(clock.Next(kMs));
+  }
+  EXPECT_DOUBLE_EQ(prescaler.GetTargetFraction(), 1.0);
+  // The run as a whole stays marked as sampled
+  EXPECT_TRUE(prescaler.IsSampling());
+}
+
+TEST(MonitorPrescalerTest, AdmittedFractionFollowsTarget) {
+  auto config = TestConfig();
+  config.min_fraction = 0.25;
+  MonitorPrescaler prescaler(config);
+  FrameClock clock;
+
+  // Drive the target to its floor, then count admissions there
+  for (int i = 0; i < 200; ++i) {
+    prescaler.Admit(clock.Next(i * kMs));
+  }
+  ASSERT_DOUBLE_EQ(prescaler.GetTargetFraction(), 0.25);
+
+  int admitted = 0;
+  const int frames = 20000;
+  for (int i = 0; i < frames; ++i) {
+    admitted += prescaler.Admit(clock.Next((200 + i) * kMs)) ? 1 : 0;
+  }
+  EXPECT_NEAR(static_cast<double>(admitted) / frames, 0.25, 0.02);
+
+  double expected = static_cast<double>(prescaler.GetEventsAdmitted()) /
+                    prescaler.GetEventsSeen();
+  EXPECT_DOUBLE_EQ(prescaler.GetSamplingFraction(), expected);
+}
+
+TEST(MonitorPrescalerTest, DisabledAdmitsEverything) {
+  auto config = TestConfig();
+  config.enabled = false;
+  MonitorPrescaler prescaler(config);
+  FrameClock clock;
+
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_TRUE(prescaler.Admit(clock.Next(i * kMs)));
+  }
+  EXPECT_DOUBLE_EQ(prescaler.GetSamplingFraction(), 1.0);
+}
+
+TEST(MonitorPrescalerTest, ResetStartsAtFullRate) {
+  MonitorPrescaler prescaler(TestConfig());
+  FrameClock clock;
+  for (int i = 0; i < 200; ++i) {
+    prescaler.Admit(clock.Next(i * kMs));
+  }
+  ASSERT_TRUE(prescaler.IsSampling());
+
+  prescaler.Reset();
+
+  EXPECT_DOUBLE_EQ(prescaler.GetTargetFraction(), 1.0);
+  EXPECT_DOUBLE_EQ(prescaler.GetSamplingFraction(), 1.0);
+  EXPECT_FALSE(prescaler.IsSampling());
+  EXPECT_EQ(prescaler.GetEventsSeen(), 0u);
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -152,6 +152,32 @@ TEST_F(MonitorROOTTest, CanSetWaveformChannel) {
   EXPECT_EQ(channel, 5);
 }
 
+TEST_F(MonitorROOTTest, WorkerThreadsDefaultAndMinimum) {
+  EXPECT_EQ(monitor_->GetWorkerThreads(), 2u);
+  monitor_->SetWorkerThreads(4);
+  EXPECT_EQ(monitor_->GetWorkerThreads(), 4u);
+  monitor_->SetWorkerThreads(0);
+  EXPECT_EQ(monitor_->GetWorkerThreads(), 1u);
+}
+
+// === Overload Handling Tests ===
+
+TEST_F(MonitorROOTTest, PrescalingEnabledByDefault) {
+  EXPECT_TRUE(monitor_->IsPrescalingEnabled());
+  EXPECT_DOUBLE_EQ(monitor_->GetSamplingFraction(), 1.0);
+  EXPECT_DOUBLE_EQ(monitor_->GetStatus().metrics.sampling_fraction, 1.0);
+}
+
+TEST_F(MonitorROOTTest, CanConfigurePrescaler) {
+  monitor_->EnablePrescaling(false);
+  EXPECT_FALSE(monitor_->IsPrescalingEnabled());
+
+  MonitorPrescaler::Config config;
+  config.lag_high_ms = 2000.0;
+  monitor_->SetPrescalerConfig(config);
+  EXPECT_DOUBLE_EQ(monitor_->GetPrescalerConfig().lag_high_ms, 2000.0);
+}
+
 // === State Transition Tests ===
 
 TEST_F(MonitorROOTTest, TransitionIdleToConfigured) {
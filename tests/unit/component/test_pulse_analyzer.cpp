@@ -0,0 +1,144 @@
+/**
+ * @file test_pulse_analyzer.cpp
+ * @brief Unit tests for PulseAnalyzer
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "PulseAnalyzer.hpp"
+
+namespace DELILA {
+namespace test {
+
+namespace {
+
+// Negative pulse on a flat baseline: linear rise over `rise` samples from
+// `start`, then exponential decay
+std::vector<int32_t> MakePulse(size_t size, double start, double amplitude,
+                               double rise = 8.0, double decay = 30.0,
+                               int32_t baseline = 8000) {
+  std::vector<int32_t> samples(size);
+  for (size_t i = 0; i < size; ++i) {
+    double t = static_cast<double>(i) - start;
+    double value = 0.0;
+    if (t > 0.0 && t <= rise) {
+      value = amplitude * t / rise;
+    } else if (t > rise) {
+      value = amplitude * std::exp(-(t - rise) / decay);
+    }
+    samples[i] = baseline - static_cast<int32_t>(std::lround(value));
+  }
+  return samples;
+}
+
+}  // namespace
+
+TEST(PulseAnalyzerTest, RejectsInconsistentSettings) {
+  PulseAnalyzer analyzer;
+  PulseAnalyzer::Settings settings;
+  std::string error;
+
+  settings.baselineSamples = 0;
+  EXPECT_FALSE(analyzer.SetSettings(settings, &error));
+  EXPECT_FALSE(error.empty());
+
+  settings = PulseAnalyzer::Settings();
+  settings.baselineSamples = 60;  // Overlaps the gates at 56
+  EXPECT_FALSE(analyzer.SetSettings(settings));
+
+  settings = PulseAnalyzer::Settings();
+  settings.shortGate = 200;
+  EXPECT_FALSE(analyzer.SetSettings(settings));
+
+  settings = PulseAnalyzer::Settings();
+  settings.cfdFraction = 0.0f;
+  EXPECT_FALSE(analyzer.SetSettings(settings));
+
+  settings = PulseAnalyzer::Settings();
+  settings.polarity = 1;
+  EXPECT_TRUE(analyzer.SetSettings(settings));
+  EXPECT_EQ(analyzer.GetSettings().polarity, 1);
+}
+
+TEST(PulseAnalyzerTest, BaselineAndGatedIntegrals) {
+  PulseAnalyzer analyzer;
+  PulseAnalyzer::Settings settings;
+  settings.triggerSample = 20;
+  settings.preGate = 4;
+  settings.baselineSamples = 10;
+  settings.shortGate = 4;
+  settings.longGate = 10;
+  ASSERT_TRUE(analyzer.SetSettings(settings));
+
+  // Rectangular negative pulse of height 100 on samples 16..25
+  std::vector<int32_t> samples(64, 1000);
+  for (size_t i = 16; i < 26; ++i) {
+    samples[i] = 900;
+  }
+  auto result = analyzer.Analyze(samples.data(), samples.size());
+  EXPECT_DOUBLE_EQ(result.baseline, 1000.0);
+  EXPECT_DOUBLE_EQ(result.shortIntegral, 400.0);
+  EXPECT_DOUBLE_EQ(result.longIntegral, 1000.0);
+}
+
+TEST(PulseAnalyzerTest, CfdTimeFollowsThePulse) {
+  PulseAnalyzer analyzer;
+  ASSERT_TRUE(analyzer.SetSettings(PulseAnalyzer::Settings()));
+
+  // The CFD time moves with the pulse and does not depend on amplitude
+  auto first = analyzer.Analyze(MakePulse(512, 60.0, 1000.0).data(), 512);
+  auto shifted = analyzer.Analyze(MakePulse(512, 63.5, 1000.0).data(), 512);
+  auto larger = analyzer.Analyze(MakePulse(512, 60.0, 4000.0).data(), 512);
+  ASSERT_GE(first.cfdSample, 0.0);
+  EXPECT_NEAR(shifted.cfdSample - first.cfdSample, 3.5, 0.1);
+  EXPECT_NEAR(larger.cfdSample, first.cfdSample, 0.05);
+
+  // A flat waveform has no crossing
+  std::vector<int32_t> flat(512, 8000);
+  EXPECT_LT(analyzer.Analyze(flat.data(), flat.size()).cfdSample, 0.0);
+}
+
+TEST(PulseAnalyzerTest, ShortWaveformsAreClipped) {
+  PulseAnalyzer analyzer;
+  ASSERT_TRUE(analyzer.SetSettings(PulseAnalyzer::Settings()));
+  auto samples = MakePulse(40, 20.0, 500.0);  // Ends before the gates
+  auto result = analyzer.Analyze(samples.data(), samples.size());
+  EXPECT_DOUBLE_EQ(result.longIntegral, 0.0);
+  EXPECT_LT(result.cfdSample, 0.0);
+}
+
+TEST(PulseAnalyzerTest, ApplyWritesBack) {
+  PulseAnalyzer analyzer;
+  PulseAnalyzer::Settings settings;
+  settings.energyScale = 0.1;
+  settings.sampleNs = 4.0;
+  ASSERT_TRUE(analyzer.SetSettings(settings));
+
+  Digitizer::EventData event(512);
+  event.analogProbe1 = MakePulse(512, 62.0, 2000.0);
+  event.timeStampNs = 1000.0;
+  event.flags = PulseAnalyzer::FLAG_NO_CFD | Digitizer::EventData::FLAG_PILEUP;
+  ASSERT_TRUE(analyzer.Apply(event));
+
+  auto result = analyzer.Analyze(event.analogProbe1.data(), 512);
+  EXPECT_EQ(event.energy, std::lround(result.longIntegral * 0.1));
+  EXPECT_EQ(event.energyShort, std::lround(result.shortIntegral * 0.1));
+  EXPECT_GT(event.energy, event.energyShort);
+  EXPECT_DOUBLE_EQ(event.timeStampNs,
+                   1000.0 + (result.cfdSample - settings.triggerSample) * 4.0);
+  EXPECT_EQ(event.flags,
+            PulseAnalyzer::FLAG_ANALYZED | Digitizer::EventData::FLAG_PILEUP);
+
+  // No waveform: left alone
+  Digitizer::EventData empty;
+  empty.energy = 123;
+  EXPECT_FALSE(analyzer.Apply(empty));
+  EXPECT_EQ(empty.energy, 123);
+  EXPECT_EQ(empty.flags, 0u);
+}
+
+}  // namespace test
+}  // namespace DELILA
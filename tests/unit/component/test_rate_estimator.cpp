@@ -0,0 +1,318 @@
+/**
+ * @file test_rate_estimator.cpp
+ * @brief Unit tests for RateEstimator
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include <DataProcessor.hpp>
+
+#include "RateEstimator.hpp"
+
+namespace DELILA {
+namespace test {
+
+namespace {
+
+constexpr uint64_t kSecond = 1000000000;
+
+// Events/bytes at a constant rate, polled at the given times
+struct Stream {
+  RateEstimator estimator;
+  uint64_t t0 = 1000 * kSecond;
+  double eventsPerSecond = 0.0;
+  double events = 0.0;
+  uint64_t now = 0;
+
+  Stream() { estimator.Reset(t0); now = t0; }
+
+  ComponentMetrics Advance(uint64_t dt) {
+    events += eventsPerSecond * dt / kSecond;
+    now += dt;
+    ComponentMetrics metrics;
+    auto total = static_cast<uint64_t>(events);
+    estimator.Fill(total, total * 100, now, metrics);
+    return metrics;
+  }
+};
+
+} // namespace
+
+TEST(RateEstimatorTest, ConstantRate) {
+  Stream stream;
+  stream.eventsPerSecond = 1000.0;
+
+  ComponentMetrics metrics;
+  for (int i = 0; i < 30; ++i) {
+    metrics = stream.Advance(kSecond);
+  }
+  EXPECT_NEAR(metrics.event_rate, 1000.0, 1.0);
+  EXPECT_NEAR(metrics.event_rate_avg, 1000.0, 1.0);
+  EXPECT_NEAR(metrics.data_rate, 0.1, 0.001);  // 100 bytes/event, MB/s
+  EXPECT_NEAR(metrics.data_rate_avg, 0.1, 0.001);
+}
+
+TEST(RateEstimatorTest, IrregularPollingGivesSameRate) {
+  Stream stream;
+  stream.eventsPerSecond = 50000.0;
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<uint64_t> interval(kSecond / 10, 3 * kSecond);
+
+  ComponentMetrics metrics;
+  for (int i = 0; i < 50; ++i) {
+    metrics = stream.Advance(interval(rng));
+  }
+  EXPECT_NEAR(metrics.event_rate, 50000.0, 50.0);
+  EXPECT_NEAR(metrics.event_rate_avg, 50000.0, 50.0);
+}
+
+TEST(RateEstimatorTest, EwmaFollowsStepWithTimeConstant) {
+  Stream stream;  // tau = 2 s
+  stream.eventsPerSecond = 1000.0;
+  for (int i = 0; i < 20; ++i) {
+    stream.Advance(kSecond);
+  }
+
+  // Rate doubles: after one time constant the EWMA is ~63% of the way
+  stream.eventsPerSecond = 2000.0;
+  ComponentMetrics metrics;
+  for (int i = 0; i < 20; ++i) {
+    metrics = stream.Advance(kSecond / 10);
+  }
+  EXPECT_NEAR(metrics.event_rate, 1000.0 + 632.0, 10.0);
+}
+
+TEST(RateEstimatorTest, WindowForgetsOldRate) {
+  Stream stream;  // 10 s window
+  stream.eventsPerSecond = 1000.0;
+  for (int i = 0; i < 20; ++i) {
+    stream.Advance(kSecond);
+  }
+
+  stream.eventsPerSecond = 0.0;
+  ComponentMetrics metrics = stream.Advance(5 * kSecond);
+  EXPECT_GT(metrics.event_rate_avg, 100.0);  // Half the window still busy
+
+  for (int i = 0; i < 6; ++i) {
+    metrics = stream.Advance(kSecond);
+  }
+  EXPECT_DOUBLE_EQ(metrics.event_rate_avg, 0.0);
+  EXPECT_LT(metrics.event_rate, 10.0);
+}
+
+TEST(RateEstimatorTest, FastPollsReuseEstimate) {
+  Stream stream;
+  stream.eventsPerSecond = 1000.0;
+  ComponentMetrics first = stream.Advance(kSecond);
+  ComponentMetrics second = stream.Advance(kSecond / 1000);
+
+  EXPECT_DOUBLE_EQ(second.event_rate, first.event_rate);
+  EXPECT_DOUBLE_EQ(second.event_rate_avg, first.event_rate_avg);
+}
+
+TEST(RateEstimatorTest, TotalsResetStartsOver) {
+  Stream stream;
+  stream.eventsPerSecond = 1000.0;
+  for (int i = 0; i < 5; ++i) {
+    stream.Advance(kSecond);
+  }
+
+  // Component zeroed its counters without calling Reset()
+  stream.events = 0.0;
+  ComponentMetrics metrics = stream.Advance(kSecond);
+  metrics = stream.Advance(kSecond);
+  EXPECT_NEAR(metrics.event_rate, 1000.0, 1.0);
+}
+
+TEST(RateEstimatorTest, ChannelRates) {
+  RateEstimator estimator;
+  estimator.Reset(0);
+
+  ComponentMetrics metrics;
+  for (uint64_t second = 1; second <= 20; ++second) {
+    for (int i = 0; i < 300; ++i) estimator.CountEvent(3, 5);
+    for (int i = 0; i < 100; ++i) estimator.CountEvent(200, 63);
+    estimator.Fill(400 * second, 0, second * kSecond, metrics);
+  }
+
+  ASSERT_EQ(metrics.channel_rates.size(), 2u);
+  EXPECT_EQ(metrics.channel_rates[0].module, 3);
+  EXPECT_EQ(metrics.channel_rates[0].channel, 5);
+  EXPECT_NEAR(metrics.channel_rates[0].event_rate, 300.0, 0.5);
+  EXPECT_EQ(metrics.channel_rates[1].module, 200);
+  EXPECT_EQ(metrics.channel_rates[1].channel, 63);
+  EXPECT_NEAR(metrics.channel_rates[1].event_rate, 100.0, 0.5);
+  EXPECT_EQ(estimator.GetUnmappedCount(), 0u);
+
+  estimator.Reset(21 * kSecond);
+  estimator.Fill(0, 0, 22 * kSecond, metrics);
+  EXPECT_TRUE(metrics.channel_rates.empty());
+}
+
+TEST(RateEstimatorTest, OutOfTableEventsAreUnmapped) {
+  RateEstimator estimator;
+  for (int module = 0; module < 17; ++module) {
+    estimator.CountEvent(static_cast<uint8_t>(module), 0);
+  }
+  estimator.CountEvent(0, 64);
+
+  EXPECT_EQ(estimator.GetUnmappedCount(), 2u);
+}
+
+TEST(RateEstimatorTest, CountsMinimalFrames) {
+  Net::DataProcessor processor;
+  auto events = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+  for (int i = 0; i < 10; ++i) {
+    events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+        1, static_cast<uint8_t>(i % 2), 1.0 * i, 100, 50, 0));
+  }
+  auto frame = processor.Process(events, 0);
+
+  RateEstimator estimator;
+  estimator.Reset(0);
+  ASSERT_TRUE(estimator.CountFrame(*frame));
+
+  ComponentMetrics metrics;
+  estimator.Fill(10, frame->size(), kSecond, metrics);
+  ASSERT_EQ(metrics.channel_rates.size(), 2u);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[0].event_rate, 5.0);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[1].event_rate, 5.0);
+}
+
+TEST(RateEstimatorTest, CountsFullFramesWithWaveforms) {
+  Net::DataProcessor processor;
+  auto events =
+      std::make_unique<std::vector<std::unique_ptr<Digitizer::EventData>>>();
+  for (int i = 0; i < 4; ++i) {
+    auto event = std::make_unique<Digitizer::EventData>(i == 0 ? 100 : 0);
+    event->module = 2;
+    event->channel = 7;
+    events->push_back(std::move(event));
+  }
+  auto frame = processor.Process(events, 0);
+
+  RateEstimator estimator;
+  estimator.Reset(0);
+  ASSERT_TRUE(estimator.CountFrame(*frame));
+
+  ComponentMetrics metrics;
+  estimator.Fill(4, frame->size(), kSecond, metrics);
+  ASSERT_EQ(metrics.channel_rates.size(), 1u);
+  EXPECT_EQ(metrics.channel_rates[0].module, 2);
+  EXPECT_EQ(metrics.channel_rates[0].channel, 7);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[0].event_rate, 4.0);
+
+  // Truncated frame and EOS are not counted
+  frame->resize(frame->size() - 1);
+  EXPECT_FALSE(estimator.CountFrame(*frame));
+  EXPECT_FALSE(estimator.CountFrame(*processor.CreateEOSMessage()));
+}
+
+TEST(RateEstimatorTest, CountsCompactFullFrames) {
+  Net::DataProcessor processor;
+  processor.EnableCompactWaveforms();
+  auto events =
+      std::make_unique<std::vector<std::unique_ptr<Digitizer::EventData>>>();
+  for (int i = 0; i < 3; ++i) {
+    auto event = std::make_unique<Digitizer::EventData>(13 * i);
+    event->module = 1;
+    event->channel = static_cast<uint8_t>(i);
+    events->push_back(std::move(event));
+  }
+  auto frame = processor.Process(events, 0);
+  Net::BinaryDataHeader header;
+  ASSERT_TRUE(Net::DataProcessor::PeekHeader(*frame, header));
+  ASSERT_EQ(header.format_version, Net::FORMAT_VERSION_COMPACT_EVENTDATA);
+
+  RateEstimator estimator;
+  estimator.Reset(0);
+  ASSERT_TRUE(estimator.CountFrame(*frame));
+
+  ComponentMetrics metrics;
+  estimator.Fill(3, frame->size(), kSecond, metrics);
+  ASSERT_EQ(metrics.channel_rates.size(), 3u);
+  EXPECT_EQ(metrics.channel_rates[2].module, 1);
+  EXPECT_EQ(metrics.channel_rates[2].channel, 2);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[2].event_rate, 1.0);
+
+  frame->resize(frame->size() - 1);
+  EXPECT_FALSE(estimator.CountFrame(*frame));
+}
+
+TEST(RateEstimatorTest, CountsEachHitOfBuiltFrames) {
+  Net::DataProcessor processor;
+  auto events = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::BuiltEventData>>>();
+  for (int i = 0; i < 3; ++i) {
+    auto event = std::make_unique<Digitizer::BuiltEventData>();
+    event->hits.emplace_back(1, 0, 1000.0 * i, 100, 50, 0);
+    event->hits.emplace_back(2, 5, 1000.0 * i + 10, 100, 50, 0);
+    events->push_back(std::move(event));
+  }
+  auto frame = processor.Process(events, 0);
+
+  RateEstimator estimator;
+  estimator.Reset(0);
+  ASSERT_TRUE(estimator.CountFrame(*frame));
+
+  ComponentMetrics metrics;
+  estimator.Fill(3, frame->size(), kSecond, metrics);
+  ASSERT_EQ(metrics.channel_rates.size(), 2u);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[0].event_rate, 3.0);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[1].event_rate, 3.0);
+
+  frame->resize(frame->size() - 1);
+  EXPECT_FALSE(estimator.CountFrame(*frame));
+}
+
+TEST(RateEstimatorTest, CountsCalibratedFrames) {
+  Net::DataProcessor processor;
+  auto events = std::make_unique<
+      std::vector<std::unique_ptr<Digitizer::CalibratedEventData>>>();
+  for (int i = 0; i < 4; ++i) {
+    events->push_back(std::make_unique<Digitizer::CalibratedEventData>(
+        3, static_cast<uint8_t>(i % 2), 100, 50.0f, 25.0f, 1000.0 * i, 0));
+  }
+  auto frame = processor.Process(events, 0);
+
+  RateEstimator estimator;
+  estimator.Reset(0);
+  ASSERT_TRUE(estimator.CountFrame(*frame));
+
+  ComponentMetrics metrics;
+  estimator.Fill(4, frame->size(), kSecond, metrics);
+  ASSERT_EQ(metrics.channel_rates.size(), 2u);
+  EXPECT_EQ(metrics.channel_rates[0].module, 3);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[0].event_rate, 2.0);
+  EXPECT_DOUBLE_EQ(metrics.channel_rates[1].event_rate, 2.0);
+}
+
+TEST(RateEstimatorTest, ReaderRunsWhileWriterCounts) {
+  RateEstimator estimator;
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> total{0};
+
+  std::thread writer([&] {
+    for (int i = 0; i < 200000; ++i) {
+      estimator.CountEvent(static_cast<uint8_t>(i % 4), static_cast<uint8_t>(i % 8));
+      total.store(total.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+    }
+    done = true;
+  });
+
+  ComponentMetrics metrics;
+  while (!done) {
+    estimator.Fill(total.load(), 0, metrics);
+  }
+  writer.join();
+  EXPECT_EQ(estimator.GetUnmappedCount(), 0u);
+}
+
+} // namespace test
+} // namespace DELILA
@@ -0,0 +1,117 @@
+/**
+ * @file test_route_table.cpp
+ * @brief Unit tests for RouteTable
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "RouteTable.hpp"
+
+namespace DELILA {
+namespace test {
+
+TEST(RouteTableTest, ModuloByModuleAndChannel) {
+  RouteTable table;
+  EXPECT_EQ(table.GetOutputs(), 1u);
+  EXPECT_EQ(table.Route(7, 3, 0.0), 0u);
+
+  ASSERT_TRUE(table.SetOutputs(3));
+  EXPECT_EQ(table.GetKey(), RouteTable::Key::Module);
+  EXPECT_EQ(table.Route(4, 0, 0.0), 1u);
+  EXPECT_EQ(table.Route(4, 15, 0.0), 1u);  // Whole module together
+  EXPECT_EQ(table.Route(5, 0, 0.0), 2u);
+
+  table.SetKey(RouteTable::Key::Channel);
+  EXPECT_EQ(table.Route(0, 4, 0.0), 1u);
+  EXPECT_EQ(table.Route(0, 5, 0.0), 2u);
+  EXPECT_EQ(table.Route(1, 0, 0.0), 256u % 3);
+}
+
+TEST(RouteTableTest, TimeSlices) {
+  RouteTable table;
+  ASSERT_TRUE(table.SetOutputs(2));
+  table.SetKey(RouteTable::Key::Time);
+  EXPECT_FALSE(table.SetTimeSlice(0.0));
+  ASSERT_TRUE(table.SetTimeSlice(1000.0));
+  EXPECT_EQ(table.Route(0, 0, 999.0), 0u);
+  EXPECT_EQ(table.Route(9, 9, 1000.0), 1u);
+  EXPECT_EQ(table.Route(0, 0, 2500.0), 0u);
+  EXPECT_EQ(table.Route(0, 0, -5.0), 0u);
+}
+
+TEST(RouteTableTest, FrameBlocks) {
+  RouteTable table;
+  ASSERT_TRUE(table.SetOutputs(3));
+  table.SetKey(RouteTable::Key::Frame);
+  EXPECT_EQ(table.GetFrameBlock(), 64u);
+  EXPECT_FALSE(table.SetFrameBlock(0));
+  ASSERT_TRUE(table.SetFrameBlock(4));
+  EXPECT_EQ(table.RouteBlock(0), 0u);
+  EXPECT_EQ(table.RouteBlock(3), 0u);
+  EXPECT_EQ(table.RouteBlock(4), 1u);
+  EXPECT_EQ(table.RouteBlock(11), 2u);
+  EXPECT_EQ(table.RouteBlock(12), 0u);  // Round robin over blocks
+}
+
+TEST(RouteTableTest, RangesOverrideModulo) {
+  RouteTable table;
+  ASSERT_TRUE(table.SetOutputs(4));
+  ASSERT_TRUE(table.AddRange("0-3=2"));
+  ASSERT_TRUE(table.AddRange("2:0-2:7=0"));  // Later range wins
+  ASSERT_TRUE(table.AddRange("9=3"));
+  EXPECT_EQ(table.Route(0, 0, 0.0), 2u);
+  EXPECT_EQ(table.Route(3, 255, 0.0), 2u);
+  EXPECT_EQ(table.Route(2, 7, 0.0), 0u);
+  EXPECT_EQ(table.Route(2, 8, 0.0), 2u);
+  EXPECT_EQ(table.Route(9, 200, 0.0), 3u);
+  EXPECT_EQ(table.Route(5, 0, 0.0), 1u);  // Not covered: 5 % 4
+
+  // Ranges also apply with the channel key
+  table.SetKey(RouteTable::Key::Channel);
+  EXPECT_EQ(table.Route(2, 7, 0.0), 0u);
+  EXPECT_EQ(table.Route(5, 2, 0.0), (5u * 256 + 2) % 4);
+
+  EXPECT_EQ(table.GetRanges(),
+            (std::vector<std::string>{"0-3=2", "2:0-2:7=0", "9=3"}));
+  table.ClearRanges();
+  table.SetKey(RouteTable::Key::Module);
+  EXPECT_EQ(table.Route(0, 0, 0.0), 0u);
+}
+
+TEST(RouteTableTest, RejectsBadRanges) {
+  RouteTable table;
+  ASSERT_TRUE(table.SetOutputs(2));
+  std::string error;
+  EXPECT_FALSE(table.AddRange("0-3", &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(table.AddRange("3-0=1", &error));
+  EXPECT_FALSE(table.AddRange("0-3=2", &error));     // No output 2
+  EXPECT_FALSE(table.AddRange("256=0", &error));
+  EXPECT_FALSE(table.AddRange("1:x=0", &error));
+  EXPECT_FALSE(table.AddRange("-1=0", &error));
+  EXPECT_TRUE(table.GetRanges().empty());
+
+  // Fewer outputs than a range needs
+  ASSERT_TRUE(table.AddRange("1=1"));
+  EXPECT_FALSE(table.SetOutputs(1, &error));
+  EXPECT_EQ(table.GetOutputs(), 2u);
+  EXPECT_FALSE(table.SetOutputs(0));
+  EXPECT_FALSE(table.SetOutputs(RouteTable::kMaxOutputs + 1));
+}
+
+TEST(RouteTableTest, ParseKey) {
+  RouteTable::Key key;
+  ASSERT_TRUE(RouteTable::ParseKey("channel", key));
+  EXPECT_EQ(key, RouteTable::Key::Channel);
+  ASSERT_TRUE(RouteTable::ParseKey("time", key));
+  EXPECT_STREQ(RouteTable::KeyName(key), "time");
+  ASSERT_TRUE(RouteTable::ParseKey("frame", key));
+  EXPECT_EQ(key, RouteTable::Key::Frame);
+  EXPECT_FALSE(RouteTable::ParseKey("energy", key));
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -0,0 +1,251 @@
+/**
+ * @file test_router.cpp
+ * @brief Unit tests for Router component
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "Router.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+class RouterTest : public ::testing::Test {
+ protected:
+  void SetUp() override { router_ = std::make_unique<Router>(); }
+
+  void TearDown() override {
+    if (router_) {
+      router_->Shutdown();
+    }
+  }
+
+  static std::unique_ptr<Net::ZMQTransport> MakeEndpoint(
+      const std::string &address, bool bind, const std::string &pattern) {
+    auto transport = std::make_unique<Net::ZMQTransport>();
+    Net::TransportConfig config;
+    config.data_address = address;
+    config.bind_data = bind;
+    config.data_pattern = pattern;
+    config.status_address = config.data_address;
+    config.command_address = "";
+    if (!transport->Configure(config) || !transport->Connect()) {
+      return nullptr;
+    }
+    return transport;
+  }
+
+  std::unique_ptr<Router> router_;
+};
+
+// === Initial State Tests ===
+
+TEST_F(RouterTest, InitialDefaults) {
+  EXPECT_EQ(router_->GetRouteKey(), RouteTable::Key::Module);
+  EXPECT_TRUE(router_->GetRanges().empty());
+}
+
+// === Configuration Tests ===
+
+TEST_F(RouterTest, RangesNeedTheirOutputs) {
+  std::string error;
+  EXPECT_FALSE(router_->AddRange("0-3=1", &error));  // One output so far
+
+  router_->SetOutputAddresses({"inproc://a", "inproc://b"});
+  EXPECT_TRUE(router_->AddRange("0-3=1"));
+  ASSERT_EQ(router_->GetRanges().size(), 1u);
+
+  // Dropping the second output makes the range invalid
+  router_->SetInputAddresses({"tcp://localhost:5555"});
+  router_->SetOutputAddresses({"inproc://a"});
+  EXPECT_FALSE(router_->Initialize(""));
+  EXPECT_FALSE(router_->GetStatus().error_message.empty());
+  router_->ClearRanges();
+  EXPECT_TRUE(router_->Initialize(""));
+}
+
+TEST_F(RouterTest, RoutingIsFixedWhileRunning) {
+  router_->SetInputAddresses({"tcp://localhost:5555"});
+  router_->SetOutputAddresses({"tcp://localhost:6666", "tcp://localhost:6667"});
+  ASSERT_TRUE(router_->SetRouteKey(RouteTable::Key::Time));
+  ASSERT_TRUE(router_->SetTimeSlice(1e6));
+
+  ASSERT_TRUE(router_->Initialize(""));
+  ASSERT_TRUE(router_->Arm());
+  ASSERT_TRUE(router_->Start(3));
+
+  EXPECT_FALSE(router_->SetRouteKey(RouteTable::Key::Module));
+  EXPECT_FALSE(router_->AddRange("0=1"));
+  EXPECT_EQ(router_->GetOutputCounts().size(), 2u);
+  EXPECT_TRUE(router_->Stop(true));
+}
+
+// === Routing Tests ===
+
+// Even frames mix modules 0-3 and are split, odd frames hold only module 1
+// and are forwarded whole. Modules 0 and 2 go to output 0, 1 and 3 to
+// output 1; each output must see only its modules, in order, with its own
+// contiguous sequence numbers, then EOS.
+TEST_F(RouterTest, SplitsByModuleAndKeepsOrder) {
+  constexpr int kFrames = 20;
+  constexpr int kHitsPerFrame = 40;
+
+  auto source = MakeEndpoint("inproc://router_test_in", true, "PUSH");
+  ASSERT_NE(source, nullptr);
+
+  router_->SetInputAddresses({"inproc://router_test_in"});
+  router_->SetOutputAddresses(
+      {"inproc://router_test_out0", "inproc://router_test_out1"});
+  ASSERT_TRUE(router_->Initialize(""));
+  ASSERT_TRUE(router_->Arm());
+
+  std::vector<std::unique_ptr<Net::ZMQTransport>> sinks;
+  for (int o = 0; o < 2; ++o) {
+    sinks.push_back(MakeEndpoint(
+        "inproc://router_test_out" + std::to_string(o), false, "PULL"));
+    ASSERT_NE(sinks.back(), nullptr);
+  }
+
+  ASSERT_TRUE(router_->Start(1));
+
+  Net::DataProcessor processor;
+  uint64_t expected[2] = {0, 0};
+  for (int f = 0; f < kFrames; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+    for (int h = 0; h < kHitsPerFrame; ++h) {
+      int n = f * kHitsPerFrame + h;
+      uint8_t module = (f % 2 == 0) ? static_cast<uint8_t>(h % 4) : 1;
+      expected[module % 2]++;
+      events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+          module, h % 16, 10.0 * n, 100, 50, 0));
+    }
+    auto frame = processor.Process(events, f);
+    ASSERT_TRUE(source->SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source->SendBytes(eos));
+
+  for (int o = 0; o < 2; ++o) {
+    uint64_t received = 0;
+    uint64_t nextSequence = 0;
+    double lastTime[4] = {-1.0, -1.0, -1.0, -1.0};
+    bool gotEos = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+      auto data = sinks[o]->ReceiveBytes();
+      if (!data) {
+        continue;
+      }
+      if (Net::DataProcessor::IsEOSMessage(*data)) {
+        gotEos = true;
+        break;
+      }
+      auto [events, sequence] = processor.DecodeMinimal(data);
+      ASSERT_NE(events, nullptr);
+      EXPECT_EQ(sequence, nextSequence++);
+      for (const auto &event : *events) {
+        ASSERT_LT(event->module, 4);
+        EXPECT_EQ(event->module % 2, o);
+        EXPECT_GT(event->timeStampNs, lastTime[event->module]);
+        lastTime[event->module] = event->timeStampNs;
+        received++;
+      }
+    }
+    EXPECT_TRUE(gotEos) << "output " << o;
+    EXPECT_EQ(received, expected[o]) << "output " << o;
+  }
+
+  EXPECT_TRUE(router_->Stop(true));
+  EXPECT_EQ(router_->GetOutputCounts(),
+            (std::vector<uint64_t>{expected[0], expected[1]}));
+  EXPECT_EQ(router_->GetStatus().metrics.events_processed,
+            expected[0] + expected[1]);
+  EXPECT_EQ(router_->GetFramesSplit(), static_cast<uint64_t>(kFrames / 2));
+  EXPECT_EQ(router_->GetFramesForwarded(), static_cast<uint64_t>(kFrames / 2));
+}
+
+// Frame key: whole frames alternate between the outputs in blocks of 3 and
+// carry their run-wide number (receive order), not the source's sequence
+TEST_F(RouterTest, FrameKeyForwardsNumberedBlocks) {
+  constexpr int kFrames = 12;
+  constexpr int kBlock = 3;
+
+  auto source = MakeEndpoint("inproc://router_frame_in", true, "PUSH");
+  ASSERT_NE(source, nullptr);
+
+  router_->SetInputAddresses({"inproc://router_frame_in"});
+  router_->SetOutputAddresses(
+      {"inproc://router_frame_out0", "inproc://router_frame_out1"});
+  ASSERT_TRUE(router_->SetRouteKey(RouteTable::Key::Frame));
+  ASSERT_TRUE(router_->SetFrameBlock(kBlock));
+  ASSERT_TRUE(router_->Initialize(""));
+  ASSERT_TRUE(router_->Arm());
+
+  std::vector<std::unique_ptr<Net::ZMQTransport>> sinks;
+  for (int o = 0; o < 2; ++o) {
+    sinks.push_back(MakeEndpoint(
+        "inproc://router_frame_out" + std::to_string(o), false, "PULL"));
+    ASSERT_NE(sinks.back(), nullptr);
+  }
+
+  ASSERT_TRUE(router_->Start(1));
+
+  // Two merged sources would repeat sequence numbers: send 7, 7, 7, ...
+  Net::DataProcessor processor;
+  for (int f = 0; f < kFrames; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+    events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+        0, 0, 100.0 * f, 100, 50, 0));
+    auto frame = processor.Process(events, 7);
+    ASSERT_TRUE(source->SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source->SendBytes(eos));
+
+  for (int o = 0; o < 2; ++o) {
+    std::vector<uint64_t> sequences;
+    bool gotEos = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+      auto data = sinks[o]->ReceiveBytes();
+      if (!data) {
+        continue;
+      }
+      if (Net::DataProcessor::IsEOSMessage(*data)) {
+        gotEos = true;
+        break;
+      }
+      auto [events, sequence] = processor.DecodeMinimal(data);
+      ASSERT_NE(events, nullptr);
+      ASSERT_EQ(events->size(), 1u);
+      EXPECT_DOUBLE_EQ((*events)[0]->timeStampNs, 100.0 * sequence);
+      sequences.push_back(sequence);
+    }
+    EXPECT_TRUE(gotEos) << "output " << o;
+
+    std::vector<uint64_t> expected;
+    for (uint64_t f = 0; f < kFrames; ++f) {
+      if ((f / kBlock) % 2 == static_cast<uint64_t>(o)) {
+        expected.push_back(f);
+      }
+    }
+    EXPECT_EQ(sequences, expected) << "output " << o;
+  }
+
+  EXPECT_TRUE(router_->Stop(true));
+  EXPECT_EQ(router_->GetFramesForwarded(), static_cast<uint64_t>(kFrames));
+  EXPECT_EQ(router_->GetFramesSplit(), 0u);
+  EXPECT_EQ(router_->GetOutputCounts(),
+            (std::vector<uint64_t>{kFrames / 2, kFrames / 2}));
+}
+
+}  // namespace test
+}  // namespace DELILA
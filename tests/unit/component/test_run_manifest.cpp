@@ -0,0 +1,158 @@
+/**
+ * @file test_run_manifest.cpp
+ * @brief Unit tests for RunManifest
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "RunManifest.hpp"
+
+namespace DELILA {
+namespace test {
+
+class RunManifestTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "delila_manifest_test";
+    std::filesystem::create_directories(dir_ / "w0");
+    std::filesystem::create_directories(dir_ / "w1");
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(RunManifestTest, ConsecutiveFramesShareABlock) {
+  RunManifest manifest;
+  size_t file = manifest.AddFile("run_000001.dat");
+  EXPECT_EQ(manifest.AddFile("run_000001.dat"), file);
+
+  manifest.AddFrame(file, 0, 0, 100, 10, 50.0, 90.0);
+  manifest.AddFrame(file, 1, 100, 80, 8, 20.0, 60.0);
+  manifest.AddFrame(file, 2, 180, 64, 0, 0.0, 0.0);  // No events
+  manifest.AddFrame(file, 6, 244, 100, 10, 300.0, 400.0);  // Next block
+
+  const auto &blocks = manifest.GetBlocks();
+  ASSERT_EQ(blocks.size(), 2u);
+  EXPECT_EQ(blocks[0].firstSequence, 0u);
+  EXPECT_EQ(blocks[0].lastSequence, 2u);
+  EXPECT_EQ(blocks[0].Frames(), 3u);
+  EXPECT_EQ(blocks[0].offset, 0u);
+  EXPECT_EQ(blocks[0].bytes, 244u);
+  EXPECT_EQ(blocks[0].events, 18u);
+  EXPECT_DOUBLE_EQ(blocks[0].firstNs, 20.0);
+  EXPECT_DOUBLE_EQ(blocks[0].lastNs, 90.0);
+  EXPECT_EQ(blocks[1].firstSequence, 6u);
+  EXPECT_EQ(blocks[1].offset, 244u);
+  EXPECT_EQ(manifest.GetFrames(), 4u);
+  EXPECT_EQ(manifest.GetEvents(), 28u);
+}
+
+TEST_F(RunManifestTest, MergeFindsGapsAndOverlaps) {
+  RunManifest w0;
+  w0.SetRunNumber(5);
+  size_t f0 = w0.AddFile("w0/run_000005.dat");
+  w0.AddFrame(f0, 0, 0, 10, 1, 1.0, 1.0);
+  w0.AddFrame(f0, 1, 10, 10, 1, 2.0, 2.0);
+  w0.AddFrame(f0, 4, 20, 10, 1, 5.0, 5.0);
+  w0.AddFrame(f0, 5, 30, 10, 1, 6.0, 6.0);
+
+  RunManifest w1;
+  w1.SetRunNumber(5);
+  size_t f1 = w1.AddFile("w1/run_000005.dat");
+  w1.AddFrame(f1, 2, 0, 10, 1, 3.0, 3.0);
+  w1.AddFrame(f1, 8, 10, 10, 1, 9.0, 9.0);  // 6-7 never written
+
+  RunManifest run;
+  ASSERT_TRUE(run.Merge(w0));
+  ASSERT_TRUE(run.Merge(w1));
+  run.Sort();
+  EXPECT_EQ(run.GetRunNumber(), 5u);
+  ASSERT_EQ(run.GetFiles().size(), 2u);
+  ASSERT_EQ(run.GetBlocks().size(), 4u);
+  EXPECT_EQ(run.GetBlocks()[1].firstSequence, 2u);
+  EXPECT_EQ(run.GetBlocks()[1].file, 1u);
+
+  auto gaps = run.FindGaps();
+  ASSERT_EQ(gaps.size(), 2u);
+  EXPECT_EQ(gaps[0].firstSequence, 3u);
+  EXPECT_EQ(gaps[0].lastSequence, 3u);
+  EXPECT_EQ(gaps[1].firstSequence, 6u);
+  EXPECT_EQ(gaps[1].lastSequence, 7u);
+  EXPECT_TRUE(run.FindOverlaps().empty());
+
+  // The same writer twice holds every frame twice
+  ASSERT_TRUE(run.Merge(w1));
+  auto overlaps = run.FindOverlaps();
+  ASSERT_EQ(overlaps.size(), 2u);
+  EXPECT_EQ(overlaps[0].firstSequence, 2u);
+
+  // Another run does not merge
+  RunManifest other;
+  other.SetRunNumber(6);
+  std::string error;
+  EXPECT_FALSE(run.Merge(other, &error));
+  EXPECT_FALSE(error.empty());
+}
+
+TEST_F(RunManifestTest, SaveAndLoadResolveFilesAgainstTheManifest) {
+  RunManifest w0;
+  w0.SetRunNumber(9);
+  size_t file = w0.AddFile((dir_ / "w0" / "run_000009.dat").string());
+  w0.AddFrame(file, 0, 0, 128, 4, 1e9, 2e9);
+  std::string path = (dir_ / "w0" / "run_000009.manifest.json").string();
+  ASSERT_TRUE(w0.Save(path));
+
+  // Stored relative to the manifest, so the directory can move
+  std::ifstream saved(path);
+  std::string text((std::istreambuf_iterator<char>(saved)),
+                   std::istreambuf_iterator<char>());
+  EXPECT_NE(text.find("\"run_000009.dat\""), std::string::npos);
+  EXPECT_EQ(text.find("w0/"), std::string::npos);
+
+  RunManifest loaded;
+  ASSERT_TRUE(loaded.Load(path));
+  EXPECT_EQ(loaded.GetRunNumber(), 9u);
+  ASSERT_EQ(loaded.GetFiles().size(), 1u);
+  EXPECT_EQ(std::filesystem::path(loaded.GetFiles()[0]),
+            (dir_ / "w0" / "run_000009.dat").lexically_normal());
+  ASSERT_EQ(loaded.GetBlocks().size(), 1u);
+  EXPECT_EQ(loaded.GetBlocks()[0].bytes, 128u);
+  EXPECT_DOUBLE_EQ(loaded.GetBlocks()[0].lastNs, 2e9);
+
+  // A run manifest one level up refers to the writers' subdirectories
+  std::string runPath = (dir_ / "run_000009.manifest.json").string();
+  ASSERT_TRUE(loaded.Save(runPath));
+  RunManifest run;
+  ASSERT_TRUE(run.Load(runPath));
+  EXPECT_EQ(run.GetFiles(), loaded.GetFiles());
+}
+
+TEST_F(RunManifestTest, LoadRejectsBadDocuments) {
+  RunManifest manifest;
+  manifest.SetRunNumber(1);
+  std::string error;
+  EXPECT_FALSE(manifest.Load((dir_ / "missing.json").string(), &error));
+
+  std::string path = (dir_ / "bad.json").string();
+  std::ofstream(path) << R"({"run_number": 2, "files": ["a.dat"],
+      "blocks": [{"file": 1, "first_sequence": 0, "last_sequence": 0,
+                  "offset": 0, "bytes": 64, "events": 1}]})";
+  EXPECT_FALSE(manifest.Load(path, &error));
+  EXPECT_NE(error.find("invalid block"), std::string::npos);
+  EXPECT_EQ(manifest.GetRunNumber(), 1u);  // Unchanged
+}
+
+TEST_F(RunManifestTest, ManifestPathFor) {
+  EXPECT_EQ(RunManifest::ManifestPathFor("data/run_000042.dat"),
+            "data/run_000042.manifest.json");
+  EXPECT_EQ(RunManifest::ManifestPathFor("raw"), "raw.manifest.json");
+}
+
+}  // namespace test
+}  // namespace DELILA
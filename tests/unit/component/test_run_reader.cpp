@@ -0,0 +1,129 @@
+/**
+ * @file test_run_reader.cpp
+ * @brief Unit tests for RunReader
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <DataProcessor.hpp>
+
+#include "RunManifest.hpp"
+#include "RunReader.hpp"
+
+namespace DELILA {
+namespace test {
+
+// Frames 0..N-1 written like a two-writer farm with blocks of kBlock
+// frames: writer (f / kBlock) % 2 holds frame f. Frame f holds f + 1
+// events at times 1000 * f + i.
+class RunReaderTest : public ::testing::Test {
+ protected:
+  static constexpr int kFrames = 20;
+  static constexpr int kBlock = 4;
+
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "delila_reader_test";
+    std::filesystem::create_directories(dir_);
+
+    std::ofstream files[2];
+    uint64_t offsets[2] = {0, 0};
+    for (int w = 0; w < 2; ++w) {
+      std::string path =
+          (dir_ / ("w" + std::to_string(w) + "_run_000003.dat")).string();
+      files[w].open(path, std::ios::binary);
+      writers_[w].SetRunNumber(3);
+      writers_[w].AddFile(path);
+    }
+
+    for (int f = 0; f < kFrames; ++f) {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+      for (int i = 0; i <= f; ++i) {
+        events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+            0, 0, 1000.0 * f + i, 100, 50, 0));
+      }
+      auto frame = processor_.Process(events, f);
+      int w = (f / kBlock) % 2;
+      files[w].write(reinterpret_cast<const char *>(frame->data()),
+                     static_cast<std::streamsize>(frame->size()));
+      writers_[w].AddFrame(0, f, offsets[w], frame->size(), f + 1,
+                           1000.0 * f, 1000.0 * f + f);
+      offsets[w] += frame->size();
+    }
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  RunManifest Run() const {
+    RunManifest run;
+    run.Merge(writers_[1]);  // Order of the writers does not matter
+    run.Merge(writers_[0]);
+    return run;
+  }
+
+  std::filesystem::path dir_;
+  Net::DataProcessor processor_;
+  RunManifest writers_[2];
+};
+
+TEST_F(RunReaderTest, ReadsTheRunInSequenceOrder) {
+  RunManifest run = Run();
+  EXPECT_EQ(run.GetBlocks().size(), static_cast<size_t>(kFrames / kBlock));
+
+  RunReader reader;
+  ASSERT_TRUE(reader.Open(run));
+  uint64_t expected = 0;
+  while (auto frame = reader.Next()) {
+    auto [events, sequence] = processor_.DecodeMinimal(frame);
+    ASSERT_NE(events, nullptr);
+    EXPECT_EQ(sequence, expected);
+    ASSERT_EQ(events->size(), expected + 1);
+    EXPECT_DOUBLE_EQ(events->front()->timeStampNs, 1000.0 * expected);
+    expected++;
+  }
+  EXPECT_FALSE(reader.HasError()) << reader.GetError();
+  EXPECT_EQ(expected, static_cast<uint64_t>(kFrames));
+  EXPECT_EQ(reader.GetFramesRead(), static_cast<uint64_t>(kFrames));
+}
+
+TEST_F(RunReaderTest, TimeRangeSelectsBlocks) {
+  RunReader reader;
+  ASSERT_TRUE(reader.Open(Run()));
+  reader.SetTimeRange(5000.0, 9000.0);  // Frames 5-9: blocks 4-7 and 8-11
+
+  std::vector<uint64_t> sequences;
+  while (auto frame = reader.Next()) {
+    Net::BinaryDataHeader header;
+    ASSERT_TRUE(Net::DataProcessor::PeekHeader(*frame, header));
+    sequences.push_back(header.sequence_number);
+  }
+  EXPECT_FALSE(reader.HasError());
+  EXPECT_EQ(sequences, (std::vector<uint64_t>{4, 5, 6, 7, 8, 9, 10, 11}));
+}
+
+TEST_F(RunReaderTest, RejectsOverlapsAndWrongFrames) {
+  RunManifest twice = Run();
+  twice.Merge(writers_[0]);
+  RunReader reader;
+  std::string error;
+  EXPECT_FALSE(reader.Open(twice, &error));
+  EXPECT_FALSE(error.empty());
+
+  // A manifest that does not match the file stops the reader
+  RunManifest wrong;
+  wrong.SetRunNumber(3);
+  wrong.AddFile(writers_[1].GetFiles()[0]);
+  const auto &block = writers_[1].GetBlocks()[0];  // Frames 4-7
+  wrong.AddFrame(0, 0, block.offset, block.bytes, 0, 0.0, 0.0);
+  ASSERT_TRUE(reader.Open(wrong));
+  EXPECT_EQ(reader.Next(), nullptr);
+  EXPECT_TRUE(reader.HasError());
+}
+
+}  // namespace test
+}  // namespace DELILA
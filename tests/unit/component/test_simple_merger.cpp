@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <filesystem>
 #include <thread>
 
 #include "SimpleMerger.hpp"
@@ -256,5 +257,63 @@ TEST_F(SimpleMergerTest, QueueSizeReportedInStatus) {
   EXPECT_GT(status.metrics.queue_max, 0);  // Should have a max queue size
 }
 
+// === Spill Mode Tests ===
+
+TEST_F(SimpleMergerTest, SpillFileExistsFromArmToReset) {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto path = dir / "spill_test_merger.spill";
+  merger_->SetComponentId("spill_test_merger");
+  merger_->SetInputAddresses({"tcp://localhost:5555"});
+  merger_->SetOutputAddresses({"tcp://localhost:6666"});
+  merger_->SetSpillDirectory(dir.string());
+  merger_->SetSpillCapacity(1 << 20);
+  merger_->Initialize("");
+
+  ASSERT_TRUE(merger_->Arm());
+  EXPECT_TRUE(std::filesystem::exists(path));
+  EXPECT_EQ(merger_->GetSpilledFrames(), 0u);
+  EXPECT_EQ(merger_->GetDroppedFrames(), 0u);
+
+  merger_->Reset();
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(SimpleMergerTest, ArmFailsWithoutSpillDirectory) {
+  merger_->SetInputAddresses({"tcp://localhost:5555"});
+  merger_->SetOutputAddresses({"tcp://localhost:6666"});
+  merger_->SetSpillDirectory("/nonexistent/delila/spill");
+  merger_->Initialize("");
+
+  EXPECT_FALSE(merger_->Arm());
+  EXPECT_EQ(merger_->GetState(), ComponentState::Error);
+}
+
+// === Sequence Tracking Tests ===
+
+TEST_F(SimpleMergerTest, InitializeFailsWithTooManyInputs) {
+  std::vector<std::string> inputs(256, "tcp://localhost:5555");
+  merger_->SetInputAddresses(inputs);
+  merger_->SetOutputAddresses({"tcp://localhost:6666"});
+
+  EXPECT_FALSE(merger_->Initialize(""));
+  EXPECT_EQ(merger_->GetState(), ComponentState::Idle);
+}
+
+TEST_F(SimpleMergerTest, InputSequenceStatsStartEmpty) {
+  EXPECT_EQ(merger_->GetReorderWindow(), 0u);
+  merger_->SetReorderWindow(16);
+  EXPECT_EQ(merger_->GetReorderWindow(), 16u);
+
+  merger_->SetInputAddresses({"tcp://localhost:5555", "tcp://localhost:5556"});
+  merger_->SetOutputAddresses({"tcp://localhost:6666"});
+  ASSERT_TRUE(merger_->Initialize(""));
+
+  auto stats = merger_->GetInputSequenceStats(1);
+  EXPECT_EQ(stats.received, 0u);
+  EXPECT_EQ(stats.lost, 0u);
+  EXPECT_EQ(stats.reordered, 0u);
+  EXPECT_EQ(merger_->GetInputSequenceStats(2).received, 0u);  // No such input
+}
+
 }  // namespace test
 }  // namespace DELILA
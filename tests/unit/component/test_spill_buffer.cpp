@@ -0,0 +1,100 @@
+/**
+ * @file test_spill_buffer.cpp
+ * @brief Unit tests for SpillBuffer
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "SpillBuffer.hpp"
+
+namespace DELILA {
+namespace test {
+
+class SpillBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path().string();
+    spill_.SetMemoryFrames(2);
+    ASSERT_TRUE(spill_.Open(
+        SpillBuffer::PathFor(dir_, "spill_buffer_test"), 1 << 20,
+        [this](std::unique_ptr<std::vector<uint8_t>> &frame) {
+          sent_.push_back(frame->front());
+          frame.reset();
+          return true;
+        },
+        [this](std::chrono::milliseconds) { return ready_; }));
+  }
+
+  void TearDown() override { spill_.Close(); }
+
+  static std::unique_ptr<std::vector<uint8_t>> MakeFrame(uint8_t id) {
+    return std::make_unique<std::vector<uint8_t>>(64, id);
+  }
+
+  std::string dir_;
+  SpillBuffer spill_;
+  bool ready_ = true;
+  std::vector<uint8_t> sent_;
+};
+
+TEST_F(SpillBufferTest, SendsDirectlyWhenReady) {
+  auto frame = MakeFrame(1);
+  EXPECT_TRUE(spill_.Send(frame));
+  EXPECT_EQ(sent_, std::vector<uint8_t>{1});
+  EXPECT_EQ(spill_.GetHeldFrames(), 0u);
+}
+
+TEST_F(SpillBufferTest, HeldFramesGoFirstOnceReady) {
+  ready_ = false;
+  for (uint8_t id = 0; id < 6; ++id) {
+    auto frame = MakeFrame(id);
+    EXPECT_TRUE(spill_.Send(frame));
+  }
+  EXPECT_TRUE(sent_.empty());
+  EXPECT_EQ(spill_.GetHeldFrames(), 6u);
+  EXPECT_EQ(spill_.GetSpilledFrames(), 4u);  // Beyond the 2 in memory
+  EXPECT_GT(spill_.GetOccupancy(), 0.0);
+
+  ready_ = true;
+  auto frame = MakeFrame(6);
+  EXPECT_TRUE(spill_.Send(frame));
+  EXPECT_EQ(sent_, (std::vector<uint8_t>{0, 1, 2, 3, 4, 5, 6}));
+  EXPECT_EQ(spill_.GetFramesSpilled(), 4u);
+  EXPECT_EQ(spill_.GetFramesRestored(), 4u);
+  EXPECT_EQ(spill_.GetOccupancy(), 0.0);
+}
+
+TEST_F(SpillBufferTest, DrainSendsWithoutNewFrames) {
+  ready_ = false;
+  auto frame = MakeFrame(7);
+  spill_.Send(frame);
+  spill_.Drain();
+  EXPECT_TRUE(sent_.empty());
+
+  ready_ = true;
+  spill_.Drain();
+  EXPECT_EQ(sent_, std::vector<uint8_t>{7});
+}
+
+TEST_F(SpillBufferTest, FlushDropsWhatCannotBeSent) {
+  ready_ = false;
+  for (uint8_t id = 0; id < 4; ++id) {
+    auto frame = MakeFrame(id);
+    spill_.Send(frame);
+  }
+  EXPECT_FALSE(spill_.Flush(std::chrono::milliseconds(1)));
+  EXPECT_EQ(spill_.GetHeldFrames(), 0u);
+  EXPECT_EQ(spill_.GetFramesDropped(), 4u);
+
+  spill_.Clear();
+  EXPECT_EQ(spill_.GetFramesDropped(), 0u);
+  EXPECT_TRUE(spill_.Flush(std::chrono::milliseconds(1)));
+}
+
+}  // namespace test
+}  // namespace DELILA
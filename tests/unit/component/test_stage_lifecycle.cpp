@@ -0,0 +1,151 @@
+/**
+ * @file test_stage_lifecycle.cpp
+ * @brief Lifecycle tests shared by every StageComponent-based stage
+ *
+ * The state machine, address checks and error handling live in
+ * StageComponent, so they are checked once here for each stage type.
+ * The per-stage test files only cover what the stage adds.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "CalibrationStage.hpp"
+#include "EventBuilder.hpp"
+#include "FilterStage.hpp"
+#include "Router.hpp"
+#include "WaveformAnalyzer.hpp"
+#include "WaveformReducer.hpp"
+#include "delila/core/ComponentState.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+/// Addresses a stage needs to initialize (no sockets are opened before Arm)
+template <typename Stage>
+struct StageSetup {
+  static void Addresses(Stage &stage) {
+    stage.SetInputAddresses({"tcp://localhost:5555"});
+    stage.SetOutputAddresses({"tcp://localhost:6666"});
+  }
+};
+
+// EventBuilder is the multi-input stage, with its own worker threads
+template <>
+struct StageSetup<EventBuilder> {
+  static void Addresses(EventBuilder &stage) {
+    stage.SetInputAddresses({"tcp://localhost:5555", "tcp://localhost:5556"});
+    stage.SetOutputAddresses({"tcp://localhost:6666"});
+    stage.SetWorkerThreads(2);
+  }
+};
+
+template <typename Stage>
+class StageLifecycleTest : public ::testing::Test {
+ protected:
+  void SetUp() override { stage_ = std::make_unique<Stage>(); }
+
+  void TearDown() override {
+    if (stage_) {
+      stage_->Shutdown();
+    }
+  }
+
+  std::unique_ptr<Stage> stage_;
+};
+
+using StageTypes =
+    ::testing::Types<FilterStage, WaveformReducer, CalibrationStage,
+                     WaveformAnalyzer, Router, EventBuilder>;
+TYPED_TEST_SUITE(StageLifecycleTest, StageTypes);
+
+// === Initial State Tests ===
+
+TYPED_TEST(StageLifecycleTest, InitialStateIsIdle) {
+  auto &stage = *this->stage_;
+  EXPECT_EQ(stage.GetState(), ComponentState::Idle);
+
+  auto status = stage.GetStatus();
+  EXPECT_EQ(status.state, ComponentState::Idle);
+  EXPECT_EQ(status.metrics.events_processed, 0u);
+  EXPECT_EQ(status.metrics.bytes_transferred, 0u);
+  EXPECT_EQ(status.run_number, 0u);
+}
+
+// === State Transition Tests ===
+
+TYPED_TEST(StageLifecycleTest, InitializeFailsWithoutAddresses) {
+  auto &stage = *this->stage_;
+  EXPECT_FALSE(stage.Initialize(""));
+  stage.SetInputAddresses({"tcp://localhost:5555"});
+  EXPECT_FALSE(stage.Initialize(""));
+  EXPECT_EQ(stage.GetState(), ComponentState::Idle);
+
+  stage.SetInputAddresses({});
+  stage.SetOutputAddresses({"tcp://localhost:6666"});
+  EXPECT_FALSE(stage.Initialize(""));
+  EXPECT_EQ(stage.GetState(), ComponentState::Idle);
+}
+
+TYPED_TEST(StageLifecycleTest, InitializeRejectsUnloadableConfigFile) {
+  auto &stage = *this->stage_;
+  StageSetup<TypeParam>::Addresses(stage);
+  EXPECT_FALSE(stage.Initialize("/nonexistent/stage.json"));
+  EXPECT_EQ(stage.GetState(), ComponentState::Idle);
+  EXPECT_FALSE(stage.GetStatus().error_message.empty());
+}
+
+TYPED_TEST(StageLifecycleTest, FullLifecycle) {
+  auto &stage = *this->stage_;
+  StageSetup<TypeParam>::Addresses(stage);
+
+  EXPECT_TRUE(stage.Initialize(""));
+  EXPECT_EQ(stage.GetState(), ComponentState::Configured);
+  EXPECT_TRUE(stage.Arm());
+  EXPECT_EQ(stage.GetState(), ComponentState::Armed);
+  EXPECT_TRUE(stage.Start(3));
+  EXPECT_EQ(stage.GetState(), ComponentState::Running);
+  EXPECT_EQ(stage.GetStatus().run_number, 3u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_TRUE(stage.Stop(true));
+  EXPECT_EQ(stage.GetState(), ComponentState::Configured);
+
+  // Another run, stopped without draining
+  EXPECT_TRUE(stage.Arm());
+  EXPECT_TRUE(stage.Start(4));
+  EXPECT_EQ(stage.GetStatus().run_number, 4u);
+  EXPECT_TRUE(stage.Stop(false));
+  EXPECT_EQ(stage.GetState(), ComponentState::Configured);
+}
+
+TYPED_TEST(StageLifecycleTest, InvalidTransitionsAreRejected) {
+  auto &stage = *this->stage_;
+  EXPECT_FALSE(stage.Arm());  // Idle
+  EXPECT_FALSE(stage.Stop(true));
+
+  StageSetup<TypeParam>::Addresses(stage);
+  ASSERT_TRUE(stage.Initialize(""));
+  EXPECT_FALSE(stage.Start(1));  // Configured
+  EXPECT_FALSE(stage.Stop(true));
+  EXPECT_EQ(stage.GetState(), ComponentState::Configured);
+}
+
+TYPED_TEST(StageLifecycleTest, ErrorToIdle) {
+  auto &stage = *this->stage_;
+  stage.ForceError("Test error");
+  EXPECT_EQ(stage.GetState(), ComponentState::Error);
+  EXPECT_EQ(stage.GetStatus().error_message, "Test error");
+
+  stage.Reset();
+  EXPECT_EQ(stage.GetState(), ComponentState::Idle);
+  EXPECT_TRUE(stage.GetStatus().error_message.empty());
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -0,0 +1,186 @@
+/**
+ * @file test_waveform_analyzer.cpp
+ * @brief Unit tests for WaveformAnalyzer component
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "WaveformAnalyzer.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+class WaveformAnalyzerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { analyzer_ = std::make_unique<WaveformAnalyzer>(); }
+
+  void TearDown() override {
+    if (analyzer_) {
+      analyzer_->Shutdown();
+    }
+  }
+
+  std::unique_ptr<WaveformAnalyzer> analyzer_;
+};
+
+// === Initial State Tests ===
+
+TEST_F(WaveformAnalyzerTest, InitialDefaults) {
+  EXPECT_EQ(analyzer_->GetWorkerThreads(), 2u);
+  EXPECT_EQ(analyzer_->GetSettings().polarity, -1);
+  EXPECT_EQ(analyzer_->GetEventsAnalyzed(), 0u);
+  EXPECT_EQ(analyzer_->GetCfdFailures(), 0u);
+}
+
+// === Configuration Tests ===
+
+TEST_F(WaveformAnalyzerTest, Configuration) {
+  analyzer_->SetWorkerThreads(0);
+  EXPECT_EQ(analyzer_->GetWorkerThreads(), 1u);
+  analyzer_->SetWorkerThreads(4);
+  EXPECT_EQ(analyzer_->GetWorkerThreads(), 4u);
+
+  PulseAnalyzer::Settings settings;
+  settings.shortGate = 30;
+  EXPECT_TRUE(analyzer_->SetSettings(settings));
+  EXPECT_EQ(analyzer_->GetSettings().shortGate, 30u);
+
+  std::string error;
+  settings.shortGate = 500;
+  EXPECT_FALSE(analyzer_->SetSettings(settings, &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_EQ(analyzer_->GetSettings().shortGate, 30u);
+}
+
+TEST_F(WaveformAnalyzerTest, SettingsAreFixedWhileRunning) {
+  analyzer_->SetInputAddresses({"tcp://localhost:5555"});
+  analyzer_->SetOutputAddresses({"tcp://localhost:6666"});
+
+  ASSERT_TRUE(analyzer_->Initialize(""));
+  ASSERT_TRUE(analyzer_->Arm());
+  ASSERT_TRUE(analyzer_->Start(5));
+
+  EXPECT_FALSE(analyzer_->SetSettings(PulseAnalyzer::Settings()));
+  analyzer_->SetWorkerThreads(8);
+  EXPECT_EQ(analyzer_->GetWorkerThreads(), 2u);
+  EXPECT_TRUE(analyzer_->Stop(true));
+}
+
+// === Analysis Tests ===
+
+// With several workers the frames still come out in input order, every
+// event with a waveform is analyzed and events without one are untouched
+TEST_F(WaveformAnalyzerTest, AnalyzesInOrderWithSeveralWorkers) {
+  constexpr int kFrames = 40;
+  constexpr int kEventsPerFrame = 50;
+  constexpr size_t kSamples = 256;
+
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://waveform_analyzer_test_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  analyzer_->SetInputAddresses({"inproc://waveform_analyzer_test_in"});
+  analyzer_->SetOutputAddresses({"inproc://waveform_analyzer_test_out"});
+  analyzer_->SetWorkerThreads(4);
+  ASSERT_TRUE(analyzer_->Initialize(""));
+  ASSERT_TRUE(analyzer_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://waveform_analyzer_test_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(analyzer_->Start(1));
+
+  // Rectangular negative pulse of 100 counts over samples 60..79: with the
+  // default gates (open at 56) short = 20 * 100 and long = 20 * 100
+  Net::DataProcessor processor;
+  uint64_t expectedAnalyzed = 0;
+  for (int f = 0; f < kFrames; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::EventData>>>();
+    for (int e = 0; e < kEventsPerFrame; ++e) {
+      int n = f * kEventsPerFrame + e;
+      bool withWaveform = (n % 5 != 0);
+      auto event =
+          std::make_unique<Digitizer::EventData>(withWaveform ? kSamples : 0);
+      event->module = 0;
+      event->channel = static_cast<uint8_t>(n % 8);
+      event->timeStampNs = 1000.0 * n;
+      event->energy = 7;
+      event->energyShort = 3;
+      if (withWaveform) {
+        std::fill(event->analogProbe1.begin(), event->analogProbe1.end(), 8000);
+        for (size_t i = 60; i < 80; ++i) {
+          event->analogProbe1[i] = 7900;
+        }
+        expectedAnalyzed++;
+      }
+      events->push_back(std::move(event));
+    }
+    auto frame = processor.Process(events, 500 + f);
+    ASSERT_TRUE(source.SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source.SendBytes(eos));
+
+  int received = 0;
+  uint64_t expectedSequence = 500;
+  bool gotEos = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+    auto data = sink.ReceiveBytes();
+    if (!data) {
+      continue;
+    }
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      gotEos = true;
+      break;
+    }
+    auto [events, sequence] = processor.Decode(data);
+    ASSERT_NE(events, nullptr);
+    ASSERT_EQ(events->size(), static_cast<size_t>(kEventsPerFrame));
+    EXPECT_EQ(sequence, expectedSequence++);
+    for (const auto &event : *events) {
+      int n = received++;
+      if (n % 5 == 0) {
+        EXPECT_EQ(event->energy, 7);
+        EXPECT_EQ(event->flags, 0u);
+        EXPECT_DOUBLE_EQ(event->timeStampNs, 1000.0 * n);
+      } else {
+        EXPECT_EQ(event->energy, 2000);
+        EXPECT_EQ(event->energyShort, 2000);
+        EXPECT_EQ(event->flags, PulseAnalyzer::FLAG_ANALYZED);
+        EXPECT_NEAR(event->timeStampNs, 1000.0 * n, 20.0);
+      }
+    }
+  }
+
+  EXPECT_TRUE(gotEos);
+  EXPECT_EQ(received, kFrames * kEventsPerFrame);
+  EXPECT_TRUE(analyzer_->Stop(true));
+  EXPECT_EQ(analyzer_->GetEventsAnalyzed(), expectedAnalyzed);
+  EXPECT_EQ(analyzer_->GetCfdFailures(), 0u);
+  EXPECT_EQ(analyzer_->GetStatus().metrics.events_processed,
+            static_cast<uint64_t>(kFrames * kEventsPerFrame));
+}
+
+}  // namespace test
+}  // namespace DELILA
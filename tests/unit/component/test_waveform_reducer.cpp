@@ -0,0 +1,270 @@
+/**
+ * @file test_waveform_reducer.cpp
+ * @brief Unit tests for WaveformReducer component
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <DataProcessor.hpp>
+#include <ZMQTransport.hpp>
+
+#include "WaveformReducer.hpp"
+#include "delila/core/ComponentStatus.hpp"
+
+namespace DELILA {
+namespace test {
+
+class WaveformReducerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { reducer_ = std::make_unique<WaveformReducer>(); }
+
+  void TearDown() override {
+    if (reducer_) {
+      reducer_->Shutdown();
+    }
+  }
+
+  std::unique_ptr<WaveformReducer> reducer_;
+};
+
+// === Initial State Tests ===
+
+TEST_F(WaveformReducerTest, InitialDefaults) {
+  EXPECT_EQ(reducer_->GetPrescale(), 0u);
+  EXPECT_TRUE(reducer_->GetWaveformChannels().empty());
+  EXPECT_TRUE(reducer_->GetRules().empty());
+  EXPECT_EQ(reducer_->GetWaveformsKept(), 0u);
+}
+
+// === Configuration Tests ===
+
+TEST_F(WaveformReducerTest, Configuration) {
+  reducer_->SetPrescale(100);
+  reducer_->SetWaveformChannels({{0, 3}, {1, 7}});
+  EXPECT_TRUE(reducer_->AddRule("psd > 0.2"));
+  EXPECT_FALSE(reducer_->AddRule("psd >"));
+
+  EXPECT_EQ(reducer_->GetPrescale(), 100u);
+  EXPECT_EQ(reducer_->GetWaveformChannels().size(), 2u);
+  ASSERT_EQ(reducer_->GetRules().size(), 1u);
+
+  reducer_->ClearRules();
+  EXPECT_TRUE(reducer_->GetRules().empty());
+}
+
+TEST_F(WaveformReducerTest, SelectionIsFixedWhileRunning) {
+  reducer_->SetInputAddresses({"tcp://localhost:5555"});
+  reducer_->SetOutputAddresses({"tcp://localhost:6666"});
+
+  ASSERT_TRUE(reducer_->Initialize(""));
+  ASSERT_TRUE(reducer_->Arm());
+  ASSERT_TRUE(reducer_->Start(5));
+
+  reducer_->SetPrescale(10);
+  EXPECT_EQ(reducer_->GetPrescale(), 0u);
+  EXPECT_FALSE(reducer_->AddRule("energy > 10"));
+  EXPECT_TRUE(reducer_->Stop(true));
+}
+
+// === Reduction Tests ===
+
+// Every event comes out as a minimal hit; waveforms are kept for every
+// tenth event, for channel 3 and for high energies, in a full frame that
+// follows its minimal frame with the next sequence number and the
+// companion flag.
+TEST_F(WaveformReducerTest, SplitsFramesAndKeepsSelectedWaveforms) {
+  constexpr int kFrames = 10;
+  constexpr int kEventsPerFrame = 100;
+  constexpr size_t kSamples = 64;
+
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://waveform_reducer_test_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  reducer_->SetInputAddresses({"inproc://waveform_reducer_test_in"});
+  reducer_->SetOutputAddresses({"inproc://waveform_reducer_test_out"});
+  reducer_->SetPrescale(10);
+  reducer_->SetWaveformChannels({{0, 3}});
+  ASSERT_TRUE(reducer_->AddRule("energy >= 3000"));
+  ASSERT_TRUE(reducer_->Initialize(""));
+  ASSERT_TRUE(reducer_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://waveform_reducer_test_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(reducer_->Start(1));
+
+  Net::DataProcessor processor;
+  uint64_t expectedKept = 0;
+  for (int f = 0; f < kFrames; ++f) {
+    auto events = std::make_unique<
+        std::vector<std::unique_ptr<Digitizer::EventData>>>();
+    for (int e = 0; e < kEventsPerFrame; ++e) {
+      int n = f * kEventsPerFrame + e;
+      auto event = std::make_unique<Digitizer::EventData>(kSamples);
+      event->module = 0;
+      event->channel = static_cast<uint8_t>(n % 8);
+      event->timeStampNs = 100.0 * n;
+      event->energy = static_cast<uint16_t>((n % 7 == 0) ? 3500 : 500);
+      event->energyShort = 100;
+      event->analogProbe1[0] = static_cast<int32_t>(n);
+      expectedKept += (n % 10 == 0) || (n % 8 == 3) || (n % 7 == 0);
+      events->push_back(std::move(event));
+    }
+    auto frame = processor.Process(events, 1000 + f);
+    ASSERT_TRUE(source.SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source.SendBytes(eos));
+
+  uint64_t minimalEvents = 0;
+  uint64_t waveformEvents = 0;
+  uint64_t lastMinimalSequence = UINT64_MAX;
+  uint64_t lastSequence = UINT64_MAX;
+  bool gotEos = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+    auto data = sink.ReceiveBytes();
+    if (!data) {
+      continue;
+    }
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      gotEos = true;
+      break;
+    }
+    Net::BinaryDataHeader header;
+    ASSERT_TRUE(Net::DataProcessor::PeekHeader(*data, header));
+    if (header.format_version == Net::FORMAT_VERSION_MINIMAL_EVENTDATA) {
+      auto [events, sequence] = processor.DecodeMinimal(data);
+      ASSERT_NE(events, nullptr);
+      EXPECT_EQ(events->size(), static_cast<size_t>(kEventsPerFrame));
+      minimalEvents += events->size();
+      EXPECT_EQ(header.frame_flags, 0u);
+      if (lastSequence != UINT64_MAX) {
+        EXPECT_EQ(sequence, lastSequence + 1);
+      }
+      lastSequence = sequence;
+      lastMinimalSequence = sequence;
+    } else {
+      ASSERT_EQ(header.format_version, Net::FORMAT_VERSION_EVENTDATA);
+      auto [events, sequence] = processor.Decode(data);
+      ASSERT_NE(events, nullptr);
+      EXPECT_EQ(sequence, lastMinimalSequence + 1);
+      EXPECT_EQ(sequence, lastSequence + 1);
+      EXPECT_EQ(header.frame_flags, Net::FRAME_FLAG_WAVEFORM_COMPANION);
+      lastSequence = sequence;
+      for (const auto &event : *events) {
+        int n = static_cast<int>(event->timeStampNs / 100.0 + 0.5);
+        EXPECT_TRUE((n % 10 == 0) || (n % 8 == 3) || (n % 7 == 0)) << n;
+        ASSERT_EQ(event->waveformSize, kSamples);
+        EXPECT_EQ(event->analogProbe1[0], n);
+        waveformEvents++;
+      }
+    }
+  }
+
+  EXPECT_TRUE(gotEos);
+  EXPECT_EQ(minimalEvents, static_cast<uint64_t>(kFrames * kEventsPerFrame));
+  EXPECT_EQ(waveformEvents, expectedKept);
+  EXPECT_TRUE(reducer_->Stop(true));
+  EXPECT_EQ(reducer_->GetWaveformsKept(), expectedKept);
+  EXPECT_EQ(reducer_->GetStatus().metrics.events_processed,
+            static_cast<uint64_t>(kFrames * kEventsPerFrame));
+}
+
+// Frames the reducer cannot reduce (here minimal ones) are forwarded
+// unchanged, but numbered in the same sequence as the reduced frames
+TEST_F(WaveformReducerTest, RenumbersForwardedFrames) {
+  Net::ZMQTransport source;
+  Net::TransportConfig sourceConfig;
+  sourceConfig.data_address = "inproc://waveform_reducer_mixed_in";
+  sourceConfig.bind_data = true;
+  sourceConfig.data_pattern = "PUSH";
+  sourceConfig.status_address = sourceConfig.data_address;
+  sourceConfig.command_address = "";
+  ASSERT_TRUE(source.Configure(sourceConfig));
+  ASSERT_TRUE(source.Connect());
+
+  reducer_->SetInputAddresses({"inproc://waveform_reducer_mixed_in"});
+  reducer_->SetOutputAddresses({"inproc://waveform_reducer_mixed_out"});
+  ASSERT_TRUE(reducer_->Initialize(""));
+  ASSERT_TRUE(reducer_->Arm());
+
+  Net::ZMQTransport sink;
+  Net::TransportConfig sinkConfig;
+  sinkConfig.data_address = "inproc://waveform_reducer_mixed_out";
+  sinkConfig.bind_data = false;
+  sinkConfig.data_pattern = "PULL";
+  sinkConfig.status_address = sinkConfig.data_address;
+  sinkConfig.command_address = "";
+  ASSERT_TRUE(sink.Configure(sinkConfig));
+  ASSERT_TRUE(sink.Connect());
+
+  ASSERT_TRUE(reducer_->Start(1));
+
+  // Full, minimal, full, minimal: upstream numbers far from the output's
+  Net::DataProcessor processor;
+  constexpr int kFrames = 4;
+  for (int f = 0; f < kFrames; ++f) {
+    std::unique_ptr<std::vector<uint8_t>> frame;
+    if (f % 2 == 0) {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<Digitizer::EventData>>>();
+      auto event = std::make_unique<Digitizer::EventData>(0);
+      event->timeStampNs = 100.0 * f;
+      events->push_back(std::move(event));
+      frame = processor.Process(events, 500 + f);
+    } else {
+      auto events = std::make_unique<
+          std::vector<std::unique_ptr<Digitizer::MinimalEventData>>>();
+      events->push_back(std::make_unique<Digitizer::MinimalEventData>(
+          0, 1, 100.0 * f, 500, 100, 0));
+      frame = processor.Process(events, 500 + f);
+    }
+    ASSERT_TRUE(source.SendBytes(frame));
+  }
+  auto eos = processor.CreateEOSMessage();
+  ASSERT_TRUE(source.SendBytes(eos));
+
+  std::vector<uint64_t> sequences;
+  bool gotEos = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!gotEos && std::chrono::steady_clock::now() < deadline) {
+    auto data = sink.ReceiveBytes();
+    if (!data) {
+      continue;
+    }
+    if (Net::DataProcessor::IsEOSMessage(*data)) {
+      gotEos = true;
+      break;
+    }
+    Net::BinaryDataHeader header;
+    ASSERT_TRUE(Net::DataProcessor::PeekHeader(*data, header));
+    EXPECT_EQ(header.format_version, Net::FORMAT_VERSION_MINIMAL_EVENTDATA);
+    auto [events, sequence] = processor.DecodeMinimal(data);
+    ASSERT_NE(events, nullptr);  // Forwarded frames still decode
+    sequences.push_back(sequence);
+  }
+
+  EXPECT_TRUE(gotEos);
+  EXPECT_EQ(sequences, (std::vector<uint64_t>{0, 1, 2, 3}));
+  EXPECT_TRUE(reducer_->Stop(true));
+}
+
+}  // namespace test
+}  // namespace DELILA
@@ -0,0 +1,162 @@
+/**
+ * @file test_configuration_engine.cpp
+ * @brief Unit tests for ParameterApplier
+ */
+
+#include <gtest/gtest.h>
+
+#include <ConfigurationEngine.hpp>
+
+namespace DELILA {
+namespace test {
+
+using Digitizer::ParameterApplier;
+
+namespace {
+
+// Records every SetValue call issued by the applier
+struct RecordingSetter {
+  std::vector<std::pair<std::string, std::string>> calls;
+  bool result = true;
+
+  ParameterApplier::Setter AsSetter() {
+    return [this](const std::string &path, const std::string &value) {
+      calls.emplace_back(path, value);
+      return result;
+    };
+  }
+};
+
+} // namespace
+
+// === Channel expansion ===
+
+TEST(ParameterApplierTest, ExpandChannelRange) {
+  auto paths = ParameterApplier::ExpandChannels("/ch/2..4/par/TriggerThr");
+  ASSERT_EQ(paths.size(), 3u);
+  EXPECT_EQ(paths[0], "/ch/2/par/TriggerThr");
+  EXPECT_EQ(paths[2], "/ch/4/par/TriggerThr");
+}
+
+TEST(ParameterApplierTest, ExpandWithoutRangeIsIdentity) {
+  auto paths = ParameterApplier::ExpandChannels("/par/StartSource");
+  ASSERT_EQ(paths.size(), 1u);
+  EXPECT_EQ(paths[0], "/par/StartSource");
+}
+
+// === Planning ===
+
+TEST(ParameterApplierTest, FirstPlanWritesEverything) {
+  ParameterApplier applier;
+  ParameterApplier::Config config = {{"URL", "dig2://host"},
+                                     {"/par/StartSource", "SWcmd"},
+                                     {"/ch/0..31/par/ChEnable", "True"}};
+
+  size_t unchanged = 0;
+  auto writes = applier.Plan(config, &unchanged);
+
+  // Non-device keys are skipped, the range stays a single write
+  ASSERT_EQ(writes.size(), 2u);
+  EXPECT_EQ(writes[0].path, "/par/StartSource");
+  EXPECT_EQ(writes[1].path, "/ch/0..31/par/ChEnable");
+  EXPECT_EQ(writes[1].channels, 32u);
+  EXPECT_EQ(unchanged, 0u);
+}
+
+TEST(ParameterApplierTest, UnchangedConfigPlansNoWrites) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  ParameterApplier::Config config = {{"/par/StartSource", "SWcmd"},
+                                     {"/ch/0..31/par/TriggerThr", "500"}};
+
+  applier.Apply(applier.Plan(config), setter.AsSetter());
+
+  size_t unchanged = 0;
+  auto writes = applier.Plan(config, &unchanged);
+  EXPECT_TRUE(writes.empty());
+  EXPECT_EQ(unchanged, 33u);
+}
+
+TEST(ParameterApplierTest, ChangedChannelsAreCoalesced) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  applier.Apply(applier.Plan({{"/ch/0..7/par/TriggerThr", "500"}}),
+                setter.AsSetter());
+
+  // Channel 3 was changed behind a single-channel override
+  applier.Apply(applier.Plan({{"/ch/0..7/par/TriggerThr", "500"},
+                              {"/ch/3/par/TriggerThr", "800"}}),
+                setter.AsSetter());
+
+  // Back to a uniform value: only channel 3 needs rewriting
+  auto writes = applier.Plan({{"/ch/0..7/par/TriggerThr", "600"}});
+  ASSERT_EQ(writes.size(), 1u);
+  EXPECT_EQ(writes[0].path, "/ch/0..7/par/TriggerThr");
+
+  setter.calls.clear();
+  applier.Apply(writes, setter.AsSetter());
+  writes = applier.Plan({{"/ch/0..7/par/TriggerThr", "600"},
+                         {"/ch/2..3/par/TriggerThr", "700"}});
+  ASSERT_EQ(writes.size(), 1u);
+  EXPECT_EQ(writes[0].path, "/ch/2..3/par/TriggerThr");
+  EXPECT_EQ(writes[0].channels, 2u);
+}
+
+TEST(ParameterApplierTest, PathComparisonIgnoresCase) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  applier.Apply(applier.Plan({{"/par/StartSource", "SWcmd"}}),
+                setter.AsSetter());
+
+  EXPECT_TRUE(applier.Plan({{"/par/startsource", "SWcmd"}}).empty());
+}
+
+TEST(ParameterApplierTest, FailedWriteIsRetried) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  setter.result = false;
+  ParameterApplier::Config config = {{"/par/StartSource", "SWcmd"}};
+
+  EXPECT_EQ(applier.Apply(applier.Plan(config), setter.AsSetter()), 1u);
+  EXPECT_EQ(applier.Plan(config).size(), 1u);
+}
+
+// === Reset decision ===
+
+TEST(ParameterApplierTest, NeedsResetInitially) {
+  ParameterApplier applier;
+  EXPECT_TRUE(applier.NeedsReset({{"/par/StartSource", "SWcmd"}}));
+}
+
+TEST(ParameterApplierTest, NoResetWhenParametersOnlyChange) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  applier.Apply(applier.Plan({{"/ch/0..3/par/TriggerThr", "500"}}),
+                setter.AsSetter());
+
+  EXPECT_FALSE(applier.NeedsReset({{"/ch/0..3/par/TriggerThr", "900"}}));
+}
+
+TEST(ParameterApplierTest, ResetWhenParameterRemoved) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  applier.Apply(applier.Plan({{"/ch/0..3/par/TriggerThr", "500"}}),
+                setter.AsSetter());
+
+  EXPECT_TRUE(applier.NeedsReset({{"/ch/0..2/par/TriggerThr", "500"}}));
+}
+
+TEST(ParameterApplierTest, InvalidateForgetsState) {
+  ParameterApplier applier;
+  RecordingSetter setter;
+  ParameterApplier::Config config = {{"/par/StartSource", "SWcmd"}};
+  applier.Apply(applier.Plan(config), setter.AsSetter());
+  EXPECT_EQ(applier.GetAppliedCount(), 1u);
+
+  applier.Invalidate();
+  EXPECT_EQ(applier.GetAppliedCount(), 0u);
+  EXPECT_EQ(applier.Plan(config).size(), 1u);
+}
+
+} // namespace test
+} // namespace DELILA
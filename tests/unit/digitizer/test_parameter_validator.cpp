@@ -0,0 +1,187 @@
+/**
+ * @file test_parameter_validator.cpp
+ * @brief Unit tests for the indexed ParameterValidator
+ */
+
+#include <gtest/gtest.h>
+
+#include <ParameterValidator.hpp>
+
+namespace DELILA {
+namespace test {
+
+using Digitizer::ParameterValidator;
+
+class ParameterValidatorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Minimal device tree in the FELib layout: two identical channels
+    tree_ = nlohmann::json::parse(R"({
+      "par": {
+        "startsource": {
+          "datatype": {"value": "STRING"},
+          "allowedvalues": {
+            "0": {"handle": 1, "value": "SWcmd"},
+            "1": {"handle": 2, "value": "EncodedClkIn"},
+            "handle": 3, "value": "2"
+          },
+          "description": {"value": "Start source"}
+        },
+        "recordlengths": {
+          "datatype": {"value": "NUMBER"},
+          "minvalue": {"value": "4"},
+          "maxvalue": {"value": "8100"}
+        }
+      },
+      "ch": {
+        "0": {"par": {
+          "triggerthr": {
+            "datatype": {"value": "NUMBER"},
+            "minvalue": {"value": "0"},
+            "maxvalue": {"value": "8191"}
+          },
+          "pulsepolarity": {
+            "datatype": {"value": "STRING"},
+            "allowedvalues": {
+              "0": {"value": "Positive"}, "1": {"value": "Negative"},
+              "handle": 9, "value": "2"
+            }
+          }
+        }},
+        "1": {"par": {
+          "triggerthr": {
+            "datatype": {"value": "NUMBER"},
+            "minvalue": {"value": "0"},
+            "maxvalue": {"value": "8191"}
+          },
+          "pulsepolarity": {
+            "datatype": {"value": "STRING"},
+            "allowedvalues": {
+              "0": {"value": "Positive"}, "1": {"value": "Negative"},
+              "handle": 9, "value": "2"
+            }
+          }
+        }},
+        "handle": 100
+      }
+    })");
+    validator_ = std::make_unique<ParameterValidator>(tree_);
+    validator_->SetSilentMode(true);
+  }
+
+  nlohmann::json tree_;
+  std::unique_ptr<ParameterValidator> validator_;
+};
+
+// === Index ===
+
+TEST_F(ParameterValidatorTest, IdenticalChannelsShareOneEntry) {
+  // 2 root + 2 channel parameters, regardless of channel count
+  EXPECT_EQ(validator_->GetIndexSize(), 4u);
+}
+
+TEST_F(ParameterValidatorTest, LookupIsCaseInsensitive) {
+  EXPECT_TRUE(validator_->IsParameterSupported("/ch/1/par/TriggerThr"));
+  EXPECT_TRUE(validator_->IsParameterSupported("/par/StartSource"));
+}
+
+TEST_F(ParameterValidatorTest, UnknownChannelIsNotSupported) {
+  EXPECT_FALSE(validator_->IsParameterSupported("/ch/2/par/TriggerThr"));
+}
+
+TEST_F(ParameterValidatorTest, PrecomputedRangeAndAllowedValues) {
+  auto range = validator_->GetParameterRange("/ch/0/par/TriggerThr");
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(range->first, "0");
+  EXPECT_EQ(range->second, "8191");
+
+  auto allowed = validator_->GetAllowedValues("/par/StartSource");
+  ASSERT_EQ(allowed.size(), 2u);
+  EXPECT_EQ(allowed[0], "SWcmd");
+  EXPECT_EQ(allowed[1], "EncodedClkIn");
+}
+
+TEST_F(ParameterValidatorTest, ChannelParametersAreListed) {
+  auto params = validator_->GetChannelParameters("1");
+  ASSERT_EQ(params.size(), 2u);
+  EXPECT_EQ(params[0], "/ch/1/par/pulsepolarity");
+  EXPECT_EQ(params[1], "/ch/1/par/triggerthr");
+
+  EXPECT_TRUE(validator_->GetChannelParameters("7").empty());
+}
+
+TEST_F(ParameterValidatorTest, DifferingChannelGetsOwnEntry) {
+  tree_["ch"]["1"]["par"]["triggerthr"]["maxvalue"]["value"] = "100";
+  ParameterValidator validator(tree_);
+
+  EXPECT_EQ(validator.GetIndexSize(), 5u);
+  EXPECT_TRUE(validator.ValidateParameter("/ch/0/par/TriggerThr", "500").isValid);
+  EXPECT_FALSE(validator.ValidateParameter("/ch/1/par/TriggerThr", "500").isValid);
+}
+
+// === Validation ===
+
+TEST_F(ParameterValidatorTest, NumberRange) {
+  EXPECT_TRUE(validator_->ValidateParameter("/ch/0/par/TriggerThr", "500").isValid);
+  EXPECT_FALSE(validator_->ValidateParameter("/ch/0/par/TriggerThr", "9000").isValid);
+  EXPECT_FALSE(validator_->ValidateParameter("/par/RecordLengths", "abc").isValid);
+}
+
+TEST_F(ParameterValidatorTest, IntegerRangeBeyondInt) {
+  // 48-bit register: limits and values outside int range
+  tree_["par"]["timestampoffset"] = nlohmann::json::parse(R"({
+    "datatype": {"value": "INTEGER"},
+    "minvalue": {"value": "-1"},
+    "maxvalue": {"value": "281474976710655"}
+  })");
+  ParameterValidator validator(tree_);
+
+  EXPECT_TRUE(validator.ValidateParameter("/par/TimestampOffset", "5000000000").isValid);
+  EXPECT_TRUE(validator.ValidateParameter("/par/TimestampOffset", "-1").isValid);
+  EXPECT_FALSE(validator.ValidateParameter("/par/TimestampOffset", "-2").isValid);
+  EXPECT_FALSE(validator.ValidateParameter("/par/TimestampOffset", "281474976710656").isValid);
+}
+
+TEST_F(ParameterValidatorTest, AllowedValuesIgnoreCase) {
+  EXPECT_TRUE(validator_->ValidateParameter("/ch/0/par/PulsePolarity", "negative").isValid);
+  EXPECT_FALSE(validator_->ValidateParameter("/ch/0/par/PulsePolarity", "Bipolar").isValid);
+}
+
+TEST_F(ParameterValidatorTest, UnknownParameterPolicy) {
+  EXPECT_FALSE(validator_->ValidateParameter("/par/NoSuchParam", "1").isValid);
+
+  validator_->SetAllowUnknownParameters(true);
+  auto result = validator_->ValidateParameter("/par/NoSuchParam", "1");
+  EXPECT_TRUE(result.isValid);
+  EXPECT_FALSE(result.warningMessage.empty());
+}
+
+TEST_F(ParameterValidatorTest, BoardConfigSummary) {
+  std::vector<std::array<std::string, 2>> config = {
+      {"URL", "dig2://host"},
+      {"/par/StartSource", "SWcmd"},
+      {"/ch/0..1/par/TriggerThr", "500"},
+      {"/ch/0..1/par/PulsePolarity", "Sideways"}};
+
+  auto summary = validator_->ValidateParameters(config);
+  EXPECT_EQ(summary.totalParameters, 3u);
+  EXPECT_EQ(summary.validParameters, 2u);
+  EXPECT_EQ(summary.invalidParameters, 1u);
+}
+
+TEST_F(ParameterValidatorTest, CustomValidatorSeesDefinition) {
+  bool sawDefinition = false;
+  validator_->AddCustomValidator(
+      ".*TriggerThr",
+      [&](const std::string &path, const std::string &value,
+          const nlohmann::json &paramDef) {
+        sawDefinition = paramDef.contains("maxvalue");
+        return ParameterValidator::ValidationResult(true, path, value);
+      });
+
+  EXPECT_TRUE(validator_->ValidateParameter("/ch/0/par/TriggerThr", "99999").isValid);
+  EXPECT_TRUE(sawDefinition);
+}
+
+} // namespace test
+} // namespace DELILA
@@ -1117,4 +1117,133 @@ TEST_F(EOSMessageTest, DataMessageHasDataMessageType) {
 
     const BinaryDataHeader* header = reinterpret_cast<const BinaryDataHeader*>(data_message->data());
     EXPECT_EQ(header->message_type, MESSAGE_TYPE_DATA);
-}
\ No newline at end of file
+}
+// Test PeekHeader (header-only decode)
+TEST_F(EOSMessageTest, PeekHeaderReadsDataHeader) {
+    auto events = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    for (int i = 0; i < 3; ++i) {
+        events->push_back(std::make_unique<MinimalEventData>(0, i, 1000.0 * i, 100, 50, 0));
+    }
+
+    auto data_message = processor->Process(events, 42);
+    ASSERT_NE(data_message, nullptr);
+
+    BinaryDataHeader header{};
+    ASSERT_TRUE(DataProcessor::PeekHeader(*data_message, header));
+    EXPECT_EQ(header.sequence_number, 42u);
+    EXPECT_EQ(header.event_count, 3u);
+    EXPECT_EQ(header.format_version, FORMAT_VERSION_MINIMAL_EVENTDATA);
+    EXPECT_EQ(header.message_type, MESSAGE_TYPE_DATA);
+    EXPECT_GT(header.timestamp, 0u);
+}
+
+TEST_F(EOSMessageTest, PeekHeaderRejectsShortOrForeignData) {
+    BinaryDataHeader header{};
+    std::vector<uint8_t> small_data(10, 0);
+    EXPECT_FALSE(DataProcessor::PeekHeader(small_data, header));
+    EXPECT_FALSE(DataProcessor::PeekHeader(nullptr, 64, header));
+
+    std::vector<uint8_t> foreign(sizeof(BinaryDataHeader), 0xAB);
+    EXPECT_FALSE(DataProcessor::PeekHeader(foreign, header));
+}
+
+// Test the merger stamp: header only, payload and checksum untouched
+TEST_F(EOSMessageTest, MergeStampKeepsFrameValid) {
+    auto events = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    events->push_back(std::make_unique<MinimalEventData>(0, 1, 1000.0, 100, 50, 0));
+
+    auto data_message = processor->Process(events, 7);
+    ASSERT_NE(data_message, nullptr);
+
+    BinaryDataHeader header{};
+    ASSERT_TRUE(DataProcessor::PeekHeader(*data_message, header));
+    EXPECT_EQ(header.source_id, 0u);
+    EXPECT_EQ(DataProcessor::GetStreamSequence(header), 7u);
+
+    ASSERT_TRUE(DataProcessor::SetSourceId(*data_message, 3));
+    ASSERT_TRUE(DataProcessor::SetMergeSequence(*data_message, 0x123456789AULL));
+    ASSERT_TRUE(DataProcessor::PeekHeader(*data_message, header));
+    EXPECT_EQ(header.source_id, 3u);
+    EXPECT_EQ(header.sequence_number, 7u);
+    EXPECT_EQ(DataProcessor::GetMergeSequence(header), 0x123456789AULL);
+    EXPECT_EQ(DataProcessor::GetStreamSequence(header), 0x123456789AULL);
+
+    auto [decoded, sequence] = processor->DecodeMinimal(data_message);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded->size(), 1u);
+    EXPECT_EQ(sequence, 7u);
+
+    std::vector<uint8_t> small_data(10, 0);
+    EXPECT_FALSE(DataProcessor::SetSourceId(small_data, 1));
+    EXPECT_FALSE(DataProcessor::SetMergeSequence(small_data, 1));
+    EXPECT_FALSE(DataProcessor::SetFrameFlags(small_data, 1));
+}
+
+// Frame flags are header only as well
+TEST_F(EOSMessageTest, FrameFlagsKeepFrameValid) {
+    auto events = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    events->push_back(std::make_unique<MinimalEventData>(0, 1, 1000.0, 100, 50, 0));
+
+    auto data_message = processor->Process(events, 8);
+    ASSERT_NE(data_message, nullptr);
+
+    BinaryDataHeader header{};
+    ASSERT_TRUE(DataProcessor::PeekHeader(*data_message, header));
+    EXPECT_EQ(header.frame_flags, 0u);
+
+    ASSERT_TRUE(DataProcessor::SetFrameFlags(*data_message,
+                                             FRAME_FLAG_WAVEFORM_COMPANION));
+    ASSERT_TRUE(DataProcessor::PeekHeader(*data_message, header));
+    EXPECT_EQ(header.frame_flags, FRAME_FLAG_WAVEFORM_COMPANION);
+    EXPECT_EQ(header.sequence_number, 8u);
+
+    auto [decoded, sequence] = processor->DecodeMinimal(data_message);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(sequence, 8u);
+}
+
+// Stamps carried over to a re-encoded frame, and renumbering that follows
+// the merge sequence of a merged frame
+TEST_F(EOSMessageTest, CopySourceStampsAndSetStreamSequence) {
+    auto events = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    events->push_back(std::make_unique<MinimalEventData>(0, 1, 1000.0, 100, 50, 0));
+
+    auto source = processor->Process(events, 4);
+    ASSERT_NE(source, nullptr);
+    ASSERT_TRUE(DataProcessor::SetSourceId(*source, 2));
+    ASSERT_TRUE(DataProcessor::SetMergeSequence(*source, 90));
+    ASSERT_TRUE(DataProcessor::SetFrameFlags(*source, FRAME_FLAG_WAVEFORM_COMPANION));
+    BinaryDataHeader from{};
+    ASSERT_TRUE(DataProcessor::PeekHeader(*source, from));
+
+    auto copy = processor->Process(events, 4);
+    ASSERT_NE(copy, nullptr);
+    ASSERT_TRUE(DataProcessor::CopySourceStamps(from, *copy));
+    BinaryDataHeader header{};
+    ASSERT_TRUE(DataProcessor::PeekHeader(*copy, header));
+    EXPECT_EQ(header.timestamp, from.timestamp);
+    EXPECT_EQ(header.source_id, 2u);
+    EXPECT_EQ(DataProcessor::GetMergeSequence(header), 90u);
+    EXPECT_EQ(header.frame_flags, FRAME_FLAG_WAVEFORM_COMPANION);
+
+    // Merged: both numbers follow
+    ASSERT_TRUE(DataProcessor::SetStreamSequence(*copy, 17));
+    ASSERT_TRUE(DataProcessor::PeekHeader(*copy, header));
+    EXPECT_EQ(header.sequence_number, 17u);
+    EXPECT_EQ(DataProcessor::GetStreamSequence(header), 17u);
+
+    // Not merged: the merge sequence stays unset
+    auto plain = processor->Process(events, 4);
+    ASSERT_TRUE(DataProcessor::SetStreamSequence(*plain, 18));
+    ASSERT_TRUE(DataProcessor::PeekHeader(*plain, header));
+    EXPECT_EQ(header.sequence_number, 18u);
+    EXPECT_EQ(DataProcessor::GetMergeSequence(header), 0u);
+
+    auto [decoded, sequence] = processor->DecodeMinimal(copy);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(sequence, 17u);
+
+    std::vector<uint8_t> small_data(10, 0);
+    EXPECT_FALSE(DataProcessor::CopySourceStamps(from, small_data));
+    EXPECT_FALSE(DataProcessor::SetStreamSequence(small_data, 1));
+}
@@ -0,0 +1,143 @@
+/**
+ * @file test_gap_recovery.cpp
+ * @brief Unit tests for GapRecovery
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "DataProcessor.hpp"
+#include "GapRecovery.hpp"
+
+using namespace DELILA::Net;
+using Outcome = GapRecovery::Outcome;
+using std::chrono::milliseconds;
+
+namespace {
+const GapRecovery::Clock::time_point kT0{};
+}  // namespace
+
+TEST(GapRecoveryTest, InOrderFramesNeedNoRequests)
+{
+    GapRecovery recovery;
+    for (uint64_t sequence = 0; sequence < 5; ++sequence) {
+        EXPECT_EQ(recovery.Accept(sequence, kT0), Outcome::InOrder);
+    }
+    EXPECT_TRUE(recovery.TakeRequests(kT0).empty());
+    EXPECT_EQ(recovery.GetMissing(), 0u);
+    EXPECT_EQ(recovery.GetGapCount(), 0u);
+}
+
+TEST(GapRecoveryTest, GapIsRequestedAndRecovered)
+{
+    GapRecovery recovery;
+    recovery.Accept(0, kT0);
+    recovery.Accept(1, kT0);
+    EXPECT_EQ(recovery.Accept(5, kT0), Outcome::Gap);  // 2-4 lost
+    EXPECT_EQ(recovery.Accept(6, kT0), Outcome::InOrder);
+    EXPECT_EQ(recovery.GetMissing(), 3u);
+
+    auto requests = recovery.TakeRequests(kT0);
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].first, 2u);
+    EXPECT_EQ(requests[0].last, 4u);
+    EXPECT_TRUE(recovery.TakeRequests(kT0 + milliseconds(10)).empty());
+
+    uint64_t latencyNs = 0;
+    EXPECT_EQ(recovery.Accept(3, kT0 + milliseconds(20), &latencyNs),
+              Outcome::Recovered);
+    EXPECT_EQ(latencyNs, 20000000u);
+    EXPECT_EQ(recovery.Accept(3, kT0 + milliseconds(21)), Outcome::Duplicate);
+    EXPECT_EQ(recovery.Accept(6, kT0 + milliseconds(21)), Outcome::Duplicate);
+
+    // Still missing: 2 and 4, asked for again once the retry interval passed
+    requests = recovery.TakeRequests(kT0 + recovery.GetRetryInterval());
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[0].first, 2u);
+    EXPECT_EQ(requests[0].last, 2u);
+    EXPECT_EQ(requests[1].first, 4u);
+    EXPECT_EQ(recovery.GetRequestsSent(), 3u);
+
+    recovery.Accept(2, kT0 + milliseconds(150));
+    recovery.Accept(4, kT0 + milliseconds(150));
+    EXPECT_EQ(recovery.GetMissing(), 0u);
+    EXPECT_EQ(recovery.GetRecovered(), 3u);
+    EXPECT_EQ(recovery.GetDuplicates(), 2u);
+    EXPECT_EQ(recovery.GetLost(), 0u);
+}
+
+TEST(GapRecoveryTest, FramesLostBeforeTheFirstAreRecovered)
+{
+    GapRecovery recovery;
+    EXPECT_EQ(recovery.Accept(2, kT0), Outcome::Gap);
+    auto requests = recovery.TakeRequests(kT0);
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].first, 0u);
+    EXPECT_EQ(requests[0].last, 1u);
+}
+
+TEST(GapRecoveryTest, MissingFramesTimeOutAsLost)
+{
+    GapRecovery recovery;
+    recovery.SetTimeout(milliseconds(500));
+    recovery.Accept(0, kT0);
+    recovery.Accept(3, kT0);
+    recovery.TakeRequests(kT0);
+
+    EXPECT_FALSE(recovery.TakeRequests(kT0 + milliseconds(400)).empty());
+    EXPECT_TRUE(recovery.TakeRequests(kT0 + milliseconds(500)).empty());
+    EXPECT_EQ(recovery.GetMissing(), 0u);
+    EXPECT_EQ(recovery.GetLost(), 2u);
+
+    // Given up on: a late copy is dropped like a duplicate
+    EXPECT_EQ(recovery.Accept(1, kT0 + milliseconds(600)), Outcome::Duplicate);
+}
+
+TEST(GapRecoveryTest, HugeGapKeepsOnlyTheNewestMissing)
+{
+    GapRecovery recovery;
+    recovery.SetMaxMissing(100);
+    recovery.Accept(0, kT0);
+    recovery.Accept(1001, kT0);
+    EXPECT_EQ(recovery.GetMissing(), 100u);
+    EXPECT_EQ(recovery.GetLost(), 900u);
+
+    auto requests = recovery.TakeRequests(kT0);
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].first, 901u);
+    EXPECT_EQ(requests[0].last, 1000u);
+}
+
+TEST(GapRecoveryTest, ResetStartsANewRun)
+{
+    GapRecovery recovery;
+    recovery.Accept(0, kT0);
+    recovery.Accept(4, kT0);
+    recovery.Reset();
+    EXPECT_EQ(recovery.GetMissing(), 0u);
+    EXPECT_EQ(recovery.GetGapCount(), 0u);
+    EXPECT_EQ(recovery.Accept(0, kT0), Outcome::InOrder);
+}
+
+TEST(GapRecoveryTest, RequestRoundTrip)
+{
+    auto data = GapRecovery::EncodeRequest({17, 42});
+    ASSERT_NE(data, nullptr);
+    EXPECT_FALSE(DataProcessor::IsEOSMessage(*data));
+
+    GapRecovery::Range range{0, 0};
+    ASSERT_TRUE(GapRecovery::DecodeRequest(*data, range));
+    EXPECT_EQ(range.first, 17u);
+    EXPECT_EQ(range.last, 42u);
+
+    // Data frames and malformed requests are not requests
+    DataProcessor processor;
+    auto eos = processor.CreateEOSMessage();
+    EXPECT_FALSE(GapRecovery::DecodeRequest(*eos, range));
+    auto backwards = GapRecovery::EncodeRequest({42, 17});
+    EXPECT_FALSE(GapRecovery::DecodeRequest(*backwards, range));
+    data->pop_back();
+    EXPECT_FALSE(GapRecovery::DecodeRequest(*data, range));
+}
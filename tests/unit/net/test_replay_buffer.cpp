@@ -0,0 +1,96 @@
+/**
+ * @file test_replay_buffer.cpp
+ * @brief Unit tests for ReplayBuffer
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "DataProcessor.hpp"
+#include "ReplayBuffer.hpp"
+
+using namespace DELILA::Net;
+
+namespace {
+
+// Minimal frame with @p events events under @p sequence
+std::unique_ptr<std::vector<uint8_t>> MakeFrame(uint64_t sequence,
+                                                size_t events = 1)
+{
+    auto list = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    for (size_t i = 0; i < events; ++i) {
+        list->push_back(std::make_unique<MinimalEventData>(
+            0, 0, static_cast<double>(sequence), 100, 80, 0));
+    }
+    DataProcessor processor;
+    return processor.Process(list, sequence);
+}
+
+}  // namespace
+
+TEST(ReplayBufferTest, FindsStoredFramesBySequence)
+{
+    ReplayBuffer replay;
+    for (uint64_t sequence = 0; sequence < 10; ++sequence) {
+        ASSERT_TRUE(replay.Store(*MakeFrame(sequence)));
+    }
+    EXPECT_EQ(replay.GetFrames(), 10u);
+
+    auto expected = MakeFrame(7);
+    const auto* frame = replay.Find(7);
+    ASSERT_NE(frame, nullptr);
+    BinaryDataHeader header;
+    ASSERT_TRUE(DataProcessor::PeekHeader(*frame, header));
+    EXPECT_EQ(header.sequence_number, 7u);
+    EXPECT_EQ(frame->size(), expected->size());
+    EXPECT_EQ(replay.Find(10), nullptr);
+}
+
+TEST(ReplayBufferTest, EvictsOldestBeyondFrameBound)
+{
+    ReplayBuffer replay(4);
+    for (uint64_t sequence = 0; sequence < 6; ++sequence) {
+        replay.Store(*MakeFrame(sequence));
+    }
+    EXPECT_EQ(replay.GetFrames(), 4u);
+    EXPECT_EQ(replay.GetEvicted(), 2u);
+    EXPECT_EQ(replay.Find(1), nullptr);
+    EXPECT_NE(replay.Find(2), nullptr);
+    EXPECT_NE(replay.Find(5), nullptr);
+}
+
+TEST(ReplayBufferTest, EvictsOldestBeyondByteBound)
+{
+    const size_t frameBytes = MakeFrame(0, 10)->size();
+    ReplayBuffer replay(100, 3 * frameBytes);
+    for (uint64_t sequence = 0; sequence < 5; ++sequence) {
+        replay.Store(*MakeFrame(sequence, 10));
+    }
+    EXPECT_EQ(replay.GetFrames(), 3u);
+    EXPECT_EQ(replay.GetBytes(), 3 * frameBytes);
+    EXPECT_EQ(replay.Find(1), nullptr);
+
+    // Shrinking the bounds evicts at once
+    replay.SetCapacity(1, 3 * frameBytes);
+    EXPECT_EQ(replay.GetFrames(), 1u);
+    EXPECT_NE(replay.Find(4), nullptr);
+}
+
+TEST(ReplayBufferTest, RejectsInvalidAndOutOfOrderFrames)
+{
+    ReplayBuffer replay;
+    std::vector<uint8_t> garbage(100, 0xAB);
+    EXPECT_FALSE(replay.Store(garbage));
+    EXPECT_TRUE(replay.Store(*MakeFrame(5)));
+    EXPECT_FALSE(replay.Store(*MakeFrame(5)));
+    EXPECT_FALSE(replay.Store(*MakeFrame(3)));
+    EXPECT_EQ(replay.GetFrames(), 1u);
+
+    // A new run starts again at 0
+    replay.Clear();
+    EXPECT_EQ(replay.GetFrames(), 0u);
+    EXPECT_EQ(replay.GetBytes(), 0u);
+    EXPECT_TRUE(replay.Store(*MakeFrame(0)));
+}
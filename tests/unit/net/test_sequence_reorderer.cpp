@@ -0,0 +1,139 @@
+/**
+ * @file test_sequence_reorderer.cpp
+ * @brief Unit tests for SequenceReorderer
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "SequenceReorderer.hpp"
+
+using namespace DELILA::Net;
+
+namespace {
+
+// Frame whose single byte is the low byte of its sequence number
+SequenceReorderer::Frame MakeFrame(uint64_t sequence)
+{
+    return std::make_unique<std::vector<uint8_t>>(
+        1, static_cast<uint8_t>(sequence));
+}
+
+// Push frames in the given order; returns the order they come out in
+std::vector<uint64_t> PushAll(SequenceReorderer& reorderer,
+                              const std::vector<uint64_t>& sequences)
+{
+    std::vector<uint64_t> out;
+    std::vector<SequenceReorderer::Frame> ready;
+    for (uint64_t sequence : sequences) {
+        reorderer.Push(sequence, MakeFrame(sequence), ready);
+        for (const auto& frame : ready) {
+            out.push_back(frame->front());
+        }
+        ready.clear();
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST(SequenceReordererTest, InOrderFramesPassStraightThrough)
+{
+    SequenceReorderer reorderer(4);
+    EXPECT_EQ(PushAll(reorderer, {5, 6, 7, 8}),
+              (std::vector<uint64_t>{5, 6, 7, 8}));
+    EXPECT_EQ(reorderer.GetReceived(), 4u);
+    EXPECT_EQ(reorderer.GetLost(), 0u);
+    EXPECT_EQ(reorderer.GetReordered(), 0u);
+    EXPECT_EQ(reorderer.GetHeld(), 0u);
+}
+
+TEST(SequenceReordererTest, WithoutWindowOnlyCounts)
+{
+    SequenceReorderer reorderer;
+    EXPECT_EQ(PushAll(reorderer, {0, 2, 3, 1, 6}),
+              (std::vector<uint64_t>{0, 2, 3, 1, 6}));
+    EXPECT_EQ(reorderer.GetReordered(), 1u);
+    EXPECT_EQ(reorderer.GetLate(), 1u);
+    EXPECT_EQ(reorderer.GetLost(), 2u);  // 4 and 5; 1 turned up late
+}
+
+TEST(SequenceReordererTest, WindowRestoresOrder)
+{
+    SequenceReorderer reorderer(4);
+    EXPECT_EQ(PushAll(reorderer, {0, 2, 3, 1, 5, 4}),
+              (std::vector<uint64_t>{0, 1, 2, 3, 4, 5}));
+    EXPECT_EQ(reorderer.GetReordered(), 2u);
+    EXPECT_EQ(reorderer.GetLate(), 0u);
+    EXPECT_EQ(reorderer.GetLost(), 0u);
+}
+
+TEST(SequenceReordererTest, FullWindowGivesUpMissingFrame)
+{
+    SequenceReorderer reorderer(2);
+    EXPECT_EQ(PushAll(reorderer, {0, 2, 3}), (std::vector<uint64_t>{0}));
+    EXPECT_EQ(reorderer.GetHeld(), 2u);
+
+    // Third frame held: 1 is given up
+    EXPECT_EQ(PushAll(reorderer, {4}), (std::vector<uint64_t>{2, 3, 4}));
+    EXPECT_EQ(reorderer.GetLost(), 1u);
+    EXPECT_EQ(reorderer.GetHeld(), 0u);
+
+    // Arrives after all: passed on, no longer lost
+    EXPECT_EQ(PushAll(reorderer, {1}), (std::vector<uint64_t>{1}));
+    EXPECT_EQ(reorderer.GetLost(), 0u);
+    EXPECT_EQ(reorderer.GetLate(), 1u);
+}
+
+TEST(SequenceReordererTest, DuplicatesAreDroppedAndCounted)
+{
+    SequenceReorderer reorderer(0);
+    EXPECT_EQ(PushAll(reorderer, {0, 1, 1, 0, 3, 2, 2}),
+              (std::vector<uint64_t>{0, 1, 3, 2}));
+    EXPECT_EQ(reorderer.GetDuplicates(), 3u);
+    EXPECT_EQ(reorderer.GetLate(), 1u);
+    EXPECT_EQ(reorderer.GetReordered(), 1u);
+    EXPECT_EQ(reorderer.GetLost(), 0u);
+
+    // A duplicate does not hide a loss
+    EXPECT_EQ(PushAll(reorderer, {6, 3}), (std::vector<uint64_t>{6}));
+    EXPECT_EQ(reorderer.GetLost(), 2u);
+    EXPECT_EQ(reorderer.GetDuplicates(), 4u);
+}
+
+TEST(SequenceReordererTest, DuplicateOfHeldFrameIsCounted)
+{
+    SequenceReorderer reorderer(4);
+    EXPECT_EQ(PushAll(reorderer, {0, 2, 2}), (std::vector<uint64_t>{0}));
+    EXPECT_EQ(reorderer.GetHeld(), 1u);
+    EXPECT_EQ(reorderer.GetDuplicates(), 1u);
+    EXPECT_EQ(reorderer.GetReordered(), 0u);
+
+    EXPECT_EQ(PushAll(reorderer, {1}), (std::vector<uint64_t>{1, 2}));
+}
+
+TEST(SequenceReordererTest, FlushReleasesHeldFramesInOrder)
+{
+    SequenceReorderer reorderer(8);
+    EXPECT_EQ(PushAll(reorderer, {0, 5, 3}), (std::vector<uint64_t>{0}));
+
+    std::vector<SequenceReorderer::Frame> ready;
+    reorderer.Flush(ready);
+    ASSERT_EQ(ready.size(), 2u);
+    EXPECT_EQ(ready[0]->front(), 3);
+    EXPECT_EQ(ready[1]->front(), 5);
+    EXPECT_EQ(reorderer.GetLost(), 3u);  // 1, 2 and 4
+    EXPECT_EQ(reorderer.GetHeld(), 0u);
+
+    // 4 turns up late; 1 and 2 are still missing
+    EXPECT_EQ(PushAll(reorderer, {4}), (std::vector<uint64_t>{4}));
+    EXPECT_EQ(reorderer.GetLost(), 2u);
+    EXPECT_EQ(reorderer.GetLate(), 1u);
+
+    reorderer.Reset();
+    EXPECT_EQ(reorderer.GetReceived(), 0u);
+    EXPECT_EQ(reorderer.GetLost(), 0u);
+    EXPECT_EQ(PushAll(reorderer, {0}), (std::vector<uint64_t>{0}));
+}
@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+
 #include "../../../lib/net/include/DataProcessor.hpp"
 #include "../../../include/delila/core/MinimalEventData.hpp"
 
@@ -19,6 +23,9 @@ TEST_F(DataProcessorFormatTest, FormatVersionConstantsExist) {
     // Test that format version constants are defined
     EXPECT_EQ(FORMAT_VERSION_EVENTDATA, 1);
     EXPECT_EQ(FORMAT_VERSION_MINIMAL_EVENTDATA, 2);
+    EXPECT_EQ(FORMAT_VERSION_BUILT_EVENTDATA, 3);
+    EXPECT_EQ(FORMAT_VERSION_CALIBRATED_EVENTDATA, 4);
+    EXPECT_EQ(FORMAT_VERSION_COMPACT_EVENTDATA, 5);
 }
 
 // TDD RED phase - This test should fail because MinimalEventData encoding doesn't exist yet
@@ -114,4 +121,306 @@ TEST_F(DataProcessorFormatTest, MinimalEventDataRoundTrip) {
     EXPECT_EQ(events[1]->energy, 200);
     EXPECT_EQ(events[1]->energyShort, 75);
     EXPECT_EQ(events[1]->flags, 0x06);
-}
\ No newline at end of file
+}
+
+TEST_F(DataProcessorFormatTest, DecodeMinimalIntoBatch) {
+    auto original = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    for (int i = 0; i < 10; ++i) {
+        original->push_back(std::make_unique<MinimalEventData>(1, i, 10.0 * i, 100 + i, 50, 0x1));
+    }
+    auto encoded = processor->Process(original, 7);
+    ASSERT_NE(encoded, nullptr);
+
+    std::vector<MinimalEventData> batch(3);  // Contents are replaced
+    uint64_t sequence = 0;
+    ASSERT_TRUE(processor->DecodeMinimal(*encoded, batch, sequence));
+    EXPECT_EQ(sequence, 7);
+    ASSERT_EQ(batch.size(), 10);
+    EXPECT_EQ(batch[9].channel, 9);
+    EXPECT_EQ(batch[9].energy, 109);
+    EXPECT_DOUBLE_EQ(batch[9].timeStampNs, 90.0);
+    EXPECT_EQ(batch[9].flags, 0x1);
+
+    // Only minimal frames are accepted, and a corrupted payload is caught
+    auto eos = processor->CreateEOSMessage();
+    EXPECT_FALSE(processor->DecodeMinimal(*eos, batch, sequence));
+    (*encoded)[BINARY_DATA_HEADER_SIZE + 3] ^= 0xFF;
+    EXPECT_FALSE(processor->DecodeMinimal(*encoded, batch, sequence));
+}
+
+TEST_F(DataProcessorFormatTest, BuiltEventDataRoundTrip) {
+    using DELILA::Digitizer::BuiltEventData;
+    auto original = std::make_unique<std::vector<std::unique_ptr<BuiltEventData>>>();
+    auto first = std::make_unique<BuiltEventData>();
+    first->hits.emplace_back(1, 2, 1000.0, 100, 50, 0);
+    first->hits.emplace_back(3, 4, 1010.5, 200, 75, 0x01);
+    first->triggerIndex = 1;
+    original->push_back(std::move(first));
+    auto second = std::make_unique<BuiltEventData>();
+    second->hits.emplace_back(5, 6, 9000.0, 300, 10, 0);
+    original->push_back(std::move(second));
+
+    auto encoded = processor->Process(original, 7);
+    ASSERT_NE(encoded, nullptr);
+    EXPECT_EQ(encoded->size(), BINARY_DATA_HEADER_SIZE + 2 * 8 + 3 * sizeof(MinimalEventData));
+
+    auto decoded = processor->DecodeBuilt(encoded);
+    ASSERT_NE(decoded.first, nullptr);
+    ASSERT_EQ(decoded.first->size(), 2);
+    EXPECT_EQ(decoded.second, 7);
+
+    auto& events = *decoded.first;
+    ASSERT_EQ(events[0]->GetMultiplicity(), 2);
+    EXPECT_EQ(events[0]->triggerIndex, 1);
+    EXPECT_EQ(events[0]->GetTrigger().module, 3);
+    EXPECT_EQ(events[0]->GetTriggerTimeNs(), 1010.5);
+    EXPECT_EQ(events[0]->hits[0].energy, 100);
+    ASSERT_EQ(events[1]->GetMultiplicity(), 1);
+    EXPECT_EQ(events[1]->hits[0].channel, 6);
+
+    // Other decoders reject the frame, and a corrupted payload is caught
+    EXPECT_EQ(processor->DecodeMinimal(encoded).first, nullptr);
+    (*encoded)[BINARY_DATA_HEADER_SIZE + 10] ^= 0xFF;
+    EXPECT_EQ(processor->DecodeBuilt(encoded).first, nullptr);
+}
+
+TEST_F(DataProcessorFormatTest, CalibratedEventDataRoundTrip) {
+    using DELILA::Digitizer::CalibratedEventData;
+    auto original = std::make_unique<std::vector<std::unique_ptr<CalibratedEventData>>>();
+    original->push_back(std::make_unique<CalibratedEventData>(1, 2, 1000, 511.0f, 120.5f, 1234.5, 0));
+    original->push_back(std::make_unique<CalibratedEventData>(3, 4, 2000, 1332.5f, 300.0f, 5678.25, 0x04));
+
+    auto encoded = processor->Process(original, 11);
+    ASSERT_NE(encoded, nullptr);
+    EXPECT_EQ(encoded->size(), BINARY_DATA_HEADER_SIZE + 2 * sizeof(CalibratedEventData));
+
+    auto decoded = processor->DecodeCalibrated(encoded);
+    ASSERT_NE(decoded.first, nullptr);
+    ASSERT_EQ(decoded.first->size(), 2);
+    EXPECT_EQ(decoded.second, 11);
+
+    auto& events = *decoded.first;
+    EXPECT_EQ(events[0]->module, 1);
+    EXPECT_EQ(events[0]->rawEnergy, 1000);
+    EXPECT_FLOAT_EQ(events[0]->energy, 511.0f);
+    EXPECT_DOUBLE_EQ(events[0]->timeStampNs, 1234.5);
+    EXPECT_EQ(events[1]->channel, 4);
+    EXPECT_FLOAT_EQ(events[1]->energyShort, 300.0f);
+    EXPECT_EQ(events[1]->flags, 0x04);
+
+    // Other decoders reject the frame, and a corrupted payload is caught
+    EXPECT_EQ(processor->DecodeMinimal(encoded).first, nullptr);
+    EXPECT_EQ(processor->DecodeBuilt(encoded).first, nullptr);
+    (*encoded)[BINARY_DATA_HEADER_SIZE + 5] ^= 0xFF;
+    EXPECT_EQ(processor->DecodeCalibrated(encoded).first, nullptr);
+}
+
+TEST_F(DataProcessorFormatTest, ScanRecordsLocatesEveryFormat) {
+    using DELILA::Digitizer::BuiltEventData;
+    using DELILA::Digitizer::EventData;
+    std::vector<EventRecordRef> records;
+
+    // Minimal: fixed 22-byte records
+    auto minimal = std::make_unique<std::vector<std::unique_ptr<MinimalEventData>>>();
+    minimal->push_back(std::make_unique<MinimalEventData>(1, 2, 100.0, 10, 5, 0));
+    minimal->push_back(std::make_unique<MinimalEventData>(3, 4, 200.0, 20, 5, 0));
+    auto encoded = processor->Process(minimal, 0);
+    ASSERT_TRUE(DataProcessor::ScanRecords(*encoded, records));
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[1].offset, BINARY_DATA_HEADER_SIZE + sizeof(MinimalEventData));
+    EXPECT_EQ(records[1].size, sizeof(MinimalEventData));
+    EXPECT_EQ(records[1].module, 3);
+    EXPECT_EQ(records[1].channel, 4);
+    EXPECT_DOUBLE_EQ(records[1].timeStampNs, 200.0);
+
+    // Full: variable-size records with waveforms
+    auto full = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+    for (int i = 0; i < 3; ++i) {
+        auto event = std::make_unique<EventData>(16 * i);
+        event->module = 5;
+        event->channel = static_cast<uint8_t>(i);
+        event->timeStampNs = 1000.0 * i;
+        event->analogProbe1.assign(16 * i, 7);
+        event->digitalProbe2.assign(8 * i, 1);
+        full->push_back(std::move(event));
+    }
+    encoded = processor->Process(full, 0);
+    ASSERT_TRUE(DataProcessor::ScanRecords(*encoded, records));
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(records[0].offset, BINARY_DATA_HEADER_SIZE);
+    EXPECT_EQ(records[2].offset + records[2].size, encoded->size());
+    EXPECT_EQ(records[2].channel, 2);
+    EXPECT_EQ(records[2].module, 5);
+    EXPECT_DOUBLE_EQ(records[2].timeStampNs, 2000.0);
+
+    // Built: routed by the trigger hit
+    auto built = std::make_unique<std::vector<std::unique_ptr<BuiltEventData>>>();
+    auto event = std::make_unique<BuiltEventData>();
+    event->hits.emplace_back(1, 1, 10.0, 100, 50, 0);
+    event->hits.emplace_back(6, 7, 12.0, 100, 50, 0);
+    event->triggerIndex = 1;
+    built->push_back(std::move(event));
+    encoded = processor->Process(built, 0);
+    ASSERT_TRUE(DataProcessor::ScanRecords(*encoded, records));
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].size, 8 + 2 * sizeof(MinimalEventData));
+    EXPECT_EQ(records[0].module, 6);
+    EXPECT_DOUBLE_EQ(records[0].timeStampNs, 12.0);
+
+    // EOS and truncated frames are rejected
+    EXPECT_FALSE(DataProcessor::ScanRecords(*processor->CreateEOSMessage(), records));
+    encoded->resize(encoded->size() - 1);
+    EXPECT_FALSE(DataProcessor::ScanRecords(*encoded, records));
+}
+
+namespace {
+
+// Waveform event with every probe filled; sample counts differ per probe
+// so that bit planes end mid-byte
+std::unique_ptr<DELILA::Digitizer::EventData> MakeWaveformEvent(size_t samples, int seed) {
+    auto event = std::make_unique<DELILA::Digitizer::EventData>(samples);
+    event->timeStampNs = 1000.5 * seed;
+    event->energy = static_cast<uint16_t>(100 + seed);
+    event->energyShort = static_cast<uint16_t>(50 + seed);
+    event->module = 2;
+    event->channel = static_cast<uint8_t>(seed);
+    event->timeResolution = 2;
+    event->downSampleFactor = 4;
+    event->flags = 0x10 + seed;
+    event->aMax = 0x7FFF;
+    for (size_t i = 0; i < samples; ++i) {
+        event->analogProbe1[i] = static_cast<int32_t>(i * 37 % 65536) - 32768;
+        event->analogProbe2[i] = static_cast<int32_t>(i) - 100;
+        event->digitalProbe1[i] = (i % 3) == 0;
+        event->digitalProbe2[i] = (i + seed) % 2;
+        event->digitalProbe3[i] = i > samples / 2;
+        event->digitalProbe4[i] = 0;
+    }
+    event->digitalProbe3.resize(samples / 2 + 1);
+    event->digitalProbe4.resize(samples > 5 ? samples - 5 : 0);
+    return event;
+}
+
+}  // namespace
+
+TEST_F(DataProcessorFormatTest, CompactEventDataRoundTrip) {
+    using DELILA::Digitizer::EventData;
+    auto original = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+    for (int i = 0; i < 4; ++i) {
+        original->push_back(MakeWaveformEvent(i == 0 ? 0 : 61 * i, i));
+    }
+
+    auto full = processor->Process(original, 3);
+    processor->EnableCompactWaveforms();
+    auto compact = processor->Process(original, 3);
+    ASSERT_NE(compact, nullptr);
+
+    BinaryDataHeader header;
+    ASSERT_TRUE(DataProcessor::PeekHeader(*compact, header));
+    EXPECT_EQ(header.format_version, FORMAT_VERSION_COMPACT_EVENTDATA);
+    EXPECT_TRUE(DataProcessor::IsEventDataFormat(header.format_version));
+    EXPECT_LT(compact->size() * 2, full->size());
+
+    auto decoded = processor->Decode(compact);
+    ASSERT_NE(decoded.first, nullptr);
+    EXPECT_EQ(decoded.second, 3);
+    ASSERT_EQ(decoded.first->size(), original->size());
+    for (size_t i = 0; i < original->size(); ++i) {
+        const auto& a = *(*original)[i];
+        const auto& b = *(*decoded.first)[i];
+        EXPECT_DOUBLE_EQ(b.timeStampNs, a.timeStampNs);
+        EXPECT_EQ(b.waveformSize, a.waveformSize);
+        EXPECT_EQ(b.energy, a.energy);
+        EXPECT_EQ(b.channel, a.channel);
+        EXPECT_EQ(b.downSampleFactor, a.downSampleFactor);
+        EXPECT_EQ(b.flags, a.flags);
+        EXPECT_EQ(b.aMax, a.aMax);
+        EXPECT_EQ(b.analogProbe1, a.analogProbe1);
+        EXPECT_EQ(b.analogProbe2, a.analogProbe2);
+        EXPECT_EQ(b.digitalProbe1, a.digitalProbe1);
+        EXPECT_EQ(b.digitalProbe2, a.digitalProbe2);
+        EXPECT_EQ(b.digitalProbe3, a.digitalProbe3);
+        EXPECT_EQ(b.digitalProbe4, a.digitalProbe4);
+    }
+
+    // Other decoders reject the frame, and a corrupted payload is caught
+    EXPECT_EQ(processor->DecodeMinimal(compact).first, nullptr);
+    (*compact)[compact->size() - 3] ^= 0xFF;
+    EXPECT_EQ(processor->Decode(compact).first, nullptr);
+}
+
+TEST_F(DataProcessorFormatTest, CompactFallsBackForSamplesThatDoNotFit) {
+    using DELILA::Digitizer::EventData;
+    processor->EnableCompactWaveforms();
+
+    auto analog = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+    analog->push_back(MakeWaveformEvent(16, 0));
+    analog->push_back(MakeWaveformEvent(16, 1));
+    (*analog)[1]->analogProbe2[3] = 40000;
+    auto encoded = processor->Process(analog, 0);
+    BinaryDataHeader header;
+    ASSERT_TRUE(DataProcessor::PeekHeader(*encoded, header));
+    EXPECT_EQ(header.format_version, FORMAT_VERSION_EVENTDATA);
+    auto decoded = processor->Decode(encoded);
+    ASSERT_NE(decoded.first, nullptr);
+    EXPECT_EQ((*decoded.first)[1]->analogProbe2[3], 40000);
+
+    auto digital = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+    digital->push_back(MakeWaveformEvent(16, 0));
+    (*digital)[0]->digitalProbe1[5] = 2;
+    encoded = processor->Process(digital, 0);
+    ASSERT_TRUE(DataProcessor::PeekHeader(*encoded, header));
+    EXPECT_EQ(header.format_version, FORMAT_VERSION_EVENTDATA);
+    decoded = processor->Decode(encoded);
+    ASSERT_NE(decoded.first, nullptr);
+    EXPECT_EQ((*decoded.first)[0]->digitalProbe1[5], 2);
+}
+
+TEST_F(DataProcessorFormatTest, CompactRejectsInconsistentSampleCounts) {
+    using DELILA::Digitizer::EventData;
+    using DELILA::Digitizer::EVENTDATA_SIZE;
+    auto original = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+    original->push_back(MakeWaveformEvent(32, 1));
+    processor->EnableChecksum(false);
+    processor->EnableCompactWaveforms();
+
+    // analogProbe1 count claims more samples than the frame holds
+    auto encoded = processor->Process(original, 0);
+    uint32_t count = 1000;
+    std::memcpy(encoded->data() + BINARY_DATA_HEADER_SIZE + EVENTDATA_SIZE, &count,
+                sizeof(count));
+    EXPECT_EQ(processor->Decode(encoded).first, nullptr);
+
+    // Trailing bytes after the last record
+    encoded = processor->Process(original, 0);
+    encoded->push_back(0);
+    uint32_t size = static_cast<uint32_t>(encoded->size() - BINARY_DATA_HEADER_SIZE);
+    std::memcpy(encoded->data() + offsetof(BinaryDataHeader, uncompressed_size), &size,
+                sizeof(size));
+    std::memcpy(encoded->data() + offsetof(BinaryDataHeader, compressed_size), &size,
+                sizeof(size));
+    EXPECT_EQ(processor->Decode(encoded).first, nullptr);
+}
+
+TEST_F(DataProcessorFormatTest, ScanRecordsLocatesCompactRecords) {
+    using DELILA::Digitizer::EventData;
+    auto original = std::make_unique<std::vector<std::unique_ptr<EventData>>>();
+    for (int i = 0; i < 3; ++i) {
+        original->push_back(MakeWaveformEvent(13 * i, i));
+    }
+    processor->EnableCompactWaveforms();
+    auto encoded = processor->Process(original, 0);
+
+    std::vector<EventRecordRef> records;
+    ASSERT_TRUE(DataProcessor::ScanRecords(*encoded, records));
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(records[0].offset, BINARY_DATA_HEADER_SIZE);
+    EXPECT_EQ(records[1].offset, records[0].offset + records[0].size);
+    EXPECT_EQ(records[2].offset + records[2].size, encoded->size());
+    EXPECT_EQ(records[2].module, 2);
+    EXPECT_EQ(records[2].channel, 2);
+    EXPECT_DOUBLE_EQ(records[2].timeStampNs, 2001.0);
+
+    encoded->resize(encoded->size() - 1);
+    EXPECT_FALSE(DataProcessor::ScanRecords(*encoded, records));
+}
@@ -0,0 +1,487 @@
+/**
+ * @file test_shared_memory_ring.cpp
+ * @brief Unit tests for SharedMemoryRing and the shm:// transport backend
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <thread>
+
+#include "SharedMemoryRing.hpp"
+#include "ZMQTransport.hpp"
+
+using namespace DELILA::Net;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Mode = SharedMemoryRing::Mode;
+using Role = SharedMemoryRing::Role;
+
+// Segment names are global to the host: make them unique per test process
+std::string UniqueName()
+{
+    static std::atomic<int> counter{0};
+    return "delila_test_" + std::to_string(getpid()) + "_" +
+           std::to_string(counter.fetch_add(1));
+}
+
+// Frame of @p size bytes whose first 8 bytes carry @p index
+std::vector<uint8_t> MakeFrame(uint64_t index, size_t size)
+{
+    std::vector<uint8_t> frame(std::max<size_t>(size, sizeof(index)));
+    std::memcpy(frame.data(), &index, sizeof(index));
+    for (size_t i = sizeof(index); i < frame.size(); ++i) {
+        frame[i] = static_cast<uint8_t>(index + i);
+    }
+    return frame;
+}
+
+bool CheckFrame(const std::vector<uint8_t>& frame, uint64_t* index)
+{
+    if (frame.size() < sizeof(uint64_t)) return false;
+    std::memcpy(index, frame.data(), sizeof(*index));
+    for (size_t i = sizeof(*index); i < frame.size(); ++i) {
+        if (frame[i] != static_cast<uint8_t>(*index + i)) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+// Test: Address parsing
+TEST(SharedMemoryRingTest, ParseAddress)
+{
+    EXPECT_EQ(SharedMemoryRing::ParseAddress("shm://daq0"), "daq0");
+    EXPECT_EQ(SharedMemoryRing::ParseAddress("tcp://localhost:5555"), "");
+    EXPECT_EQ(SharedMemoryRing::ParseAddress("shm://"), "");
+}
+
+// Test: Capacity is rounded up to a power of two
+TEST(SharedMemoryRingTest, CapacityIsRoundedUp)
+{
+    SharedMemoryRing ring;
+    ASSERT_TRUE(ring.Create(UniqueName(), Mode::Distribute, 100000));
+    EXPECT_EQ(ring.GetCapacity(), 131072u);
+    EXPECT_EQ(ring.GetMaxFrameSize(), 131072u / 2 - 16);  // Less the record header
+}
+
+// Test: Frame written by the producer is read back unchanged
+TEST(SharedMemoryRingTest, WriteAndRead)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Distribute, 1 << 20));
+
+    SharedMemoryRing consumer;
+    ASSERT_TRUE(consumer.Attach(name, Role::Consumer, Mode::Distribute));
+
+    auto frame = MakeFrame(42, 1000);
+    ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 100ms));
+
+    auto received = consumer.Read(100ms);
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(*received, frame);
+    EXPECT_EQ(producer.GetUsedBytes(), 0u);
+}
+
+// Test: Read times out on an empty ring
+TEST(SharedMemoryRingTest, ReadTimesOut)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Distribute, 1 << 20));
+    SharedMemoryRing consumer;
+    ASSERT_TRUE(consumer.Attach(name, Role::Consumer, Mode::Distribute));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(consumer.Read(50ms), nullptr);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 45ms);
+}
+
+// Test: Peek exposes the frame in place until Release
+TEST(SharedMemoryRingTest, PeekIsZeroCopy)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Distribute, 1 << 20));
+    SharedMemoryRing consumer;
+    ASSERT_TRUE(consumer.Attach(name, Role::Consumer, Mode::Distribute));
+
+    uint8_t* slot = producer.Reserve(64, 100ms);
+    ASSERT_NE(slot, nullptr);
+    std::memset(slot, 0xAB, 64);
+    producer.Commit();
+
+    auto view = consumer.Peek(100ms);
+    ASSERT_NE(view.data, nullptr);
+    EXPECT_EQ(view.size, 64u);
+    EXPECT_EQ(view.data[63], 0xAB);
+    EXPECT_GT(producer.GetUsedBytes(), 0u);
+
+    consumer.Release();
+    EXPECT_EQ(producer.GetUsedBytes(), 0u);
+}
+
+// Test: Producer waits for space instead of overwriting unread frames
+TEST(SharedMemoryRingTest, FullRingAppliesBackpressure)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Distribute, SharedMemoryRing::kMinCapacity));
+    SharedMemoryRing consumer;
+    ASSERT_TRUE(consumer.Attach(name, Role::Consumer, Mode::Distribute));
+
+    auto frame = MakeFrame(0, 16 * 1024);
+    int written = 0;
+    while (producer.Write(frame.data(), frame.size(), 10ms)) {
+        ++written;
+        ASSERT_LT(written, 100);
+    }
+    EXPECT_GE(written, 3);
+
+    ASSERT_NE(consumer.Read(100ms), nullptr);
+    EXPECT_TRUE(producer.Write(frame.data(), frame.size(), 10ms));
+}
+
+// Test: Oversized frames are rejected
+TEST(SharedMemoryRingTest, OversizedFrameIsRejected)
+{
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(UniqueName(), Mode::Distribute, SharedMemoryRing::kMinCapacity));
+    std::vector<uint8_t> frame(producer.GetMaxFrameSize() + 1);
+    EXPECT_FALSE(producer.Write(frame.data(), frame.size(), 10ms));
+}
+
+// Test: Frames of varying size survive many wrap-arounds intact and in order
+TEST(SharedMemoryRingTest, WrapAroundPreservesFrames)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Distribute, SharedMemoryRing::kMinCapacity));
+    SharedMemoryRing consumer;
+    ASSERT_TRUE(consumer.Attach(name, Role::Consumer, Mode::Distribute));
+
+    constexpr uint64_t kFrames = 5000;
+    std::thread writer([&]() {
+        for (uint64_t i = 0; i < kFrames; ++i) {
+            auto frame = MakeFrame(i, 8 + (i * 7919) % 9000);
+            ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 1000ms));
+        }
+    });
+
+    for (uint64_t expected = 0; expected < kFrames; ++expected) {
+        auto frame = consumer.Read(1000ms);
+        ASSERT_NE(frame, nullptr);
+        uint64_t index = 0;
+        ASSERT_TRUE(CheckFrame(*frame, &index));
+        EXPECT_EQ(index, expected);
+    }
+    writer.join();
+}
+
+// Test: PUSH/PULL semantics - each frame goes to exactly one consumer
+TEST(SharedMemoryRingTest, DistributeDeliversEachFrameOnce)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Distribute, 256 * 1024));
+
+    constexpr int kConsumers = 3;
+    constexpr uint64_t kFrames = 6000;
+    std::vector<std::unique_ptr<SharedMemoryRing>> consumers;
+    for (int c = 0; c < kConsumers; ++c) {
+        consumers.push_back(std::make_unique<SharedMemoryRing>());
+        ASSERT_TRUE(consumers.back()->Attach(name, Role::Consumer, Mode::Distribute));
+    }
+
+    std::atomic<uint64_t> total{0};
+    std::vector<std::vector<uint64_t>> seen(kConsumers);
+    std::vector<std::thread> readers;
+    for (int c = 0; c < kConsumers; ++c) {
+        readers.emplace_back([&, c]() {
+            while (total.load() < kFrames) {
+                auto frame = consumers[c]->Read(20ms);
+                if (!frame) continue;
+                uint64_t index = 0;
+                ASSERT_TRUE(CheckFrame(*frame, &index));
+                seen[c].push_back(index);
+                total.fetch_add(1);
+            }
+        });
+    }
+
+    for (uint64_t i = 0; i < kFrames; ++i) {
+        auto frame = MakeFrame(i, 64 + i % 2048);
+        ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 1000ms));
+    }
+    for (auto& reader : readers) reader.join();
+
+    std::set<uint64_t> all;
+    size_t count = 0;
+    for (const auto& indices : seen) {
+        count += indices.size();
+        all.insert(indices.begin(), indices.end());
+    }
+    EXPECT_EQ(count, kFrames);
+    EXPECT_EQ(all.size(), kFrames);
+}
+
+// Test: PUB/SUB semantics - every subscriber sees every frame
+TEST(SharedMemoryRingTest, BroadcastDeliversToAllSubscribers)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Broadcast, SharedMemoryRing::kMinCapacity));
+
+    constexpr int kSubscribers = 3;
+    constexpr uint64_t kFrames = 3000;
+    std::vector<std::unique_ptr<SharedMemoryRing>> subscribers;
+    for (int s = 0; s < kSubscribers; ++s) {
+        subscribers.push_back(std::make_unique<SharedMemoryRing>());
+        ASSERT_TRUE(subscribers.back()->Attach(name, Role::Consumer, Mode::Broadcast));
+    }
+
+    // A subscriber that falls behind loses frames but never sees a torn
+    // or reordered one; what it lost is counted
+    std::vector<std::thread> readers;
+    for (int s = 0; s < kSubscribers; ++s) {
+        readers.emplace_back([&, s]() {
+            uint64_t received = 0;
+            uint64_t index = 0;
+            int64_t previous = -1;
+            while (index + 1 < kFrames) {
+                auto frame = subscribers[s]->Read(1000ms);
+                ASSERT_NE(frame, nullptr);
+                ASSERT_TRUE(CheckFrame(*frame, &index));
+                ASSERT_GT(static_cast<int64_t>(index), previous);
+                previous = static_cast<int64_t>(index);
+                ++received;
+            }
+            EXPECT_EQ(received + subscribers[s]->GetDroppedFrames(), kFrames);
+        });
+    }
+
+    for (uint64_t i = 0; i < kFrames; ++i) {
+        auto frame = MakeFrame(i, 8 + i % 3000);
+        ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 1000ms));
+    }
+    for (auto& reader : readers) reader.join();
+}
+
+// Test: Like a SUB socket, a subscriber only sees frames published after it joined
+TEST(SharedMemoryRingTest, LateSubscriberStartsAtHead)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Broadcast, 1 << 20));
+
+    // No subscribers: publishing never blocks
+    auto early = MakeFrame(1, 100);
+    for (int i = 0; i < 100000 / 100; ++i) {
+        ASSERT_TRUE(producer.Write(early.data(), early.size(), 0ms));
+    }
+
+    SharedMemoryRing subscriber;
+    ASSERT_TRUE(subscriber.Attach(name, Role::Consumer, Mode::Broadcast));
+    auto late = MakeFrame(2, 100);
+    ASSERT_TRUE(producer.Write(late.data(), late.size(), 0ms));
+
+    auto frame = subscriber.Read(100ms);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(*frame, late);
+}
+
+// Test: Like a PUB socket, a stalled subscriber never holds back the
+// producer; it loses the oldest frames and counts them
+TEST(SharedMemoryRingTest, LaggingSubscriberLosesOldestFrames)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Broadcast, SharedMemoryRing::kMinCapacity));
+    SharedMemoryRing subscriber;
+    ASSERT_TRUE(subscriber.Attach(name, Role::Consumer, Mode::Broadcast));
+
+    constexpr uint64_t kFrames = 20;
+    for (uint64_t i = 0; i < kFrames; ++i) {
+        auto frame = MakeFrame(i, 16 * 1024);
+        ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 0ms));
+    }
+
+    uint64_t dropped = subscriber.GetDroppedFrames();
+    EXPECT_GT(dropped, 0u);
+    EXPECT_EQ(producer.GetDroppedFrames(), dropped);
+
+    // The rest arrive intact, starting right after the lost ones
+    for (uint64_t expected = dropped; expected < kFrames; ++expected) {
+        auto frame = subscriber.Read(100ms);
+        ASSERT_NE(frame, nullptr);
+        uint64_t index = 0;
+        ASSERT_TRUE(CheckFrame(*frame, &index));
+        EXPECT_EQ(index, expected);
+    }
+    EXPECT_EQ(subscriber.Read(10ms), nullptr);
+}
+
+// Test: A frame overwritten while a subscriber holds its view is reported
+TEST(SharedMemoryRingTest, OverwrittenPeekIsReported)
+{
+    auto name = UniqueName();
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Create(name, Mode::Broadcast, SharedMemoryRing::kMinCapacity));
+    SharedMemoryRing subscriber;
+    ASSERT_TRUE(subscriber.Attach(name, Role::Consumer, Mode::Broadcast));
+
+    auto frame = MakeFrame(0, 16 * 1024);
+    ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 0ms));
+    ASSERT_NE(subscriber.Peek(100ms).data, nullptr);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(producer.Write(frame.data(), frame.size(), 0ms));
+    }
+    EXPECT_FALSE(subscriber.Release());
+    EXPECT_GT(subscriber.GetDroppedFrames(), 0u);
+}
+
+// Test: Attach rejects a mode mismatch, a second producer and a missing segment
+TEST(SharedMemoryRingTest, AttachValidation)
+{
+    auto name = UniqueName();
+    SharedMemoryRing owner;
+    ASSERT_TRUE(owner.Create(name, Mode::Distribute, 1 << 20));
+
+    SharedMemoryRing wrong_mode;
+    EXPECT_FALSE(wrong_mode.Attach(name, Role::Consumer, Mode::Broadcast));
+
+    SharedMemoryRing second_producer;
+    EXPECT_FALSE(second_producer.Attach(name, Role::Producer, Mode::Distribute));
+
+    SharedMemoryRing missing;
+    EXPECT_FALSE(missing.Attach(UniqueName(), Role::Consumer, Mode::Distribute));
+}
+
+// Test: A live segment cannot be created twice; it can after the owner closed it
+TEST(SharedMemoryRingTest, CreateRefusesLiveSegment)
+{
+    auto name = UniqueName();
+    SharedMemoryRing first;
+    ASSERT_TRUE(first.Create(name, Mode::Distribute, 1 << 20));
+
+    SharedMemoryRing second;
+    EXPECT_FALSE(second.Create(name, Mode::Distribute, 1 << 20));
+
+    first.Close();
+    EXPECT_TRUE(second.Create(name, Mode::Distribute, 1 << 20));
+}
+
+// Test: Owner closing the segment wakes a blocked consumer
+TEST(SharedMemoryRingTest, OwnerCloseWakesConsumer)
+{
+    auto name = UniqueName();
+    SharedMemoryRing consumer;
+    ASSERT_TRUE(consumer.Create(name, Mode::Distribute, 1 << 20, Role::Consumer));
+    SharedMemoryRing producer;
+    ASSERT_TRUE(producer.Attach(name, Role::Producer, Mode::Distribute));
+
+    std::thread closer([&]() {
+        std::this_thread::sleep_for(50ms);
+        producer.Close();
+    });
+
+    // The consumer owns the ring here, so closing the producer must not
+    // end the wait - only the timeout does
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(consumer.Read(200ms), nullptr);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 190ms);
+    closer.join();
+
+    SharedMemoryRing attached;
+    ASSERT_TRUE(attached.Attach(name, Role::Consumer, Mode::Distribute));
+    std::thread owner_closer([&]() {
+        std::this_thread::sleep_for(50ms);
+        consumer.Close();
+    });
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(attached.Read(5000ms), nullptr);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 2000ms);
+    EXPECT_TRUE(attached.IsClosedByOwner());
+    owner_closer.join();
+}
+
+// === ZMQTransport shm:// backend ===
+
+namespace {
+
+TransportConfig ShmConfig(const std::string& name, const std::string& pattern, bool bind)
+{
+    TransportConfig config;
+    config.data_address = "shm://" + name;
+    config.status_address = "";
+    config.command_address = "";
+    config.data_pattern = pattern;
+    config.bind_data = bind;
+    config.is_publisher = (pattern == "PUB" || pattern == "PUSH");
+    config.shm_buffer_size = 1 << 20;
+    return config;
+}
+
+}  // namespace
+
+// Test: Only PUB/SUB and PUSH/PULL are accepted for shm:// addresses
+TEST(ShmTransportTest, ConfigureRejectsUnsupportedPatterns)
+{
+    ZMQTransport transport;
+    EXPECT_TRUE(transport.Configure(ShmConfig("x", "PUSH", true)));
+    EXPECT_FALSE(transport.Configure(ShmConfig("x", "PAIR", true)));
+    EXPECT_FALSE(transport.Configure(ShmConfig("", "PUSH", true)));
+}
+
+// Test: PUSH bind / PULL connect round trip through SendBytes/ReceiveBytes
+TEST(ShmTransportTest, PushPullRoundTrip)
+{
+    auto name = UniqueName();
+    ZMQTransport sender;
+    ASSERT_TRUE(sender.Configure(ShmConfig(name, "PUSH", true)));
+    ASSERT_TRUE(sender.Connect());
+
+    ZMQTransport receiver;
+    ASSERT_TRUE(receiver.Configure(ShmConfig(name, "PULL", false)));
+    ASSERT_TRUE(receiver.Connect());
+
+    auto frame = MakeFrame(7, 4096);
+    auto data = std::make_unique<std::vector<uint8_t>>(frame);
+    ASSERT_TRUE(sender.SendBytes(data));
+    EXPECT_EQ(data, nullptr);
+
+    auto received = receiver.ReceiveBytes();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(*received, frame);
+}
+
+// Test: A subscriber may connect before the publisher has bound
+TEST(ShmTransportTest, SubscriberConnectsBeforeBind)
+{
+    auto name = UniqueName();
+    ZMQTransport receiver;
+    ASSERT_TRUE(receiver.Configure(ShmConfig(name, "SUB", false)));
+    ASSERT_TRUE(receiver.Connect());
+    EXPECT_EQ(receiver.ReceiveBytes(), nullptr);
+
+    ZMQTransport sender;
+    ASSERT_TRUE(sender.Configure(ShmConfig(name, "PUB", true)));
+    ASSERT_TRUE(sender.Connect());
+
+    // First receive attaches; frames published afterwards are delivered
+    EXPECT_EQ(receiver.ReceiveBytes(), nullptr);
+    auto data = std::make_unique<std::vector<uint8_t>>(MakeFrame(3, 128));
+    ASSERT_TRUE(sender.SendBytes(data));
+
+    auto received = receiver.ReceiveBytes();
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(received->size(), 128u);
+}
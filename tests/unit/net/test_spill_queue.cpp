@@ -0,0 +1,200 @@
+/**
+ * @file test_spill_queue.cpp
+ * @brief Unit tests for SpillQueue
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SpillQueue.hpp"
+
+using namespace DELILA::Net;
+
+namespace {
+
+// Frame of @p size bytes, all set to the low byte of @p id
+SpillQueue::Frame MakeFrame(uint64_t id, size_t size = 100)
+{
+    SpillQueue::Frame frame;
+    frame.data = std::make_unique<std::vector<uint8_t>>(
+        size, static_cast<uint8_t>(id));
+    frame.stamp = id;
+    return frame;
+}
+
+class SpillQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        path_ = (std::filesystem::temp_directory_path() / "delila_spill_test.spill")
+                    .string();
+    }
+
+    void TearDown() override { std::filesystem::remove(path_); }
+
+    std::string path_;
+};
+
+}  // namespace
+
+TEST_F(SpillQueueTest, WithoutSpillFileDropsWhenFull)
+{
+    SpillQueue queue(3);
+    for (uint64_t id = 0; id < 3; ++id) {
+        EXPECT_TRUE(queue.Push(MakeFrame(id)));
+    }
+    EXPECT_FALSE(queue.Push(MakeFrame(3)));
+    EXPECT_EQ(queue.Size(), 3u);
+    EXPECT_EQ(queue.GetDropped(), 1u);
+
+    SpillQueue::Frame frame;
+    ASSERT_TRUE(queue.Pop(frame));
+    EXPECT_EQ(frame.stamp, 0u);
+}
+
+TEST_F(SpillQueueTest, OverflowIsSpilledAndRestoredInOrder)
+{
+    SpillQueue queue(4);
+    ASSERT_TRUE(queue.OpenSpill(path_, 1 << 20));
+    EXPECT_TRUE(std::filesystem::exists(path_));
+
+    for (uint64_t id = 0; id < 10; ++id) {
+        ASSERT_TRUE(queue.Push(MakeFrame(id, 100 + id)));
+    }
+    EXPECT_EQ(queue.GetMemorySize(), 4u);
+    EXPECT_EQ(queue.GetSpilledFrames(), 6u);
+    EXPECT_GT(queue.GetSpilledBytes(), 6u * 100);
+
+    // Room in memory again, but frames keep going to disk behind the
+    // spilled ones until those are drained
+    SpillQueue::Frame frame;
+    ASSERT_TRUE(queue.Pop(frame));
+    ASSERT_TRUE(queue.Push(MakeFrame(10, 110)));
+    EXPECT_EQ(queue.GetSpilledFrames(), 7u);
+
+    for (uint64_t id = 1; id <= 10; ++id) {
+        ASSERT_TRUE(queue.Pop(frame));
+        EXPECT_EQ(frame.stamp, id);
+        ASSERT_EQ(frame.data->size(), 100 + id);
+        EXPECT_EQ(frame.data->front(), static_cast<uint8_t>(id));
+        EXPECT_EQ(frame.data->back(), static_cast<uint8_t>(id));
+    }
+    EXPECT_FALSE(queue.Pop(frame));
+    EXPECT_EQ(queue.GetTotalSpilled(), 7u);
+    EXPECT_EQ(queue.GetTotalRestored(), 7u);
+    EXPECT_EQ(queue.GetSpilledBytes(), 0u);
+    EXPECT_EQ(queue.GetDropped(), 0u);
+}
+
+TEST_F(SpillQueueTest, RingWrapsAroundWithoutGrowing)
+{
+    // Room for three 1000-byte records; records end up split at the end
+    const uint64_t capacity = 3 * (16 + 1000) + 500;
+    SpillQueue queue(1);
+    ASSERT_TRUE(queue.OpenSpill(path_, capacity));
+    ASSERT_TRUE(queue.Push(MakeFrame(0, 1000)));  // Stays in memory
+
+    uint64_t pushed = 1;
+    uint64_t popped = 0;
+    SpillQueue::Frame frame;
+    for (int round = 0; round < 20; ++round) {
+        while (queue.Push(MakeFrame(pushed, 1000))) {
+            pushed++;
+        }
+        // Ring full: take two out and check the order
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_TRUE(queue.Pop(frame));
+            EXPECT_EQ(frame.stamp, popped);
+            EXPECT_EQ(frame.data->front(), static_cast<uint8_t>(popped));
+            EXPECT_EQ(frame.data->back(), static_cast<uint8_t>(popped));
+            popped++;
+        }
+    }
+    EXPECT_LE(std::filesystem::file_size(path_), capacity);
+    EXPECT_EQ(queue.GetDropped(), 20u);
+}
+
+TEST_F(SpillQueueTest, RequeuedFrameComesBackFirst)
+{
+    SpillQueue queue(1);
+    ASSERT_TRUE(queue.OpenSpill(path_, 1 << 20));
+    queue.Push(MakeFrame(0));
+    queue.Push(MakeFrame(1));
+
+    SpillQueue::Frame frame;
+    ASSERT_TRUE(queue.Pop(frame));
+    ASSERT_TRUE(queue.Pop(frame));
+    EXPECT_EQ(frame.stamp, 1u);
+    queue.Requeue(std::move(frame));
+    queue.Push(MakeFrame(2));
+
+    ASSERT_TRUE(queue.Pop(frame));
+    EXPECT_EQ(frame.stamp, 1u);
+    ASSERT_TRUE(queue.Pop(frame));
+    EXPECT_EQ(frame.stamp, 2u);
+}
+
+TEST_F(SpillQueueTest, TwoPhasePushIsInvisibleUntilEnded)
+{
+    SpillQueue queue(1);
+    ASSERT_TRUE(queue.OpenSpill(path_, 1 << 20));
+    SpillQueue::Reservation reservation;
+    SpillQueue::Frame first = MakeFrame(0);
+    EXPECT_EQ(queue.BeginPush(first, reservation), SpillQueue::PushResult::Stored);
+    queue.Push(MakeFrame(1));
+
+    // The consumer drains everything committed while the write is pending
+    SpillQueue::Frame pending = MakeFrame(2);
+    ASSERT_EQ(queue.BeginPush(pending, reservation),
+              SpillQueue::PushResult::Reserved);
+    SpillQueue::Frame frame;
+    ASSERT_TRUE(queue.Pop(frame));
+    ASSERT_TRUE(queue.Pop(frame));
+    EXPECT_EQ(frame.stamp, 1u);
+    EXPECT_FALSE(queue.Pop(frame));
+
+    ASSERT_TRUE(queue.WriteReserved(reservation, pending));
+    ASSERT_TRUE(queue.EndPush(reservation, true));
+    ASSERT_TRUE(queue.Pop(frame));
+    EXPECT_EQ(frame.stamp, 2u);
+    EXPECT_EQ(frame.data->size(), 100u);
+    EXPECT_EQ(queue.GetTotalSpilled(), 2u);
+
+    // Spilled frames dropped under a pending write take it along
+    queue.Push(MakeFrame(3));
+    queue.Push(MakeFrame(4));
+    SpillQueue::Frame late = MakeFrame(5);
+    ASSERT_EQ(queue.BeginPush(late, reservation),
+              SpillQueue::PushResult::Reserved);
+    queue.DropAll();
+    ASSERT_TRUE(queue.WriteReserved(reservation, late));
+    EXPECT_FALSE(queue.EndPush(reservation, true));
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_EQ(queue.GetDropped(), 3u);
+}
+
+TEST_F(SpillQueueTest, CloseRemovesSpillFile)
+{
+    SpillQueue queue(1);
+    ASSERT_TRUE(queue.OpenSpill(path_, 1 << 20));
+    queue.Push(MakeFrame(0));
+    queue.Push(MakeFrame(1));
+    queue.Push(MakeFrame(2));
+
+    queue.CloseSpill();
+    EXPECT_FALSE(std::filesystem::exists(path_));
+    EXPECT_EQ(queue.Size(), 1u);
+    EXPECT_EQ(queue.GetDropped(), 2u);
+
+    queue.DropAll();
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_EQ(queue.GetDropped(), 3u);
+
+    std::string error;
+    EXPECT_FALSE(queue.OpenSpill("/nonexistent/dir/x.spill", 1 << 20, &error));
+    EXPECT_FALSE(error.empty());
+}
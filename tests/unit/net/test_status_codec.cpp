@@ -0,0 +1,316 @@
+/**
+ * @file test_status_codec.cpp
+ * @brief Unit tests for the binary and JSON status message formats
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "StatusCodec.hpp"
+
+using namespace DELILA::Net;
+
+namespace
+{
+
+ComponentStatus MakeStatus()
+{
+  ComponentStatus status;
+  status.component_id = "digitizer_01";
+  status.state = "Running";
+  status.timestamp = std::chrono::system_clock::time_point(
+      std::chrono::seconds(1700000000));
+  status.run_number = 42;
+  status.heartbeat_counter = 1234;
+  status.component_metrics.events_processed = 9876543210ULL;
+  status.component_metrics.bytes_transferred = 123456789012ULL;
+  status.component_metrics.queue_size = 17;
+  status.component_metrics.queue_max = 1000;
+  status.component_metrics.event_rate = 1.5e6;
+  status.component_metrics.data_rate = 33.25;
+  status.component_metrics.drain_latency_us = 12.5;
+  status.component_metrics.sampling_fraction = 0.25;
+  status.component_metrics.processing.count = 5000;
+  status.component_metrics.processing.p50_us = 12.0;
+  status.component_metrics.processing.p99_us = 80.5;
+  status.component_metrics.processing.p999_us = 410.0;
+  status.component_metrics.processing.max_us = 2048.0;
+  status.component_metrics.frame_age.p99_us = 1500.0;
+  status.component_metrics.event_rate_avg = 1.4e6;
+  status.component_metrics.data_rate_avg = 31.0;
+  status.component_metrics.channel_rates = {{0, 3, 2500.0}, {1, 15, 12.5}};
+  status.metrics["temperature_c"] = 41.5;
+  status.metrics["dropped_events"] = 3.0;
+  return status;
+}
+
+void ExpectEqual(const ComponentStatus &a, const ComponentStatus &b)
+{
+  EXPECT_EQ(a.component_id, b.component_id);
+  EXPECT_EQ(a.state, b.state);
+  EXPECT_EQ(a.timestamp, b.timestamp);
+  EXPECT_EQ(a.run_number, b.run_number);
+  EXPECT_EQ(a.heartbeat_counter, b.heartbeat_counter);
+  EXPECT_EQ(a.error_message, b.error_message);
+  EXPECT_EQ(a.metrics, b.metrics);
+
+  const auto &m = a.component_metrics;
+  const auto &n = b.component_metrics;
+  EXPECT_EQ(m.events_processed, n.events_processed);
+  EXPECT_EQ(m.bytes_transferred, n.bytes_transferred);
+  EXPECT_EQ(m.queue_size, n.queue_size);
+  EXPECT_EQ(m.queue_max, n.queue_max);
+  EXPECT_DOUBLE_EQ(m.event_rate, n.event_rate);
+  EXPECT_DOUBLE_EQ(m.data_rate, n.data_rate);
+  EXPECT_DOUBLE_EQ(m.drain_latency_us, n.drain_latency_us);
+  EXPECT_DOUBLE_EQ(m.sampling_fraction, n.sampling_fraction);
+  EXPECT_DOUBLE_EQ(m.event_rate_avg, n.event_rate_avg);
+  EXPECT_DOUBLE_EQ(m.data_rate_avg, n.data_rate_avg);
+
+  ASSERT_EQ(m.channel_rates.size(), n.channel_rates.size());
+  for (size_t i = 0; i < m.channel_rates.size(); ++i) {
+    EXPECT_EQ(m.channel_rates[i].module, n.channel_rates[i].module);
+    EXPECT_EQ(m.channel_rates[i].channel, n.channel_rates[i].channel);
+    EXPECT_DOUBLE_EQ(m.channel_rates[i].event_rate,
+                     n.channel_rates[i].event_rate);
+  }
+
+  const DELILA::LatencySummary *la[] = {&m.residency, &m.processing,
+                                        &m.frame_age};
+  const DELILA::LatencySummary *lb[] = {&n.residency, &n.processing,
+                                        &n.frame_age};
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(la[i]->count, lb[i]->count);
+    EXPECT_DOUBLE_EQ(la[i]->p50_us, lb[i]->p50_us);
+    EXPECT_DOUBLE_EQ(la[i]->p99_us, lb[i]->p99_us);
+    EXPECT_DOUBLE_EQ(la[i]->p999_us, lb[i]->p999_us);
+    EXPECT_DOUBLE_EQ(la[i]->max_us, lb[i]->max_us);
+  }
+}
+
+}  // namespace
+
+TEST(StatusCodecTest, HeaderIs64Bytes)
+{
+  EXPECT_EQ(sizeof(BinaryStatusHeader), 64u);
+}
+
+TEST(StatusCodecTest, BinaryRoundTrip)
+{
+  auto status = MakeStatus();
+  status.error_message = "ADC overrange on ch 3";
+
+  auto bytes = StatusCodec::EncodeBinary(status);
+  ASSERT_TRUE(StatusCodec::IsBinaryStatus(bytes.data(), bytes.size()));
+
+  auto decoded = StatusCodec::DecodeBinary(bytes);
+  ASSERT_NE(decoded, nullptr);
+  ExpectEqual(*decoded, status);
+}
+
+TEST(StatusCodecTest, BinaryIsCompact)
+{
+  auto status = MakeStatus();
+  auto bytes = StatusCodec::EncodeBinary(status);
+
+  // 64 header + 192 metrics + 12 id + 7 state + 2 x (2 + key + 8)
+  // + 2 channel rates x (1 + 1 + 8)
+  EXPECT_EQ(bytes.size(), 64u + 192u + 12u + 7u + (2 + 13 + 8) + (2 + 14 + 8) +
+                              2 * 10u);
+  EXPECT_LT(bytes.size(), StatusCodec::EncodeJson(status).size() / 2);
+
+  // The typical heartbeat quoted in StatusCodec.hpp and MANUAL.md
+  status.metrics.clear();
+  status.component_metrics.channel_rates.clear();
+  EXPECT_EQ(StatusCodec::EncodeBinary(status).size(), 275u);
+}
+
+TEST(StatusCodecTest, EncodeReusesBuffer)
+{
+  auto status = MakeStatus();
+  std::vector<uint8_t> buffer;
+  StatusCodec::EncodeBinary(status, buffer);
+  const uint8_t *storage = buffer.data();
+
+  status.heartbeat_counter++;
+  StatusCodec::EncodeBinary(status, buffer);
+
+  EXPECT_EQ(buffer.data(), storage);
+  EXPECT_EQ(StatusCodec::DecodeBinary(buffer)->heartbeat_counter, 1235u);
+}
+
+TEST(StatusCodecTest, TruncatedMessagesAreRejected)
+{
+  auto bytes = StatusCodec::EncodeBinary(MakeStatus());
+
+  for (size_t size = 0; size < bytes.size(); ++size) {
+    EXPECT_EQ(StatusCodec::DecodeBinary(bytes.data(), size), nullptr)
+        << "size " << size;
+  }
+}
+
+TEST(StatusCodecTest, InconsistentLengthsAreRejected)
+{
+  auto bytes = StatusCodec::EncodeBinary(MakeStatus());
+  BinaryStatusHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+
+  // Counter count larger than what the payload holds
+  auto corrupt = bytes;
+  header.counter_count = 100;
+  std::memcpy(corrupt.data(), &header, sizeof(header));
+  EXPECT_EQ(StatusCodec::DecodeBinary(corrupt), nullptr);
+
+  // String length running past the payload
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  header.id_length = 0xFFFF;
+  std::memcpy(corrupt.data(), &header, sizeof(header));
+  EXPECT_EQ(StatusCodec::DecodeBinary(corrupt), nullptr);
+}
+
+TEST(StatusCodecTest, UnknownVersionIsRejected)
+{
+  auto bytes = StatusCodec::EncodeBinary(MakeStatus());
+  BinaryStatusHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  header.format_version = STATUS_FORMAT_VERSION + 1;
+  std::memcpy(bytes.data(), &header, sizeof(header));
+
+  EXPECT_EQ(StatusCodec::DecodeBinary(bytes), nullptr);
+}
+
+TEST(StatusCodecTest, LargerMetricsBlockIsSkipped)
+{
+  // A later sender appending a field to the metrics block
+  auto status = MakeStatus();
+  auto bytes = StatusCodec::EncodeBinary(status);
+  BinaryStatusHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+
+  double extra = 7.0;
+  size_t blockEnd = BINARY_STATUS_HEADER_SIZE + header.metrics_size;
+  bytes.insert(bytes.begin() + blockEnd, reinterpret_cast<uint8_t *>(&extra),
+               reinterpret_cast<uint8_t *>(&extra) + sizeof(extra));
+  header.metrics_size += sizeof(extra);
+  header.payload_size += sizeof(extra);
+  std::memcpy(bytes.data(), &header, sizeof(header));
+
+  auto decoded = StatusCodec::DecodeBinary(bytes);
+  ASSERT_NE(decoded, nullptr);
+  ExpectEqual(*decoded, status);
+}
+
+TEST(StatusCodecTest, Version1MetricsBlockStillDecodes)
+{
+  // A sender from before the latency summaries were added
+  auto status = MakeStatus();
+  auto bytes = StatusCodec::EncodeBinary(status);
+  BinaryStatusHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+
+  size_t blockStart = BINARY_STATUS_HEADER_SIZE;
+  bytes.erase(bytes.begin() + blockStart + STATUS_METRICS_SIZE_V1,
+              bytes.begin() + blockStart + header.metrics_size);
+  header.payload_size -= header.metrics_size - STATUS_METRICS_SIZE_V1;
+  header.metrics_size = STATUS_METRICS_SIZE_V1;
+  std::memcpy(bytes.data(), &header, sizeof(header));
+
+  auto decoded = StatusCodec::DecodeBinary(bytes);
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_EQ(decoded->component_id, status.component_id);
+  EXPECT_DOUBLE_EQ(decoded->component_metrics.sampling_fraction, 0.25);
+  EXPECT_EQ(decoded->component_metrics.processing.count, 0u);
+  EXPECT_EQ(decoded->metrics, status.metrics);
+}
+
+TEST(StatusCodecTest, ChannelRatesAreTrailingPayload)
+{
+  // A decoder that stops after the counters sees a well-formed message
+  auto status = MakeStatus();
+  auto bytes = StatusCodec::EncodeBinary(status);
+  status.component_metrics.channel_rates.clear();
+  auto withoutRates = StatusCodec::EncodeBinary(status);
+
+  ASSERT_EQ(bytes.size(), withoutRates.size() + 2 * 10u);
+  EXPECT_EQ(std::memcmp(bytes.data() + BINARY_STATUS_HEADER_SIZE,
+                        withoutRates.data() + BINARY_STATUS_HEADER_SIZE,
+                        withoutRates.size() - BINARY_STATUS_HEADER_SIZE),
+            0);
+
+  // Rate count larger than what the payload holds
+  BinaryStatusHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  header.channel_rate_count = 3;
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  EXPECT_EQ(StatusCodec::DecodeBinary(bytes), nullptr);
+}
+
+TEST(StatusCodecTest, FromComponentStatusKeepsMetrics)
+{
+  DELILA::ComponentStatus core{};
+  core.component_id = "merger";
+  core.state = DELILA::ComponentState::Running;
+  core.timestamp = 1700000000123;
+  core.run_number = 9;
+  core.metrics.processing.p99_us = 42.0;
+  core.heartbeat_counter = 3;
+
+  auto status = StatusCodec::FromComponentStatus(core);
+  EXPECT_EQ(status.component_id, "merger");
+  EXPECT_EQ(status.state, DELILA::ComponentStateToString(core.state));
+  EXPECT_EQ(status.timestamp.time_since_epoch(),
+            std::chrono::milliseconds(1700000000123));
+  EXPECT_EQ(status.run_number, 9u);
+  EXPECT_DOUBLE_EQ(status.component_metrics.processing.p99_us, 42.0);
+
+  auto decoded = StatusCodec::DecodeBinary(StatusCodec::EncodeBinary(status));
+  ASSERT_NE(decoded, nullptr);
+  ExpectEqual(*decoded, status);
+}
+
+TEST(StatusCodecTest, JsonRoundTrip)
+{
+  auto status = MakeStatus();
+  status.error_message = "quoted \"name\" and\nnewline";
+
+  auto json = StatusCodec::EncodeJson(status);
+  auto decoded = StatusCodec::DecodeJson(json);
+  ASSERT_NE(decoded, nullptr);
+  ExpectEqual(*decoded, status);
+}
+
+TEST(StatusCodecTest, DecodeDetectsFormat)
+{
+  auto status = MakeStatus();
+  auto binary = StatusCodec::EncodeBinary(status);
+  auto json = StatusCodec::EncodeJson(status);
+
+  auto fromBinary = StatusCodec::Decode(binary.data(), binary.size());
+  auto fromJson = StatusCodec::Decode(
+      reinterpret_cast<const uint8_t *>(json.data()), json.size());
+  ASSERT_NE(fromBinary, nullptr);
+  ASSERT_NE(fromJson, nullptr);
+  ExpectEqual(*fromBinary, *fromJson);
+
+  const char *garbage = "not a status";
+  EXPECT_EQ(StatusCodec::Decode(reinterpret_cast<const uint8_t *>(garbage),
+                                std::strlen(garbage)),
+            nullptr);
+}
+
+TEST(StatusCodecTest, LegacyJsonIsAccepted)
+{
+  // Format sent before the binary message existed
+  std::string json =
+      "{\"component_id\":\"merger\",\"state\":\"Running\","
+      "\"error_message\":\"\",\"heartbeat_counter\":7,"
+      "\"metrics\":{\"rate\":12.5}}";
+
+  auto status = StatusCodec::DecodeJson(json);
+  ASSERT_NE(status, nullptr);
+  EXPECT_EQ(status->component_id, "merger");
+  EXPECT_EQ(status->heartbeat_counter, 7u);
+  EXPECT_DOUBLE_EQ(status->metrics.at("rate"), 12.5);
+  EXPECT_DOUBLE_EQ(status->component_metrics.sampling_fraction, 1.0);
+}
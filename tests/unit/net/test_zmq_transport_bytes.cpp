@@ -332,4 +332,56 @@ TEST_F(ZMQTransportBytesTest, ConcurrentSendReceive) {
     
     // Assert
     EXPECT_EQ(received_count, message_count);
-}
\ No newline at end of file
+}
+// Test inproc:// between two transports in one process (shared context)
+TEST_F(ZMQTransportBytesTest, InprocPushPullSharesContext) {
+    auto sender = std::make_unique<ZMQTransport>();
+    auto receiver = std::make_unique<ZMQTransport>();
+
+    TransportConfig push_config;
+    push_config.data_address = "inproc://bytes_test_push_pull";
+    push_config.bind_data = true;
+    push_config.data_pattern = "PUSH";
+    push_config.status_address = push_config.data_address;
+    push_config.command_address = "";
+
+    TransportConfig pull_config = push_config;
+    pull_config.bind_data = false;
+    pull_config.data_pattern = "PULL";
+
+    ASSERT_TRUE(sender->Configure(push_config));
+    ASSERT_TRUE(sender->Connect());
+    ASSERT_TRUE(receiver->Configure(pull_config));
+    ASSERT_TRUE(receiver->Connect());
+    EXPECT_TRUE(sender->UsesSharedContext());
+    EXPECT_TRUE(receiver->UsesSharedContext());
+
+    // Large enough that ZeroMQ keeps the sender's buffer rather than
+    // copying it into the message
+    for (size_t size : {16, 4096, 1024 * 1024}) {
+        auto data = CreateTestData(size);
+        ASSERT_TRUE(sender->SendBytes(data));
+        EXPECT_EQ(data, nullptr);
+
+        auto received = receiver->ReceiveBytes();
+        ASSERT_NE(received, nullptr) << "Failed for size: " << size;
+        EXPECT_EQ(received->size(), size);
+        EXPECT_TRUE(VerifyTestData(*received));
+    }
+}
+
+// Test explicit shared_context selection for non-inproc transports
+TEST_F(ZMQTransportBytesTest, SharedContextIsProcessWide) {
+    auto first = ZMQTransport::SharedContext();
+    auto second = ZMQTransport::SharedContext();
+    EXPECT_EQ(first, second);
+
+    TransportConfig config = GetBasicPubSubConfig();
+    ASSERT_TRUE(transport->Configure(config));
+    EXPECT_FALSE(transport->UsesSharedContext());
+
+    config.shared_context = true;
+    ASSERT_TRUE(transport->Configure(config));
+    EXPECT_TRUE(transport->UsesSharedContext());
+    ASSERT_TRUE(transport->Connect());
+}